@@ -0,0 +1,189 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : arm_alu.h
+// Date : October 17, 2026
+// Description : Shared ARM condition codes, flags, and barrel shifter
+//
+// Templated on the CPU model so the GBA ARM7, NDS ARM7, and NDS ARM9 use one implementation
+// Everything is inline, so each core gets its own copy with unused features compiled out
+
+#ifndef EMU_ARM_ALU
+#define EMU_ARM_ALU
+
+#include <iostream>
+
+#include "common.h"
+
+enum arm_cpu_model
+{
+	ARM_V4T,
+	ARM_V5TE,
+};
+
+template <arm_cpu_model model>
+struct arm_alu
+{
+	/****** Checks the condition field of an ARM instruction against the CPSR ******/
+	static inline bool check_condition(u32 cpsr, u32 current_arm_instruction)
+	{
+		bool n = (cpsr & CPSR_N_FLAG);
+		bool z = (cpsr & CPSR_Z_FLAG);
+		bool c = (cpsr & CPSR_C_FLAG);
+		bool v = (cpsr & CPSR_V_FLAG);
+
+		switch(current_arm_instruction >> 28)
+		{
+			//EQ, NE
+			case 0x0: return z;
+			case 0x1: return !z;
+
+			//CS, CC
+			case 0x2: return c;
+			case 0x3: return !c;
+
+			//MI, PL
+			case 0x4: return n;
+			case 0x5: return !n;
+
+			//VS, VC
+			case 0x6: return v;
+			case 0x7: return !v;
+
+			//HI, LS
+			case 0x8: return (c && !z);
+			case 0x9: return (!c || z);
+
+			//GE, LT
+			case 0xA: return (n == v);
+			case 0xB: return (n != v);
+
+			//GT, LE
+			case 0xC: return (!z && (n == v));
+			case 0xD: return (z || (n != v));
+
+			//AL
+			case 0xE: return true;
+
+			//NV - ARMv5TE uses this space for unconditional instructions like BLX
+			default:
+				if(model == ARM_V4T) { std::cout<<"CPU::Warning: ARM instruction uses reserved conditional code NV \n"; }
+				return true;
+		}
+	}
+
+	/****** Updates the condition codes in the CPSR register after logical operations ******/
+	static inline void update_condition_logical(u32& cpsr, u32 result, u8 shift_out)
+	{
+		//Negative and Zero flags
+		cpsr &= ~(CPSR_N_FLAG | CPSR_Z_FLAG);
+		cpsr |= (result & CPSR_N_FLAG);
+		if(result == 0) { cpsr |= CPSR_Z_FLAG; }
+
+		//Carry flag - Shift out of 2 leaves it untouched
+		if(shift_out == 1) { cpsr |= CPSR_C_FLAG; }
+		else if(shift_out == 0) { cpsr &= ~CPSR_C_FLAG; }
+	}
+
+	/****** Performs 32-bit logical shift left - Returns Carry Out ******/
+	static inline u8 logical_shift_left(u32& input, u8 offset)
+	{
+		//LSL #0
+		//No shift performed, carry flag not affected, set it to something not 0 or 1 to check!
+		if(offset == 0) { return 2; }
+
+		//Perform LSL #(n-1), if Bit 31 is 1, we know it will carry out
+		u8 carry_out = ((input << (offset - 1)) & 0x80000000) ? 1 : 0;
+
+		if(offset >= 32)
+		{
+			input = 0;
+			return (offset == 32) ? carry_out : 0;
+		}
+
+		input <<= offset;
+		return carry_out;
+	}
+
+	/****** Performs 32-bit logical shift right - Returns Carry Out ******/
+	static inline u8 logical_shift_right(u32& input, u8 offset)
+	{
+		u8 carry_out = 0;
+
+		//LSR #0
+		//Same as LSR #32, input becomes zero, carry flag is Bit 31 of input
+		if(offset == 0)
+		{
+			carry_out = (input >> 31);
+			input = 0;
+			return carry_out;
+		}
+
+		//Perform LSR #(n-1), if Bit 0 is 1, we know it will carry out
+		carry_out = ((input >> (offset - 1)) & 0x1) ? 1 : 0;
+
+		if(offset >= 32)
+		{
+			input = 0;
+			return (offset == 32) ? carry_out : 0;
+		}
+
+		input >>= offset;
+		return carry_out;
+	}
+
+	/****** Performs 32-bit arithmetic shift right - Returns Carry Out ******/
+	static inline u8 arithmetic_shift_right(u32& input, u8 offset)
+	{
+		u8 carry_out = 0;
+
+		//ASR #0 and ASR #32 or more
+		//Input becomes 0xFFFFFFFF or 0x0 depending on Bit 31 of input, as does the carry flag
+		if((offset == 0) || (offset >= 32))
+		{
+			carry_out = (input >> 31);
+			input = (carry_out) ? 0xFFFFFFFF : 0;
+			return carry_out;
+		}
+
+		carry_out = (input >> (offset - 1)) & 0x1;
+		input = u32(s32(input) >> offset);
+		return carry_out;
+	}
+
+	/****** Performs 32-bit rotate right - Returns Carry Out ******/
+	static inline u8 rotate_right(u32 cpsr, u32& input, u8 offset)
+	{
+		//ROR #0
+		//Same as RRX #1, which is similar to ROR #1, except Bit 31 now becomes the old carry flag
+		if(offset == 0)
+		{
+			u8 carry_out = input & 0x1;
+			input >>= 1;
+
+			if(cpsr & CPSR_C_FLAG) { input |= 0x80000000; }
+			return carry_out;
+		}
+
+		//Rotating by multiples of 32 leaves input as-is, last bit out is always the new Bit 31
+		offset &= 0x1F;
+		if(offset) { input = (input >> offset) | (input << (32 - offset)); }
+
+		return (input >> 31);
+	}
+
+	/****** Performs 32-bit rotate right - For ARM.5 Data Processing when Bit 25 is 1 ******/
+	static inline u8 rotate_right_special(u32 cpsr, u32& input, u8 offset)
+	{
+		if(offset == 0) { return (cpsr & CPSR_C_FLAG) ? 1 : 0; }
+
+		//Immediates are rotated by twice the offset
+		offset = (offset * 2) & 0x1F;
+		if(offset) { input = (input >> offset) | (input << (32 - offset)); }
+
+		return (input >> 31);
+	}
+};
+
+#endif // EMU_ARM_ALU
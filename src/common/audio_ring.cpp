@@ -0,0 +1,80 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : audio_ring.cpp
+// Date : October 17, 2026
+// Description : Audio ring buffer
+//
+// Single-producer/single-consumer ring buffer for mixed audio samples
+// The emulation thread writes samples, the SDL audio callback reads them, neither side locks
+
+#include "audio_ring.h"
+
+/****** Audio ring buffer constructor ******/
+audio_ring::audio_ring()
+{
+	mask = 0;
+	write_pos = 0;
+	read_pos = 0;
+}
+
+/****** Audio ring buffer destructor ******/
+audio_ring::~audio_ring() { }
+
+/****** Sets the size of the ring buffer, rounded up to a power of 2 - Only call while nothing reads or writes ******/
+void audio_ring::resize(u32 size)
+{
+	u32 final_size = 1;
+	while(final_size < size) { final_size <<= 1; }
+
+	buffer.assign(final_size, 0);
+	mask = final_size - 1;
+	clear();
+}
+
+/****** Empties the ring buffer - Only call while nothing reads or writes ******/
+void audio_ring::clear()
+{
+	write_pos.store(0, std::memory_order_relaxed);
+	read_pos.store(0, std::memory_order_relaxed);
+}
+
+/****** Writes samples to the ring buffer - Producer only ******/
+u32 audio_ring::write(const s16* data, u32 count)
+{
+	u32 w_pos = write_pos.load(std::memory_order_relaxed);
+	u32 r_pos = read_pos.load(std::memory_order_acquire);
+
+	//Samples are written all at once or not at all, keeping stereo pairs together
+	if((buffer.empty()) || ((buffer.size() - (w_pos - r_pos)) < count)) { return 0; }
+
+	for(u32 x = 0; x < count; x++) { buffer[(w_pos + x) & mask] = data[x]; }
+
+	write_pos.store(w_pos + count, std::memory_order_release);
+	return count;
+}
+
+/****** Reads up to a given amount of samples from the ring buffer - Consumer only ******/
+u32 audio_ring::read(s16* data, u32 count)
+{
+	u32 r_pos = read_pos.load(std::memory_order_relaxed);
+	u32 w_pos = write_pos.load(std::memory_order_acquire);
+
+	u32 total = w_pos - r_pos;
+	if(count > total) { count = total; }
+
+	for(u32 x = 0; x < count; x++) { data[x] = buffer[(r_pos + x) & mask]; }
+
+	read_pos.store(r_pos + count, std::memory_order_release);
+	return count;
+}
+
+/****** Returns the amount of samples waiting to be read ******/
+u32 audio_ring::available()
+{
+	return write_pos.load(std::memory_order_acquire) - read_pos.load(std::memory_order_acquire);
+}
+
+/****** Returns the total amount of samples the ring buffer can hold ******/
+u32 audio_ring::capacity() { return buffer.size(); }
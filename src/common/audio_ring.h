@@ -0,0 +1,46 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : audio_ring.h
+// Date : October 17, 2026
+// Description : Audio ring buffer
+//
+// Single-producer/single-consumer ring buffer for mixed audio samples
+// The emulation thread writes samples, the SDL audio callback reads them, neither side locks
+
+#ifndef GBE_AUDIO_RING
+#define GBE_AUDIO_RING
+
+#include <atomic>
+#include <vector>
+
+#include "common.h"
+
+class audio_ring
+{
+	public:
+
+	audio_ring();
+	~audio_ring();
+
+	void resize(u32 size);
+	void clear();
+
+	u32 write(const s16* data, u32 count);
+	u32 read(s16* data, u32 count);
+
+	u32 available();
+	u32 capacity();
+
+	private:
+
+	std::vector<s16> buffer;
+	u32 mask;
+
+	//Free-running positions, only the producer moves write_pos and only the consumer moves read_pos
+	std::atomic<u32> write_pos;
+	std::atomic<u32> read_pos;
+};
+
+#endif // GBE_AUDIO_RING
@@ -0,0 +1,252 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : audio_synth.cpp
+// Date : October 17, 2026
+// Description : Band-limited audio synthesis
+//
+// Blip buffers turn level changes at fractional sample times into band-limited steps
+// FIR resamplers convert streams of PCM samples to the output sample rate with a polyphase filter
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define GBE_FIR_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "audio_synth.h"
+
+namespace
+{
+	const double SYNTH_PI = 3.14159265358979323846;
+
+	//Input samples the FIR resampler starts behind
+	const u32 FIR_LATENCY = 4;
+
+	/****** Windowed sinc lowpass - Cutoff is in cycles per sample, x is the distance from the center tap ******/
+	double windowed_sinc(double x, double cutoff, double half_width)
+	{
+		if(std::fabs(x) >= half_width) { return 0.0; }
+
+		double sinc = (x == 0.0) ? (2.0 * cutoff) : (std::sin(2.0 * SYNTH_PI * cutoff * x) / (SYNTH_PI * x));
+		double window = 0.42 + (0.5 * std::cos(SYNTH_PI * x / half_width)) + (0.08 * std::cos(2.0 * SYNTH_PI * x / half_width));
+
+		return sinc * window;
+	}
+
+	struct blip_kernel_table
+	{
+		s32 taps[BLIP_PHASES][BLIP_TAPS];
+	};
+
+	/****** Builds the band-limited step kernel - Each phase sums to exactly 1 << BLIP_SHIFT so steps never drift ******/
+	blip_kernel_table build_blip_kernel()
+	{
+		blip_kernel_table table;
+		const s32 unit = (1 << BLIP_SHIFT);
+
+		for(u32 phase = 0; phase < BLIP_PHASES; phase++)
+		{
+			double center = (BLIP_TAPS / 2) - 1 + (double(phase) / BLIP_PHASES);
+			double raw[BLIP_TAPS];
+			double total = 0.0;
+
+			for(u32 x = 0; x < BLIP_TAPS; x++)
+			{
+				raw[x] = windowed_sinc(x - center, 0.45, (BLIP_TAPS / 2));
+				total += raw[x];
+			}
+
+			s32 sum = 0;
+
+			for(u32 x = 0; x < BLIP_TAPS; x++)
+			{
+				table.taps[phase][x] = s32(std::floor(((raw[x] / total) * unit) + 0.5));
+				sum += table.taps[phase][x];
+			}
+
+			//Put any rounding error on the tap closest to the center
+			table.taps[phase][BLIP_TAPS / 2] += (unit - sum);
+		}
+
+		return table;
+	}
+
+	const blip_kernel_table& blip_kernel()
+	{
+		static const blip_kernel_table table = build_blip_kernel();
+		return table;
+	}
+
+	/****** Clamps a mixed sample to S16 ******/
+	s16 clamp_s16(s32 sample)
+	{
+		if(sample > 32767) { return 32767; }
+		if(sample < -32768) { return -32768; }
+		return sample;
+	}
+
+	/****** Multiplies and sums FIR_TAPS samples against a kernel phase ******/
+	float fir_dot(const float* samples, const float* taps)
+	{
+		#ifdef GBE_FIR_SSE2
+		__m128 sum = _mm_mul_ps(_mm_loadu_ps(samples), _mm_loadu_ps(taps));
+
+		for(u32 x = 4; x < FIR_TAPS; x += 4)
+		{
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(samples + x), _mm_loadu_ps(taps + x)));
+		}
+
+		//Horizontal add of all 4 lanes
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x1));
+		return _mm_cvtss_f32(sum);
+
+		#else
+		float sum = 0.0f;
+		for(u32 x = 0; x < FIR_TAPS; x++) { sum += (samples[x] * taps[x]); }
+		return sum;
+
+		#endif
+	}
+}
+
+/****** Blip buffer constructor ******/
+blip_buffer::blip_buffer() { reset(0); }
+
+/****** Blip buffer destructor ******/
+blip_buffer::~blip_buffer() { }
+
+/****** Reset blip buffer - Output starts at the given level ******/
+void blip_buffer::reset(s32 start_level)
+{
+	level = start_level;
+	accumulator = start_level * (1 << BLIP_SHIFT);
+	memset(deltas, 0, sizeof(deltas));
+}
+
+/****** Changes the output level at a time within the current block - Time is in samples, fractions allowed ******/
+void blip_buffer::set_level(double time, s32 new_level)
+{
+	if(new_level == level) { return; }
+
+	s32 delta = new_level - level;
+	level = new_level;
+
+	if(time < 0.0) { time = 0.0; }
+	if(time > SYNTH_MAX_BLOCK) { time = SYNTH_MAX_BLOCK; }
+
+	u32 index = time;
+	u32 phase = (time - index) * BLIP_PHASES;
+
+	if(phase >= BLIP_PHASES)
+	{
+		phase = 0;
+		index++;
+	}
+
+	const s32* taps = blip_kernel().taps[phase];
+	s32* out = &deltas[index];
+
+	for(u32 x = 0; x < BLIP_TAPS; x++) { out[x] += (delta * taps[x]); }
+}
+
+/****** Outputs a block of samples and moves any remaining steps to the next block ******/
+void blip_buffer::read_samples(s16* stream, u32 length)
+{
+	if(length > SYNTH_MAX_BLOCK) { length = SYNTH_MAX_BLOCK; }
+
+	for(u32 x = 0; x < length; x++)
+	{
+		accumulator += deltas[x];
+		stream[x] = clamp_s16(accumulator >> BLIP_SHIFT);
+	}
+
+	u32 total = (SYNTH_MAX_BLOCK + BLIP_TAPS + 1);
+	memmove(deltas, deltas + length, (total - length) * sizeof(s32));
+	memset(deltas + (total - length), 0, length * sizeof(s32));
+}
+
+/****** FIR resampler constructor ******/
+fir_resampler::fir_resampler()
+{
+	kernel_ratio = 0.0;
+	reset();
+}
+
+/****** FIR resampler destructor ******/
+fir_resampler::~fir_resampler() { }
+
+/****** Reset FIR resampler - History starts out silent, the kernel is kept ******/
+void fir_resampler::reset()
+{
+	//Trail the newest input by a few samples so uneven arrivals do not starve the filter
+	input.assign(FIR_TAPS + FIR_LATENCY, 0.0f);
+	position = 0.0;
+}
+
+/****** Queues an input sample ******/
+void fir_resampler::write(s16 sample) { input.push_back(sample); }
+
+/****** Builds the polyphase kernel - Cutoff follows the lower of the input and output rates ******/
+void fir_resampler::build_kernel(double ratio)
+{
+	double cutoff = (ratio > 1.0) ? (0.45 / ratio) : 0.45;
+
+	for(u32 phase = 0; phase < FIR_PHASES; phase++)
+	{
+		double center = (FIR_TAPS / 2) - 1 + (double(phase) / FIR_PHASES);
+		double total = 0.0;
+
+		for(u32 x = 0; x < FIR_TAPS; x++) { total += windowed_sinc(x - center, cutoff, (FIR_TAPS / 2)); }
+		for(u32 x = 0; x < FIR_TAPS; x++) { kernel[phase][x] = windowed_sinc(x - center, cutoff, (FIR_TAPS / 2)) / total; }
+	}
+
+	kernel_ratio = ratio;
+}
+
+/****** Outputs a block of samples - Ratio is input samples per output sample ******/
+void fir_resampler::read_samples(s16* stream, u32 length, double ratio)
+{
+	if(std::fabs(ratio - kernel_ratio) > 0.0001) { build_kernel(ratio); }
+
+	//Last position with a full set of taps available
+	double max_position = input.size() - FIR_TAPS;
+
+	//Skip ahead if input arrives faster than expected, so latency stays bounded
+	double backlog = max_position - position;
+	if(backlog > ((ratio * length * 2) + FIR_TAPS)) { position = max_position - (ratio * length); }
+
+	for(u32 x = 0; x < length; x++)
+	{
+		//Hold at the newest input if the next samples have not arrived yet
+		double current = (position < max_position) ? position : max_position;
+		u32 index = current;
+		u32 phase = (current - index) * FIR_PHASES;
+
+		if(phase >= FIR_PHASES) { phase = FIR_PHASES - 1; }
+
+		stream[x] = clamp_s16(s32(fir_dot(&input[index], kernel[phase])));
+
+		position += ratio;
+		if(position > (max_position + 1.0)) { position = max_position + 1.0; }
+	}
+
+	//Drop input that no longer falls under any taps
+	u32 consumed = (position < max_position) ? u32(position) : u32(max_position);
+	input.erase(input.begin(), input.begin() + consumed);
+	position -= consumed;
+}
+
+/****** Returns the name of the instruction set used by the FIR resampler ******/
+std::string fir_kernel_name()
+{
+	#ifdef GBE_FIR_SSE2
+	return "SSE2";
+	#else
+	return "Scalar";
+	#endif
+}
@@ -0,0 +1,76 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : audio_synth.h
+// Date : October 17, 2026
+// Description : Band-limited audio synthesis
+//
+// Blip buffers turn level changes at fractional sample times into band-limited steps
+// FIR resamplers convert streams of PCM samples to the output sample rate with a polyphase filter
+
+#ifndef GBE_AUDIO_SYNTH
+#define GBE_AUDIO_SYNTH
+
+#include <string>
+#include <vector>
+
+#include "common.h"
+
+//Blip buffer kernel size - Taps per step, fractional positions per sample, fixed-point precision
+const u32 BLIP_TAPS = 16;
+const u32 BLIP_PHASES = 64;
+const u32 BLIP_SHIFT = 12;
+
+//Most samples a blip buffer or resampler produces at once
+const u32 SYNTH_MAX_BLOCK = 256;
+
+//FIR resampler kernel size - Taps per output sample, fractional positions per input sample
+const u32 FIR_TAPS = 16;
+const u32 FIR_PHASES = 64;
+
+class blip_buffer
+{
+	public:
+
+	blip_buffer();
+	~blip_buffer();
+
+	void reset(s32 start_level);
+	void set_level(double time, s32 new_level);
+	void read_samples(s16* stream, u32 length);
+
+	s32 level;
+
+	private:
+
+	s32 accumulator;
+	s32 deltas[SYNTH_MAX_BLOCK + BLIP_TAPS + 1];
+};
+
+class fir_resampler
+{
+	public:
+
+	fir_resampler();
+	~fir_resampler();
+
+	void reset();
+	void write(s16 sample);
+	void read_samples(s16* stream, u32 length, double ratio);
+
+	private:
+
+	void build_kernel(double ratio);
+
+	std::vector<float> input;
+	double position;
+
+	double kernel_ratio;
+	float kernel[FIR_PHASES][FIR_TAPS];
+};
+
+//Name of the instruction set picked for the FIR resampler
+std::string fir_kernel_name();
+
+#endif // GBE_AUDIO_SYNTH
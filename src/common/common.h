@@ -42,10 +42,10 @@ const u32 CPSR_MODE_ABT = 0x17;
 const u32 CPSR_MODE_UND = 0x1B;
 const u32 CPSR_MODE_SYS = 0x1F;
 
-const u32 DMG_SAVE_STATE_VERSION = 0x05;
-const u32 SGB_SAVE_STATE_VERSION = 0x05;
-const u32 AGB_SAVE_STATE_VERSION = 0x05;
-const u32 MIN_SAVE_STATE_VERSION = 0x03;
-const u32 NTR_SAVE_STATE_VERSION = 0x0B;
+const u32 DMG_SAVE_STATE_VERSION = 0x06;
+const u32 SGB_SAVE_STATE_VERSION = 0x06;
+const u32 AGB_SAVE_STATE_VERSION = 0x06;
+const u32 MIN_SAVE_STATE_VERSION = 0x04;
+const u32 NTR_SAVE_STATE_VERSION = 0x0C;
 
 #endif // EMU_COMMON
\ No newline at end of file
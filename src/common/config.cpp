@@ -89,6 +89,7 @@ namespace config
 	u32 hotkey_camera = SDLK_p;
 	u32 hotkey_swap_screen = SDLK_F4;
 	u32 hotkey_shift_screen = SDLK_F3;
+	u32 hotkey_rewind = SDLK_BACKSPACE;
 
 	//Default joystick dead-zone
 	u32 dead_zone = 16000;
@@ -123,7 +124,7 @@ namespace config
 	u32 utp_steps = 0;
 	u32 magic_reader_id = 0x500000;
 	bool use_opengl = false;
-	bool turbo = false;
+	thread_local bool turbo = false;
 
 	std::string vertex_shader = "vertex.vs";
 	std::string fragment_shader = "fragment.fs";
@@ -148,6 +149,9 @@ namespace config
 	bool netplay_hard_sync = true;
 	bool use_net_gate = false;
 	u32 netplay_sync_threshold = 32;
+	u32 netplay_rollback = 0;
+	u8 netplay_local_players = 0;
+	bool netplay_local = false;
 	u16 netplay_server_port = 2000;
 	u16 netplay_client_port = 2001;
 	u8 netplay_id = 0;
@@ -243,6 +247,29 @@ namespace config
 	//CPU overclocking flags
 	u32 oc_flags = 0;
 
+	//Cache pre-decoded CPU code blocks (GBA)
+	bool use_block_cache = true;
+
+	//Recompile hot CPU code blocks to host code (GBA, x86-64 builds only)
+	bool use_jit = false;
+
+	//Skip ahead to the next event when the CPU spins in an idle loop (GBA, DMG, NDS)
+	bool skip_idle_loops = true;
+
+	//Draw scanlines on a separate thread (GBA)
+	bool threaded_render = false;
+
+	//Frame skipping - 0 = Off, 1-9 = Draw 1 out of every N + 1 frames, automatic mode overrides the fixed count
+	u32 frame_skip = 0;
+	bool frame_skip_auto = false;
+
+	//Rewind - Take a snapshot every N frames (0 = Off), keep up to the given MB of history
+	u32 rewind_interval = 0;
+	u32 rewind_buffer_size = 32;
+
+	//Run-ahead - Frames emulated ahead of the shown one to hide input lag (0 = Off)
+	u32 run_ahead = 0;
+
 	//IR database index
 	u32 ir_db_index = 0;
 
@@ -309,8 +336,8 @@ namespace config
 	//On-screen display settings
 	bool use_osd = false;
 	std::vector <u32> osd_font;
-	std::string osd_message = "";
-	u32 osd_count = 0;
+	thread_local std::string osd_message = "";
+	thread_local u32 osd_count = 0;
 	u8 osd_alpha = 0xFF;
 }
 
@@ -861,6 +888,22 @@ bool parse_cli_args()
 				}
 			}
 
+			//Set frame skipping
+			else if((config::cli_args[x] == "-fs") || (config::cli_args[x] == "--frame-skip"))
+			{
+				if((++x) == config::cli_args.size()) { std::cout<<"GBE::Error - No frame skip value set\n"; }
+
+				else if(config::cli_args[x] == "auto") { config::frame_skip_auto = true; }
+
+				else
+				{
+					u32 output = 0;
+					util::from_str(config::cli_args[x], output);
+					config::frame_skip = (output > 9) ? 9 : output;
+					config::frame_skip_auto = false;
+				}
+			}
+
 			//Override default audio driver
 			else if((config::cli_args[x] == "-ad") || (config::cli_args[x] == "--audio-driver"))
 			{
@@ -1117,6 +1160,7 @@ bool parse_cli_args()
 				std::cout<<"--use-legacy-save-size\n\tUse old 128KB save format from older GBE+ versions\n\n";
 				std::cout<<"-ad [DRIVER], --audio-driver [DRIVER]\n\tSelects a specific audio driver for GBE+\n\n";
 				std::cout<<"-mf [FRAMERATE], --max-fps [FRAMERATE]\n\tSets the maximum frames per-second\n\n";
+				std::cout<<"-fs [FRAMES], --frame-skip [FRAMES]\n\tSkips drawing N frames between drawn frames, 'auto' to skip based on host speed\n\n";
 				std::cout<<"--slot2-gba [FILE]\n\tSets Slot-2 of NDS core to use a specified GBA ROM file\n\n"; 
 				std::cout<<"-h, --help\n\tPrint these help messages\n\n";
 				return false;
@@ -1340,6 +1384,15 @@ bool parse_ini_file(std::string filename)
 		//Max FPS
 		if(!parse_ini_number(ini_item, "#max_fps", config::max_fps, ini_opts, x, 0, 65535)) { return false; }
 
+		//Frame skipping
+		if(!parse_ini_number(ini_item, "#frame_skip", config::frame_skip, ini_opts, x, 0, 9)) { return false; }
+		if(!parse_ini_bool(ini_item, "#frame_skip_auto", config::frame_skip_auto, ini_opts, x)) { return false; }
+
+		//Rewind
+		if(!parse_ini_number(ini_item, "#rewind_interval", config::rewind_interval, ini_opts, x, 0, 60)) { return false; }
+		if(!parse_ini_number(ini_item, "#rewind_buffer_size", config::rewind_buffer_size, ini_opts, x, 1, 1024)) { return false; }
+		if(!parse_ini_number(ini_item, "#run_ahead", config::run_ahead, ini_opts, x, 0, 4)) { return false; }
+
 		//Use gamepad dead zone
 		if(!parse_ini_number(ini_item, "#dead_zone", config::dead_zone, ini_opts, x, 0, 32767)) { return false; }
 
@@ -1433,6 +1486,18 @@ bool parse_ini_file(std::string filename)
 
 		//CPU overclocking flags
 		if(!parse_ini_number(ini_item, "#oc_flags", config::oc_flags, ini_opts, x, 0, 3)) { return false; }
+
+		//CPU code block cache
+		if(!parse_ini_bool(ini_item, "#use_block_cache", config::use_block_cache, ini_opts, x)) { return false; }
+
+		//CPU recompiler
+		if(!parse_ini_bool(ini_item, "#use_jit", config::use_jit, ini_opts, x)) { return false; }
+
+		//Idle loop skipping
+		if(!parse_ini_bool(ini_item, "#skip_idle_loops", config::skip_idle_loops, ini_opts, x)) { return false; }
+
+		//Threaded rendering
+		if(!parse_ini_bool(ini_item, "#threaded_render", config::threaded_render, ini_opts, x)) { return false; }
 			
 		//Emulated DMG-on-GBC palette
 		if(!parse_ini_number(ini_item, "#dmg_on_gbc_pal", config::dmg_gbc_pal, ini_opts, x, 1, 16)) { return false; }
@@ -1671,6 +1736,9 @@ bool parse_ini_file(std::string filename)
 			}
 		}
 
+		//Rewind hotkey
+		if(!parse_ini_number(ini_item, "#hotkey_rewind", config::hotkey_rewind, ini_opts, x, 0, 0xFFFFFFFF)) { return false; }
+
 		//NDS touch zone mappings
 		if(ini_item == "#nds_touch_zone")
 		{
@@ -1743,6 +1811,12 @@ bool parse_ini_file(std::string filename)
 		//Netplay sync threshold
 		if(!parse_ini_number(ini_item, "#netplay_sync_threshold", config::netplay_sync_threshold, ini_opts, x, 0, 0xFFFFFFFF)) { return false; }
 
+		//Netplay rollback
+		if(!parse_ini_number(ini_item, "#netplay_rollback", config::netplay_rollback, ini_opts, x, 0, 30)) { return false; }
+
+		//Netplay local link session
+		if(!parse_ini_number(ini_item, "#netplay_local_players", config::netplay_local_players, ini_opts, x, 0, 4)) { return false; }
+
 		//Netplay server port
 		if(!parse_ini_number(ini_item, "#netplay_server_port", config::netplay_server_port, ini_opts, x, 0, 65535)) { return false; }
 
@@ -2571,6 +2645,42 @@ bool save_ini_file()
 			output_lines[line_pos] = "[#oc_flags:" + val + "]";
 		}
 
+		//CPU code block cache
+		else if(ini_item == "#use_block_cache")
+		{
+			line_pos = output_count[x];
+			std::string val = (config::use_block_cache) ? "1" : "0";
+
+			output_lines[line_pos] = "[#use_block_cache:" + val + "]";
+		}
+
+		//CPU recompiler
+		else if(ini_item == "#use_jit")
+		{
+			line_pos = output_count[x];
+			std::string val = (config::use_jit) ? "1" : "0";
+
+			output_lines[line_pos] = "[#use_jit:" + val + "]";
+		}
+
+		//Idle loop skipping
+		else if(ini_item == "#skip_idle_loops")
+		{
+			line_pos = output_count[x];
+			std::string val = (config::skip_idle_loops) ? "1" : "0";
+
+			output_lines[line_pos] = "[#skip_idle_loops:" + val + "]";
+		}
+
+		//Threaded rendering
+		else if(ini_item == "#threaded_render")
+		{
+			line_pos = output_count[x];
+			std::string val = (config::threaded_render) ? "1" : "0";
+
+			output_lines[line_pos] = "[#threaded_render:" + val + "]";
+		}
+
 		//Emulated DMG-on-GBC palette
 		else if(ini_item == "#dmg_on_gbc_pal")
 		{
@@ -2631,6 +2741,47 @@ bool save_ini_file()
 			output_lines[line_pos] = "[#max_fps:" + util::to_str(config::max_fps) + "]";
 		}
 
+		//Frame skipping
+		else if(ini_item == "#frame_skip")
+		{
+			line_pos = output_count[x];
+
+			output_lines[line_pos] = "[#frame_skip:" + util::to_str(config::frame_skip) + "]";
+		}
+
+		//Automatic frame skipping
+		else if(ini_item == "#frame_skip_auto")
+		{
+			line_pos = output_count[x];
+			std::string val = (config::frame_skip_auto) ? "1" : "0";
+
+			output_lines[line_pos] = "[#frame_skip_auto:" + val + "]";
+		}
+
+		//Rewind interval
+		else if(ini_item == "#rewind_interval")
+		{
+			line_pos = output_count[x];
+
+			output_lines[line_pos] = "[#rewind_interval:" + util::to_str(config::rewind_interval) + "]";
+		}
+
+		//Rewind buffer size
+		else if(ini_item == "#rewind_buffer_size")
+		{
+			line_pos = output_count[x];
+
+			output_lines[line_pos] = "[#rewind_buffer_size:" + util::to_str(config::rewind_buffer_size) + "]";
+		}
+
+		//Run-ahead
+		else if(ini_item == "#run_ahead")
+		{
+			line_pos = output_count[x];
+
+			output_lines[line_pos] = "[#run_ahead:" + util::to_str(config::run_ahead) + "]";
+		}
+
 		//Keyboard controls
 		else if(ini_item == "#gbe_key_controls")
 		{
@@ -2765,6 +2916,14 @@ bool save_ini_file()
 			output_lines[line_pos] = "[#hotkeys:" + val_1 + ":" + val_2 + ":" + val_3 + ":" + val_4 + ":" + val_5 + "]";
 		}
 
+		//Rewind hotkey
+		else if(ini_item == "#hotkey_rewind")
+		{
+			line_pos = output_count[x];
+
+			output_lines[line_pos] = "[#hotkey_rewind:" + util::to_str(config::hotkey_rewind) + "]";
+		}
+
 		//Use netplay
 		else if(ini_item == "#use_netplay")
 		{
@@ -2801,6 +2960,24 @@ bool save_ini_file()
 			output_lines[line_pos] = "[#netplay_sync_threshold:" + val + "]";
 		}
 
+		//Netplay rollback
+		else if(ini_item == "#netplay_rollback")
+		{
+			line_pos = output_count[x];
+			std::string val = util::to_str(config::netplay_rollback);
+
+			output_lines[line_pos] = "[#netplay_rollback:" + val + "]";
+		}
+
+		//Netplay local link session
+		else if(ini_item == "#netplay_local_players")
+		{
+			line_pos = output_count[x];
+			std::string val = util::to_str(config::netplay_local_players);
+
+			output_lines[line_pos] = "[#netplay_local_players:" + val + "]";
+		}
+
 		//Netplay server port
 		else if(ini_item == "#netplay_server_port")
 		{
@@ -3276,8 +3453,17 @@ bool generate_ini_file()
 	ini_contents += "[#scaling_factor]\n\n";
 	ini_contents += "[#maintain_aspect_ratio]\n\n";
 	ini_contents += "[#max_fps]\n\n";
+	ini_contents += "[#frame_skip]\n\n";
+	ini_contents += "[#frame_skip_auto]\n\n";
+	ini_contents += "[#rewind_interval]\n\n";
+	ini_contents += "[#rewind_buffer_size]\n\n";
+	ini_contents += "[#run_ahead]\n\n";
 	ini_contents += "[#rtc_offset]\n\n";
 	ini_contents += "[#oc_flags]\n\n";
+	ini_contents += "[#use_block_cache]\n\n";
+	ini_contents += "[#use_jit]\n\n";
+	ini_contents += "[#skip_idle_loops]\n\n";
+	ini_contents += "[#threaded_render]\n\n";
 	ini_contents += "[#dead_zone]\n\n";
 	ini_contents += "[#volume]\n\n";
 	ini_contents += "[#mute]\n\n";
@@ -3303,12 +3489,15 @@ bool generate_ini_file()
 	ini_contents += "[#motion_scaler]\n\n";
 	ini_contents += "[#use_ddr_mapping]\n\n";
 	ini_contents += "[#hotkeys]\n\n";
+	ini_contents += "[#hotkey_rewind]\n\n";
 	ini_contents += "[#use_netplay]\n\n";
 	ini_contents += "[#use_netplay_hard_sync]\n\n";
 	ini_contents += "[#use_net_gate]\n\n";
 	ini_contents += "[#use_real_gbma_server]\n\n";
 	ini_contents += "[#gbma_server_http_port]\n\n";
 	ini_contents += "[#netplay_sync_threshold]\n\n";
+	ini_contents += "[#netplay_rollback]\n\n";
+	ini_contents += "[#netplay_local_players]\n\n";
 	ini_contents += "[#netplay_server_port]\n\n";
 	ini_contents += "[#netplay_client_port]\n\n";
 	ini_contents += "[#netplay_client_ip]\n\n";
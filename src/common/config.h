@@ -225,6 +225,7 @@ namespace config
 	extern u32 hotkey_camera;
 	extern u32 hotkey_swap_screen;
 	extern u32 hotkey_shift_screen;
+	extern u32 hotkey_rewind;
 	extern u32 dead_zone;
 	extern int joy_id;
 	extern int joy_sdl_id;
@@ -251,7 +252,10 @@ namespace config
 	extern u32 mic_device;
 	extern bool use_opengl;
 	extern bool use_debugger;
-	extern bool turbo;
+
+	//Per thread, so each core in a local link session keeps its own turbo state
+	extern thread_local bool turbo;
+
 	extern u8 scaling_factor;
 	extern u8 old_scaling_factor;
 	extern std::stringstream title;
@@ -282,6 +286,9 @@ namespace config
 	extern bool use_net_gate;
 	extern bool use_real_gbma_server;
 	extern u32 netplay_sync_threshold;
+	extern u32 netplay_rollback;
+	extern u8 netplay_local_players;
+	extern bool netplay_local;
 	extern u16 netplay_server_port;
 	extern u16 netplay_client_port;
 	extern u8 netplay_id;
@@ -314,12 +321,21 @@ namespace config
 	extern bool maintain_aspect_ratio;
 	extern u8 lcd_config;
 	extern u16 max_fps;
+	extern u32 frame_skip;
+	extern bool frame_skip_auto;
+	extern u32 rewind_interval;
+	extern u32 rewind_buffer_size;
+	extern u32 run_ahead;
 
 	extern u32 DMG_BG_PAL[4];
 	extern u32 DMG_OBJ_PAL[4][2];
 
 	extern u16 rtc_offset[6];
 	extern u32 oc_flags;
+	extern bool use_block_cache;
+	extern bool use_jit;
+	extern bool skip_idle_loops;
+	extern bool threaded_render;
 	extern u32 ir_db_index;
 
 	extern u16 battle_chip_id;
@@ -358,8 +374,11 @@ namespace config
 
 	extern bool use_osd;
 	extern std::vector <u32> osd_font;
-	extern std::string osd_message;
-	extern u32 osd_count;
+
+	//Per thread, so each core in a local link session draws its own messages
+	extern thread_local std::string osd_message;
+	extern thread_local u32 osd_count;
+
 	extern u8 osd_alpha;
 
 	extern bool use_external_interfaces;
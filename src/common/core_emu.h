@@ -13,10 +13,12 @@
 #define CORE_EMU
 
 #include <SDL.h>
+#include <atomic>
 #include <string>
 #include <vector>
 
 #include "common/common.h"
+#include "common/save_state.h"
 
 class core_emu
 {
@@ -38,8 +40,13 @@ class core_emu
 	virtual void feed_key_input(int sdl_key, bool pressed) = 0;
 	virtual	void save_state(u8 slot) = 0;
 	virtual	void load_state(u8 slot) = 0;
-	virtual bool get_save_state_info(u32 offset, std::string filename) = 0;
-	virtual bool set_save_state_info(std::string filename) = 0;
+	virtual bool get_save_state_info(state_reader& state) = 0;
+	virtual void set_save_state_info(state_writer& state) = 0;
+
+	//In-memory save states
+	virtual u32 get_state_size() = 0;
+	virtual u32 serialize_state(u8* buffer, u32 length) = 0;
+	virtual bool deserialize_state(const u8* buffer, u32 length) = 0;
 
 	//Core debugging
 	virtual	void debug_step() = 0;
@@ -64,7 +71,8 @@ class core_emu
 	//Misc
 	virtual u32 get_core_data(u32 core_index) = 0;
 
-	bool running;
+	//Atomic, so a local link session can stop a core from the main thread
+	std::atomic<bool> running;
 	SDL_Event event;
 	
 	struct debugging
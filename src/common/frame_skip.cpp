@@ -0,0 +1,80 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : frame_skip.cpp
+// Date : October 17, 2026
+// Description : Frame skipping
+//
+// Decides once per frame whether the LCDs should draw and blit the next frame
+// Emulated timing is never touched, only pixel generation and presentation are skipped
+// Hidden frames (run-ahead) are never shown and do not count towards frame limiting
+
+#include "frame_skip.h"
+#include "config.h"
+
+//Most frames automatic skipping will drop in a row before forcing a draw
+const u32 FRAME_SKIP_AUTO_MAX = 4;
+
+/****** Frame skipper constructor ******/
+frame_skipper::frame_skipper() { reset(); }
+
+/****** Frame skipper destructor ******/
+frame_skipper::~frame_skipper() { }
+
+/****** Reset frame skipper ******/
+void frame_skipper::reset()
+{
+	skip_frame = false;
+	hidden = false;
+	paced = true;
+	shown_skip = false;
+	skip_count = 0;
+	last_draw_time = 0;
+}
+
+/****** Decides if the next frame is drawn - Called once per frame at VBlank, before limiting the framerate ******/
+void frame_skipper::update(u32 current_time, u32 frame_start_time, u32 frame_delay)
+{
+	if(hidden) { return; }
+
+	if(!skip_frame) { last_draw_time = current_time; }
+
+	//Automatic - With turbo, draw at most once per regular frame period
+	if((config::frame_skip_auto) && (config::turbo))
+	{
+		skip_frame = ((current_time - last_draw_time) < frame_delay);
+	}
+
+	//Automatic - Otherwise, skip whenever the last frame ran past its time slot
+	else if(config::frame_skip_auto)
+	{
+		skip_count = skip_frame ? (skip_count + 1) : 0;
+		skip_frame = ((current_time - frame_start_time) > frame_delay) && (skip_count < FRAME_SKIP_AUTO_MAX);
+	}
+
+	//Fixed - Draw 1 out of every N + 1 frames
+	else if(config::frame_skip)
+	{
+		skip_count = skip_frame ? (skip_count + 1) : 0;
+		skip_frame = (skip_count < config::frame_skip);
+	}
+
+	else { skip_frame = false; }
+}
+
+/****** Hides or shows the next frame - Hidden frames are never drawn, the skip decision for shown frames is kept ******/
+void frame_skipper::set_hidden(bool hide)
+{
+	//Only shown frames wait on the frame limiter unless set_paced() says otherwise
+	paced = !hide;
+
+	if(hide == hidden) { return; }
+
+	if(hide) { shown_skip = skip_frame; }
+	skip_frame = (hide) ? true : shown_skip;
+	hidden = hide;
+}
+
+/****** Sets whether the next frame waits on the frame limiter - Call after set_hidden() ******/
+void frame_skipper::set_paced(bool pace) { paced = pace; }
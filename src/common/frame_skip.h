@@ -0,0 +1,43 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : frame_skip.h
+// Date : October 17, 2026
+// Description : Frame skipping
+//
+// Decides once per frame whether the LCDs should draw and blit the next frame
+// Emulated timing is never touched, only pixel generation and presentation are skipped
+// Hidden frames (run-ahead) are never shown, and frame limiting only waits on paced frames
+
+#ifndef GBE_FRAME_SKIP
+#define GBE_FRAME_SKIP
+
+#include "common.h"
+
+class frame_skipper
+{
+	public:
+
+	frame_skipper();
+	~frame_skipper();
+
+	void reset();
+	void update(u32 current_time, u32 frame_start_time, u32 frame_delay);
+	void set_hidden(bool hide);
+	void set_paced(bool pace);
+
+	bool skip_frame;
+	bool hidden;
+	bool paced;
+
+	private:
+
+	//Skip decision for the next shown frame, kept while frames are hidden
+	bool shown_skip;
+
+	u32 skip_count;
+	u32 last_draw_time;
+};
+
+#endif // GBE_FRAME_SKIP
@@ -20,6 +20,7 @@
 #include <SDL_opengl.h>
 
 #include "common.h"
+#include "save_state.h"
 
 //Matrix class
 class gx_matrix
@@ -80,8 +81,8 @@ float dist(float x1, float y1, float x2, float y2);
 //3D distance
 float dist(float x1, float y1, float z1, float x2, float y2, float z2);
 
-//Serialize matrix data to/from binary file
-bool serialize_matrix(std::ifstream &file, gx_matrix &mat);
-bool serialize_matrix(std::ofstream &file, gx_matrix &mat);
+//Serialize matrix data to/from save states
+void serialize_matrix(state_reader &state, gx_matrix &mat);
+void serialize_matrix(state_writer &state, gx_matrix &mat);
 
 #endif // GBE_GX_UTIL
@@ -0,0 +1,352 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : hle_decompress.h
+// Date : October 17, 2026
+// Description : HLE BIOS decompression routines
+//
+// LZ77, Huffman, RL, and BitUnPack decoders shared by the GBA and NDS HLE BIOS
+// Plain RAM and VRAM are accessed through host pointers, everything else through the MMU
+
+#ifndef EMU_HLE_DECOMPRESS
+#define EMU_HLE_DECOMPRESS
+
+#include "common.h"
+
+template <typename mmu_type>
+struct hle_memory_span
+{
+	mmu_type* mem;
+	u8* ptr;
+	u32 addr;
+	u32 length;
+
+	//Range written through the host pointer, reported back to the MMU when done
+	u32 write_start;
+	u32 write_end;
+
+	hle_memory_span(mmu_type* ex_mem, u32 address, bool write)
+	{
+		mem = ex_mem;
+		addr = address;
+		length = 0;
+		ptr = mem->get_host_span(address, length, write);
+
+		write_start = 0xFFFFFFFF;
+		write_end = 0;
+	}
+
+	~hle_memory_span()
+	{
+		if(write_end > write_start) { mem->notify_host_write((addr + write_start), (write_end - write_start)); }
+	}
+
+	/****** Read 1 byte ******/
+	inline u8 read_u8(u32 address)
+	{
+		u32 offset = address - addr;
+		if(offset < length) { return ptr[offset]; }
+
+		return mem->read_u8(address);
+	}
+
+	/****** Read 2 bytes - Misaligned reads are left to the MMU ******/
+	inline u16 read_u16(u32 address)
+	{
+		u32 offset = address - addr;
+		if(((address & 0x1) == 0) && (offset < length) && ((length - offset) >= 2)) { return (ptr[offset] | (ptr[offset + 1] << 8)); }
+
+		return mem->read_u16(address);
+	}
+
+	/****** Read 4 bytes - Misaligned reads are left to the MMU ******/
+	inline u32 read_u32(u32 address)
+	{
+		u32 offset = address - addr;
+
+		if(((address & 0x3) == 0) && (offset < length) && ((length - offset) >= 4))
+		{
+			return (ptr[offset] | (ptr[offset + 1] << 8) | (ptr[offset + 2] << 16) | (u32(ptr[offset + 3]) << 24));
+		}
+
+		return mem->read_u32(address);
+	}
+
+	/****** Write 1 byte ******/
+	inline void write_u8(u32 address, u8 value)
+	{
+		u32 offset = address - addr;
+
+		if(offset < length)
+		{
+			ptr[offset] = value;
+			mark_write(offset, 1);
+		}
+
+		else { mem->write_u8(address, value); }
+	}
+
+	/****** Write 4 bytes - Misaligned writes are left to the MMU ******/
+	inline void write_u32(u32 address, u32 value)
+	{
+		u32 offset = address - addr;
+
+		if(((address & 0x3) == 0) && (offset < length) && ((length - offset) >= 4))
+		{
+			ptr[offset] = (value & 0xFF);
+			ptr[offset + 1] = ((value >> 8) & 0xFF);
+			ptr[offset + 2] = ((value >> 16) & 0xFF);
+			ptr[offset + 3] = ((value >> 24) & 0xFF);
+			mark_write(offset, 4);
+		}
+
+		else { mem->write_u32(address, value); }
+	}
+
+	inline void mark_write(u32 offset, u32 size)
+	{
+		if(offset < write_start) { write_start = offset; }
+		if((offset + size) > write_end) { write_end = offset + size; }
+	}
+};
+
+/****** LZ77 decompression - LZ77UnCompWram and LZ77UnCompVram ******/
+template <typename mmu_type>
+void hle_lz77_uncomp(mmu_type* mem, u32 src_addr, u32 dest_addr)
+{
+	hle_memory_span<mmu_type> src(mem, src_addr, false);
+	hle_memory_span<mmu_type> dest(mem, dest_addr, true);
+
+	//Grab compressed data size in bytes
+	u32 data_size = (src.read_u32(src_addr) >> 8);
+
+	//Pointer to current address of compressed data that needs to be processed
+	//When uncompression starts, move 5 bytes from source address (header + flag)
+	u32 data_ptr = (src_addr + 4);
+
+	while(data_size > 0)
+	{
+		//Grab flag data
+		u8 flag_data = src.read_u8(data_ptr++);
+
+		//Process 8 blocks
+		for(int x = 7; x >= 0; x--)
+		{
+			//Block Type 0 - Uncompressed
+			if((flag_data & (1 << x)) == 0)
+			{
+				dest.write_u8(dest_addr++, src.read_u8(data_ptr++));
+
+				data_size--;
+				if(data_size == 0) { return; }
+			}
+
+			//Block Type 1 - Compressed
+			else
+			{
+				u16 compressed_block = src.read_u16(data_ptr);
+				data_ptr += 2;
+
+				u16 distance = ((compressed_block & 0xF) << 8);
+				distance |= (compressed_block >> 8);
+
+				u8 length = ((compressed_block >> 4) & 0xF) + 3;
+
+				//Copy length+3 Bytes from dest_addr-length-1 to dest_addr
+				for(int y = 0; y < length; y++)
+				{
+					dest.write_u8(dest_addr, dest.read_u8(dest_addr - distance - 1));
+
+					dest_addr++;
+					data_size--;
+					if(data_size == 0) { return; }
+				}
+			}
+		}
+	}
+}
+
+/****** Huffman decompression - Returns the data bit-size from the header ******/
+template <typename mmu_type>
+u8 hle_huff_uncomp(mmu_type* mem, u32 src_addr, u32 dest_addr)
+{
+	hle_memory_span<mmu_type> src(mem, src_addr, false);
+	hle_memory_span<mmu_type> dest(mem, dest_addr, true);
+
+	u32 data_header = src.read_u32(src_addr);
+	u8 bit_size = (data_header & 0xF);
+
+	//Grab compressed data size in bytes - Data comes in units of 32-bits, 4 bytes
+	u32 data_size = ((data_header >> 8) + 3) & ~0x3;
+
+	//Pointer to current address that needs to be processed
+	//When uncompression start, points to data after the header (the first Tree Size attribute)
+	u32 data_ptr = (src_addr + 4);
+
+	u8 data_shift = 0;
+	u32 temp = 0;
+
+	//Grab Tree Size
+	u16 tree_size = src.read_u8(data_ptr++);
+	tree_size = ((tree_size + 1) * 2) - 1;
+
+	//Grab the root node
+	u32 root_node_addr = data_ptr;
+	u32 node_position = 0;
+
+	//Grab the 32-bit compressed bitstream
+	u32 bitstream_addr = (data_ptr + tree_size);
+	u32 bitstream = src.read_u32(bitstream_addr);
+	u32 bitstream_mask = 0x80000000;
+
+	bool is_data_node = false;
+
+	while(data_size > 0)
+	{
+		//Begin parsing the nodes, starting with root node
+		while(bitstream_mask != 0)
+		{
+			u8 node = src.read_u8(data_ptr);
+
+			//If this node is a data node, read data
+			if(is_data_node)
+			{
+				//Add data to 32-bit value
+				u8 data = (bit_size == 4) ? (node & 0xF) : node;
+				temp |= (data << data_shift);
+				data_shift += bit_size;
+
+				//Transfer completed 32-bit value to memory
+				if(data_shift >= 32)
+				{
+					dest.write_u32(dest_addr, temp);
+					dest_addr += 4;
+					data_size -= 4;
+					temp = 0;
+					data_shift = 0;
+
+					if(data_size == 0) { return bit_size; }
+				}
+
+				//Return to root node
+				data_ptr = root_node_addr;
+				is_data_node = false;
+				node_position = 0;
+			}
+
+			//If this node is a child node, continue along the binary trees
+			else
+			{
+				if(node_position == 0) { node_position++; }
+				else { node_position += (((node & 0x3F) + 1) * 2); }
+
+				//Read bitstream bit, decide if child_node.0 or child_node.1 should be looked at
+				bool bitstream_bit = (bitstream & bitstream_mask);
+				bitstream_mask >>= 1;
+
+				//Go offset for child_node.1
+				if(bitstream_bit)
+				{
+					data_ptr = (root_node_addr + node_position + 1);
+					is_data_node = (node & 0x40);
+				}
+
+				//Go offset for child_node.0
+				else
+				{
+					data_ptr = (root_node_addr + node_position);
+					is_data_node = (node & 0x80);
+				}
+			}
+		}
+
+		//After this 32-bit bitstream is complete, move onto the next bitstream
+		bitstream_addr += 4;
+		bitstream = src.read_u32(bitstream_addr);
+		bitstream_mask = 0x80000000;
+	}
+
+	return bit_size;
+}
+
+/****** Run-length decompression - RLUnCompWram and RLUnCompVram ******/
+template <typename mmu_type>
+void hle_rl_uncomp(mmu_type* mem, u32 src_addr, u32 dest_addr)
+{
+	hle_memory_span<mmu_type> src(mem, src_addr, false);
+	hle_memory_span<mmu_type> dest(mem, dest_addr, true);
+
+	u32 data_size = (src.read_u32(src_addr) >> 8);
+
+	//Data pointer to compressed data. Points to first flag.
+	u32 data_ptr = (src_addr + 4);
+
+	while(data_size > 0)
+	{
+		u8 flag = src.read_u8(data_ptr++);
+
+		//Adjust data length, +1 for uncompressed data, +3 for compressed data
+		u8 data_length = (flag & 0x7F);
+		data_length += (flag & 0x80) ? 3 : 1;
+
+		//Output the specified byte the amount of times in data_length
+		for(int x = 0; x < data_length; x++)
+		{
+			//Compressed runs repeat one byte, uncompressed runs copy every byte
+			u8 data_byte = (flag & 0x80) ? src.read_u8(data_ptr) : src.read_u8(data_ptr++);
+
+			dest.write_u8(dest_addr++, data_byte);
+			data_size--;
+
+			if(data_size == 0) { return; }
+		}
+
+		//Manually adjust data pointer for compressed data to point to next flag
+		if(flag & 0x80) { data_ptr++; }
+	}
+}
+
+/****** Expands packed bits to a wider width - BitUnPack ******/
+template <typename mmu_type>
+void hle_bit_unpack(mmu_type* mem, u32 src_addr, u32 dest_addr, u16 length, u8 src_width, u8 dest_width, u32 data_offset, bool zero_flag)
+{
+	hle_memory_span<mmu_type> src(mem, src_addr, false);
+	hle_memory_span<mmu_type> dest(mem, dest_addr, true);
+
+	u8 bit_mask = (1 << src_width) - 1;
+	u8 src_byte = 0;
+	u8 src_count = 0;
+
+	while(length > 0)
+	{
+		u32 result = 0;
+
+		//Cycle through the byte and expand to destination width
+		for(u8 x = 0; x < 32; x += dest_width)
+		{
+			//Grab new source byte
+			if((src_count % 8) == 0)
+			{
+				src_byte = src.read_u8(src_addr++);
+				length--;
+			}
+
+			//Grab the slice
+			u32 slice = (src_byte & bit_mask);
+			src_byte >>= src_width;
+			src_count += src_width;
+
+			if((slice != 0) || (zero_flag)) { slice += data_offset; }
+
+			//OR the slice to the final result
+			result |= (slice << x);
+		}
+
+		//Write result to the destination address
+		dest.write_u32(dest_addr, result);
+		dest_addr += 4;
+	}
+}
+
+#endif // EMU_HLE_DECOMPRESS
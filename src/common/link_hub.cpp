@@ -0,0 +1,567 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : link_hub.cpp
+// Date : October 17, 2026
+// Description : In-process link hub
+//
+// Stands in for TCP when several cores run inside one GBE+ process
+// Ports and connections behave like SDL_net's, but data only moves through shared memory
+// Lockstep sessions run every core in fixed cycle quanta, and data sent in one quantum is only seen after it ends
+
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "link_hub.h"
+
+#ifdef GBE_NETPLAY
+
+//Number of connections the hub can hold at once, must be a power of 2
+#define LINK_HUB_MAX_PIPES 64
+
+//Starting size of each connection's buffer, must be a power of 2
+#define LINK_HUB_PIPE_SIZE 0x1000
+
+//Marks a thread or connection end that no lockstep player owns
+#define LINK_HUB_NO_PLAYER 0xFF
+
+namespace
+{
+
+//Where the data a player sent during one quantum ends
+struct link_mark
+{
+	u32 end;
+	u32 tag;
+};
+
+//One-way connection from a client to a server
+struct link_pipe
+{
+	link_pipe()
+	{
+		lock = SDL_CreateMutex();
+		signal = SDL_CreateCond();
+		data.resize(LINK_HUB_PIPE_SIZE, 0);
+		reset();
+	}
+
+	void reset()
+	{
+		id = 0;
+		read_pos = 0;
+		write_pos = 0;
+		visible_pos = 0;
+		marks.clear();
+		client_closed = false;
+		server_closed = false;
+		writer = LINK_HUB_NO_PLAYER;
+		reader = LINK_HUB_NO_PLAYER;
+	}
+
+	//Each connection has its own lock, so cores on different connections never wait on each other
+	SDL_mutex* lock;
+	SDL_cond* signal;
+
+	//Connection ID using this slot, 0 while the slot is free
+	u32 id;
+
+	//Ring buffer of unread data - Positions are free-running, masked by the buffer size
+	std::vector<u8> data;
+	u32 read_pos;
+	u32 write_pos;
+
+	//Lockstep quanta the unread data was sent in, oldest first
+	std::vector<link_mark> marks;
+
+	//Where the data the reader may see ends, moved only when the reader finishes a quantum
+	u32 visible_pos;
+
+	bool client_closed;
+	bool server_closed;
+
+	//Lockstep players on either end
+	u8 writer;
+	u8 reader;
+};
+
+//One core in a lockstep session
+struct lockstep_player
+{
+	u32 quantum;
+	u32 blocked_id;
+	u8 blocked_on;
+	bool done;
+};
+
+//Listening ports, each with connections not yet accepted (like a TCP backlog)
+std::map<u16, std::deque<u32>> listeners;
+u32 next_serial = 1;
+
+//Lockstep session state, guarded by get_lockstep_lock()
+lockstep_player players[4];
+u8 total_players = 0;
+u32 quantum_cycles = 0;
+
+std::atomic<bool> lockstep_active(false);
+std::atomic<bool> lockstep_stopping(false);
+
+//Player whose core runs on the current thread, and how far along its quanta it is
+thread_local u8 current_player = LINK_HUB_NO_PLAYER;
+thread_local u32 current_quantum = 0;
+thread_local u32 current_cycles = 0;
+
+//Listeners and connection IDs share one lock - Only opening and closing connections takes it
+SDL_mutex* get_lock()
+{
+	static SDL_mutex* lock = SDL_CreateMutex();
+	return lock;
+}
+
+SDL_mutex* get_lockstep_lock()
+{
+	static SDL_mutex* lock = SDL_CreateMutex();
+	return lock;
+}
+
+SDL_cond* get_lockstep_signal()
+{
+	static SDL_cond* signal = SDL_CreateCond();
+	return signal;
+}
+
+//Every connection slot - IDs keep their slot in the low bits
+link_pipe* get_pipes()
+{
+	static link_pipe* pipes = new link_pipe[LINK_HUB_MAX_PIPES];
+	return pipes;
+}
+
+link_pipe& get_pipe(u32 id)
+{
+	return get_pipes()[id & (LINK_HUB_MAX_PIPES - 1)];
+}
+
+//Frees a connection's slot once both ends are closed - Call with the connection's lock held
+void release_pipe(link_pipe& pipe)
+{
+	if((pipe.client_closed) && (pipe.server_closed)) { pipe.reset(); }
+}
+
+//Returns where the data this thread may read right now ends - Call with the connection's lock held
+//Lockstep players only see what was there when they last finished a quantum, so reads never depend on thread timing
+u32 visible_end(link_pipe& pipe)
+{
+	if((!lockstep_active.load()) || (current_player == LINK_HUB_NO_PLAYER) || (pipe.client_closed)) { return pipe.write_pos; }
+
+	//Blocking reads may already have gone past it
+	return ((s32)(pipe.visible_pos - pipe.read_pos) > 0) ? pipe.visible_pos : pipe.read_pos;
+}
+
+//Lets a reader see everything sent to it in quanta before the given one - Call with the connection's lock held
+void show_pipe(link_pipe& pipe, u32 quantum)
+{
+	for(u32 x = 0; x < pipe.marks.size(); x++)
+	{
+		if(pipe.marks[x].tag >= quantum) { break; }
+		pipe.visible_pos = pipe.marks[x].end;
+	}
+}
+
+//Doubles a connection's buffer until a write fits - Unread data keeps its free-running positions
+void grow_pipe(link_pipe& pipe, u32 length)
+{
+	u32 size = pipe.data.size();
+	while(((pipe.write_pos - pipe.read_pos) + length) > size) { size <<= 1; }
+
+	std::vector<u8> temp(size, 0);
+
+	for(u32 pos = pipe.read_pos; pos != pipe.write_pos; pos++)
+	{
+		temp[pos & (size - 1)] = pipe.data[pos & (pipe.data.size() - 1)];
+	}
+
+	pipe.data.swap(temp);
+}
+
+//Marks whether a lockstep player is waiting on a connection - Call with the connection's lock held
+void set_blocked(link_pipe& pipe, u8 player, bool blocked)
+{
+	if((!lockstep_active.load()) || (player == LINK_HUB_NO_PLAYER)) { return; }
+
+	SDL_LockMutex(get_lockstep_lock());
+
+	if(blocked)
+	{
+		players[player].blocked_id = pipe.id;
+		players[player].blocked_on = pipe.writer;
+		SDL_CondBroadcast(get_lockstep_signal());
+	}
+
+	else if(players[player].blocked_id == pipe.id)
+	{
+		players[player].blocked_id = 0;
+		players[player].blocked_on = LINK_HUB_NO_PLAYER;
+	}
+
+	SDL_UnlockMutex(get_lockstep_lock());
+}
+
+//Returns true once every other player finished a quantum or is stuck waiting for data only this player can send
+//Call with the lockstep lock held
+bool all_arrived(u8 player, u32 quantum)
+{
+	for(u32 x = 0; x < total_players; x++)
+	{
+		if((x == player) || (players[x].done) || (players[x].quantum >= quantum)) { continue; }
+		if((players[x].blocked_id) && ((players[x].blocked_on == player) || (players[x].blocked_on == LINK_HUB_NO_PLAYER))) { continue; }
+
+		return false;
+	}
+
+	return true;
+}
+
+} //Namespace
+
+namespace link_hub
+{
+
+//Starts listening on a port, fails if something else already is
+bool listen(u16 port)
+{
+	SDL_LockMutex(get_lock());
+
+	bool result = (listeners.find(port) == listeners.end());
+	if(result) { listeners[port].clear(); }
+
+	SDL_UnlockMutex(get_lock());
+	return result;
+}
+
+//Stops listening on a port, connections never accepted are closed
+void unlisten(u16 port)
+{
+	SDL_LockMutex(get_lock());
+
+	auto listener = listeners.find(port);
+
+	if(listener != listeners.end())
+	{
+		for(u32 x = 0; x < listener->second.size(); x++) { close(listener->second[x], NET_COMM_SERVER); }
+		listeners.erase(listener);
+	}
+
+	SDL_UnlockMutex(get_lock());
+}
+
+//Connects to a listening port - Returns the connection ID or 0 if nothing is listening or every slot is taken
+u32 connect(u16 port)
+{
+	SDL_LockMutex(get_lock());
+
+	u32 id = 0;
+	auto listener = listeners.find(port);
+
+	if(listener != listeners.end())
+	{
+		link_pipe* pipes = get_pipes();
+
+		for(u32 x = 0; (x < LINK_HUB_MAX_PIPES) && (!id); x++)
+		{
+			SDL_LockMutex(pipes[x].lock);
+
+			if(!pipes[x].id)
+			{
+				id = (next_serial++ * LINK_HUB_MAX_PIPES) | x;
+				if(!id) { id = (next_serial++ * LINK_HUB_MAX_PIPES) | x; }
+
+				pipes[x].id = id;
+				pipes[x].writer = current_player;
+			}
+
+			SDL_UnlockMutex(pipes[x].lock);
+		}
+
+		if(id) { listener->second.push_back(id); }
+	}
+
+	SDL_UnlockMutex(get_lock());
+	return id;
+}
+
+//Accepts the oldest waiting connection on a port - Returns the connection ID or 0 if none are waiting
+u32 accept(u16 port)
+{
+	SDL_LockMutex(get_lock());
+
+	u32 id = 0;
+	auto listener = listeners.find(port);
+
+	if((listener != listeners.end()) && (!listener->second.empty()))
+	{
+		id = listener->second.front();
+		listener->second.pop_front();
+
+		link_pipe& pipe = get_pipe(id);
+
+		SDL_LockMutex(pipe.lock);
+		if(pipe.id == id) { pipe.reader = current_player; }
+		SDL_UnlockMutex(pipe.lock);
+	}
+
+	SDL_UnlockMutex(get_lock());
+	return id;
+}
+
+//Closes one end of a connection
+void close(u32 id, net_comm_role role)
+{
+	link_pipe& pipe = get_pipe(id);
+
+	SDL_LockMutex(pipe.lock);
+
+	if((id) && (pipe.id == id))
+	{
+		if(role == NET_COMM_SERVER) { pipe.server_closed = true; }
+		else { pipe.client_closed = true; }
+
+		SDL_CondBroadcast(pipe.signal);
+		release_pipe(pipe);
+	}
+
+	SDL_UnlockMutex(pipe.lock);
+}
+
+//Sends data from a client - Returns -1 if the connection is closed
+s32 send(u32 id, void* buffer, u32 length)
+{
+	link_pipe& pipe = get_pipe(id);
+
+	SDL_LockMutex(pipe.lock);
+
+	s32 result = -1;
+
+	if((id) && (pipe.id == id) && (!pipe.client_closed) && (!pipe.server_closed))
+	{
+		if(((pipe.write_pos - pipe.read_pos) + length) > pipe.data.size()) { grow_pipe(pipe, length); }
+
+		//Copy in at most two pieces, one up to the end of the buffer and one wrapped around to the start
+		u32 mask = pipe.data.size() - 1;
+		u32 start = pipe.write_pos & mask;
+		u32 first = ((start + length) > pipe.data.size()) ? (pipe.data.size() - start) : length;
+
+		memcpy(&pipe.data[start], buffer, first);
+		memcpy(&pipe.data[0], (u8*)buffer + first, length - first);
+
+		pipe.write_pos += length;
+		result = length;
+
+		//Record which quantum this data belongs to
+		if((!pipe.marks.empty()) && (pipe.marks.back().tag == current_quantum)) { pipe.marks.back().end = pipe.write_pos; }
+		else { pipe.marks.push_back({ pipe.write_pos, current_quantum }); }
+
+		SDL_CondBroadcast(pipe.signal);
+
+		//A reader waiting on this connection is no longer stuck
+		set_blocked(pipe, pipe.reader, false);
+	}
+
+	SDL_UnlockMutex(pipe.lock);
+	return result;
+}
+
+//Receives data on a server - Returns -1 once the client has closed and everything sent was read
+s32 recv(u32 id, void* buffer, u32 length, bool is_blocking)
+{
+	link_pipe& pipe = get_pipe(id);
+
+	SDL_LockMutex(pipe.lock);
+
+	//Blocking waits for at least one byte, like SDLNet_TCP_Recv, and takes it even if sent in a quantum not yet finished
+	//Lockstep players waiting here let the player they wait on run ahead until it sends something
+	if((is_blocking) && (id) && (pipe.id == id) && (pipe.read_pos == pipe.write_pos) && (!pipe.client_closed))
+	{
+		set_blocked(pipe, current_player, true);
+
+		while((pipe.id == id) && (pipe.read_pos == pipe.write_pos) && (!pipe.client_closed) && (!lockstep_stopping.load()))
+		{
+			SDL_CondWait(pipe.signal, pipe.lock);
+		}
+
+		set_blocked(pipe, current_player, false);
+	}
+
+	s32 result = -1;
+
+	if((id) && (pipe.id == id))
+	{
+		u32 end = (is_blocking) ? pipe.write_pos : visible_end(pipe);
+		u32 count = ((end - pipe.read_pos) < length) ? (end - pipe.read_pos) : length;
+
+		//Copy out at most two pieces, same as send()
+		u32 mask = pipe.data.size() - 1;
+		u32 start = pipe.read_pos & mask;
+		u32 first = ((start + count) > pipe.data.size()) ? (pipe.data.size() - start) : count;
+
+		memcpy(buffer, &pipe.data[start], first);
+		memcpy((u8*)buffer + first, &pipe.data[0], count - first);
+
+		pipe.read_pos += count;
+
+		//Forget quanta that were read completely
+		u32 done = 0;
+		while((done < pipe.marks.size()) && ((s32)(pipe.marks[done].end - pipe.read_pos) <= 0)) { done++; }
+		if(done) { pipe.marks.erase(pipe.marks.begin(), pipe.marks.begin() + done); }
+
+		if(count) { result = count; }
+		else if((!pipe.client_closed) && (!lockstep_stopping.load())) { result = 0; }
+	}
+
+	SDL_UnlockMutex(pipe.lock);
+	return result;
+}
+
+//Waits up to a timeout (in ms) for a connection to have data - Returns 1 if data is ready or the connection closed, 0 otherwise
+s32 wait(u32 id, u32 timeout)
+{
+	link_pipe& pipe = get_pipe(id);
+
+	SDL_LockMutex(pipe.lock);
+
+	if((timeout) && (id) && (pipe.id == id) && (visible_end(pipe) == pipe.read_pos) && (!pipe.client_closed))
+	{
+		SDL_CondWaitTimeout(pipe.signal, pipe.lock, timeout);
+	}
+
+	s32 result = ((!id) || (pipe.id != id) || (visible_end(pipe) != pipe.read_pos) || (pipe.client_closed)) ? 1 : 0;
+
+	SDL_UnlockMutex(pipe.lock);
+	return result;
+}
+
+//Returns how many bytes can be read right now, or -1 once the client has closed and everything sent was read
+s32 ready(u32 id)
+{
+	link_pipe& pipe = get_pipe(id);
+
+	SDL_LockMutex(pipe.lock);
+
+	s32 result = -1;
+
+	if((id) && (pipe.id == id))
+	{
+		result = visible_end(pipe) - pipe.read_pos;
+		if((!result) && (pipe.client_closed)) { result = -1; }
+	}
+
+	SDL_UnlockMutex(pipe.lock);
+	return result;
+}
+
+//Starts a lockstep session - Each player then runs a fixed number of cycles before waiting for the rest
+void start_lockstep(u8 count, u32 quantum)
+{
+	SDL_LockMutex(get_lockstep_lock());
+
+	total_players = (count > 4) ? 4 : count;
+	quantum_cycles = quantum;
+
+	for(u32 x = 0; x < 4; x++)
+	{
+		players[x].quantum = 0;
+		players[x].blocked_id = 0;
+		players[x].blocked_on = LINK_HUB_NO_PLAYER;
+		players[x].done = false;
+	}
+
+	lockstep_stopping.store(false);
+	lockstep_active.store(true);
+
+	SDL_UnlockMutex(get_lockstep_lock());
+}
+
+//Releases every player waiting on the session, so their cores can shut down
+void stop_lockstep()
+{
+	SDL_LockMutex(get_lockstep_lock());
+
+	lockstep_stopping.store(true);
+	SDL_CondBroadcast(get_lockstep_signal());
+
+	SDL_UnlockMutex(get_lockstep_lock());
+
+	link_pipe* pipes = get_pipes();
+
+	for(u32 x = 0; x < LINK_HUB_MAX_PIPES; x++)
+	{
+		SDL_LockMutex(pipes[x].lock);
+		SDL_CondBroadcast(pipes[x].signal);
+		SDL_UnlockMutex(pipes[x].lock);
+	}
+}
+
+//Binds the current thread to a lockstep player - Call before that player's core opens any connections
+void join_lockstep(u8 player)
+{
+	current_player = (player < 4) ? player : LINK_HUB_NO_PLAYER;
+	current_quantum = 0;
+	current_cycles = 0;
+}
+
+//Marks a player as finished, others stop waiting for it
+void leave_lockstep(u8 player)
+{
+	if(player >= 4) { return; }
+
+	SDL_LockMutex(get_lockstep_lock());
+
+	players[player].done = true;
+	SDL_CondBroadcast(get_lockstep_signal());
+
+	SDL_UnlockMutex(get_lockstep_lock());
+
+	if(current_player == player) { current_player = LINK_HUB_NO_PLAYER; }
+}
+
+//Counts cycles run by the current thread's core - Waits for the other players at the end of each quantum
+void step_lockstep(u32 cycles)
+{
+	if((current_player == LINK_HUB_NO_PLAYER) || (!lockstep_active.load())) { return; }
+
+	current_cycles += cycles;
+	if(current_cycles < quantum_cycles) { return; }
+
+	current_cycles -= quantum_cycles;
+
+	SDL_LockMutex(get_lockstep_lock());
+
+	current_quantum = ++players[current_player].quantum;
+	SDL_CondBroadcast(get_lockstep_signal());
+
+	while((!lockstep_stopping.load()) && (!all_arrived(current_player, current_quantum)))
+	{
+		SDL_CondWait(get_lockstep_signal(), get_lockstep_lock());
+	}
+
+	SDL_UnlockMutex(get_lockstep_lock());
+
+	//Every other player either finished this quantum or waits on this one, so what they sent before it is complete
+	//Anything sent later, even for an earlier quantum, waits until this player finishes its next quantum
+	link_pipe* pipes = get_pipes();
+
+	for(u32 x = 0; x < LINK_HUB_MAX_PIPES; x++)
+	{
+		SDL_LockMutex(pipes[x].lock);
+		if((pipes[x].id) && (pipes[x].reader == current_player)) { show_pipe(pipes[x], current_quantum); }
+		SDL_UnlockMutex(pipes[x].lock);
+	}
+}
+
+} //Namespace
+
+#endif
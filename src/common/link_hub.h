@@ -0,0 +1,43 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : link_hub.h
+// Date : October 17, 2026
+// Description : In-process link hub
+//
+// Stands in for TCP when several cores run inside one GBE+ process
+// Ports and connections behave like SDL_net's, but data only moves through shared memory
+// Lockstep sessions run every core in fixed cycle quanta, and data sent in one quantum is only seen after it ends
+
+#ifndef GBE_LINK_HUB
+#define GBE_LINK_HUB
+
+#include "net_util.h"
+
+#ifdef GBE_NETPLAY
+
+namespace link_hub
+{
+	bool listen(u16 port);
+	void unlisten(u16 port);
+
+	u32 connect(u16 port);
+	u32 accept(u16 port);
+	void close(u32 id, net_comm_role role);
+
+	s32 send(u32 id, void* buffer, u32 length);
+	s32 recv(u32 id, void* buffer, u32 length, bool is_blocking);
+	s32 wait(u32 id, u32 timeout);
+	s32 ready(u32 id);
+
+	void start_lockstep(u8 count, u32 quantum);
+	void stop_lockstep();
+	void join_lockstep(u8 player);
+	void leave_lockstep(u8 player);
+	void step_lockstep(u32 cycles);
+};
+
+#endif
+
+#endif // GBE_LINK_HUB
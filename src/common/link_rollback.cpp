@@ -0,0 +1,233 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : link_rollback.cpp
+// Date : October 17, 2026
+// Description : Rollback for link cable netplay
+//
+// Transfers started by this system complete right away with a predicted reply instead of waiting on the network
+// Keeps a snapshot of every recent frame plus the input and incoming transfers seen during them
+// When a real reply differs from its prediction, the core reloads the frame it happened in and runs forward again
+
+#include "link_rollback.h"
+
+/****** Link rollback constructor ******/
+link_rollback::link_rollback() { reset(0); }
+
+/****** Link rollback destructor ******/
+link_rollback::~link_rollback() { }
+
+/****** Clears all history - Keeps snapshots for the given number of frames, 0 disables rollback ******/
+void link_rollback::reset(u32 max_frames)
+{
+	frames.clear();
+	if(max_frames) { frames.resize(max_frames + 1); }
+
+	for(u32 x = 0; x < frames.size(); x++) { frames[x].input = 0; }
+
+	frame_count = 0;
+	frame_step = 0;
+	started = false;
+
+	transfers.clear();
+	events.clear();
+	last_reply = 0xFFFFFFFF;
+
+	mispredicted = false;
+	mispredicted_frame = 0;
+
+	replay = false;
+	replay_frame = 0;
+	transfer_cursor = 0;
+	event_cursor = 0;
+}
+
+/****** Returns true once rollback is set up and the first frame has started ******/
+bool link_rollback::enabled() { return (!frames.empty()) && (started); }
+
+/****** Starts a new frame - Returns the buffer its snapshot goes in ******/
+std::vector<u8>& link_rollback::begin_frame(u32 input)
+{
+	if(started) { frame_count++; }
+	started = true;
+
+	frame_step = 0;
+	trim();
+
+	frame_entry& entry = frames[frame_count % frames.size()];
+	entry.input = input;
+
+	return entry.state;
+}
+
+/****** Returns the snapshot taken at the start of a frame ******/
+std::vector<u8>& link_rollback::frame_state(u32 frame) { return frames[frame % frames.size()].state; }
+
+/****** Returns the input held at the start of a frame ******/
+u32 link_rollback::frame_input(u32 frame) { return frames[frame % frames.size()].input; }
+
+/****** Returns the number of the frame currently running ******/
+u32 link_rollback::current_frame() { return frame_count; }
+
+/****** Completes a transfer started by this system - Replays known replies while resimulating, otherwise predicts one ******/
+bool link_rollback::next_local_transfer(u32 &reply)
+{
+	u32 frame = (replay) ? replay_frame : frame_count;
+
+	//Transfers already sent keep their confirmed reply, unconfirmed ones use the latest prediction
+	if((replay) && (transfer_cursor < transfers.size()))
+	{
+		transfer_entry& entry = transfers[transfer_cursor++];
+
+		if(!entry.confirmed) { entry.value = last_reply; }
+		entry.frame = frame;
+
+		reply = entry.value;
+		return false;
+	}
+
+	//Predict the other system answers the same way it did last time
+	transfer_entry entry;
+	entry.frame = frame;
+	entry.value = last_reply;
+	entry.confirmed = false;
+
+	transfers.push_back(entry);
+	if(replay) { transfer_cursor++; }
+
+	reply = last_reply;
+	return true;
+}
+
+/****** Matches a reply from the other system with the oldest transfer still waiting on one ******/
+void link_rollback::confirm_transfer(u32 reply)
+{
+	last_reply = reply;
+
+	for(u32 x = 0; x < transfers.size(); x++)
+	{
+		transfer_entry& entry = transfers[x];
+		if(entry.confirmed) { continue; }
+
+		entry.confirmed = true;
+
+		//Wrong guess, everything from this frame onward has to run again
+		if(entry.value != reply)
+		{
+			entry.value = reply;
+
+			if((!mispredicted) || (entry.frame < mispredicted_frame)) { mispredicted_frame = entry.frame; }
+			mispredicted = true;
+		}
+
+		return;
+	}
+}
+
+/****** Records something that changed the emulated system from outside during the current frame ******/
+void link_rollback::log_event(u8 type, u32 data)
+{
+	if((replay) || (!enabled())) { return; }
+
+	event_entry entry;
+	entry.frame = frame_count;
+	entry.step = frame_step;
+	entry.type = type;
+	entry.data = data;
+
+	events.push_back(entry);
+}
+
+/****** Returns the next recorded event due at this point of the resimulation ******/
+bool link_rollback::next_event(u8 &type, u32 &data)
+{
+	if((!replay) || (event_cursor >= events.size())) { return false; }
+
+	event_entry& entry = events[event_cursor];
+
+	//Events are applied at the same instruction they happened on, or as soon as possible if the new timeline is shorter
+	if((entry.frame < replay_frame) || ((entry.frame == replay_frame) && (entry.step <= frame_step)))
+	{
+		type = entry.type;
+		data = entry.data;
+		event_cursor++;
+		return true;
+	}
+
+	return false;
+}
+
+/****** Returns true if a reply did not match its prediction ******/
+bool link_rollback::needs_rollback() { return mispredicted; }
+
+/****** Returns true if the oldest unconfirmed transfer is about to lose its snapshot ******/
+bool link_rollback::must_wait()
+{
+	if(!enabled()) { return false; }
+
+	u32 window = frames.size() - 1;
+
+	for(u32 x = 0; x < transfers.size(); x++)
+	{
+		if(!transfers[x].confirmed) { return ((transfers[x].frame + window) <= frame_count); }
+	}
+
+	return false;
+}
+
+/****** Returns the frame resimulation starts from ******/
+u32 link_rollback::rollback_frame() { return mispredicted_frame; }
+
+/****** Starts resimulating from the rollback frame - Its snapshot must be loaded first ******/
+void link_rollback::begin_replay()
+{
+	replay = true;
+	replay_frame = mispredicted_frame;
+	mispredicted = false;
+	frame_step = 0;
+
+	transfer_cursor = 0;
+	while((transfer_cursor < transfers.size()) && (transfers[transfer_cursor].frame < replay_frame)) { transfer_cursor++; }
+
+	event_cursor = 0;
+	while((event_cursor < events.size()) && (events[event_cursor].frame < replay_frame)) { event_cursor++; }
+}
+
+/****** Moves resimulation to the next frame - Returns the buffer its new snapshot goes in ******/
+std::vector<u8>& link_rollback::replay_next_frame(u32 input)
+{
+	replay_frame++;
+	frame_step = 0;
+
+	frame_entry& entry = frames[replay_frame % frames.size()];
+	entry.input = input;
+
+	return entry.state;
+}
+
+/****** Finishes resimulating ******/
+void link_rollback::end_replay() { replay = false; }
+
+/****** Returns true while resimulating ******/
+bool link_rollback::replaying() { return replay; }
+
+/****** Drops history no rollback can reach anymore ******/
+void link_rollback::trim()
+{
+	u32 oldest = frame_count;
+
+	for(u32 x = 0; x < transfers.size(); x++)
+	{
+		if(!transfers[x].confirmed)
+		{
+			if(transfers[x].frame < oldest) { oldest = transfers[x].frame; }
+			break;
+		}
+	}
+
+	if((mispredicted) && (mispredicted_frame < oldest)) { oldest = mispredicted_frame; }
+
+	while((!transfers.empty()) && (transfers.front().frame < oldest)) { transfers.pop_front(); }
+	while((!events.empty()) && (events.front().frame < oldest)) { events.pop_front(); }
+}
@@ -0,0 +1,261 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : link_rollback.h
+// Date : October 17, 2026
+// Description : Rollback for link cable netplay
+//
+// Transfers started by this system complete right away with a predicted reply instead of waiting on the network
+// Keeps a snapshot of every recent frame plus the input and incoming transfers seen during them
+// When a real reply differs from its prediction, the core reloads the frame it happened in and runs forward again
+
+#ifndef GBE_LINK_ROLLBACK
+#define GBE_LINK_ROLLBACK
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <deque>
+
+#include "config.h"
+
+//Events replayed while resimulating
+const u8 LINK_EVENT_INPUT = 0;
+const u8 LINK_EVENT_TRANSFER = 1;
+
+class link_rollback
+{
+	public:
+
+	link_rollback();
+	~link_rollback();
+
+	void reset(u32 max_frames);
+	bool enabled();
+
+	//Frame snapshots - Cores serialize into the returned buffer at the start of every frame
+	std::vector<u8>& begin_frame(u32 input);
+	std::vector<u8>& frame_state(u32 frame);
+	u32 frame_input(u32 frame);
+	u32 current_frame();
+
+	//Transfers started by this system - Returns true if the transfer is new and has to be sent
+	bool next_local_transfer(u32 &reply);
+	void confirm_transfer(u32 reply);
+
+	//Input changes and transfers started by the other system
+	void log_event(u8 type, u32 data);
+	bool next_event(u8 &type, u32 &data);
+
+	//Resimulation
+	bool needs_rollback();
+	bool must_wait();
+	u32 rollback_frame();
+	void begin_replay();
+	std::vector<u8>& replay_next_frame(u32 input);
+	void end_replay();
+	bool replaying();
+
+	//Per-frame work shared by the cores, see the hooks listed below
+	template <typename core_type> void update(core_type& core, u32 frame_steps);
+	template <typename core_type> void resimulate(core_type& core, u32 frame_steps);
+	template <typename core_type> void save_frame(core_type& core, std::vector<u8>& buffer);
+	template <typename core_type> bool load_frame(core_type& core, std::vector<u8>& buffer);
+	template <typename core_type> void apply_events(core_type& core);
+
+	//Instructions run since the current frame started
+	u32 frame_step;
+
+	private:
+
+	struct frame_entry
+	{
+		u32 input;
+		std::vector<u8> state;
+	};
+
+	struct transfer_entry
+	{
+		u32 frame;
+		u32 value;
+		bool confirmed;
+	};
+
+	struct event_entry
+	{
+		u32 frame;
+		u32 step;
+		u8 type;
+		u32 data;
+	};
+
+	void trim();
+
+	//Snapshots for the last few frames, indexed by frame number
+	std::vector<frame_entry> frames;
+	u32 frame_count;
+	bool started;
+
+	//Transfers started by this system, oldest first
+	std::deque<transfer_entry> transfers;
+	u32 last_reply;
+
+	std::deque<event_entry> events;
+
+	bool mispredicted;
+	u32 mispredicted_frame;
+
+	bool replay;
+	u32 replay_frame;
+	u32 transfer_cursor;
+	u32 event_cursor;
+};
+
+//Cores using the templates below provide these hooks
+//get_link_input(), set_link_input(u32), restore_link_input(u32) - Joypad state kept per frame
+//apply_link_event(u8, u32) - Applies one recorded input change or transfer
+//step_link() - Runs one instruction while resimulating
+//mute_link_audio(bool) - Keeps resimulated frames silent
+//link_cycles() - Cycles carried over between frames, saved with each snapshot
+//Their SIO provides receive_byte(), wait_receive(u32), link_lost(), and restore_link_status()
+
+/****** Keeps link cable netplay in step with rollback - Cores call this once per frame ******/
+template <typename core_type> void link_rollback::update(core_type& core, u32 frame_steps)
+{
+	auto& sio = core.core_cpu.controllers.serial_io;
+
+	//Never let a prediction outlive the snapshots kept for it - Sleep on the receiving thread until the reply shows up
+	u32 wait_start = SDL_GetTicks();
+
+	while(must_wait())
+	{
+		if(sio.link_lost())
+		{
+			std::cout<<"SIO::Error - Netplay connection lost while waiting on rollback. Closing connection.\n";
+			sio.reset();
+			sio.init();
+			return;
+		}
+
+		if((SDL_GetTicks() - wait_start) >= 10000)
+		{
+			std::cout<<"SIO::Error - Timed out waiting on netplay rollback. Closing connection.\n";
+			sio.reset();
+			sio.init();
+			return;
+		}
+
+		//Keep the window responsive - Local link sessions handle events on the main thread instead
+		if(!config::netplay_local) { SDL_PumpEvents(); }
+
+		sio.wait_receive(100);
+		sio.receive_byte();
+	}
+
+	if(needs_rollback()) { resimulate(core, frame_steps); }
+
+	save_frame(core, begin_frame(core.get_link_input()));
+}
+
+/****** Runs every frame since a wrong prediction again with the real replies ******/
+template <typename core_type> void link_rollback::resimulate(core_type& core, u32 frame_steps)
+{
+	auto& video = core.core_cpu.controllers.video;
+
+	u32 frame = rollback_frame();
+	u32 last_frame = current_frame();
+	u32 live_input = core.get_link_input();
+
+	begin_replay();
+
+	if(!load_frame(core, frame_state(frame)))
+	{
+		end_replay();
+		return;
+	}
+
+	core.set_link_input(frame_input(frame));
+
+	//Past frames make no sound and are never shown
+	core.mute_link_audio(true);
+	video.frame_skip.set_hidden(true);
+
+	u32 current = video.frame_count;
+	u32 max_steps = (last_frame - frame + 1) * frame_steps;
+
+	//Run up to the start of the live frame, taking new snapshots along the way
+	for(u32 x = 0; (core.core_cpu.running) && (x < max_steps); x++)
+	{
+		apply_events(core);
+
+		if(video.frame_count != current)
+		{
+			current = video.frame_count;
+			if(++frame > last_frame) { break; }
+
+			save_frame(core, replay_next_frame(core.get_link_input()));
+			continue;
+		}
+
+		core.step_link();
+		frame_step++;
+	}
+
+	//Anything left over happens right away
+	frame_step = 0xFFFFFFFF;
+	apply_events(core);
+
+	end_replay();
+
+	core.restore_link_input(live_input);
+	core.mute_link_audio(false);
+	video.frame_skip.set_hidden(false);
+}
+
+/****** Saves a snapshot for rollback - Save states leave out SIO, so it is added at the end ******/
+template <typename core_type> void link_rollback::save_frame(core_type& core, std::vector<u8>& buffer)
+{
+	auto& sio_stat = core.core_cpu.controllers.serial_io.sio_stat;
+
+	u32 size = core.get_state_size();
+	u32 cycles = core.link_cycles();
+
+	buffer.resize(size + sizeof(sio_stat) + sizeof(u32));
+
+	core.serialize_state(&buffer[0], size);
+	memcpy(&buffer[size], &sio_stat, sizeof(sio_stat));
+	memcpy(&buffer[size + sizeof(sio_stat)], &cycles, sizeof(u32));
+}
+
+/****** Loads a snapshot for rollback - The network side of SIO stays as it is now ******/
+template <typename core_type> bool link_rollback::load_frame(core_type& core, std::vector<u8>& buffer)
+{
+	auto& sio = core.core_cpu.controllers.serial_io;
+
+	u32 extra = sizeof(sio.sio_stat) + sizeof(u32);
+	if(buffer.size() <= extra) { return false; }
+
+	u32 size = buffer.size() - extra;
+	if(!core.read_state_chunks(&buffer[0], size)) { return false; }
+
+	auto live = sio.sio_stat;
+
+	memcpy(&sio.sio_stat, &buffer[size], sizeof(sio.sio_stat));
+	memcpy(&core.link_cycles(), &buffer[size + sizeof(sio.sio_stat)], sizeof(u32));
+
+	sio.restore_link_status(live);
+
+	return true;
+}
+
+/****** Applies recorded input and transfers due at this point of a resimulation ******/
+template <typename core_type> void link_rollback::apply_events(core_type& core)
+{
+	u8 type = 0;
+	u32 data = 0;
+
+	while(next_event(type, data)) { core.apply_link_event(type, data); }
+}
+
+#endif // GBE_LINK_ROLLBACK
@@ -0,0 +1,289 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : net_receiver.cpp
+// Date : October 17, 2026
+// Description : Network receiving thread
+//
+// Polls a netplay connection on its own thread and splits the stream into fixed-size packets
+// Packets go into a single-producer/single-consumer queue, so the emulation thread only checks an atomic
+// Connections through the in-process link hub are read directly instead, without a thread
+
+#include "net_receiver.h"
+#include "link_hub.h"
+
+#ifdef GBE_NETPLAY
+
+//Number of packets the queue holds, must be a power of 2
+#define NET_RECEIVER_QUEUE_SIZE 256
+
+/****** Network receiver constructor ******/
+net_receiver::net_receiver()
+{
+	thread = nullptr;
+	lock = nullptr;
+	signal = nullptr;
+
+	quit = false;
+	lost = false;
+	direct = false;
+
+	source = nullptr;
+	packet_size = 0;
+	mask = 0;
+
+	write_pos = 0;
+	read_pos = 0;
+}
+
+/****** Network receiver destructor ******/
+net_receiver::~net_receiver()
+{
+	stop();
+
+	if(signal != nullptr) { SDL_DestroyCond(signal); }
+	if(lock != nullptr) { SDL_DestroyMutex(lock); }
+}
+
+/****** Starts reading packets of a given size from a connection - Does nothing if already running ******/
+bool net_receiver::start(gbe_net_comm* comm, u32 size)
+{
+	if((thread != nullptr) || (direct)) { return true; }
+	if((comm == nullptr) || (!comm->remote_init) || (size == 0)) { return false; }
+
+	//The link hub already queues data in memory, so read it as the emulation thread asks for packets
+	//Lockstep sessions also need those reads to happen on the core's own thread
+	if(comm->is_local)
+	{
+		source = comm;
+		packet_size = size;
+		lost.store(false);
+		direct = true;
+		return true;
+	}
+
+	if(lock == nullptr) { lock = SDL_CreateMutex(); }
+	if(signal == nullptr) { signal = SDL_CreateCond(); }
+
+	if((lock == nullptr) || (signal == nullptr))
+	{
+		std::cout<<"SIO::Error - Could not create network receiver lock\n";
+		return false;
+	}
+
+	source = comm;
+	packet_size = size;
+	packets.assign(NET_RECEIVER_QUEUE_SIZE * size, 0);
+	mask = NET_RECEIVER_QUEUE_SIZE - 1;
+
+	write_pos.store(0, std::memory_order_relaxed);
+	read_pos.store(0, std::memory_order_relaxed);
+	quit.store(false);
+	lost.store(false);
+
+	thread = SDL_CreateThread(thread_main, "GBE+ Net Receiver", this);
+
+	if(thread == nullptr)
+	{
+		std::cout<<"SIO::Error - Could not start network receiver thread\n";
+		return false;
+	}
+
+	return true;
+}
+
+/****** Stops the receiving thread and drops any queued packets ******/
+void net_receiver::stop()
+{
+	if(direct)
+	{
+		direct = false;
+		source = nullptr;
+		return;
+	}
+
+	if(thread == nullptr) { return; }
+
+	quit.store(true);
+
+	//Wake anything blocked in wait()
+	SDL_LockMutex(lock);
+	SDL_CondBroadcast(signal);
+	SDL_UnlockMutex(lock);
+
+	SDL_WaitThread(thread, nullptr);
+	thread = nullptr;
+	source = nullptr;
+
+	write_pos.store(0, std::memory_order_relaxed);
+	read_pos.store(0, std::memory_order_relaxed);
+}
+
+/****** Returns true if the receiving thread is active ******/
+bool net_receiver::running()
+{
+	return ((thread != nullptr) || (direct));
+}
+
+/****** Returns true if at least one full packet is waiting ******/
+bool net_receiver::pending()
+{
+	if(direct) { return (link_hub::ready(source->local_id) >= (s32)packet_size); }
+
+	return (write_pos.load(std::memory_order_acquire) != read_pos.load(std::memory_order_relaxed));
+}
+
+/****** Returns true once the connection has dropped and every packet received before that was read ******/
+bool net_receiver::disconnected()
+{
+	if(direct) { return ((lost.load()) || (link_hub::ready(source->local_id) < 0)); }
+
+	return ((lost.load()) && (!pending()));
+}
+
+/****** Copies the oldest packet if one is waiting - Never blocks ******/
+bool net_receiver::pop(u8* packet)
+{
+	if(direct) { return (pending()) && (link_hub::recv(source->local_id, packet, packet_size, false) == (s32)packet_size); }
+
+	u32 r = read_pos.load(std::memory_order_relaxed);
+	if(write_pos.load(std::memory_order_acquire) == r) { return false; }
+
+	u32 offset = (r & mask) * packet_size;
+	for(u32 x = 0; x < packet_size; x++) { packet[x] = packets[offset + x]; }
+
+	read_pos.store(r + 1, std::memory_order_release);
+	return true;
+}
+
+/****** Blocks until a packet arrives - Returns false if the connection drops or the receiver stops first ******/
+bool net_receiver::wait(u8* packet)
+{
+	//Packets are always sent whole, but keep reading until one is complete anyway
+	if(direct)
+	{
+		u32 filled = 0;
+
+		while(filled < packet_size)
+		{
+			s32 bytes_recv = link_hub::recv(source->local_id, packet + filled, packet_size - filled, NET_COMM_IS_BLOCKING);
+
+			if(bytes_recv <= 0)
+			{
+				lost.store(true);
+				return false;
+			}
+
+			filled += bytes_recv;
+		}
+
+		return true;
+	}
+
+	if(thread == nullptr) { return false; }
+
+	SDL_LockMutex(lock);
+
+	while((!pending()) && (!lost.load()) && (!quit.load()))
+	{
+		SDL_CondWaitTimeout(signal, lock, 100);
+	}
+
+	SDL_UnlockMutex(lock);
+
+	return pop(packet);
+}
+
+/****** Blocks until a packet arrives or the timeout (in ms) passes - The packet stays queued for pop() ******/
+bool net_receiver::wait_pending(u32 timeout)
+{
+	if(direct)
+	{
+		link_hub::wait(source->local_id, timeout);
+		return pending();
+	}
+
+	if(thread == nullptr) { return false; }
+
+	SDL_LockMutex(lock);
+
+	if((!pending()) && (!lost.load()) && (!quit.load())) { SDL_CondWaitTimeout(signal, lock, timeout); }
+
+	SDL_UnlockMutex(lock);
+
+	return pending();
+}
+
+/****** Adds one packet to the queue - Returns false if the queue is full ******/
+bool net_receiver::push(const u8* packet)
+{
+	u32 w = write_pos.load(std::memory_order_relaxed);
+	if((w - read_pos.load(std::memory_order_acquire)) >= NET_RECEIVER_QUEUE_SIZE) { return false; }
+
+	u32 offset = (w & mask) * packet_size;
+	for(u32 x = 0; x < packet_size; x++) { packets[offset + x] = packet[x]; }
+
+	write_pos.store(w + 1, std::memory_order_release);
+
+	SDL_LockMutex(lock);
+	SDL_CondSignal(signal);
+	SDL_UnlockMutex(lock);
+
+	return true;
+}
+
+/****** Receiving thread - Waits on the socket and reassembles packets split across TCP reads ******/
+int net_receiver::thread_main(void* data)
+{
+	net_receiver* self = (net_receiver*)data;
+	gbe_net_comm* comm = self->source;
+
+	std::vector<u8> partial(self->packet_size, 0);
+	u32 filled = 0;
+	bool full = false;
+
+	while(!self->quit.load())
+	{
+		//Hold onto a complete packet until the emulation thread makes room for it
+		if(full)
+		{
+			if(self->push(partial.data()))
+			{
+				full = false;
+				filled = 0;
+			}
+
+			else
+			{
+				SDL_Delay(1);
+				continue;
+			}
+		}
+
+		//Short timeout so stop() never waits long
+		if(net_util::check_sockets(*comm, 10) <= 0) { continue; }
+		if(!net_util::socket_ready(*comm)) { continue; }
+
+		s32 bytes_recv = net_util::recv_data(*comm, partial.data() + filled, self->packet_size - filled, NET_COMM_IS_BLOCKING);
+
+		//Remote side closed or errored out
+		if(bytes_recv <= 0)
+		{
+			self->lost.store(true);
+
+			SDL_LockMutex(self->lock);
+			SDL_CondBroadcast(self->signal);
+			SDL_UnlockMutex(self->lock);
+
+			break;
+		}
+
+		filled += bytes_recv;
+		if(filled >= self->packet_size) { full = true; }
+	}
+
+	return 0;
+}
+
+#endif
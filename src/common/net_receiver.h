@@ -0,0 +1,71 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : net_receiver.h
+// Date : October 17, 2026
+// Description : Network receiving thread
+//
+// Polls a netplay connection on its own thread and splits the stream into fixed-size packets
+// Packets go into a single-producer/single-consumer queue, so the emulation thread only checks an atomic
+// Connections through the in-process link hub are read directly instead, without a thread
+
+#ifndef GBE_NET_RECEIVER
+#define GBE_NET_RECEIVER
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+#include "net_util.h"
+
+#ifdef GBE_NETPLAY
+
+class net_receiver
+{
+	public:
+
+	net_receiver();
+	~net_receiver();
+
+	bool start(gbe_net_comm* comm, u32 size);
+	void stop();
+	bool running();
+
+	bool pending();
+	bool disconnected();
+	bool pop(u8* packet);
+	bool wait(u8* packet);
+	bool wait_pending(u32 timeout);
+
+	private:
+
+	static int thread_main(void* data);
+	bool push(const u8* packet);
+
+	SDL_Thread* thread;
+	SDL_mutex* lock;
+	SDL_cond* signal;
+
+	std::atomic<bool> quit;
+	std::atomic<bool> lost;
+
+	//Reading straight from the link hub on the emulation thread
+	bool direct;
+
+	//Connection being read - Only the receiving thread touches its remote socket while running
+	gbe_net_comm* source;
+	u32 packet_size;
+
+	//Queued packets, each one packet_size bytes long
+	std::vector<u8> packets;
+	u32 mask;
+
+	//Free-running positions, only the receiving thread moves write_pos and only the emulation thread moves read_pos
+	std::atomic<u32> write_pos;
+	std::atomic<u32> read_pos;
+};
+
+#endif
+
+#endif // GBE_NET_RECEIVER
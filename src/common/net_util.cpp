@@ -10,6 +10,7 @@
 // Intended to help with transition from SDL_net 2.2.0 to 3.0+
 
 #include "net_util.h"
+#include "link_hub.h"
 
 #ifdef GBE_NETPLAY
 
@@ -19,6 +20,7 @@ namespace net_util
 //Sends data from server to remote client
 s32 send_data(gbe_net_comm &client, void* buffer, u32 length, bool is_blocking)
 {
+	if(client.is_local) { return (client.local_id) ? link_hub::send(client.local_id, buffer, length) : 0; }
 	if(client.host_socket == nullptr) { return 0; }
 
 	return SDLNet_TCP_Send(client.host_socket, buffer, length);
@@ -27,6 +29,7 @@ s32 send_data(gbe_net_comm &client, void* buffer, u32 length, bool is_blocking)
 //Receives data from remote client sent to server
 s32 recv_data(gbe_net_comm &server, void* buffer, u32 length, bool is_blocking)
 {
+	if(server.is_local) { return (server.local_id) ? link_hub::recv(server.local_id, buffer, length, is_blocking) : 0; }
 	if(server.remote_socket == nullptr) { return 0; }
 
 	s32 bytes_recv = 0;
@@ -66,6 +69,8 @@ s32 recv_response(gbe_net_comm &client, void* buffer, u32 length)
 //Resolves hostname from a given IP address
 s32 resolve_host(gbe_net_comm &req, std::string ip_address)
 {
+	if(req.is_local) { return 0; }
+
 	s32 result = 0;
 	
 	if(ip_address.empty())
@@ -81,11 +86,38 @@ s32 resolve_host(gbe_net_comm &req, std::string ip_address)
 	return result;
 }
 
+//Waits up to a timeout (in ms) for incoming data, same as SDLNet_CheckSockets
+s32 check_sockets(gbe_net_comm &req, u32 timeout)
+{
+	if(req.is_local) { return (req.local_id) ? link_hub::wait(req.local_id, timeout) : 0; }
+	if(req.tcp_sockets == nullptr) { return 0; }
+
+	return SDLNet_CheckSockets(req.tcp_sockets, timeout);
+}
+
+//Returns true if the remote client has data (or hung up) after check_sockets
+bool socket_ready(gbe_net_comm &req)
+{
+	if(req.is_local) { return (req.local_id) && (link_hub::wait(req.local_id, 0) > 0); }
+	if(req.remote_socket == nullptr) { return false; }
+
+	return SDLNet_SocketReady(req.remote_socket);
+}
+
 //Opens a TCP connection
 bool open_tcp(gbe_net_comm &req)
 {
 	bool result = false;
 
+	//Servers listen on the hub, clients connect through it
+	if(req.is_local)
+	{
+		if(req.role == NET_COMM_SERVER) { result = req.local_host = link_hub::listen(req.port); }
+		else { req.local_id = link_hub::connect(req.port); result = (req.local_id != 0); }
+
+		return result;
+	}
+
 	req.host_socket = SDLNet_TCP_Open(&req.host_ip);
 	if(req.host_socket != nullptr) { result = true; }
 
@@ -95,6 +127,13 @@ bool open_tcp(gbe_net_comm &req)
 //Closes a TCP connection
 void close_tcp(gbe_net_comm &req, net_comm_role role)
 {
+	if(req.is_local)
+	{
+		if((role == NET_COMM_SERVER) && (req.local_host)) { link_hub::unlisten(req.port); req.local_host = false; }
+		else if(role == NET_COMM_CLIENT) { link_hub::close(req.local_id, req.role); req.local_id = 0; }
+		return;
+	}
+
 	if(role == NET_COMM_SERVER)
 	{
 		SDLNet_TCP_Close(req.host_socket);
@@ -109,6 +148,16 @@ void close_tcp(gbe_net_comm &req, net_comm_role role)
 //Accepts a connection from a client for a server
 bool accept_client(gbe_net_comm &req)
 {
+	if(req.is_local)
+	{
+		if(req.local_host) { req.local_id = link_hub::accept(req.port); }
+		if(!req.local_id) { return false; }
+
+		req.connected = true;
+		req.remote_init = true;
+		return true;
+	}
+
 	if(req.host_socket == nullptr) { return false; }
 
 	bool result = false;
@@ -142,12 +191,12 @@ bool accept_server(gbe_net_comm &req)
 	{
 		result = true;
 
-		if(req.tcp_sockets == nullptr)
+		if((req.tcp_sockets == nullptr) && (!req.is_local))
 		{
 			req.tcp_sockets = SDLNet_AllocSocketSet(2);
 		}
 
-		SDLNet_TCP_AddSocket(req.tcp_sockets, req.host_socket);
+		if(!req.is_local) { SDLNet_TCP_AddSocket(req.tcp_sockets, req.host_socket); }
 		req.connected = true;
 		req.host_init = true;
 	}
@@ -156,7 +205,7 @@ bool accept_server(gbe_net_comm &req)
 }
 
 //Handles setup of client or server
-void setup_comm(gbe_net_comm &req, u16 port, net_comm_role role)
+void setup_comm(gbe_net_comm &req, u16 port, net_comm_role role, bool is_local)
 {
 	req.host_socket = nullptr;
 	req.host_init = false;
@@ -166,11 +215,24 @@ void setup_comm(gbe_net_comm &req, u16 port, net_comm_role role)
 	req.port = port;
 	req.role = role;
 	req.tcp_sockets = nullptr;
+	req.is_local = is_local;
+	req.local_host = false;
+	req.local_id = 0;
 }
 
 //Closes any active connections for client or server
 void close_comm(gbe_net_comm &req)
 {
+	//Close both ends that belong to this side of the hub
+	if(req.is_local)
+	{
+		if(req.local_host) { link_hub::unlisten(req.port); }
+		if(req.local_id) { link_hub::close(req.local_id, req.role); }
+
+		req.local_host = false;
+		req.local_id = 0;
+	}
+
 	bool is_valid_socket = (req.tcp_sockets != nullptr);
 
 	if(is_valid_socket)
@@ -44,6 +44,11 @@ struct gbe_net_comm
 	bool remote_init;
 	u16 port;
 	net_comm_role role;
+
+	//In-process link hub, used instead of the sockets above
+	bool is_local = false;
+	bool local_host = false;
+	u32 local_id = 0;
 };
 
 namespace net_util
@@ -53,6 +58,8 @@ namespace net_util
 	s32 send_response(gbe_net_comm &client, void* buffer, u32 length);
 	s32 recv_response(gbe_net_comm &client, void* buffer, u32 length);
 	s32 resolve_host(gbe_net_comm &req, std::string ip_address);
+	s32 check_sockets(gbe_net_comm &req, u32 timeout);
+	bool socket_ready(gbe_net_comm &req);
 
 	bool accept_client(gbe_net_comm &req);
 	bool accept_server(gbe_net_comm &req);
@@ -60,7 +67,7 @@ namespace net_util
 	bool open_tcp(gbe_net_comm &req);
 	void close_tcp(gbe_net_comm &req, net_comm_role role);
 
-	void setup_comm(gbe_net_comm &req, u16 port, net_comm_role role);
+	void setup_comm(gbe_net_comm &req, u16 port, net_comm_role role, bool is_local = false);
 	void close_comm(gbe_net_comm &req);
 };
 
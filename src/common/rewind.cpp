@@ -0,0 +1,209 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : rewind.cpp
+// Date : October 17, 2026
+// Description : Rewind history
+//
+// Keeps a history of serialized save states in a fixed-size ring
+// Only the newest state is kept whole, older ones are stored as XOR/RLE deltas against the next newer one
+
+#include <cstring>
+
+#include "rewind.h"
+
+namespace
+{
+	//Matching bytes needed to end a literal run - Shorter gaps cost more to encode than to copy
+	const u32 DELTA_MIN_RUN = 8;
+
+	/****** Appends a 32-bit value to a delta ******/
+	void put_u32(std::vector<u8> &data, u32 value)
+	{
+		u8 bytes[4];
+		memcpy(bytes, &value, 4);
+		data.insert(data.end(), bytes, bytes + 4);
+	}
+
+	/****** Reads a 32-bit value from a delta ******/
+	u32 get_u32(const u8* data)
+	{
+		u32 value = 0;
+		memcpy(&value, data, 4);
+		return value;
+	}
+}
+
+/****** Rewind buffer constructor ******/
+rewind_buffer::rewind_buffer() { reset(0); }
+
+/****** Rewind buffer destructor ******/
+rewind_buffer::~rewind_buffer() { }
+
+/****** Clears all history and sets the memory used for deltas ******/
+void rewind_buffer::reset(u32 capacity)
+{
+	ring.clear();
+	ring.resize(capacity, 0);
+	entries.clear();
+	ring_head = 0;
+	ring_used = 0;
+
+	current.clear();
+	has_current = false;
+}
+
+/****** Adds a new snapshot - The previous one is kept as a delta against it ******/
+void rewind_buffer::push(std::vector<u8> &state)
+{
+	if(ring.empty()) { return; }
+
+	//States of different sizes cannot be diffed, start history over
+	if((has_current) && (state.size() == current.size()))
+	{
+		encode_delta(state);
+		store_delta();
+	}
+
+	else
+	{
+		entries.clear();
+		ring_head = 0;
+		ring_used = 0;
+	}
+
+	current = state;
+	has_current = true;
+}
+
+/****** Returns the newest snapshot and steps history back by one - The oldest snapshot is never removed ******/
+bool rewind_buffer::pop(std::vector<u8> &state)
+{
+	if(!has_current) { return false; }
+
+	state = current;
+
+	if(entries.empty()) { return true; }
+
+	//Copy the newest delta out of the ring, it may wrap around
+	delta_entry entry = entries.back();
+	entries.pop_back();
+
+	u32 first = ring.size() - entry.start;
+	if(first > entry.length) { first = entry.length; }
+
+	scratch.resize(entry.length);
+	if(first) { memcpy(scratch.data(), &ring[entry.start], first); }
+	if(entry.length > first) { memcpy(scratch.data() + first, &ring[0], entry.length - first); }
+
+	apply_delta(entry.length);
+
+	ring_head = entry.start;
+	ring_used -= entry.length;
+
+	return true;
+}
+
+/****** Returns the number of snapshots held ******/
+u32 rewind_buffer::count() { return entries.size() + (has_current ? 1 : 0); }
+
+/****** Returns the bytes used by all snapshots ******/
+u32 rewind_buffer::used() { return ring_used + current.size(); }
+
+/****** Encodes the difference between the newest snapshot and the next one ******/
+void rewind_buffer::encode_delta(std::vector<u8> &next_state)
+{
+	const u8* old_data = current.data();
+	const u8* new_data = next_state.data();
+	u32 length = next_state.size();
+	u32 x = 0;
+
+	scratch.clear();
+
+	//Each run is stored as - Skipped bytes (4 bytes), Literal length (4 bytes), XORed literal bytes
+	while(x < length)
+	{
+		u32 skip_start = x;
+
+		//Skip matching bytes, 8 at a time where possible
+		while(((x + 8) <= length) && (!memcmp(old_data + x, new_data + x, 8))) { x += 8; }
+		while((x < length) && (old_data[x] == new_data[x])) { x++; }
+
+		if(x >= length) { break; }
+
+		u32 skip = x - skip_start;
+		u32 literal_start = x;
+		u32 match = 0;
+
+		//Grab differing bytes until a long enough run of matching ones shows up
+		while((x < length) && (match < DELTA_MIN_RUN))
+		{
+			match = (old_data[x] == new_data[x]) ? (match + 1) : 0;
+			x++;
+		}
+
+		x -= match;
+
+		put_u32(scratch, skip);
+		put_u32(scratch, x - literal_start);
+
+		for(u32 y = literal_start; y < x; y++) { scratch.push_back(old_data[y] ^ new_data[y]); }
+	}
+}
+
+/****** Applies a delta held in scratch to the newest snapshot ******/
+void rewind_buffer::apply_delta(u32 length)
+{
+	u8* data = current.data();
+	u32 pos = 0;
+	u32 x = 0;
+
+	while((pos + 8) <= length)
+	{
+		x += get_u32(&scratch[pos]);
+		u32 literal_length = get_u32(&scratch[pos + 4]);
+		pos += 8;
+
+		for(u32 y = 0; y < literal_length; y++) { data[x + y] ^= scratch[pos + y]; }
+
+		x += literal_length;
+		pos += literal_length;
+	}
+}
+
+/****** Moves the delta held in scratch into the ring, dropping the oldest history to make room ******/
+void rewind_buffer::store_delta()
+{
+	u32 length = scratch.size();
+	u32 capacity = ring.size();
+
+	//A delta larger than the whole ring cannot be kept, history before it is lost
+	if(length > capacity)
+	{
+		entries.clear();
+		ring_head = 0;
+		ring_used = 0;
+		return;
+	}
+
+	while((capacity - ring_used) < length)
+	{
+		ring_used -= entries.front().length;
+		entries.pop_front();
+	}
+
+	u32 first = capacity - ring_head;
+	if(first > length) { first = length; }
+
+	if(first) { memcpy(&ring[ring_head], scratch.data(), first); }
+	if(length > first) { memcpy(&ring[0], scratch.data() + first, length - first); }
+
+	delta_entry entry;
+	entry.start = ring_head;
+	entry.length = length;
+	entries.push_back(entry);
+
+	ring_head = (ring_head + length) % capacity;
+	ring_used += length;
+}
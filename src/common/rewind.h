@@ -0,0 +1,59 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : rewind.h
+// Date : October 17, 2026
+// Description : Rewind history
+//
+// Keeps a history of serialized save states in a fixed-size ring
+// Only the newest state is kept whole, older ones are stored as XOR/RLE deltas against the next newer one
+
+#ifndef GBE_REWIND
+#define GBE_REWIND
+
+#include <vector>
+#include <deque>
+
+#include "common.h"
+
+class rewind_buffer
+{
+	public:
+
+	rewind_buffer();
+	~rewind_buffer();
+
+	void reset(u32 capacity);
+	void push(std::vector<u8> &state);
+	bool pop(std::vector<u8> &state);
+
+	u32 count();
+	u32 used();
+
+	private:
+
+	struct delta_entry
+	{
+		u32 start;
+		u32 length;
+	};
+
+	void encode_delta(std::vector<u8> &next_state);
+	void apply_delta(u32 length);
+	void store_delta();
+
+	//Compressed deltas, oldest first
+	std::vector<u8> ring;
+	std::deque<delta_entry> entries;
+	u32 ring_head;
+	u32 ring_used;
+
+	//Newest snapshot
+	std::vector<u8> current;
+	bool has_current;
+
+	std::vector<u8> scratch;
+};
+
+#endif // GBE_REWIND
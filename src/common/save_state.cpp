@@ -0,0 +1,264 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : save_state.cpp
+// Date : October 17, 2026
+// Description : In-memory save state serialization
+//
+// Writes and reads save states to and from contiguous byte buffers
+// A state starts with a fixed header (version, system type, date) followed by tagged, versioned chunks
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "save_state.h"
+
+namespace
+{
+	//ID (4 bytes) + Version (4 bytes) + Length (4 bytes)
+	const u32 STATE_CHUNK_HEADER_SIZE = 12;
+
+	/****** Reads a little-endian 32-bit value from a buffer ******/
+	u32 read_u32(const u8* data) { return (data[3] << 24) | (data[2] << 16) | (data[1] << 8) | data[0]; }
+
+	/****** Writes a little-endian 32-bit value to a buffer ******/
+	void write_u32(u8* data, u32 value)
+	{
+		data[0] = (value & 0xFF);
+		data[1] = ((value >> 8) & 0xFF);
+		data[2] = ((value >> 16) & 0xFF);
+		data[3] = ((value >> 24) & 0xFF);
+	}
+
+	/****** Converts a chunk ID into readable text ******/
+	std::string chunk_name(u32 id)
+	{
+		std::string name = "";
+		for(u32 x = 0; x < 4; x++)
+		{
+			char letter = ((id >> (x * 8)) & 0xFF);
+			if(letter != ' ') { name += letter; }
+		}
+
+		return name;
+	}
+}
+
+/****** State writer constructor ******/
+state_writer::state_writer(u8* ex_buffer, u32 ex_capacity)
+{
+	buffer = ex_buffer;
+	capacity = ex_capacity;
+	position = 0;
+	chunk_start = 0;
+	overflow = false;
+}
+
+/****** State writer destructor ******/
+state_writer::~state_writer() { }
+
+/****** Appends data to the state - Only counts bytes when measuring or after running out of space ******/
+void state_writer::write(const void* data, u32 length)
+{
+	if((buffer != NULL) && (!overflow))
+	{
+		if(length > (capacity - position)) { overflow = true; }
+		else { memcpy(buffer + position, data, length); }
+	}
+
+	position += length;
+}
+
+/****** Starts a new chunk - Its length is filled in by end_chunk() ******/
+void state_writer::begin_chunk(u32 id, u32 version)
+{
+	u8 header[STATE_CHUNK_HEADER_SIZE];
+
+	write_u32(header, id);
+	write_u32(header + 4, version);
+	write_u32(header + 8, 0);
+
+	chunk_start = position;
+	write(header, STATE_CHUNK_HEADER_SIZE);
+}
+
+/****** Finishes the current chunk ******/
+void state_writer::end_chunk()
+{
+	if((buffer == NULL) || (overflow)) { return; }
+	write_u32(buffer + chunk_start + 8, position - chunk_start - STATE_CHUNK_HEADER_SIZE);
+}
+
+/****** Returns the number of bytes written (or needed) so far ******/
+u32 state_writer::size() { return position; }
+
+/****** Returns true if everything written so far fit in the buffer ******/
+bool state_writer::good() { return !overflow; }
+
+/****** State reader constructor ******/
+state_reader::state_reader(const u8* ex_buffer, u32 ex_length)
+{
+	buffer = ex_buffer;
+	length = (ex_buffer != NULL) ? ex_length : 0;
+	position = 0;
+	chunk_end = length;
+	underflow = false;
+}
+
+/****** State reader destructor ******/
+state_reader::~state_reader() { }
+
+/****** Copies data out of the current chunk - Missing bytes are zero-filled ******/
+void state_reader::read(void* data, u32 data_length)
+{
+	if(data_length > (chunk_end - position))
+	{
+		memset(data, 0, data_length);
+		underflow = true;
+		position = chunk_end;
+		return;
+	}
+
+	memcpy(data, buffer + position, data_length);
+	position += data_length;
+}
+
+/****** Locates a chunk after the header ******/
+bool state_reader::find_chunk(u32 id, u32 &version, u32 &start, u32 &chunk_length)
+{
+	u32 offset = STATE_HEADER_SIZE;
+
+	while((offset <= length) && ((length - offset) >= STATE_CHUNK_HEADER_SIZE))
+	{
+		u32 current_id = read_u32(buffer + offset);
+		u32 current_length = read_u32(buffer + offset + 8);
+
+		offset += STATE_CHUNK_HEADER_SIZE;
+
+		//Stop on chunks that claim to run past the end of the buffer
+		if(current_length > (length - offset)) { return false; }
+
+		if(current_id == id)
+		{
+			version = read_u32(buffer + offset - 8);
+			start = offset;
+			chunk_length = current_length;
+			return true;
+		}
+
+		offset += current_length;
+	}
+
+	return false;
+}
+
+/****** Checks that a chunk exists with the expected version ******/
+bool state_reader::has_chunk(u32 id, u32 version)
+{
+	u32 chunk_version = 0;
+	u32 start = 0;
+	u32 chunk_length = 0;
+
+	if(!find_chunk(id, chunk_version, start, chunk_length))
+	{
+		std::cout<<"GBE::Error - Save State has no " << chunk_name(id) << " data. Cannot load save.\n";
+		return false;
+	}
+
+	if(chunk_version != version)
+	{
+		std::cout<<"GBE::Error - Save State has outdated " << chunk_name(id) << " data. Cannot load save.\n";
+		return false;
+	}
+
+	return true;
+}
+
+/****** Moves reading to the start of a chunk ******/
+bool state_reader::open_chunk(u32 id, u32 version)
+{
+	u32 chunk_version = 0;
+	u32 start = 0;
+	u32 chunk_length = 0;
+
+	if((!find_chunk(id, chunk_version, start, chunk_length)) || (chunk_version != version))
+	{
+		underflow = true;
+		position = chunk_end = 0;
+		return false;
+	}
+
+	position = start;
+	chunk_end = start + chunk_length;
+	return true;
+}
+
+/****** Finishes reading a chunk - Fails if the chunk was not read exactly to its end ******/
+bool state_reader::close_chunk()
+{
+	if(position != chunk_end) { underflow = true; }
+
+	position = 0;
+	chunk_end = length;
+
+	return !underflow;
+}
+
+/****** Returns true if every read so far was satisfied ******/
+bool state_reader::good() { return !underflow; }
+
+/****** Reads a state into a core, leaving the core as it was if the state turns out to be damaged ******/
+bool restore_state(const u8* buffer, u32 length, std::function<u32(u8*, u32)> serialize, std::function<bool(const u8*, u32)> read_chunks)
+{
+	//Chunk contents can only be checked by reading them, so keep the current state in case one turns out to be damaged
+	std::vector<u8> backup(serialize(NULL, 0));
+
+	if((backup.empty()) || (!serialize(&backup[0], backup.size())))
+	{
+		std::cout<<"GBE::Error - Could not back up the current state. Cannot load save.\n";
+		return false;
+	}
+
+	if(read_chunks(buffer, length)) { return true; }
+
+	read_chunks(&backup[0], backup.size());
+
+	std::cout<<"GBE::Error - Save State is damaged. Cannot load save.\n";
+	return false;
+}
+
+/****** Writes a serialized state to a file in one go ******/
+bool write_state_file(std::string filename, std::vector<u8> &data)
+{
+	//Never truncate an existing state without something to replace it
+	if(data.empty()) { return false; }
+
+	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+	if(!file.is_open()) { return false; }
+
+	file.write((char*)&data[0], data.size());
+	file.close();
+
+	return file.good();
+}
+
+/****** Reads a whole save state file into memory ******/
+bool read_state_file(std::string filename, std::vector<u8> &data)
+{
+	std::ifstream file(filename.c_str(), std::ios::binary);
+	if(!file.is_open()) { return false; }
+
+	file.seekg(0, std::ios::end);
+	u32 file_size = file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	if(file_size < STATE_HEADER_SIZE) { return false; }
+
+	data.resize(file_size);
+	file.read((char*)&data[0], file_size);
+	file.close();
+
+	return true;
+}
@@ -0,0 +1,87 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : save_state.h
+// Date : October 17, 2026
+// Description : In-memory save state serialization
+//
+// Writes and reads save states to and from contiguous byte buffers
+// A state starts with a fixed header (version, system type, date) followed by tagged, versioned chunks
+
+#ifndef GBE_SAVE_STATE
+#define GBE_SAVE_STATE
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common.h"
+
+//Version (4 bytes) + System type (1 byte) + Date (32 bytes)
+const u32 STATE_HEADER_SIZE = 37;
+
+//Chunk IDs - 4 ASCII characters stored little-endian
+const u32 STATE_CHUNK_CPU = 0x20555043;
+const u32 STATE_CHUNK_CPU_2 = 0x32555043;
+const u32 STATE_CHUNK_MMU = 0x20554D4D;
+const u32 STATE_CHUNK_APU = 0x20555041;
+const u32 STATE_CHUNK_LCD = 0x2044434C;
+
+class state_writer
+{
+	public:
+
+	//A NULL buffer only measures how many bytes the state needs
+	state_writer(u8* ex_buffer, u32 ex_capacity);
+	~state_writer();
+
+	void write(const void* data, u32 length);
+	void begin_chunk(u32 id, u32 version);
+	void end_chunk();
+
+	u32 size();
+	bool good();
+
+	private:
+
+	u8* buffer;
+	u32 capacity;
+	u32 position;
+	u32 chunk_start;
+	bool overflow;
+};
+
+class state_reader
+{
+	public:
+
+	state_reader(const u8* ex_buffer, u32 ex_length);
+	~state_reader();
+
+	void read(void* data, u32 data_length);
+	bool has_chunk(u32 id, u32 version);
+	bool open_chunk(u32 id, u32 version);
+	bool close_chunk();
+
+	bool good();
+
+	private:
+
+	bool find_chunk(u32 id, u32 &version, u32 &start, u32 &chunk_length);
+
+	const u8* buffer;
+	u32 length;
+	u32 position;
+	u32 chunk_end;
+	bool underflow;
+};
+
+//Reads a state with read_chunks(), putting back the state serialize() captured first if any chunk is damaged
+bool restore_state(const u8* buffer, u32 length, std::function<u32(u8*, u32)> serialize, std::function<bool(const u8*, u32)> read_chunks);
+
+//Save state files hold a single serialized buffer
+bool write_state_file(std::string filename, std::vector<u8> &data);
+bool read_state_file(std::string filename, std::vector<u8> &data);
+
+#endif // GBE_SAVE_STATE
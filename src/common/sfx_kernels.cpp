@@ -0,0 +1,388 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : sfx_kernels.cpp
+// Date : October 17, 2026
+// Description : Colour special effect kernels
+//
+// Alpha blending and brightness adjustments applied to whole lines of ARGB pixels
+// Uses AVX2 or SSE2 when the host CPU supports them, plain C++ otherwise
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GBE_SFX_X86
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#endif
+
+//GCC and Clang need each SIMD function marked with its instruction set, MSVC does not
+#if defined(__GNUC__) || defined(__clang__)
+#define SFX_TARGET(x) __attribute__((target(x)))
+#else
+#define SFX_TARGET(x)
+#endif
+
+#include "sfx_kernels.h"
+
+namespace
+{
+	typedef void (*blend_kernel)(u32*, const u32*, const u32*, u8, u8, u32);
+	typedef void (*brightness_kernel)(u32*, const u32*, u8, u32);
+
+	struct sfx_kernel_table
+	{
+		std::string name;
+		blend_kernel alpha_blend;
+		brightness_kernel brightness_up[2];
+		brightness_kernel brightness_down[2];
+	};
+
+	/****** Alpha blending - Scalar ******/
+	void alpha_blend_scalar(u32* dest, const u32* src_1, const u32* src_2, u8 eva, u8 evb, u32 length)
+	{
+		for(u32 x = 0; x < length; x++)
+		{
+			u32 result = 0xFF000000;
+
+			for(u32 shift = 3; shift < 24; shift += 8)
+			{
+				u32 c1 = (src_1[x] >> shift) & 0x1F;
+				u32 c2 = (src_2[x] >> shift) & 0x1F;
+				u32 c = ((c1 * eva) + (c2 * evb)) >> 4;
+
+				result |= (((c > 0x1F) ? 0x1F : c) << shift);
+			}
+
+			dest[x] = result;
+		}
+	}
+
+	/****** Brightness increase - Scalar ******/
+	template <u32 bits>
+	void brightness_up_scalar(u32* dest, const u32* src, u8 evy, u32 length)
+	{
+		const u32 max = (1 << bits) - 1;
+
+		for(u32 x = 0; x < length; x++)
+		{
+			u32 result = 0xFF000000;
+
+			for(u32 shift = (8 - bits); shift < 24; shift += 8)
+			{
+				u32 c = (src[x] >> shift) & max;
+				c += (((max - c) * evy) >> 4);
+
+				result |= (((c > max) ? max : c) << shift);
+			}
+
+			dest[x] = result;
+		}
+	}
+
+	/****** Brightness decrease - Scalar ******/
+	template <u32 bits>
+	void brightness_down_scalar(u32* dest, const u32* src, u8 evy, u32 length)
+	{
+		const u32 max = (1 << bits) - 1;
+		const u32 coef = 16 - ((evy > 16) ? 16 : evy);
+
+		for(u32 x = 0; x < length; x++)
+		{
+			u32 result = 0xFF000000;
+
+			for(u32 shift = (8 - bits); shift < 24; shift += 8)
+			{
+				u32 c = (src[x] >> shift) & max;
+				result |= (((c * coef) >> 4) << shift);
+			}
+
+			dest[x] = result;
+		}
+	}
+
+#ifdef GBE_SFX_X86
+
+	//All channel math stays below 16 bits, so 16-bit multiplies work on the 32-bit lanes
+	//The upper half of each lane is always 0 * 0
+
+	/****** Alpha blending - SSE2 ******/
+	SFX_TARGET("sse2") void alpha_blend_sse2(u32* dest, const u32* src_1, const u32* src_2, u8 eva, u8 evb, u32 length)
+	{
+		const __m128i mask = _mm_set1_epi32(0x1F);
+		const __m128i alpha = _mm_set1_epi32(0xFF000000);
+		const __m128i coef_a = _mm_set1_epi32(eva);
+		const __m128i coef_b = _mm_set1_epi32(evb);
+
+		u32 x = 0;
+
+		for(; (x + 4) <= length; x += 4)
+		{
+			__m128i c1 = _mm_loadu_si128((const __m128i*)(src_1 + x));
+			__m128i c2 = _mm_loadu_si128((const __m128i*)(src_2 + x));
+
+			__m128i r = _mm_add_epi32(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(c1, 19), mask), coef_a), _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(c2, 19), mask), coef_b));
+			__m128i g = _mm_add_epi32(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(c1, 11), mask), coef_a), _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(c2, 11), mask), coef_b));
+			__m128i b = _mm_add_epi32(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(c1, 3), mask), coef_a), _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(c2, 3), mask), coef_b));
+
+			r = _mm_min_epi16(_mm_srli_epi32(r, 4), mask);
+			g = _mm_min_epi16(_mm_srli_epi32(g, 4), mask);
+			b = _mm_min_epi16(_mm_srli_epi32(b, 4), mask);
+
+			__m128i result = _mm_or_si128(alpha, _mm_or_si128(_mm_slli_epi32(r, 19), _mm_or_si128(_mm_slli_epi32(g, 11), _mm_slli_epi32(b, 3))));
+			_mm_storeu_si128((__m128i*)(dest + x), result);
+		}
+
+		alpha_blend_scalar(dest + x, src_1 + x, src_2 + x, eva, evb, length - x);
+	}
+
+	/****** Brightness increase - SSE2 ******/
+	template <u32 bits>
+	SFX_TARGET("sse2") void brightness_up_sse2(u32* dest, const u32* src, u8 evy, u32 length)
+	{
+		const __m128i max = _mm_set1_epi32((1 << bits) - 1);
+		const __m128i alpha = _mm_set1_epi32(0xFF000000);
+		const __m128i coef = _mm_set1_epi32(evy);
+
+		u32 x = 0;
+
+		for(; (x + 4) <= length; x += 4)
+		{
+			__m128i color = _mm_loadu_si128((const __m128i*)(src + x));
+
+			__m128i r = _mm_and_si128(_mm_srli_epi32(color, 24 - bits), max);
+			__m128i g = _mm_and_si128(_mm_srli_epi32(color, 16 - bits), max);
+			__m128i b = _mm_and_si128(_mm_srli_epi32(color, 8 - bits), max);
+
+			r = _mm_min_epi16(_mm_add_epi32(r, _mm_srli_epi32(_mm_mullo_epi16(_mm_sub_epi32(max, r), coef), 4)), max);
+			g = _mm_min_epi16(_mm_add_epi32(g, _mm_srli_epi32(_mm_mullo_epi16(_mm_sub_epi32(max, g), coef), 4)), max);
+			b = _mm_min_epi16(_mm_add_epi32(b, _mm_srli_epi32(_mm_mullo_epi16(_mm_sub_epi32(max, b), coef), 4)), max);
+
+			__m128i result = _mm_or_si128(alpha, _mm_or_si128(_mm_slli_epi32(r, 24 - bits), _mm_or_si128(_mm_slli_epi32(g, 16 - bits), _mm_slli_epi32(b, 8 - bits))));
+			_mm_storeu_si128((__m128i*)(dest + x), result);
+		}
+
+		brightness_up_scalar<bits>(dest + x, src + x, evy, length - x);
+	}
+
+	/****** Brightness decrease - SSE2 ******/
+	template <u32 bits>
+	SFX_TARGET("sse2") void brightness_down_sse2(u32* dest, const u32* src, u8 evy, u32 length)
+	{
+		const __m128i max = _mm_set1_epi32((1 << bits) - 1);
+		const __m128i alpha = _mm_set1_epi32(0xFF000000);
+		const __m128i coef = _mm_set1_epi32(16 - ((evy > 16) ? 16 : evy));
+
+		u32 x = 0;
+
+		for(; (x + 4) <= length; x += 4)
+		{
+			__m128i color = _mm_loadu_si128((const __m128i*)(src + x));
+
+			__m128i r = _mm_srli_epi32(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(color, 24 - bits), max), coef), 4);
+			__m128i g = _mm_srli_epi32(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(color, 16 - bits), max), coef), 4);
+			__m128i b = _mm_srli_epi32(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(color, 8 - bits), max), coef), 4);
+
+			__m128i result = _mm_or_si128(alpha, _mm_or_si128(_mm_slli_epi32(r, 24 - bits), _mm_or_si128(_mm_slli_epi32(g, 16 - bits), _mm_slli_epi32(b, 8 - bits))));
+			_mm_storeu_si128((__m128i*)(dest + x), result);
+		}
+
+		brightness_down_scalar<bits>(dest + x, src + x, evy, length - x);
+	}
+
+	/****** Alpha blending - AVX2 ******/
+	SFX_TARGET("avx2") void alpha_blend_avx2(u32* dest, const u32* src_1, const u32* src_2, u8 eva, u8 evb, u32 length)
+	{
+		const __m256i mask = _mm256_set1_epi32(0x1F);
+		const __m256i alpha = _mm256_set1_epi32(0xFF000000);
+		const __m256i coef_a = _mm256_set1_epi32(eva);
+		const __m256i coef_b = _mm256_set1_epi32(evb);
+
+		u32 x = 0;
+
+		for(; (x + 8) <= length; x += 8)
+		{
+			__m256i c1 = _mm256_loadu_si256((const __m256i*)(src_1 + x));
+			__m256i c2 = _mm256_loadu_si256((const __m256i*)(src_2 + x));
+
+			__m256i r = _mm256_add_epi32(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(c1, 19), mask), coef_a), _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(c2, 19), mask), coef_b));
+			__m256i g = _mm256_add_epi32(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(c1, 11), mask), coef_a), _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(c2, 11), mask), coef_b));
+			__m256i b = _mm256_add_epi32(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(c1, 3), mask), coef_a), _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(c2, 3), mask), coef_b));
+
+			r = _mm256_min_epi32(_mm256_srli_epi32(r, 4), mask);
+			g = _mm256_min_epi32(_mm256_srli_epi32(g, 4), mask);
+			b = _mm256_min_epi32(_mm256_srli_epi32(b, 4), mask);
+
+			__m256i result = _mm256_or_si256(alpha, _mm256_or_si256(_mm256_slli_epi32(r, 19), _mm256_or_si256(_mm256_slli_epi32(g, 11), _mm256_slli_epi32(b, 3))));
+			_mm256_storeu_si256((__m256i*)(dest + x), result);
+		}
+
+		alpha_blend_scalar(dest + x, src_1 + x, src_2 + x, eva, evb, length - x);
+	}
+
+	/****** Brightness increase - AVX2 ******/
+	template <u32 bits>
+	SFX_TARGET("avx2") void brightness_up_avx2(u32* dest, const u32* src, u8 evy, u32 length)
+	{
+		const __m256i max = _mm256_set1_epi32((1 << bits) - 1);
+		const __m256i alpha = _mm256_set1_epi32(0xFF000000);
+		const __m256i coef = _mm256_set1_epi32(evy);
+
+		u32 x = 0;
+
+		for(; (x + 8) <= length; x += 8)
+		{
+			__m256i color = _mm256_loadu_si256((const __m256i*)(src + x));
+
+			__m256i r = _mm256_and_si256(_mm256_srli_epi32(color, 24 - bits), max);
+			__m256i g = _mm256_and_si256(_mm256_srli_epi32(color, 16 - bits), max);
+			__m256i b = _mm256_and_si256(_mm256_srli_epi32(color, 8 - bits), max);
+
+			r = _mm256_min_epi32(_mm256_add_epi32(r, _mm256_srli_epi32(_mm256_mullo_epi16(_mm256_sub_epi32(max, r), coef), 4)), max);
+			g = _mm256_min_epi32(_mm256_add_epi32(g, _mm256_srli_epi32(_mm256_mullo_epi16(_mm256_sub_epi32(max, g), coef), 4)), max);
+			b = _mm256_min_epi32(_mm256_add_epi32(b, _mm256_srli_epi32(_mm256_mullo_epi16(_mm256_sub_epi32(max, b), coef), 4)), max);
+
+			__m256i result = _mm256_or_si256(alpha, _mm256_or_si256(_mm256_slli_epi32(r, 24 - bits), _mm256_or_si256(_mm256_slli_epi32(g, 16 - bits), _mm256_slli_epi32(b, 8 - bits))));
+			_mm256_storeu_si256((__m256i*)(dest + x), result);
+		}
+
+		brightness_up_scalar<bits>(dest + x, src + x, evy, length - x);
+	}
+
+	/****** Brightness decrease - AVX2 ******/
+	template <u32 bits>
+	SFX_TARGET("avx2") void brightness_down_avx2(u32* dest, const u32* src, u8 evy, u32 length)
+	{
+		const __m256i max = _mm256_set1_epi32((1 << bits) - 1);
+		const __m256i alpha = _mm256_set1_epi32(0xFF000000);
+		const __m256i coef = _mm256_set1_epi32(16 - ((evy > 16) ? 16 : evy));
+
+		u32 x = 0;
+
+		for(; (x + 8) <= length; x += 8)
+		{
+			__m256i color = _mm256_loadu_si256((const __m256i*)(src + x));
+
+			__m256i r = _mm256_srli_epi32(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(color, 24 - bits), max), coef), 4);
+			__m256i g = _mm256_srli_epi32(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(color, 16 - bits), max), coef), 4);
+			__m256i b = _mm256_srli_epi32(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(color, 8 - bits), max), coef), 4);
+
+			__m256i result = _mm256_or_si256(alpha, _mm256_or_si256(_mm256_slli_epi32(r, 24 - bits), _mm256_or_si256(_mm256_slli_epi32(g, 16 - bits), _mm256_slli_epi32(b, 8 - bits))));
+			_mm256_storeu_si256((__m256i*)(dest + x), result);
+		}
+
+		brightness_down_scalar<bits>(dest + x, src + x, evy, length - x);
+	}
+
+	/****** Checks which SIMD instruction sets the host CPU and OS support ******/
+	bool cpu_has_avx2()
+	{
+		#if defined(__GNUC__) || defined(__clang__)
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+
+		#else
+		int info[4];
+		__cpuid(info, 0);
+		if(info[0] < 7) { return false; }
+
+		//AVX needs OSXSAVE, plus the OS saving XMM and YMM state
+		__cpuid(info, 1);
+		if(((info[2] & 0x18000000) != 0x18000000) || ((_xgetbv(0) & 0x6) != 0x6)) { return false; }
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & 0x20) ? true : false;
+
+		#endif
+	}
+
+	bool cpu_has_sse2()
+	{
+		#if defined(__x86_64__) || defined(_M_X64)
+		return true;
+
+		#elif defined(__GNUC__) || defined(__clang__)
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("sse2");
+
+		#else
+		int info[4];
+		__cpuid(info, 1);
+		return (info[3] & 0x4000000) ? true : false;
+
+		#endif
+	}
+
+#endif
+
+	/****** Picks the fastest kernels for this CPU ******/
+	sfx_kernel_table select_kernels()
+	{
+		sfx_kernel_table table;
+
+		#ifdef GBE_SFX_X86
+		if(cpu_has_avx2())
+		{
+			table.name = "AVX2";
+			table.alpha_blend = alpha_blend_avx2;
+			table.brightness_up[SFX_RGB15] = brightness_up_avx2<5>;
+			table.brightness_up[SFX_RGB18] = brightness_up_avx2<6>;
+			table.brightness_down[SFX_RGB15] = brightness_down_avx2<5>;
+			table.brightness_down[SFX_RGB18] = brightness_down_avx2<6>;
+			return table;
+		}
+
+		if(cpu_has_sse2())
+		{
+			table.name = "SSE2";
+			table.alpha_blend = alpha_blend_sse2;
+			table.brightness_up[SFX_RGB15] = brightness_up_sse2<5>;
+			table.brightness_up[SFX_RGB18] = brightness_up_sse2<6>;
+			table.brightness_down[SFX_RGB15] = brightness_down_sse2<5>;
+			table.brightness_down[SFX_RGB18] = brightness_down_sse2<6>;
+			return table;
+		}
+		#endif
+
+		table.name = "Scalar";
+		table.alpha_blend = alpha_blend_scalar;
+		table.brightness_up[SFX_RGB15] = brightness_up_scalar<5>;
+		table.brightness_up[SFX_RGB18] = brightness_up_scalar<6>;
+		table.brightness_down[SFX_RGB15] = brightness_down_scalar<5>;
+		table.brightness_down[SFX_RGB18] = brightness_down_scalar<6>;
+		return table;
+	}
+
+	const sfx_kernel_table& kernels()
+	{
+		static const sfx_kernel_table table = select_kernels();
+		return table;
+	}
+}
+
+/****** Blends 2 lines of RGB15 pixels ******/
+void sfx_alpha_blend(u32* dest, const u32* src_1, const u32* src_2, u8 eva, u8 evb, u32 length)
+{
+	kernels().alpha_blend(dest, src_1, src_2, eva, evb, length);
+}
+
+/****** Brightens a line of pixels ******/
+void sfx_brightness_up(u32* dest, const u32* src, u8 evy, u32 length, sfx_color_depth depth)
+{
+	kernels().brightness_up[depth](dest, src, evy, length);
+}
+
+/****** Darkens a line of pixels ******/
+void sfx_brightness_down(u32* dest, const u32* src, u8 evy, u32 length, sfx_color_depth depth)
+{
+	kernels().brightness_down[depth](dest, src, evy, length);
+}
+
+/****** Returns the name of the instruction set used by the kernels ******/
+std::string sfx_kernel_name()
+{
+	return kernels().name;
+}
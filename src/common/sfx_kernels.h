@@ -0,0 +1,44 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : sfx_kernels.h
+// Date : October 17, 2026
+// Description : Colour special effect kernels
+//
+// Alpha blending and brightness adjustments applied to whole lines of ARGB pixels
+// Uses AVX2 or SSE2 when the host CPU supports them, plain C++ otherwise
+
+#ifndef GBE_SFX_KERNELS
+#define GBE_SFX_KERNELS
+
+#include <string>
+
+#include "common.h"
+
+//Channel depths - RGB15 keeps 5 bits per channel at Bits 19, 11, 3, RGB18 keeps 6 bits at Bits 18, 10, 2
+enum sfx_color_depth
+{
+	SFX_RGB15,
+	SFX_RGB18,
+};
+
+//Blends 2 lines of RGB15 pixels - ((1st * EVA) + (2nd * EVB)) / 16
+void sfx_alpha_blend(u32* dest, const u32* src_1, const u32* src_2, u8 eva, u8 evb, u32 length);
+
+//Brightens a line of pixels - I + ((Max - I) * EVY) / 16
+void sfx_brightness_up(u32* dest, const u32* src, u8 evy, u32 length, sfx_color_depth depth);
+
+//Darkens a line of pixels - I - (I * EVY) / 16, EVY is capped at 16
+void sfx_brightness_down(u32* dest, const u32* src, u8 evy, u32 length, sfx_color_depth depth);
+
+//Name of the instruction set picked for the kernels
+std::string sfx_kernel_name();
+
+/****** Converts a 15-bit BGR color to an RGB15 kernel pixel ******/
+inline u32 sfx_bgr15_to_argb(u16 color)
+{
+	return 0xFF000000 | ((color & 0x1F) << 19) | (((color >> 5) & 0x1F) << 11) | (((color >> 10) & 0x1F) << 3);
+}
+
+#endif // GBE_SFX_KERNELS
@@ -101,6 +101,13 @@ bool DMG_APU::init()
 		return false;
 	}
 
+	//In a local link session, only the first player owns the audio device, everyone else runs silently
+	if((config::netplay_local) && (SDL_GetAudioStatus() != SDL_AUDIO_STOPPED))
+	{
+		std::cout<<"APU::Initialized - Silent\n";
+		return true;
+	}
+
 	//Setup the desired audio specifications
     	desired_spec.freq = apu_stat.sample_rate;
 	desired_spec.format = AUDIO_S16SYS;
@@ -128,19 +135,10 @@ bool DMG_APU::init()
 }
 
 /****** Read APU data from save state ******/
-bool DMG_APU::apu_read(u32 offset, std::string filename)
+void DMG_APU::apu_read(state_reader& state)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
-
-	//Serialize APU data from file stream
-	file.read((char*)&apu_stat, sizeof(apu_stat));
-
-	file.close();
+	//Serialize APU data from save state
+	state.read(&apu_stat, sizeof(apu_stat));
 
 	//Sanitize APU data
 	if(apu_stat.noise_prescalar == 0) { apu_stat.noise_prescalar = 1; }
@@ -160,27 +158,15 @@ bool DMG_APU::apu_read(u32 offset, std::string filename)
 	apu_stat.channel[1].raw_frequency &= 0x7FF;
 	apu_stat.channel[2].raw_frequency &= 0x7FF;
 	apu_stat.channel[3].raw_frequency &= 0x7FF;
-
-	return true;
 }
 
 /****** Write APU data to save state ******/
-bool DMG_APU::apu_write(std::string filename)
+void DMG_APU::apu_write(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
-
-	//Serialize APU data to file stream
-	file.write((char*)&apu_stat, sizeof(apu_stat));
-
-	file.close();
-	return true;
+	//Serialize APU data to save state
+	state.write(&apu_stat, sizeof(apu_stat));
 }
 
-/****** Gets the size of APU data for serialization ******/
-u32 DMG_APU::size() { return sizeof(apu_stat); }
-
 /******* Generate samples for GB sound channel 1 ******/
 void DMG_APU::generate_channel_1_samples(s16* stream, int length)
 {
@@ -34,9 +34,8 @@ class DMG_APU
 	void reset();
 
 	//Serialize data for save state loading/saving
-	bool apu_read(u32 offset, std::string filename);
-	bool apu_write(std::string filename);
-	u32 size();
+	void apu_read(state_reader& state);
+	void apu_write(state_writer& state);
 
 	void generate_channel_1_samples(s16* stream, int length);
 	void generate_channel_2_samples(s16* stream, int length);
@@ -15,6 +15,7 @@
 #include <sstream>
 
 #include "common/util.h"
+#include "common/link_hub.h"
 
 #include "core.h"
 
@@ -39,6 +40,10 @@ DMG_core::DMG_core()
 	//Link MMU and GamePad
 	core_cpu.mem->g_pad = &core_pad;
 
+	rewind_frame = 0;
+	rewind_counter = 0;
+	rewinding = false;
+
 	db_unit.debug_mode = false;
 	db_unit.display_cycles = false;
 	db_unit.print_all = false;
@@ -84,6 +89,12 @@ void DMG_core::start()
 
 	//Initialize the GamePad
 	core_pad.init();
+
+	//Start rewind history over
+	rewind.reset((config::rewind_interval) ? (config::rewind_buffer_size << 20) : 0);
+	rewind_frame = core_cpu.controllers.video.frame_count;
+	rewind_counter = 0;
+	rewinding = false;
 }
 
 /****** Stop the core ******/
@@ -157,33 +168,21 @@ void DMG_core::load_state(u8 slot)
 		state_file = config::rom_file + ".ss" + id;
 	}
 
-	u32 offset = 0;
+	std::vector<u8> state_data;
 
 	//Check if save state is accessible
-	std::ifstream test(state_file.c_str());
-	
-	if(!test.good())
+	if(!read_state_file(state_file, state_data))
 	{
 		config::osd_message = "INVALID SAVE STATE " + util::to_str(slot);
 		config::osd_count = 180;
 		return;
 	}
 
-	if(!get_save_state_info(offset, state_file)) { return; }
-	offset += sizeof(DMG_SAVE_STATE_VERSION);
-	offset += sizeof(config::gb_type);
-	offset += 32;
-
-	if(!core_cpu.cpu_read(offset, state_file)) { return; }
-	offset += core_cpu.size();	
-
-	if(!core_mmu.mmu_read(offset, state_file)) { return; }
-	offset += core_mmu.size();
-
-	if(!core_cpu.controllers.audio.apu_read(offset, state_file)) { return; }
-	offset += core_cpu.controllers.audio.size();
-
-	if(!core_cpu.controllers.video.lcd_read(offset, state_file)) { return; }
+	if(!deserialize_state(&state_data[0], state_data.size()))
+	{
+		std::cout<<"GBE::Error - Could not load save state " << state_file << "\n";
+		return;
+	}
 
 	std::cout<<"GBE::Loaded state " << state_file << "\n";
 
@@ -210,11 +209,11 @@ void DMG_core::save_state(u8 slot)
 		state_file = config::rom_file + ".ss" + id;
 	}
 
-	if(!set_save_state_info(state_file)) { return; }
-	if(!core_cpu.cpu_write(state_file)) { return; }
-	if(!core_mmu.mmu_write(state_file)) { return; }
-	if(!core_cpu.controllers.audio.apu_write(state_file)) { return; }
-	if(!core_cpu.controllers.video.lcd_write(state_file)) { return; }
+	//Serialize the whole state in memory, then write it out at once
+	std::vector<u8> state_data(get_state_size());
+
+	if(!serialize_state(&state_data[0], state_data.size())) { return; }
+	if(!write_state_file(state_file, state_data)) { return; }
 
 	std::cout<<"GBE::Saved state " << state_file << "\n";
 
@@ -223,31 +222,103 @@ void DMG_core::save_state(u8 slot)
 	config::osd_count = 180;
 }
 
+/****** Gets the number of bytes needed to serialize the core ******/
+u32 DMG_core::get_state_size() { return serialize_state(NULL, 0); }
+
+/****** Serializes the core into a buffer - Returns the bytes written, or 0 if the buffer is too small ******/
+u32 DMG_core::serialize_state(u8* buffer, u32 length)
+{
+	state_writer state(buffer, length);
+
+	set_save_state_info(state);
+
+	state.begin_chunk(STATE_CHUNK_CPU, DMG_SAVE_STATE_VERSION);
+	core_cpu.cpu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_MMU, DMG_SAVE_STATE_VERSION);
+	core_mmu.mmu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_APU, DMG_SAVE_STATE_VERSION);
+	core_cpu.controllers.audio.apu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_LCD, DMG_SAVE_STATE_VERSION);
+	core_cpu.controllers.video.lcd_write(state);
+	state.end_chunk();
+
+	return (state.good()) ? state.size() : 0;
+}
+
+/****** Restores the core from a buffer filled by serialize_state() - The core is left untouched if the buffer is rejected ******/
+bool DMG_core::deserialize_state(const u8* buffer, u32 length)
+{
+	state_reader state(buffer, length);
+
+	if(!get_save_state_info(state)) { return false; }
+
+	//Make sure every chunk is present before changing anything
+	if(!state.has_chunk(STATE_CHUNK_CPU, DMG_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_MMU, DMG_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_APU, DMG_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_LCD, DMG_SAVE_STATE_VERSION)) { return false; }
+
+	return restore_state(buffer, length, [this](u8* data, u32 size) { return serialize_state(data, size); }, [this](const u8* data, u32 size) { return read_state_chunks(data, size); });
+}
+
+/****** Reads every chunk of a state into the core - Only use directly on buffers this core serialized itself ******/
+bool DMG_core::read_state_chunks(const u8* buffer, u32 length)
+{
+	state_reader state(buffer, length);
+
+	if(!get_save_state_info(state)) { return false; }
+
+	state.open_chunk(STATE_CHUNK_CPU, DMG_SAVE_STATE_VERSION);
+	core_cpu.cpu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_MMU, DMG_SAVE_STATE_VERSION);
+	core_mmu.mmu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_APU, DMG_SAVE_STATE_VERSION);
+	core_cpu.controllers.audio.apu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_LCD, DMG_SAVE_STATE_VERSION);
+	core_cpu.controllers.video.lcd_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	return true;
+}
+
 /****** Gets the save state info (Version + System Type) ******/
-bool DMG_core::get_save_state_info(u32 offset, std::string filename)
+bool DMG_core::get_save_state_info(state_reader& state)
 {
 	u32 version = 0;
 	u8 system_type = 0;
 	u8 state_date[32];
 
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	if(!file.is_open()) { return false; }
+	state.read(&version, sizeof(version));
+	state.read(&system_type, sizeof(system_type));
+	state.read(&state_date[0], 32);
 
-	file.seekg(offset);
-	file.read((char*)&version, sizeof(version));
-	file.read((char*)&system_type, sizeof(system_type));
-	file.read((char*)&state_date[0], 32);
-	file.close();
+	if(!state.good())
+	{
+		std::cout<<"GBE::Error - Save State is too small. Cannot load save.\n";
+		return false;
+	}
 
 	if(system_type != config::gb_type)
 	{
-		std::cout<<"GBE::Error - Save State " <<  filename << " has incorrect system type. Cannot load save.\n";
+		std::cout<<"GBE::Error - Save State has incorrect system type. Cannot load save.\n";
 		return false;
 	}
 
 	if(version != DMG_SAVE_STATE_VERSION)
 	{
-		std::cout<<"GBE::Error - Save State " <<  filename << " has outdated version number. Cannot load save.\n";
+		std::cout<<"GBE::Error - Save State has outdated version number. Cannot load save.\n";
 		return false;
 	}
 
@@ -255,11 +326,8 @@ bool DMG_core::get_save_state_info(u32 offset, std::string filename)
 }
 
 /****** Sets the save state info (Version + System Type) ******/
-bool DMG_core::set_save_state_info(std::string filename)
+void DMG_core::set_save_state_info(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
-	if(!file.is_open()) { return false; }
-
 	//Add current date metadata - Fixed size of 32 bytes
 	u8 state_date[32];
 	std::string date = util::get_long_date(true);
@@ -274,12 +342,135 @@ bool DMG_core::set_save_state_info(std::string filename)
 		}
 	}
 
-	file.write((char*)&DMG_SAVE_STATE_VERSION, sizeof(DMG_SAVE_STATE_VERSION));
-	file.write((char*)&config::gb_type, sizeof(config::gb_type));
-	file.write((char*)&state_date[0], 32);
-	file.close();
+	state.write(&DMG_SAVE_STATE_VERSION, sizeof(DMG_SAVE_STATE_VERSION));
+	state.write(&config::gb_type, sizeof(config::gb_type));
+	state.write(&state_date[0], 32);
+}
 
-	return true;
+/****** Takes rewind snapshots, or steps back through them while rewinding - Called once per frame ******/
+void DMG_core::update_rewind()
+{
+	rewind_frame = core_cpu.controllers.video.frame_count;
+
+	if(!config::rewind_interval) { return; }
+
+	//Rewinding a linked core would desync it from the other side, so no history is kept while connected
+	if(core_cpu.controllers.serial_io.sio_stat.connected)
+	{
+		if(rewind.count()) { rewind.reset(config::rewind_buffer_size << 20); }
+		rewind_counter = 0;
+		return;
+	}
+
+	//Load the newest snapshot each frame, history steps back by one every time
+	if(rewinding)
+	{
+		if(rewind.pop(rewind_state)) { read_state_chunks(&rewind_state[0], rewind_state.size()); }
+		rewind_counter = 0;
+	}
+
+	else if(++rewind_counter >= config::rewind_interval)
+	{
+		rewind_counter = 0;
+		rewind_state.resize(get_state_size());
+
+		if(serialize_state(&rewind_state[0], rewind_state.size())) { rewind.push(rewind_state); }
+	}
+}
+
+/****** Shows a frame from the future, then rolls back to the committed one - Called once per frame ******/
+void DMG_core::update_run_ahead()
+{
+	DMG_LCD& video = core_cpu.controllers.video;
+
+	//Frames from netplay cannot be rolled back, rewinding shows each snapshot as is
+	if((!config::run_ahead) || (rewinding) || (db_unit.debug_mode) || (core_cpu.controllers.serial_io.sio_stat.connected))
+	{
+		video.frame_skip.set_hidden(false);
+		return;
+	}
+
+	run_ahead_state.resize(get_state_size());
+
+	if(!serialize_state(&run_ahead_state[0], run_ahead_state.size()))
+	{
+		video.frame_skip.set_hidden(false);
+		return;
+	}
+
+	//Future frames must never be heard, so keep the audio callback out until they are rolled back
+	SDL_LockAudio();
+
+	for(u32 x = 1; x <= config::run_ahead; x++)
+	{
+		video.frame_skip.set_hidden(x != config::run_ahead);
+		video.frame_skip.set_paced(false);
+		u32 frame = video.frame_count;
+
+		//Give up on frames the LCD never finishes (e.g. turned off)
+		for(u32 y = 0; (core_cpu.running) && (video.frame_count == frame) && (y < 0x100000); y++) { step(); }
+	}
+
+	read_state_chunks(&run_ahead_state[0], run_ahead_state.size());
+	SDL_UnlockAudio();
+
+	//The committed frame is emulated next, but never shown - It waits on the frame limiter instead, outside of any audio lock
+	video.frame_skip.set_hidden(true);
+	video.frame_skip.set_paced(true);
+}
+
+/****** Keeps link cable netplay in step with rollback - Called once per frame ******/
+void DMG_core::update_link_rollback()
+{
+	DMG_SIO& sio = core_cpu.controllers.serial_io;
+
+	if((!config::netplay_rollback) || (!sio.sio_stat.connected) || (sio.sio_stat.sio_type != GB_LINK)) { return; }
+
+	sio.rollback.update(*this, 0x100000);
+}
+
+/****** Rollback hooks - The live frame keeps the buttons held now, but the game's column select comes from the new timeline ******/
+void DMG_core::restore_link_input(u32 live_input) { set_link_input((live_input & 0xFFFF) | (get_link_input() & 0xFF0000)); }
+
+/****** Rollback hooks - Runs one instruction while resimulating ******/
+void DMG_core::step_link() { step(); }
+
+/****** Rollback hooks - Past frames must never be heard again, so keep the audio callback out until the live frame is reached ******/
+void DMG_core::mute_link_audio(bool mute)
+{
+	if(mute) { SDL_LockAudio(); }
+	else { SDL_UnlockAudio(); }
+}
+
+/****** Rollback hooks - Cycles carried over between frames ******/
+u32& DMG_core::link_cycles() { return core_cpu.cycles; }
+
+/****** Rollback hooks - Applies recorded input and transfers during a resimulation ******/
+void DMG_core::apply_link_event(u8 type, u32 data)
+{
+	switch(type)
+	{
+		case LINK_EVENT_INPUT:
+			core_pad.p14 = (data >> 8) & 0xFF;
+			core_pad.p15 = (data & 0xFF);
+			if(data & 0x10000) { core_mmu.memory_map[IF_FLAG] |= 0x10; }
+			break;
+
+		case LINK_EVENT_TRANSFER:
+			core_cpu.controllers.serial_io.link_cable_exchange(data & 0xFF);
+			break;
+	}
+}
+
+/****** Packs the joypad state the MMU reads from - Bits 0-15 are P14 and P15, Bits 16-23 are the selected column ******/
+u32 DMG_core::get_link_input() { return (core_pad.column_id << 16) | (core_pad.p14 << 8) | core_pad.p15; }
+
+/****** Unpacks joypad state saved for rollback ******/
+void DMG_core::set_link_input(u32 input)
+{
+	core_pad.column_id = (input >> 16) & 0xFF;
+	core_pad.p14 = (input >> 8) & 0xFF;
+	core_pad.p15 = (input & 0xFF);
 }
 
 /****** Run the core in a loop until exit ******/
@@ -290,10 +481,10 @@ void DMG_core::run_core()
 	//Begin running the core
 	while(running)
 	{
-		//Handle SDL Events
+		//Handle SDL Events - Local link sessions handle them on the main thread instead
 		if(core_cpu.controllers.video.lcd_stat.current_scanline == 144)
 		{
-			if(SDL_PollEvent(&event))
+			if((!config::netplay_local) && SDL_PollEvent(&event))
 			{
 				//X out of a window
 				if(event.type == SDL_QUIT) { stop(); SDL_Quit(); }
@@ -309,6 +500,10 @@ void DMG_core::run_core()
 
 					//Trigger Joypad Interrupt if necessary
 					if(core_pad.joypad_irq) { core_mmu.memory_map[IF_FLAG] |= 0x10; }
+
+					//Keep a record so rollback can apply this input again while resimulating
+					u32 input = (core_pad.p14 << 8) | core_pad.p15;
+					core_cpu.controllers.serial_io.rollback.log_event(LINK_EVENT_INPUT, (core_pad.joypad_irq) ? (input | 0x10000) : input);
 				}
 
 				//Hotplug joypad
@@ -329,6 +524,15 @@ void DMG_core::run_core()
 			if(core_mmu.ir_stat.try_connection) { core_cpu.controllers.serial_io.process_network_communication(); }
 		}
 
+		//Once per frame, take rewind snapshots or step backwards, then run ahead
+		if(core_cpu.controllers.video.frame_count != rewind_frame)
+		{
+			update_rewind();
+			update_run_ahead();
+			update_link_rollback();
+			rewind_frame = core_cpu.controllers.video.frame_count;
+		}
+
 		//Run the CPU
 		if(core_cpu.running)
 		{
@@ -349,6 +553,13 @@ void DMG_core::run_core()
 
 						while(core_cpu.controllers.serial_io.sio_stat.sync)
 						{
+							//Stop waiting at once if this core is stopping or the other side hung up
+							if((!running) || (core_cpu.controllers.serial_io.link_lost()))
+							{
+								core_cpu.controllers.serial_io.reset();
+								break;
+							}
+
 							core_cpu.controllers.serial_io.receive_byte();
 							if(core_cpu.controllers.serial_io.is_master) { core_cpu.controllers.serial_io.four_player_request_sync(); }
 
@@ -394,6 +605,11 @@ void DMG_core::run_core()
 				}
 			}
 
+			//Local link sessions run every core in fixed cycle quanta
+			#ifdef GBE_NETPLAY
+			if(config::netplay_local) { link_hub::step_lockstep((core_cpu.double_speed) ? (core_cpu.cycles >> 1) : core_cpu.cycles); }
+			#endif
+
 			core_cpu.debug_cycles += core_cpu.cycles;
 			core_cpu.cycles = 0;
 
@@ -401,6 +617,9 @@ void DMG_core::run_core()
 			core_cpu.handle_interrupts();
 
 			if(db_unit.debug_mode) { debug_step(); }
+
+			//Netplay syncs on exact cycle counts, so never skip idle loops there
+			core_cpu.idle_loop.enable = (config::skip_idle_loops && !db_unit.debug_mode && !core_cpu.controllers.serial_io.sio_stat.connected);
 	
 			//Halt CPU if necessary
 			if(core_cpu.halt == true)
@@ -424,8 +643,13 @@ void DMG_core::run_core()
 			//Process Opcodes
 			else 
 			{
+				u16 opcode_addr = core_cpu.reg.pc;
+
 				core_cpu.opcode = core_mmu.read_u8(core_cpu.reg.pc++);
 				core_cpu.exec_op(core_cpu.opcode);
+
+				//Backwards jumps may land in an idle loop
+				if((core_cpu.reg.pc < opcode_addr) && (core_cpu.idle_loop.enable)) { core_cpu.check_idle_loop(); }
 			}
 
 			//Update LCD
@@ -627,6 +851,8 @@ void DMG_core::run_core()
 					core_cpu.controllers.serial_io.singer_izek_data_process();
 				}
 			}
+
+			core_cpu.controllers.serial_io.rollback.frame_step++;
 		}
 
 		//Stop emulation
@@ -646,8 +872,8 @@ void DMG_core::step()
 		//Receive byte from another instance of GBE+ via netplay
 		if(core_cpu.controllers.serial_io.sio_stat.connected)
 		{
-			//Perform syncing operations when hard sync is enabled
-			if(core_cpu.controllers.serial_io.sio_stat.use_hard_sync)
+			//Perform syncing operations when hard sync is enabled - Resimulated frames were already synced when they first ran
+			if((core_cpu.controllers.serial_io.sio_stat.use_hard_sync) && (!core_cpu.controllers.serial_io.rollback.replaying()))
 			{
 				core_cpu.controllers.serial_io.sio_stat.sync_counter += (core_cpu.double_speed) ? (core_cpu.cycles >> 1) : core_cpu.cycles;
 
@@ -660,6 +886,13 @@ void DMG_core::step()
 
 					while(core_cpu.controllers.serial_io.sio_stat.sync)
 					{
+						//Stop waiting at once if this core is stopping or the other side hung up
+						if((!running) || (core_cpu.controllers.serial_io.link_lost()))
+						{
+							core_cpu.controllers.serial_io.reset();
+							break;
+						}
+
 						core_cpu.controllers.serial_io.receive_byte();
 						if(core_cpu.controllers.serial_io.is_master) { core_cpu.controllers.serial_io.four_player_request_sync(); }
 
@@ -1071,7 +1304,8 @@ void DMG_core::handle_hotkey(SDL_Event& event)
 	}
 
 	//Pause emulation
-	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_PAUSE))
+	//Local link sessions never pause a single core, that would poll SDL off the main thread
+	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_PAUSE) && (!config::netplay_local))
 	{
 		config::pause_emu = true;
 		SDL_PauseAudio(1);
@@ -1109,6 +1343,10 @@ void DMG_core::handle_hotkey(SDL_Event& event)
 		config::turbo = false;
 		if((config::sdl_render) && (config::use_opengl)) { SDL_GL_SetSwapInterval(1); }
 	}
+
+	//Step backwards while the rewind hotkey is held
+	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == config::hotkey_rewind)) { rewinding = true; }
+	else if((event.type == SDL_KEYUP) && (event.key.keysym.sym == config::hotkey_rewind)) { rewinding = false; }
 		
 	//Reset emulation on F8
 	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_F8))
@@ -1287,6 +1525,9 @@ void DMG_core::handle_hotkey(int input, bool pressed)
 	//Toggle turbo off
 	else if((input == config::hotkey_turbo) && (!pressed)) { config::turbo = false; }
 
+	//Step backwards while the rewind hotkey is held
+	else if(input == config::hotkey_rewind) { rewinding = pressed; }
+
 	//GB Camera load/unload external picture into VRAM
 	else if((input == config::hotkey_camera) && (pressed))
 	{
@@ -1423,8 +1664,8 @@ void DMG_core::handle_hotkey(int input, bool pressed)
 	}
 				
 	//Reset emulation on F8
-	//Only done when using GB Memory Cartridge via GUI
-	else if((input == SDLK_F8) && (pressed) && (config::cart_type == DMG_GBMEM) && (config::use_external_interfaces))
+	//Only done when using GB Memory Cartridge via GUI, never in local link sessions since the system type is shared
+	else if((input == SDLK_F8) && (pressed) && (config::cart_type == DMG_GBMEM) && (config::use_external_interfaces) && (!config::netplay_local))
 	{
 		//If running GB Memory Cartridge, make sure this is a true reset, i.e. boot to the menu program
 		if(core_mmu.cart.flash_stat == 0x40)
@@ -16,6 +16,7 @@
 #define GB_CORE
 
 #include "common/core_emu.h"
+#include "common/rewind.h"
 #include "mmu.h"
 #include "sm83.h"
 
@@ -37,9 +38,25 @@ class DMG_core : virtual public core_emu
 		void feed_key_input(int sdl_key, bool pressed);
 		void save_state(u8 slot);
 		void load_state(u8 slot);
-		bool get_save_state_info(u32 offset, std::string filename);
-		bool set_save_state_info(std::string filename);
+		bool get_save_state_info(state_reader& state);
+		void set_save_state_info(state_writer& state);
+		u32 get_state_size();
+		u32 serialize_state(u8* buffer, u32 length);
+		bool deserialize_state(const u8* buffer, u32 length);
+		bool read_state_chunks(const u8* buffer, u32 length);
 		void run_core();
+		void update_rewind();
+		void update_run_ahead();
+		void update_link_rollback();
+
+		//Hooks for link_rollback
+		u32 get_link_input();
+		void set_link_input(u32 input);
+		void restore_link_input(u32 live_input);
+		void apply_link_event(u8 type, u32 data);
+		void step_link();
+		void mute_link_audio(bool mute);
+		u32& link_cycles();
 
 		//Core debugging
 		void debug_step();
@@ -67,6 +84,16 @@ class DMG_core : virtual public core_emu
 		DMG_MMU core_mmu;
 		SM83 core_cpu;
 		DMG_GamePad core_pad;
+
+		//Rewind history
+		rewind_buffer rewind;
+		std::vector<u8> rewind_state;
+		u32 rewind_frame;
+		u32 rewind_counter;
+		bool rewinding;
+
+		//Snapshot of the committed frame while running ahead
+		std::vector<u8> run_ahead_state;
 };
 		
 #endif // GB_CORE
@@ -37,8 +37,8 @@ bool DMG_SIO::four_player_init()
 		u16 sender_port = config::netplay_client_port + (x * 2);
 
 		//Server and Client info
-		net_util::setup_comm(four_player_server[x], server_port, NET_COMM_SERVER);
-		net_util::setup_comm(four_player_sender[x], sender_port, NET_COMM_CLIENT);	
+		net_util::setup_comm(four_player_server[x], server_port, NET_COMM_SERVER, config::netplay_local);
+		net_util::setup_comm(four_player_sender[x], sender_port, NET_COMM_CLIENT, config::netplay_local);	
 
 		//Setup server, resolve the server with nullptr as the hostname, the server will now listen for connections
 		if(net_util::resolve_host(four_player_server[x], "") < 0)
@@ -92,7 +92,7 @@ void DMG_SIO::four_player_disconnect()
 	temp_buffer[0] = 0;
 	temp_buffer[1] = 0x80;
 
-	if((four_player_sender[master_id].host_socket != nullptr) && (!is_master))
+	if((four_player_sender[master_id].connected) && (!is_master))
 	{
 		net_util::send_data(four_player_sender[master_id], temp_buffer, 2);
 	}
@@ -111,6 +111,8 @@ void DMG_SIO::four_player_disconnect()
 	//Close any current connections
 	for(int x = 0; x < 3; x++)
 	{
+		four_player_receiver[x].stop();
+
 		net_util::close_comm(four_player_server[x]);
 		net_util::close_comm(four_player_sender[x]);
 	}
@@ -149,6 +151,9 @@ void DMG_SIO::four_player_process_network_communication()
 		{
 			sio_stat.connected = true;
 
+			//Start polling this server for transfers
+			four_player_receiver[x].start(&four_player_server[x], 2);
+
 			//For 4 Player adapter, set ID based on port number
 			four_player.id = (is_master) ? 1 : (x + 2);
 			four_player.status = four_player.id;
@@ -255,13 +260,11 @@ bool DMG_SIO::four_player_receive_byte()
 	//If this socket is active, receive the transfer
 	for(int x = 0; x < 3; x++)
 	{
-		if((four_player_server[x].tcp_sockets != nullptr) && (four_player_server[x].remote_socket != nullptr))
+		if(four_player_server[x].remote_init)
 		{
-			//Check the status of connection
+			//Take any transfer the receiving thread has waiting
 			//This is non-blocking
-			SDLNet_CheckSockets(four_player_server[x].tcp_sockets, 0);
-
-			if((SDLNet_SocketReady(four_player_server[x].remote_socket)) && (net_util::recv_data(four_player_server[x], temp_buffer, 2) > 0))
+			if(four_player_receiver[x].pop(temp_buffer))
 			{
 				//4-Player - Confirm SB write for Players 2, 3, and 4
 				if(temp_buffer[1] == 0xFE)
@@ -496,7 +499,7 @@ void DMG_SIO::four_player_broadcast(u8 data_one, u8 data_two)
 
 			//Wait for other instance of GBE+ to send an acknowledgement
 			//This is blocking, will effectively pause GBE+ until it gets something
-			net_util::recv_data(four_player_server[x], temp_buffer, 2, true);
+			four_player_receiver[x].wait(temp_buffer);
 
 			if(temp_buffer[1] == 0x80)
 			{
@@ -540,7 +543,7 @@ u8 DMG_SIO::four_player_request(u8 data_one, u8 data_two, u8 id)
 
 	//Wait for other instance of GBE+ to send an acknowledgement
 	//This is blocking, will effectively pause GBE+ until it gets something
-	net_util::recv_data(four_player_server[id], temp_buffer, 2, true);
+	four_player_receiver[id].wait(temp_buffer);
 
 	if(temp_buffer[1] == 0x80)
 	{
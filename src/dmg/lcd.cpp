@@ -57,7 +57,9 @@ void DMG_LCD::reset()
 	frame_start_time = 0;
 	frame_current_time = 0;
 	fps_count = 0;
+	frame_count = 0;
 	fps_time = 0;
+	frame_skip.reset();
 
 	for(u32 x = 0; x < 60; x++)
 	{
@@ -246,22 +248,15 @@ bool DMG_LCD::init()
 }
 
 /****** Read LCD data from save state ******/
-bool DMG_LCD::lcd_read(u32 offset, std::string filename)
+void DMG_LCD::lcd_read(state_reader& state)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
-
-	//Serialize LCD data from file stream
-	file.read((char*)&lcd_stat, sizeof(lcd_stat));
+	//Serialize LCD data from save state
+	state.read(&lcd_stat, sizeof(lcd_stat));
 
-	//Serialize OBJ data from file stream
+	//Serialize OBJ data from save state
 	for(int x = 0; x < 40; x++)
 	{
-		file.read((char*)&obj[x], sizeof(obj[x]));
+		state.read(&obj[x], sizeof(obj[x]));
 	}
 
 	//Sanitize LCD data
@@ -271,29 +266,19 @@ bool DMG_LCD::lcd_read(u32 offset, std::string filename)
 
 	lcd_stat.lcd_mode &= 0x3;
 	lcd_stat.hdma_type &= 0x1;
-	
-	file.close();
-	return true;
 }
 
 /****** Read LCD data from save state ******/
-bool DMG_LCD::lcd_write(std::string filename)
+void DMG_LCD::lcd_write(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
-
-	//Serialize LCD data to file stream
-	file.write((char*)&lcd_stat, sizeof(lcd_stat));
+	//Serialize LCD data to save state
+	state.write(&lcd_stat, sizeof(lcd_stat));
 
-	//Serialize OBJ data to file stream
+	//Serialize OBJ data to save state
 	for(int x = 0; x < 40; x++)
 	{
-		file.write((char*)&obj[x], sizeof(obj[x]));
+		state.write(&obj[x], sizeof(obj[x]));
 	}
-
-	file.close();
-	return true;
 }
 
 /****** Compares LY and LYC - Generates STAT interrupt ******/
@@ -1131,6 +1116,30 @@ void DMG_LCD::update_obj_colors()
 	lcd_stat.update_obj_colors = false;
 }
 
+/****** Returns the number of LCD cycles until the next mode or scanline change ******/
+u32 DMG_LCD::cycles_to_event()
+{
+	//LCD on/off switches are processed on the next step
+	if(lcd_stat.on_off) { return 1; }
+
+	//Nothing changes while the LCD is off, so just wait a scanline
+	if(!lcd_stat.lcd_enable) { return 456; }
+
+	//Modes 0, 2, and 3 - Outside of VBlank
+	if(lcd_stat.lcd_clock < 65664)
+	{
+		u32 line_clock = lcd_stat.lcd_clock % 456;
+
+		if(line_clock < 80) { return 80 - line_clock; }
+		else if(line_clock < 252) { return 252 - line_clock; }
+		else { return 456 - line_clock; }
+	}
+
+	//Mode 1 - VBlank, waiting for the next scanline
+	if(lcd_stat.lcd_mode != 1) { return 1; }
+	return (lcd_stat.vblank_clock < 456) ? (456 - lcd_stat.vblank_clock) : 1;
+}
+
 /****** Execute LCD operations ******/
 void DMG_LCD::step(int cpu_clock) 
 {
@@ -1228,7 +1237,7 @@ void DMG_LCD::step(int cpu_clock)
 					else { update_obj_render_list(); }
 					
 					//Render scanline when first entering Mode 0
-					if(!config::request_resize)
+					if((!config::request_resize) && (!frame_skip.skip_frame))
 					{
 						if(config::gb_type != SYS_GBC) { render_dmg_scanline(); }
 						else { render_gbc_scanline(); }
@@ -1336,8 +1345,8 @@ void DMG_LCD::step(int cpu_clock)
 				//Process sewing machines
 				if(mem->g_pad->con_flags & 0x800) { mem->g_pad->con_update = true; }
 
-				//Render final screen buffer
-				if(lcd_stat.lcd_enable)
+				//Render final screen buffer - Nothing is blitted for skipped frames
+				if((lcd_stat.lcd_enable) && (!frame_skip.skip_frame))
 				{
 					//Copy sub-screen to screen buffer
 					if(mem->sub_screen_buffer.size())
@@ -1447,8 +1456,11 @@ void DMG_LCD::step(int cpu_clock)
 					}
 				}
 
-				//Limit framerate
-				if(!config::turbo)
+				//Decide whether the next frame gets drawn
+				frame_skip.update(SDL_GetTicks(), frame_start_time, frame_delay[fps_count % 60]);
+
+				//Limit framerate - Unpaced frames (run-ahead, rollback) run as fast as possible
+				if((!config::turbo) && (frame_skip.paced))
 				{
 					frame_current_time = SDL_GetTicks();
 					int delay = frame_delay[fps_count % 60];
@@ -1457,7 +1469,8 @@ void DMG_LCD::step(int cpu_clock)
 				}
 
 				//Update FPS counter + title
-				fps_count++;
+				if(!frame_skip.hidden) { fps_count++; }
+				frame_count++;
 				if(((SDL_GetTicks() - fps_time) >= 1000) && (config::sdl_render)) 
 				{ 
 					fps_time = SDL_GetTicks();
@@ -1485,8 +1498,8 @@ void DMG_LCD::step(int cpu_clock)
 					else { mem->memory_map[REG_RP] |= 0x2; }
 				}
 
-				//Process Turbo Buttons
-				if(mem->g_pad->turbo_button_enabled) { mem->g_pad->process_turbo_buttons(); }
+				//Process Turbo Buttons - Once per shown frame
+				if((mem->g_pad->turbo_button_enabled) && (!frame_skip.hidden)) { mem->g_pad->process_turbo_buttons(); }
 
 				//Process Vaus input
 				if(config::sio_device == SIO_VAUS_CONTROLLER) { mem->g_pad->process_vaus(); }
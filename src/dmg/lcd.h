@@ -16,6 +16,7 @@
 #include "mmu.h"
 
 #include "common/gx_util.h"
+#include "common/frame_skip.h"
 
 class DMG_LCD
 {
@@ -29,6 +30,7 @@ class DMG_LCD
 	~DMG_LCD();
 
 	void step(int cpu_clock);
+	u32 cycles_to_event();
 	void reset();
 	bool init();
 	bool opengl_init();
@@ -37,8 +39,8 @@ class DMG_LCD
 	u32 get_scanline_pixel(u8 pixel);
 
 	//Serialize data for save state loading/saving
-	bool lcd_read(u32 offset, std::string filename);
-	bool lcd_write(std::string filename);
+	void lcd_read(state_reader& state);
+	void lcd_write(state_writer& state);
 
 	//Screen data
 	SDL_Window *window;
@@ -49,6 +51,12 @@ class DMG_LCD
 
 	int max_fullscreen_ratio;
 
+	//Frames completed since the last reset
+	u32 frame_count;
+
+	//Frame skipping, also hides frames while running ahead
+	frame_skipper frame_skip;
+
 	bool power_antenna_osd;
 
 	private:
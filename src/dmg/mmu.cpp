@@ -23,6 +23,7 @@ DMG_MMU::DMG_MMU()
 
 	//Grab the original system type, used for SGB save state info
 	original_sys_type = config::gb_type;
+	write_backup = ((!config::netplay_local) || (config::netplay_id == 0));
 
 	reset();
 }
@@ -36,7 +37,7 @@ DMG_MMU::~DMG_MMU()
 		for(u32 x = 0; x < cart.cam_buffer.size(); x++) { random_access_bank[0][0x100 + x] = 0x0; }
 	}
 
-	save_backup(config::save_file);
+	if(write_backup) { save_backup(config::save_file); }
 	memory_map.clear();
 	std::cout<<"MMU::Shutdown\n"; 
 }
@@ -152,6 +153,7 @@ void DMG_MMU::reset()
 	}
 
 	div_reset = false;
+	write_count = 0;
 
 	//Resize various banks
 	read_only_bank.resize(0x200);
@@ -189,51 +191,44 @@ void DMG_MMU::reset()
 }
 
 /****** Read MMU data from save state ******/
-bool DMG_MMU::mmu_read(u32 offset, std::string filename)
+void DMG_MMU::mmu_read(state_reader& state)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
-
 	//Serialize DMG/GBC RAM from save state
 	u8* ex_ram = &memory_map[0x8000];
-	file.read((char*)ex_ram, 0x8000);
+	state.read(ex_ram, 0x8000);
 
 	for(int x = 0; x < 0x2; x++)
 	{
 		ex_ram = &video_ram[x][0];
-		file.read((char*)ex_ram, 0x2000);
+		state.read(ex_ram, 0x2000);
 	}
 
 	for(int x = 0; x < 0x8; x++)
 	{
 		ex_ram = &working_ram_bank[x][0];
-		file.read((char*)ex_ram, 0x1000);
+		state.read(ex_ram, 0x1000);
 	}
 
 	for(int x = 0; x < 0x10; x++)
 	{
 		ex_ram = &random_access_bank[x][0];
-		file.read((char*)ex_ram, 0x2000);
+		state.read(ex_ram, 0x2000);
 	}
 
 	//Serialize misc MMU data from save state
-	file.read((char*)&rom_bank, sizeof(rom_bank));
-	file.read((char*)&ram_bank, sizeof(ram_bank));
-	file.read((char*)&wram_bank, sizeof(wram_bank));
-	file.read((char*)&vram_bank, sizeof(vram_bank));
-	file.read((char*)&bank_bits, sizeof(bank_bits));
-	file.read((char*)&bank_mode, sizeof(bank_mode));
-	file.read((char*)&ram_banking_enabled, sizeof(ram_banking_enabled));
-	file.read((char*)&in_bios, sizeof(in_bios));
-	file.read((char*)&bios_type, sizeof(bios_type));
-	file.read((char*)&bios_size, sizeof(bios_size));
-	file.read((char*)&cart, sizeof(cart));
-	file.read((char*)&previous_value, sizeof(previous_value));
-	file.read((char*)&original_sys_type, sizeof(original_sys_type));
+	state.read(&rom_bank, sizeof(rom_bank));
+	state.read(&ram_bank, sizeof(ram_bank));
+	state.read(&wram_bank, sizeof(wram_bank));
+	state.read(&vram_bank, sizeof(vram_bank));
+	state.read(&bank_bits, sizeof(bank_bits));
+	state.read(&bank_mode, sizeof(bank_mode));
+	state.read(&ram_banking_enabled, sizeof(ram_banking_enabled));
+	state.read(&in_bios, sizeof(in_bios));
+	state.read(&bios_type, sizeof(bios_type));
+	state.read(&bios_size, sizeof(bios_size));
+	state.read(&cart, sizeof(cart));
+	state.read(&previous_value, sizeof(previous_value));
+	state.read(&original_sys_type, sizeof(original_sys_type));
 
 	//Sanitize MMU data from save state
 	if((bios_size != 0x100) && (bios_size != 0x900)) { bios_size = 0x100; }
@@ -244,66 +239,33 @@ bool DMG_MMU::mmu_read(u32 offset, std::string filename)
 	vram_bank &= 0x1;
 	bank_mode &= 0x1;
 	bank_bits &= 0xF;
-
-	file.close();
-	return true;
 }
 
 /****** Write MMU data to save state ******/
-bool DMG_MMU::mmu_write(std::string filename)
+void DMG_MMU::mmu_write(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
-
 	//Serialize DMG/GBC RAM to save state
-	file.write(reinterpret_cast<char*> (&memory_map[0x8000]), 0x8000);
-	for(int x = 0; x < 0x2; x++) { file.write(reinterpret_cast<char*> (&video_ram[x][0]), 0x2000); }
-	for(int x = 0; x < 0x8; x++) { file.write(reinterpret_cast<char*> (&working_ram_bank[x][0]), 0x1000); }
-	for(int x = 0; x < 0x10; x++) { file.write(reinterpret_cast<char*> (&random_access_bank[x][0]), 0x2000); }
+	state.write(&memory_map[0x8000], 0x8000);
+	for(int x = 0; x < 0x2; x++) { state.write(&video_ram[x][0], 0x2000); }
+	for(int x = 0; x < 0x8; x++) { state.write(&working_ram_bank[x][0], 0x1000); }
+	for(int x = 0; x < 0x10; x++) { state.write(&random_access_bank[x][0], 0x2000); }
 
 	//Serialize misc MMU data to save state
-	file.write((char*)&rom_bank, sizeof(rom_bank));
-	file.write((char*)&ram_bank, sizeof(ram_bank));
-	file.write((char*)&wram_bank, sizeof(wram_bank));
-	file.write((char*)&vram_bank, sizeof(vram_bank));
-	file.write((char*)&bank_bits, sizeof(bank_bits));
-	file.write((char*)&bank_mode, sizeof(bank_mode));
-	file.write((char*)&ram_banking_enabled, sizeof(ram_banking_enabled));
-	file.write((char*)&in_bios, sizeof(in_bios));
-	file.write((char*)&bios_type, sizeof(bios_type));
-	file.write((char*)&bios_size, sizeof(bios_size));
-	file.write((char*)&cart, sizeof(cart));
-	file.write((char*)&previous_value, sizeof(previous_value));
-	file.write((char*)&original_sys_type, sizeof(original_sys_type));
-
-	file.close();
-	return true;
+	state.write(&rom_bank, sizeof(rom_bank));
+	state.write(&ram_bank, sizeof(ram_bank));
+	state.write(&wram_bank, sizeof(wram_bank));
+	state.write(&vram_bank, sizeof(vram_bank));
+	state.write(&bank_bits, sizeof(bank_bits));
+	state.write(&bank_mode, sizeof(bank_mode));
+	state.write(&ram_banking_enabled, sizeof(ram_banking_enabled));
+	state.write(&in_bios, sizeof(in_bios));
+	state.write(&bios_type, sizeof(bios_type));
+	state.write(&bios_size, sizeof(bios_size));
+	state.write(&cart, sizeof(cart));
+	state.write(&previous_value, sizeof(previous_value));
+	state.write(&original_sys_type, sizeof(original_sys_type));
 }
 
-/****** Gets the size of MMU data for serialization ******/
-u32 DMG_MMU::size()
-{
-	u32 mmu_size = 0;
-	
-	mmu_size += 0x34000;
-
-	mmu_size += sizeof(rom_bank);
-	mmu_size += sizeof(ram_bank);
-	mmu_size += sizeof(wram_bank);
-	mmu_size += sizeof(vram_bank);
-	mmu_size += sizeof(bank_bits);
-	mmu_size += sizeof(bank_mode);
-	mmu_size += sizeof(ram_banking_enabled);
-	mmu_size += sizeof(in_bios);
-	mmu_size += sizeof(bios_type);
-	mmu_size += sizeof(bios_size);
-	mmu_size += sizeof(cart);
-	mmu_size += sizeof(previous_value);
-	mmu_size += sizeof(original_sys_type);
-
-	return mmu_size;
-}
 	
 /****** Read byte from memory ******/
 u8 DMG_MMU::read_u8(u16 address) 
@@ -470,6 +432,8 @@ void DMG_MMU::write_u8(u16 address, u8 value)
 	debug_addr = address;
 	#endif
 
+	write_count++;
+
 	if(cart.mbc_type != ROM_ONLY) 
 	{
 		mbc_write(address, value);
@@ -19,6 +19,7 @@
 #include "common.h"
 #include "common/config.h"
 #include "gamepad.h"
+#include "common/save_state.h"
 #include "lcd_data.h"
 #include "apu_data.h"
 #include "sio_data.h"
@@ -61,6 +62,9 @@ class DMG_MMU
 
 	u8 original_sys_type;
 
+	//Local link sessions only keep Player 1's save data, every player shares the same path
+	bool write_backup;
+
 	//Bank controls
 	u16 rom_bank;
 	u8 ram_bank;
@@ -198,6 +202,9 @@ class DMG_MMU
 
 	bool div_reset;
 
+	//Stores seen by idle loop detection
+	u32 write_count;
+
 	dmg_core_pad* g_pad;
 
 	std::vector<u32> sub_screen_buffer;
@@ -311,9 +318,8 @@ class DMG_MMU
 	void set_sio_data(dmg_sio_data* ex_sio_stat);
 
 	//Serialize data for save state loading/saving
-	bool mmu_read(u32 offset, std::string filename);
-	bool mmu_write(std::string filename);
-	u32 size();
+	void mmu_read(state_reader& state);
+	void mmu_write(state_writer& state);
 
 	private:
 
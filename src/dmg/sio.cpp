@@ -53,6 +53,8 @@ DMG_SIO::~DMG_SIO()
 			net_util::send_data(sender, temp_buffer, 2);
 		}
 
+		receiver.stop();
+
 		net_util::close_comm(server);
 		net_util::close_comm(sender);
 	}
@@ -146,8 +148,8 @@ bool DMG_SIO::init()
 	//Initialize other Link Cable communications normally
 
 	//Server and Client info
-	net_util::setup_comm(server, config::netplay_server_port, NET_COMM_SERVER);
-	net_util::setup_comm(sender, config::netplay_client_port, NET_COMM_CLIENT);
+	net_util::setup_comm(server, config::netplay_server_port, NET_COMM_SERVER, config::netplay_local);
+	net_util::setup_comm(sender, config::netplay_client_port, NET_COMM_CLIENT, config::netplay_local);
 
 	//Use special port configuration for HuC-1/HuC-3 IR communications
 	//Network connections are set up by set_huc_ir_connection()
@@ -244,6 +246,8 @@ void DMG_SIO::reset()
 	sio_stat.ping_finish = false;
 	sio_stat.send_data = false;
 	sio_stat.halt_counter = 0;
+
+	rollback.reset(0);
 	
 	switch(config::sio_device)
 	{
@@ -537,6 +541,8 @@ void DMG_SIO::reset()
 					net_util::send_data(four_player_sender[x], temp_buffer, 2);
 				}
 
+				four_player_receiver[x].stop();
+
 				net_util::close_comm(four_player_server[x]);
 				net_util::close_comm(four_player_sender[x]);
 			}
@@ -563,6 +569,8 @@ void DMG_SIO::reset()
 		
 			net_util::send_data(sender, temp_buffer, 2);
 
+			receiver.stop();
+
 			net_util::close_comm(server);
 			net_util::close_comm(sender);
 		}
@@ -608,8 +616,32 @@ bool DMG_SIO::send_byte()
 {
 	#ifdef GBE_NETPLAY
 
+	//With rollback, finish the transfer right away with a predicted reply
+	if((sio_stat.sio_type == GB_LINK) && (rollback.enabled()))
+	{
+		u32 reply = 0;
+
+		//Transfers sent before resimulating only need their reply again
+		if(rollback.next_local_transfer(reply))
+		{
+			u8 temp_buffer[2];
+			temp_buffer[0] = sio_stat.transfer_byte;
+			temp_buffer[1] = 0;
+
+			if(net_util::send_data(sender, temp_buffer, 2) < 2)
+			{
+				std::cout<<"SIO::Error - Host failed to send data to client\n";
+				reset();
+				init();
+				return false;
+			}
+		}
+
+		mem->memory_map[REG_SB] = sio_stat.transfer_byte = (reply & 0xFF);
+	}
+
 	//Only do any of this if emulating a connected Link Cable
-	if(sio_stat.sio_type == GB_LINK)
+	else if(sio_stat.sio_type == GB_LINK)
 	{
 		u8 temp_buffer[2];
 		temp_buffer[0] = sio_stat.transfer_byte;
@@ -625,13 +657,13 @@ bool DMG_SIO::send_byte()
 
 		//Wait for other Game Boy to send this one its SB
 		//This is blocking, will effectively pause GBE+ until it gets something
-		if(net_util::recv_data(server, temp_buffer, 2, true) > 0)
+		if(receiver.wait(temp_buffer))
 		{
 			mem->memory_map[REG_SB] = sio_stat.transfer_byte = temp_buffer[0];
 		}
 
-		//Reset hard sync if new SIO byte sent
-		if((config::netplay_hard_sync) && (!sio_stat.use_hard_sync))
+		//Reset hard sync if new SIO byte sent - Rollback replaces hard sync for Link Cable bytes
+		if((config::netplay_hard_sync) && (!config::netplay_rollback) && (!sio_stat.use_hard_sync))
 		{
 			sio_stat.use_hard_sync = true;
 		}
@@ -655,6 +687,13 @@ bool DMG_SIO::send_ir_signal()
 
 	#ifdef GBE_NETPLAY
 
+	//Signals resimulated for rollback were already sent when their frame first ran
+	if(rollback.replaying())
+	{
+		mem->ir_stat.send = false;
+		return true;
+	}
+
 	u8 temp_buffer[2];
 
 	//For IR signals, flag it properly
@@ -672,7 +711,7 @@ bool DMG_SIO::send_ir_signal()
 
 	//Wait for other instance of GBE+ to send an acknowledgement
 	//This is blocking, will effectively pause GBE+ until it gets something
-	if(net_util::recv_data(server, temp_buffer, 2, true) > 0)
+	if(receiver.wait(temp_buffer))
 	{
 		mem->ir_stat.send = false;
 	}
@@ -694,17 +733,17 @@ bool DMG_SIO::receive_byte()
 	#ifdef GBE_NETPLAY
 
 	if(sio_stat.sio_type == GB_FOUR_PLAYER_ADAPTER) { return four_player_receive_byte(); }
-	if((!sio_stat.connected) || (server.tcp_sockets == nullptr)) { return false; }
+	if((!sio_stat.connected) || (!server.remote_init)) { return false; }
+
+	//Transfers received while resimulating wait until it finishes
+	if(rollback.replaying()) { return true; }
 
 	u8 temp_buffer[2];
 	temp_buffer[0] = temp_buffer[1] = 0;
 
-	//Check the status of connection
-	SDLNet_CheckSockets(server.tcp_sockets, 0);
-
-	//If this socket is active, receive the transfer
+	//If the receiving thread has a transfer waiting, process it
 	//This is non-blocking
-	if(net_util::recv_data(server, temp_buffer, 2) > 0)
+	if(receiver.pop(temp_buffer))
 	{
 		//Stop sync
 		if(temp_buffer[1] == 0xFF)
@@ -804,30 +843,32 @@ bool DMG_SIO::receive_byte()
 			return true;
 		}
 
+		//Reply to a byte sent with rollback
+		else if(temp_buffer[1] == 0x02)
+		{
+			rollback.confirm_transfer(temp_buffer[0]);
+			return true;
+		}
+
 		else if(temp_buffer[1] != 0) { return true; }
 
 		//Send transfer byte back to other Game Boy only if emulating the Link Cable
 		if(sio_stat.sio_type == GB_LINK)
 		{
-			//Raise SIO IRQ after sending byte
-			mem->memory_map[IF_FLAG] |= 0x08;
-
-			//Store byte from transfer into SB
-			sio_stat.transfer_byte = mem->memory_map[REG_SB];
-			mem->memory_map[REG_SB] = temp_buffer[0];
-
-			//Reset Bit 7 of SC
-			mem->memory_map[REG_SC] &= ~0x80;
+			//Keep a record so rollback can apply this transfer again while resimulating
+			rollback.log_event(LINK_EVENT_TRANSFER, temp_buffer[0]);
 
 			//Send other Game Boy the old SB value
-			temp_buffer[0] = sio_stat.transfer_byte;
-			sio_stat.transfer_byte = mem->memory_map[REG_SB];
+			temp_buffer[0] = link_cable_exchange(temp_buffer[0]);
+
+			//Mark the reply when using rollback
+			if(config::netplay_rollback) { temp_buffer[1] = 0x02; }
 
 			//Start hard sync timeout countdown
 			sio_stat.halt_counter = 0x400000;
 
-			//Reset hard sync if new SIO byte received
-			if((config::netplay_hard_sync) && (!sio_stat.use_hard_sync))
+			//Reset hard sync if new SIO byte received - Rollback replaces hard sync for Link Cable bytes
+			if((config::netplay_hard_sync) && (!config::netplay_rollback) && (!sio_stat.use_hard_sync))
 			{
 				sio_stat.use_hard_sync = true;		
 			}
@@ -851,6 +892,25 @@ bool DMG_SIO::receive_byte()
 	return true;
 }
 
+/****** Swaps SB with a byte clocked in by another Game Boy - Returns the old SB ******/
+u8 DMG_SIO::link_cable_exchange(u8 input)
+{
+	//Raise SIO IRQ after sending byte
+	mem->memory_map[IF_FLAG] |= 0x08;
+
+	//Store byte from transfer into SB
+	sio_stat.transfer_byte = mem->memory_map[REG_SB];
+	mem->memory_map[REG_SB] = input;
+
+	//Reset Bit 7 of SC
+	mem->memory_map[REG_SC] &= ~0x80;
+
+	u8 output = sio_stat.transfer_byte;
+	sio_stat.transfer_byte = mem->memory_map[REG_SB];
+
+	return output;
+}
+
 /****** Requests syncronization with another system ******/
 bool DMG_SIO::request_sync()
 {
@@ -908,6 +968,44 @@ bool DMG_SIO::stop_sync()
 	return true;
 }
 
+/****** Returns true once the other side of a netplay connection has hung up ******/
+bool DMG_SIO::link_lost()
+{
+	#ifdef GBE_NETPLAY
+
+	return receiver.disconnected();
+
+	#else
+
+	return false;
+
+	#endif
+}
+
+/****** Sleeps until the receiving thread has a transfer waiting or the timeout (in ms) passes ******/
+bool DMG_SIO::wait_receive(u32 timeout)
+{
+	#ifdef GBE_NETPLAY
+
+	return receiver.wait_pending(timeout);
+
+	#else
+
+	return false;
+
+	#endif
+}
+
+/****** Puts back the status that belongs to the live connection after a rollback snapshot is loaded ******/
+void DMG_SIO::restore_link_status(const dmg_sio_data& live)
+{
+	sio_stat.connected = live.connected;
+	sio_stat.sync = live.sync;
+	sio_stat.sync_counter = live.sync_counter;
+	sio_stat.use_hard_sync = live.use_hard_sync;
+	sio_stat.halt_counter = live.halt_counter;
+}
+
 /****** Manages network communication via SDL_net ******/
 void DMG_SIO::process_network_communication()
 {
@@ -949,6 +1047,12 @@ void DMG_SIO::process_network_communication()
 
 			//Set the emulated SIO device type
 			if((sio_stat.sio_type != GB_FOUR_PLAYER_ADAPTER) && (sio_stat.sio_type != NO_GB_DEVICE)) { sio_stat.sio_type = GB_LINK; }
+
+			//Start polling the server for transfers
+			receiver.start(&server, 2);
+
+			//Start keeping frames for rollback
+			rollback.reset(config::netplay_rollback);
 		}
 	}
 
@@ -983,14 +1087,22 @@ void DMG_SIO::resume_network_connection()
 	u8 temp_buffer[2];
 	temp_buffer[0] = temp_buffer[1] = 0;
 
-	if(server.tcp_sockets == nullptr) { return; }
+	if(!server.remote_init) { return; }
 
-	//Check the status of connection
-	SDLNet_CheckSockets(server.tcp_sockets, 0);
+	bool got_data = false;
 
-	//If this socket is active, receive the transfer
+	//The receiving thread keeps running while suspended, so take the transfer from it
+	if(receiver.running()) { got_data = receiver.pop(temp_buffer); }
+
+	//Otherwise check the status of connection directly
 	//This is non-blocking
-	if(net_util::recv_data(server, temp_buffer, 2) > 0)
+	else
+	{
+		net_util::check_sockets(server, 0);
+		got_data = (net_util::recv_data(server, temp_buffer, 2) > 0);
+	}
+
+	if(got_data)
 	{
 		//Stop sync
 		if(temp_buffer[1] == 0x81)
@@ -1017,7 +1129,7 @@ void DMG_SIO::set_huc_ir_connection()
 	if(network_init)
 	{
 		//Regular disconnect signal
-		if(sender.host_socket != nullptr)
+		if(sender.connected)
 		{
 			//Send disconnect byte to another system
 			u8 temp_buffer[2];
@@ -1027,6 +1139,8 @@ void DMG_SIO::set_huc_ir_connection()
 			net_util::send_data(sender, temp_buffer, 2);
 		}
 
+		receiver.stop();
+
 		net_util::close_comm(server);
 		net_util::close_comm(sender);
 
@@ -1037,8 +1151,8 @@ void DMG_SIO::set_huc_ir_connection()
 		u16 server_port = config::netplay_server_port + (16 * config::netplay_id) + mem->ir_stat.network_id;
 		u16 client_port = config::netplay_server_port + (16 * mem->ir_stat.network_id) + config::netplay_id;
 
-		net_util::setup_comm(server, server_port, NET_COMM_SERVER);
-		net_util::setup_comm(sender, client_port, NET_COMM_CLIENT);
+		net_util::setup_comm(server, server_port, NET_COMM_SERVER, config::netplay_local);
+		net_util::setup_comm(sender, client_port, NET_COMM_CLIENT, config::netplay_local);
 
 		//Clear up any syncing when the instance doing the switching suspends a network connection
 		sio_stat.sync = false;
@@ -24,6 +24,8 @@
 #include "sio_data.h"
 
 #include "common/net_util.h"
+#include "common/net_receiver.h"
+#include "common/link_rollback.h"
 
 class DMG_SIO
 {
@@ -53,8 +55,15 @@ class DMG_SIO
 	//Sending client (4-Player)
 	gbe_net_comm four_player_sender[3];
 
+	//Reads the receiving servers on separate threads
+	net_receiver receiver;
+	net_receiver four_player_receiver[3];
+
 	#endif
 
+	//Rollback for link cable netplay
+	link_rollback rollback;
+
 	//GB Printer
 	struct gb_printer
 	{
@@ -263,8 +272,12 @@ class DMG_SIO
 	bool send_byte();
 	bool send_ir_signal();
 	bool receive_byte();
+	u8 link_cable_exchange(u8 input);
 	bool request_sync();
 	bool stop_sync();
+	bool link_lost();
+	bool wait_receive(u32 timeout);
+	void restore_link_status(const dmg_sio_data& live);
 	void process_network_communication();
 	void suspend_network_connection();
 	void resume_network_connection();
@@ -13,6 +13,7 @@
 
 #include <string>
 #include <iostream>
+#include <cstring>
 
 #include "common.h"
 #include "mmu.h"
@@ -102,6 +103,16 @@ class SM83
 	bool double_speed;
 	bool skip_instruction;
 
+	//Idle loop detection - Last backwards jump target with AF, BC, DE, HL, SP, and IME
+	struct idle_loop_data
+	{
+		bool enable;
+		u16 addr;
+		u16 regs[5];
+		bool interrupt;
+		u32 write_count;
+	} idle_loop;
+
 	//Audio-Video and other controllers
 	struct io_controllers
 	{
@@ -119,13 +130,14 @@ class SM83
 	void exec_op(u16 opcode);
 
 	//Serialize data for save state loading/saving
-	bool cpu_read(u32 offset, std::string filename);
-	bool cpu_write(std::string filename);
-	u32 size();
+	void cpu_read(state_reader& state);
+	void cpu_write(state_writer& state);
 
 	//Interrupt handling
 	bool handle_interrupts();
 
+	void check_idle_loop();
+
 	inline void jr(u8 reg_one);
 
 	//Math functions
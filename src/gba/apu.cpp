@@ -13,6 +13,9 @@
 
 #include "apu.h"
 
+//Samples mixed at once on the emulation thread, small enough for register writes to be heard right away
+const u32 APU_BLOCK_SIZE = 32;
+
 /****** APU Constructor ******/
 AGB_APU::AGB_APU()
 {
@@ -148,6 +151,27 @@ void AGB_APU::reset()
 
 	mic_buffer.clear();
 	apu_stat.mic_id = 0;
+
+	//Default output buffering, resized when SDL audio opens
+	output_limit = 0x4000;
+	output_ring.resize(output_limit * 2);
+	last_output[0] = last_output[1] = 0;
+	mute_output = false;
+
+	sample_ticks = 0;
+	dma_idle_samples[0] = dma_idle_samples[1] = 0;
+	noise_clock = 0.0;
+
+	for(int x = 0; x < 4; x++)
+	{
+		psg_blip[x].reset(-32768);
+		psg_phase[x] = 0.0;
+	}
+
+	dma_resampler[0].reset();
+	dma_resampler[1].reset();
+	ext_audio_fraction = 0.0;
+	campho_fraction = 0.0;
 }
 
 /****** Initialize APU with SDL ******/
@@ -169,6 +193,13 @@ bool AGB_APU::init()
 		return false;
 	}
 
+	//In a local link session, only the first player owns the audio device, everyone else runs silently
+	if((config::netplay_local) && (SDL_GetAudioStatus() != SDL_AUDIO_STOPPED))
+	{
+		std::cout<<"APU::Initialized - Silent\n";
+		return true;
+	}
+
 	//Setup the desired audio specifications
     	desired_spec.freq = apu_stat.sample_rate;
 	desired_spec.format = AUDIO_S16SYS;
@@ -190,11 +221,13 @@ bool AGB_APU::init()
 		apu_stat.dma[0].master_volume = config::volume;
 		apu_stat.dma[1].master_volume = config::volume;
 
-		apu_stat.psg_fill_rate = apu_stat.sample_rate / 60;
+		//Keep about 2 callbacks worth of samples queued, anything more only adds latency
+		output_limit = desired_spec.samples * desired_spec.channels * 2;
+		output_ring.resize(output_limit * 2);
 
 		SDL_PauseAudio(0);
 		init_status = true;
-		std::cout<<"APU::Initialized\n";
+		std::cout<<"APU::Initialized - " << fir_kernel_name() << " resampler\n";
 	}
 
 	//Open microphone if enabled and if possible
@@ -266,199 +299,390 @@ bool AGB_APU::init()
 /******* Generate samples for GBA sound channel 1 ******/
 void AGB_APU::generate_channel_1_samples(s16* stream, int length)
 {
-	//Determine if more data needs to be buffered
-	while(apu_stat.channel[0].buffer_size < length)
+	//Generate samples from the last output of the channel
+	if((apu_stat.channel[0].playing) && (apu_stat.channel[0].left_enable || apu_stat.channel[0].right_enable))
 	{
-		buffer_channel_1();
-		apu_stat.psg_needs_fill = false;
-	}
+		int x = 0;
 
-	//Copy from last position in the buffer
-	for(int x = 0; x < length; x++)
-	{
-		stream[x] = apu_stat.channel[0].buffer[apu_stat.channel[0].last_index++];
-	}
+		while(x < length)
+		{
+			//Synthesize all samples up to the next sweep, envelope, or length change at once
+			u32 plain_samples = get_plain_samples(0, (length - x));
 
-	apu_stat.channel[0].buffer_size -= length;
+			if(plain_samples)
+			{
+				if(apu_stat.channel[0].sweep_time >= 1) { apu_stat.channel[0].sweep_counter += plain_samples; }
+				if(apu_stat.channel[0].envelope_step >= 1) { apu_stat.channel[0].envelope_counter += plain_samples; }
+				apu_stat.channel[0].sample_length -= plain_samples;
 
-	//Drain buffer if it gets too large
-	if(apu_stat.channel[0].buffer_size >= 512)
-	{
-		apu_stat.channel[0].buffer_size = 0;
-		apu_stat.channel[0].last_index = 0;
-		apu_stat.channel[0].current_index = 0;
+				render_square(0, x, plain_samples);
+				x += plain_samples;
+				continue;
+			}
+
+			//Process audio sweep
+			if(apu_stat.channel[0].sweep_time >= 1)
+			{
+				apu_stat.channel[0].sweep_counter++;
+
+				if(apu_stat.channel[0].sweep_counter >= ((apu_stat.sample_rate/128) * apu_stat.channel[0].sweep_time))
+				{
+					int pre_calc = 0;
+
+					//Increase frequency
+					if(apu_stat.channel[0].sweep_direction == 0)
+					{
+						if(apu_stat.channel[0].sweep_shift >= 1) { pre_calc = (apu_stat.channel[0].raw_frequency >> apu_stat.channel[0].sweep_shift); }
+
+						//When frequency is greater than 131KHz, stop sound
+						if((apu_stat.channel[0].raw_frequency + pre_calc) >= 0x800) 
+						{ 
+							apu_stat.channel[0].volume = apu_stat.channel[0].sweep_shift = apu_stat.channel[0].envelope_step = apu_stat.channel[0].sweep_time = 0; 
+							apu_stat.channel[0].playing = false; 
+						}
+
+						else 
+						{ 
+							apu_stat.channel[0].raw_frequency += pre_calc;
+							apu_stat.channel[0].output_frequency = 131072.0/(2048 - apu_stat.channel[0].raw_frequency);
+							mem->memory_map[SND1CNT_X] = (apu_stat.channel[0].raw_frequency & 0xFF);
+							mem->memory_map[SND1CNT_X+1] &= ~0x7;
+							mem->memory_map[SND1CNT_X+1] |= ((apu_stat.channel[0].raw_frequency >> 8) & 0x7);
+						}
+					}
+
+					//Decrease frequency
+					else if(apu_stat.channel[0].sweep_direction == 1)
+					{
+						if(apu_stat.channel[0].sweep_shift >= 1) { pre_calc = (apu_stat.channel[0].raw_frequency >> apu_stat.channel[0].sweep_shift); }
+
+						//Only sweep down when result of frequency change is greater than zero
+						if((apu_stat.channel[0].raw_frequency - pre_calc) >= 0) 
+						{ 
+							apu_stat.channel[0].raw_frequency -= pre_calc;
+							apu_stat.channel[0].output_frequency = 131072.0/(2048 - apu_stat.channel[0].raw_frequency);
+							mem->memory_map[SND1CNT_X] = (apu_stat.channel[0].raw_frequency & 0xFF);
+							mem->memory_map[SND1CNT_X+1] &= ~0x7;
+							mem->memory_map[SND1CNT_X+1] |= ((apu_stat.channel[0].raw_frequency >> 8) & 0x7);
+						}
+					}
+
+					apu_stat.channel[0].sweep_counter = 0;
+				}
+			} 
+
+			//Process audio envelope
+			if(apu_stat.channel[0].envelope_step >= 1)
+			{
+				apu_stat.channel[0].envelope_counter++;
+
+				if(apu_stat.channel[0].envelope_counter >= ((apu_stat.sample_rate/64) * apu_stat.channel[0].envelope_step)) 
+				{		
+					//Decrease volume
+					if((apu_stat.channel[0].envelope_direction == 0) && (apu_stat.channel[0].volume >= 1)) { apu_stat.channel[0].volume--; }
+				
+					//Increase volume
+					else if((apu_stat.channel[0].envelope_direction == 1) && (apu_stat.channel[0].volume < 0xF)) { apu_stat.channel[0].volume++; }
+
+					apu_stat.channel[0].envelope_counter = 0;
+				}
+			}
+
+			//Process audio waveform
+			if(apu_stat.channel[0].sample_length > 0) { render_square(0, x, 1); }
+
+			//Continuously generate sound if necessary
+			else if((apu_stat.channel[0].sample_length == 0) && (!apu_stat.channel[0].length_flag)) { apu_stat.channel[0].sample_length = apu_stat.sample_rate; }
+
+			//Or stop sound after duration has been met, reset Sound 1 On Flag
+			else if((apu_stat.channel[0].sample_length == 0) && (apu_stat.channel[0].length_flag)) 
+			{ 
+				psg_blip[0].set_level(x, -32768);
+				apu_stat.channel[0].sample_length = 0; 
+				apu_stat.channel[0].playing = false; 
+			}
+
+			apu_stat.channel[0].sample_length--;
+			x++;
+		}
 	}
+
+	//Otherwise, generate silence
+	else { psg_blip[0].set_level(0, -32768); }
+
+	psg_blip[0].read_samples(stream, length);
 }
 
 /******* Generate samples for GBA sound channel 2 ******/
 void AGB_APU::generate_channel_2_samples(s16* stream, int length)
 {
-	//Determine if more data needs to be buffered
-	while(apu_stat.channel[1].buffer_size < length)
+	//Generate samples from the last output of the channel
+	if((apu_stat.channel[1].playing) && (apu_stat.channel[1].left_enable || apu_stat.channel[1].right_enable))
 	{
-		buffer_channel_2();
-		apu_stat.psg_needs_fill = false;
-	}
+		int x = 0;
 
-	//Copy from last position in the buffer
-	for(int x = 0; x < length; x++)
-	{
-		stream[x] = apu_stat.channel[1].buffer[apu_stat.channel[1].last_index++];
-	}
+		while(x < length)
+		{
+			//Synthesize all samples up to the next envelope or length change at once
+			u32 plain_samples = get_plain_samples(1, (length - x));
 
-	apu_stat.channel[1].buffer_size -= length;
+			if(plain_samples)
+			{
+				if(apu_stat.channel[1].envelope_step >= 1) { apu_stat.channel[1].envelope_counter += plain_samples; }
+				apu_stat.channel[1].sample_length -= plain_samples;
 
-	//Drain buffer if it gets too large
-	if(apu_stat.channel[1].buffer_size >= 512)
-	{
-		apu_stat.channel[1].buffer_size = 0;
-		apu_stat.channel[1].last_index = 0;
-		apu_stat.channel[1].current_index = 0;
+				render_square(1, x, plain_samples);
+				x += plain_samples;
+				continue;
+			}
+
+			//Process audio envelope
+			if(apu_stat.channel[1].envelope_step >= 1)
+			{
+				apu_stat.channel[1].envelope_counter++;
+
+				if(apu_stat.channel[1].envelope_counter >= ((apu_stat.sample_rate/64) * apu_stat.channel[1].envelope_step)) 
+				{		
+					//Decrease volume
+					if((apu_stat.channel[1].envelope_direction == 0) && (apu_stat.channel[1].volume >= 1)) { apu_stat.channel[1].volume--; }
+				
+					//Increase volume
+					else if((apu_stat.channel[1].envelope_direction == 1) && (apu_stat.channel[1].volume < 0xF)) { apu_stat.channel[1].volume++; }
+
+					apu_stat.channel[1].envelope_counter = 0;
+				}
+			}
+
+			//Process audio waveform
+			if(apu_stat.channel[1].sample_length > 0) { render_square(1, x, 1); }
+
+			//Continuously generate sound if necessary
+			else if((apu_stat.channel[1].sample_length == 0) && (!apu_stat.channel[1].length_flag)) { apu_stat.channel[1].sample_length = apu_stat.sample_rate; }
+
+			//Or stop sound after duration has been met, reset Sound 2 On Flag
+			else if((apu_stat.channel[1].sample_length == 0) && (apu_stat.channel[1].length_flag)) 
+			{ 
+				psg_blip[1].set_level(x, -32768);
+				apu_stat.channel[1].sample_length = 0; 
+				apu_stat.channel[1].playing = false; 
+			}
+
+			apu_stat.channel[1].sample_length--;
+			x++;
+		}
 	}
+
+	//Otherwise, generate silence
+	else { psg_blip[1].set_level(0, -32768); }
+
+	psg_blip[1].read_samples(stream, length);
 }
 
 /******* Generate samples for GBA sound channel 3 ******/
 void AGB_APU::generate_channel_3_samples(s16* stream, int length)
 {
-	//Determine if more data needs to be buffered
-	while(apu_stat.channel[2].buffer_size < length)
+	//Generate samples from the last output of the channel, wave RAM needs a size first
+	if((apu_stat.channel[2].playing) && (apu_stat.channel[2].enable) && (apu_stat.channel[2].left_enable || apu_stat.channel[2].right_enable)
+	&& (apu_stat.waveram_size != 0) && (apu_stat.channel[2].output_frequency > 0))
 	{
-		buffer_channel_3();
-		apu_stat.psg_needs_fill = false;
-	}
+		int x = 0;
 
-	//Copy from last position in the buffer
-	for(int x = 0; x < length; x++)
-	{
-		stream[x] = apu_stat.channel[2].buffer[apu_stat.channel[2].last_index++];
-	}
+		while(x < length)
+		{
+			//Synthesize all samples up to the next length change at once
+			u32 plain_samples = get_plain_samples(2, (length - x));
+
+			if(plain_samples)
+			{
+				apu_stat.channel[2].sample_length -= plain_samples;
 
-	apu_stat.channel[2].buffer_size -= length;
+				render_wave(x, plain_samples);
+				x += plain_samples;
+				continue;
+			}
 
-	//Drain buffer if it gets too large
-	if(apu_stat.channel[2].buffer_size >= 512)
-	{
-		apu_stat.channel[2].buffer_size = 0;
-		apu_stat.channel[2].last_index = 0;
-		apu_stat.channel[2].current_index = 0;
+			//Process audio waveform
+			if(apu_stat.channel[2].sample_length > 0) { render_wave(x, 1); }
+
+			//Continuously generate sound if necessary
+			else if((apu_stat.channel[2].sample_length == 0) && (!apu_stat.channel[2].length_flag)) { apu_stat.channel[2].sample_length = apu_stat.sample_rate; }
+
+			//Or stop sound after duration has been met, reset Sound 3 On Flag
+			else if((apu_stat.channel[2].sample_length == 0) && (apu_stat.channel[2].length_flag)) 
+			{ 
+				psg_blip[2].set_level(x, -32768);
+				apu_stat.channel[2].sample_length = 0; 
+				apu_stat.channel[2].playing = false; 
+			}
+
+			apu_stat.channel[2].sample_length--;
+			x++;
+		}
 	}
+
+	//Otherwise, generate silence
+	else { psg_blip[2].set_level(0, -32768); }
+
+	psg_blip[2].read_samples(stream, length);
 }
 
 /******* Generate samples for GBA sound channel 4 ******/
 void AGB_APU::generate_channel_4_samples(s16* stream, int length)
 {
-	//Determine if more data needs to be buffered
-	while(apu_stat.channel[3].buffer_size < length)
+	//Generate samples from the last output of the channel
+	if((apu_stat.channel[3].playing) && (apu_stat.channel[3].left_enable || apu_stat.channel[3].right_enable))
 	{
-		buffer_channel_4();
-		apu_stat.psg_needs_fill = false;
-	}
+		int x = 0;
 
-	//Copy from last position in the buffer
-	for(int x = 0; x < length; x++)
-	{
-		stream[x] = apu_stat.channel[3].buffer[apu_stat.channel[3].last_index++];
-	}
+		while(x < length)
+		{
+			//Synthesize all samples up to the next envelope or length change at once
+			u32 plain_samples = get_plain_samples(3, (length - x));
 
-	apu_stat.channel[3].buffer_size -= length;
+			if(plain_samples)
+			{
+				if(apu_stat.channel[3].envelope_step >= 1) { apu_stat.channel[3].envelope_counter += plain_samples; }
+				apu_stat.channel[3].sample_length -= plain_samples;
 
-	//Drain buffer if it gets too large
-	if(apu_stat.channel[3].buffer_size >= 512)
-	{
-		apu_stat.channel[3].buffer_size = 0;
-		apu_stat.channel[3].last_index = 0;
-		apu_stat.channel[3].current_index = 0;
+				render_noise(x, plain_samples);
+				x += plain_samples;
+				continue;
+			}
+
+			if(apu_stat.channel[3].sample_length > 0)
+			{
+				//Process audio envelope
+				if(apu_stat.channel[3].envelope_step >= 1)
+				{
+					apu_stat.channel[3].envelope_counter++;
+
+					if(apu_stat.channel[3].envelope_counter >= ((apu_stat.sample_rate/64) * apu_stat.channel[3].envelope_step)) 
+					{		
+						//Decrease volume
+						if((apu_stat.channel[3].envelope_direction == 0) && (apu_stat.channel[3].volume >= 1)) { apu_stat.channel[3].volume--; }
+				
+						//Increase volume
+						else if((apu_stat.channel[3].envelope_direction == 1) && (apu_stat.channel[3].volume < 0xF)) { apu_stat.channel[3].volume++; }
+
+						apu_stat.channel[3].envelope_counter = 0;
+					}
+				}
+
+				render_noise(x, 1);
+			}
+
+			//Continuously generate sound if necessary
+			else if(apu_stat.channel[3].sample_length == 0) { apu_stat.channel[3].sample_length = apu_stat.sample_rate; }
+
+			//Or stop sound after duration has been met, reset Sound 4 On Flag
+			else
+			{
+				psg_blip[3].set_level(x, -32768);
+				apu_stat.channel[3].sample_length = 0;
+				apu_stat.channel[3].playing = false;
+			}
+
+			apu_stat.channel[3].sample_length--;
+			x++;
+		}
 	}
+
+	//Otherwise, generate silence
+	else { psg_blip[3].set_level(0, -32768); }
+
+	psg_blip[3].read_samples(stream, length);
 }
 
 /******* Generate samples for GBA DMA channel A ******/
 void AGB_APU::generate_dma_a_samples(s16* stream, int length)
 {
-	//Generate samples from the last output of the channel
-	if((apu_stat.dma[0].left_enable || apu_stat.dma[0].right_enable) && (apu_stat.dma[0].length != 0))
-	{
-		double sample_ratio = apu_stat.dma[0].output_frequency/apu_stat.sample_rate;
-		u8 buffer_sample = 0;
-		s8 buffer_output = 0;
-		u16 buffer_pos = 0;
+	u16 fifo_length = apu_stat.dma[0].length;
 
-		for(int x = 0; x < length; x++)
-		{
-			if((sample_ratio * x) < apu_stat.dma[0].length) { buffer_pos = apu_stat.dma[0].last_position + (sample_ratio * x); }
-			buffer_sample = apu_stat.dma[0].buffer[buffer_pos];
-			
-			if(buffer_sample & 0x80)
-			{
-				buffer_sample--;
-				buffer_sample = ~buffer_sample;
-				buffer_output = 0 - buffer_sample;
-			}
+	//FIFO data keeps the channel playing, stop after a frame passes without any
+	if(fifo_length) 
+	{
+		apu_stat.dma[0].playing = true;
+		dma_idle_samples[0] = 0;
+	}
 
-			else { buffer_output = buffer_sample; }
-			
+	else if(apu_stat.dma[0].playing)
+	{
+		dma_idle_samples[0] += length;
+		if(dma_idle_samples[0] >= (apu_stat.sample_rate / 60)) { apu_stat.dma[0].playing = false; }
+	}
 
-			//Scale S8 audio to S16
-			stream[x] = buffer_output * 256;
+	//Generate samples from FIFO data that arrived during this block
+	if((apu_stat.dma[0].left_enable || apu_stat.dma[0].right_enable) && (apu_stat.dma[0].playing))
+	{
+		//Scale S8 audio to S16
+		for(u16 x = 0; x < fifo_length; x++)
+		{
+			u16 buffer_pos = apu_stat.dma[0].last_position + x;
+			dma_resampler[0].write(apu_stat.dma[0].buffer[buffer_pos] * 256);
 		}
 
-		//Reset DMA channel A buffer
-		apu_stat.dma[0].counter = apu_stat.dma[0].last_position = buffer_pos;
+		//Resample from the timer's rate to the output rate, estimate it from the FIFO if the timer rate is unknown
+		double sample_ratio = apu_stat.dma[0].output_frequency / apu_stat.sample_rate;
+		if(sample_ratio <= 0.0) { sample_ratio = double(fifo_length) / length; }
+
+		dma_resampler[0].read_samples(stream, length, sample_ratio);
 	}
 
 	//Otherwise, generate silence
 	else 
 	{
 		for(int x = 0; x < length; x++) { stream[x] = -32768; }
-		apu_stat.dma[0].counter = apu_stat.dma[0].last_position = 0;
+		dma_resampler[0].reset();
 	}
 
-	if(apu_stat.dma[0].length > length) { apu_stat.dma[0].length -= length; }
-	else { apu_stat.dma[0].length = 0; }
+	apu_stat.dma[0].last_position += fifo_length;
+	apu_stat.dma[0].length = 0;
 }
 
 /******* Generate samples for GBA DMA channel B ******/
 void AGB_APU::generate_dma_b_samples(s16* stream, int length)
 {
-	//Generate samples from the last output of the channel
-	if((apu_stat.dma[1].left_enable || apu_stat.dma[1].right_enable) && (apu_stat.dma[1].length != 0))
-	{
-		double sample_ratio = apu_stat.dma[1].output_frequency/apu_stat.sample_rate;
-		u8 buffer_sample = 0;
-		s8 buffer_output = 0;
-		u16 buffer_pos = 0;
+	u16 fifo_length = apu_stat.dma[1].length;
 
-		for(int x = 0; x < length; x++)
-		{
-			if((sample_ratio * x) < apu_stat.dma[1].length) { buffer_pos = apu_stat.dma[1].last_position + (sample_ratio * x); }
-			buffer_sample = apu_stat.dma[1].buffer[buffer_pos];
-			
-			if(buffer_sample & 0x80)
-			{
-				buffer_sample--;
-				buffer_sample = ~buffer_sample;
-				buffer_output = 0 - buffer_sample;
-			}
+	//FIFO data keeps the channel playing, stop after a frame passes without any
+	if(fifo_length) 
+	{
+		apu_stat.dma[1].playing = true;
+		dma_idle_samples[1] = 0;
+	}
 
-			else { buffer_output = buffer_sample; }
-			
+	else if(apu_stat.dma[1].playing)
+	{
+		dma_idle_samples[1] += length;
+		if(dma_idle_samples[1] >= (apu_stat.sample_rate / 60)) { apu_stat.dma[1].playing = false; }
+	}
 
-			//Scale S8 audio to S16
-			stream[x] = buffer_output * 256;
+	//Generate samples from FIFO data that arrived during this block
+	if((apu_stat.dma[1].left_enable || apu_stat.dma[1].right_enable) && (apu_stat.dma[1].playing))
+	{
+		//Scale S8 audio to S16
+		for(u16 x = 0; x < fifo_length; x++)
+		{
+			u16 buffer_pos = apu_stat.dma[1].last_position + x;
+			dma_resampler[1].write(apu_stat.dma[1].buffer[buffer_pos] * 256);
 		}
 
-		//Reset DMA channel A buffer
-		apu_stat.dma[1].counter = apu_stat.dma[1].last_position = buffer_pos;
+		//Resample from the timer's rate to the output rate, estimate it from the FIFO if the timer rate is unknown
+		double sample_ratio = apu_stat.dma[1].output_frequency / apu_stat.sample_rate;
+		if(sample_ratio <= 0.0) { sample_ratio = double(fifo_length) / length; }
+
+		dma_resampler[1].read_samples(stream, length, sample_ratio);
 	}
 
 	//Otherwise, generate silence
 	else 
 	{
 		for(int x = 0; x < length; x++) { stream[x] = -32768; }
-		apu_stat.dma[1].counter = apu_stat.dma[1].last_position = 0;
+		dma_resampler[1].reset();
 	}
 
-	if(apu_stat.dma[1].length > length) { apu_stat.dma[1].length -= length; }
-	else { apu_stat.dma[1].length = 0; }
+	apu_stat.dma[1].last_position += fifo_length;
+	apu_stat.dma[1].length = 0;
 }
 
 /****** Generate raw samples for playback on external audio channel ******/
@@ -473,7 +697,7 @@ void AGB_APU::generate_ext_audio_hi_samples(s16* stream, int length)
 	if(apu_stat.ext_audio.buffer == nullptr) { return; }
 
 	double sample_ratio = apu_stat.ext_audio.frequency/apu_stat.sample_rate;
-	u32 last_pos = apu_stat.ext_audio.sample_pos;
+	double last_pos = apu_stat.ext_audio.sample_pos + ext_audio_fraction;
 	u32 buffer_pos = 0;
 
 	//Convert existing buffer to S16
@@ -593,7 +817,10 @@ void AGB_APU::generate_ext_audio_hi_samples(s16* stream, int length)
 		}	
 	}
 
-	apu_stat.ext_audio.sample_pos = buffer_pos;
+	//Carry the fractional position over to the next block
+	double next_pos = last_pos + (sample_ratio * length);
+	apu_stat.ext_audio.sample_pos = next_pos;
+	ext_audio_fraction = next_pos - apu_stat.ext_audio.sample_pos;
 }
 
 /****** Generate raw samples for playback on external audio channel - Campho Audio Edition ******/
@@ -607,7 +834,7 @@ void AGB_APU::generate_campho_audio_samples(s16* stream, int length)
 
 	for(int x = 0; x < length; x++)
 	{
-		buffer_pos = (sample_ratio * x);
+		buffer_pos = campho_fraction + (sample_ratio * x);
 
 		if(buffer_pos < buffer_size)
 		{
@@ -620,7 +847,11 @@ void AGB_APU::generate_campho_audio_samples(s16* stream, int length)
 		stream[x] = sample;
 	}
 
-	//Delete samples that have already been played
+	//Delete samples that have already been played, carrying the fractional position over to the next block
+	double next_pos = campho_fraction + (sample_ratio * length);
+	buffer_pos = next_pos;
+	campho_fraction = next_pos - buffer_pos;
+
 	if(buffer_pos >= buffer_size)
 	{
 		mem->campho.microphone_in_buffer.clear();
@@ -633,38 +864,36 @@ void AGB_APU::generate_campho_audio_samples(s16* stream, int length)
 	}
 }
 
-/****** SDL Audio Callback ******/ 
-void agb_audio_callback(void* _apu, u8 *_stream, int _length)
+/****** Mixes a block of samples for all channels and queues them for SDL ******/
+void AGB_APU::mix_samples(u32 length)
 {
-	s16* stream = (s16*) _stream;
-	int length = _length/2;
+	if(length > APU_BLOCK_SIZE) { length = APU_BLOCK_SIZE; }
+	u32 output_length = (config::use_stereo) ? (length * 2) : length;
 
-	//Set correct length for stereo
-	if(config::use_stereo) { length /= 2; }
+	s16 stream[APU_BLOCK_SIZE * 2];
 
-	std::vector<s16> channel_1_stream(length);
-	std::vector<s16> channel_2_stream(length);
-	std::vector<s16> channel_3_stream(length);
-	std::vector<s16> channel_4_stream(length);
+	s16 channel_1_stream[APU_BLOCK_SIZE];
+	s16 channel_2_stream[APU_BLOCK_SIZE];
+	s16 channel_3_stream[APU_BLOCK_SIZE];
+	s16 channel_4_stream[APU_BLOCK_SIZE];
 
-	std::vector<s16> dma_a_stream(length);
-	std::vector<s16> dma_b_stream(length);
+	s16 dma_a_stream[APU_BLOCK_SIZE];
+	s16 dma_b_stream[APU_BLOCK_SIZE];
 
-	std::vector<s16> ext_stream(length);
+	s16 ext_stream[APU_BLOCK_SIZE];
 
-	AGB_APU* apu_link = (AGB_APU*) _apu;
-	apu_link->generate_channel_1_samples(&channel_1_stream[0], length);
-	apu_link->generate_channel_2_samples(&channel_2_stream[0], length);
-	apu_link->generate_channel_3_samples(&channel_3_stream[0], length);
-	apu_link->generate_channel_4_samples(&channel_4_stream[0], length);
-	apu_link->generate_dma_a_samples(&dma_a_stream[0], length);
-	apu_link->generate_dma_b_samples(&dma_b_stream[0], length);
-
-	double channel_ratio = apu_link->apu_stat.channel_master_volume / 128.0;
-	double dma_a_ratio = apu_link->apu_stat.dma[0].master_volume / 128.0;
-	double dma_b_ratio = apu_link->apu_stat.dma[1].master_volume / 128.0;
-
-	double ext_ratio = (apu_link->apu_stat.ext_audio.volume & 0x3F) / 63.0;
+	generate_channel_1_samples(channel_1_stream, length);
+	generate_channel_2_samples(channel_2_stream, length);
+	generate_channel_3_samples(channel_3_stream, length);
+	generate_channel_4_samples(channel_4_stream, length);
+	generate_dma_a_samples(dma_a_stream, length);
+	generate_dma_b_samples(dma_b_stream, length);
+
+	double channel_ratio = apu_stat.channel_master_volume / 128.0;
+	double dma_a_ratio = apu_stat.dma[0].master_volume / 128.0;
+	double dma_b_ratio = apu_stat.dma[1].master_volume / 128.0;
+
+	double ext_ratio = (apu_stat.ext_audio.volume & 0x3F) / 63.0;
 	double emu_volume = config::volume / 128.0;
 
 	//Custom software mixing
@@ -691,28 +920,28 @@ void agb_audio_callback(void* _apu, u8 *_stream, int _length)
 			u32 index = (x * 2);
 
 			//Left sample
-			s32 ch1 = apu_link->apu_stat.channel[0].left_enable ? channel_1_stream[x] : -32768;
-			s32 ch2 = apu_link->apu_stat.channel[1].left_enable ? channel_2_stream[x] : -32768;
-			s32 ch3 = apu_link->apu_stat.channel[2].left_enable ? channel_3_stream[x] : -32768;
-			s32 ch4 = apu_link->apu_stat.channel[3].left_enable ? channel_4_stream[x] : -32768;
-			s32 ch5 = apu_link->apu_stat.dma[0].left_enable ? dma_a_stream[x] : -32768;
-			s32 ch6 = apu_link->apu_stat.dma[1].left_enable ? dma_b_stream[x] : -32768;
-
-			s32 out_sample = (ch1 + ch2 + ch3 + ch4) * channel_ratio * apu_link->apu_stat.channel_left_volume;
+			s32 ch1 = apu_stat.channel[0].left_enable ? channel_1_stream[x] : -32768;
+			s32 ch2 = apu_stat.channel[1].left_enable ? channel_2_stream[x] : -32768;
+			s32 ch3 = apu_stat.channel[2].left_enable ? channel_3_stream[x] : -32768;
+			s32 ch4 = apu_stat.channel[3].left_enable ? channel_4_stream[x] : -32768;
+			s32 ch5 = apu_stat.dma[0].left_enable ? dma_a_stream[x] : -32768;
+			s32 ch6 = apu_stat.dma[1].left_enable ? dma_b_stream[x] : -32768;
+
+			s32 out_sample = (ch1 + ch2 + ch3 + ch4) * channel_ratio * apu_stat.channel_left_volume;
 			out_sample += (ch5 * dma_a_ratio) + (ch6 * dma_b_ratio);
 			out_sample /= 6;
 
 			stream[index] = out_sample;
 
 			//Right sample
-			ch1 = apu_link->apu_stat.channel[0].right_enable ? channel_1_stream[x] : -32768;
-			ch2 = apu_link->apu_stat.channel[1].right_enable ? channel_2_stream[x] : -32768;
-			ch3 = apu_link->apu_stat.channel[2].right_enable ? channel_3_stream[x] : -32768;
-			ch4 = apu_link->apu_stat.channel[3].right_enable ? channel_4_stream[x] : -32768;
-			ch5 = apu_link->apu_stat.dma[0].right_enable ? dma_a_stream[x] : -32768;
-			ch6 = apu_link->apu_stat.dma[1].right_enable ? dma_b_stream[x] : -32768;
-
-			out_sample = (ch1 + ch2 + ch3 + ch4) * channel_ratio * apu_link->apu_stat.channel_right_volume;
+			ch1 = apu_stat.channel[0].right_enable ? channel_1_stream[x] : -32768;
+			ch2 = apu_stat.channel[1].right_enable ? channel_2_stream[x] : -32768;
+			ch3 = apu_stat.channel[2].right_enable ? channel_3_stream[x] : -32768;
+			ch4 = apu_stat.channel[3].right_enable ? channel_4_stream[x] : -32768;
+			ch5 = apu_stat.dma[0].right_enable ? dma_a_stream[x] : -32768;
+			ch6 = apu_stat.dma[1].right_enable ? dma_b_stream[x] : -32768;
+
+			out_sample = (ch1 + ch2 + ch3 + ch4) * channel_ratio * apu_stat.channel_right_volume;
 			out_sample += (ch5 * dma_a_ratio) + (ch6 * dma_b_ratio);
 			out_sample /= 6;
 
@@ -721,12 +950,12 @@ void agb_audio_callback(void* _apu, u8 *_stream, int _length)
 	}
 
 	//Mix in external audio if necessary
-	if(apu_link->apu_stat.ext_audio.playing)
+	if(apu_stat.ext_audio.playing)
 	{
 		//Generate raw samples (high quality)
-		if((apu_link->apu_stat.ext_audio.use_headphones) || (config::cart_type == AGB_CAMPHO) || (config::cart_type == AGB_TV_TUNER))
+		if((apu_stat.ext_audio.use_headphones) || (config::cart_type == AGB_CAMPHO) || (config::cart_type == AGB_TV_TUNER))
 		{
-			apu_link->generate_ext_audio_hi_samples(&ext_stream[0], length);
+			generate_ext_audio_hi_samples(ext_stream, length);
 		}
 
 		//Generate GBA samples (low quality)
@@ -736,7 +965,7 @@ void agb_audio_callback(void* _apu, u8 *_stream, int _length)
 		}
 
 		//Custom software mixing
-		for(u32 x = 0; x < length; x++)
+		for(u32 x = 0; x < output_length; x++)
 		{
 			//Mono audio
 			if(!config::use_stereo)
@@ -761,6 +990,51 @@ void agb_audio_callback(void* _apu, u8 *_stream, int _length)
 			}
 		}
 	}
+
+	//Drop the block if SDL is not keeping up, so latency stays bounded
+	if((output_ring.available() + output_length) <= output_limit) { output_ring.write(stream, output_length); }
+}
+
+/****** Mixes samples as emulated cycles pass ******/
+void AGB_APU::step(u32 cycles)
+{
+	//Nothing is mixed for frames that get rolled back, the output stays on the committed timeline
+	if(mute_output) { return; }
+
+	//GBA runs at 2^24 cycles per second, so each sample takes (2^24 / sample rate) cycles
+	sample_ticks += (u64(cycles) * u32(apu_stat.sample_rate));
+
+	while((sample_ticks >> 24) >= APU_BLOCK_SIZE)
+	{
+		mix_samples(APU_BLOCK_SIZE);
+		sample_ticks -= (u64(APU_BLOCK_SIZE) << 24);
+	}
+}
+
+/****** SDL Audio Callback ******/ 
+void agb_audio_callback(void* _apu, u8 *_stream, int _length)
+{
+	s16* stream = (s16*) _stream;
+	u32 length = _length/2;
+
+	AGB_APU* apu_link = (AGB_APU*) _apu;
+
+	//Drain samples mixed by the emulation thread, nothing else in the APU is touched here
+	u32 count = apu_link->output_ring.read(stream, length);
+
+	if((config::use_stereo) && (count >= 2))
+	{
+		apu_link->last_output[0] = stream[count - 2];
+		apu_link->last_output[1] = stream[count - 1];
+	}
+
+	else if((!config::use_stereo) && (count >= 1))
+	{
+		apu_link->last_output[0] = apu_link->last_output[1] = stream[count - 1];
+	}
+
+	//Hold the last output if emulation falls behind to avoid pops
+	for(u32 x = count; x < length; x++) { stream[x] = apu_link->last_output[x & 0x1]; }
 }
 
 /****** SDL Audio Callback - Microphone ******/ 
@@ -953,491 +1227,185 @@ void agb_microphone_callback(void* _apu, u8 *_stream, int _length)
 	}
 }
 
-/****** Fill PSG channels with audio data when buffering ******/
-void AGB_APU::buffer_channels()
+/****** Counts samples until the next sweep, envelope, or length event for a PSG channel ******/
+u32 AGB_APU::get_plain_samples(u8 id, u32 max_samples)
 {
-	buffer_channel_1();
-	buffer_channel_2();
-	buffer_channel_3();
-	buffer_channel_4();
-}
+	if(apu_stat.channel[id].sample_length <= 0) { return 0; }
 
-/****** Buffer GBA Channel 1 data ******/
-void AGB_APU::buffer_channel_1()
-{
-	int length = apu_stat.psg_fill_rate;
-	apu_stat.channel[0].buffer_size += length;
+	u32 count = (apu_stat.channel[id].sample_length < max_samples) ? apu_stat.channel[id].sample_length : max_samples;
 
-	//Generate samples from the last output of the channel
-	if((apu_stat.channel[0].playing) && (apu_stat.channel[0].left_enable || apu_stat.channel[0].right_enable))
+	//Sweeps only exist on Sound 1
+	if((id == 0) && (apu_stat.channel[id].sweep_time >= 1))
 	{
-		int frequency_samples = apu_stat.sample_rate/apu_stat.channel[0].output_frequency;
-
-		for(int x = 0; x < length; x++, apu_stat.channel[0].sample_length--)
-		{
-			//Process audio sweep
-			if(apu_stat.channel[0].sweep_time >= 1)
-			{
-				apu_stat.channel[0].sweep_counter++;
-
-				if(apu_stat.channel[0].sweep_counter >= ((apu_stat.sample_rate/128) * apu_stat.channel[0].sweep_time))
-				{
-					int pre_calc = 0;
-
-					//Increase frequency
-					if(apu_stat.channel[0].sweep_direction == 0)
-					{
-						if(apu_stat.channel[0].sweep_shift >= 1) { pre_calc = (apu_stat.channel[0].raw_frequency >> apu_stat.channel[0].sweep_shift); }
-
-						//When frequency is greater than 131KHz, stop sound
-						if((apu_stat.channel[0].raw_frequency + pre_calc) >= 0x800) 
-						{ 
-							apu_stat.channel[0].volume = apu_stat.channel[0].sweep_shift = apu_stat.channel[0].envelope_step = apu_stat.channel[0].sweep_time = 0; 
-							apu_stat.channel[0].playing = false; 
-						}
-
-						else 
-						{ 
-							apu_stat.channel[0].raw_frequency += pre_calc;
-							apu_stat.channel[0].output_frequency = 131072.0/(2048 - apu_stat.channel[0].raw_frequency);
-							mem->memory_map[SND1CNT_X] = (apu_stat.channel[0].raw_frequency & 0xFF);
-							mem->memory_map[SND1CNT_X+1] &= ~0x7;
-							mem->memory_map[SND1CNT_X+1] |= ((apu_stat.channel[0].raw_frequency >> 8) & 0x7);
-						}
-					}
-
-						//Decrease frequency
-						else if(apu_stat.channel[0].sweep_direction == 1)
-						{
-							if(apu_stat.channel[0].sweep_shift >= 1) { pre_calc = (apu_stat.channel[0].raw_frequency >> apu_stat.channel[0].sweep_shift); }
-
-							//Only sweep down when result of frequency change is greater than zero
-							if((apu_stat.channel[0].raw_frequency - pre_calc) >= 0) 
-							{ 
-								apu_stat.channel[0].raw_frequency -= pre_calc;
-								apu_stat.channel[0].output_frequency = 131072.0/(2048 - apu_stat.channel[0].raw_frequency);
-								mem->memory_map[SND1CNT_X] = (apu_stat.channel[0].raw_frequency & 0xFF);
-								mem->memory_map[SND1CNT_X+1] &= ~0x7;
-								mem->memory_map[SND1CNT_X+1] |= ((apu_stat.channel[0].raw_frequency >> 8) & 0x7);
-							}
-						}
-
-						apu_stat.channel[0].sweep_counter = 0;
-					}
-				} 
-
-			//Process audio envelope
-			if(apu_stat.channel[0].envelope_step >= 1)
-			{
-				apu_stat.channel[0].envelope_counter++;
-
-				if(apu_stat.channel[0].envelope_counter >= ((apu_stat.sample_rate/64) * apu_stat.channel[0].envelope_step)) 
-				{		
-					//Decrease volume
-					if((apu_stat.channel[0].envelope_direction == 0) && (apu_stat.channel[0].volume >= 1)) { apu_stat.channel[0].volume--; }
-				
-					//Increase volume
-					else if((apu_stat.channel[0].envelope_direction == 1) && (apu_stat.channel[0].volume < 0xF)) { apu_stat.channel[0].volume++; }
-
-					apu_stat.channel[0].envelope_counter = 0;
-				}
-			}
-
-			//Process audio waveform
-			if(apu_stat.channel[0].sample_length > 0)
-			{
-				apu_stat.channel[0].frequency_distance++;
-
-				//Reset frequency distance
-				if(apu_stat.channel[0].frequency_distance >= frequency_samples) { apu_stat.channel[0].frequency_distance = 0; }
-		
-				//Generate high wave form if duty cycle is on AND volume is not muted
-				if((apu_stat.channel[0].frequency_distance >= (frequency_samples/8) * apu_stat.channel[0].duty_cycle_start) 
-				&& (apu_stat.channel[0].frequency_distance < (frequency_samples/8) * apu_stat.channel[0].duty_cycle_end)
-				&& (apu_stat.channel[0].volume != 0))
-				{
-					apu_stat.channel[0].buffer[apu_stat.channel[0].current_index++] = -32768 + (4369 * apu_stat.channel[0].volume);
-				}
-
-				//Generate low wave form if duty cycle is off OR volume is muted
-				else { apu_stat.channel[0].buffer[apu_stat.channel[0].current_index++] = -32768; }
-			}
-
-			//Continuously generate sound if necessary
-			else if((apu_stat.channel[0].sample_length == 0) && (!apu_stat.channel[0].length_flag)) { apu_stat.channel[0].sample_length = apu_stat.sample_rate; }
-
-			//Or stop sound after duration has been met, reset Sound 1 On Flag
-			else if((apu_stat.channel[0].sample_length == 0) && (apu_stat.channel[0].length_flag)) 
-			{ 
-				apu_stat.channel[0].buffer[apu_stat.channel[0].current_index++] = -32768; 
-				apu_stat.channel[0].sample_length = 0; 
-				apu_stat.channel[0].playing = false; 
-			}
-		}
+		u32 limit = std::ceil((apu_stat.sample_rate/128) * apu_stat.channel[id].sweep_time);
+		u32 next = (limit > apu_stat.channel[id].sweep_counter) ? (limit - apu_stat.channel[id].sweep_counter) : 1;
+		if((next - 1) < count) { count = next - 1; }
 	}
 
-	//Otherwise, generate silence
-	else 
+	//Envelopes do not exist on Sound 3
+	if((id != 2) && (apu_stat.channel[id].envelope_step >= 1))
 	{
-		for(int x = 0; x < length; x++) { apu_stat.channel[0].buffer[apu_stat.channel[0].current_index++] = -32768; }
+		u32 limit = std::ceil((apu_stat.sample_rate/64) * apu_stat.channel[id].envelope_step);
+		u32 next = (limit > apu_stat.channel[id].envelope_counter) ? (limit - apu_stat.channel[id].envelope_counter) : 1;
+		if((next - 1) < count) { count = next - 1; }
 	}
+
+	return count;
 }
 
-/****** Buffer GBA Channel 2 data ******/
-void AGB_APU::buffer_channel_2()
+/****** Synthesizes square waves for Sound 1 or 2 - Only duty cycle edges are processed ******/
+void AGB_APU::render_square(u8 id, double time, u32 length)
 {
-	int length = apu_stat.psg_fill_rate;
-	apu_stat.channel[1].buffer_size += length;
-
-	//Generate samples from the last output of the channel
-	if((apu_stat.channel[1].playing) && (apu_stat.channel[1].left_enable || apu_stat.channel[1].right_enable))
-	{
-		int frequency_samples = apu_stat.sample_rate/apu_stat.channel[1].output_frequency;
-
-		for(int x = 0; x < length; x++, apu_stat.channel[1].sample_length--)
-		{
-			//Process audio envelope
-			if(apu_stat.channel[1].envelope_step >= 1)
-			{
-				apu_stat.channel[1].envelope_counter++;
+	double step = apu_stat.channel[id].output_frequency / apu_stat.sample_rate;
+	double duty_start = apu_stat.channel[id].duty_cycle_start / 8.0;
+	double duty_end = apu_stat.channel[id].duty_cycle_end / 8.0;
+	double end_time = time + length;
 
-				if(apu_stat.channel[1].envelope_counter >= ((apu_stat.sample_rate/64) * apu_stat.channel[1].envelope_step)) 
-				{		
-					//Decrease volume
-					if((apu_stat.channel[1].envelope_direction == 0) && (apu_stat.channel[1].volume >= 1)) { apu_stat.channel[1].volume--; }
-				
-					//Increase volume
-					else if((apu_stat.channel[1].envelope_direction == 1) && (apu_stat.channel[1].volume < 0xF)) { apu_stat.channel[1].volume++; }
+	s32 high_level = -32768 + (4369 * apu_stat.channel[id].volume);
+	bool muted = (apu_stat.channel[id].volume == 0) || (step <= 0.0);
 
-					apu_stat.channel[1].envelope_counter = 0;
-				}
-			}
+	while(true)
+	{
+		//Generate high wave form if duty cycle is on AND volume is not muted
+		bool is_high = (!muted) && (psg_phase[id] >= duty_start) && (psg_phase[id] < duty_end);
+		psg_blip[id].set_level(time, is_high ? high_level : -32768);
 
-			//Process audio waveform
-			if(apu_stat.channel[1].sample_length > 0)
-			{
-				apu_stat.channel[1].frequency_distance++;
-
-				//Reset frequency distance
-				if(apu_stat.channel[1].frequency_distance >= frequency_samples) { apu_stat.channel[1].frequency_distance = 0; }
-		
-				//Generate high wave form if duty cycle is on AND volume is not muted
-				if((apu_stat.channel[1].frequency_distance >= (frequency_samples/8) * apu_stat.channel[1].duty_cycle_start) 
-				&& (apu_stat.channel[1].frequency_distance < (frequency_samples/8) * apu_stat.channel[1].duty_cycle_end)
-				&& (apu_stat.channel[1].volume != 0))
-				{
-					apu_stat.channel[1].buffer[apu_stat.channel[1].current_index++] = -32768 + (4369 * apu_stat.channel[1].volume);
-				}
+		if(muted) { return; }
 
-				//Generate low wave form if duty cycle is off OR volume is muted
-				else { apu_stat.channel[1].buffer[apu_stat.channel[1].current_index++] = -32768; }
-			}
+		//Find the next duty cycle edge
+		double edge = 1.0;
+		if(psg_phase[id] < duty_start) { edge = duty_start; }
+		else if(psg_phase[id] < duty_end) { edge = duty_end; }
 
-			//Continuously generate sound if necessary
-			else if((apu_stat.channel[1].sample_length == 0) && (!apu_stat.channel[1].length_flag)) { apu_stat.channel[1].sample_length = apu_stat.sample_rate; }
+		double edge_time = time + ((edge - psg_phase[id]) / step);
 
-			//Or stop sound after duration has been met, reset Sound 1 On Flag
-			else if((apu_stat.channel[1].sample_length == 0) && (apu_stat.channel[1].length_flag)) 
-			{ 
-				apu_stat.channel[1].buffer[apu_stat.channel[1].current_index++] = -32768; 
-				apu_stat.channel[1].sample_length = 0; 
-				apu_stat.channel[1].playing = false; 
-			}
+		if(edge_time >= end_time)
+		{
+			psg_phase[id] += ((end_time - time) * step);
+			return;
 		}
-	}
 
-	//Otherwise, generate silence
-	else 
-	{
-		for(int x = 0; x < length; x++) { apu_stat.channel[1].buffer[apu_stat.channel[1].current_index++] = -32768; }
+		time = edge_time;
+		psg_phase[id] = (edge >= 1.0) ? 0.0 : edge;
 	}
 }
 
-
-/****** Buffer GBA Channel 3 data ******/
-void AGB_APU::buffer_channel_3()
+/****** Synthesizes wave RAM playback for Sound 3 - Only steps in the waveform are processed ******/
+void AGB_APU::render_wave(double time, u32 length)
 {
-	int length = apu_stat.psg_fill_rate;
-	apu_stat.channel[2].buffer_size += length;
-
-	//Generate samples from the last output of the channel
-	if((apu_stat.channel[2].playing) && (apu_stat.channel[2].enable) && (apu_stat.channel[2].left_enable || apu_stat.channel[2].right_enable))
-	{
-		double waveform_frequency = apu_stat.channel[2].output_frequency;
-		if(apu_stat.waveram_size == 64) { waveform_frequency /= 2.0; }
-
-		//Determine amount of samples per waveform sample
-		double wave_step = (apu_stat.sample_rate/waveform_frequency) / apu_stat.waveram_size;
-
-		//Generate silence if samples per waveform sample is zero
-		if(wave_step == 0) 
-		{ 
-			for(int x = 0; x < length; x++) { apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = -32768; }
-			return;
-		}
-
-		int frequency_samples = apu_stat.sample_rate/waveform_frequency;
-
-		for(int x = 0; x < length; x++, apu_stat.channel[2].sample_length--)
-		{
-			if(apu_stat.channel[2].sample_length > 0)
-			{
-				apu_stat.channel[2].frequency_distance++;
-				
-				//Reset frequency distance
-				if(apu_stat.channel[2].frequency_distance >= frequency_samples) { apu_stat.channel[2].frequency_distance = 0; }
-
-				//Determine which step in the waveform the current sample corresponds to
-				u8 step = int(floor(apu_stat.channel[2].frequency_distance/wave_step)) % apu_stat.waveram_size;
-
-				//Grab wave RAM sample data for even samples
-				if(step % 2 == 0)
-				{
-					step >>= 1;
-
-					if(apu_stat.waveram_size == 32) 
-					{
-						apu_stat.waveram_sample = apu_stat.waveram_data[(apu_stat.waveram_bank_play << 4) + step] >> 4;
-					}
-
-					else
-					{
-						apu_stat.waveram_sample = apu_stat.waveram_data[step] >> 4;
-					}
-	
-					//Scale waveform to S16 audio stream
-					switch(apu_stat.channel[2].volume)
-					{
-						case 0x0:
-							apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = -32768;
-							break;
-
-						case 0x1:
-							apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = -32768 + (4369 * apu_stat.waveram_sample);
-							break;
+	double waveform_frequency = apu_stat.channel[2].output_frequency;
+	if(apu_stat.waveram_size == 64) { waveform_frequency /= 2.0; }
 
-						case 0x2:
-							apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = (-32768 + (4369 * apu_stat.waveram_sample)) * 0.5;
-							break;
+	//Phase for Sound 3 is kept in waveform steps rather than whole waveforms
+	double step = (waveform_frequency * apu_stat.waveram_size) / apu_stat.sample_rate;
+	double end_time = time + length;
 
-						case 0x3:
-							apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = (-32768 + (4369 * apu_stat.waveram_sample)) * 0.25;
-							break;
+	if(psg_phase[2] >= apu_stat.waveram_size) { psg_phase[2] = std::fmod(psg_phase[2], apu_stat.waveram_size); }
 
-						case 0x4:
-							apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = (-32768 + (4369 * apu_stat.waveram_sample)) * 0.75;
-							break;
-
-						default:
-							apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = -32768;
-							break;
-					}
-				}
-
-				//Grab wave RAM step data for odd steps
-				else
-				{
-					step >>= 1;
-
-					if(apu_stat.waveram_size == 32) 
-					{
-						apu_stat.waveram_sample = apu_stat.waveram_data[(apu_stat.waveram_bank_play << 4) + step] & 0xF;
-					}
-
-					else
-					{
-						apu_stat.waveram_sample = apu_stat.waveram_data[step] & 0xF;
-					}
-	
-					//Scale waveform to S16 audio stream
-					switch(apu_stat.channel[2].volume)
-					{
-						case 0x0:
-							apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = -32768;
-							break;
-
-						case 0x1:
-							apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = -32768 + (4369 * apu_stat.waveram_sample);
-							break;
+	while(true)
+	{
+		//Determine which step in the waveform the current sample corresponds to
+		u8 wave_step = psg_phase[2];
+		u8 wave_pos = (apu_stat.waveram_size == 32) ? ((apu_stat.waveram_bank_play << 4) + (wave_step >> 1)) : (wave_step >> 1);
 
-						case 0x2:
-							apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = (-32768 + (4369 * apu_stat.waveram_sample)) * 0.5;
-							break;
+		//Grab wave RAM sample data, high nibble for even steps, low nibble for odd steps
+		if(wave_step & 0x1) { apu_stat.waveram_sample = apu_stat.waveram_data[wave_pos] & 0xF; }
+		else { apu_stat.waveram_sample = apu_stat.waveram_data[wave_pos] >> 4; }
 
-						case 0x3:
-							apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = (-32768 + (4369 * apu_stat.waveram_sample)) * 0.25;
-							break;
+		//Scale waveform to S16 audio stream
+		s32 wave_level = -32768;
 
-						case 0x4:
-							apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = (-32768 + (4369 * apu_stat.waveram_sample)) * 0.75;
-							break;
+		switch(apu_stat.channel[2].volume)
+		{
+			case 0x1: wave_level = -32768 + (4369 * apu_stat.waveram_sample); break;
+			case 0x2: wave_level = (-32768 + (4369 * apu_stat.waveram_sample)) * 0.5; break;
+			case 0x3: wave_level = (-32768 + (4369 * apu_stat.waveram_sample)) * 0.25; break;
+			case 0x4: wave_level = (-32768 + (4369 * apu_stat.waveram_sample)) * 0.75; break;
+		}
 
-						default:
-							apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = -32768;
-							break;
-					}
-				}
-			}
+		psg_blip[2].set_level(time, wave_level);
 
-			//Continuously generate sound if necessary
-			else if((apu_stat.channel[2].sample_length == 0) && (!apu_stat.channel[2].length_flag)) { apu_stat.channel[2].sample_length = apu_stat.sample_rate; }
+		//Find the next step in the waveform
+		double edge = wave_step + 1;
+		double edge_time = time + ((edge - psg_phase[2]) / step);
 
-			//Or stop sound after duration has been met, reset Sound 1 On Flag
-			else if((apu_stat.channel[2].sample_length == 0) && (apu_stat.channel[2].length_flag)) 
-			{ 
-				apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = -32768; 
-				apu_stat.channel[2].sample_length = 0; 
-				apu_stat.channel[2].playing = false; 
-			}
+		if(edge_time >= end_time)
+		{
+			psg_phase[2] += ((end_time - time) * step);
+			return;
 		}
-	}
 
-	//Otherwise, generate silence
-	else 
-	{
-		for(int x = 0; x < length; x++) { apu_stat.channel[2].buffer[apu_stat.channel[2].current_index++] = -32768; }
+		time = edge_time;
+		psg_phase[2] = (edge >= apu_stat.waveram_size) ? 0.0 : edge;
 	}
 }
 
-/****** Buffer GBA Channel 4 data ******/
-void AGB_APU::buffer_channel_4()
+/****** Synthesizes noise for Sound 4 - Only LSFR clocks are processed ******/
+void AGB_APU::render_noise(double time, u32 length)
 {
-	int length = apu_stat.psg_fill_rate;
-	apu_stat.channel[3].buffer_size += length;
+	double step = apu_stat.channel[3].output_frequency / apu_stat.sample_rate;
+	double end_time = time + length;
+	s32 high_level = -32768 + (4369 * apu_stat.channel[3].volume);
 
-	//Generate samples from the last output of the channel
-	if((apu_stat.channel[3].playing) && (apu_stat.channel[3].left_enable || apu_stat.channel[3].right_enable))
+	while(true)
 	{
-		double samples_per_freq = apu_stat.channel[3].output_frequency/apu_stat.sample_rate;
-		double samples_per_freq_counter = 0;
-		u32 lsfr_runs = 0;
+		//Generate high wave if LSFR returns 1 from first byte and volume is not muted
+		bool is_high = false;
 
-		for(int x = 0; x < length; x++, apu_stat.channel[3].sample_length--)
-		{
-			if(apu_stat.channel[3].sample_length > 0)
-			{
-				apu_stat.channel[3].frequency_distance++;
-				samples_per_freq_counter += samples_per_freq;
+		if((apu_stat.noise_stages == 15) && (apu_stat.noise_15_stage_lsfr & 0x1) && (apu_stat.channel[3].volume >= 1)) { is_high = true; }
+		else if((apu_stat.noise_stages == 7) && (apu_stat.noise_7_stage_lsfr & 0x1) && (apu_stat.channel[3].volume >= 1)) { is_high = true; }
 
-				//Process audio envelope
-				if(apu_stat.channel[3].envelope_step >= 1)
-				{
-					apu_stat.channel[3].envelope_counter++;
+		psg_blip[3].set_level(time, is_high ? high_level : -32768);
 
-					if(apu_stat.channel[3].envelope_counter >= ((apu_stat.sample_rate/64) * apu_stat.channel[3].envelope_step)) 
-					{		
-						//Decrease volume
-						if((apu_stat.channel[3].envelope_direction == 0) && (apu_stat.channel[3].volume >= 1)) { apu_stat.channel[3].volume--; }
-				
-						//Increase volume
-						else if((apu_stat.channel[3].envelope_direction == 1) && (apu_stat.channel[3].volume < 0xF)) { apu_stat.channel[3].volume++; }
+		if(step <= 0.0) { return; }
 
-						apu_stat.channel[3].envelope_counter = 0;
-					}
-				}
+		//Find the next LSFR clock
+		double clock_time = time + ((1.0 - noise_clock) / step);
 
-				//Determine how many times to run LSFR
-				if(samples_per_freq_counter >= 1)
-				{
-					lsfr_runs = 0;
-					while(samples_per_freq_counter >= 1)
-					{
-						samples_per_freq_counter -= 1.0;
-						lsfr_runs++;
-					}
+		if(clock_time >= end_time)
+		{
+			noise_clock += ((end_time - time) * step);
+			return;
+		}
 
-					//Run LSFR
-					for(int y = 0; y < lsfr_runs; y++)
-					{
-						//7-stage
-						if(apu_stat.noise_stages == 7)
-						{
-							u8 bit_0 = (apu_stat.noise_7_stage_lsfr & 0x1) ? 1 : 0;
-							u8 bit_1 = (apu_stat.noise_7_stage_lsfr & 0x2) ? 1 : 0;
-							u8 result = bit_0 ^ bit_1;
-							apu_stat.noise_7_stage_lsfr >>= 1;
-							
-							if(result == 1) { apu_stat.noise_7_stage_lsfr |= 0x40; }
-						}
+		time = clock_time;
+		noise_clock = 0.0;
 
-						//15-stage
-						else if(apu_stat.noise_stages == 15)
-						{
-							u8 bit_0 = (apu_stat.noise_15_stage_lsfr & 0x1) ? 1 : 0;
-							u8 bit_1 = (apu_stat.noise_15_stage_lsfr & 0x2) ? 1 : 0;
-							u8 result = bit_0 ^ bit_1;
-							apu_stat.noise_15_stage_lsfr >>= 1;
+		//7-stage
+		if(apu_stat.noise_stages == 7)
+		{
+			u8 bit_0 = (apu_stat.noise_7_stage_lsfr & 0x1) ? 1 : 0;
+			u8 bit_1 = (apu_stat.noise_7_stage_lsfr & 0x2) ? 1 : 0;
+			u8 result = bit_0 ^ bit_1;
+			apu_stat.noise_7_stage_lsfr >>= 1;
 							
-							if(result == 1) { apu_stat.noise_15_stage_lsfr |= 0x4000; }
-						}
-					}
-				}
-
-				//Generate high wave if LSFR returns 1 from first byte and volume is not muted
-				if((apu_stat.noise_stages == 15) && (apu_stat.noise_15_stage_lsfr & 0x1) && (apu_stat.channel[3].volume >= 1)) 
-				{ 
-					apu_stat.channel[3].buffer[apu_stat.channel[3].current_index++] = -32768 + (4369 * apu_stat.channel[3].volume); 
-				}
-
-				else if((apu_stat.noise_stages == 7) && (apu_stat.noise_7_stage_lsfr & 0x1) && (apu_stat.channel[3].volume >= 1)) 
-				{ 
-					apu_stat.channel[3].buffer[apu_stat.channel[3].current_index++] = -32768 + (4369 * apu_stat.channel[3].volume); 
-				}
-
-				//Or generate low wave
-				else { apu_stat.channel[3].buffer[apu_stat.channel[3].current_index++] = -32768; }
-			}
-
-			//Continuously generate sound if necessary
-			else if(apu_stat.channel[3].sample_length == 0) { apu_stat.channel[3].sample_length = apu_stat.sample_rate; }
-
-			//Or stop sound after duration has been met, reset Sound 4 On Flag
-			else
-			{
-				apu_stat.channel[3].sample_length = 0;
-				apu_stat.channel[3].buffer[apu_stat.channel[3].current_index++] = -32768;
-				apu_stat.channel[3].playing = false;
-			}
+			if(result == 1) { apu_stat.noise_7_stage_lsfr |= 0x40; }
 		}
-	}
 
-	//Otherwise, generate silence
-	else 
-	{
-		for(int x = 0; x < length; x++) { apu_stat.channel[3].buffer[apu_stat.channel[3].current_index++] = -32768; }
+		//15-stage
+		else if(apu_stat.noise_stages == 15)
+		{
+			u8 bit_0 = (apu_stat.noise_15_stage_lsfr & 0x1) ? 1 : 0;
+			u8 bit_1 = (apu_stat.noise_15_stage_lsfr & 0x2) ? 1 : 0;
+			u8 result = bit_0 ^ bit_1;
+			apu_stat.noise_15_stage_lsfr >>= 1;
+							
+			if(result == 1) { apu_stat.noise_15_stage_lsfr |= 0x4000; }
+		}
 	}
 }
 
 /****** Read APU data from save state ******/
-bool AGB_APU::apu_read(u32 offset, std::string filename)
+void AGB_APU::apu_read(state_reader& state)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
-
 	//Serialize APU data from save state
-	file.read((char*)&apu_stat, sizeof(apu_stat));
-
-	file.close();
-	return true;
+	state.read(&apu_stat, sizeof(apu_stat));
 }
 
 /****** Write APU data to save state ******/
-bool AGB_APU::apu_write(std::string filename)
+void AGB_APU::apu_write(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
-
 	//Serialize APU data to save state
-	file.write((char*)&apu_stat, sizeof(apu_stat));
-
-	file.close();
-	return true;
+	state.write(&apu_stat, sizeof(apu_stat));
 }
 
-/****** Gets the size of APU data for serialization ******/
-u32 AGB_APU::size() { return sizeof(apu_stat); }
@@ -8,6 +8,7 @@
 //
 // Sets up SDL audio for mixing
 // Generates and mixes samples for the GBA's 4 sound channels + DMA channels 
+// Samples are mixed on the emulation thread as cycles pass, SDL only drains the results
 
 #ifndef GBA_APU
 #define GBA_APU
@@ -16,6 +17,9 @@
 #include <SDL_audio.h>
 #include "mmu.h"
 
+#include "common/audio_ring.h"
+#include "common/audio_synth.h"
+
 class AGB_APU
 {
 	public:
@@ -31,17 +35,22 @@ class AGB_APU
 	//Recording buffer for microphone input
 	std::vector<s16> mic_buffer;
 
+	//Mixed samples waiting for the SDL audio callback
+	audio_ring output_ring;
+	u32 output_limit;
+	s16 last_output[2];
+
+	//Set while running frames ahead (run-ahead)
+	bool mute_output;
+
 	AGB_APU();
 	~AGB_APU();
 
 	bool init();
 	void reset();
 
-	void buffer_channels();
-	void buffer_channel_1();
-	void buffer_channel_2();
-	void buffer_channel_3();
-	void buffer_channel_4();
+	void step(u32 cycles);
+	void mix_samples(u32 length);
 
 	void generate_channel_1_samples(s16* stream, int length);
 	void generate_channel_2_samples(s16* stream, int length);
@@ -53,9 +62,28 @@ class AGB_APU
 	void generate_campho_audio_samples(s16* stream, int length);
 
 	//Serialize data for save state loading/saving
-	bool apu_read(u32 offset, std::string filename);
-	bool apu_write(std::string filename);
-	u32 size();
+	void apu_read(state_reader& state);
+	void apu_write(state_writer& state);
+
+	private:
+
+	u32 get_plain_samples(u8 id, u32 max_samples);
+	void render_square(u8 id, double time, u32 length);
+	void render_wave(double time, u32 length);
+	void render_noise(double time, u32 length);
+
+	//Output sample position in GBA cycles, scaled by the sample rate
+	u64 sample_ticks;
+
+	//Band-limited synthesis state for Sound 1-4 and Direct Sound
+	blip_buffer psg_blip[4];
+	double psg_phase[4];
+	double noise_clock;
+
+	fir_resampler dma_resampler[2];
+	u32 dma_idle_samples[2];
+	double ext_audio_fraction;
+	double campho_fraction;
 };
 
 /****** SDL Audio Callback ******/ 
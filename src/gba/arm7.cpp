@@ -11,9 +11,17 @@
 
 #include "arm7.h"
 
+ARM7::arm_instructions ARM7::arm_decode_table[4096];
+ARM7::arm_instructions ARM7::thumb_decode_table[1024];
+ARM7::arm_handler ARM7::arm_handler_table[THUMB_19 + 1];
+ARM7::thumb_handler ARM7::thumb_handler_table[THUMB_19 + 1];
+u8 ARM7::debug_message_table[THUMB_19 + 1];
+bool ARM7::decode_tables_ready = false;
+
 /****** CPU Constructor ******/
 ARM7::ARM7()
 {
+	build_decode_tables();
 	reset();
 }
 
@@ -82,6 +90,10 @@ void ARM7::reset()
 
 	system_cycles = 0;
 
+	idle_loop.enable = false;
+	idle_loop.addr = 0xFFFFFFFF;
+	idle_loop.write_count = 0;
+
 	debug_message = 0xFF;
 	debug_code = 0;
 	debug_cycles = 0;
@@ -307,6 +319,8 @@ void ARM7::set_spsr(u32 value)
 /****** Fetch ARM instruction ******/
 void ARM7::fetch()
 {
+	//Grab pre-decoded instructions from the code block cache when possible
+	if(fetch_block()) { return; }
 
 	#ifdef GBE_FAST_FETCH
 
@@ -362,450 +376,547 @@ void ARM7::decode()
 {
 	u8 pipeline_id = (pipeline_pointer + 2) % 3;
 
-	if(instruction_operation[pipeline_id] == PIPELINE_FILL) { return; }
+	//Skip pipeline fills and instructions already decoded by the code block cache
+	if(instruction_operation[pipeline_id] != UNDEFINED) { return; }
 
-	//Decode THUMB instructions
+	//Decode THUMB instructions - Lookup using Bits 15-6
 	if(arm_mode == THUMB)
 	{
-		u16 current_instruction = instruction_pipeline[pipeline_id];
-		
-		if(((current_instruction >> 13) == 0) && (((current_instruction >> 11) & 0x7) != 0x3))
-		{
-			//THUMB_1
-			instruction_operation[pipeline_id] = THUMB_1;
-		}
+		instruction_operation[pipeline_id] = thumb_decode_table[(instruction_pipeline[pipeline_id] >> 6) & 0x3FF];
+	}
 
-		else if(((current_instruction >> 11) & 0x1F) == 0x3)
-		{
-			//THUMB_2
-			instruction_operation[pipeline_id] = THUMB_2;
-		}
+	//Decode ARM instructions - Lookup using Bits 27-20 and Bits 7-4
+	else
+	{
+		u32 current_instruction = instruction_pipeline[pipeline_id];
+		instruction_operation[pipeline_id] = arm_decode_table[((current_instruction >> 16) & 0xFF0) | ((current_instruction >> 4) & 0xF)];
+	}
+}
 
-		else if((current_instruction >> 13) == 0x1)
-		{
-			//THUMB_3
-			instruction_operation[pipeline_id] = THUMB_3;
-		}
+/****** Execute ARM instruction ******/
+void ARM7::execute()
+{
+	u8 pipeline_id = (pipeline_pointer + 1) % 3;
+	arm_instructions current_operation = instruction_operation[pipeline_id];
 
-		else if(((current_instruction >> 10) & 0x3F) == 0x10)
-		{
-			//THUMB_4
-			instruction_operation[pipeline_id] = THUMB_4;
-		}
+	if(current_operation == PIPELINE_FILL) 
+	{
+		debug_message = 0xFF; 
+		return; 
+	}
+
+	debug_code = instruction_pipeline[pipeline_id];
+
+	//Execute THUMB instruction
+	if(arm_mode == THUMB)
+	{
+		thumb_handler handler = thumb_handler_table[current_operation];
 
-		else if(((current_instruction >> 10) & 0x3F) == 0x11)
+		if(handler != nullptr)
 		{
-			//THUMB_5
-			instruction_operation[pipeline_id] = THUMB_5;
+			(this->*handler)(instruction_pipeline[pipeline_id]);
+			debug_message = debug_message_table[current_operation];
 		}
 
-		else if((current_instruction >> 11) == 0x9)
+		else
 		{
-			//THUMB_6
-			instruction_operation[pipeline_id] = THUMB_6;
+			debug_message = 0x13;
+			if(!config::ignore_illegal_opcodes) { running = false; }
 		}
+	}
 
-		else if((current_instruction >> 12) == 0x5)
+	//Execute ARM instruction
+	else if(arm_mode == ARM)
+	{
+		//Conditionally execute ARM instruction
+		if(check_condition(instruction_pipeline[pipeline_id]))
 		{
-			if(current_instruction & 0x200)
+			arm_handler handler = arm_handler_table[current_operation];
+
+			if(handler != nullptr)
 			{
-				//THUMB_8
-				instruction_operation[pipeline_id] = THUMB_8;
+				(this->*handler)(instruction_pipeline[pipeline_id]);
+				debug_message = debug_message_table[current_operation];
 			}
 
 			else
 			{
-				//THUMB_7
-				instruction_operation[pipeline_id] = THUMB_7;
+				debug_message = 0x1E;
+				if(!config::ignore_illegal_opcodes) { running = false; }
 			}
 		}
 
-		else if(((current_instruction >> 13) & 0x7) == 0x3)
-		{
-			//THUMB_9
-			instruction_operation[pipeline_id] = THUMB_9;
-		}
+		//Skip ARM instruction
+		else 
+		{ 
+			debug_message = 0x1F; 
 
-		else if((current_instruction >> 12) == 0x8)
-		{
-			//THUMB_10
-			instruction_operation[pipeline_id] = THUMB_10;
+			//Clock CPU and controllers - 1S
+			clock(reg.r15, false); 
 		}
+	}
+}
 
-		else if((current_instruction >> 12) == 0x9)
-		{
-			//THUMB_11
-			instruction_operation[pipeline_id] = THUMB_11;
-		}
+/****** Classifies a THUMB instruction - Used to build the THUMB decoding table ******/
+ARM7::arm_instructions ARM7::classify_thumb(u16 current_instruction)
+{
+	if(((current_instruction >> 13) == 0) && (((current_instruction >> 11) & 0x7) != 0x3))
+	{
+		//THUMB_1
+		return THUMB_1;
+	}
 
-		else if((current_instruction >> 12) == 0xA)
-		{
-			//THUMB_12
-			instruction_operation[pipeline_id] = THUMB_12;
-		}
+	else if(((current_instruction >> 11) & 0x1F) == 0x3)
+	{
+		//THUMB_2
+		return THUMB_2;
+	}
 
-		else if((current_instruction >> 8) == 0xB0)
-		{
-			//THUMB_13
-			instruction_operation[pipeline_id] = THUMB_13;
-		}
+	else if((current_instruction >> 13) == 0x1)
+	{
+		//THUMB_3
+		return THUMB_3;
+	}
 
-		else if((current_instruction >> 12) == 0xB)
-		{
-			//THUMB_14
-			instruction_operation[pipeline_id] = THUMB_14;
-		}
+	else if(((current_instruction >> 10) & 0x3F) == 0x10)
+	{
+		//THUMB_4
+		return THUMB_4;
+	}
 
-		else if((current_instruction >> 12) == 0xC)
-		{
-			//THUMB_15
-			instruction_operation[pipeline_id] = THUMB_15;
-		}
+	else if(((current_instruction >> 10) & 0x3F) == 0x11)
+	{
+		//THUMB_5
+		return THUMB_5;
+	}
 
-		else if((current_instruction >> 12) == 13)
-		{
-			//THUMB_16
-			instruction_operation[pipeline_id] = THUMB_16;
-		}
+	else if((current_instruction >> 11) == 0x9)
+	{
+		//THUMB_6
+		return THUMB_6;
+	}
 
-		else if((current_instruction >> 11) == 0x1C)
+	else if((current_instruction >> 12) == 0x5)
+	{
+		if(current_instruction & 0x200)
 		{
-			//THUMB_18
-			instruction_operation[pipeline_id] = THUMB_18;
+			//THUMB_8
+			return THUMB_8;
 		}
 
-		else if((current_instruction >> 11) >= 0x1E)
+		else
 		{
-			//THUMB_19
-			instruction_operation[pipeline_id] = THUMB_19;
+			//THUMB_7
+			return THUMB_7;
 		}
 	}
 
-	//Decode ARM instructions
-	if(arm_mode == ARM)
+	else if(((current_instruction >> 13) & 0x7) == 0x3)
 	{
-		u32 current_instruction = instruction_pipeline[pipeline_id];
+		//THUMB_9
+		return THUMB_9;
+	}
+
+	else if((current_instruction >> 12) == 0x8)
+	{
+		//THUMB_10
+		return THUMB_10;
+	}
+
+	else if((current_instruction >> 12) == 0x9)
+	{
+		//THUMB_11
+		return THUMB_11;
+	}
+
+	else if((current_instruction >> 12) == 0xA)
+	{
+		//THUMB_12
+		return THUMB_12;
+	}
+
+	else if((current_instruction >> 8) == 0xB0)
+	{
+		//THUMB_13
+		return THUMB_13;
+	}
+
+	else if((current_instruction >> 12) == 0xB)
+	{
+		//THUMB_14
+		return THUMB_14;
+	}
+
+	else if((current_instruction >> 12) == 0xC)
+	{
+		//THUMB_15
+		return THUMB_15;
+	}
+
+	else if((current_instruction >> 12) == 13)
+	{
+		//THUMB_16
+		return THUMB_16;
+	}
+
+	else if((current_instruction >> 11) == 0x1C)
+	{
+		//THUMB_18
+		return THUMB_18;
+	}
+
+	else if((current_instruction >> 11) >= 0x1E)
+	{
+		//THUMB_19
+		return THUMB_19;
+	}
+
+	return UNDEFINED;
+}
+
+/****** Classifies an ARM instruction - Used to build the ARM decoding table ******/
+ARM7::arm_instructions ARM7::classify_arm(u32 current_instruction)
+{
+	if(((current_instruction >> 8) & 0xFFFFF) == 0x12FFF)
+	{
+		//ARM_3
+		return ARM_3;
+	}
 
-		if(((current_instruction >> 8) & 0xFFFFF) == 0x12FFF)
+	else if(((current_instruction >> 25) & 0x7) == 0x5)
+	{
+		//ARM_4
+		return ARM_4;
+	}
+
+	//TODO - Move ARM_6 decoding to final stage of ARM_5 decoding
+	//TODO - Move ARM_12 deconding to final stage of ARM_10 decoding		
+
+	else if((current_instruction & 0xD900000) == 0x1000000) 
+	{
+
+		if((current_instruction & 0x80) && (current_instruction & 0x10) && ((current_instruction & 0x2000000) == 0))
 		{
-			//ARM_3
-			instruction_operation[pipeline_id] = ARM_3;
+			if(((current_instruction >> 5) & 0x3) == 0) 
+			{ 
+				return ARM_12;
+			}
+
+			else 
+			{
+				return ARM_10;
+			}
 		}
 
-		else if(((current_instruction >> 25) & 0x7) == 0x5)
+		else 
 		{
-			//ARM_4
-			instruction_operation[pipeline_id] = ARM_4;
+			//ARM_6
+			return ARM_6;
 		}
+	}
 
-		//TODO - Move ARM_6 decoding to final stage of ARM_5 decoding
-		//TODO - Move ARM_12 deconding to final stage of ARM_10 decoding		
-
-		else if((current_instruction & 0xD900000) == 0x1000000) 
+	else if(((current_instruction >> 26) & 0x3) == 0x0)
+	{
+		if((current_instruction & 0x80) && ((current_instruction & 0x10) == 0))
 		{
+			//ARM.5
+			if(current_instruction & 0x2000000)
+			{
+				return ARM_5;
+			}
 
-			if((current_instruction & 0x80) && (current_instruction & 0x10) && ((current_instruction & 0x2000000) == 0))
+			//ARM.5
+			else if((current_instruction & 0x100000) && (((current_instruction >> 23) & 0x3) == 0x2))
 			{
-				if(((current_instruction >> 5) & 0x3) == 0) 
-				{ 
-					instruction_operation[pipeline_id] = ARM_12;
-				}
+				return ARM_5;
+			}
 
-				else 
-				{
-					instruction_operation[pipeline_id] = ARM_10;
-				}
+			//ARM.5
+			else if(((current_instruction >> 23) & 0x3) != 0x2)
+			{
+				return ARM_5;
 			}
 
-			else 
+			//ARM.7
+			else
 			{
-				//ARM_6
-				instruction_operation[pipeline_id] = ARM_6;
+				return ARM_7;
 			}
 		}
 
-		else if(((current_instruction >> 26) & 0x3) == 0x0)
+		else if((current_instruction & 0x80) && (current_instruction & 0x10))
 		{
-			if((current_instruction & 0x80) && ((current_instruction & 0x10) == 0))
+			if(((current_instruction >> 4) & 0xF) == 0x9)
 			{
 				//ARM.5
 				if(current_instruction & 0x2000000)
 				{
-					instruction_operation[pipeline_id] = ARM_5;
-				}
-
-				//ARM.5
-				else if((current_instruction & 0x100000) && (((current_instruction >> 23) & 0x3) == 0x2))
-				{
-					instruction_operation[pipeline_id] = ARM_5;
+					return ARM_5;
 				}
 
-				//ARM.5
-				else if(((current_instruction >> 23) & 0x3) != 0x2)
+				//ARM.12
+				else if(((current_instruction >> 23) & 0x3) == 0x2)
 				{
-					instruction_operation[pipeline_id] = ARM_5;
+					return ARM_12;
 				}
 
 				//ARM.7
 				else
 				{
-					instruction_operation[pipeline_id] = ARM_7;
+					return ARM_7;
 				}
 			}
 
-			else if((current_instruction & 0x80) && (current_instruction & 0x10))
+			//ARM.5
+			else if(current_instruction & 0x2000000)
 			{
-				if(((current_instruction >> 4) & 0xF) == 0x9)
-				{
-					//ARM.5
-					if(current_instruction & 0x2000000)
-					{
-						instruction_operation[pipeline_id] = ARM_5;
-					}
-
-					//ARM.12
-					else if(((current_instruction >> 23) & 0x3) == 0x2)
-					{
-						instruction_operation[pipeline_id] = ARM_12;
-					}
-
-					//ARM.7
-					else
-					{
-						instruction_operation[pipeline_id] = ARM_7;
-					}
-				}
-
-				//ARM.5
-				else if(current_instruction & 0x2000000)
-				{
-					instruction_operation[pipeline_id] = ARM_5;
-				}
-
-				//ARM.10
-				else
-				{
-					instruction_operation[pipeline_id] = ARM_10;
-				}
+				return ARM_5;
 			}
 
-			//ARM.5
+			//ARM.10
 			else
 			{
-				instruction_operation[pipeline_id] = ARM_5;
+				return ARM_10;
 			}
 		}
 
-		else if(((current_instruction >> 26) & 0x3) == 0x1)
+		//ARM.5
+		else
 		{
-			//ARM_9
-			instruction_operation[pipeline_id] = ARM_9;
+			return ARM_5;
 		}
+	}
 
-		else if(((current_instruction >> 25) & 0x7) == 0x4)
-		{
-			//ARM_11
-			instruction_operation[pipeline_id] = ARM_11;
-		}
+	else if(((current_instruction >> 26) & 0x3) == 0x1)
+	{
+		//ARM_9
+		return ARM_9;
+	}
 
-		else if(((current_instruction >> 24) & 0xF) == 0xF)
-		{
-			//ARM_13
-			instruction_operation[pipeline_id] = ARM_13;
-		}
+	else if(((current_instruction >> 25) & 0x7) == 0x4)
+	{
+		//ARM_11
+		return ARM_11;
+	}
+
+	else if(((current_instruction >> 24) & 0xF) == 0xF)
+	{
+		//ARM_13
+		return ARM_13;
 	}
+
+	return UNDEFINED;
 }
 
-/****** Execute ARM instruction ******/
-void ARM7::execute()
+/****** Builds the lookup tables used to decode and dispatch instructions ******/
+void ARM7::build_decode_tables()
 {
-	u8 pipeline_id = (pipeline_pointer + 1) % 3;
+	if(decode_tables_ready) { return; }
 
-	if(instruction_operation[pipeline_id] == PIPELINE_FILL) 
+	//THUMB - Every format is fully determined by Bits 15-6
+	for(u32 x = 0; x < 1024; x++) { thumb_decode_table[x] = classify_thumb(x << 6); }
+
+	//ARM - Every format is fully determined by Bits 27-20 and Bits 7-4, except ARM.3
+	//ARM.3 also checks Bits 19-8, so fill them in as 0xFFF for its slot. Other encodings in that slot are undefined on the ARM7TDMI
+	for(u32 x = 0; x < 4096; x++)
 	{
-		debug_message = 0xFF; 
-		return; 
+		u32 current_instruction = ((x & 0xFF0) << 16) | ((x & 0xF) << 4);
+		if(x == 0x121) { current_instruction |= 0xFFF00; }
+
+		arm_decode_table[x] = classify_arm(current_instruction);
 	}
 
-	//Execute THUMB instruction
-	if(arm_mode == THUMB)
+	//Dispatch tables, indexed by the decoded operation
+	for(u32 x = 0; x <= THUMB_19; x++)
 	{
-		switch(instruction_operation[pipeline_id])
-		{
-			case THUMB_1:
-				move_shifted_register(instruction_pipeline[pipeline_id]);
-				debug_message = 0x0; debug_code = instruction_pipeline[pipeline_id];
-				break;
+		arm_handler_table[x] = nullptr;
+		thumb_handler_table[x] = nullptr;
+		debug_message_table[x] = 0;
+	}
 
-			case THUMB_2:
-				add_sub_immediate(instruction_pipeline[pipeline_id]);
-				debug_message = 0x1; debug_code = instruction_pipeline[pipeline_id];
-				break;
+	arm_handler_table[ARM_3] = &ARM7::branch_exchange; debug_message_table[ARM_3] = 0x14;
+	arm_handler_table[ARM_4] = &ARM7::branch_link; debug_message_table[ARM_4] = 0x15;
+	arm_handler_table[ARM_5] = &ARM7::data_processing; debug_message_table[ARM_5] = 0x16;
+	arm_handler_table[ARM_6] = &ARM7::psr_transfer; debug_message_table[ARM_6] = 0x17;
+	arm_handler_table[ARM_7] = &ARM7::multiply; debug_message_table[ARM_7] = 0x18;
+	arm_handler_table[ARM_9] = &ARM7::single_data_transfer; debug_message_table[ARM_9] = 0x19;
+	arm_handler_table[ARM_10] = &ARM7::halfword_signed_transfer; debug_message_table[ARM_10] = 0x1A;
+	arm_handler_table[ARM_11] = &ARM7::block_data_transfer; debug_message_table[ARM_11] = 0x1B;
+	arm_handler_table[ARM_12] = &ARM7::single_data_swap; debug_message_table[ARM_12] = 0x1C;
+	arm_handler_table[ARM_13] = &ARM7::software_interrupt_breakpoint; debug_message_table[ARM_13] = 0x1D;
+
+	thumb_handler_table[THUMB_1] = &ARM7::move_shifted_register; debug_message_table[THUMB_1] = 0x0;
+	thumb_handler_table[THUMB_2] = &ARM7::add_sub_immediate; debug_message_table[THUMB_2] = 0x1;
+	thumb_handler_table[THUMB_3] = &ARM7::mcas_immediate; debug_message_table[THUMB_3] = 0x2;
+	thumb_handler_table[THUMB_4] = &ARM7::alu_ops; debug_message_table[THUMB_4] = 0x3;
+	thumb_handler_table[THUMB_5] = &ARM7::hireg_bx; debug_message_table[THUMB_5] = 0x4;
+	thumb_handler_table[THUMB_6] = &ARM7::load_pc_relative; debug_message_table[THUMB_6] = 0x5;
+	thumb_handler_table[THUMB_7] = &ARM7::load_store_reg_offset; debug_message_table[THUMB_7] = 0x6;
+	thumb_handler_table[THUMB_8] = &ARM7::load_store_sign_ex; debug_message_table[THUMB_8] = 0x7;
+	thumb_handler_table[THUMB_9] = &ARM7::load_store_imm_offset; debug_message_table[THUMB_9] = 0x8;
+	thumb_handler_table[THUMB_10] = &ARM7::load_store_halfword; debug_message_table[THUMB_10] = 0x9;
+	thumb_handler_table[THUMB_11] = &ARM7::load_store_sp_relative; debug_message_table[THUMB_11] = 0xA;
+	thumb_handler_table[THUMB_12] = &ARM7::get_relative_address; debug_message_table[THUMB_12] = 0xB;
+	thumb_handler_table[THUMB_13] = &ARM7::add_offset_sp; debug_message_table[THUMB_13] = 0xC;
+	thumb_handler_table[THUMB_14] = &ARM7::push_pop; debug_message_table[THUMB_14] = 0xD;
+	thumb_handler_table[THUMB_15] = &ARM7::multiple_load_store; debug_message_table[THUMB_15] = 0xE;
+	thumb_handler_table[THUMB_16] = &ARM7::conditional_branch; debug_message_table[THUMB_16] = 0xF;
+	thumb_handler_table[THUMB_18] = &ARM7::unconditional_branch; debug_message_table[THUMB_18] = 0x11;
+	thumb_handler_table[THUMB_19] = &ARM7::long_branch_link; debug_message_table[THUMB_19] = 0x12;
+
+	decode_tables_ready = true;
+}
 
-			case THUMB_3:
-				mcas_immediate(instruction_pipeline[pipeline_id]);
-				debug_message = 0x2; debug_code = instruction_pipeline[pipeline_id];
-				break;
+/****** Fetch ARM instruction from the code block cache ******/
+bool ARM7::fetch_block()
+{
+	agb_block_cache& cache = mem->code_cache;
+	if(!cache.enable) { return false; }
 
-			case THUMB_4:
-				alu_ops(instruction_pipeline[pipeline_id]);
-				debug_message = 0x3; debug_code = instruction_pipeline[pipeline_id];
-				break;
+	agb_code_block* block = cache.current_block;
 
-			case THUMB_5:
-				hireg_bx(instruction_pipeline[pipeline_id]);
-				debug_message = 0x4; debug_code = instruction_pipeline[pipeline_id];
-				break;
+	u32 addr = reg.r15;
+	bool thumb = (arm_mode == THUMB);
+	u8 shift = thumb ? 1 : 2;
 
-			case THUMB_6:
-				load_pc_relative(instruction_pipeline[pipeline_id]);
-				debug_message = 0x5; debug_code = instruction_pipeline[pipeline_id];
-				break;
+	//Look up a new block unless the PC is still inside the current one
+	if((block == nullptr) || (block->thumb != thumb) || (addr < block->start_addr) || (addr >= block->end_addr))
+	{
+		auto cached_block = cache.blocks.find(addr | thumb);
 
-			case THUMB_7:
-				load_store_reg_offset(instruction_pipeline[pipeline_id]);
-				debug_message = 0x6; debug_code = instruction_pipeline[pipeline_id];
-				break;
+		if(cached_block != cache.blocks.end()) { block = &cached_block->second; }
+		else if(block_cacheable(addr)) { block = build_block(addr, thumb); }
+		else { block = nullptr; }
 
-			case THUMB_8:
-				load_store_sign_ex(instruction_pipeline[pipeline_id]);
-				debug_message = 0x7; debug_code = instruction_pipeline[pipeline_id];
-				break;
+		cache.current_block = block;
+		if(block == nullptr) { return false; }
+	}
 
-			case THUMB_9:
-	 			load_store_imm_offset(instruction_pipeline[pipeline_id]);
-				debug_message = 0x8; debug_code = instruction_pipeline[pipeline_id];
-				break;
+	u32 index = (addr - block->start_addr) >> shift;
+	instruction_pipeline[pipeline_pointer] = block->opcode[index];
+	instruction_operation[pipeline_pointer] = arm_instructions(block->operation[index]);
 
-			case THUMB_10:
-				load_store_halfword(instruction_pipeline[pipeline_id]);
-				debug_message = 0x9; debug_code = instruction_pipeline[pipeline_id];
-				break;
+	return true;
+}
 
-			case THUMB_11:
-				load_store_sp_relative(instruction_pipeline[pipeline_id]);
-				debug_message = 0xA; debug_code = instruction_pipeline[pipeline_id];
-				break;
+/****** Checks whether code at a given address can be cached ******/
+bool ARM7::block_cacheable(u32 addr)
+{
+	//Misaligned PCs always go through the normal fetch
+	if(addr & ((arm_mode == THUMB) ? 0x1 : 0x3)) { return false; }
 
-			case THUMB_12:
-				get_relative_address(instruction_pipeline[pipeline_id]);
-				debug_message = 0xB; debug_code = instruction_pipeline[pipeline_id];
-				break;
+	agb_block_cache& cache = mem->code_cache;
 
-			case THUMB_13:
-				add_offset_sp(instruction_pipeline[pipeline_id]);
-				debug_message = 0xC; debug_code = instruction_pipeline[pipeline_id];
-				break;
+	switch(addr >> 24)
+	{
+		//EWRAM and IWRAM - Writes invalidate cached blocks by page. Self-modifying pages fall back to the normal fetch
+		case 0x2: return (addr <= 0x203FFFF) && (cache.page_invalidations[(addr & 0x3FFFF) >> BLOCK_PAGE_SHIFT] < BLOCK_MAX_INVALIDATIONS);
+		case 0x3: return (addr <= 0x3007FFF) && (cache.page_invalidations[BLOCK_EWRAM_PAGES + ((addr & 0x7FFF) >> BLOCK_PAGE_SHIFT)] < BLOCK_MAX_INVALIDATIONS);
 
-			case THUMB_14:
-				push_pop(instruction_pipeline[pipeline_id]);
-				debug_message = 0xD; debug_code = instruction_pipeline[pipeline_id];
-				break;
+		//ROM and its mirrors - Skip the first page (GPIO) and carts that remap or stream ROM contents
+		case 0x8:
+		case 0x9:
+		case 0xA:
+		case 0xB:
+		case 0xC:
+			if((addr & 0x1FFFFFF) < (1 << BLOCK_PAGE_SHIFT)) { return false; }
 
-			case THUMB_15:
-				multiple_load_store(instruction_pipeline[pipeline_id]);
-				debug_message = 0xE; debug_code = instruction_pipeline[pipeline_id];
-				break;
+			switch(config::cart_type)
+			{
+				case AGB_AM3:
+				case AGB_JUKEBOX:
+				case AGB_PLAY_YAN:
+				case AGB_CAMPHO:
+				case AGB_TV_TUNER:
+					return false;
+
+				default: return true;
+			}
 
-			case THUMB_16:
-				conditional_branch(instruction_pipeline[pipeline_id]);
-				debug_message = 0xF; debug_code = instruction_pipeline[pipeline_id];
-				break;
+		default: return false;
+	}
+}
 
-			case THUMB_18:
-				unconditional_branch(instruction_pipeline[pipeline_id]);
-				debug_message = 0x11; debug_code = instruction_pipeline[pipeline_id];
-				break;
+/****** Pre-decodes a run of instructions up to the next branch and adds it to the code block cache ******/
+agb_code_block* ARM7::build_block(u32 addr, bool thumb)
+{
+	u32 key = addr | thumb;
+	u32 page_end = (addr | ((1 << BLOCK_PAGE_SHIFT) - 1)) + 1;
+
+	agb_code_block& block = mem->code_cache.blocks[key];
+	block.start_addr = addr;
+	block.thumb = thumb;
+	block.opcode.clear();
+	block.operation.clear();
+	block.host_code = nullptr;
+	block.run_count = 0;
+	block.host_mode = current_cpu_mode;
+	block.host_banked = false;
+
+	while((addr < page_end) && (block.opcode.size() < BLOCK_MAX_LENGTH))
+	{
+		u32 current_instruction = 0;
+		arm_instructions current_operation = UNDEFINED;
 
-			case THUMB_19:
-				long_branch_link(instruction_pipeline[pipeline_id]);
-				debug_message = 0x12; debug_code = instruction_pipeline[pipeline_id];
-				break;
+		if(thumb)
+		{
+			#ifdef GBE_FAST_FETCH
+			current_instruction = mem->read_u16_fast(addr);
+			#else
+			current_instruction = mem->read_u16(addr);
+			#endif
+
+			current_operation = thumb_decode_table[(current_instruction >> 6) & 0x3FF];
+			addr += 2;
+		}
 
-			default:
-				debug_message = 0x13; debug_code = instruction_pipeline[pipeline_id];
-				if(!config::ignore_illegal_opcodes) { running = false; }
-				break;
+		else
+		{
+			#ifdef GBE_FAST_FETCH
+			current_instruction = mem->read_u32_fast(addr);
+			#else
+			current_instruction = mem->read_u32(addr);
+			#endif
+
+			current_operation = arm_decode_table[((current_instruction >> 16) & 0xFF0) | ((current_instruction >> 4) & 0xF)];
+			addr += 4;
 		}
-	}
 
-	//Execute ARM instruction
-	else if(arm_mode == ARM)
-	{
-		//Conditionally execute ARM instruction
-		if(check_condition(instruction_pipeline[pipeline_id]))
+		block.opcode.push_back(current_instruction);
+		block.operation.push_back(current_operation);
+
+		//End the block on branches, BX, and SWIs
+		bool end_block = false;
+
+		switch(current_operation)
 		{
+			case ARM_3:
+			case ARM_4:
+			case ARM_13:
+			case THUMB_5:
+			case THUMB_16:
+			case THUMB_17:
+			case THUMB_18:
+			case THUMB_19:
+				end_block = true;
+				break;
 
-			switch(instruction_operation[pipeline_id])
-			{
-				case ARM_3:
-					branch_exchange(instruction_pipeline[pipeline_id]);
-					debug_message = 0x14; debug_code = instruction_pipeline[pipeline_id];
-					break;
-
-				case ARM_4:
-					branch_link(instruction_pipeline[pipeline_id]);
-					debug_message = 0x15; debug_code = instruction_pipeline[pipeline_id];
-					break;
-
-				case ARM_5:
-					data_processing(instruction_pipeline[pipeline_id]);
-					debug_message = 0x16; debug_code = instruction_pipeline[pipeline_id];
-					break;
-
-				case ARM_6:
-					psr_transfer(instruction_pipeline[pipeline_id]);
-					debug_message = 0x17; debug_code = instruction_pipeline[pipeline_id];
-					break;
-
-				case ARM_7:
-					multiply(instruction_pipeline[pipeline_id]);
-					debug_message = 0x18; debug_code = instruction_pipeline[pipeline_id];
-					break;
-
-				case ARM_9:
-					single_data_transfer(instruction_pipeline[pipeline_id]);
-					debug_message = 0x19; debug_code = instruction_pipeline[pipeline_id];
-					break;
-
-				case ARM_10:
-					halfword_signed_transfer(instruction_pipeline[pipeline_id]);
-					debug_message = 0x1A; debug_code = instruction_pipeline[pipeline_id];
-					break;
-
-				case ARM_11:
-					block_data_transfer(instruction_pipeline[pipeline_id]);
-					debug_message = 0x1B; debug_code = instruction_pipeline[pipeline_id];
-					break;
-
-				case ARM_12:
-					single_data_swap(instruction_pipeline[pipeline_id]);
-					debug_message = 0x1C; debug_code = instruction_pipeline[pipeline_id];
-					break;
-
-				case ARM_13:
-					software_interrupt_breakpoint(instruction_pipeline[pipeline_id]);
-					debug_message = 0x1D; debug_code = instruction_pipeline[pipeline_id];
-					break;
-
-				default:
-					debug_message = 0x1E; debug_code = instruction_pipeline[pipeline_id];
-					if(!config::ignore_illegal_opcodes) { running = false; }
-					break;
-			}
+			default: break;
 		}
 
-		//Skip ARM instruction
-		else 
-		{ 
-			debug_message = 0x1F; 
-			debug_code = instruction_pipeline[pipeline_id];
+		if(end_block) { break; }
+	}
 
-			//Clock CPU and controllers - 1S
-			clock(reg.r15, false); 
-		}
+	block.end_addr = addr;
+
+	//Track blocks in EWRAM and IWRAM so writes can invalidate them
+	switch(block.start_addr >> 24)
+	{
+		case 0x2: mem->code_cache.page_blocks[(block.start_addr & 0x3FFFF) >> BLOCK_PAGE_SHIFT].push_back(key); break;
+		case 0x3: mem->code_cache.page_blocks[BLOCK_EWRAM_PAGES + ((block.start_addr & 0x7FFF) >> BLOCK_PAGE_SHIFT)].push_back(key); break;
 	}
 
+	return &block;
 }
 
 /****** Flush the pipeline - Called when branching or resetting ******/
@@ -823,140 +934,7 @@ void ARM7::update_pc()
 	reg.r15 += (arm_mode == ARM) ? 4 : 2;
 }
 
-/****** Check conditional code ******/
-bool ARM7::check_condition(u32 current_arm_instruction) const
-{
-	switch(current_arm_instruction >> 28)
-	{
-		//EQ
-		case 0x0:
-			if(reg.cpsr & CPSR_Z_FLAG) { return true; }
-			else { return false; }
-			break;
-
-		//NE
-		case 0x1:
-			if(reg.cpsr & CPSR_Z_FLAG) { return false; }
-			else { return true; }
-			break;
-
-		//CS
-		case 0x2:
-			if(reg.cpsr & CPSR_C_FLAG) { return true; }
-			else { return false; }
-			break;
-
-		//CC
-		case 0x3:
-			if(reg.cpsr & CPSR_C_FLAG) { return false; }
-			else { return true; }
-			break;
-
-		//MI
-		case 0x4:
-			if(reg.cpsr & CPSR_N_FLAG) { return true; }
-			else { return false; }
-			break;
-
-		//PL
-		case 0x5:
-			if(reg.cpsr & CPSR_N_FLAG) { return false; }
-			else { return true; }
-			break;
-
-		//VS
-		case 0x6:
-			if(reg.cpsr & CPSR_V_FLAG) { return true; }
-			else { return false; }
-			break;
-
-		//VC
-		case 0x7:
-			if(reg.cpsr & CPSR_V_FLAG) { return false; }
-			else { return true; }
-			break;
-
-		//HI
-		case 0x8:
-			if((reg.cpsr & CPSR_C_FLAG) && ((reg.cpsr & CPSR_Z_FLAG) == 0)) { return true; }
-			else { return false; }
-			break;
-
-		//LS
-		case 0x9:
-			if((reg.cpsr & CPSR_Z_FLAG) || ((reg.cpsr & CPSR_C_FLAG) == 0)) { return true; }
-			else { return false; }
-			break;
-
-		//GE
-		case 0xA:
-			{
-				u8 n = (reg.cpsr & CPSR_N_FLAG) ? 1 : 0;
-				u8 v = (reg.cpsr & CPSR_V_FLAG) ? 1 : 0;
-
-				if(n == v) { return true; }
-				else { return false; }
-			}
-			break;
-
-		//LT
-		case 0xB:
-			{
-				u8 n = (reg.cpsr & CPSR_N_FLAG) ? 1 : 0;
-				u8 v = (reg.cpsr & CPSR_V_FLAG) ? 1 : 0;
-
-				if(n != v) { return true; }
-				else { return false; }
-			}
-			break;
-
-		//GT
-		case 0xC:
-			{
-				u8 n = (reg.cpsr & CPSR_N_FLAG) ? 1 : 0;
-				u8 v = (reg.cpsr & CPSR_V_FLAG) ? 1 : 0;
-				u8 z = (reg.cpsr & CPSR_Z_FLAG) ? 1 : 0;
-
-				if((z == 0) && (n == v)) { return true; }
-				else { return false; }
-			}
-			break;
-
-		//LE
-		case 0xD:
-			{
-				u8 n = (reg.cpsr & CPSR_N_FLAG) ? 1 : 0;
-				u8 v = (reg.cpsr & CPSR_V_FLAG) ? 1 : 0;
-				u8 z = (reg.cpsr & CPSR_Z_FLAG) ? 1 : 0;
-
-				if((z == 1) || (n != v)) { return true; }
-				else { return false; }
-			}
-			break;
-
-		//AL
-		case 0xE: return true; break;
-
-		//NV
-		default: std::cout<<"CPU::Warning: ARM instruction uses reserved conditional code NV \n"; return true;
-	}
-}
-
-/****** Updates the condition codes in the CPSR register after logical operations ******/
-void ARM7::update_condition_logical(u32 result, u8 shift_out)
-{
-	//Negative flag
-	if(result & 0x80000000) { reg.cpsr |= CPSR_N_FLAG; }
-	else { reg.cpsr &= ~CPSR_N_FLAG; }
-
-	//Zero flag
-	if(result == 0) { reg.cpsr |= CPSR_Z_FLAG; }
-	else { reg.cpsr &= ~CPSR_Z_FLAG; }
 
-	//Carry flag
-	if(shift_out == 1) { reg.cpsr |= CPSR_C_FLAG; }
-	else if(shift_out == 0) { reg.cpsr &= ~CPSR_C_FLAG; }
-}
 
 /****** Updates the condition codes in the CPSR register after arithmetic operations ******/
 void ARM7::update_condition_arithmetic(u32 input, u64 operand, u32 result, bool addition)
@@ -1017,146 +995,10 @@ void ARM7::update_condition_arithmetic(u32 input, u64 operand, u32 result, bool
 	}
 }
 
-/****** Performs 32-bit logical shift left - Returns Carry Out ******/
-u8 ARM7::logical_shift_left(u32& input, u8 offset)
-{
-	u8 carry_out = 0;
-
-	if(offset > 0)
-	{
-		//Test for carry
-		//Perform LSL #(n-1), if Bit 31 is 1, we know it will carry out
-		u32 carry_test = input << (offset - 1);
-		carry_out = (carry_test & 0x80000000) ? 1 : 0;
-
-		if(offset >= 32)
-		{
-			input = 0;
-			carry_out = (offset == 32) ? carry_out : 0;
-		}
-
-		else { input <<= offset; }
-	}
-
-	//LSL #0
-	//No shift performed, carry flag not affected, set it to something not 0 or 1 to check!
-	else { carry_out = 2; }
-
-	return carry_out;
-}
-
-/****** Performs 32-bit logical shift right - Returns Carry Out ******/
-u8 ARM7::logical_shift_right(u32& input, u8 offset)
-{
-	u8 carry_out = 0;
-
-	if(offset > 0)
-	{
-		//Test for carry
-		//Perform LSR #(n-1), if Bit 0 is 1, we know it will carry out
-		u32 carry_test = input >> (offset - 1);
-		carry_out = (carry_test & 0x1) ? 1 : 0;
-
-		if(offset >= 32)
-		{
-			input = 0;
-			carry_out = (offset == 32) ? carry_out : 0;
-		}
 
-		else { input >>= offset; }
-	}
 
-	//LSR #0
-	//Same as LSR #32, input becomes zero, carry flag is Bit 31 of input
-	else
-	{
-		carry_out = (input & 0x80000000) ? 1 : 0;
-		input = 0;
-	}
 
-	return carry_out;
-}
 
-/****** Performs 32-bit arithmetic shift right - Returns Carry Out ******/
-u8 ARM7::arithmetic_shift_right(u32& input, u8 offset)
-{
-	u8 carry_out = 0;
-
-	if(offset > 0)
-	{
-		u8 high_bit = (input & 0x80000000) ? 1 : 0;		
-
-		//Basically LSR, but bits become Bit 31
-		for(int x = 0; x < offset; x++)
-		{
-			carry_out = (input & 0x1) ? 1 : 0;
-			input >>= 1;
-			if(high_bit == 1) { input |= 0x80000000; }
-		}	
-	}
-
-	//ASR #0
-	//Same as ASR #32, input becomes 0xFFFFFFFF or 0x0 depending on Bit 31 of input
-	//Carry flag set to 0 or 1 depending on Bit 31 of input
-	else
-	{
-		if(input & 0x80000000) { input = 0xFFFFFFFF; carry_out = 1; }
-		else { input = 0; carry_out = 0; }
-	}
-
-	return carry_out;
-}
-
-/****** Performs 32-bit rotate right ******/
-u8 ARM7::rotate_right(u32& input, u8 offset)
-{
-	u8 carry_out = 0;
-
-	if(offset > 0)
-	{
-		//Perform ROR shift on immediate
-		for(int x = 0; x < offset; x++)
-		{
-			carry_out = input & 0x1;
-			input >>= 1;
-
-			if(carry_out) { input |= 0x80000000; }
-		}
-	}
-
-	//ROR #0
-	//Same as RRX #1, which is similar to ROR #1, except Bit 31 now becomes the old carry flag
-	else
-	{
-		u8 old_carry = (reg.cpsr & CPSR_C_FLAG) ? 1 : 0;
-		carry_out = input & 0x1;
-		input >>= 1;
-		
-		if(old_carry) { input |= 0x80000000; }
-	}
-
-	return carry_out;
-}
-
-/****** Performs 32-bit rotate right - For ARM.5 Data Processing when Bit 25 is 1 ******/
-u8 ARM7::rotate_right_special(u32& input, u8 offset)
-{
-	u8 carry_out = (reg.cpsr & CPSR_C_FLAG) ? 1 : 0;
-
-	if(offset > 0)
-	{
-		//Perform ROR shift on immediate
-		for(int x = 0; x < (offset * 2); x++)
-		{
-			carry_out = input & 0x1;
-			input >>= 1;
-
-			if(carry_out) { input |= 0x80000000; }
-		}
-	}
-
-	return carry_out;
-}			
 
 /****** Checks address before 32-bit reading/writing for special case scenarios ******/
 void ARM7::mem_check_32(u32 addr, u32& value, bool load_store)
@@ -1490,26 +1332,123 @@ void ARM7::clock(u32 access_addr, bool first_access)
 	}
 
 	system_cycles += access_cycles;
+	clock_controllers(access_cycles, true);
+}
+
+/****** Runs audio and video controllers for 1 cycle ******/
+void ARM7::clock()
+{
+	clock_controllers(1, false);
+	system_cycles++;
+}
+
+/****** Runs audio and video controllers until the next event - Used when the CPU idles ******/
+void ARM7::clock_idle()
+{
+	u32 idle_cycles = next_event(false);
+	u32 timer_cycles = next_timer_overflow();
+	if(timer_cycles < idle_cycles) { idle_cycles = timer_cycles; }
+
+	clock_controllers(idle_cycles, false);
+	system_cycles += idle_cycles;
+}
+
+/****** Skips ahead to the next event when a branch lands in a loop that cannot change anything ******/
+void ARM7::check_idle_loop()
+{
+	u32 current_regs[16] = { reg.r0, reg.r1, reg.r2, reg.r3, reg.r4, reg.r5, reg.r6, reg.r7,
+		reg.r8, reg.r9, reg.r10, reg.r11, reg.r12, reg.r13, reg.r14, reg.cpsr };
+
+	//Same target, same registers, no stores and no timer reads since the last pass
+	//Every further pass would be identical until an event changes memory, so jump straight to it
+	if((reg.r15 == idle_loop.addr) && (mem->write_count == idle_loop.write_count) && (!mem->timer_read)
+	&& (std::memcmp(current_regs, idle_loop.regs, sizeof(current_regs)) == 0))
+	{
+		clock_idle();
+		return;
+	}
+
+	idle_loop.addr = reg.r15;
+	idle_loop.write_count = mem->write_count;
+	std::memcpy(idle_loop.regs, current_regs, sizeof(current_regs));
+	mem->timer_read = false;
+}
 
-	//Run controllers for each cycle		 
-	for(int x = 0; x < access_cycles; x++)
+/****** Returns the number of cycles until any controller besides the timers needs to run ******/
+u32 ARM7::next_event(bool memory_access)
+{
+	//Active DMA channels are checked every cycle
+	if(mem->dma[0].enable || mem->dma[1].enable || mem->dma[2].enable || mem->dma[3].enable) { return 1; }
+
+	//LCD mode and scanline changes
+	u32 event_cycles = controllers.video.cycles_to_event();
+
+	//Play-Yan + NMP sound sample updates
+	if(memory_access && mem->play_yan.is_media_playing && !controllers.audio.apu_stat.ext_audio.use_headphones && (mem->play_yan.cycles < mem->play_yan.cycle_limit))
 	{
-		controllers.video.step();
-		clock_timers();
+		u32 play_yan_cycles = mem->play_yan.cycle_limit - mem->play_yan.cycles;
+		if(play_yan_cycles < event_cycles) { event_cycles = play_yan_cycles; }
+	}
+
+	return event_cycles;
+}
+
+/****** Returns the number of cycles until the next timer overflow ******/
+u32 ARM7::next_timer_overflow()
+{
+	u32 overflow_cycles = 0xFFFFFFFF;
+
+	for(int x = 0; x < 4; x++)
+	{
+		gba_timer& current_timer = controllers.timer[x];
+
+		//Count-up timers are only incremented by the previous timer
+		if((!current_timer.enable) || (current_timer.count_up) || (current_timer.prescalar == 0)) { continue; }
+
+		//Counters are only updated lazily, so account for cycles that have not been applied yet
+		u32 timer_cycles = current_timer.cycles + mem->timer_pending;
+		u32 counter = current_timer.counter + (timer_cycles / current_timer.prescalar);
+		u32 remaining_cycles = ((0x10000 - counter) * current_timer.prescalar) - (timer_cycles % current_timer.prescalar);
+
+		if(remaining_cycles < overflow_cycles) { overflow_cycles = remaining_cycles; }
+	}
+
+	return overflow_cycles;
+}
+
+/****** Runs audio and video controllers for a number of cycles, stopping at each event ******/
+void ARM7::clock_controllers(u32 cycles, bool memory_access)
+{
+	while(cycles)
+	{
+		//Nothing happens between events, so run controllers in a single batch up to the next one
+		u32 run_cycles = next_event(memory_access);
+		u32 timer_cycles = next_timer_overflow();
+
+		if(timer_cycles < run_cycles) { run_cycles = timer_cycles; }
+		if(run_cycles > cycles) { run_cycles = cycles; }
+
+		controllers.video.step(run_cycles);
+
+		//Timers only need to run when one overflows. Otherwise their counters are computed when read
+		mem->timer_pending += run_cycles;
+		if(run_cycles == timer_cycles) { clock_timers(); }
+
 		clock_dma();
-		debug_cycles++;
+		cycles -= run_cycles;
 
-		//Generate audio buffers for PSG channels on VBlank
-		if(controllers.video.lcd_clock == 0)
-		{
-			if(controllers.audio.apu_stat.psg_needs_fill) { controllers.audio.buffer_channels(); }
-			controllers.audio.apu_stat.psg_needs_fill = true;
-		}
+		//Mix audio samples for the cycles that just passed, after any FIFO data for them has arrived
+		controllers.audio.step(run_cycles);
+
+		//Memory access cycles only
+		if(!memory_access) { continue; }
+
+		debug_cycles += run_cycles;
 
 		//Update sound samples for Play-Yan models + NMP when not using headphones
 		if(mem->play_yan.is_media_playing && !controllers.audio.apu_stat.ext_audio.use_headphones)
 		{
-			mem->play_yan.cycles++;
+			mem->play_yan.cycles += run_cycles;
 
 			if(mem->play_yan.cycles == mem->play_yan.cycle_limit)
 			{
@@ -1540,37 +1479,20 @@ void ARM7::clock(u32 access_addr, bool first_access)
 	}
 }
 
-/****** Runs audio and video controllers every clock cycle ******/
-void ARM7::clock()
-{
-	controllers.video.step();
-	clock_timers();
-	clock_dma();
-
-	//Generate audio buffers for PSG channels on VBlank
-	if(controllers.video.lcd_clock == 0)
-	{
-		if(controllers.audio.apu_stat.psg_needs_fill) { controllers.audio.buffer_channels(); }
-		controllers.audio.apu_stat.psg_needs_fill = true;
-	}
-
-	system_cycles++;
-}
-
 /****** Runs DMA controllers every clock cycle ******/
 void ARM7::clock_dma()
 {
 	//DMA0
-	if(mem->dma[0].enable) { dma0(); }
+	if(mem->dma[0].enable) { dma(0); }
 
 	//DMA1
-	if(mem->dma[1].enable) { dma1(); }
+	if(mem->dma[1].enable) { dma(1); }
 
 	//DMA2
-	if(mem->dma[2].enable) { dma2(); }
+	if(mem->dma[2].enable) { dma(2); }
 
 	//DMA3
-	if(mem->dma[3].enable) { dma3(); }
+	if(mem->dma[3].enable) { dma(3); }
 }
 
 /****** Runs Serial IO for some cycles ******/
@@ -1841,67 +1763,53 @@ void ARM7::clock_emulated_sio_device()
 	}
 }
 
-/****** Runs Timer controllers every clock cycle ******/
+/****** Runs Timer controllers - Handles any overflows since the timers were last updated ******/
 void ARM7::clock_timers()
 {
+	u8 overflow = mem->sync_timers();
+
 	for(int x = 0; x < 4; x++)
 	{
-		//See if this timer is enabled first
-		if(controllers.timer[x].enable)
+		//If counter overflows, reload value, trigger interrupt if necessary
+		if(overflow & (1 << x))
 		{
-			controllers.timer[x].cycles++;
+			controllers.timer[x].counter = controllers.timer[x].reload_value;
 
-			//If the amount of cycles matches the prescalar, increment counter
-			if(controllers.timer[x].cycles == controllers.timer[x].prescalar)
+			//Increment next timer if in count-up mode
+			if((x < 3) && (controllers.timer[x+1].count_up)) { controllers.timer[x+1].counter++; }
+
+			//Interrupt
+			if(controllers.timer[x].interrupt)
 			{
-				controllers.timer[x].cycles = 0;
-				if(!controllers.timer[x].count_up)
+				mem->memory_map[REG_IF] |= (8 << x);
+			}
+
+			u8 fifo_a = controllers.audio.apu_stat.dma[0].channel;
+			u8 fifo_b = controllers.audio.apu_stat.dma[1].channel;
+
+			//FIFO A Audio
+			if((x == controllers.audio.apu_stat.dma[0].timer) && (mem->dma[fifo_a].destination_address == FIFO_A) && (mem->dma[fifo_a].started)) 
+			{
+				controllers.audio.apu_stat.dma[0].buffer[controllers.audio.apu_stat.dma[0].counter++] = mem->memory_map[mem->dma[fifo_a].start_address++];
+				controllers.audio.apu_stat.dma[0].length++;
+
+				//Trigger DMA IRQ after 16th bit is transferred
+				if((mem->memory_map[REG_IE+1] & 0x2) && ((controllers.audio.apu_stat.dma[0].counter % 16) == 0))
 				{
-					controllers.timer[x].counter++;
-
-					//If counter overflows, reload value, trigger interrupt if necessary
-					if(controllers.timer[x].counter == 0) 
-					{
-						controllers.timer[x].counter = controllers.timer[x].reload_value;
-
-						//Increment next timer if in count-up mode
-						if((x < 4) && (controllers.timer[x+1].count_up)) { controllers.timer[x+1].counter++; }
-
-						//Interrupt
-						if(controllers.timer[x].interrupt)
-						{
-							mem->memory_map[REG_IF] |= (8 << x);
-						}
-
-						u8 fifo_a = controllers.audio.apu_stat.dma[0].channel;
-						u8 fifo_b = controllers.audio.apu_stat.dma[1].channel;
-
-						//FIFO A Audio
-						if((x == controllers.audio.apu_stat.dma[0].timer) && (mem->dma[fifo_a].destination_address == FIFO_A) && (mem->dma[fifo_a].started)) 
-						{
-							controllers.audio.apu_stat.dma[0].buffer[controllers.audio.apu_stat.dma[0].counter++] = mem->memory_map[mem->dma[fifo_a].start_address++];
-							controllers.audio.apu_stat.dma[0].length++;
-
-							//Trigger DMA IRQ after 16th bit is transferred
-							if((mem->memory_map[REG_IE+1] & 0x2) && ((controllers.audio.apu_stat.dma[0].counter % 16) == 0))
-							{
-								mem->memory_map[REG_IF+1] |= 0x2;
-							}
-						}
-
-						//FIFO B Audio
-						if((x == controllers.audio.apu_stat.dma[1].timer) && (mem->dma[fifo_b].destination_address == FIFO_B) && (mem->dma[fifo_b].started)) 
-						{
-							controllers.audio.apu_stat.dma[1].buffer[controllers.audio.apu_stat.dma[1].counter++] = mem->memory_map[mem->dma[fifo_b].start_address++];
-							controllers.audio.apu_stat.dma[1].length++;
-
-							//Trigger DMA IRQ after 16th bit is transferred
-							if((mem->memory_map[REG_IE+1] & 0x4) && ((controllers.audio.apu_stat.dma[1].counter % 16) == 0))
-							{
-								mem->memory_map[REG_IF+1] |= 0x4;
-							}
-						}
-					}
+					mem->memory_map[REG_IF+1] |= 0x2;
+				}
+			}
+
+			//FIFO B Audio
+			if((x == controllers.audio.apu_stat.dma[1].timer) && (mem->dma[fifo_b].destination_address == FIFO_B) && (mem->dma[fifo_b].started)) 
+			{
+				controllers.audio.apu_stat.dma[1].buffer[controllers.audio.apu_stat.dma[1].counter++] = mem->memory_map[mem->dma[fifo_b].start_address++];
+				controllers.audio.apu_stat.dma[1].length++;
+
+				//Trigger DMA IRQ after 16th bit is transferred
+				if((mem->memory_map[REG_IE+1] & 0x4) && ((controllers.audio.apu_stat.dma[1].counter % 16) == 0))
+				{
+					mem->memory_map[REG_IF+1] |= 0x4;
 				}
 			}
 		}
@@ -2020,123 +1928,75 @@ void ARM7::handle_interrupt()
 }
 
 /****** Read CPU data from save state ******/
-bool ARM7::cpu_read(u32 offset, std::string filename)
+void ARM7::cpu_read(state_reader& state)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
-
-	//Serialize CPU registers data from file stream
-	file.read((char*)&reg, sizeof(reg));
-
-	//Serialize misc CPU data from file stream
-	file.read((char*)&current_cpu_mode, sizeof(current_cpu_mode));
-	file.read((char*)&arm_mode, sizeof(arm_mode));
-	file.read((char*)&bios_read_state, sizeof(bios_read_state));
-	file.read((char*)&running, sizeof(running));
-	file.read((char*)&needs_flush, sizeof(needs_flush));
-	file.read((char*)&needs_reset, sizeof(needs_reset));
-	file.read((char*)&in_interrupt, sizeof(in_interrupt));
-	file.read((char*)&sleep, sizeof(sleep));
-	file.read((char*)&thumb_long_branch, sizeof(thumb_long_branch));
-	file.read((char*)&swi_vblank_wait, sizeof(swi_vblank_wait));
-	file.read((char*)&instruction_pipeline[0], sizeof(instruction_pipeline[0]));
-	file.read((char*)&instruction_pipeline[1], sizeof(instruction_pipeline[1]));
-	file.read((char*)&instruction_pipeline[2], sizeof(instruction_pipeline[2]));
-	file.read((char*)&instruction_operation[0], sizeof(instruction_operation[0]));
-	file.read((char*)&instruction_operation[1], sizeof(instruction_operation[1]));
-	file.read((char*)&instruction_operation[2], sizeof(instruction_operation[2]));
-	file.read((char*)&pipeline_pointer, sizeof(pipeline_pointer));
-	file.read((char*)&debug_message, sizeof(debug_message));
-	file.read((char*)&debug_code, sizeof(debug_code));
-	file.read((char*)&debug_cycles, sizeof(debug_cycles));
+	//Serialize CPU registers data from save state
+	state.read(&reg, sizeof(reg));
+
+	//Serialize misc CPU data from save state
+	state.read(&current_cpu_mode, sizeof(current_cpu_mode));
+	state.read(&arm_mode, sizeof(arm_mode));
+	state.read(&bios_read_state, sizeof(bios_read_state));
+	state.read(&running, sizeof(running));
+	state.read(&needs_flush, sizeof(needs_flush));
+	state.read(&needs_reset, sizeof(needs_reset));
+	state.read(&in_interrupt, sizeof(in_interrupt));
+	state.read(&sleep, sizeof(sleep));
+	state.read(&thumb_long_branch, sizeof(thumb_long_branch));
+	state.read(&swi_vblank_wait, sizeof(swi_vblank_wait));
+	state.read(&instruction_pipeline[0], sizeof(instruction_pipeline[0]));
+	state.read(&instruction_pipeline[1], sizeof(instruction_pipeline[1]));
+	state.read(&instruction_pipeline[2], sizeof(instruction_pipeline[2]));
+	state.read(&instruction_operation[0], sizeof(instruction_operation[0]));
+	state.read(&instruction_operation[1], sizeof(instruction_operation[1]));
+	state.read(&instruction_operation[2], sizeof(instruction_operation[2]));
+	state.read(&pipeline_pointer, sizeof(pipeline_pointer));
+	state.read(&debug_message, sizeof(debug_message));
+	state.read(&debug_code, sizeof(debug_code));
+	state.read(&debug_cycles, sizeof(debug_cycles));
 
 	//Serialize timers from save state
-	file.read((char*)&controllers.timer[0], sizeof(controllers.timer[0]));
-	file.read((char*)&controllers.timer[1], sizeof(controllers.timer[1]));
-	file.read((char*)&controllers.timer[2], sizeof(controllers.timer[2]));
-	file.read((char*)&controllers.timer[3], sizeof(controllers.timer[3]));
-
-	file.close();
-	return true;
+	state.read(&controllers.timer[0], sizeof(controllers.timer[0]));
+	state.read(&controllers.timer[1], sizeof(controllers.timer[1]));
+	state.read(&controllers.timer[2], sizeof(controllers.timer[2]));
+	state.read(&controllers.timer[3], sizeof(controllers.timer[3]));
 }
 
 /****** Write CPU data to save state ******/
-bool ARM7::cpu_write(std::string filename)
+void ARM7::cpu_write(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
+	//Bring timer counters up to date before saving them
+	mem->sync_timers();
 
 	//Serialize CPU registers data to save state
-	file.write((char*)&reg, sizeof(reg));
+	state.write(&reg, sizeof(reg));
 
 	//Serialize misc CPU data to save state
-	file.write((char*)&current_cpu_mode, sizeof(current_cpu_mode));
-	file.write((char*)&arm_mode, sizeof(arm_mode));
-	file.write((char*)&bios_read_state, sizeof(bios_read_state));
-	file.write((char*)&running, sizeof(running));
-	file.write((char*)&needs_flush, sizeof(needs_flush));
-	file.write((char*)&needs_reset, sizeof(needs_reset));
-	file.write((char*)&in_interrupt, sizeof(in_interrupt));
-	file.write((char*)&sleep, sizeof(sleep));
-	file.write((char*)&thumb_long_branch, sizeof(thumb_long_branch));
-	file.write((char*)&swi_vblank_wait, sizeof(swi_vblank_wait));
-	file.write((char*)&instruction_pipeline[0], sizeof(instruction_pipeline[0]));
-	file.write((char*)&instruction_pipeline[1], sizeof(instruction_pipeline[1]));
-	file.write((char*)&instruction_pipeline[2], sizeof(instruction_pipeline[2]));
-	file.write((char*)&instruction_operation[0], sizeof(instruction_operation[0]));
-	file.write((char*)&instruction_operation[1], sizeof(instruction_operation[1]));
-	file.write((char*)&instruction_operation[2], sizeof(instruction_operation[2]));
-	file.write((char*)&pipeline_pointer, sizeof(pipeline_pointer));
-	file.write((char*)&debug_message, sizeof(debug_message));
-	file.write((char*)&debug_code, sizeof(debug_code));
-	file.write((char*)&debug_cycles, sizeof(debug_cycles));
+	state.write(&current_cpu_mode, sizeof(current_cpu_mode));
+	state.write(&arm_mode, sizeof(arm_mode));
+	state.write(&bios_read_state, sizeof(bios_read_state));
+	state.write(&running, sizeof(running));
+	state.write(&needs_flush, sizeof(needs_flush));
+	state.write(&needs_reset, sizeof(needs_reset));
+	state.write(&in_interrupt, sizeof(in_interrupt));
+	state.write(&sleep, sizeof(sleep));
+	state.write(&thumb_long_branch, sizeof(thumb_long_branch));
+	state.write(&swi_vblank_wait, sizeof(swi_vblank_wait));
+	state.write(&instruction_pipeline[0], sizeof(instruction_pipeline[0]));
+	state.write(&instruction_pipeline[1], sizeof(instruction_pipeline[1]));
+	state.write(&instruction_pipeline[2], sizeof(instruction_pipeline[2]));
+	state.write(&instruction_operation[0], sizeof(instruction_operation[0]));
+	state.write(&instruction_operation[1], sizeof(instruction_operation[1]));
+	state.write(&instruction_operation[2], sizeof(instruction_operation[2]));
+	state.write(&pipeline_pointer, sizeof(pipeline_pointer));
+	state.write(&debug_message, sizeof(debug_message));
+	state.write(&debug_code, sizeof(debug_code));
+	state.write(&debug_cycles, sizeof(debug_cycles));
 
 	//Serialize timers to save state
-	file.write((char*)&controllers.timer[0], sizeof(controllers.timer[0]));
-	file.write((char*)&controllers.timer[1], sizeof(controllers.timer[1]));
-	file.write((char*)&controllers.timer[2], sizeof(controllers.timer[2]));
-	file.write((char*)&controllers.timer[3], sizeof(controllers.timer[3]));
-
-	file.close();
-	return true;
+	state.write(&controllers.timer[0], sizeof(controllers.timer[0]));
+	state.write(&controllers.timer[1], sizeof(controllers.timer[1]));
+	state.write(&controllers.timer[2], sizeof(controllers.timer[2]));
+	state.write(&controllers.timer[3], sizeof(controllers.timer[3]));
 }
 
-/****** Gets the size of CPU data for serialization ******/
-u32 ARM7::size()
-{
-	u32 cpu_size = 0;
-
-	cpu_size += sizeof(reg);
-	cpu_size += sizeof(current_cpu_mode);
-	cpu_size += sizeof(arm_mode);
-	cpu_size += sizeof(bios_read_state);
-	cpu_size += sizeof(running);
-	cpu_size += sizeof(needs_flush);
-	cpu_size += sizeof(needs_reset);
-	cpu_size += sizeof(in_interrupt);
-	cpu_size += sizeof(sleep);
-	cpu_size += sizeof(thumb_long_branch);
-	cpu_size += sizeof(swi_vblank_wait);
-	cpu_size += sizeof(instruction_pipeline[0]);
-	cpu_size += sizeof(instruction_pipeline[1]);
-	cpu_size += sizeof(instruction_pipeline[2]);
-	cpu_size += sizeof(instruction_operation[0]);
-	cpu_size += sizeof(instruction_operation[1]);
-	cpu_size += sizeof(instruction_operation[2]);
-	cpu_size += sizeof(pipeline_pointer);
-	cpu_size += sizeof(debug_message);
-	cpu_size += sizeof(debug_code);
-	cpu_size += sizeof(debug_cycles);
-
-	cpu_size += sizeof(controllers.timer[0]);
-	cpu_size += sizeof(controllers.timer[1]);
-	cpu_size += sizeof(controllers.timer[2]);
-	cpu_size += sizeof(controllers.timer[3]);
-
-	return cpu_size;
-}
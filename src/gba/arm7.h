@@ -15,13 +15,16 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <cstring>
 
 #include "common.h"
+#include "common/arm_alu.h"
 #include "timer.h"
 #include "mmu.h"
 #include "lcd.h"
 #include "apu.h"
 #include "sio.h"
+#include "jit.h"
 
 
 class ARM7
@@ -182,6 +185,30 @@ class ARM7
 
 	AGB_MMU* mem;
 
+	//Instruction handlers used for dispatching decoded instructions
+	typedef void (ARM7::*arm_handler)(u32 current_arm_instruction);
+	typedef void (ARM7::*thumb_handler)(u16 current_thumb_instruction);
+
+	//Decoding and dispatch lookup tables - Shared by every CPU instance
+	static arm_instructions arm_decode_table[4096];
+	static arm_instructions thumb_decode_table[1024];
+	static arm_handler arm_handler_table[THUMB_19 + 1];
+	static thumb_handler thumb_handler_table[THUMB_19 + 1];
+	static u8 debug_message_table[THUMB_19 + 1];
+	static bool decode_tables_ready;
+
+	//Idle loop detection - Last branch target with registers r0-r14 and CPSR
+	struct idle_loop_data
+	{
+		bool enable;
+		u32 addr;
+		u32 regs[16];
+		u32 write_count;
+	} idle_loop;
+
+	//Recompiler for hot code blocks
+	AGB_JIT jit;
+
 	//Audio-Video and other controllers
 	struct io_controllers
 	{
@@ -201,6 +228,16 @@ class ARM7
 	void update_pc();
 	void flush_pipeline();
 
+	//Code block cache
+	bool fetch_block();
+	bool block_cacheable(u32 addr);
+	agb_code_block* build_block(u32 addr, bool thumb);
+
+	//Decoding table generation
+	static void build_decode_tables();
+	static arm_instructions classify_arm(u32 current_instruction);
+	static arm_instructions classify_thumb(u16 current_instruction);
+
 	void reset();
 
 	//Get and set ARM registers
@@ -244,6 +281,11 @@ class ARM7
 	//System functions
 	void clock(u32 access_address, bool first_access);
 	void clock();
+	void clock_idle();
+	void check_idle_loop();
+	void clock_controllers(u32 cycles, bool memory_access);
+	u32 next_event(bool memory_access);
+	u32 next_timer_overflow();
 	void clock_timers();
 	void clock_dma();
 	void clock_sio();
@@ -251,20 +293,19 @@ class ARM7
 	void handle_interrupt();
 
 	//DMA functions
-	void dma0();
-	void dma1();
-	void dma2();
-	void dma3();
+	void dma(u8 index);
+	void dma_transfer(u8 index);
+	void dma_block_copy(u8 index, u8 unit);
 
 	//Misc CPU helpers
-	void update_condition_logical(u32 result, u8 shift_out);
+	void update_condition_logical(u32 result, u8 shift_out) { arm_alu<ARM_V4T>::update_condition_logical(reg.cpsr, result, shift_out); }
 	void update_condition_arithmetic(u32 input, u64 operand, u32 result, bool addition);
-	bool check_condition(u32 current_arm_instruction) const;
-	u8 logical_shift_left(u32& input, u8 offset);
-	u8 logical_shift_right(u32& input, u8 offset);
-	u8 arithmetic_shift_right(u32& input, u8 offset);
-	u8 rotate_right(u32& input, u8 offset);
-	u8 rotate_right_special(u32& input, u8 offset);
+	bool check_condition(u32 current_arm_instruction) const { return arm_alu<ARM_V4T>::check_condition(reg.cpsr, current_arm_instruction); }
+	u8 logical_shift_left(u32& input, u8 offset) { return arm_alu<ARM_V4T>::logical_shift_left(input, offset); }
+	u8 logical_shift_right(u32& input, u8 offset) { return arm_alu<ARM_V4T>::logical_shift_right(input, offset); }
+	u8 arithmetic_shift_right(u32& input, u8 offset) { return arm_alu<ARM_V4T>::arithmetic_shift_right(input, offset); }
+	u8 rotate_right(u32& input, u8 offset) { return arm_alu<ARM_V4T>::rotate_right(reg.cpsr, input, offset); }
+	u8 rotate_right_special(u32& input, u8 offset) { return arm_alu<ARM_V4T>::rotate_right_special(reg.cpsr, input, offset); }
 	void mem_check_32(u32 addr, u32& value, bool load_store);
 	void mem_check_16(u32 addr, u32& value, bool load_store);
 	void mem_check_8(u32 addr, u32& value, bool load_store);
@@ -298,9 +339,8 @@ class ARM7
 	void swi_hardreset();
 
 	//Serialize data for save state loading/saving
-	bool cpu_read(u32 offset, std::string filename);
-	bool cpu_write(std::string filename);
-	u32 size();
+	void cpu_read(state_reader& state);
+	void cpu_write(state_writer& state);
 };
 		
 #endif // GBA_CPU
\ No newline at end of file
@@ -0,0 +1,65 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : block_cache.h
+// Date : October 17, 2026
+// Description : GBA code block cache
+//
+// Defines the data structures used to cache pre-decoded runs of ARM7 instructions
+// Used as a header file here because multiple components (CPU, MMU) need access to it
+
+#ifndef GBA_BLOCK_CACHE
+#define GBA_BLOCK_CACHE
+
+#include <vector>
+#include <unordered_map>
+
+#include "common.h"
+
+//Blocks never cross these boundaries, so every block belongs to exactly one page
+#define BLOCK_PAGE_SHIFT 8
+#define BLOCK_MAX_LENGTH 64
+
+//Pages invalidated this many times are treated as self-modifying and no longer cached
+#define BLOCK_MAX_INVALIDATIONS 16
+
+//Pages tracked for invalidation - 256KB EWRAM followed by 32KB IWRAM
+#define BLOCK_EWRAM_PAGES (0x40000 >> BLOCK_PAGE_SHIFT)
+#define BLOCK_IWRAM_PAGES (0x8000 >> BLOCK_PAGE_SHIFT)
+
+struct agb_code_block
+{
+	u32 start_addr;
+	u32 end_addr;
+	bool thumb;
+
+	std::vector<u32> opcode;
+	std::vector<u8> operation;
+
+	//Recompiled host code, times entered before recompiling, and the CPU mode banked registers were resolved for
+	u8* host_code;
+	u32 run_count;
+	u8 host_mode;
+	bool host_banked;
+};
+
+struct agb_block_cache
+{
+	//Blocks keyed by start address, Bit 0 set for THUMB blocks
+	std::unordered_map<u32, agb_code_block> blocks;
+
+	//Keys of blocks living in each EWRAM and IWRAM page
+	std::vector< std::vector<u32> > page_blocks;
+	std::vector<u8> page_invalidations;
+
+	//Block currently being fetched from
+	agb_code_block* current_block;
+
+	//Incremented whenever blocks are dropped, so recompiled code can tell it went stale
+	u32 generation;
+
+	bool enable;
+};
+
+#endif // GBA_BLOCK_CACHE
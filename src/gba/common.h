@@ -244,4 +244,9 @@ const u32 TV_FLASH_CMD0 = 0x8000AAA;
 const u32 TV_FLASH_CMD1 = 0x8000554;
 const u32 TV_FLASH_DATA = 0x8020000;
 
+/* Memory page tables */
+const u32 MEM_PAGE_SHIFT = 15;
+const u32 MEM_PAGE_SIZE = 0x8000;
+const u32 MEM_PAGE_COUNT = 0x2000;
+
 #endif // GBA_COMMON
\ No newline at end of file
@@ -13,8 +13,10 @@
 #include <iomanip>
 #include <ctime>
 #include <sstream>
+#include <cstring>
 
 #include "common/util.h"
+#include "common/link_hub.h"
 
 #include "core.h"
 
@@ -45,6 +47,10 @@ AGB_core::AGB_core()
 	//Link MMU and CPU's timers
 	core_mmu.timer = &core_cpu.controllers.timer;
 
+	rewind_frame = 0;
+	rewind_counter = 0;
+	rewinding = false;
+
 	db_unit.debug_mode = false;
 	db_unit.display_cycles = false;
 	db_unit.print_all = false;
@@ -95,6 +101,12 @@ void AGB_core::start()
 	//Initialize the GamePad
 	core_pad.init();
 	if(core_mmu.gpio.type == AGB_MMU::GPIO_RUMBLE) { core_pad.is_gb_player = false; }
+
+	//Start rewind history over
+	rewind.reset((config::rewind_interval) ? (config::rewind_buffer_size << 20) : 0);
+	rewind_frame = core_cpu.controllers.video.frame_count;
+	rewind_counter = 0;
+	rewinding = false;
 }
 
 /****** Stop the core ******/
@@ -132,17 +144,19 @@ void AGB_core::sleep()
 	//Wait for exit sleep condition (Joypad, Game Pak, or SIO IRQ)
 	bool exit_sleep = false;
 
-	while(core_cpu.sleep)
+	while((core_cpu.sleep) && (running))
 	{
-		SDL_PollEvent(&event);
-
-		if((event.type == SDL_KEYDOWN) || (event.type == SDL_KEYUP) 
-		|| (event.type == SDL_JOYBUTTONDOWN) || (event.type == SDL_JOYBUTTONUP)
-		|| (event.type == SDL_JOYAXISMOTION) || (event.type == SDL_JOYHATMOTION)) { core_pad.handle_input(event); handle_hotkey(event); }
+		//Local link sessions poll SDL on the main thread and feed keys through the render hook in video.update()
+		if((!config::netplay_local) && (SDL_PollEvent(&event)))
+		{
+			if((event.type == SDL_KEYDOWN) || (event.type == SDL_KEYUP) 
+			|| (event.type == SDL_JOYBUTTONDOWN) || (event.type == SDL_JOYBUTTONUP)
+			|| (event.type == SDL_JOYAXISMOTION) || (event.type == SDL_JOYHATMOTION)) { core_pad.handle_input(event); handle_hotkey(event); }
 
-		//Hotplug joypad
-		else if((event.type == SDL_JOYDEVICEADDED) && (!core_pad.joy_init)) { core_pad.init(); }
-		else if((event.type == SDL_JOYDEVICEREMOVED) && (core_pad.joy_init)) { core_pad.close_joystick(); }
+			//Hotplug joypad
+			else if((event.type == SDL_JOYDEVICEADDED) && (!core_pad.joy_init)) { core_pad.init(); }
+			else if((event.type == SDL_JOYDEVICEREMOVED) && (core_pad.joy_init)) { core_pad.close_joystick(); }
+		}
 
 		//Exit on Joypad IRQ
 		if(core_pad.joypad_irq)
@@ -231,33 +245,21 @@ void AGB_core::load_state(u8 slot)
 		state_file = config::rom_file + ".ss" + id;
 	}
 
-	u32 offset = 0;
+	std::vector<u8> state_data;
 
 	//Check if save state is accessible
-	std::ifstream test(state_file.c_str());
-	
-	if(!test.good())
+	if(!read_state_file(state_file, state_data))
 	{
 		config::osd_message = "INVALID SAVE STATE " + util::to_str(slot);
 		config::osd_count = 180;
 		return;
 	}
 
-	if(!get_save_state_info(offset, state_file)) { return; }
-	offset += sizeof(AGB_SAVE_STATE_VERSION);
-	offset += sizeof(config::gb_type);
-	offset += 32;
-
-	if(!core_cpu.cpu_read(offset, state_file)) { return; }
-	offset += core_cpu.size();
-
-	if(!core_mmu.mmu_read(offset, state_file)) { return; }
-	offset += core_mmu.size();
-
-	if(!core_cpu.controllers.audio.apu_read(offset, state_file)) { return; }
-	offset += core_cpu.controllers.audio.size();
-
-	if(!core_cpu.controllers.video.lcd_read(offset, state_file)) { return; }
+	if(!deserialize_state(&state_data[0], state_data.size()))
+	{
+		std::cout<<"GBE::Error - Could not load save state " << state_file << "\n";
+		return;
+	}
 
 	std::cout<<"GBE::Loaded state " << state_file << "\n";
 
@@ -284,11 +286,11 @@ void AGB_core::save_state(u8 slot)
 		state_file = config::rom_file + ".ss" + id;
 	}
 
-	if(!set_save_state_info(state_file)) { return; }
-	if(!core_cpu.cpu_write(state_file)) { return; }
-	if(!core_mmu.mmu_write(state_file)) { return; }
-	if(!core_cpu.controllers.audio.apu_write(state_file)) { return; }
-	if(!core_cpu.controllers.video.lcd_write(state_file)) { return; }
+	//Serialize the whole state in memory, then write it out at once
+	std::vector<u8> state_data(get_state_size());
+
+	if(!serialize_state(&state_data[0], state_data.size())) { return; }
+	if(!write_state_file(state_file, state_data)) { return; }
 
 	std::cout<<"GBE::Saved state " << state_file << "\n";
 
@@ -297,31 +299,103 @@ void AGB_core::save_state(u8 slot)
 	config::osd_count = 180;
 }
 
-/****** Gets the save state info (Version + System Type)******/
-bool AGB_core::get_save_state_info(u32 offset, std::string filename)
+/****** Gets the number of bytes needed to serialize the core ******/
+u32 AGB_core::get_state_size() { return serialize_state(NULL, 0); }
+
+/****** Serializes the core into a buffer - Returns the bytes written, or 0 if the buffer is too small ******/
+u32 AGB_core::serialize_state(u8* buffer, u32 length)
+{
+	state_writer state(buffer, length);
+
+	set_save_state_info(state);
+
+	state.begin_chunk(STATE_CHUNK_CPU, AGB_SAVE_STATE_VERSION);
+	core_cpu.cpu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_MMU, AGB_SAVE_STATE_VERSION);
+	core_mmu.mmu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_APU, AGB_SAVE_STATE_VERSION);
+	core_cpu.controllers.audio.apu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_LCD, AGB_SAVE_STATE_VERSION);
+	core_cpu.controllers.video.lcd_write(state);
+	state.end_chunk();
+
+	return (state.good()) ? state.size() : 0;
+}
+
+/****** Restores the core from a buffer filled by serialize_state() - The core is left untouched if the buffer is rejected ******/
+bool AGB_core::deserialize_state(const u8* buffer, u32 length)
+{
+	state_reader state(buffer, length);
+
+	if(!get_save_state_info(state)) { return false; }
+
+	//Make sure every chunk is present before changing anything
+	if(!state.has_chunk(STATE_CHUNK_CPU, AGB_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_MMU, AGB_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_APU, AGB_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_LCD, AGB_SAVE_STATE_VERSION)) { return false; }
+
+	return restore_state(buffer, length, [this](u8* data, u32 size) { return serialize_state(data, size); }, [this](const u8* data, u32 size) { return read_state_chunks(data, size); });
+}
+
+/****** Reads every chunk of a state into the core - Only use directly on buffers this core serialized itself ******/
+bool AGB_core::read_state_chunks(const u8* buffer, u32 length)
+{
+	state_reader state(buffer, length);
+
+	if(!get_save_state_info(state)) { return false; }
+
+	state.open_chunk(STATE_CHUNK_CPU, AGB_SAVE_STATE_VERSION);
+	core_cpu.cpu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_MMU, AGB_SAVE_STATE_VERSION);
+	core_mmu.mmu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_APU, AGB_SAVE_STATE_VERSION);
+	core_cpu.controllers.audio.apu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_LCD, AGB_SAVE_STATE_VERSION);
+	core_cpu.controllers.video.lcd_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	return true;
+}
+
+/****** Gets the save state info (Version + System Type) ******/
+bool AGB_core::get_save_state_info(state_reader& state)
 {
 	u32 version = 0;
 	u8 system_type = 0;
 	u8 state_date[32];
 
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	if(!file.is_open()) { return false; }
+	state.read(&version, sizeof(version));
+	state.read(&system_type, sizeof(system_type));
+	state.read(&state_date[0], 32);
 
-	file.seekg(offset);
-	file.read((char*)&version, sizeof(version));
-	file.read((char*)&system_type, sizeof(system_type));
-	file.read((char*)&state_date[0], 32);
-	file.close();
+	if(!state.good())
+	{
+		std::cout<<"GBE::Error - Save State is too small. Cannot load save.\n";
+		return false;
+	}
 
 	if(system_type != config::gb_type)
 	{
-		std::cout<<"GBE::Error - Save State " <<  filename << " has incorrect system type. Cannot load save.\n";
+		std::cout<<"GBE::Error - Save State has incorrect system type. Cannot load save.\n";
 		return false;
 	}
 
 	if(version != AGB_SAVE_STATE_VERSION)
 	{
-		std::cout<<"GBE::Error - Save State " <<  filename << " has outdated version number. Cannot load save.\n";
+		std::cout<<"GBE::Error - Save State has outdated version number. Cannot load save.\n";
 		return false;
 	}
 
@@ -329,11 +403,8 @@ bool AGB_core::get_save_state_info(u32 offset, std::string filename)
 }
 
 /****** Sets the save state info (Version + System Type) ******/
-bool AGB_core::set_save_state_info(std::string filename)
+void AGB_core::set_save_state_info(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
-	if(!file.is_open()) { return false; }
-
 	//Add current date metadata - Fixed size of 32 bytes
 	u8 state_date[32];
 	std::string date = util::get_long_date(true);
@@ -348,12 +419,128 @@ bool AGB_core::set_save_state_info(std::string filename)
 		}
 	}
 
-	file.write((char*)&AGB_SAVE_STATE_VERSION, sizeof(AGB_SAVE_STATE_VERSION));
-	file.write((char*)&config::gb_type, sizeof(config::gb_type));
-	file.write((char*)&state_date[0], 32);
-	file.close();
+	state.write(&AGB_SAVE_STATE_VERSION, sizeof(AGB_SAVE_STATE_VERSION));
+	state.write(&config::gb_type, sizeof(config::gb_type));
+	state.write(&state_date[0], 32);
+}
 
-	return true;
+/****** Takes rewind snapshots, or steps back through them while rewinding - Called once per frame ******/
+void AGB_core::update_rewind()
+{
+	rewind_frame = core_cpu.controllers.video.frame_count;
+
+	if(!config::rewind_interval) { return; }
+
+	//Rewinding a linked core would desync it from the other side, so no history is kept while connected
+	if(core_cpu.controllers.serial_io.sio_stat.connected)
+	{
+		if(rewind.count()) { rewind.reset(config::rewind_buffer_size << 20); }
+		rewind_counter = 0;
+		return;
+	}
+
+	//Load the newest snapshot each frame, history steps back by one every time
+	if(rewinding)
+	{
+		if(rewind.pop(rewind_state)) { read_state_chunks(&rewind_state[0], rewind_state.size()); }
+		rewind_counter = 0;
+	}
+
+	else if(++rewind_counter >= config::rewind_interval)
+	{
+		rewind_counter = 0;
+		rewind_state.resize(get_state_size());
+
+		if(serialize_state(&rewind_state[0], rewind_state.size())) { rewind.push(rewind_state); }
+	}
+}
+
+/****** Shows a frame from the future, then rolls back to the committed one - Called once per frame ******/
+void AGB_core::update_run_ahead()
+{
+	AGB_LCD& video = core_cpu.controllers.video;
+
+	//Frames from netplay cannot be rolled back, rewinding shows each snapshot as is
+	if((!config::run_ahead) || (rewinding) || (db_unit.debug_mode) || (core_cpu.controllers.serial_io.sio_stat.connected))
+	{
+		video.frame_skip.set_hidden(false);
+		return;
+	}
+
+	run_ahead_state.resize(get_state_size());
+
+	if(!serialize_state(&run_ahead_state[0], run_ahead_state.size()))
+	{
+		video.frame_skip.set_hidden(false);
+		return;
+	}
+
+	//Future frames make no sound, only the last one is shown
+	core_cpu.controllers.audio.mute_output = true;
+
+	for(u32 x = 1; x <= config::run_ahead; x++)
+	{
+		video.frame_skip.set_hidden(x != config::run_ahead);
+		video.frame_skip.set_paced(false);
+		u32 frame = video.frame_count;
+
+		//Give up on frames the LCD never finishes
+		for(u32 y = 0; (core_cpu.running) && (video.frame_count == frame) && (y < 0x200000); y++)
+		{
+			core_cpu.system_cycles = 0;
+			step();
+		}
+	}
+
+	read_state_chunks(&run_ahead_state[0], run_ahead_state.size());
+	core_cpu.controllers.audio.mute_output = false;
+
+	//The committed frame is emulated next, but never shown - It waits on the frame limiter instead, outside of any audio lock
+	video.frame_skip.set_hidden(true);
+	video.frame_skip.set_paced(true);
+}
+
+/****** Keeps link cable netplay in step with rollback - Called once per frame ******/
+void AGB_core::update_link_rollback()
+{
+	if((!config::netplay_rollback) || (!core_cpu.controllers.serial_io.sio_stat.connected)) { return; }
+
+	core_cpu.controllers.serial_io.rollback.update(*this, 0x200000);
+}
+
+/****** Rollback hooks - Joypad state kept with each frame ******/
+u32 AGB_core::get_link_input() { return core_pad.key_input; }
+void AGB_core::set_link_input(u32 input) { core_pad.key_input = (input & 0xFFFF); }
+void AGB_core::restore_link_input(u32 live_input) { set_link_input(live_input); }
+
+/****** Rollback hooks - Runs one instruction while resimulating ******/
+void AGB_core::step_link()
+{
+	core_cpu.clock_sio();
+	core_cpu.system_cycles = 0;
+	step();
+}
+
+/****** Rollback hooks - Resimulated frames make no sound ******/
+void AGB_core::mute_link_audio(bool mute) { core_cpu.controllers.audio.mute_output = mute; }
+
+/****** Rollback hooks - Cycles carried over between frames ******/
+u32& AGB_core::link_cycles() { return core_cpu.system_cycles; }
+
+/****** Rollback hooks - Applies recorded input and transfers during a resimulation ******/
+void AGB_core::apply_link_event(u8 type, u32 data)
+{
+	switch(type)
+	{
+		case LINK_EVENT_INPUT:
+			core_pad.key_input = (data & 0xFFFF);
+			if(data & 0x10000) { core_mmu.memory_map[REG_IF + 1] |= 0x10; }
+			break;
+
+		case LINK_EVENT_TRANSFER:
+			core_cpu.controllers.serial_io.multiplay_receive(data);
+			break;
+	}
 }
 
 /****** Run the core in a loop until exit ******/
@@ -362,8 +549,8 @@ void AGB_core::run_core()
 	//Begin running the core
 	while(running)
 	{
-		//Handle SDL Events
-		if((core_cpu.controllers.video.current_scanline == 160) && SDL_PollEvent(&event))
+		//Handle SDL Events - Local link sessions handle them on the main thread instead
+		if((core_cpu.controllers.video.current_scanline == 160) && (!config::netplay_local) && SDL_PollEvent(&event))
 		{
 			//X out of a window
 			if(event.type == SDL_QUIT) { stop(); SDL_Quit(); }
@@ -379,6 +566,9 @@ void AGB_core::run_core()
 
 				//Trigger Joypad Interrupt if necessary
 				if(core_pad.joypad_irq) { core_mmu.memory_map[REG_IF + 1] |= 0x10; }
+
+				//Keep a record so rollback can apply this input again while resimulating
+				core_cpu.controllers.serial_io.rollback.log_event(LINK_EVENT_INPUT, (core_pad.joypad_irq) ? (core_pad.key_input | 0x10000) : core_pad.key_input);
 			}
 
 			//Hotplug joypad
@@ -386,6 +576,15 @@ void AGB_core::run_core()
 			else if((event.type == SDL_JOYDEVICEREMOVED) && (core_pad.joy_init)) { core_pad.close_joystick(); }
 		}
 
+		//Once per frame, take rewind snapshots or step backwards, then run ahead
+		if(core_cpu.controllers.video.frame_count != rewind_frame)
+		{
+			update_rewind();
+			update_run_ahead();
+			update_link_rollback();
+			rewind_frame = core_cpu.controllers.video.frame_count;
+		}
+
 		//Run the CPU
 		if(core_cpu.running)
 		{	
@@ -434,19 +633,43 @@ void AGB_core::run_core()
 				}
 			}
 
+			//Local link sessions run every core in fixed cycle quanta
+			#ifdef GBE_NETPLAY
+			if(config::netplay_local) { link_hub::step_lockstep(core_cpu.system_cycles); }
+			#endif
+
 			//Reset system cycles for next instruction
 			core_cpu.system_cycles = 0;
 
 			if(db_unit.debug_mode) { debug_step(); }
 
-			core_cpu.fetch();
-			core_cpu.decode();
-			core_cpu.execute();
+			//The CLI debugger always steps through the plain interpreter
+			core_mmu.code_cache.enable = (config::use_block_cache && !db_unit.debug_mode);
+
+			//Serial transfers are not scheduled as events, so never skip past them
+			core_cpu.idle_loop.enable = (config::skip_idle_loops && !db_unit.debug_mode && !core_cpu.controllers.serial_io.sio_stat.connected
+			&& !core_cpu.controllers.serial_io.sio_stat.emu_device_ready);
+
+			//Recompiled blocks batch controller updates, so anything clocked per instruction above keeps the interpreter
+			core_cpu.jit.enable = (config::use_jit && core_mmu.code_cache.enable && !config::netplay_local
+			&& !core_cpu.controllers.serial_io.sio_stat.connected && !core_cpu.controllers.serial_io.sio_stat.emu_device_ready
+			&& !core_mmu.am3.transfer_delay && (config::cart_type != AGB_PLAY_YAN));
+
+			if(!core_cpu.jit.run_block(core_cpu))
+			{
+				core_cpu.fetch();
+				core_cpu.decode();
+				core_cpu.execute();
+			}
 
 			core_cpu.handle_interrupt();
 		
-			//Flush pipeline if necessary
-			if(core_cpu.needs_flush) { core_cpu.flush_pipeline(); }
+			//Flush pipeline if necessary, then check if the branch landed in an idle loop
+			if(core_cpu.needs_flush)
+			{
+				core_cpu.flush_pipeline();
+				if(core_cpu.idle_loop.enable) { core_cpu.check_idle_loop(); }
+			}
 
 			//Else update the pipeline and PC
 			else 
@@ -456,6 +679,7 @@ void AGB_core::run_core()
 			}
 
 			core_cpu.thumb_long_branch = false;
+			core_cpu.controllers.serial_io.rollback.frame_step++;
 		}
 
 		//Stop emulation
@@ -668,7 +892,8 @@ void AGB_core::handle_hotkey(SDL_Event& event)
 	}
 
 	//Pause emulation
-	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_PAUSE))
+	//Local link sessions never pause a single core, that would poll SDL off the main thread
+	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_PAUSE) && (!config::netplay_local))
 	{
 		config::pause_emu = true;
 		SDL_PauseAudio(1);
@@ -706,6 +931,10 @@ void AGB_core::handle_hotkey(SDL_Event& event)
 		config::turbo = false;
 		if((config::sdl_render) && (config::use_opengl)) { SDL_GL_SetSwapInterval(1); }
 	}
+
+	//Step backwards while the rewind hotkey is held
+	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == config::hotkey_rewind)) { rewinding = true; }
+	else if((event.type == SDL_KEYUP) && (event.key.keysym.sym == config::hotkey_rewind)) { rewinding = false; }
 		
 	//Reset emulation on F8
 	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_F8)) { reset(); }
@@ -739,6 +968,9 @@ void AGB_core::handle_hotkey(int input, bool pressed)
 	//Toggle turbo off
 	else if((input == config::hotkey_turbo) && (!pressed)) { config::turbo = false; }
 
+	//Step backwards while the rewind hotkey is held
+	else if(input == config::hotkey_rewind) { rewinding = pressed; }
+
 	//Initiate various communication functions
 	//Soul Doll Adapter - Reset Soul Doll
 	else if((input == SDLK_F3) && (pressed))
@@ -756,8 +988,8 @@ void AGB_core::handle_hotkey(int input, bool pressed)
 				break;
 		}
 
-		//Close any open sub screen
-		if(config::resize_mode == 1)
+		//Close any open sub screen - Local link sessions share one window and never open one
+		if((config::resize_mode == 1) && (!config::netplay_local))
 		{
 			config::request_resize = true;
 			config::resize_mode = 0;
@@ -923,6 +1155,9 @@ void AGB_core::start_netplay()
 
 		//Process network connections
 		core_cpu.controllers.serial_io.process_network_communication();
+
+		//Check again if the GBE+ instances connected
+		if(core_cpu.controllers.serial_io.sio_stat.connected) { break; }
 	}
 
 	if(!core_cpu.controllers.serial_io.sio_stat.connected) { std::cout<<"SIO::No netplay connection established\n"; }
@@ -955,6 +1190,13 @@ void AGB_core::hard_sync()
 
 		while(core_cpu.controllers.serial_io.sio_stat.sync)
 		{
+			//Stop waiting at once if this core is stopping or the other side hung up
+			if((!running) || (core_cpu.controllers.serial_io.link_lost()))
+			{
+				core_cpu.controllers.serial_io.reset();
+				break;
+			}
+
 			core_cpu.controllers.serial_io.receive_byte();
 
 			//Timeout if 10 seconds passes
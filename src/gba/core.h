@@ -16,6 +16,7 @@
 #define GBA_CORE
 
 #include "common/core_emu.h"
+#include "common/rewind.h"
 #include "mmu.h"
 #include "arm7.h"
 
@@ -38,9 +39,25 @@ class AGB_core : virtual public core_emu
 		void feed_key_input(int sdl_key, bool pressed);
 		void save_state(u8 slot);
 		void load_state(u8 slot);
-		bool get_save_state_info(u32 offset, std::string filename);
-		bool set_save_state_info(std::string filename);
+		bool get_save_state_info(state_reader& state);
+		void set_save_state_info(state_writer& state);
+		u32 get_state_size();
+		u32 serialize_state(u8* buffer, u32 length);
+		bool deserialize_state(const u8* buffer, u32 length);
+		bool read_state_chunks(const u8* buffer, u32 length);
 		void run_core();
+		void update_rewind();
+		void update_run_ahead();
+		void update_link_rollback();
+
+		//Hooks for link_rollback
+		u32 get_link_input();
+		void set_link_input(u32 input);
+		void restore_link_input(u32 live_input);
+		void apply_link_event(u8 type, u32 data);
+		void step_link();
+		void mute_link_audio(bool mute);
+		u32& link_cycles();
 		void buffer_audio_data();
 
 		//Core debugging
@@ -71,6 +88,16 @@ class AGB_core : virtual public core_emu
 		AGB_MMU core_mmu;
 		ARM7 core_cpu;
 		AGB_GamePad core_pad;
+
+		//Rewind history
+		rewind_buffer rewind;
+		std::vector<u8> rewind_state;
+		u32 rewind_frame;
+		u32 rewind_counter;
+		bool rewinding;
+
+		//Snapshot of the committed frame while running ahead
+		std::vector<u8> run_ahead_state;
 };
 		
 #endif // GBA_CORE
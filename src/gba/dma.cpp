@@ -13,573 +13,25 @@
 
 //TODO - HDMAs basically act like immediate DMAs during HBlank. In reality, if they are take longer than the HBlank period they should stop, then resume from the last position.
 
-/****** Performs DMA0 transfers ******/
-void ARM7::dma0()
+/****** Performs DMA0 through DMA3 transfers ******/
+void ARM7::dma(u8 index)
 {
 	//Wait 2 cycles after DMA is triggered before actual transfer
-	if(mem->dma[0].delay != 0) { mem->dma[0].delay--; }
+	if(mem->dma[index].delay != 0) { mem->dma[index].delay--; return; }
 
-	//See if DMA Start Timing conditions dictate a transfer
-	else
-	{
-		mem->dma[0].word_count = mem->read_u16_fast(DMA0CNT_L);
-		mem->dma[0].word_type = (mem->read_u16_fast(DMA0CNT_H) & 0x400) ? 1 : 0;
-
-		u32 temp_value = 0;
-
-		if((mem->dma[0].control & 0x8000) == 0) { mem->dma[0].enable = false; return; }
-
-		//Check DMA Start Timings
-		switch(((mem->dma[0].control >> 12) & 0x3))
-		{
-			//Immediate
-			case 0x0:
-				//Set word count of transfer to max (0x4000) if specified as zero
-				if(mem->dma[0].word_count == 0) { mem->dma[0].word_count = 0x4000; }
-
-				//16-bit transfer
-				if(mem->dma[0].word_type == 0)
-				{
-					//Align addresses to half-word
-					mem->dma[0].start_address &= ~0x1;
-					mem->dma[0].destination_address	&= ~0x1;
-
-					while(mem->dma[0].word_count != 0)
-					{
-						temp_value = mem->read_u16(mem->dma[0].start_address);
-						mem->write_u16(mem->dma[0].destination_address, temp_value);
-
-						//Update DMA0 Start Address
-						if(mem->dma[0].src_addr_ctrl == 0) { mem->dma[0].start_address += 2; }
-						else if(mem->dma[0].src_addr_ctrl == 1) { mem->dma[0].start_address -= 2; }
-						else if(mem->dma[0].src_addr_ctrl == 3) { mem->dma[0].start_address += 2; }
-
-						//Update DMA0 Destination Address
-						if(mem->dma[0].dest_addr_ctrl == 0) { mem->dma[0].destination_address += 2; }
-						else if(mem->dma[0].dest_addr_ctrl == 1) { mem->dma[0].destination_address -= 2; }
-						else if(mem->dma[0].dest_addr_ctrl == 3) { mem->dma[0].destination_address += 2; }
-
-						mem->dma[0].word_count--;
-					}
-				}
-
-				//32-bit transfer
-				else
-				{
-					//Align addresses to word
-					mem->dma[0].start_address &= ~0x3;
-					mem->dma[0].destination_address	&= ~0x3;
-
-					while(mem->dma[0].word_count != 0)
-					{
-						temp_value = mem->read_u32(mem->dma[0].start_address);
-						mem->write_u32(mem->dma[0].destination_address, temp_value);
-
-						//Update DMA0 Start Address
-						if(mem->dma[0].src_addr_ctrl == 0) { mem->dma[0].start_address += 4; }
-						else if(mem->dma[0].src_addr_ctrl == 1) { mem->dma[0].start_address -= 4; }
-						else if(mem->dma[0].src_addr_ctrl == 3) { mem->dma[0].start_address += 4; }
-
-						//Update DMA0 Destination Address
-						if(mem->dma[0].dest_addr_ctrl == 0) { mem->dma[0].destination_address += 4; }
-						else if(mem->dma[0].dest_addr_ctrl == 1) { mem->dma[0].destination_address -= 4; }
-						else if(mem->dma[0].dest_addr_ctrl == 3) { mem->dma[0].destination_address += 4; }
-
-						mem->dma[0].word_count--;
-					}
-				}
-
-				//Reload if control flags are set to 0x3
-				if(mem->dma[0].dest_addr_ctrl == 3) { mem->dma[0].destination_address = mem->dma[0].original_destination_address; };
-
-				mem->dma[0].control &= ~0x8000;
-				mem->write_u16_fast(DMA0CNT_H, mem->dma[0].control);
-
-				//Raise DMA0 IRQ if necessary
-				if(mem->dma[0].control & 0x4000) { mem->memory_map[REG_IF+1] |= 0x1; }
-
-				mem->dma[0].enable = false;
-				break;
-
-			//VBlank
-			case 0x1:
-				std::cout<<"VBlank DMA0!\n";
-				mem->dma[0].enable = false;
-				break;
-
-			//HBlank
-			case 0x2:
-				if(mem->dma[0].started)
-				{
-					//Set word count of transfer to max (0x4000) if specified as zero
-					if(mem->dma[0].word_count == 0) { mem->dma[0].word_count = 0x4000; }
-
-					//16-bit transfer
-					if(mem->dma[0].word_type == 0)
-					{
-						//Align addresses to half-word
-						mem->dma[0].start_address &= ~0x1;
-						mem->dma[0].destination_address	&= ~0x1;
-
-						while(mem->dma[0].word_count != 0)
-						{
-							temp_value = mem->read_u16(mem->dma[0].start_address);
-							mem->write_u16(mem->dma[0].destination_address, temp_value);
-
-							//Update DMA0 Start Address
-							if(mem->dma[0].src_addr_ctrl == 0) { mem->dma[0].start_address += 2; }
-							else if(mem->dma[0].src_addr_ctrl == 1) { mem->dma[0].start_address -= 2; }
-							else if(mem->dma[0].src_addr_ctrl == 3) { mem->dma[0].start_address += 2; }
-
-							//Update DMA0 Destination Address
-							if(mem->dma[0].dest_addr_ctrl == 0) { mem->dma[0].destination_address += 2; }
-							else if(mem->dma[0].dest_addr_ctrl == 1) { mem->dma[0].destination_address -= 2; }
-							else if(mem->dma[0].dest_addr_ctrl == 3) { mem->dma[0].destination_address += 2; }
-
-							mem->dma[0].word_count--;
-						}
-					}
-
-					//32-bit transfer
-					else
-					{
-						//Align addresses to word
-						mem->dma[0].start_address &= ~0x3;
-						mem->dma[0].destination_address	&= ~0x3;
-
-						while(mem->dma[0].word_count != 0)
-						{
-							temp_value = mem->read_u32(mem->dma[0].start_address);
-							mem->write_u32(mem->dma[0].destination_address, temp_value);
-
-							//Update DMA0 Start Address
-							if(mem->dma[0].src_addr_ctrl == 0) { mem->dma[0].start_address += 4; }
-							else if(mem->dma[0].src_addr_ctrl == 1) { mem->dma[0].start_address -= 4; }
-							else if(mem->dma[0].src_addr_ctrl == 3) { mem->dma[0].start_address += 4; }
-
-							//Update DMA0 Destination Address
-							if(mem->dma[0].dest_addr_ctrl == 0) { mem->dma[0].destination_address += 4; }
-							else if(mem->dma[0].dest_addr_ctrl == 1) { mem->dma[0].destination_address -= 4; }
-							else if(mem->dma[0].dest_addr_ctrl == 3) { mem->dma[0].destination_address += 4; }
-
-							mem->dma[0].word_count--;
-						}
-					}
-
-					//Reload if control flags are set to 0x3
-					if(mem->dma[0].dest_addr_ctrl == 3) { mem->dma[0].destination_address = mem->dma[0].original_destination_address; };
-
-					//Reset enable bit if HBlank DMA is non-repeating
-					if((mem->dma[0].control & 0x200) == 0)
-					{
-						mem->dma[0].control &= ~0x8000;
-						mem->write_u16_fast(DMA0CNT_H, mem->dma[0].control);
-					}
-
-					//Raise DMA0 IRQ if necessary
-					if(mem->dma[0].control & 0x4000) { mem->memory_map[REG_IF+1] |= 0x1; }
-
-					mem->dma[0].enable = false;
-					mem->dma[0].started = false;
-				}
-
-				break;
-
-			//Special
-			case 0x3:
-				std::cout<<"Special DMA0!\n";
-				mem->dma[0].enable = false;
-				break;
-		}
-	}
-}
-
-/****** Performs DMA1 transfers ******/
-void ARM7::dma1()
-{
-	//Wait 2 cycles after DMA is triggered before actual transfer
-	if(mem->dma[1].delay != 0) { mem->dma[1].delay--; }
-
-	//See if DMA Start Timing conditions dictate a transfer
-	else
-	{
-		mem->dma[1].word_count = mem->read_u16_fast(DMA1CNT_L);
-		mem->dma[1].word_type = (mem->read_u16_fast(DMA1CNT_H) & 0x400) ? 1 : 0;
-
-		u32 temp_value = 0;
-
-		if((mem->dma[1].control & 0x8000) == 0) { mem->dma[1].enable = false; return; }
-
-		//Check DMA Start Timings
-		switch(((mem->dma[1].control >> 12) & 0x3))
-		{
-			//Immediate
-			case 0x0:
-				//Set word count of transfer to max (0x4000) if specified as zero
-				if(mem->dma[1].word_count == 0) { mem->dma[1].word_count = 0x4000; }
-
-				//16-bit transfer
-				if(mem->dma[1].word_type == 0)
-				{
-					//Align addresses to half-word
-					mem->dma[1].start_address &= ~0x1;
-					mem->dma[1].destination_address	&= ~0x1;
-
-					while(mem->dma[1].word_count != 0)
-					{
-						temp_value = mem->read_u16(mem->dma[1].start_address);
-						mem->write_u16(mem->dma[1].destination_address, temp_value);
-
-						//Update DMA1 Start Address
-						if(mem->dma[1].src_addr_ctrl == 0) { mem->dma[1].start_address += 2; }
-						else if(mem->dma[1].src_addr_ctrl == 1) { mem->dma[1].start_address -= 2; }
-						else if(mem->dma[1].src_addr_ctrl == 3) { mem->dma[1].start_address += 2; }
-
-						//Update DMA1 Destination Address
-						if(mem->dma[1].dest_addr_ctrl == 0) { mem->dma[1].destination_address += 2; }
-						else if(mem->dma[1].dest_addr_ctrl == 1) { mem->dma[1].destination_address -= 2; }
-						else if(mem->dma[1].dest_addr_ctrl == 3) { mem->dma[1].destination_address += 2; }
-
-						mem->dma[1].word_count--;
-					}
-				}
-
-				//32-bit transfer
-				else
-				{
-					//Align addresses to word
-					mem->dma[1].start_address &= ~0x3;
-					mem->dma[1].destination_address	&= ~0x3;
-
-					while(mem->dma[1].word_count != 0)
-					{
-						temp_value = mem->read_u32(mem->dma[1].start_address);
-						mem->write_u32(mem->dma[1].destination_address, temp_value);
-
-						//Update DMA1 Start Address
-						if(mem->dma[1].src_addr_ctrl == 0) { mem->dma[1].start_address += 4; }
-						else if(mem->dma[1].src_addr_ctrl == 1) { mem->dma[1].start_address -= 4; }
-						else if(mem->dma[1].src_addr_ctrl == 3) { mem->dma[1].start_address += 4; }
-
-						//Update DMA1 Destination Address
-						if(mem->dma[1].dest_addr_ctrl == 0) { mem->dma[1].destination_address += 4; }
-						else if(mem->dma[1].dest_addr_ctrl == 1) { mem->dma[1].destination_address -= 4; }
-						else if(mem->dma[1].dest_addr_ctrl == 3) { mem->dma[1].destination_address += 4; }
-
-						mem->dma[1].word_count--;
-					}
-				}
-
-				//Reload if control flags are set to 0x3
-				if(mem->dma[1].dest_addr_ctrl == 3) { mem->dma[1].destination_address = mem->dma[1].original_destination_address; };
-
-				mem->dma[1].control &= ~0x8000;
-				mem->write_u16_fast(DMA1CNT_H, mem->dma[1].control);
-
-				//Raise DMA1 IRQ if necessary
-				if(mem->dma[1].control & 0x4000) { mem->memory_map[REG_IF+1] |= 0x2; }
-
-				mem->dma[1].enable = false;
-				break;
-
-			//VBlank
-			case 0x1:
-				std::cout<<"VBlank DMA1!\n";
-				mem->dma[1].enable = false;
-				break;
-
-			//HBlank
-			case 0x2:
-				if(mem->dma[1].started)
-				{
-					//Set word count of transfer to max (0x4000) if specified as zero
-					if(mem->dma[1].word_count == 0) { mem->dma[1].word_count = 0x4000; }
-
-					//16-bit transfer
-					if(mem->dma[1].word_type == 0)
-					{
-						//Align addresses to half-word
-						mem->dma[1].start_address &= ~0x1;
-						mem->dma[1].destination_address	&= ~0x1;
-
-						while(mem->dma[1].word_count != 0)
-						{
-							temp_value = mem->read_u16(mem->dma[1].start_address);
-							mem->write_u16(mem->dma[1].destination_address, temp_value);
-
-							//Update DMA1 Start Address
-							if(mem->dma[1].src_addr_ctrl == 0) { mem->dma[1].start_address += 2; }
-							else if(mem->dma[1].src_addr_ctrl == 1) { mem->dma[1].start_address -= 2; }
-							else if(mem->dma[1].src_addr_ctrl == 3) { mem->dma[1].start_address += 2; }
-
-							//Update DMA1 Destination Address
-							if(mem->dma[1].dest_addr_ctrl == 0) { mem->dma[1].destination_address += 2; }
-							else if(mem->dma[1].dest_addr_ctrl == 1) { mem->dma[1].destination_address -= 2; }
-							else if(mem->dma[1].dest_addr_ctrl == 3) { mem->dma[1].destination_address += 2; }
-
-							mem->dma[1].word_count--;
-						}
-					}
-
-					//32-bit transfer
-					else
-					{
-						//Align addresses to word
-						mem->dma[1].start_address &= ~0x3;
-						mem->dma[1].destination_address	&= ~0x3;
-
-						while(mem->dma[1].word_count != 0)
-						{
-							temp_value = mem->read_u32(mem->dma[1].start_address);
-							mem->write_u32(mem->dma[1].destination_address, temp_value);
-
-							//Update DMA1 Start Address
-							if(mem->dma[1].src_addr_ctrl == 0) { mem->dma[1].start_address += 4; }
-							else if(mem->dma[1].src_addr_ctrl == 1) { mem->dma[1].start_address -= 4; }
-							else if(mem->dma[1].src_addr_ctrl == 3) { mem->dma[1].start_address += 4; }
-
-							//Update DMA1 Destination Address
-							if(mem->dma[1].dest_addr_ctrl == 0) { mem->dma[1].destination_address += 4; }
-							else if(mem->dma[1].dest_addr_ctrl == 1) { mem->dma[1].destination_address -= 4; }
-							else if(mem->dma[1].dest_addr_ctrl == 3) { mem->dma[1].destination_address += 4; }
-
-							mem->dma[1].word_count--;
-						}
-					}
-
-					//Reload if control flags are set to 0x3
-					if(mem->dma[1].dest_addr_ctrl == 3) { mem->dma[1].destination_address = mem->dma[1].original_destination_address; };
-
-					//Reset enable bit if HBlank DMA is non-repeating
-					if((mem->dma[1].control & 0x200) == 0)
-					{
-						mem->dma[1].control &= ~0x8000;
-						mem->write_u16_fast(DMA1CNT_H, mem->dma[1].control);
-					}
-
-					//Raise DMA1 IRQ if necessary
-					if(mem->dma[1].control & 0x4000) { mem->memory_map[REG_IF+1] |= 0x2; }
-
-					mem->dma[1].enable = false;
-					mem->dma[1].started = false;
-				}
-
-				break;
-
-			//Special
-			case 0x3:
-				mem->dma[1].enable = false;
-				mem->dma[1].started = true;
-
-				if(mem->dma[1].destination_address == FIFO_A) { controllers.audio.apu_stat.dma[0].channel = 1; }
-				if(mem->dma[1].destination_address == FIFO_B) { controllers.audio.apu_stat.dma[1].channel = 1; }
-
-				break;
-		}
-	}
-}
-
-/****** Performs DMA2 transfers ******/
-void ARM7::dma2()
-{
-	//Wait 2 cycles after DMA is triggered before actual transfer
-	if(mem->dma[2].delay != 0) { mem->dma[2].delay--; }
+	u32 cnt_l_addr = DMA0CNT_L + (index * 12);
+	u32 cnt_h_addr = DMA0CNT_H + (index * 12);
+	u8 irq_mask = (1 << index);
 
 	//See if DMA Start Timing conditions dictate a transfer
-	else
-	{
-		mem->dma[2].word_count = mem->read_u16_fast(DMA2CNT_L);
-		mem->dma[2].word_type = (mem->read_u16_fast(DMA2CNT_H) & 0x400) ? 1 : 0;
-
-		u32 temp_value = 0;
-
-		if((mem->dma[2].control & 0x8000) == 0) { mem->dma[2].enable = false; return; }
-
-		//Check DMA Start Timings
-		switch(((mem->dma[2].control >> 12) & 0x3))
-		{
-			//Immediate
-			case 0x0:
-				//Set word count of transfer to max (0x4000) if specified as zero
-				if(mem->dma[2].word_count == 0) { mem->dma[2].word_count = 0x4000; }
-
-				//16-bit transfer
-				if(mem->dma[2].word_type == 0)
-				{
-					//Align addresses to half-word
-					mem->dma[2].start_address &= ~0x1;
-					mem->dma[2].destination_address	&= ~0x1;
-
-					while(mem->dma[2].word_count != 0)
-					{
-						temp_value = mem->read_u16(mem->dma[2].start_address);
-						mem->write_u16(mem->dma[2].destination_address, temp_value);
-
-						//Update DMA2 Start Address
-						if(mem->dma[2].src_addr_ctrl == 0) { mem->dma[2].start_address += 2; }
-						else if(mem->dma[2].src_addr_ctrl == 1) { mem->dma[2].start_address -= 2; }
-						else if(mem->dma[2].src_addr_ctrl == 3) { mem->dma[2].start_address += 2; }
-
-						//Update DMA2 Destination Address
-						if(mem->dma[2].dest_addr_ctrl == 0) { mem->dma[2].destination_address += 2; }
-						else if(mem->dma[2].dest_addr_ctrl == 1) { mem->dma[2].destination_address -= 2; }
-						else if(mem->dma[2].dest_addr_ctrl == 3) { mem->dma[2].destination_address += 2; }
-
-						mem->dma[2].word_count--;
-					}
-				}
-
-				//32-bit transfer
-				else
-				{
-					//Align addresses to word
-					mem->dma[2].start_address &= ~0x3;
-					mem->dma[2].destination_address	&= ~0x3;
-
-					while(mem->dma[2].word_count != 0)
-					{
-						temp_value = mem->read_u32(mem->dma[2].start_address);
-						mem->write_u32(mem->dma[2].destination_address, temp_value);
-
-						//Update DMA2 Start Address
-						if(mem->dma[2].src_addr_ctrl == 0) { mem->dma[2].start_address += 4; }
-						else if(mem->dma[2].src_addr_ctrl == 1) { mem->dma[2].start_address -= 4; }
-						else if(mem->dma[2].src_addr_ctrl == 3) { mem->dma[2].start_address += 4; }
-
-						//Update DMA2 Destination Address
-						if(mem->dma[2].dest_addr_ctrl == 0) { mem->dma[2].destination_address += 4; }
-						else if(mem->dma[2].dest_addr_ctrl == 1) { mem->dma[2].destination_address -= 4; }
-						else if(mem->dma[2].dest_addr_ctrl == 3) { mem->dma[2].destination_address += 4; }
-
-						mem->dma[2].word_count--;
-					}
-				}
-
-				//Reload if control flags are set to 0x3
-				if(mem->dma[2].dest_addr_ctrl == 3) { mem->dma[2].destination_address = mem->dma[2].original_destination_address; };
-
-				mem->dma[2].control &= ~0x8000;
-				mem->write_u16_fast(DMA2CNT_H, mem->dma[2].control);
+	mem->dma[index].word_count = mem->read_u16_fast(cnt_l_addr);
+	mem->dma[index].word_type = (mem->read_u16_fast(cnt_h_addr) & 0x400) ? 1 : 0;
 
-				//Raise DMA2 IRQ if necessary
-				if(mem->dma[2].control & 0x4000) { mem->memory_map[REG_IF+1] |= 0x4; }
+	if((mem->dma[index].control & 0x8000) == 0) { mem->dma[index].enable = false; return; }
 
-				mem->dma[2].enable = false;
-				break;
-
-			//VBlank
-			case 0x1:
-				std::cout<<"VBlank DMA2!\n";
-				mem->dma[2].enable = false;
-				break;
-
-			//HBlank
-			case 0x2:
-				if(mem->dma[2].started)
-				{
-					//Set word count of transfer to max (0x4000) if specified as zero
-					if(mem->dma[2].word_count == 0) { mem->dma[2].word_count = 0x4000; }
-
-					//16-bit transfer
-					if(mem->dma[2].word_type == 0)
-					{
-						//Align addresses to half-word
-						mem->dma[2].start_address &= ~0x1;
-						mem->dma[2].destination_address	&= ~0x1;
-
-						while(mem->dma[2].word_count != 0)
-						{
-							temp_value = mem->read_u16(mem->dma[2].start_address);
-							mem->write_u16(mem->dma[2].destination_address, temp_value);
-
-							//Update DMA2 Start Address
-							if(mem->dma[2].src_addr_ctrl == 0) { mem->dma[2].start_address += 2; }
-							else if(mem->dma[2].src_addr_ctrl == 1) { mem->dma[2].start_address -= 2; }
-							else if(mem->dma[2].src_addr_ctrl == 3) { mem->dma[2].start_address += 2; }
-
-							//Update DMA2 Destination Address
-							if(mem->dma[2].dest_addr_ctrl == 0) { mem->dma[2].destination_address += 2; }
-							else if(mem->dma[2].dest_addr_ctrl == 1) { mem->dma[2].destination_address -= 2; }
-							else if(mem->dma[2].dest_addr_ctrl == 3) { mem->dma[2].destination_address += 2; }
-
-							mem->dma[2].word_count--;
-						}
-					}
-
-					//32-bit transfer
-					else
-					{
-						//Align addresses to word
-						mem->dma[2].start_address &= ~0x3;
-						mem->dma[2].destination_address	&= ~0x3;
-
-						while(mem->dma[2].word_count != 0)
-						{
-							temp_value = mem->read_u32(mem->dma[2].start_address);
-							mem->write_u32(mem->dma[2].destination_address, temp_value);
-
-							//Update DMA2 Start Address
-							if(mem->dma[2].src_addr_ctrl == 0) { mem->dma[2].start_address += 4; }
-							else if(mem->dma[2].src_addr_ctrl == 1) { mem->dma[2].start_address -= 4; }
-							else if(mem->dma[2].src_addr_ctrl == 3) { mem->dma[2].start_address += 4; }
-
-							//Update DMA2 Destination Address
-							if(mem->dma[2].dest_addr_ctrl == 0) { mem->dma[2].destination_address += 4; }
-							else if(mem->dma[2].dest_addr_ctrl == 1) { mem->dma[2].destination_address -= 4; }
-							else if(mem->dma[2].dest_addr_ctrl == 3) { mem->dma[2].destination_address += 4; }
-
-							mem->dma[2].word_count--;
-						}
-					}
-
-					//Reload if control flags are set to 0x3
-					if(mem->dma[2].dest_addr_ctrl == 3) { mem->dma[2].destination_address = mem->dma[2].original_destination_address; };
-
-					//Reset enable bit if HBlank DMA is non-repeating
-					if((mem->dma[2].control & 0x200) == 0)
-					{
-						mem->dma[2].control &= ~0x8000;
-						mem->write_u16_fast(DMA2CNT_H, mem->dma[2].control);
-					}
-
-					//Raise DMA2 IRQ if necessary
-					if(mem->dma[2].control & 0x4000) { mem->memory_map[REG_IF+1] |= 0x4; }
-
-					mem->dma[2].enable = false;
-					mem->dma[2].started = false;
-				}
-
-				break;
-
-			//Special
-			case 0x3:
-				mem->dma[2].enable = false;
-				mem->dma[2].started = true;
-
-				if(mem->dma[2].destination_address == FIFO_A) { controllers.audio.apu_stat.dma[0].channel = 2; }
-				if(mem->dma[2].destination_address == FIFO_B) { controllers.audio.apu_stat.dma[1].channel = 2; }
-
-				break;
-		}
-	}
-}
-
-/****** Performs DMA3 transfers ******/
-void ARM7::dma3()
-{
-	//Wait 2 cycles after DMA is triggered before actual transfer
-	if(mem->dma[3].delay != 0) { mem->dma[3].delay--; }
-
-	//See if DMA Start Timing conditions dictate a transfer
-	else
+	//EEPROM is only reachable through DMA3
+	if(index == 3)
 	{
-		mem->dma[3].word_count = mem->read_u16_fast(DMA3CNT_L);
-		mem->dma[3].word_type = (mem->read_u16_fast(DMA3CNT_H) & 0x400) ? 1 : 0;
-
-		u32 temp_value = 0;
-
-		if((mem->dma[3].control & 0x8000) == 0) { mem->dma[3].enable = false; return; }
-
 		//Read from EEPROM
 		if((mem->dma[3].start_address >= 0xD000000) && (mem->dma[3].start_address <= 0xDFFFFFF)) 
 		{
@@ -622,168 +74,173 @@ void ARM7::dma3()
 			mem->dma[3].enable = false; 
 			return;
 		}
+	}
 
-		//Check DMA Start Timings
-		switch(((mem->dma[3].control >> 12) & 0x3))
-		{
-			//Immediate
-			case 0x0:
-				//Set word count of transfer to max (0x10000) if specified as zero
-				if(mem->dma[3].word_count == 0) { mem->dma[3].word_count = 0x10000; }
+	//Check DMA Start Timings
+	switch(((mem->dma[index].control >> 12) & 0x3))
+	{
+		//Immediate
+		case 0x0:
+			dma_transfer(index);
 
-				//16-bit transfer
-				if(mem->dma[3].word_type == 0)
-				{
-					//Align addresses to half-word
-					mem->dma[3].start_address &= ~0x1;
-					mem->dma[3].destination_address	&= ~0x1;
-
-					while(mem->dma[3].word_count != 0)
-					{
-						temp_value = mem->read_u16(mem->dma[3].start_address);
-						mem->write_u16(mem->dma[3].destination_address, temp_value);
-
-						//Update DMA3 Start Address
-						if(mem->dma[3].src_addr_ctrl == 0) { mem->dma[3].start_address += 2; }
-						else if(mem->dma[3].src_addr_ctrl == 1) { mem->dma[3].start_address -= 2; }
-						else if(mem->dma[3].src_addr_ctrl == 3) { mem->dma[3].start_address += 2; }
-
-						//Update DMA3 Destination Address
-						if(mem->dma[3].dest_addr_ctrl == 0) { mem->dma[3].destination_address += 2; }
-						else if(mem->dma[3].dest_addr_ctrl == 1) { mem->dma[3].destination_address -= 2; }
-						else if(mem->dma[3].dest_addr_ctrl == 3) { mem->dma[3].destination_address += 2; }
-
-						mem->dma[3].word_count--;
-					}
-				}
+			mem->dma[index].control &= ~0x8000;
+			mem->write_u16_fast(cnt_h_addr, mem->dma[index].control);
+
+			//Raise DMA IRQ if necessary
+			if(mem->dma[index].control & 0x4000) { mem->memory_map[REG_IF+1] |= irq_mask; }
+
+			mem->dma[index].enable = false;
+			break;
+
+		//VBlank
+		case 0x1:
+			std::cout<<"VBlank DMA" << (u16)index << "!\n";
+			mem->dma[index].enable = false;
+			break;
 
-				//32-bit transfer
-				else
+		//HBlank
+		case 0x2:
+			if(mem->dma[index].started)
+			{
+				dma_transfer(index);
+
+				//Reset enable bit if HBlank DMA is non-repeating
+				if((mem->dma[index].control & 0x200) == 0)
 				{
-					//Align addresses to word
-					mem->dma[3].start_address &= ~0x3;
-					mem->dma[3].destination_address	&= ~0x3;
-
-					while(mem->dma[3].word_count != 0)
-					{
-						temp_value = mem->read_u32(mem->dma[3].start_address);
-						mem->write_u32(mem->dma[3].destination_address, temp_value);
-
-						//Update DMA3 Start Address
-						if(mem->dma[3].src_addr_ctrl == 0) { mem->dma[3].start_address += 4; }
-						else if(mem->dma[3].src_addr_ctrl == 1) { mem->dma[3].start_address -= 4; }
-						else if(mem->dma[3].src_addr_ctrl == 3) { mem->dma[3].start_address += 4; }
-
-						//Update DMA3 Destination Address
-						if(mem->dma[3].dest_addr_ctrl == 0) { mem->dma[3].destination_address += 4; }
-						else if(mem->dma[3].dest_addr_ctrl == 1) { mem->dma[3].destination_address -= 4; }
-						else if(mem->dma[3].dest_addr_ctrl == 3) { mem->dma[3].destination_address += 4; }
-
-						mem->dma[3].word_count--;
-					}
+					mem->dma[index].control &= ~0x8000;
+					mem->write_u16_fast(cnt_h_addr, mem->dma[index].control);
 				}
 
-				//Reload if control flags are set to 0x3
-				if(mem->dma[3].dest_addr_ctrl == 3) { mem->dma[3].destination_address = mem->dma[3].original_destination_address; };
+				//Raise DMA IRQ if necessary
+				if(mem->dma[index].control & 0x4000) { mem->memory_map[REG_IF+1] |= irq_mask; }
 
-				mem->dma[3].control &= ~0x8000;
-				mem->write_u16_fast(DMA3CNT_H, mem->dma[3].control);
+				mem->dma[index].enable = false;
+				mem->dma[index].started = false;
+			}
 
-				//Raise DMA3 IRQ if necessary
-				if(mem->dma[3].control & 0x4000) { mem->memory_map[REG_IF+1] |= 0x8; }
+			break;
 
-				mem->dma[3].enable = false;
-				break;
+		//Special
+		case 0x3:
+			mem->dma[index].enable = false;
 
-			//VBlank
-			case 0x1:
-				std::cout<<"VBlank DMA3!\n";
-				mem->dma[3].enable = false;
-				break;
+			//DMA1 and DMA2 feed the sound FIFOs
+			//Whichever FIFO the destination points at is served by this channel, same as the old dma1() and dma2()
+			if((index == 1) || (index == 2))
+			{
+				mem->dma[index].started = true;
 
-			//HBlank
-			case 0x2:
-				if(mem->dma[3].started)
-				{
-					//Set word count of transfer to max (0x10000) if specified as zero
-					if(mem->dma[3].word_count == 0) { mem->dma[3].word_count = 0x10000; }
-
-					//16-bit transfer
-					if(mem->dma[3].word_type == 0)
-					{
-						//Align addresses to half-word
-						mem->dma[3].start_address &= ~0x1;
-						mem->dma[3].destination_address	&= ~0x1;
-
-						while(mem->dma[3].word_count != 0)
-						{
-							temp_value = mem->read_u16(mem->dma[3].start_address);
-							mem->write_u16(mem->dma[3].destination_address, temp_value);
-
-							//Update DMA3 Start Address
-							if(mem->dma[3].src_addr_ctrl == 0) { mem->dma[3].start_address += 2; }
-							else if(mem->dma[3].src_addr_ctrl == 1) { mem->dma[3].start_address -= 2; }
-							else if(mem->dma[3].src_addr_ctrl == 3) { mem->dma[3].start_address += 2; }
-
-							//Update DMA0 Destination Address
-							if(mem->dma[3].dest_addr_ctrl == 0) { mem->dma[3].destination_address += 2; }
-							else if(mem->dma[3].dest_addr_ctrl == 1) { mem->dma[3].destination_address -= 2; }
-							else if(mem->dma[3].dest_addr_ctrl == 3) { mem->dma[3].destination_address += 2; }
-
-							mem->dma[3].word_count--;
-						}
-					}
-
-					//32-bit transfer
-					else
-					{
-						//Align addresses to word
-						mem->dma[3].start_address &= ~0x3;
-						mem->dma[3].destination_address	&= ~0x3;
-
-						while(mem->dma[3].word_count != 0)
-						{
-							temp_value = mem->read_u32(mem->dma[3].start_address);
-							mem->write_u32(mem->dma[3].destination_address, temp_value);
-
-							//Update DMA0 Start Address
-							if(mem->dma[3].src_addr_ctrl == 0) { mem->dma[3].start_address += 4; }
-							else if(mem->dma[3].src_addr_ctrl == 1) { mem->dma[3].start_address -= 4; }
-							else if(mem->dma[3].src_addr_ctrl == 3) { mem->dma[3].start_address += 4; }
-
-							//Update DMA0 Destination Address
-							if(mem->dma[3].dest_addr_ctrl == 0) { mem->dma[3].destination_address += 4; }
-							else if(mem->dma[3].dest_addr_ctrl == 1) { mem->dma[3].destination_address -= 4; }
-							else if(mem->dma[3].dest_addr_ctrl == 3) { mem->dma[3].destination_address += 4; }
-
-							mem->dma[3].word_count--;
-						}
-					}
-
-					//Reload if control flags are set to 0x3
-					if(mem->dma[3].dest_addr_ctrl == 3) { mem->dma[3].destination_address = mem->dma[3].original_destination_address; };
-
-					//Reset enable bit if HBlank DMA is non-repeating
-					if((mem->dma[3].control & 0x200) == 0)
-					{
-						mem->dma[3].control &= ~0x8000;
-						mem->write_u16_fast(DMA3CNT_H, mem->dma[3].control);
-					}
-
-					//Raise DMA3 IRQ if necessary
-					if(mem->dma[3].control & 0x4000) { mem->memory_map[REG_IF+1] |= 0x8; }
-
-					mem->dma[3].enable = false;
-					mem->dma[3].started = false;
-				}
+				if(mem->dma[index].destination_address == FIFO_A) { controllers.audio.apu_stat.dma[0].channel = index; }
+				if(mem->dma[index].destination_address == FIFO_B) { controllers.audio.apu_stat.dma[1].channel = index; }
+			}
+
+			else { std::cout<<"Special DMA" << (u16)index << "!\n"; }
+
+			break;
+	}
+}
+
+/****** Moves all units of a DMA transfer ******/
+void ARM7::dma_transfer(u8 index)
+{
+	u32 temp_value = 0;
+
+	//Set word count of transfer to max (0x4000 or 0x10000 for DMA3) if specified as zero
+	if(mem->dma[index].word_count == 0) { mem->dma[index].word_count = (index == 3) ? 0x10000 : 0x4000; }
+
+	u8 unit = (mem->dma[index].word_type) ? 4 : 2;
+
+	//Align addresses to half-word or word
+	mem->dma[index].start_address &= ~(unit - 1);
+	mem->dma[index].destination_address &= ~(unit - 1);
+
+	//Plain memory with incrementing addresses gets copied in blocks, anything left over goes unit by unit
+	dma_block_copy(index, unit);
+
+	while(mem->dma[index].word_count != 0)
+	{
+		//16-bit transfer
+		if(unit == 2)
+		{
+			temp_value = mem->read_u16(mem->dma[index].start_address);
+			mem->write_u16(mem->dma[index].destination_address, temp_value);
+		}
+
+		//32-bit transfer
+		else
+		{
+			temp_value = mem->read_u32(mem->dma[index].start_address);
+			mem->write_u32(mem->dma[index].destination_address, temp_value);
+		}
+
+		//Update DMA Start Address
+		if(mem->dma[index].src_addr_ctrl == 0) { mem->dma[index].start_address += unit; }
+		else if(mem->dma[index].src_addr_ctrl == 1) { mem->dma[index].start_address -= unit; }
+		else if(mem->dma[index].src_addr_ctrl == 3) { mem->dma[index].start_address += unit; }
+
+		//Update DMA Destination Address
+		if(mem->dma[index].dest_addr_ctrl == 0) { mem->dma[index].destination_address += unit; }
+		else if(mem->dma[index].dest_addr_ctrl == 1) { mem->dma[index].destination_address -= unit; }
+		else if(mem->dma[index].dest_addr_ctrl == 3) { mem->dma[index].destination_address += unit; }
+
+		mem->dma[index].word_count--;
+	}
+
+	//Reload if control flags are set to 0x3
+	if(mem->dma[index].dest_addr_ctrl == 3) { mem->dma[index].destination_address = mem->dma[index].original_destination_address; }
+}
+
+/****** Copies as much of a DMA transfer as possible directly between host buffers ******/
+void ARM7::dma_block_copy(u8 index, u8 unit)
+{
+	#ifndef GBE_DEBUG
+
+	//Both addresses must increment (0x3 increments as well)
+	if((mem->dma[index].src_addr_ctrl == 1) || (mem->dma[index].src_addr_ctrl == 2)) { return; }
+	if((mem->dma[index].dest_addr_ctrl == 1) || (mem->dma[index].dest_addr_ctrl == 2)) { return; }
+
+	while(mem->dma[index].word_count != 0)
+	{
+		u32 src_addr = mem->dma[index].start_address;
+		u32 dst_addr = mem->dma[index].destination_address;
+
+		if(((src_addr >> MEM_PAGE_SHIFT) >= MEM_PAGE_COUNT) || ((dst_addr >> MEM_PAGE_SHIFT) >= MEM_PAGE_COUNT)) { return; }
 
-				break;
+		//Only memory without side effects is mapped into the page tables
+		u8* src = mem->read_pages[src_addr >> MEM_PAGE_SHIFT];
+		u8* dst = mem->write_pages[dst_addr >> MEM_PAGE_SHIFT];
 
-			//Special
-			case 0x3:
-				std::cout<<"Special DMA3!\n";
-				mem->dma[3].enable = false;
-				break;
+		if((src == NULL) || (dst == NULL)) { return; }
+
+		src += (src_addr & (MEM_PAGE_SIZE - 1));
+		dst += (dst_addr & (MEM_PAGE_SIZE - 1));
+
+		//Copy up to the end of whichever page ends first
+		u32 length = mem->dma[index].word_count * unit;
+		u32 src_left = MEM_PAGE_SIZE - (src_addr & (MEM_PAGE_SIZE - 1));
+		u32 dst_left = MEM_PAGE_SIZE - (dst_addr & (MEM_PAGE_SIZE - 1));
+
+		if(src_left < length) { length = src_left; }
+		if(dst_left < length) { length = dst_left; }
+
+		//Overlapping copies to higher addresses repeat data unit by unit, leave those on the slow path
+		if((dst > src) && (dst < (src + length))) { return; }
+
+		//Drop any cached code this copy modifies
+		if((!mem->code_cache.blocks.empty()) && (std::memcmp(dst, src, length) != 0))
+		{
+			for(u32 x = 0; x < length; x += (1 << BLOCK_PAGE_SHIFT)) { mem->invalidate_code(dst_addr + x); }
+			mem->invalidate_code(dst_addr + length - 1);
 		}
+
+		std::memmove(dst, src, length);
+		if((dst_addr >> 24) == 0x6) { mem->mark_vram_dirty(dst_addr, length); }
+
+		mem->dma[index].start_address += length;
+		mem->dma[index].destination_address += length;
+		mem->dma[index].word_count -= (length / unit);
+		mem->write_count++;
 	}
+
+	#endif
 }
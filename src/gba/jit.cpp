@@ -0,0 +1,1198 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : jit.cpp
+// Date : October 17, 2026
+// Description : GBA x86-64 recompiler
+//
+// Translates hot blocks from the code block cache into x86-64 host code
+// Data processing and branches run natively, every other instruction calls its interpreter handler
+// Controller cycles are added up natively and only handed to ARM7::clock_controllers() before the next event
+
+#include "arm7.h"
+
+#ifdef GBE_JIT
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+//x86-64 registers
+#define X64_RAX 0
+#define X64_RCX 1
+#define X64_RDX 2
+#define X64_RBX 3
+#define X64_RSI 6
+#define X64_RDI 7
+#define X64_R8 8
+#define X64_R9 9
+#define X64_R10 10
+#define X64_R11 11
+#define X64_R12 12
+#define X64_R13 13
+#define X64_R14 14
+
+//Registers kept for the whole block - CPU pointer, pending cycles, cycle budget, pending memory access cycles
+#define JIT_CPU X64_RBX
+#define JIT_CYCLES X64_R12
+#define JIT_BUDGET X64_R13
+#define JIT_ACCESS_CYCLES X64_R14
+
+//Host calling convention
+#ifdef _WIN32
+#define JIT_ARG_0 X64_RCX
+#define JIT_ARG_1 X64_RDX
+#define JIT_ARG_2 X64_R8
+#define JIT_ARG_3 X64_R9
+#else
+#define JIT_ARG_0 X64_RDI
+#define JIT_ARG_1 X64_RSI
+#define JIT_ARG_2 X64_RDX
+#define JIT_ARG_3 X64_RCX
+#endif
+
+//x86-64 condition codes
+#define X64_CC_O 0x0
+#define X64_CC_C 0x2
+#define X64_CC_NC 0x3
+#define X64_CC_Z 0x4
+#define X64_CC_S 0x8
+
+//x86-64 ALU, shift, and unary operations
+#define X64_ADD 0
+#define X64_OR 1
+#define X64_ADC 2
+#define X64_SBB 3
+#define X64_AND 4
+#define X64_SUB 5
+#define X64_XOR 6
+#define X64_CMP 7
+
+#define X64_ROR 1
+#define X64_RCR 3
+#define X64_SHL 4
+#define X64_SHR 5
+#define X64_SAR 7
+
+#define X64_NOT 2
+#define X64_NEG 3
+
+//Where the new Carry flag comes from when updating the CPSR
+#define JIT_CARRY_KEEP 0
+#define JIT_CARRY_HOST 1
+#define JIT_CARRY_CLEAR 2
+#define JIT_CARRY_SET 3
+
+/****** Checks whether the CPU takes an interrupt after the current instruction - Mirrors ARM7::handle_interrupt() ******/
+static bool jit_irq_pending(ARM7* cpu)
+{
+	if(((cpu->mem->memory_map[REG_IME] & 0x1) == 0) || (cpu->reg.cpsr & CPSR_IRQ) || (cpu->in_interrupt)) { return false; }
+
+	return (cpu->mem->read_u16_fast(REG_IF) & cpu->mem->read_u16_fast(REG_IE) & 0x3FFF) != 0;
+}
+
+/****** Returns the number of cycles recompiled code may run before any controller needs to ******/
+static u32 jit_cycle_budget(ARM7* cpu)
+{
+	u32 event_cycles = cpu->next_event(false);
+	u32 timer_cycles = cpu->next_timer_overflow();
+
+	return (timer_cycles < event_cycles) ? timer_cycles : event_cycles;
+}
+
+/****** Runs controllers for cycles added up by recompiled code ******/
+static void jit_clock(ARM7* cpu, u32 cycles, u32 access_cycles)
+{
+	cpu->system_cycles += cycles;
+	cpu->clock_controllers(access_cycles, true);
+	cpu->clock_controllers(cycles - access_cycles, false);
+}
+
+/****** Checks whether recompiled code may go on after an instruction ******/
+static bool jit_can_resume(ARM7* cpu)
+{
+	AGB_JIT& jit = cpu->jit;
+
+	if((cpu->needs_flush) || (!cpu->running) || (cpu->current_cpu_mode != jit.entry_cpu_mode) || (cpu->arm_mode != jit.entry_arm_mode)) { return false; }
+	if(cpu->mem->code_cache.generation != jit.entry_generation) { return false; }
+
+	return !jit_irq_pending(cpu);
+}
+
+/****** Sets up the pipeline as the interpreter has it while running the instruction at addr ******/
+static void jit_prefetch(ARM7* cpu, u32 addr)
+{
+	u32 instr_size = (cpu->arm_mode == ARM7::THUMB) ? 2 : 4;
+
+	//Recompiled code stores opcodes from its own block. Anything past the end is fetched from memory
+	for(u32 x = 1; x < 3; x++)
+	{
+		if(cpu->instruction_operation[x] != ARM7::PIPELINE_FILL) { continue; }
+
+		cpu->pipeline_pointer = x;
+		cpu->reg.r15 = addr + (instr_size * x);
+		cpu->fetch();
+	}
+
+	//Executing from Slot 0, decoding Slot 1, just fetched Slot 2
+	cpu->pipeline_pointer = 2;
+	cpu->reg.r15 = addr + (instr_size * 2);
+	cpu->decode();
+}
+
+/****** Leaves recompiled code after the instruction at addr ******/
+static void jit_leave(ARM7* cpu, u32 addr)
+{
+	cpu->debug_code = cpu->instruction_pipeline[0];
+	cpu->debug_message = ARM7::debug_message_table[cpu->instruction_operation[0]];
+
+	//Branches flush the pipeline anyway
+	if(!cpu->needs_flush) { jit_prefetch(cpu, addr); }
+}
+
+/****** Called by recompiled code once its cycles reach the budget - Returns a new budget, or 0 after leaving the block ******/
+static u32 jit_sync(ARM7* cpu, u32 cycles, u32 access_cycles, u32 addr)
+{
+	jit_clock(cpu, cycles, access_cycles);
+	if(jit_can_resume(cpu)) { return jit_cycle_budget(cpu); }
+
+	jit_leave(cpu, addr);
+	return 0;
+}
+
+/****** Called by recompiled code for instructions it cannot run natively - Returns a new budget, or 0 after leaving the block ******/
+static u32 jit_fallback(ARM7* cpu, u32 cycles, u32 access_cycles, u32 addr)
+{
+	jit_clock(cpu, cycles, access_cycles);
+
+	//The instruction sits in Slot 0 already, run it through the interpreter with the pipeline it expects
+	jit_prefetch(cpu, addr);
+	cpu->execute();
+
+	return jit_can_resume(cpu) ? jit_cycle_budget(cpu) : 0;
+}
+
+/****** Called by recompiled code after the last instruction of a block ******/
+static void jit_exit(ARM7* cpu, u32 cycles, u32 access_cycles, u32 addr)
+{
+	jit_clock(cpu, cycles, access_cycles);
+	jit_leave(cpu, addr);
+}
+
+/****** JIT Constructor ******/
+AGB_JIT::AGB_JIT()
+{
+	enable = false;
+	code_buffer = nullptr;
+	code_pos = 0;
+	entry_generation = 0;
+	entry_cpu_mode = 0;
+	entry_arm_mode = 0;
+	uses_banked_regs = false;
+}
+
+/****** JIT Destructor ******/
+AGB_JIT::~AGB_JIT()
+{
+	if(code_buffer == nullptr) { return; }
+
+	#ifdef _WIN32
+	VirtualFree(code_buffer, 0, MEM_RELEASE);
+	#else
+	munmap(code_buffer, JIT_BUFFER_SIZE);
+	#endif
+}
+
+/****** Runs a recompiled block if one starts at the PC - Returns false when the interpreter has to run the next instruction ******/
+bool AGB_JIT::run_block(ARM7& cpu)
+{
+	if(!enable) { return false; }
+
+	//Blocks are only entered right after the pipeline was flushed, so they never start mid-pipeline
+	if((cpu.pipeline_pointer != 0) || (cpu.instruction_operation[0] != ARM7::PIPELINE_FILL)
+	|| (cpu.instruction_operation[1] != ARM7::PIPELINE_FILL) || (cpu.instruction_operation[2] != ARM7::PIPELINE_FILL)) { return false; }
+
+	//Interrupts already pending are taken after the first instruction, leave that to the interpreter
+	if(jit_irq_pending(&cpu)) { return false; }
+
+	bool thumb = (cpu.arm_mode == ARM7::THUMB);
+	agb_block_cache& cache = cpu.mem->code_cache;
+
+	auto cached_block = cache.blocks.find(cpu.reg.r15 | thumb);
+	if((cached_block == cache.blocks.end()) || (cached_block->second.thumb != thumb)) { return false; }
+
+	agb_code_block& block = cached_block->second;
+
+	if(block.host_code == nullptr)
+	{
+		//Blocks run a few times before recompiling. Ones that could not be recompiled stay with the interpreter
+		if(block.run_count > JIT_COMPILE_THRESHOLD) { return false; }
+		if(block.run_count++ < JIT_COMPILE_THRESHOLD) { return false; }
+		if(!compile(cpu, block)) { return false; }
+	}
+
+	//Banked registers are resolved when compiling, so those blocks only run in the same CPU mode
+	if((block.host_banked) && (block.host_mode != cpu.current_cpu_mode)) { return false; }
+
+	entry_generation = cache.generation;
+	entry_cpu_mode = cpu.current_cpu_mode;
+	entry_arm_mode = cpu.arm_mode;
+
+	host_block run = (host_block)block.host_code;
+	run(&cpu, jit_cycle_budget(&cpu));
+
+	return true;
+}
+
+/****** Recompiles a code block into host code ******/
+bool AGB_JIT::compile(ARM7& cpu, agb_code_block& block)
+{
+	//Allocate executable memory the first time anything gets recompiled
+	if(code_buffer == nullptr)
+	{
+		#ifdef _WIN32
+		code_buffer = (u8*)VirtualAlloc(NULL, JIT_BUFFER_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+		#else
+		void* buffer = mmap(NULL, JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		code_buffer = (buffer == MAP_FAILED) ? nullptr : (u8*)buffer;
+		#endif
+
+		if(code_buffer == nullptr)
+		{
+			std::cout<<"JIT::Error - Could not allocate executable memory, falling back to the interpreter\n";
+			enable = false;
+			config::use_jit = false;
+			return false;
+		}
+	}
+
+	//Start over once the buffer is full. Nothing is running at this point, so old host code can go
+	if((code_pos + JIT_MAX_BLOCK_SIZE) > JIT_BUFFER_SIZE) { flush_buffer(cpu); }
+
+	code.clear();
+	exit_jumps.clear();
+	uses_banked_regs = false;
+
+	//Prologue - Save callee-saved registers and keep the stack aligned for calls
+	push_reg(X64_RBX);
+	push_reg(X64_R12);
+	push_reg(X64_R13);
+	push_reg(X64_R14);
+	stack_frame(true);
+
+	mov_reg64_reg64(JIT_CPU, JIT_ARG_0);
+	mov_reg_reg(JIT_BUDGET, JIT_ARG_1);
+	alu_reg_reg(X64_XOR, JIT_CYCLES, JIT_CYCLES);
+	alu_reg_reg(X64_XOR, JIT_ACCESS_CYCLES, JIT_ACCESS_CYCLES);
+
+	u32 instr_size = block.thumb ? 2 : 4;
+	u32 count = block.opcode.size();
+	u32 native_count = 0;
+	bool native = false;
+
+	for(u32 x = 0; x < count; x++)
+	{
+		u32 addr = block.start_addr + (x * instr_size);
+		bool last = ((x + 1) == count);
+
+		if(block.thumb) { native = compile_thumb(cpu, addr, block.opcode[x], block.operation[x], last); }
+		else { native = compile_arm(cpu, addr, block.opcode[x], block.operation[x], last); }
+
+		if(!native) { compile_fallback(cpu, block, x); }
+		else if(!last) { emit_cycle_check(cpu, block, x); }
+
+		if(native) { native_count++; }
+	}
+
+	//Blocks made up only of loads, stores, and other interpreter calls gain nothing from recompiling
+	if(native_count == 0) { return false; }
+
+	//Hand the remaining cycles to the controllers and leave the pipeline as the interpreter would
+	//Interpreter calls leave it that way on their own
+	if(native)
+	{
+		emit_pipeline(cpu, block, (count - 1));
+
+		mov_reg64_reg64(JIT_ARG_0, JIT_CPU);
+		mov_reg_reg(JIT_ARG_1, JIT_CYCLES);
+		mov_reg_reg(JIT_ARG_2, JIT_ACCESS_CYCLES);
+		mov_reg_imm(JIT_ARG_3, (block.start_addr + ((count - 1) * instr_size)));
+		call((void*)&jit_exit);
+	}
+
+	//Epilogue - Every early exit lands here
+	for(u32 x = 0; x < exit_jumps.size(); x++) { bind(exit_jumps[x]); }
+
+	stack_frame(false);
+	pop_reg(X64_R14);
+	pop_reg(X64_R13);
+	pop_reg(X64_R12);
+	pop_reg(X64_RBX);
+	emit_u8(0xC3);
+
+	if(code.size() > JIT_MAX_BLOCK_SIZE)
+	{
+		std::cout<<"JIT::Error - Recompiled block at 0x" << std::hex << block.start_addr << " is too large\n";
+		return false;
+	}
+
+	memcpy(code_buffer + code_pos, &code[0], code.size());
+
+	block.host_code = code_buffer + code_pos;
+	block.host_mode = cpu.current_cpu_mode;
+	block.host_banked = uses_banked_regs;
+
+	code_pos += (code.size() + 15) & ~15;
+
+	return true;
+}
+
+/****** Drops every recompiled block once the host code buffer is full ******/
+void AGB_JIT::flush_buffer(ARM7& cpu)
+{
+	for(auto& cached_block : cpu.mem->code_cache.blocks)
+	{
+		cached_block.second.host_code = nullptr;
+		cached_block.second.run_count = 0;
+	}
+	code_pos = 0;
+}
+
+/****** Recompiles an ARM instruction - Returns false if it has to call the interpreter ******/
+bool AGB_JIT::compile_arm(ARM7& cpu, u32 addr, u32 opcode, u8 operation, bool last)
+{
+	u8 condition = (opcode >> 28);
+	s32 cpsr = cpu_offset(cpu, &cpu.reg.cpsr);
+
+	//NV prints a warning in the interpreter
+	if(condition == 0xF) { return false; }
+
+	cycle_count pass = { 0, 0, 0, 0 };
+	cycle_count skip = { 0, 0, 0, 0 };
+
+	//Skipped instructions - 1S
+	if(!add_access(skip, (addr + 8), false)) { return false; }
+
+	u32 skip_jump = 0;
+
+	switch(operation)
+	{
+		//ARM.4 - Branch and Branch with Link
+		case ARM7::ARM_4:
+			{
+				if(!last) { return false; }
+
+				u32 offset = (opcode & 0xFFFFFF) << 2;
+				if(offset & 0x2000000) { offset |= 0xFC000000; }
+
+				u32 target = addr + 8 + offset;
+
+				//1N + 2S
+				if(!add_access(pass, (addr + 8), true)) { return false; }
+				if(!add_access(pass, target, false)) { return false; }
+				if(!add_access(pass, (target + 4), false)) { return false; }
+
+				if(condition != 0xE) { emit_condition(cpu, condition, skip_jump); }
+
+				if(opcode & 0x1000000) { mov_cpu_imm(reg_offset(cpu, 14), (addr + 4)); }
+				mov_cpu_imm(cpu_offset(cpu, &cpu.reg.r15), target);
+				mov_cpu_imm8(cpu_offset(cpu, &cpu.needs_flush), 1);
+			}
+
+			break;
+
+		//ARM.5 - Data Processing
+		case ARM7::ARM_5:
+			{
+				bool use_immediate = (opcode & 0x2000000) ? true : false;
+				bool set_condition = (opcode & 0x100000) ? true : false;
+				u8 op = (opcode >> 21) & 0xF;
+				u8 src_reg = (opcode >> 16) & 0xF;
+				u8 dest_reg = (opcode >> 12) & 0xF;
+
+				//Writes to the PC, shifts by register, and flag-setting ADC, SBC, and RSC go to the interpreter
+				if(dest_reg == 15) { return false; }
+				if((!use_immediate) && (opcode & 0x10)) { return false; }
+				if((set_condition) && (op >= 0x5) && (op <= 0x7)) { return false; }
+
+				bool logical = false;
+				bool subtraction = false;
+
+				switch(op)
+				{
+					case 0x0: case 0x1: case 0x8: case 0x9:
+					case 0xC: case 0xD: case 0xE: case 0xF:
+						logical = true;
+						break;
+
+					case 0x2: case 0x3: case 0xA:
+						subtraction = true;
+						break;
+				}
+
+				//1I for register operands, then 1S
+				if(!use_immediate) { pass.internal++; }
+				if(!add_access(pass, (addr + 12), false)) { return false; }
+
+				if(condition != 0xE) { emit_condition(cpu, condition, skip_jump); }
+
+				u8 carry_mode = JIT_CARRY_KEEP;
+
+				//Operand goes into ECX
+				if(use_immediate)
+				{
+					u32 operand = (opcode & 0xFF);
+					u8 offset = ((opcode >> 8) & 0xF) * 2;
+
+					if(offset)
+					{
+						operand = (operand >> offset) | (operand << (32 - offset));
+						carry_mode = (operand & 0x80000000) ? JIT_CARRY_SET : JIT_CARRY_CLEAR;
+					}
+
+					mov_reg_imm(X64_RCX, operand);
+				}
+
+				else
+				{
+					u8 operand_reg = (opcode & 0xF);
+
+					if(operand_reg == 15) { mov_reg_imm(X64_RCX, (addr + 8)); }
+					else { mov_reg_cpu(X64_RCX, reg_offset(cpu, operand_reg)); }
+
+					emit_shift_imm(cpu, X64_RCX, ((opcode >> 5) & 0x3), ((opcode >> 7) & 0x1F), (set_condition && logical), carry_mode);
+				}
+
+				//Input goes into EAX
+				if((op != 0xD) && (op != 0xF))
+				{
+					if(src_reg == 15) { mov_reg_imm(X64_RAX, (addr + 8)); }
+					else { mov_reg_cpu(X64_RAX, reg_offset(cpu, src_reg)); }
+				}
+
+				switch(op)
+				{
+					case 0x0: alu_reg_reg(X64_AND, X64_RAX, X64_RCX); break;
+					case 0x1: alu_reg_reg(X64_XOR, X64_RAX, X64_RCX); break;
+					case 0x2: alu_reg_reg(X64_SUB, X64_RAX, X64_RCX); break;
+					case 0x3: alu_reg_reg(X64_SUB, X64_RCX, X64_RAX); mov_reg_reg(X64_RAX, X64_RCX); break;
+					case 0x4: alu_reg_reg(X64_ADD, X64_RAX, X64_RCX); break;
+
+					//ADC, SBC, RSC - Load the Carry flag into the host, inverted as a borrow for subtraction
+					case 0x5: bt_cpu_imm(cpsr, 29); alu_reg_reg(X64_ADC, X64_RAX, X64_RCX); break;
+					case 0x6: bt_cpu_imm(cpsr, 29); cmc(); alu_reg_reg(X64_SBB, X64_RAX, X64_RCX); break;
+					case 0x7: bt_cpu_imm(cpsr, 29); cmc(); alu_reg_reg(X64_SBB, X64_RCX, X64_RAX); mov_reg_reg(X64_RAX, X64_RCX); break;
+
+					case 0x8: alu_reg_reg(X64_AND, X64_RAX, X64_RCX); break;
+					case 0x9: alu_reg_reg(X64_XOR, X64_RAX, X64_RCX); break;
+					case 0xA: alu_reg_reg(X64_CMP, X64_RAX, X64_RCX); break;
+					case 0xB: alu_reg_reg(X64_ADD, X64_RAX, X64_RCX); break;
+					case 0xC: alu_reg_reg(X64_OR, X64_RAX, X64_RCX); break;
+					case 0xD: mov_reg_reg(X64_RAX, X64_RCX); break;
+					case 0xE: unary_reg(X64_NOT, X64_RCX); alu_reg_reg(X64_AND, X64_RAX, X64_RCX); break;
+					case 0xF: unary_reg(X64_NOT, X64_RCX); mov_reg_reg(X64_RAX, X64_RCX); break;
+				}
+
+				//Arithmetic flags come straight from the host. ARM's Carry is the inverse of x86's borrow
+				if((set_condition) && (!logical))
+				{
+					setcc_reg(X64_CC_S, X64_R8);
+					setcc_reg(X64_CC_Z, X64_R9);
+					setcc_reg((subtraction ? X64_CC_NC : X64_CC_C), X64_R10);
+					setcc_reg(X64_CC_O, X64_R11);
+				}
+
+				//TST, TEQ, CMP, and CMN only update flags
+				if((op < 0x8) || (op > 0xB)) { mov_cpu_reg(reg_offset(cpu, dest_reg), X64_RAX); }
+
+				if((set_condition) && (logical))
+				{
+					test_reg_reg(X64_RAX, X64_RAX);
+					setcc_reg(X64_CC_S, X64_R8);
+					setcc_reg(X64_CC_Z, X64_R9);
+					emit_flags(cpu, carry_mode, false);
+				}
+
+				else if(set_condition) { emit_flags(cpu, JIT_CARRY_HOST, true); }
+			}
+
+			break;
+
+		default: return false;
+	}
+
+	emit_cycles(cpu, pass);
+
+	if(condition != 0xE)
+	{
+		u32 done_jump = jmp();
+		bind(skip_jump);
+		emit_cycles(cpu, skip);
+		bind(done_jump);
+	}
+
+	return true;
+}
+
+/****** Recompiles a THUMB instruction - Returns false if it has to call the interpreter ******/
+bool AGB_JIT::compile_thumb(ARM7& cpu, u32 addr, u16 opcode, u8 operation, bool last)
+{
+	cycle_count cycles = { 0, 0, 0, 0 };
+	u8 carry_mode = JIT_CARRY_KEEP;
+
+	switch(operation)
+	{
+		//THUMB.1 - Move Shifted Register
+		case ARM7::THUMB_1:
+			{
+				if(!add_access(cycles, (addr + 4), false)) { return false; }
+
+				mov_reg_cpu(X64_RCX, reg_offset(cpu, ((opcode >> 3) & 0x7)));
+				emit_shift_imm(cpu, X64_RCX, ((opcode >> 11) & 0x3), ((opcode >> 6) & 0x1F), true, carry_mode);
+				mov_cpu_reg(reg_offset(cpu, (opcode & 0x7)), X64_RCX);
+
+				test_reg_reg(X64_RCX, X64_RCX);
+				setcc_reg(X64_CC_S, X64_R8);
+				setcc_reg(X64_CC_Z, X64_R9);
+				emit_flags(cpu, carry_mode, false);
+			}
+
+			break;
+
+		//THUMB.2 - Add-Sub Immediate
+		case ARM7::THUMB_2:
+			{
+				if(!add_access(cycles, (addr + 4), false)) { return false; }
+
+				u8 op = ((opcode >> 9) & 0x3);
+				u8 imm_reg = ((opcode >> 6) & 0x7);
+
+				mov_reg_cpu(X64_RAX, reg_offset(cpu, ((opcode >> 3) & 0x7)));
+
+				if(op & 0x2) { mov_reg_imm(X64_RCX, imm_reg); }
+				else { mov_reg_cpu(X64_RCX, reg_offset(cpu, imm_reg)); }
+
+				alu_reg_reg(((op & 0x1) ? X64_SUB : X64_ADD), X64_RAX, X64_RCX);
+
+				setcc_reg(X64_CC_S, X64_R8);
+				setcc_reg(X64_CC_Z, X64_R9);
+				setcc_reg(((op & 0x1) ? X64_CC_NC : X64_CC_C), X64_R10);
+				setcc_reg(X64_CC_O, X64_R11);
+
+				mov_cpu_reg(reg_offset(cpu, (opcode & 0x7)), X64_RAX);
+				emit_flags(cpu, JIT_CARRY_HOST, true);
+			}
+
+			break;
+
+		//THUMB.3 - Move-Compare-Add-Subtract Immediate
+		case ARM7::THUMB_3:
+			{
+				if(!add_access(cycles, (addr + 4), false)) { return false; }
+
+				u8 op = ((opcode >> 11) & 0x3);
+				u8 dest_reg = ((opcode >> 8) & 0x7);
+				u32 operand = (opcode & 0xFF);
+
+				//MOV - An 8-bit immediate is never negative, so both flags are known already
+				if(op == 0)
+				{
+					s32 cpsr = cpu_offset(cpu, &cpu.reg.cpsr);
+
+					mov_cpu_imm(reg_offset(cpu, dest_reg), operand);
+					mov_reg_cpu(X64_RCX, cpsr);
+					alu_reg_imm(X64_AND, X64_RCX, ~(CPSR_N_FLAG | CPSR_Z_FLAG));
+					if(operand == 0) { alu_reg_imm(X64_OR, X64_RCX, CPSR_Z_FLAG); }
+					mov_cpu_reg(cpsr, X64_RCX);
+					break;
+				}
+
+				mov_reg_cpu(X64_RAX, reg_offset(cpu, dest_reg));
+				mov_reg_imm(X64_RCX, operand);
+				alu_reg_reg(((op == 2) ? X64_ADD : X64_SUB), X64_RAX, X64_RCX);
+
+				setcc_reg(X64_CC_S, X64_R8);
+				setcc_reg(X64_CC_Z, X64_R9);
+				setcc_reg(((op == 2) ? X64_CC_C : X64_CC_NC), X64_R10);
+				setcc_reg(X64_CC_O, X64_R11);
+
+				//CMP does not update the destination
+				if(op != 1) { mov_cpu_reg(reg_offset(cpu, dest_reg), X64_RAX); }
+				emit_flags(cpu, JIT_CARRY_HOST, true);
+			}
+
+			break;
+
+		//THUMB.4 - ALU Operations
+		case ARM7::THUMB_4:
+			{
+				u8 op = ((opcode >> 6) & 0xF);
+				u8 dest_reg = (opcode & 0x7);
+				bool arithmetic = false;
+
+				//Register shifts, ADC, SBC, and MUL go to the interpreter
+				switch(op)
+				{
+					case 0x0: case 0x1: case 0x8: case 0xC: case 0xE: case 0xF: break;
+					case 0x9: case 0xA: case 0xB: arithmetic = true; break;
+					default: return false;
+				}
+
+				if(!add_access(cycles, (addr + 4), false)) { return false; }
+
+				mov_reg_cpu(X64_RCX, reg_offset(cpu, ((opcode >> 3) & 0x7)));
+
+				if(op == 0x9) { mov_reg_imm(X64_RAX, 0); }
+				else if(op != 0xF) { mov_reg_cpu(X64_RAX, reg_offset(cpu, dest_reg)); }
+
+				switch(op)
+				{
+					case 0x0: alu_reg_reg(X64_AND, X64_RAX, X64_RCX); break;
+					case 0x1: alu_reg_reg(X64_XOR, X64_RAX, X64_RCX); break;
+					case 0x8: alu_reg_reg(X64_AND, X64_RAX, X64_RCX); break;
+					case 0x9: alu_reg_reg(X64_SUB, X64_RAX, X64_RCX); break;
+					case 0xA: alu_reg_reg(X64_CMP, X64_RAX, X64_RCX); break;
+					case 0xB: alu_reg_reg(X64_ADD, X64_RAX, X64_RCX); break;
+					case 0xC: alu_reg_reg(X64_OR, X64_RAX, X64_RCX); break;
+					case 0xE: unary_reg(X64_NOT, X64_RCX); alu_reg_reg(X64_AND, X64_RAX, X64_RCX); break;
+					case 0xF: unary_reg(X64_NOT, X64_RCX); mov_reg_reg(X64_RAX, X64_RCX); break;
+				}
+
+				if(arithmetic)
+				{
+					setcc_reg(X64_CC_S, X64_R8);
+					setcc_reg(X64_CC_Z, X64_R9);
+					setcc_reg(((op == 0xB) ? X64_CC_C : X64_CC_NC), X64_R10);
+					setcc_reg(X64_CC_O, X64_R11);
+				}
+
+				//TST, CMP, and CMN only update flags
+				if((op != 0x8) && (op != 0xA) && (op != 0xB)) { mov_cpu_reg(reg_offset(cpu, dest_reg), X64_RAX); }
+
+				if(arithmetic) { emit_flags(cpu, JIT_CARRY_HOST, true); }
+
+				else
+				{
+					test_reg_reg(X64_RAX, X64_RAX);
+					setcc_reg(X64_CC_S, X64_R8);
+					setcc_reg(X64_CC_Z, X64_R9);
+					emit_flags(cpu, JIT_CARRY_KEEP, false);
+				}
+			}
+
+			break;
+
+		//THUMB.12 - Get Relative Address
+		case ARM7::THUMB_12:
+			{
+				if(!add_access(cycles, (addr + 4), false)) { return false; }
+
+				u32 offset = (opcode & 0xFF) << 2;
+				u8 dest_reg = ((opcode >> 8) & 0x7);
+
+				//Rd = PC + nn
+				if((opcode & 0x800) == 0) { mov_cpu_imm(reg_offset(cpu, dest_reg), (((addr + 4) & ~0x2) + offset)); }
+
+				//Rd = SP + nn
+				else
+				{
+					mov_reg_cpu(X64_RAX, reg_offset(cpu, 13));
+					alu_reg_imm(X64_ADD, X64_RAX, offset);
+					mov_cpu_reg(reg_offset(cpu, dest_reg), X64_RAX);
+				}
+			}
+
+			break;
+
+		//THUMB.13 - Add Offset to Stack Pointer
+		case ARM7::THUMB_13:
+			{
+				if(!add_access(cycles, (addr + 4), false)) { return false; }
+
+				u32 offset = (opcode & 0x7F) << 2;
+
+				mov_reg_cpu(X64_RAX, reg_offset(cpu, 13));
+				alu_reg_imm(((opcode & 0x80) ? X64_SUB : X64_ADD), X64_RAX, offset);
+				mov_cpu_reg(reg_offset(cpu, 13), X64_RAX);
+			}
+
+			break;
+
+		//THUMB.16 - Conditional Branch
+		case ARM7::THUMB_16:
+			{
+				u8 condition = ((opcode >> 8) & 0xF);
+				if((!last) || (condition >= 0xE)) { return false; }
+
+				u32 target = addr + 4 + (s32(s8(opcode & 0xFF)) * 2);
+				cycle_count skip = { 0, 0, 0, 0 };
+
+				//Taken - 1N + 2S, Not taken - 1S
+				if(!add_access(cycles, (addr + 4), true)) { return false; }
+				if(!add_access(cycles, target, false)) { return false; }
+				if(!add_access(cycles, (target + 2), false)) { return false; }
+				if(!add_access(skip, (addr + 4), false)) { return false; }
+
+				u32 skip_jump = 0;
+				emit_condition(cpu, condition, skip_jump);
+
+				mov_cpu_imm(cpu_offset(cpu, &cpu.reg.r15), target);
+				mov_cpu_imm8(cpu_offset(cpu, &cpu.needs_flush), 1);
+				emit_cycles(cpu, cycles);
+
+				u32 done_jump = jmp();
+				bind(skip_jump);
+				emit_cycles(cpu, skip);
+				bind(done_jump);
+			}
+
+			return true;
+
+		//THUMB.18 - Unconditional Branch
+		case ARM7::THUMB_18:
+			{
+				if(!last) { return false; }
+
+				u32 target = addr + 4 + (s32(u32(opcode & 0x7FF) << 21) >> 20);
+
+				//1N + 2S
+				if(!add_access(cycles, (addr + 4), true)) { return false; }
+				if(!add_access(cycles, target, false)) { return false; }
+				if(!add_access(cycles, (target + 2), false)) { return false; }
+
+				mov_cpu_imm(cpu_offset(cpu, &cpu.reg.r15), target);
+				mov_cpu_imm8(cpu_offset(cpu, &cpu.needs_flush), 1);
+			}
+
+			break;
+
+		default: return false;
+	}
+
+	emit_cycles(cpu, cycles);
+	return true;
+}
+
+/****** Calls the interpreter handler for an instruction that is not recompiled ******/
+void AGB_JIT::compile_fallback(ARM7& cpu, agb_code_block& block, u32 index)
+{
+	u32 addr = block.start_addr + (index * (block.thumb ? 2 : 4));
+
+	emit_pipeline(cpu, block, index);
+
+	mov_reg64_reg64(JIT_ARG_0, JIT_CPU);
+	mov_reg_reg(JIT_ARG_1, JIT_CYCLES);
+	mov_reg_reg(JIT_ARG_2, JIT_ACCESS_CYCLES);
+	mov_reg_imm(JIT_ARG_3, addr);
+	call((void*)&jit_fallback);
+
+	emit_resume();
+}
+
+/****** Stores an instruction and the two after it in the pipeline, as the interpreter has them while executing it ******/
+void AGB_JIT::emit_pipeline(ARM7& cpu, agb_code_block& block, u32 index)
+{
+	for(u32 x = 0; x < 3; x++)
+	{
+		s32 operation = cpu_offset(cpu, &cpu.instruction_operation[x]);
+
+		//Instructions past the end of the block are marked for fetching from memory
+		if((index + x) >= block.opcode.size())
+		{
+			mov_cpu_imm(operation, ARM7::PIPELINE_FILL);
+			continue;
+		}
+
+		mov_cpu_imm(cpu_offset(cpu, &cpu.instruction_pipeline[x]), block.opcode[index + x]);
+		mov_cpu_imm(operation, block.operation[index + x]);
+	}
+}
+
+/****** Adds one memory access to an instruction's cycles, see ARM7::clock() - Returns false if it depends on the LCD ******/
+bool AGB_JIT::add_access(cycle_count& cycles, u32 access_addr, bool first_access)
+{
+	//VRAM timing changes with the LCD mode, which is only up to date when controllers have caught up
+	if((access_addr >= 0x5000000) && (access_addr <= 0x70003FF)) { return false; }
+
+	cycles.access++;
+
+	//Wait State 0 - Read from the current WAITCNT settings
+	if((access_addr >= 0x8000000) && (access_addr <= 0x9FFFFFF))
+	{
+		if(first_access) { cycles.n_access++; }
+		else { cycles.s_access++; }
+	}
+
+	return true;
+}
+
+/****** Adds an instruction's cycles to the pending cycles ******/
+void AGB_JIT::emit_cycles(ARM7& cpu, const cycle_count& cycles)
+{
+	if(cycles.n_access)
+	{
+		movzx_reg_abs8(X64_RAX, &cpu.mem->n_clock);
+
+		for(u32 x = 0; x < cycles.n_access; x++)
+		{
+			alu_reg_reg(X64_ADD, JIT_CYCLES, X64_RAX);
+			alu_reg_reg(X64_ADD, JIT_ACCESS_CYCLES, X64_RAX);
+		}
+	}
+
+	if(cycles.s_access)
+	{
+		movzx_reg_abs8(X64_RAX, &cpu.mem->s_clock);
+
+		for(u32 x = 0; x < cycles.s_access; x++)
+		{
+			alu_reg_reg(X64_ADD, JIT_CYCLES, X64_RAX);
+			alu_reg_reg(X64_ADD, JIT_ACCESS_CYCLES, X64_RAX);
+		}
+	}
+
+	if(cycles.internal + cycles.access) { alu_reg_imm(X64_ADD, JIT_CYCLES, (cycles.internal + cycles.access)); }
+	if(cycles.access) { alu_reg_imm(X64_ADD, JIT_ACCESS_CYCLES, cycles.access); }
+}
+
+/****** Runs controllers once pending cycles reach the next event ******/
+void AGB_JIT::emit_cycle_check(ARM7& cpu, agb_code_block& block, u32 index)
+{
+	alu_reg_reg(X64_CMP, JIT_CYCLES, JIT_BUDGET);
+	u32 skip_jump = jcc(X64_CC_C);
+
+	emit_pipeline(cpu, block, index);
+
+	mov_reg64_reg64(JIT_ARG_0, JIT_CPU);
+	mov_reg_reg(JIT_ARG_1, JIT_CYCLES);
+	mov_reg_reg(JIT_ARG_2, JIT_ACCESS_CYCLES);
+	mov_reg_imm(JIT_ARG_3, (block.start_addr + (index * (block.thumb ? 2 : 4))));
+	call((void*)&jit_sync);
+
+	emit_resume();
+	bind(skip_jump);
+}
+
+/****** Picks up after a helper ran controllers - Leaves the block if it returned 0, otherwise takes the new budget ******/
+void AGB_JIT::emit_resume()
+{
+	alu_reg_reg(X64_XOR, JIT_CYCLES, JIT_CYCLES);
+	alu_reg_reg(X64_XOR, JIT_ACCESS_CYCLES, JIT_ACCESS_CYCLES);
+
+	test_reg_reg(X64_RAX, X64_RAX);
+	exit_jumps.push_back(jcc(X64_CC_Z));
+
+	mov_reg_reg(JIT_BUDGET, X64_RAX);
+}
+
+/****** Jumps ahead when an ARM condition fails ******/
+void AGB_JIT::emit_condition(ARM7& cpu, u8 condition, u32& skip_jump)
+{
+	//Build a lookup mask of every NZCV combination that passes
+	u32 pass_mask = 0;
+
+	for(u32 flags = 0; flags < 16; flags++)
+	{
+		if(arm_alu<ARM_V4T>::check_condition((flags << 28), (u32(condition) << 28))) { pass_mask |= (1 << flags); }
+	}
+
+	mov_reg_cpu(X64_RAX, cpu_offset(cpu, &cpu.reg.cpsr));
+	shift_reg_imm(X64_SHR, X64_RAX, 28);
+	mov_reg_imm(X64_RDX, pass_mask);
+	bt_reg_reg(X64_RDX, X64_RAX);
+	skip_jump = jcc(X64_CC_NC);
+}
+
+/****** Shifts a register by an immediate, see ARM7::logical_shift_left() and friends ******/
+void AGB_JIT::emit_shift_imm(ARM7& cpu, u8 reg, u8 shift_type, u8 amount, bool capture_carry, u8& carry_mode)
+{
+	switch(shift_type)
+	{
+		//LSL - LSL #0 leaves the Carry flag alone
+		case 0x0:
+			if(amount == 0) { return; }
+			shift_reg_imm(X64_SHL, reg, amount);
+			break;
+
+		//LSR - LSR #0 is LSR #32
+		case 0x1:
+			if(amount == 0)
+			{
+				bt_reg_imm(reg, 31);
+				if(capture_carry) { setcc_reg(X64_CC_C, X64_R10); }
+				alu_reg_reg(X64_XOR, reg, reg);
+				carry_mode = capture_carry ? JIT_CARRY_HOST : carry_mode;
+				return;
+			}
+
+			shift_reg_imm(X64_SHR, reg, amount);
+			break;
+
+		//ASR - ASR #0 is ASR #32
+		case 0x2:
+			if(amount == 0)
+			{
+				bt_reg_imm(reg, 31);
+				if(capture_carry) { setcc_reg(X64_CC_C, X64_R10); }
+				shift_reg_imm(X64_SAR, reg, 31);
+				carry_mode = capture_carry ? JIT_CARRY_HOST : carry_mode;
+				return;
+			}
+
+			shift_reg_imm(X64_SAR, reg, amount);
+			break;
+
+		//ROR - ROR #0 is RRX, rotating the old Carry flag into Bit 31
+		case 0x3:
+			if(amount == 0)
+			{
+				bt_cpu_imm(cpu_offset(cpu, &cpu.reg.cpsr), 29);
+				shift_reg_imm(X64_RCR, reg, 1);
+			}
+
+			else { shift_reg_imm(X64_ROR, reg, amount); }
+			break;
+	}
+
+	//x86 leaves the last bit shifted out in its Carry flag, same as ARM
+	if(capture_carry)
+	{
+		setcc_reg(X64_CC_C, X64_R10);
+		carry_mode = JIT_CARRY_HOST;
+	}
+}
+
+/****** Writes N and Z (R8B, R9B), C (R10B or a constant), and V (R11B) into the CPSR ******/
+void AGB_JIT::emit_flags(ARM7& cpu, u8 carry_mode, bool overflow)
+{
+	s32 cpsr = cpu_offset(cpu, &cpu.reg.cpsr);
+	u32 flag_mask = CPSR_N_FLAG | CPSR_Z_FLAG;
+
+	movzx_reg_reg8(X64_RDX, X64_R8);
+	shift_reg_imm(X64_SHL, X64_RDX, 31);
+	movzx_reg_reg8(X64_RCX, X64_R9);
+	shift_reg_imm(X64_SHL, X64_RCX, 30);
+	alu_reg_reg(X64_OR, X64_RDX, X64_RCX);
+
+	switch(carry_mode)
+	{
+		case JIT_CARRY_HOST:
+			movzx_reg_reg8(X64_RCX, X64_R10);
+			shift_reg_imm(X64_SHL, X64_RCX, 29);
+			alu_reg_reg(X64_OR, X64_RDX, X64_RCX);
+			flag_mask |= CPSR_C_FLAG;
+			break;
+
+		case JIT_CARRY_SET:
+			alu_reg_imm(X64_OR, X64_RDX, CPSR_C_FLAG);
+			flag_mask |= CPSR_C_FLAG;
+			break;
+
+		case JIT_CARRY_CLEAR:
+			flag_mask |= CPSR_C_FLAG;
+			break;
+	}
+
+	if(overflow)
+	{
+		movzx_reg_reg8(X64_RCX, X64_R11);
+		shift_reg_imm(X64_SHL, X64_RCX, 28);
+		alu_reg_reg(X64_OR, X64_RDX, X64_RCX);
+		flag_mask |= CPSR_V_FLAG;
+	}
+
+	mov_reg_cpu(X64_RCX, cpsr);
+	alu_reg_imm(X64_AND, X64_RCX, ~flag_mask);
+	alu_reg_reg(X64_OR, X64_RCX, X64_RDX);
+	mov_cpu_reg(cpsr, X64_RCX);
+}
+
+/****** Returns where a register lives for the current CPU mode, relative to the CPU ******/
+s32 AGB_JIT::reg_offset(ARM7& cpu, u8 index)
+{
+	ARM7::registers& reg = cpu.reg;
+	bool fiq = (cpu.current_cpu_mode == ARM7::FIQ);
+
+	if(index >= 8) { uses_banked_regs = true; }
+
+	switch(index)
+	{
+		case 0: return cpu_offset(cpu, &reg.r0);
+		case 1: return cpu_offset(cpu, &reg.r1);
+		case 2: return cpu_offset(cpu, &reg.r2);
+		case 3: return cpu_offset(cpu, &reg.r3);
+		case 4: return cpu_offset(cpu, &reg.r4);
+		case 5: return cpu_offset(cpu, &reg.r5);
+		case 6: return cpu_offset(cpu, &reg.r6);
+		case 7: return cpu_offset(cpu, &reg.r7);
+		case 8: return cpu_offset(cpu, (fiq ? &reg.r8_fiq : &reg.r8));
+		case 9: return cpu_offset(cpu, (fiq ? &reg.r9_fiq : &reg.r9));
+		case 10: return cpu_offset(cpu, (fiq ? &reg.r10_fiq : &reg.r10));
+		case 11: return cpu_offset(cpu, (fiq ? &reg.r11_fiq : &reg.r11));
+		case 12: return cpu_offset(cpu, (fiq ? &reg.r12_fiq : &reg.r12));
+
+		case 13:
+			switch(cpu.current_cpu_mode)
+			{
+				case ARM7::FIQ: return cpu_offset(cpu, &reg.r13_fiq);
+				case ARM7::SVC: return cpu_offset(cpu, &reg.r13_svc);
+				case ARM7::ABT: return cpu_offset(cpu, &reg.r13_abt);
+				case ARM7::IRQ: return cpu_offset(cpu, &reg.r13_irq);
+				case ARM7::UND: return cpu_offset(cpu, &reg.r13_und);
+				default: return cpu_offset(cpu, &reg.r13);
+			}
+
+		case 14:
+			switch(cpu.current_cpu_mode)
+			{
+				case ARM7::FIQ: return cpu_offset(cpu, &reg.r14_fiq);
+				case ARM7::SVC: return cpu_offset(cpu, &reg.r14_svc);
+				case ARM7::ABT: return cpu_offset(cpu, &reg.r14_abt);
+				case ARM7::IRQ: return cpu_offset(cpu, &reg.r14_irq);
+				case ARM7::UND: return cpu_offset(cpu, &reg.r14_und);
+				default: return cpu_offset(cpu, &reg.r14);
+			}
+
+		default: return cpu_offset(cpu, &reg.r15);
+	}
+}
+
+/****** Returns where a CPU field lives, relative to the CPU ******/
+s32 AGB_JIT::cpu_offset(ARM7& cpu, void* field)
+{
+	return s32((u8*)field - (u8*)&cpu);
+}
+
+/****** x86-64 emitter ******/
+void AGB_JIT::emit_u8(u8 value) { code.push_back(value); }
+
+void AGB_JIT::emit_u32(u32 value)
+{
+	for(u32 x = 0; x < 4; x++) { code.push_back(value >> (x * 8)); }
+}
+
+void AGB_JIT::emit_u64(u64 value)
+{
+	for(u32 x = 0; x < 8; x++) { code.push_back(value >> (x * 8)); }
+}
+
+/****** Emits a REX prefix when needed - Byte registers SPL through DIL always need one ******/
+void AGB_JIT::emit_rex(bool wide, u8 reg, u8 rm, bool byte_reg)
+{
+	u8 rex = 0x40 | (wide ? 0x8 : 0) | ((reg & 0x8) ? 0x4 : 0) | ((rm & 0x8) ? 0x1 : 0);
+	if((rex != 0x40) || (byte_reg)) { emit_u8(rex); }
+}
+
+void AGB_JIT::emit_modrm_reg(u8 reg, u8 rm) { emit_u8(0xC0 | ((reg & 0x7) << 3) | (rm & 0x7)); }
+
+/****** Addresses [RBX + offset] ******/
+void AGB_JIT::emit_modrm_cpu(u8 reg, s32 offset)
+{
+	emit_u8(0x80 | ((reg & 0x7) << 3) | X64_RBX);
+	emit_u32(offset);
+}
+
+void AGB_JIT::mov_reg_cpu(u8 reg, s32 offset) { emit_rex(false, reg, X64_RBX, false); emit_u8(0x8B); emit_modrm_cpu(reg, offset); }
+void AGB_JIT::mov_cpu_reg(s32 offset, u8 reg) { emit_rex(false, reg, X64_RBX, false); emit_u8(0x89); emit_modrm_cpu(reg, offset); }
+void AGB_JIT::mov_cpu_imm(s32 offset, u32 value) { emit_u8(0xC7); emit_modrm_cpu(0, offset); emit_u32(value); }
+void AGB_JIT::mov_cpu_imm8(s32 offset, u8 value) { emit_u8(0xC6); emit_modrm_cpu(0, offset); emit_u8(value); }
+void AGB_JIT::mov_reg_imm(u8 reg, u32 value) { emit_rex(false, 0, reg, false); emit_u8(0xB8 | (reg & 0x7)); emit_u32(value); }
+void AGB_JIT::mov_reg_reg(u8 dst, u8 src) { emit_rex(false, src, dst, false); emit_u8(0x89); emit_modrm_reg(src, dst); }
+void AGB_JIT::mov_reg64_reg64(u8 dst, u8 src) { emit_rex(true, src, dst, false); emit_u8(0x89); emit_modrm_reg(src, dst); }
+
+/****** Loads a byte from anywhere in host memory - Clobbers RAX ******/
+void AGB_JIT::movzx_reg_abs8(u8 reg, void* address)
+{
+	emit_u8(0x48);
+	emit_u8(0xB8);
+	emit_u64(u64(address));
+
+	emit_rex(false, reg, X64_RAX, false);
+	emit_u8(0x0F);
+	emit_u8(0xB6);
+	emit_u8((reg & 0x7) << 3);
+}
+
+void AGB_JIT::movzx_reg_reg8(u8 dst, u8 src) { emit_rex(false, dst, src, (src >= 4)); emit_u8(0x0F); emit_u8(0xB6); emit_modrm_reg(dst, src); }
+void AGB_JIT::alu_reg_reg(u8 op, u8 dst, u8 src) { emit_rex(false, src, dst, false); emit_u8((op << 3) | 0x1); emit_modrm_reg(src, dst); }
+void AGB_JIT::alu_reg_imm(u8 op, u8 dst, u32 value) { emit_rex(false, 0, dst, false); emit_u8(0x81); emit_modrm_reg(op, dst); emit_u32(value); }
+void AGB_JIT::test_reg_reg(u8 dst, u8 src) { emit_rex(false, src, dst, false); emit_u8(0x85); emit_modrm_reg(src, dst); }
+void AGB_JIT::shift_reg_imm(u8 op, u8 reg, u8 amount) { emit_rex(false, 0, reg, false); emit_u8(0xC1); emit_modrm_reg(op, reg); emit_u8(amount); }
+void AGB_JIT::unary_reg(u8 op, u8 reg) { emit_rex(false, 0, reg, false); emit_u8(0xF7); emit_modrm_reg(op, reg); }
+void AGB_JIT::bt_cpu_imm(s32 offset, u8 bit) { emit_u8(0x0F); emit_u8(0xBA); emit_modrm_cpu(4, offset); emit_u8(bit); }
+void AGB_JIT::bt_reg_imm(u8 reg, u8 bit) { emit_rex(false, 0, reg, false); emit_u8(0x0F); emit_u8(0xBA); emit_modrm_reg(4, reg); emit_u8(bit); }
+void AGB_JIT::bt_reg_reg(u8 reg, u8 bit_reg) { emit_rex(false, bit_reg, reg, false); emit_u8(0x0F); emit_u8(0xA3); emit_modrm_reg(bit_reg, reg); }
+void AGB_JIT::setcc_reg(u8 condition, u8 reg) { emit_rex(false, 0, reg, (reg >= 4)); emit_u8(0x0F); emit_u8(0x90 | condition); emit_modrm_reg(0, reg); }
+void AGB_JIT::cmc() { emit_u8(0xF5); }
+
+/****** Emits a conditional jump - Returns its position so it can be bound later ******/
+u32 AGB_JIT::jcc(u8 condition)
+{
+	emit_u8(0x0F);
+	emit_u8(0x80 | condition);
+	emit_u32(0);
+	return code.size() - 4;
+}
+
+/****** Emits a jump - Returns its position so it can be bound later ******/
+u32 AGB_JIT::jmp()
+{
+	emit_u8(0xE9);
+	emit_u32(0);
+	return code.size() - 4;
+}
+
+/****** Points a jump at the current position ******/
+void AGB_JIT::bind(u32 jump)
+{
+	u32 offset = code.size() - (jump + 4);
+	for(u32 x = 0; x < 4; x++) { code[jump + x] = (offset >> (x * 8)); }
+}
+
+/****** Calls a helper through RAX ******/
+void AGB_JIT::call(void* function)
+{
+	emit_u8(0x48);
+	emit_u8(0xB8);
+	emit_u64(u64(function));
+
+	emit_u8(0xFF);
+	emit_u8(0xD0);
+}
+
+void AGB_JIT::push_reg(u8 reg) { emit_rex(false, 0, reg, false); emit_u8(0x50 | (reg & 0x7)); }
+void AGB_JIT::pop_reg(u8 reg) { emit_rex(false, 0, reg, false); emit_u8(0x58 | (reg & 0x7)); }
+
+/****** Reserves or releases shadow space for calls - Four pushes plus 40 bytes keep RSP 16-byte aligned ******/
+void AGB_JIT::stack_frame(bool enter)
+{
+	emit_u8(0x48);
+	emit_u8(0x83);
+	emit_u8(enter ? 0xEC : 0xC4);
+	emit_u8(0x28);
+}
+
+#else
+
+/****** JIT Constructor - Builds without the recompiler always use the interpreter ******/
+AGB_JIT::AGB_JIT()
+{
+	enable = false;
+	code_buffer = nullptr;
+	code_pos = 0;
+	entry_generation = 0;
+	entry_cpu_mode = 0;
+	entry_arm_mode = 0;
+	uses_banked_regs = false;
+}
+
+/****** JIT Destructor ******/
+AGB_JIT::~AGB_JIT() { }
+
+/****** Runs a recompiled block - Never happens without the recompiler ******/
+bool AGB_JIT::run_block(ARM7& cpu) { return false; }
+
+#endif // GBE_JIT
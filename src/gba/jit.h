@@ -0,0 +1,124 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : jit.h
+// Date : October 17, 2026
+// Description : GBA x86-64 recompiler
+//
+// Translates hot blocks from the code block cache into x86-64 host code
+// Data processing and branches run natively, every other instruction calls its interpreter handler
+
+#ifndef GBA_JIT
+#define GBA_JIT
+
+#include <vector>
+
+#include "common.h"
+#include "block_cache.h"
+
+class ARM7;
+
+//Blocks are recompiled once they have been entered this many times
+#define JIT_COMPILE_THRESHOLD 8
+
+//Host code buffer size, and the most space a single block may take
+#define JIT_BUFFER_SIZE 0x800000
+#define JIT_MAX_BLOCK_SIZE 0x10000
+
+class AGB_JIT
+{
+	public:
+
+	//Recompiled blocks take the CPU and the number of cycles until the next controller event
+	typedef void (*host_block)(ARM7* cpu, u32 cycle_budget);
+
+	bool enable;
+
+	//CPU state when the running block was entered - Blocks exit as soon as any of it changes
+	u32 entry_generation;
+	u8 entry_cpu_mode;
+	u8 entry_arm_mode;
+
+	AGB_JIT();
+	~AGB_JIT();
+
+	bool run_block(ARM7& cpu);
+
+	private:
+
+	//Executable memory holding every recompiled block
+	u8* code_buffer;
+	u32 code_pos;
+
+	//Block currently being recompiled
+	std::vector<u8> code;
+	std::vector<u32> exit_jumps;
+	bool uses_banked_regs;
+
+	//Cycles for one path through an instruction, matching its ARM7::clock() calls
+	struct cycle_count
+	{
+		u32 internal;
+		u32 access;
+		u8 n_access;
+		u8 s_access;
+	};
+
+	bool compile(ARM7& cpu, agb_code_block& block);
+	void flush_buffer(ARM7& cpu);
+
+	//Instruction translation
+	bool compile_arm(ARM7& cpu, u32 addr, u32 opcode, u8 operation, bool last);
+	bool compile_thumb(ARM7& cpu, u32 addr, u16 opcode, u8 operation, bool last);
+	void compile_fallback(ARM7& cpu, agb_code_block& block, u32 index);
+	void emit_pipeline(ARM7& cpu, agb_code_block& block, u32 index);
+
+	bool add_access(cycle_count& cycles, u32 access_addr, bool first_access);
+	void emit_cycles(ARM7& cpu, const cycle_count& cycles);
+	void emit_cycle_check(ARM7& cpu, agb_code_block& block, u32 index);
+	void emit_resume();
+	void emit_condition(ARM7& cpu, u8 condition, u32& skip_jump);
+	void emit_shift_imm(ARM7& cpu, u8 reg, u8 shift_type, u8 amount, bool capture_carry, u8& carry_mode);
+	void emit_flags(ARM7& cpu, u8 carry_mode, bool overflow);
+
+	s32 reg_offset(ARM7& cpu, u8 index);
+	s32 cpu_offset(ARM7& cpu, void* field);
+
+	//x86-64 emitter
+	void emit_u8(u8 value);
+	void emit_u32(u32 value);
+	void emit_u64(u64 value);
+	void emit_rex(bool wide, u8 reg, u8 rm, bool byte_reg);
+	void emit_modrm_reg(u8 reg, u8 rm);
+	void emit_modrm_cpu(u8 reg, s32 offset);
+
+	void mov_reg_cpu(u8 reg, s32 offset);
+	void mov_cpu_reg(s32 offset, u8 reg);
+	void mov_cpu_imm(s32 offset, u32 value);
+	void mov_cpu_imm8(s32 offset, u8 value);
+	void mov_reg_imm(u8 reg, u32 value);
+	void mov_reg_reg(u8 dst, u8 src);
+	void mov_reg64_reg64(u8 dst, u8 src);
+	void movzx_reg_abs8(u8 reg, void* address);
+	void movzx_reg_reg8(u8 dst, u8 src);
+	void alu_reg_reg(u8 op, u8 dst, u8 src);
+	void alu_reg_imm(u8 op, u8 dst, u32 value);
+	void test_reg_reg(u8 dst, u8 src);
+	void shift_reg_imm(u8 op, u8 reg, u8 amount);
+	void unary_reg(u8 op, u8 reg);
+	void bt_cpu_imm(s32 offset, u8 bit);
+	void bt_reg_imm(u8 reg, u8 bit);
+	void bt_reg_reg(u8 reg, u8 bit_reg);
+	void setcc_reg(u8 condition, u8 reg);
+	void cmc();
+	u32 jcc(u8 condition);
+	u32 jmp();
+	void bind(u32 jump);
+	void call(void* function);
+	void push_reg(u8 reg);
+	void pop_reg(u8 reg);
+	void stack_frame(bool enter);
+};
+
+#endif // GBA_JIT
@@ -9,7 +9,9 @@
 // Draws background, window, and sprites to screen
 // Responsible for blitting pixel data and limiting frame rate
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include "lcd.h"
 #include "common/util.h"
@@ -18,14 +20,29 @@
 AGB_LCD::AGB_LCD()
 {
 	window = nullptr;
+
+	render_worker = nullptr;
+	render_thread = nullptr;
+	render_lock = nullptr;
+	render_signal = nullptr;
+	is_render_worker = false;
+
 	reset();
 }
 
 /****** LCD Destructor ******/
 AGB_LCD::~AGB_LCD()
 {
+	//The MMU may already be gone, so leave its VRAM bitmap alone
+	mem = nullptr;
+	stop_render_thread();
+
 	screen_buffer.clear();
 	scanline_buffer.clear();
+
+	//The render worker never owns a window or OpenGL context
+	if(is_render_worker) { return; }
+
 	SDL_DestroyWindow(window);
 
 	#ifdef GBE_OGL
@@ -45,6 +62,17 @@ void AGB_LCD::reset()
 	if((window != nullptr) && (config::sdl_render)) { SDL_DestroyWindow(window); }
 	window = nullptr;
 
+	stop_render_thread();
+	render_vram = nullptr;
+	render_vram_dirty = nullptr;
+	memset(worker_vram_dirty, 0xFF, sizeof(worker_vram_dirty));
+
+	render_lines_submitted = 0;
+	render_lines_drawn = 0;
+	render_thread_quit = false;
+	render_obj_update = true;
+	render_pal_update = true;
+
 	scanline_buffer.clear();
 	screen_buffer.clear();
 
@@ -54,7 +82,9 @@ void AGB_LCD::reset()
 	frame_start_time = 0;
 	frame_current_time = 0;
 	fps_count = 0;
+	frame_count = 0;
 	fps_time = 0;
+	frame_skip.reset();
 
 	for(u32 x = 0; x < 60; x++)
 	{
@@ -69,6 +99,14 @@ void AGB_LCD::reset()
 
 	screen_buffer.resize(0x9600, 0);
 	scanline_buffer.resize(0x100, 0);
+	tile_cache.assign(0x40000, 0);
+
+	for(u32 x = 0; x < 256; x++)
+	{
+		sfx_line_type[x] = NORMAL;
+		sfx_line_target_1[x] = 0;
+		sfx_line_target_2[x] = 0;
+	}
 
 	//Initialize various LCD status variables
 	lcd_stat.oam_update = true;
@@ -277,7 +315,7 @@ bool AGB_LCD::init()
 		final_screen = SDL_CreateRGBSurface(SDL_SWSURFACE, config::sys_width, config::sys_height, 32, 0, 0, 0, 0);
 	}
 
-	std::cout<<"LCD::Initialized\n";
+	std::cout<<"LCD::Initialized - " << sfx_kernel_name() << " SFX kernels\n";
 
 	return true;
 }
@@ -420,6 +458,8 @@ void AGB_LCD::update_oam()
 
 	//Update render list for the current scanline
 	update_obj_render_list();
+
+	render_obj_update = true;
 }
 
 /****** Updates the size and position of OBJs from affine transformation ******/
@@ -514,6 +554,8 @@ void AGB_LCD::update_obj_render_list()
 /****** Updates palette entries when values in memory change ******/
 void AGB_LCD::update_palettes()
 {
+	render_pal_update = true;
+
 	//Update BG palettes
 	if(lcd_stat.bg_pal_update)
 	{
@@ -573,47 +615,98 @@ void AGB_LCD::update_palettes()
 	}
 }
 
-/****** Determines if a sprite pixel should be rendered, and if so draws it to the current scanline pixel ******/
-bool AGB_LCD::render_sprite_pixel()
+/****** Draws every sprite on the current line to the OBJ line buffer ******/
+void AGB_LCD::render_obj_line()
 {
+	for(u32 x = 0; x < 240; x++)
+	{
+		obj_line_opaque[x] = false;
+		obj_line_win[x] = false;
+		obj_line_priority[x] = 0xFF;
+		obj_line_mode[x] = 0;
+	}
+
 	//If sprites are disabled, quit now
-	if((lcd_stat.display_control & 0x1000) == 0) { return false; }
+	if((lcd_stat.display_control & 0x1000) == 0) { return; }
 
 	//If no sprites are rendered on this line, quit now
-	if(obj_render_length == 0) { return false; }
+	if(obj_render_length == 0) { return; }
+
+	//Hardware fetches OBJs in OAM order, anything past the line's rendering cycles is dropped
+	//1210 cycles are available per line, 954 if OAM access during H-Blank is enabled
+	bool obj_on_line[128];
+	for(u32 x = 0; x < 128; x++) { obj_on_line[x] = false; }
+	for(u32 x = 0; x < obj_render_length; x++) { obj_on_line[obj_render_list[x]] = true; }
+
+	s32 obj_cycles = (lcd_stat.display_control & 0x20) ? 954 : 1210;
+
+	for(u32 x = 0; x < 128; x++)
+	{
+		if(!obj_on_line[x]) { continue; }
+
+		//Normal OBJs take 1 cycle per pixel, affine OBJs take 2 per pixel of their bounding area plus 10
+		if(obj[x].affine_enable) { obj_cycles -= (10 + ((obj[x].width << obj[x].type) * 2)); }
+		else { obj_cycles -= obj[x].width; }
+
+		if(obj_cycles < 0) { obj_on_line[x] = false; }
+	}
+
+	//Draw OBJs from highest to lowest priority, the first opaque pixel wins
+	//OBJ Window sprites never occupy pixels, they only mark where the window is
+	for(u32 x = 0; x < obj_render_length; x++)
+	{
+		u8 sprite_id = obj_render_list[x];
 
-	u8 sprite_id = 0;
-	u32 sprite_tile_addr = 0;
-	u32 meta_sprite_tile = 0;
-	u8 raw_color = 0;
+		if(!obj_on_line[sprite_id]) { continue; }
+
+		//For bitmap BG Modes 3-5, skip rendering tile numbers lower than 512
+		if((lcd_stat.bg_mode >= 0x3) && (obj[sprite_id].tile_number < 512)) { continue; }
+
+		render_obj_sprite(sprite_id);
+	}
+}
+
+/****** Draws a single sprite's pixels on the current line to the OBJ line buffer ******/
+void AGB_LCD::render_obj_sprite(u8 sprite_id)
+{
+	u8* vram = render_vram;
+	bool obj_win = (obj[sprite_id].mode == 2);
+
+	//Find the span of the line covered by this sprite
+	//Sprites wrapping off the right edge always start past X = 240, so only their left part is ever visible
+	u32 first_x = obj[sprite_id].x_wrap ? 0 : obj[sprite_id].left;
+	u32 last_x = (obj[sprite_id].right > 239) ? 239 : obj[sprite_id].right;
 
 	u16 sprite_tile_pixel_x = 0;
 	u16 sprite_tile_pixel_y = 0;
 
-	bool render_obj;
-	bool final_render = false;
-
-	//Cycle through all sprites that are rendering on this pixel, draw them according to their priority
-	for(int x = 0; x < obj_render_length; x++)
+	//Normal sprites use the same row for the whole line
+	if(!obj[sprite_id].affine_enable)
 	{
-		sprite_id = obj_render_list[x];
-		render_obj = true;
+		sprite_tile_pixel_y = obj[sprite_id].y_wrap ? (current_scanline + obj[sprite_id].y_wrap_val) : (current_scanline - obj[sprite_id].y);
 
-		if((final_render) && (obj[sprite_id].mode != 2)) { continue; }
+		//Vertical flip the internal Y coordinate
+		if(obj[sprite_id].v_flip)
+		{
+			s16 v_flip = sprite_tile_pixel_y;
+			v_flip -= (obj[sprite_id].height - 1);
 
-		//Check to see if current_scanline_pixel is within sprite
-		if((!obj[sprite_id].x_wrap) && ((scanline_pixel_counter < obj[sprite_id].left) || (scanline_pixel_counter > obj[sprite_id].right))) { continue; }
-		else if((obj[sprite_id].x_wrap) && ((scanline_pixel_counter > obj[sprite_id].right) && (scanline_pixel_counter < obj[sprite_id].left))) { continue; }
+			if(v_flip < 0) { v_flip *= -1; }
 
-		//For bitmap BG Modes 3-5, skip rendering tile numbers lower than 512
-		else if((lcd_stat.bg_mode >= 0x3) && (obj[sprite_id].tile_number < 512)) { continue; }
+			sprite_tile_pixel_y = v_flip;
+		}
+	}
+
+	for(u32 scanline_x = first_x; scanline_x <= last_x; scanline_x++)
+	{
+		//Pixels already covered by a higher priority sprite are only checked by the OBJ Window
+		if((!obj_win) && (obj_line_opaque[scanline_x])) { continue; }
 
 		//Normal sprite rendering
 		if(!obj[sprite_id].affine_enable)
 		{
-			//Determine the internal X-Y coordinates of the sprite's pixel
-			sprite_tile_pixel_x = obj[sprite_id].x_wrap ? (scanline_pixel_counter + obj[sprite_id].x_wrap_val) : (scanline_pixel_counter - obj[sprite_id].x);
-			sprite_tile_pixel_y = obj[sprite_id].y_wrap ? (current_scanline + obj[sprite_id].y_wrap_val) : (current_scanline - obj[sprite_id].y);
+			//Determine the internal X coordinate of the sprite's pixel
+			sprite_tile_pixel_x = obj[sprite_id].x_wrap ? (scanline_x + obj[sprite_id].x_wrap_val) : (scanline_x - obj[sprite_id].x);
 
 			//Horizontal flip the internal X coordinate
 			if(obj[sprite_id].h_flip)
@@ -625,17 +718,6 @@ bool AGB_LCD::render_sprite_pixel()
 
 				sprite_tile_pixel_x = h_flip;
 			}
-
-			//Vertical flip the internal Y coordinate
-			if(obj[sprite_id].v_flip)
-			{
-				s16 v_flip = sprite_tile_pixel_y;
-				v_flip -= (obj[sprite_id].height - 1);
-
-				if(v_flip < 0) { v_flip *= -1; }
-
-				sprite_tile_pixel_y = v_flip;
-			}
 		}
 
 		//Affine transformation sprite rendering
@@ -645,8 +727,8 @@ bool AGB_LCD::render_sprite_pixel()
 			s16 current_x, current_y;
 
 			//Determine current X position relative to the OBJ center X, account for screen wrapping
-			if((obj[sprite_id].x_wrap) && (scanline_pixel_counter < obj[sprite_id].right)) { current_x = scanline_pixel_counter - (obj[sprite_id].cx - obj[sprite_id].x_wrap); }
-			else { current_x = scanline_pixel_counter - obj[sprite_id].cx; }
+			if((obj[sprite_id].x_wrap) && (scanline_x < obj[sprite_id].right)) { current_x = scanline_x - (obj[sprite_id].cx - obj[sprite_id].x_wrap); }
+			else { current_x = scanline_x - obj[sprite_id].cx; }
 
 			//Determine current Y position relative to the OBJ center Y, account for screen wrapping
 			if((obj[sprite_id].y_wrap) && (current_scanline < obj[sprite_id].bottom)) { current_y = current_scanline - (obj[sprite_id].cy - obj[sprite_id].y_wrap); }
@@ -656,513 +738,495 @@ bool AGB_LCD::render_sprite_pixel()
 			s16 new_y = obj[sprite_id].ch + (lcd_stat.obj_affine[index+2] * current_x) + (lcd_stat.obj_affine[index+3] * current_y);
 
 			//If out of bounds for the transformed sprite, abort rendering
-			if((new_x < 0) || (new_y < 0) || (new_x >= obj[sprite_id].width) || (new_y >= obj[sprite_id].height)) { render_obj = false; }
-		
+			if((new_x < 0) || (new_y < 0) || (new_x >= obj[sprite_id].width) || (new_y >= obj[sprite_id].height)) { continue; }
+
 			sprite_tile_pixel_x = new_x;
 			sprite_tile_pixel_y = new_y;
 		}
 
-		//This check is mainly for affine OBJs
-		if(render_obj)
-		{
-			//Handle the mosiac function
-			if(obj[sprite_id].mosiac && lcd_stat.obj_mos_hsize) { sprite_tile_pixel_x = ((sprite_tile_pixel_x / lcd_stat.obj_mos_hsize) * lcd_stat.obj_mos_hsize); }
-			if(obj[sprite_id].mosiac && lcd_stat.obj_mos_vsize) { sprite_tile_pixel_y = ((sprite_tile_pixel_y / lcd_stat.obj_mos_vsize) * lcd_stat.obj_mos_vsize); }
-
-			//Determine meta x-coordinate of rendered sprite pixel
-			u8 meta_x = (sprite_tile_pixel_x / 8);
+		u16 pixel_x = sprite_tile_pixel_x;
+		u16 pixel_y = sprite_tile_pixel_y;
 
-			//Determine meta Y-coordinate of rendered sprite pixel
-			u8 meta_y = (sprite_tile_pixel_y / 8);
+		//Handle the mosiac function
+		if(obj[sprite_id].mosiac && lcd_stat.obj_mos_hsize) { pixel_x = ((pixel_x / lcd_stat.obj_mos_hsize) * lcd_stat.obj_mos_hsize); }
+		if(obj[sprite_id].mosiac && lcd_stat.obj_mos_vsize) { pixel_y = ((pixel_y / lcd_stat.obj_mos_vsize) * lcd_stat.obj_mos_vsize); }
 
-			//Determine which 8x8 section to draw pixel from, and what tile that actually represents in VRAM
-			if(lcd_stat.display_control & 0x40)
-			{
-				meta_sprite_tile = (meta_y * (obj[sprite_id].width/8)) + meta_x;	
-			}
+		//Determine meta X-Y coordinates of rendered sprite pixel
+		u8 meta_x = (pixel_x / 8);
+		u8 meta_y = (pixel_y / 8);
+		u32 meta_sprite_tile = 0;
 
-			else
-			{
-				meta_sprite_tile = (obj[sprite_id].bit_depth == 8) ? ((meta_y * 16) + meta_x) : ((meta_y * 32) + meta_x);
-			}
-
-			sprite_tile_addr = obj[sprite_id].addr + (meta_sprite_tile * (obj[sprite_id].bit_depth << 3));
+		//Determine which 8x8 section to draw pixel from, and what tile that actually represents in VRAM
+		if(lcd_stat.display_control & 0x40)
+		{
+			meta_sprite_tile = (meta_y * (obj[sprite_id].width/8)) + meta_x;
+		}
 
-			meta_x = (sprite_tile_pixel_x % 8);
-			meta_y = (sprite_tile_pixel_y % 8);
+		else
+		{
+			meta_sprite_tile = (obj[sprite_id].bit_depth == 8) ? ((meta_y * 16) + meta_x) : ((meta_y * 32) + meta_x);
+		}
 
-			u8 sprite_tile_pixel = (meta_y * 8) + meta_x;
+		//OBJ tiles wrap around within the 32KB OBJ area of VRAM, never into BG VRAM
+		u32 sprite_tile_addr = 0x10000 | ((obj[sprite_id].addr + (meta_sprite_tile * (obj[sprite_id].bit_depth << 3))) & 0x7FFF);
+		u8 sprite_tile_pixel = ((pixel_y % 8) * 8) + (pixel_x % 8);
+		u8 raw_color = 0;
+		u16 pal_index = 0;
 
-			//Grab the byte corresponding to (sprite_tile_pixel), render it as ARGB - 4-bit version
-			if(obj[sprite_id].bit_depth == 4)
-			{
-				sprite_tile_addr += (sprite_tile_pixel >> 1);
-				raw_color = mem->memory_map[sprite_tile_addr];
+		//Grab the pixel from the decoded tile - 4-bit version
+		if(obj[sprite_id].bit_depth == 4)
+		{
+			raw_color = get_tile_4bpp(sprite_tile_addr)[sprite_tile_pixel];
+			pal_index = (obj[sprite_id].palette_number << 4) + raw_color;
+		}
 
-				if((sprite_tile_pixel % 2) == 0) { raw_color &= 0xF; }
-				else { raw_color >>= 4; }
+		//Grab the byte corresponding to (sprite_tile_pixel) - 8-bit version
+		else
+		{
+			raw_color = vram[0x10000 | ((sprite_tile_addr + sprite_tile_pixel) & 0x7FFF)];
+			pal_index = raw_color;
+		}
 
-				if(raw_color != 0) 
-				{
-					//If this sprite is in OBJ Window mode, do not render it, but set a flag indicating the LCD passed over its pixel
-					if(obj[sprite_id].mode == 2) { obj_win_pixel = true; }
+		if(raw_color == 0) { continue; }
 
-					else 
-					{
-						scanline_buffer[scanline_pixel_counter] = pal[((obj[sprite_id].palette_number * 32) + (raw_color * 2)) >> 1][1];
-						last_raw_color = raw_pal[((obj[sprite_id].palette_number * 32) + (raw_color * 2)) >> 1][1];
-						last_obj_priority = obj[sprite_id].bg_priority;
-						last_obj_mode = obj[sprite_id].mode;
-						final_render = true;
-					}
-				}
-			}
+		//If this sprite is in OBJ Window mode, do not render it, but set a flag indicating the LCD passed over its pixel
+		if(obj_win) { obj_line_win[scanline_x] = true; }
 
-			//Grab the byte corresponding to (sprite_tile_pixel), render it as ARGB - 8-bit version
-			else
-			{
-				sprite_tile_addr += sprite_tile_pixel;
-				raw_color = mem->memory_map[sprite_tile_addr];
-
-				if(raw_color != 0) 
-				{
-					//If this sprite is in OBJ Window mode, do not render it, but set a flag indicating the LCD passed over its pixel
-					if(obj[sprite_id].mode == 2) { obj_win_pixel = true; }
-
-					else
-					{
-						scanline_buffer[scanline_pixel_counter] = pal[raw_color][1];
-						last_raw_color = raw_pal[raw_color][1];
-						last_obj_priority = obj[sprite_id].bg_priority;
-						last_obj_mode = obj[sprite_id].mode;
-						final_render = true;
-					}
-				}
-			}
+		else
+		{
+			obj_line_buffer[scanline_x] = pal[pal_index][1];
+			obj_line_raw[scanline_x] = raw_pal[pal_index][1];
+			obj_line_priority[scanline_x] = obj[sprite_id].bg_priority;
+			obj_line_mode[scanline_x] = obj[sprite_id].mode;
+			obj_line_opaque[scanline_x] = true;
 		}
 	}
-
-	//Return false if nothing was drawn
-	return final_render;
 }
 
-/****** Determines if a background pixel should be rendered, and if so draws it to the current scanline pixel ******/
-bool AGB_LCD::render_bg_pixel(u32 bg_control)
+/****** Draws a background's pixels on the current line to its line buffer ******/
+void AGB_LCD::render_bg_line(u8 bg_id)
 {
-	if(!lcd_stat.bg_enable[(bg_control - 0x4000008) >> 1]) { return false; }
+	for(u32 x = 0; x < 240; x++) { bg_line_opaque[bg_id][x] = false; }
+
+	if(!lcd_stat.bg_enable[bg_id]) { return; }
 
-	//Render BG pixel according to current BG Mode
+	//Render BG line according to current BG Mode
 	switch(lcd_stat.bg_mode)
 	{
 		//BG Mode 0
 		case 0:
-			return render_bg_mode_0(bg_control); break;
+			render_bg_mode_0(bg_id); break;
 
 		//BG Mode 1
 		case 1:
 			//Render BG2 as Scaled+Rotation
-			if(bg_control == BG2CNT) { return render_bg_mode_1(bg_control); }
-
-			//BG3 is never drawn in Mode 1
-			else if(bg_control == BG3CNT) { return false; }
+			if(bg_id == 2) { render_bg_mode_1(bg_id); }
 
-			//Render BG0 and BG1 as Text (same as Mode 0)
-			else { return render_bg_mode_0(bg_control); } 
+			//Render BG0 and BG1 as Text (same as Mode 0), BG3 is never drawn in Mode 1
+			else if(bg_id != 3) { render_bg_mode_0(bg_id); }
 
 			break;
 
 		//BG Mode 2
 		case 0x2:
 			//Render BG2 and BG3 as Scaled+Rotation
-			if((bg_control == BG2CNT) || (bg_control == BG3CNT)) { return render_bg_mode_1(bg_control); }
-			else { return false; }
+			if(bg_id >= 2) { render_bg_mode_1(bg_id); }
 
 			break;
 
 		//BG Mode 3
 		case 3:
-			return render_bg_mode_3(); break;
+			render_bg_mode_3(bg_id); break;
 
 		//BG Mode 4
 		case 4:
-			return render_bg_mode_4(); break;
+			render_bg_mode_4(bg_id); break;
 
 		//BG Mode 5
 		case 5:
-			return render_bg_mode_5(); break;
+			render_bg_mode_5(bg_id); break;
 
 		default:
 			//std::cout<<"LCD::invalid or unsupported BG Mode : " << std::dec << (lcd_stat.display_control & 0x7);
-			return false;
+			break;
 	}
 }
 
-/****** Render BG Mode 0 ******/
-bool AGB_LCD::render_bg_mode_0(u32 bg_control)
+/****** Returns the decoded pixels of a 4bpp tile, decoding it again if its VRAM changed ******/
+const u8* AGB_LCD::get_tile_4bpp(u32 tile_addr)
 {
-	//Set BG ID to determine which BG is being rendered.
-	u8 bg_id = (bg_control - 0x4000008) >> 1;
-	
-	//BG offset
-	u16 screen_offset = 0;
-
-	//Determine meta x-coordinate of rendered BG pixel
-	u16 meta_x = ((scanline_pixel_counter + lcd_stat.bg_offset_x[bg_id]) % lcd_stat.mode_0_width[bg_id]);
+	u32 tile = (tile_addr & 0x1FFFF) >> 5;
+	u8* pixels = &tile_cache[tile << 6];
 
-	//Determine meta Y-coordinate of rendered BG pixel
-	u16 meta_y = ((current_scanline + lcd_stat.bg_offset_y[bg_id]) % lcd_stat.mode_0_height[bg_id]);
-	
-	//Determine the address offset for the screen
-	switch(lcd_stat.bg_size[bg_id])
+	if(render_vram_dirty[tile >> 5] & (1 << (tile & 0x1F)))
 	{
-		//Size 0 - 256x256
-		case 0x0: break;
-
-		//Size 1 - 512x256
-		case 0x1: 
-			screen_offset = lcd_stat.screen_offset_lut[meta_x];
-			break;
+		render_vram_dirty[tile >> 5] &= ~(1 << (tile & 0x1F));
 
-		//Size 2 - 256x512
-		case 0x2:
-			screen_offset = lcd_stat.screen_offset_lut[meta_y];
-			break;
+		//Split each byte into 2 palette indices, low nibble first
+		u8* vram = &render_vram[tile << 5];
 
-		//Size 3 - 512x512
-		case 0x3:
-			screen_offset = (meta_y > 255) ? (lcd_stat.screen_offset_lut[meta_x] | 0x1000) : lcd_stat.screen_offset_lut[meta_x];
-			break;
+		for(u32 x = 0; x < 32; x++)
+		{
+			pixels[x << 1] = (vram[x] & 0xF);
+			pixels[(x << 1) + 1] = (vram[x] >> 4);
+		}
 	}
 
-	//Add screen offset to current BG map base address
-	u32 map_base_addr = lcd_stat.bg_base_map_addr[bg_id] + screen_offset;
+	return pixels;
+}
 
-	//Determine the X-Y coordinates of the BG's tile on the tile map
-	u16 current_tile_pixel_x = ((scanline_pixel_counter + lcd_stat.bg_offset_x[bg_id]) % 256);
-	u16 current_tile_pixel_y = ((current_scanline + lcd_stat.bg_offset_y[bg_id]) % 256);
+/****** Render BG Mode 0 ******/
+void AGB_LCD::render_bg_mode_0(u8 bg_id)
+{
+	u8* vram = render_vram;
 
-	//Handle mosiac tiles
-	if(lcd_stat.bg_mosiac[bg_id] && lcd_stat.bg_mos_hsize) { current_tile_pixel_x = ((current_tile_pixel_x / lcd_stat.bg_mos_hsize) * lcd_stat.bg_mos_hsize); }
-	if(lcd_stat.bg_mosiac[bg_id] && lcd_stat.bg_mos_vsize) { current_tile_pixel_y = ((current_tile_pixel_y / lcd_stat.bg_mos_vsize) * lcd_stat.bg_mos_vsize); }
+	//Determine meta Y-coordinate of rendered BG pixels, the same for the whole line
+	u16 meta_y = ((current_scanline + lcd_stat.bg_offset_y[bg_id]) % lcd_stat.mode_0_height[bg_id]);
+	u16 tile_pixel_y = ((current_scanline + lcd_stat.bg_offset_y[bg_id]) % 256);
 
-	//Get current map entry for rendered pixel
-	u16 tile_number = lcd_stat.bg_num_lut[current_tile_pixel_x][current_tile_pixel_y];
+	//Handle mosiac tiles
+	if(lcd_stat.bg_mosiac[bg_id] && lcd_stat.bg_mos_vsize) { tile_pixel_y = ((tile_pixel_y / lcd_stat.bg_mos_vsize) * lcd_stat.bg_mos_vsize); }
 
-	//Grab the map's data
-	u16 map_data = mem->read_u16_fast(map_base_addr + (tile_number * 2));
+	//Map entry currently being drawn - Only looked up again when moving onto a different tile
+	u32 last_map_addr = 0xFFFFFFFF;
+	const u8* tile_row = NULL;
+	bool h_flip = false;
+	u16 pal_base = 0;
 
-	//Look at the Tile Map #(tile_number), see what Tile # it points to
-	u16 map_entry = map_data & 0x3FF;
+	for(u32 scanline_x = 0; scanline_x < 240; scanline_x++)
+	{
+		//BG offset
+		u16 screen_offset = 0;
 
-	//Grab horizontal and vertical flipping options
-	u8 flip_options = (map_data >> 10) & 0x3;
+		//Determine meta x-coordinate of rendered BG pixel
+		u16 meta_x = ((scanline_x + lcd_stat.bg_offset_x[bg_id]) % lcd_stat.mode_0_width[bg_id]);
 
-	//Grab the Palette number of the tiles
-	u8 palette_number = (map_data >> 12);
+		//Determine the address offset for the screen
+		switch(lcd_stat.bg_size[bg_id])
+		{
+			//Size 0 - 256x256
+			case 0x0: break;
+
+			//Size 1 - 512x256
+			case 0x1:
+				screen_offset = lcd_stat.screen_offset_lut[meta_x];
+				break;
+
+			//Size 2 - 256x512
+			case 0x2:
+				screen_offset = lcd_stat.screen_offset_lut[meta_y];
+				break;
+
+			//Size 3 - 512x512
+			case 0x3:
+				screen_offset = (meta_y > 255) ? (lcd_stat.screen_offset_lut[meta_x] | 0x1000) : lcd_stat.screen_offset_lut[meta_x];
+				break;
+		}
 
-	//Get address of Tile #(map_entry)
-	u32 tile_addr = lcd_stat.bg_base_tile_addr[bg_id] + (map_entry * (lcd_stat.bg_depth[bg_id] << 3));
+		//Determine the X-Y coordinates of the BG's tile on the tile map
+		u16 current_tile_pixel_x = ((scanline_x + lcd_stat.bg_offset_x[bg_id]) % 256);
 
-	switch(flip_options)
-	{
-		case 0x0: break;
+		//Handle mosiac tiles
+		if(lcd_stat.bg_mosiac[bg_id] && lcd_stat.bg_mos_hsize) { current_tile_pixel_x = ((current_tile_pixel_x / lcd_stat.bg_mos_hsize) * lcd_stat.bg_mos_hsize); }
 
-		//Horizontal flip
-		case 0x1: 
-			current_tile_pixel_x = lcd_stat.bg_flip_lut[current_tile_pixel_x];
-			break;
+		//Get address of the current map entry for rendered pixel
+		u32 map_addr = lcd_stat.bg_base_map_addr[bg_id] + screen_offset + (lcd_stat.bg_num_lut[current_tile_pixel_x][tile_pixel_y] * 2);
 
-		//Vertical flip
-		case 0x2:
-			current_tile_pixel_y = lcd_stat.bg_flip_lut[current_tile_pixel_y];
-			break;
+		if(map_addr != last_map_addr)
+		{
+			last_map_addr = map_addr;
 
-		//Horizontal + vertical flip
-		case 0x3:
-			current_tile_pixel_x = lcd_stat.bg_flip_lut[current_tile_pixel_x];
-			current_tile_pixel_y = lcd_stat.bg_flip_lut[current_tile_pixel_y];
-			break;
-	}
+			//Grab the map's data
+			u16 map_data = vram[map_addr & 0x1FFFF] | (vram[(map_addr + 1) & 0x1FFFF] << 8);
 
-	u8 current_tile_pixel = lcd_stat.bg_tile_lut[current_tile_pixel_x][current_tile_pixel_y];
+			//Look at the Tile Map #(tile_number), see what Tile # it points to
+			u16 map_entry = map_data & 0x3FF;
 
-	//Grab the byte corresponding to (current_tile_pixel), render it as ARGB - 4-bit version
-	if(lcd_stat.bg_depth[bg_id] == 4)
-	{
-		tile_addr += (current_tile_pixel >> 1);
-		u8 raw_color = mem->memory_map[tile_addr];
+			//Grab horizontal and vertical flipping options
+			h_flip = (map_data & 0x400);
+			u8 tile_y = (map_data & 0x800) ? lcd_stat.bg_flip_lut[tile_pixel_y] : (tile_pixel_y & 0x7);
 
-		if((current_tile_pixel % 2) == 0) { raw_color &= 0xF; }
-		else { raw_color >>= 4; }
+			//Get address of Tile #(map_entry)
+			u32 tile_addr = lcd_stat.bg_base_tile_addr[bg_id] + (map_entry * (lcd_stat.bg_depth[bg_id] << 3));
 
-		//If the bg color is transparent, abort drawing
-		if(raw_color == 0) { return false; }
+			//4-bit tiles come from the decoded tile cache, palette number selects a 16 color bank
+			if(lcd_stat.bg_depth[bg_id] == 4)
+			{
+				tile_row = get_tile_4bpp(tile_addr) + (tile_y << 3);
+				pal_base = ((map_data >> 12) << 4);
+			}
 
-		scanline_buffer[scanline_pixel_counter] = pal[((palette_number * 32) + (raw_color * 2)) >> 1][0];
-		last_raw_color = raw_pal[((palette_number * 32) + (raw_color * 2)) >> 1][0];
-	}
+			//8-bit tiles already hold 1 palette index per byte
+			else
+			{
+				tile_row = &vram[(tile_addr + (tile_y << 3)) & 0x1FFFF];
+				pal_base = 0;
+			}
+		}
 
-	//Grab the byte corresponding to (current_tile_pixel), render it as ARGB - 8-bit version
-	else
-	{
-		tile_addr += current_tile_pixel;
-		u8 raw_color = mem->memory_map[tile_addr];
+		u8 raw_color = tile_row[h_flip ? lcd_stat.bg_flip_lut[current_tile_pixel_x] : (current_tile_pixel_x & 0x7)];
 
 		//If the bg color is transparent, abort drawing
-		if(raw_color == 0) { return false; }
+		if(raw_color == 0) { continue; }
 
-		scanline_buffer[scanline_pixel_counter] = pal[raw_color][0];
-		last_raw_color = raw_pal[raw_color][0];
-	}
+		u16 pal_index = pal_base + raw_color;
 
-	return true;
+		bg_line_buffer[bg_id][scanline_x] = pal[pal_index][0];
+		bg_line_raw[bg_id][scanline_x] = raw_pal[pal_index][0];
+		bg_line_opaque[bg_id][scanline_x] = true;
+	}
 }
 
 /****** Render BG Mode 1 ******/
-bool AGB_LCD::render_bg_mode_1(u32 bg_control)
+void AGB_LCD::render_bg_mode_1(u8 bg_id)
 {
-	//Set BG ID to determine which BG is being rendered.
-	u8 bg_id = (bg_control - 0x4000008) >> 1;
+	u8* vram = render_vram;
 	u8 scale_rot_id = (bg_id == 2) ? 0 : 1;
 
-	//If rendering pixels along a given line, add DX and DY
-	lcd_stat.bg_affine[scale_rot_id].x_pos = lcd_stat.bg_affine[scale_rot_id].x_ref + (lcd_stat.bg_affine[scale_rot_id].dx * scanline_pixel_counter);
-	lcd_stat.bg_affine[scale_rot_id].y_pos = lcd_stat.bg_affine[scale_rot_id].y_ref + (lcd_stat.bg_affine[scale_rot_id].dy * scanline_pixel_counter);
-
 	//Get BG size in tiles, pixels
 	//0 - 128x128, 1 - 256x256, 2 - 512x512, 3 - 1024x1024
 	u16 bg_tile_size = (16 << (lcd_stat.bg_control[bg_id] >> 14));
 	u16 bg_pixel_size = bg_tile_size << 3;
 
-	//Calculate new X-Y coordinates from scaling+rotation
-	double new_x = lcd_stat.bg_affine[scale_rot_id].x_pos;
-	double new_y = lcd_stat.bg_affine[scale_rot_id].y_pos;
-
-	//Clip BG if coordinates overflow and overflow flag is not set
-	if(!lcd_stat.bg_affine[scale_rot_id].overflow)
+	for(u32 scanline_x = 0; scanline_x < 240; scanline_x++)
 	{
-		if((new_x >= bg_pixel_size) || (new_x < 0)) { return false; }
-		if((new_y >= bg_pixel_size) || (new_y < 0)) { return false; }
-	}
+		//If rendering pixels along a given line, add DX and DY
+		lcd_stat.bg_affine[scale_rot_id].x_pos = lcd_stat.bg_affine[scale_rot_id].x_ref + (lcd_stat.bg_affine[scale_rot_id].dx * scanline_x);
+		lcd_stat.bg_affine[scale_rot_id].y_pos = lcd_stat.bg_affine[scale_rot_id].y_ref + (lcd_stat.bg_affine[scale_rot_id].dy * scanline_x);
 
-	//Wrap BG if coordinates overflow and overflow flag is set
-	else 
-	{
-		while(new_x >= bg_pixel_size) { new_x -= bg_pixel_size; }
-		while(new_y >= bg_pixel_size) { new_y -= bg_pixel_size; }
-		while(new_x < 0) { new_x += bg_pixel_size; }
-		while(new_y < 0) { new_y += bg_pixel_size; } 
-	}
+		//Calculate new X-Y coordinates from scaling+rotation
+		double new_x = lcd_stat.bg_affine[scale_rot_id].x_pos;
+		double new_y = lcd_stat.bg_affine[scale_rot_id].y_pos;
 
-	//Determine source pixel X-Y coordinates
-	u16 src_x = new_x; 
-	u16 src_y = new_y;
+		//Clip BG if coordinates overflow and overflow flag is not set
+		if(!lcd_stat.bg_affine[scale_rot_id].overflow)
+		{
+			if((new_x >= bg_pixel_size) || (new_x < 0)) { continue; }
+			if((new_y >= bg_pixel_size) || (new_y < 0)) { continue; }
+		}
 
-	//Handle mosiac tiles
-	if(lcd_stat.bg_mosiac[bg_id] && lcd_stat.bg_mos_hsize) { src_x = ((src_x / lcd_stat.bg_mos_hsize) * lcd_stat.bg_mos_hsize); }
-	if(lcd_stat.bg_mosiac[bg_id] && lcd_stat.bg_mos_vsize) { src_y = ((src_y / lcd_stat.bg_mos_vsize) * lcd_stat.bg_mos_vsize); }
+		//Wrap BG if coordinates overflow and overflow flag is set
+		else
+		{
+			while(new_x >= bg_pixel_size) { new_x -= bg_pixel_size; }
+			while(new_y >= bg_pixel_size) { new_y -= bg_pixel_size; }
+			while(new_x < 0) { new_x += bg_pixel_size; }
+			while(new_y < 0) { new_y += bg_pixel_size; }
+		}
 
-	//Get current map entry for rendered pixel
-	u16 tile_number = ((src_y / 8) * bg_tile_size) + (src_x / 8);
+		//Determine source pixel X-Y coordinates
+		u16 src_x = new_x;
+		u16 src_y = new_y;
 
-	//Look at the Tile Map #(tile_number), see what Tile # it points to
-	u8 map_entry = mem->memory_map[lcd_stat.bg_base_map_addr[bg_id] + tile_number];
+		//Handle mosiac tiles
+		if(lcd_stat.bg_mosiac[bg_id] && lcd_stat.bg_mos_hsize) { src_x = ((src_x / lcd_stat.bg_mos_hsize) * lcd_stat.bg_mos_hsize); }
+		if(lcd_stat.bg_mosiac[bg_id] && lcd_stat.bg_mos_vsize) { src_y = ((src_y / lcd_stat.bg_mos_vsize) * lcd_stat.bg_mos_vsize); }
 
-	//Get address of Tile #(map_entry)
-	u32 tile_addr = lcd_stat.bg_base_tile_addr[bg_id] + (map_entry * 64);
+		//Get current map entry for rendered pixel
+		u16 tile_number = ((src_y / 8) * bg_tile_size) + (src_x / 8);
 
-	u8 current_tile_pixel = ((src_y % 8) * 8) + (src_x % 8);
+		//Look at the Tile Map #(tile_number), see what Tile # it points to
+		u8 map_entry = vram[(lcd_stat.bg_base_map_addr[bg_id] + tile_number) & 0x1FFFF];
 
-	//Grab the byte corresponding to (current_tile_pixel), render it as ARGB - 8-bit version
-	tile_addr += current_tile_pixel;
-	u8 raw_color = mem->memory_map[tile_addr];
+		//Get address of Tile #(map_entry)
+		u32 tile_addr = lcd_stat.bg_base_tile_addr[bg_id] + (map_entry * 64);
 
-	//If the bg color is transparent, abort drawing
-	if(raw_color == 0) { return false; }
+		u8 current_tile_pixel = ((src_y % 8) * 8) + (src_x % 8);
 
-	scanline_buffer[scanline_pixel_counter] = pal[raw_color][0];
-	last_raw_color = raw_pal[raw_color][0];
+		//Grab the byte corresponding to (current_tile_pixel) - 8-bit version
+		tile_addr += current_tile_pixel;
+		u8 raw_color = vram[tile_addr & 0x1FFFF];
 
-	return true;
+		//If the bg color is transparent, abort drawing
+		if(raw_color == 0) { continue; }
+
+		bg_line_buffer[bg_id][scanline_x] = pal[raw_color][0];
+		bg_line_raw[bg_id][scanline_x] = raw_pal[raw_color][0];
+		bg_line_opaque[bg_id][scanline_x] = true;
+	}
 }
 
 /****** Render BG Mode 3 ******/
-bool AGB_LCD::render_bg_mode_3()
+void AGB_LCD::render_bg_mode_3(u8 bg_id)
 {
-	//If rendering pixels along a given line, add DX and DY
-	lcd_stat.bg_affine[0].x_pos = lcd_stat.bg_affine[0].x_ref + (lcd_stat.bg_affine[0].dx * scanline_pixel_counter);
-	lcd_stat.bg_affine[0].y_pos = lcd_stat.bg_affine[0].y_ref + (lcd_stat.bg_affine[0].dy * scanline_pixel_counter);
-
-	//Clip affine coordinates if out-of-bounds
-	if((lcd_stat.bg_affine[0].x_pos >= 240) || (lcd_stat.bg_affine[0].x_pos < 0)) { return false; }
-	if((lcd_stat.bg_affine[0].y_pos >= 160) || (lcd_stat.bg_affine[0].y_pos < 0)) { return false; }
+	for(u32 scanline_x = 0; scanline_x < 240; scanline_x++)
+	{
+		//If rendering pixels along a given line, add DX and DY
+		lcd_stat.bg_affine[0].x_pos = lcd_stat.bg_affine[0].x_ref + (lcd_stat.bg_affine[0].dx * scanline_x);
+		lcd_stat.bg_affine[0].y_pos = lcd_stat.bg_affine[0].y_ref + (lcd_stat.bg_affine[0].dy * scanline_x);
 
-	u16 src_x = lcd_stat.bg_affine[0].x_pos; 
-	u16 src_y = lcd_stat.bg_affine[0].y_pos;
+		//Clip affine coordinates if out-of-bounds
+		if((lcd_stat.bg_affine[0].x_pos >= 240) || (lcd_stat.bg_affine[0].x_pos < 0)) { continue; }
+		if((lcd_stat.bg_affine[0].y_pos >= 160) || (lcd_stat.bg_affine[0].y_pos < 0)) { continue; }
 
-	//Determine which byte in VRAM to read for color data
-	u16 color_bytes = mem->read_u16_fast(0x6000000 + (src_y * 480) + (src_x * 2));
-	last_raw_color = color_bytes;
+		u16 src_x = lcd_stat.bg_affine[0].x_pos;
+		u16 src_y = lcd_stat.bg_affine[0].y_pos;
 
-	//ARGB conversion
-	u8 red = ((color_bytes & 0x1F) * 8);
-	color_bytes >>= 5;
+		//Determine which byte in VRAM to read for color data
+		u32 bitmap_entry = (src_y * 480) + (src_x * 2);
+		u16 color_bytes = render_vram[bitmap_entry] | (render_vram[bitmap_entry + 1] << 8);
+		bg_line_raw[bg_id][scanline_x] = color_bytes;
 
-	u8 green = ((color_bytes & 0x1F) * 8);
-	color_bytes >>= 5;
+		//ARGB conversion
+		u8 red = ((color_bytes & 0x1F) * 8);
+		color_bytes >>= 5;
 
-	u8 blue = ((color_bytes & 0x1F) * 8);
+		u8 green = ((color_bytes & 0x1F) * 8);
+		color_bytes >>= 5;
 
-	scanline_buffer[scanline_pixel_counter] = 0xFF000000 | (red << 16) | (green << 8) | (blue);
+		u8 blue = ((color_bytes & 0x1F) * 8);
 
-	return true;
+		bg_line_buffer[bg_id][scanline_x] = 0xFF000000 | (red << 16) | (green << 8) | (blue);
+		bg_line_opaque[bg_id][scanline_x] = true;
+	}
 }
 
 /****** Render BG Mode 4 ******/
-bool AGB_LCD::render_bg_mode_4()
+void AGB_LCD::render_bg_mode_4(u8 bg_id)
 {
-	//If rendering pixels along a given line, add DX and DY
-	lcd_stat.bg_affine[0].x_pos = lcd_stat.bg_affine[0].x_ref + (lcd_stat.bg_affine[0].dx * scanline_pixel_counter);
-	lcd_stat.bg_affine[0].y_pos = lcd_stat.bg_affine[0].y_ref + (lcd_stat.bg_affine[0].dy * scanline_pixel_counter);
-
-	//Clip affine coordinates if out-of-bounds
-	if((lcd_stat.bg_affine[0].x_pos >= 240) || (lcd_stat.bg_affine[0].x_pos < 0)) { return false; }
-	if((lcd_stat.bg_affine[0].y_pos >= 160) || (lcd_stat.bg_affine[0].y_pos < 0)) { return false; }
+	for(u32 scanline_x = 0; scanline_x < 240; scanline_x++)
+	{
+		//If rendering pixels along a given line, add DX and DY
+		lcd_stat.bg_affine[0].x_pos = lcd_stat.bg_affine[0].x_ref + (lcd_stat.bg_affine[0].dx * scanline_x);
+		lcd_stat.bg_affine[0].y_pos = lcd_stat.bg_affine[0].y_ref + (lcd_stat.bg_affine[0].dy * scanline_x);
 
-	u16 src_x = lcd_stat.bg_affine[0].x_pos; 
-	u16 src_y = lcd_stat.bg_affine[0].y_pos;
+		//Clip affine coordinates if out-of-bounds
+		if((lcd_stat.bg_affine[0].x_pos >= 240) || (lcd_stat.bg_affine[0].x_pos < 0)) { continue; }
+		if((lcd_stat.bg_affine[0].y_pos >= 160) || (lcd_stat.bg_affine[0].y_pos < 0)) { continue; }
 
-	//Determine which byte in VRAM to read for color data
-	u32 bitmap_entry = (lcd_stat.frame_base + (src_y * 240) + src_x);
+		u16 src_x = lcd_stat.bg_affine[0].x_pos;
+		u16 src_y = lcd_stat.bg_affine[0].y_pos;
 
-	u8 raw_color = mem->memory_map[bitmap_entry];
-	if(raw_color == 0) { return false; }
+		//Determine which byte in VRAM to read for color data
+		u32 bitmap_entry = (lcd_stat.frame_base + (src_y * 240) + src_x);
 
-	scanline_buffer[scanline_pixel_counter] = pal[raw_color][0];
-	last_raw_color = raw_pal[raw_color][0];
+		u8 raw_color = render_vram[bitmap_entry & 0x1FFFF];
+		if(raw_color == 0) { continue; }
 
-	return true;
+		bg_line_buffer[bg_id][scanline_x] = pal[raw_color][0];
+		bg_line_raw[bg_id][scanline_x] = raw_pal[raw_color][0];
+		bg_line_opaque[bg_id][scanline_x] = true;
+	}
 }
 
 /****** Render BG Mode 5 ******/
-bool AGB_LCD::render_bg_mode_5()
+void AGB_LCD::render_bg_mode_5(u8 bg_id)
 {
-	//If rendering pixels along a given line, add DX and DY
-	lcd_stat.bg_affine[0].x_pos = lcd_stat.bg_affine[0].x_ref + (lcd_stat.bg_affine[0].dx * scanline_pixel_counter);
-	lcd_stat.bg_affine[0].y_pos = lcd_stat.bg_affine[0].y_ref + (lcd_stat.bg_affine[0].dy * scanline_pixel_counter);
-
-	//Clip affine coordinates if out-of-bounds
-	if((lcd_stat.bg_affine[0].x_pos >= 160) || (lcd_stat.bg_affine[0].x_pos < 0)) { return false; }
-	if((lcd_stat.bg_affine[0].y_pos >= 128) || (lcd_stat.bg_affine[0].y_pos < 0)) { return false; }
+	for(u32 scanline_x = 0; scanline_x < 240; scanline_x++)
+	{
+		//If rendering pixels along a given line, add DX and DY
+		lcd_stat.bg_affine[0].x_pos = lcd_stat.bg_affine[0].x_ref + (lcd_stat.bg_affine[0].dx * scanline_x);
+		lcd_stat.bg_affine[0].y_pos = lcd_stat.bg_affine[0].y_ref + (lcd_stat.bg_affine[0].dy * scanline_x);
 
-	u16 src_x = lcd_stat.bg_affine[0].x_pos; 
-	u16 src_y = lcd_stat.bg_affine[0].y_pos;
+		//Clip affine coordinates if out-of-bounds
+		if((lcd_stat.bg_affine[0].x_pos >= 160) || (lcd_stat.bg_affine[0].x_pos < 0)) { continue; }
+		if((lcd_stat.bg_affine[0].y_pos >= 128) || (lcd_stat.bg_affine[0].y_pos < 0)) { continue; }
 
-	//Determine which byte in VRAM to read for color data
-	u16 color_bytes = mem->read_u16_fast(lcd_stat.frame_base + (src_y * 320) + (src_x * 2));
-	last_raw_color = color_bytes;
+		u16 src_x = lcd_stat.bg_affine[0].x_pos;
+		u16 src_y = lcd_stat.bg_affine[0].y_pos;
 
-	//ARGB conversion
-	u8 red = ((color_bytes & 0x1F) * 8);
-	color_bytes >>= 5;
+		//Determine which byte in VRAM to read for color data
+		u32 bitmap_entry = (lcd_stat.frame_base + (src_y * 320) + (src_x * 2)) & 0x1FFFF;
+		u16 color_bytes = render_vram[bitmap_entry] | (render_vram[bitmap_entry + 1] << 8);
+		bg_line_raw[bg_id][scanline_x] = color_bytes;
 
-	u8 green = ((color_bytes & 0x1F) * 8);
-	color_bytes >>= 5;
+		//ARGB conversion
+		u8 red = ((color_bytes & 0x1F) * 8);
+		color_bytes >>= 5;
 
-	u8 blue = ((color_bytes & 0x1F) * 8);
+		u8 green = ((color_bytes & 0x1F) * 8);
+		color_bytes >>= 5;
 
-	scanline_buffer[scanline_pixel_counter] = 0xFF000000 | (red << 16) | (green << 8) | (blue);
+		u8 blue = ((color_bytes & 0x1F) * 8);
 
-	return true;
+		bg_line_buffer[bg_id][scanline_x] = 0xFF000000 | (red << 16) | (green << 8) | (blue);
+		bg_line_opaque[bg_id][scanline_x] = true;
+	}
 }
 
-/****** Render pixels for a given scanline (per-pixel) ******/
-void AGB_LCD::render_scanline()
+/****** Determines which window, if any, covers each pixel on the current line ******/
+void AGB_LCD::render_window_line()
 {
-	bool obj_render = false;
-	bool winout = false;
-	lcd_stat.in_window = false;
-	lcd_stat.current_window = 0;
-	last_obj_priority = 0xFF;
-	last_bg_priority = 0x5;
-	last_obj_mode = 0;
-	last_raw_color = raw_pal[0][0];
-	obj_win_pixel = false;
-	u8 bg_render_list[4];
-	u8 bg_id;
-
-	//Render sprites
-	obj_render = render_sprite_pixel();
-
-	bool check_x = false;
-	bool check_y = false;
+	bool check_y[2] = { false, false };
 
-	//Determine window status of this pixel
-	if(lcd_stat.window_enable[0])
+	//Vertical window bounds are the same for the whole line
+	for(u32 win = 0; win < 2; win++)
 	{
-		if((lcd_stat.window_x1[0] <= lcd_stat.window_x2[0]) && (scanline_pixel_counter >= lcd_stat.window_x1[0]) && (scanline_pixel_counter <= lcd_stat.window_x2[0]))
+		if((lcd_stat.window_y1[win] <= lcd_stat.window_y2[win]) && (current_scanline >= lcd_stat.window_y1[win]) && (current_scanline < lcd_stat.window_y2[win]))
 		{
-			check_x = true;
+			check_y[win] = true;
 		}
 
-		else if((lcd_stat.window_x1[0] > lcd_stat.window_x2[0]) && ((scanline_pixel_counter >= lcd_stat.window_x1[0]) || (scanline_pixel_counter <= lcd_stat.window_x2[0])))
+		else if((lcd_stat.window_y1[win] > lcd_stat.window_y2[win]) && ((current_scanline >= lcd_stat.window_y1[win]) || (current_scanline < lcd_stat.window_y2[win])))
 		{
-			check_x = true;
+			check_y[win] = true;
 		}
 
-		if((lcd_stat.window_y1[0] <= lcd_stat.window_y2[0]) && (current_scanline >= lcd_stat.window_y1[0]) && (current_scanline < lcd_stat.window_y2[0]))
-		{
-			check_y = true;
-		}
-
-		else if((lcd_stat.window_y1[0] > lcd_stat.window_y2[0]) && ((current_scanline >= lcd_stat.window_y1[0]) || (current_scanline < lcd_stat.window_y2[0])))
-		{
-			check_y = true;
-		}
-		
-		if(check_x && check_y) { lcd_stat.in_window = true; lcd_stat.current_window = 0; }
+		if(!lcd_stat.window_enable[win]) { check_y[win] = false; }
 	}
 
-	
-	if((lcd_stat.window_enable[1]) && (!lcd_stat.in_window))
+	for(u32 x = 0; x < 240; x++)
 	{
-		check_x = false;
-		check_y = false;
+		window_line[x] = 0xFF;
 
-		if((lcd_stat.window_x1[1] <= lcd_stat.window_x2[1]) && (scanline_pixel_counter >= lcd_stat.window_x1[1]) && (scanline_pixel_counter <= lcd_stat.window_x2[1]))
+		//Window 0 takes priority over Window 1
+		for(u8 win = 0; win < 2; win++)
 		{
-			check_x = true;
-		}
+			if(!check_y[win]) { continue; }
 
-		else if((lcd_stat.window_x1[1] > lcd_stat.window_x2[1]) && ((scanline_pixel_counter >= lcd_stat.window_x1[1]) || (scanline_pixel_counter <= lcd_stat.window_x2[1])))
-		{
-			check_x = true;
-		}
+			bool check_x = false;
 
-		if((lcd_stat.window_y1[1] <= lcd_stat.window_y2[1]) && (current_scanline >= lcd_stat.window_y1[1]) && (current_scanline < lcd_stat.window_y2[1]))
-		{
-			check_y = true;
-		}
+			if((lcd_stat.window_x1[win] <= lcd_stat.window_x2[win]) && (x >= lcd_stat.window_x1[win]) && (x <= lcd_stat.window_x2[win]))
+			{
+				check_x = true;
+			}
 
-		else if((lcd_stat.window_y1[1] > lcd_stat.window_y2[1]) && ((current_scanline >= lcd_stat.window_y1[1]) || (current_scanline < lcd_stat.window_y2[1])))
-		{
-			check_y = true;
+			else if((lcd_stat.window_x1[win] > lcd_stat.window_x2[win]) && ((x >= lcd_stat.window_x1[win]) || (x <= lcd_stat.window_x2[win])))
+			{
+				check_x = true;
+			}
+
+			if(check_x) { window_line[x] = win; break; }
 		}
-		
-		if(check_x && check_y) { lcd_stat.in_window = true; lcd_stat.current_window = 1; }
 	}
-	
+}
 
-	//Turn off OBJ rendering if in/out of a window where OBJ rendering is disabled
-	if((lcd_stat.obj_win_enable) && (obj_win_pixel)) { }
-	else if((lcd_stat.window_enable[lcd_stat.current_window]) && (!lcd_stat.in_window) && (!lcd_stat.window_out_enable[4][0])) { obj_render = false; }
-	else if((lcd_stat.window_enable[lcd_stat.current_window]) && (lcd_stat.in_window) && (!lcd_stat.window_in_enable[4][lcd_stat.current_window])) { obj_render = false; }
+/****** Copies the current pixel from the OBJ line buffer, if a sprite was drawn there ******/
+bool AGB_LCD::fetch_obj_pixel()
+{
+	if(!obj_line_opaque[scanline_pixel_counter]) { return false; }
 
-	//Also turn off OBJ rendering if OBJ Window is enabled, but rendered pixel is outside any OBJ Window
-	else if((!lcd_stat.in_window) && (lcd_stat.obj_win_enable) && (!obj_win_pixel) && (!lcd_stat.window_out_enable[4][0])) { obj_render = false; }
+	scanline_buffer[scanline_pixel_counter] = obj_line_buffer[scanline_pixel_counter];
+	last_raw_color = obj_line_raw[scanline_pixel_counter];
+	last_obj_priority = obj_line_priority[scanline_pixel_counter];
+	last_obj_mode = obj_line_mode[scanline_pixel_counter];
+
+	return true;
+}
+
+/****** Copies the current pixel from a BG line buffer, if the BG was drawn there ******/
+bool AGB_LCD::fetch_bg_pixel(u8 bg_id)
+{
+	if(!bg_line_opaque[bg_id][scanline_pixel_counter]) { return false; }
+
+	scanline_buffer[scanline_pixel_counter] = bg_line_buffer[bg_id][scanline_pixel_counter];
+	last_raw_color = bg_line_raw[bg_id][scanline_pixel_counter];
+
+	return true;
+}
+
+/****** Render pixels for a given scanline (per-line) ******/
+void AGB_LCD::render_scanline()
+{
+	u8 bg_render_list[4];
+
+	//Draw every layer and the window mask for this line once
+	render_obj_line();
+	for(u8 x = 0; x < 4; x++) { render_bg_line(x); }
+	render_window_line();
 
 	//Determine WINOUT status
-	winout = (lcd_stat.obj_win_enable || lcd_stat.window_enable[0] || lcd_stat.window_enable[1]);
+	bool winout = (lcd_stat.obj_win_enable || lcd_stat.window_enable[0] || lcd_stat.window_enable[1]);
 
 	//Determine BG rendering priority
 	for(int x = 0, list_length = 0; x < 4; x++)
@@ -1173,6 +1237,74 @@ void AGB_LCD::render_scanline()
 		if(lcd_stat.bg_priority[3] == x) { bg_render_list[list_length++] = 3; }
 	}
 
+	bool line_sfx = (lcd_stat.current_sfx_type != NORMAL);
+
+	//Composite the line buffers and pick SFX for each pixel
+	for(scanline_pixel_counter = 0; scanline_pixel_counter < 240; scanline_pixel_counter++)
+	{
+		sfx_line_type[scanline_pixel_counter] = NORMAL;
+
+		compose_pixel(bg_render_list, winout);
+		if(line_sfx) { apply_sfx(); }
+	}
+
+	//Apply SFX to the whole line at once
+	if(line_sfx) { apply_sfx_line(); }
+
+	scanline_pixel_counter = 0;
+}
+
+/****** Renders the current line and pushes it to the screen buffer ******/
+void AGB_LCD::draw_scanline()
+{
+	render_scanline();
+
+	//Push scanline data to final buffer - Only if Forced Blank is disabled
+	if((lcd_stat.display_control & 0x80) == 0)
+	{
+		for(int x = 0, y = (240 * current_scanline); x < 240; x++, y++)
+		{
+			screen_buffer[y] = scanline_buffer[x];
+		}
+	}
+
+	//Draw all-white during Forced Blank
+	else
+	{
+		for(int x = 0, y = (240 * current_scanline); x < 240; x++, y++)
+		{
+			screen_buffer[y] = 0xFFFFFFFF;
+		}
+	}
+}
+
+/****** Picks the final pixel from the line buffers based on priority and windows ******/
+void AGB_LCD::compose_pixel(u8* bg_render_list, bool winout)
+{
+	bool obj_render = false;
+	u8 bg_id;
+
+	//Determine window status of this pixel
+	lcd_stat.in_window = (window_line[scanline_pixel_counter] != 0xFF);
+	lcd_stat.current_window = (lcd_stat.in_window) ? window_line[scanline_pixel_counter] : 0;
+
+	last_obj_priority = 0xFF;
+	last_bg_priority = 0x5;
+	last_obj_mode = 0;
+	last_raw_color = raw_pal[0][0];
+	obj_win_pixel = obj_line_win[scanline_pixel_counter];
+
+	//Render sprites
+	obj_render = fetch_obj_pixel();
+
+	//Turn off OBJ rendering if in/out of a window where OBJ rendering is disabled
+	if((lcd_stat.obj_win_enable) && (obj_win_pixel)) { }
+	else if((lcd_stat.window_enable[lcd_stat.current_window]) && (!lcd_stat.in_window) && (!lcd_stat.window_out_enable[4][0])) { obj_render = false; }
+	else if((lcd_stat.window_enable[lcd_stat.current_window]) && (lcd_stat.in_window) && (!lcd_stat.window_in_enable[4][lcd_stat.current_window])) { obj_render = false; }
+
+	//Also turn off OBJ rendering if OBJ Window is enabled, but rendered pixel is outside any OBJ Window
+	else if((!lcd_stat.in_window) && (lcd_stat.obj_win_enable) && (!obj_win_pixel) && (!lcd_stat.window_out_enable[4][0])) { obj_render = false; }
+
 	//Render BGs based on priority (3 is the 'lowest', 0 is the 'highest')
 	for(int x = 0; x < 4; x++)
 	{
@@ -1191,7 +1323,7 @@ void AGB_LCD::render_scanline()
 		else if((lcd_stat.obj_win_enable) && (obj_win_pixel) && (!lcd_stat.window_out_enable[bg_id][1])) { continue; }
 
 		//Render BG pixel
-		else if(render_bg_pixel(BG0CNT + (bg_id << 1))) { last_bg_priority = bg_id; return; }
+		else if(fetch_bg_pixel(bg_id)) { last_bg_priority = bg_id; return; }
 	}
 
 	//Use BG Palette #0, Color #0 as the backdrop if no BG or OBJ was rendered
@@ -1234,19 +1366,23 @@ void AGB_LCD::apply_sfx()
 
 	if(!do_sfx) { return; }
 
-	//Apply the specified SFX
+	//Pick the specified SFX, the color math is done for the whole line once compositing finishes
 	switch(lcd_stat.current_sfx_type)
 	{
 		case ALPHA_BLEND:
-			scanline_buffer[scanline_pixel_counter] = alpha_blend();
-			break;
+			{
+				//Searching for blend targets fetches other layers into the scanline buffer, so keep the composited pixel
+				u32 final_color = scanline_buffer[scanline_pixel_counter];
+				sfx_line_type[scanline_pixel_counter] = alpha_blend();
+				scanline_buffer[scanline_pixel_counter] = final_color;
+			}
 
-		case BRIGHTNESS_UP: 
-			scanline_buffer[scanline_pixel_counter] = brightness_up(); 
 			break;
 
+		case BRIGHTNESS_UP:
 		case BRIGHTNESS_DOWN:
-			scanline_buffer[scanline_pixel_counter] = brightness_down(); 
+			sfx_line_type[scanline_pixel_counter] = lcd_stat.current_sfx_type;
+			sfx_line_target_1[scanline_pixel_counter] = sfx_bgr15_to_argb(last_raw_color);
 			break;
 	}
 
@@ -1254,61 +1390,47 @@ void AGB_LCD::apply_sfx()
 	lcd_stat.temp_sfx_type = NORMAL;
 }
 
-/****** SFX - Increase brightness ******/
-u32 AGB_LCD::brightness_up()
+/****** Runs the SFX kernels over the current line, then copies results to the pixels using them ******/
+void AGB_LCD::apply_sfx_line()
 {
-	u16 color_bytes = last_raw_color;
-	u16 result = 0;
-
-	//Increase RGB intensities
-	u8 red = (color_bytes & 0x1F);
-	result = red + ((0x1F - red) * lcd_stat.brightness_coef);
-	red = (result > 0x1F) ? 0x1F : result;
-	color_bytes >>= 5;
-
-	u8 green = (color_bytes & 0x1F);
-	result = green + ((0x1F - green) * lcd_stat.brightness_coef);
-	green = (result > 0x1F) ? 0x1F : result;
-	color_bytes >>= 5;
-
-	u8 blue = (color_bytes & 0x1F);
-	result = blue + ((0x1F - blue) * lcd_stat.brightness_coef);
-	blue = (result > 0x1F) ? 0x1F : result;
-
-	//Return 32-bit color
-	return 0xFF000000 | (red << 19) | (green << 11) | (blue << 3);
-}
+	bool sfx_used[4] = { false, false, false, false };
+	for(u32 x = 0; x < 240; x++) { sfx_used[sfx_line_type[x]] = true; }
 
-/****** SFX - Decrease brightness ******/
-u32 AGB_LCD::brightness_down()
-{
-	u16 color_bytes = last_raw_color;
+	//Coefficients are stored as N/16
+	u8 eva = lcd_stat.alpha_a_coef * 16.0;
+	u8 evb = lcd_stat.alpha_b_coef * 16.0;
+	u8 evy = lcd_stat.brightness_coef * 16.0;
 
-	//Decrease RGB intensities 
-	u8 red = (color_bytes & 0x1F);
-	red -= (red * lcd_stat.brightness_coef);
-	color_bytes >>= 5;
+	for(u32 type = ALPHA_BLEND; type <= BRIGHTNESS_DOWN; type++)
+	{
+		if(!sfx_used[type]) { continue; }
 
-	u8 green = (color_bytes & 0x1F);
-	green -= (green * lcd_stat.brightness_coef);
-	color_bytes >>= 5;
+		switch(type)
+		{
+			case ALPHA_BLEND:
+				sfx_alpha_blend(sfx_line_result, sfx_line_target_1, sfx_line_target_2, eva, evb, 240);
+				break;
 
-	u8 blue = (color_bytes & 0x1F);
-	blue -= (blue * lcd_stat.brightness_coef);
+			case BRIGHTNESS_UP:
+				sfx_brightness_up(sfx_line_result, sfx_line_target_1, evy, 240, SFX_RGB15);
+				break;
 
-	//Return 32-bit color
-	return 0xFF000000 | (red << 19) | (green << 11) | (blue << 3);
-}
+			case BRIGHTNESS_DOWN:
+				sfx_brightness_down(sfx_line_result, sfx_line_target_1, evy, 240, SFX_RGB15);
+				break;
+		}
 
-/****** SFX - Alpha blending ******/
-u32 AGB_LCD::alpha_blend()
-{		
-	//Grab the current 32-bit color for this pixel, in case no alpha blending occurs
-	u32 final_color = scanline_buffer[scanline_pixel_counter];
+		for(u32 x = 0; x < 240; x++)
+		{
+			if(sfx_line_type[x] == type) { scanline_buffer[x] = sfx_line_result[x]; }
+		}
+	}
+}
 
+/****** SFX - Picks alpha blending targets, returns the SFX to apply or NORMAL if none ******/
+sfx_types AGB_LCD::alpha_blend()
+{
 	u16 color_1 = last_raw_color;
-	u16 color_2 = 0x0;
-	u16 result = 0;
 	u8 next_bg_priority = 0;
 	bool do_blending = false;
 
@@ -1318,19 +1440,19 @@ u32 AGB_LCD::alpha_blend()
 		for(int x = 0; x < 4; x++)
 		{
 			//OBJ is 1st target
-			if((last_obj_priority == x) && (lcd_stat.sfx_target[4][0] || (last_obj_mode == 1)) && (!do_blending)) { do_blending = render_sprite_pixel(); last_bg_priority = 4;  }
+			if((last_obj_priority == x) && (lcd_stat.sfx_target[4][0] || (last_obj_mode == 1)) && (!do_blending)) { do_blending = fetch_obj_pixel(); last_bg_priority = 4;  }
 	
 			//BG0 is 1st target
-			if((lcd_stat.bg_priority[0] == x) && (lcd_stat.sfx_target[0][0]) && (!do_blending)) { do_blending = render_bg_pixel(BG0CNT); last_bg_priority = 0; }
+			if((lcd_stat.bg_priority[0] == x) && (lcd_stat.sfx_target[0][0]) && (!do_blending)) { do_blending = fetch_bg_pixel(0); last_bg_priority = 0; }
 
 			//BG1 is 1st target
-			if((lcd_stat.bg_priority[1] == x) && (lcd_stat.sfx_target[1][0]) && (!do_blending)) { do_blending = render_bg_pixel(BG1CNT); last_bg_priority = 1; }
+			if((lcd_stat.bg_priority[1] == x) && (lcd_stat.sfx_target[1][0]) && (!do_blending)) { do_blending = fetch_bg_pixel(1); last_bg_priority = 1; }
 
 			//BG2 is 1st target
-			if((lcd_stat.bg_priority[2] == x) && (lcd_stat.sfx_target[2][0]) && (!do_blending)) { do_blending = render_bg_pixel(BG2CNT); last_bg_priority = 2; }
+			if((lcd_stat.bg_priority[2] == x) && (lcd_stat.sfx_target[2][0]) && (!do_blending)) { do_blending = fetch_bg_pixel(2); last_bg_priority = 2; }
 
 			//BG3 is 1st target
-			if((lcd_stat.bg_priority[3] == x) && (lcd_stat.sfx_target[3][0]) && (!do_blending)) { do_blending = render_bg_pixel(BG3CNT); last_bg_priority = 3; }
+			if((lcd_stat.bg_priority[3] == x) && (lcd_stat.sfx_target[3][0]) && (!do_blending)) { do_blending = fetch_bg_pixel(3); last_bg_priority = 3; }
 
 			if(do_blending) { x = 4; }
 		}
@@ -1340,13 +1462,16 @@ u32 AGB_LCD::alpha_blend()
 	}
 
 	//If the BD is the 1st target, abort alpha blending (no pixel technically exists behind it for blending)
-	if(last_bg_priority == 5) { return final_color; }
+	if(last_bg_priority == 5) { return NORMAL; }
 
 	//If BG0-3 was drawn last but is not the 1st target, abort alpha blending
-	if((last_bg_priority < 4) && (!lcd_stat.sfx_target[last_bg_priority][0])) { return final_color; }
+	if((last_bg_priority < 4) && (!lcd_stat.sfx_target[last_bg_priority][0])) { return NORMAL; }
 
 	//If no 1st target is set, abort alpha blending unless semi-trasnparent OBJ
-	if(((mem->memory_map[BLDCNT] & 0x3F) == 0) && (last_obj_mode != 1)) { return final_color; }
+	bool first_target = false;
+	for(u32 x = 0; x < 6; x++) { first_target |= lcd_stat.sfx_target[x][0]; }
+
+	if((!first_target) && (last_obj_mode != 1)) { return NORMAL; }
 
 	//Determine which priority to start looking at to grab the 2nd target
 	u8 current_bg_priority = (last_bg_priority == 4) ? last_obj_priority : lcd_stat.bg_priority[last_bg_priority];
@@ -1355,19 +1480,19 @@ u32 AGB_LCD::alpha_blend()
 	for(int x = current_bg_priority; x < 4; x++)
 	{
 		//Blend with OBJ
-		if((last_obj_priority == x) && (last_bg_priority != 4) && (!do_blending)) { do_blending = render_sprite_pixel(); next_bg_priority = 4; }
+		if((last_obj_priority == x) && (last_bg_priority != 4) && (!do_blending)) { do_blending = fetch_obj_pixel(); next_bg_priority = 4; }
 	
 		//Blend with BG0
-		if((lcd_stat.bg_priority[0] == x) && (last_bg_priority != 0) && (!do_blending)) { do_blending = render_bg_pixel(BG0CNT); next_bg_priority = 0; }
+		if((lcd_stat.bg_priority[0] == x) && (last_bg_priority != 0) && (!do_blending)) { do_blending = fetch_bg_pixel(0); next_bg_priority = 0; }
 
 		//Blend with BG1
-		if((lcd_stat.bg_priority[1] == x) && (last_bg_priority != 1) && (!do_blending)) { do_blending = render_bg_pixel(BG1CNT); next_bg_priority = 1; }
+		if((lcd_stat.bg_priority[1] == x) && (last_bg_priority != 1) && (!do_blending)) { do_blending = fetch_bg_pixel(1); next_bg_priority = 1; }
 
 		//Blend with BG2
-		if((lcd_stat.bg_priority[2] == x) && (last_bg_priority != 2) && (!do_blending)) { do_blending = render_bg_pixel(BG2CNT); next_bg_priority = 2; }
+		if((lcd_stat.bg_priority[2] == x) && (last_bg_priority != 2) && (!do_blending)) { do_blending = fetch_bg_pixel(2); next_bg_priority = 2; }
 
 		//Blend with BG3
-		if((lcd_stat.bg_priority[3] == x) && (last_bg_priority != 3) && (!do_blending)) { do_blending = render_bg_pixel(BG3CNT); next_bg_priority = 3; }
+		if((lcd_stat.bg_priority[3] == x) && (last_bg_priority != 3) && (!do_blending)) { do_blending = fetch_bg_pixel(3); next_bg_priority = 3; }
 
 		if(do_blending) { x = 4; }
 	}
@@ -1376,40 +1501,25 @@ u32 AGB_LCD::alpha_blend()
 	if((!do_blending) && (lcd_stat.sfx_target[5][1])) { last_raw_color = raw_pal[0][0]; do_blending = true; }
 
 	//If the 2nd target is rendered and not specified for blending, abort 
-	if((do_blending) && (!lcd_stat.sfx_target[next_bg_priority][1])) { return final_color; } 
+	if((do_blending) && (!lcd_stat.sfx_target[next_bg_priority][1])) { return NORMAL; } 
 
 	if(!do_blending) 
 	{
-		//If no alpha-blending occurs, see if Brightness Increase can be applied (for semi-transparent OBJ only)
-		if(lcd_stat.temp_sfx_type == BRIGHTNESS_UP) { return brightness_up(); }
-
-		//If no alpha-blending occurs, see if Brightness Decrease can be applied (for semi-transparent OBJ only)
-		else if(lcd_stat.temp_sfx_type == BRIGHTNESS_DOWN) { return brightness_down(); }
+		//If no alpha-blending occurs, see if Brightness Increase or Decrease can be applied (for semi-transparent OBJ only)
+		if((lcd_stat.temp_sfx_type == BRIGHTNESS_UP) || (lcd_stat.temp_sfx_type == BRIGHTNESS_DOWN))
+		{
+			sfx_line_target_1[scanline_pixel_counter] = sfx_bgr15_to_argb(last_raw_color);
+			return lcd_stat.temp_sfx_type;
+		}
 
 		//If no alpha-blending occurs and no fringe cases occur, abort
-		else { return final_color; }
+		else { return NORMAL; }
 	}
 
-	color_2 = last_raw_color;
+	sfx_line_target_1[scanline_pixel_counter] = sfx_bgr15_to_argb(color_1);
+	sfx_line_target_2[scanline_pixel_counter] = sfx_bgr15_to_argb(last_raw_color);
 
-	//Alpha-blending
-	result = ((color_1 & 0x1F) * lcd_stat.alpha_a_coef) + ((color_2 & 0x1F) * lcd_stat.alpha_b_coef);
-	u8 red = (result > 0x1F) ? 0x1F : result;
-	color_1 >>= 5;
-	color_2 >>= 5;
-
-	result = ((color_1 & 0x1F) * lcd_stat.alpha_a_coef) + ((color_2 & 0x1F) * lcd_stat.alpha_b_coef);
-	u8 green = (result > 0x1F) ? 0x1F : result;
-	color_1 >>= 5;
-	color_2 >>= 5;
-
-	result = ((color_1 & 0x1F) * lcd_stat.alpha_a_coef) + ((color_2 & 0x1F) * lcd_stat.alpha_b_coef);
-	u8 blue = (result > 0x1F) ? 0x1F : result;
-	color_1 >>= 5;
-	color_2 >>= 5;
-
-	//Return 32-bit color
-	return 0xFF000000 | (red << 19) | (green << 11) | (blue << 3);
+	return ALPHA_BLEND;
 }
 
 /****** Immediately draw current buffer to the screen ******/
@@ -1493,6 +1603,27 @@ void AGB_LCD::clear_screen_buffer(u32 color)
 	for(u32 x = 0; x < 0x9600; x++) { screen_buffer[x] = color; }
 }
 
+/****** Cycles until the LCD changes state (mode, scanline, or flags) ******/
+u32 AGB_LCD::cycles_to_event()
+{
+	//Cheats are applied every cycle of HBlank
+	if((config::use_cheats) && (lcd_mode == 1)) { return 1; }
+
+	//Everything happens when the scanline clock reaches 0 (new line), 960 (HBlank in VBlank), or 961 (HBlank)
+	u32 line_clock = lcd_clock % 1232;
+
+	if(line_clock < 960) { return 960 - line_clock; }
+	else if(line_clock == 960) { return 1; }
+	else { return 1232 - line_clock; }
+}
+
+/****** Run LCD for several cycles - Only the last cycle may change LCD state, see cycles_to_event() ******/
+void AGB_LCD::step(u32 cycles)
+{
+	lcd_clock += (cycles - 1);
+	step();
+}
+
 /****** Run LCD for one cycle ******/
 void AGB_LCD::step()
 {
@@ -1554,12 +1685,19 @@ void AGB_LCD::step()
 		//Change mode
 		if(lcd_mode != 1) 
 		{
-			//Render scanline data
-			for(u32 x = 0; x < 256; x++) 
+			//Render scanline data unless frame skipping - Hand it off to the render worker if pipelined
+			if((config::threaded_render) && (render_worker == nullptr)) { start_render_thread(); }
+
+			if(!frame_skip.skip_frame)
 			{
-				render_scanline();
-				if(lcd_stat.current_sfx_type != NORMAL) { apply_sfx(); }
-				scanline_pixel_counter++;
+				if(render_worker != nullptr) { submit_render_line(); }
+
+				else
+				{
+					render_vram = &mem->memory_map.regions[agb_memory_map::VRAM].data[0];
+					render_vram_dirty = mem->vram_dirty;
+					draw_scanline();
+				}
 			}
 
 			//Toggle HBlank flag ON
@@ -1571,24 +1709,6 @@ void AGB_LCD::step()
 			//Raise HBlank interrupt
 			if(mem->memory_map[DISPSTAT] & 0x10) { mem->memory_map[REG_IF] |= 0x2; }
 
-			//Push scanline data to final buffer - Only if Forced Blank is disabled
-			if((lcd_stat.display_control & 0x80) == 0)
-			{
-				for(int x = 0, y = (240 * current_scanline); x < 240; x++, y++)
-				{
-					screen_buffer[y] = scanline_buffer[x];
-				}
-			}
-
-			//Draw all-white during Forced Blank
-			else
-			{
-				for(int x = 0, y = (240 * current_scanline); x < 240; x++, y++)
-				{
-					screen_buffer[y] = 0xFFFFFFFF;
-				}
-			}
-	
 			//Start HBlank DMA
 			mem->start_blank_dma();
 		}
@@ -1608,6 +1728,16 @@ void AGB_LCD::step()
 		{
 			lcd_mode = 2;
 
+			//Collect the finished frame from the render worker
+			if((render_worker != nullptr) && (!frame_skip.skip_frame))
+			{
+				sync_render_thread();
+				std::copy(render_worker->screen_buffer.begin(), render_worker->screen_buffer.begin() + 0x9600, screen_buffer.begin());
+			}
+
+			//Threaded rendering was switched off at runtime, go back to drawing here from the next frame on
+			if((render_worker != nullptr) && (!config::threaded_render)) { stop_render_thread(); }
+
 			//Check for screen resize - CDZ sub screen
 			if((config::request_resize) && (config::resize_mode > 0))
 			{
@@ -1670,13 +1800,13 @@ void AGB_LCD::step()
 			//Jukebox
 			if((config::cart_type == AGB_JUKEBOX) && (mem->jukebox.progress)) { mem->process_jukebox(); }
 
-			//Process Turbo Buttons
-			if(mem->g_pad->turbo_button_enabled) { mem->g_pad->process_turbo_buttons(); }
+			//Process Turbo Buttons - Once per shown frame
+			if((mem->g_pad->turbo_button_enabled) && (!frame_skip.hidden)) { mem->g_pad->process_turbo_buttons(); }
 
 			if(mem->g_pad->is_gb_player) { mem->g_pad->process_gb_rumble(); }
 
-			//Use SDL
-			if(config::sdl_render)
+			//Use SDL - Nothing is blitted for skipped frames
+			if((config::sdl_render) && (!frame_skip.skip_frame))
 			{
 				//If using SDL and no OpenGL, manually stretch for fullscreen via SDL
 				if((config::flags & SDL_WINDOW_FULLSCREEN) && (!config::use_opengl))
@@ -1759,7 +1889,7 @@ void AGB_LCD::step()
 			}
 
 			//Use external rendering method (GUI)
-			else
+			else if((!config::sdl_render) && (!frame_skip.skip_frame))
 			{
 				if(!config::use_opengl)
 				{
@@ -1790,8 +1920,11 @@ void AGB_LCD::step()
 				}
 			}
 
-			//Limit framerate
-			if(!config::turbo)
+			//Decide whether the next frame gets drawn
+			frame_skip.update(SDL_GetTicks(), frame_start_time, frame_delay[fps_count % 60]);
+
+			//Limit framerate - Unpaced frames (run-ahead, rollback) run as fast as possible
+			if((!config::turbo) && (frame_skip.paced))
 			{
 				frame_current_time = SDL_GetTicks();
 				int delay = frame_delay[fps_count % 60];
@@ -1800,7 +1933,8 @@ void AGB_LCD::step()
 			}
 
 			//Update FPS counter + title
-			fps_count++;
+			if(!frame_skip.hidden) { fps_count++; }
+			frame_count++;
 			if(((SDL_GetTicks() - fps_time) >= 1000) && (config::sdl_render))
 			{ 
 				fps_time = SDL_GetTicks(); 
@@ -1877,6 +2011,219 @@ void AGB_LCD::step()
 	}
 }
 
+/****** Starts drawing lines on a separate thread ******/
+void AGB_LCD::start_render_thread()
+{
+	render_worker = new AGB_LCD();
+	render_worker->is_render_worker = true;
+	render_worker->worker_vram.assign(0x20000, 0);
+	render_worker->render_vram = &render_worker->worker_vram[0];
+	render_worker->render_vram_dirty = render_worker->worker_vram_dirty;
+
+	render_records.resize(160);
+	render_lines_submitted = 0;
+	render_lines_drawn = 0;
+	render_thread_quit = false;
+
+	//The worker starts out knowing nothing, so send it all of VRAM, OAM, and palettes
+	render_obj_update = true;
+	render_pal_update = true;
+	memset(mem->vram_dirty, 0xFF, sizeof(mem->vram_dirty));
+
+	render_lock = SDL_CreateMutex();
+	render_signal = SDL_CreateCond();
+	render_thread = SDL_CreateThread(render_thread_main, "GBA LCD", this);
+
+	//Fall back to drawing on the emulation thread
+	if(render_thread == nullptr)
+	{
+		std::cout<<"LCD::Error - Could not start render thread : " << SDL_GetError() << "\n";
+		stop_render_thread();
+		config::threaded_render = false;
+	}
+}
+
+/****** Stops the render thread, any lines not drawn yet are dropped ******/
+void AGB_LCD::stop_render_thread()
+{
+	if(render_worker == nullptr) { return; }
+
+	if(render_thread != nullptr)
+	{
+		SDL_LockMutex(render_lock);
+		render_thread_quit = true;
+		SDL_CondBroadcast(render_signal);
+		SDL_UnlockMutex(render_lock);
+
+		SDL_WaitThread(render_thread, nullptr);
+	}
+
+	SDL_DestroyCond(render_signal);
+	SDL_DestroyMutex(render_lock);
+	delete render_worker;
+
+	render_worker = nullptr;
+	render_thread = nullptr;
+	render_lock = nullptr;
+	render_signal = nullptr;
+
+	//VRAM written while the worker ran only reached the worker, so this LCD's tile cache is stale now
+	if(mem != nullptr) { memset(mem->vram_dirty, 0xFF, sizeof(mem->vram_dirty)); }
+}
+
+/****** Waits until the render thread has drawn every line sent to it ******/
+void AGB_LCD::sync_render_thread()
+{
+	if(render_worker == nullptr) { return; }
+
+	SDL_LockMutex(render_lock);
+
+	while(render_lines_drawn != render_lines_submitted) { SDL_CondWait(render_signal, render_lock); }
+
+	//Records can be reused now
+	render_lines_submitted = 0;
+	render_lines_drawn = 0;
+
+	SDL_UnlockMutex(render_lock);
+}
+
+/****** Records the state needed to draw the current line and sends it to the render thread ******/
+void AGB_LCD::submit_render_line()
+{
+	//Normally 160 lines are sent per frame, but loading a state mid-frame can start another set early
+	if(render_lines_submitted == render_records.size()) { sync_render_thread(); }
+
+	render_line_record& record = render_records[render_lines_submitted];
+
+	record.scanline = current_scanline;
+	memcpy(record.lcd_regs, &lcd_stat, sizeof(record.lcd_regs));
+	record.bg_affine[0] = lcd_stat.bg_affine[0];
+	record.bg_affine[1] = lcd_stat.bg_affine[1];
+	record.mos_size[0] = lcd_stat.bg_mos_hsize;
+	record.mos_size[1] = lcd_stat.bg_mos_vsize;
+	record.mos_size[2] = lcd_stat.obj_mos_hsize;
+	record.mos_size[3] = lcd_stat.obj_mos_vsize;
+
+	memcpy(record.obj_render_list, obj_render_list, sizeof(obj_render_list));
+	record.obj_render_length = obj_render_length;
+
+	record.obj_update = render_obj_update;
+	render_obj_update = false;
+
+	if(record.obj_update)
+	{
+		for(u32 x = 0; x < 128; x++)
+		{
+			record.obj[x] = obj[x];
+			record.obj_affine[x] = lcd_stat.obj_affine[x];
+		}
+	}
+
+	record.pal_update = render_pal_update;
+	render_pal_update = false;
+
+	if(record.pal_update)
+	{
+		memcpy(record.pal, pal, sizeof(pal));
+		memcpy(record.raw_pal, raw_pal, sizeof(raw_pal));
+	}
+
+	//Send every block of VRAM written since the last line
+	u8* vram = &mem->memory_map.regions[agb_memory_map::VRAM].data[0];
+	record.vram_blocks.clear();
+	record.vram_data.clear();
+
+	for(u32 x = 0; x < 0x80; x++)
+	{
+		if(mem->vram_dirty[x] == 0) { continue; }
+
+		for(u32 y = 0; y < 32; y++)
+		{
+			if((mem->vram_dirty[x] & (1 << y)) == 0) { continue; }
+
+			u32 block = (x << 5) | y;
+			record.vram_blocks.push_back(block);
+			record.vram_data.insert(record.vram_data.end(), (vram + (block << 5)), (vram + (block << 5) + 32));
+		}
+
+		mem->vram_dirty[x] = 0;
+	}
+
+	SDL_LockMutex(render_lock);
+	render_lines_submitted++;
+	SDL_CondBroadcast(render_signal);
+	SDL_UnlockMutex(render_lock);
+}
+
+/****** Draws a recorded line - Only called on the render worker ******/
+void AGB_LCD::replay_render_line(render_line_record& record)
+{
+	current_scanline = record.scanline;
+	memcpy(&lcd_stat, record.lcd_regs, sizeof(record.lcd_regs));
+	lcd_stat.bg_affine[0] = record.bg_affine[0];
+	lcd_stat.bg_affine[1] = record.bg_affine[1];
+	lcd_stat.bg_mos_hsize = record.mos_size[0];
+	lcd_stat.bg_mos_vsize = record.mos_size[1];
+	lcd_stat.obj_mos_hsize = record.mos_size[2];
+	lcd_stat.obj_mos_vsize = record.mos_size[3];
+
+	memcpy(obj_render_list, record.obj_render_list, sizeof(obj_render_list));
+	obj_render_length = record.obj_render_length;
+
+	if(record.obj_update)
+	{
+		for(u32 x = 0; x < 128; x++)
+		{
+			obj[x] = record.obj[x];
+			lcd_stat.obj_affine[x] = record.obj_affine[x];
+		}
+	}
+
+	if(record.pal_update)
+	{
+		memcpy(pal, record.pal, sizeof(pal));
+		memcpy(raw_pal, record.raw_pal, sizeof(raw_pal));
+	}
+
+	//Update the private copy of VRAM, decoded tiles are refreshed when next used
+	for(u32 x = 0; x < record.vram_blocks.size(); x++)
+	{
+		u16 block = record.vram_blocks[x];
+		memcpy(&worker_vram[block << 5], &record.vram_data[x << 5], 32);
+		worker_vram_dirty[block >> 5] |= (1 << (block & 0x1F));
+	}
+
+	draw_scanline();
+}
+
+/****** Render thread - Draws lines as they arrive until told to quit ******/
+int AGB_LCD::render_thread_main(void* data)
+{
+	AGB_LCD* lcd = (AGB_LCD*)data;
+
+	SDL_LockMutex(lcd->render_lock);
+
+	while(true)
+	{
+		while((lcd->render_lines_drawn == lcd->render_lines_submitted) && (!lcd->render_thread_quit)) { SDL_CondWait(lcd->render_signal, lcd->render_lock); }
+		if(lcd->render_thread_quit) { break; }
+
+		//Records are never rewritten until drawn, so no need to hold the lock while drawing
+		render_line_record& record = lcd->render_records[lcd->render_lines_drawn];
+		SDL_UnlockMutex(lcd->render_lock);
+
+		lcd->render_worker->replay_render_line(record);
+
+		SDL_LockMutex(lcd->render_lock);
+		lcd->render_lines_drawn++;
+
+		if(lcd->render_lines_drawn == lcd->render_lines_submitted) { SDL_CondBroadcast(lcd->render_signal); }
+	}
+
+	SDL_UnlockMutex(lcd->render_lock);
+	return 0;
+}
+
 /****** Compare VCOUNT to LYC ******/
 void AGB_LCD::scanline_compare()
 {
@@ -1962,100 +2309,88 @@ void AGB_LCD::reload_affine_references(u32 bg_control)
 }
 
 /****** Read LCD data from save state ******/
-bool AGB_LCD::lcd_read(u32 offset, std::string filename)
+void AGB_LCD::lcd_read(state_reader& state)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
+	//Finish any lines still being drawn, then resend OAM and palettes to the render worker
+	sync_render_thread();
+	render_obj_update = true;
+	render_pal_update = true;
 
 	//Serialize LCD data from save state
-	file.read((char*)&lcd_stat, sizeof(lcd_stat));
+	state.read(&lcd_stat, sizeof(lcd_stat));
 
 	//Serialize OBJ data from save state
 	for(int x = 0; x < 128; x++)
 	{
-		file.read((char*)&obj[x], sizeof(obj[x]));
-		file.read((char*)&obj_render_list[x], sizeof(obj_render_list[x]));
+		state.read(&obj[x], sizeof(obj[x]));
+		state.read(&obj_render_list[x], sizeof(obj_render_list[x]));
 	}
 
 	//Serialize Misc LCD data from save state
-	file.read((char*)&lcd_mode, sizeof(lcd_mode));
-	file.read((char*)&current_scanline, sizeof(current_scanline));
-	file.read((char*)&lcd_clock, sizeof(lcd_clock));
-	file.read((char*)&obj_render_length, sizeof(obj_render_length));
-	file.read((char*)&last_obj_priority, sizeof(last_obj_priority));
-	file.read((char*)&last_obj_mode, sizeof(last_obj_mode));
-	file.read((char*)&last_bg_priority, sizeof(last_bg_priority));
-	file.read((char*)&last_raw_color, sizeof(last_raw_color));
-	file.read((char*)&obj_win_pixel, sizeof(obj_win_pixel));
-	file.read((char*)&scanline_pixel_counter, sizeof(scanline_pixel_counter));
+	state.read(&lcd_mode, sizeof(lcd_mode));
+	state.read(&current_scanline, sizeof(current_scanline));
+	state.read(&lcd_clock, sizeof(lcd_clock));
+	state.read(&obj_render_length, sizeof(obj_render_length));
+	state.read(&last_obj_priority, sizeof(last_obj_priority));
+	state.read(&last_obj_mode, sizeof(last_obj_mode));
+	state.read(&last_bg_priority, sizeof(last_bg_priority));
+	state.read(&last_raw_color, sizeof(last_raw_color));
+	state.read(&obj_win_pixel, sizeof(obj_win_pixel));
+	state.read(&scanline_pixel_counter, sizeof(scanline_pixel_counter));
 
 	for(int x = 0; x < 256; x++)
 	{
 		for(int y = 0; y < 2; y++)
 		{
-			file.read((char*)&pal[x][y], sizeof(pal[x][y]));
-			file.read((char*)&raw_pal[x][y], sizeof(raw_pal[x][y]));
+			state.read(&pal[x][y], sizeof(pal[x][y]));
+			state.read(&raw_pal[x][y], sizeof(raw_pal[x][y]));
 		}
 	}
 
 	for(int x = 0; x < 4; x++)
 	{
-		file.read((char*)&bg_offset_x[x], sizeof(bg_offset_x[x]));
-		file.read((char*)&bg_offset_y[x], sizeof(bg_offset_y[x]));
+		state.read(&bg_offset_x[x], sizeof(bg_offset_x[x]));
+		state.read(&bg_offset_y[x], sizeof(bg_offset_y[x]));
 	}
-
-	file.close();
-	return true;
 }
 
 /****** Read LCD data from save state ******/
-bool AGB_LCD::lcd_write(std::string filename)
+void AGB_LCD::lcd_write(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
-
 	//Serialize LCD data to save state
-	file.write((char*)&lcd_stat, sizeof(lcd_stat));
+	state.write(&lcd_stat, sizeof(lcd_stat));
 
 	//Serialize OBJ data to save state
 	for(int x = 0; x < 128; x++)
 	{
-		file.write((char*)&obj[x], sizeof(obj[x]));
-		file.write((char*)&obj_render_list[x], sizeof(obj_render_list[x]));
+		state.write(&obj[x], sizeof(obj[x]));
+		state.write(&obj_render_list[x], sizeof(obj_render_list[x]));
 	}
 
 	//Serialize Misc LCD data to save state
-	file.write((char*)&lcd_mode, sizeof(lcd_mode));
-	file.write((char*)&current_scanline, sizeof(current_scanline));
-	file.write((char*)&lcd_clock, sizeof(lcd_clock));
-	file.write((char*)&obj_render_length, sizeof(obj_render_length));
-	file.write((char*)&last_obj_priority, sizeof(last_obj_priority));
-	file.write((char*)&last_obj_mode, sizeof(last_obj_mode));
-	file.write((char*)&last_bg_priority, sizeof(last_bg_priority));
-	file.write((char*)&last_raw_color, sizeof(last_raw_color));
-	file.write((char*)&obj_win_pixel, sizeof(obj_win_pixel));
-	file.write((char*)&scanline_pixel_counter, sizeof(scanline_pixel_counter));
+	state.write(&lcd_mode, sizeof(lcd_mode));
+	state.write(&current_scanline, sizeof(current_scanline));
+	state.write(&lcd_clock, sizeof(lcd_clock));
+	state.write(&obj_render_length, sizeof(obj_render_length));
+	state.write(&last_obj_priority, sizeof(last_obj_priority));
+	state.write(&last_obj_mode, sizeof(last_obj_mode));
+	state.write(&last_bg_priority, sizeof(last_bg_priority));
+	state.write(&last_raw_color, sizeof(last_raw_color));
+	state.write(&obj_win_pixel, sizeof(obj_win_pixel));
+	state.write(&scanline_pixel_counter, sizeof(scanline_pixel_counter));
 
 	for(int x = 0; x < 256; x++)
 	{
 		for(int y = 0; y < 2; y++)
 		{
-			file.write((char*)&pal[x][y], sizeof(pal[x][y]));
-			file.write((char*)&raw_pal[x][y], sizeof(raw_pal[x][y]));
+			state.write(&pal[x][y], sizeof(pal[x][y]));
+			state.write(&raw_pal[x][y], sizeof(raw_pal[x][y]));
 		}
 	}
 
 	for(int x = 0; x < 4; x++)
 	{
-		file.write((char*)&bg_offset_x[x], sizeof(bg_offset_x[x]));
-		file.write((char*)&bg_offset_y[x], sizeof(bg_offset_y[x]));
+		state.write(&bg_offset_x[x], sizeof(bg_offset_x[x]));
+		state.write(&bg_offset_y[x], sizeof(bg_offset_y[x]));
 	}
-
-	file.close();
-	return true;
 }
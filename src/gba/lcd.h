@@ -12,10 +12,14 @@
 #ifndef GBA_LCD
 #define GBA_LCD
 
+#include <cstddef>
+
 #include "SDL.h"
 #include "mmu.h"
 
 #include "common/gx_util.h"
+#include "common/sfx_kernels.h"
+#include "common/frame_skip.h"
 
 class AGB_LCD
 {
@@ -32,6 +36,8 @@ class AGB_LCD
 	~AGB_LCD();
 
 	void step();
+	void step(u32 cycles);
+	u32 cycles_to_event();
 	void reset();
 	bool init();
 	bool opengl_init();
@@ -39,8 +45,8 @@ class AGB_LCD
 	void clear_screen_buffer(u32 color);
 
 	//Serialize data for save state loading/saving
-	bool lcd_read(u32 offset, std::string filename);
-	bool lcd_write(std::string filename);
+	void lcd_read(state_reader& state);
+	void lcd_write(state_writer& state);
 
 	//Screen data
 	SDL_Window* window;
@@ -51,6 +57,13 @@ class AGB_LCD
 	u32 lcd_clock;
 
 	int max_fullscreen_ratio;
+
+	//Frames completed since the last reset
+	u32 frame_count;
+
+	//Frame skipping, also hides frames while running ahead
+	frame_skipper frame_skip;
+
 	bool power_antenna_osd;
 
 	private:
@@ -128,6 +141,77 @@ class AGB_LCD
 
 	u32 scanline_pixel_counter;
 
+	//Per-line layer buffers, each layer is drawn once per line then composited
+	u32 bg_line_buffer[4][256];
+	u16 bg_line_raw[4][256];
+	bool bg_line_opaque[4][256];
+
+	u32 obj_line_buffer[256];
+	u16 obj_line_raw[256];
+	u8 obj_line_priority[256];
+	u8 obj_line_mode[256];
+	bool obj_line_opaque[256];
+	bool obj_line_win[256];
+
+	//Decoded 4bpp tiles for all of VRAM, 1 palette index per pixel
+	std::vector<u8> tile_cache;
+
+	//Window covering each pixel of the line - 0 or 1 for Window 0/1, 0xFF when outside both
+	u8 window_line[256];
+
+	//SFX picked for each pixel of the line, applied by the SFX kernels after compositing
+	sfx_types sfx_line_type[256];
+	u32 sfx_line_target_1[256];
+	u32 sfx_line_target_2[256];
+	u32 sfx_line_result[256];
+
+	//VRAM read while drawing and its dirty bitmap - The MMU's own, or private copies on the render worker
+	u8* render_vram;
+	u32* render_vram_dirty;
+
+	std::vector<u8> worker_vram;
+	u32 worker_vram_dirty[0x80];
+
+	//Everything needed to draw one line on the render worker, recorded at HBlank
+	struct render_line_record
+	{
+		u8 scanline;
+
+		//Display registers - Everything in lcd_stat before the lookup tables
+		u8 lcd_regs[offsetof(agb_lcd_data, bg_flip_lut)];
+		agb_lcd_data::bg_affine_parameters bg_affine[2];
+		u8 mos_size[4];
+
+		u8 obj_render_list[128];
+		u8 obj_render_length;
+
+		//OAM and palettes are only sent when they change
+		bool obj_update;
+		oam_entries obj[128];
+		float obj_affine[128];
+
+		bool pal_update;
+		u32 pal[256][2];
+		u16 raw_pal[256][2];
+
+		//32 byte blocks of VRAM written since the last line
+		std::vector<u16> vram_blocks;
+		std::vector<u8> vram_data;
+	};
+
+	//Pipelined rendering - Lines are drawn on a worker thread, both sides only wait on each other at VBlank
+	std::vector<render_line_record> render_records;
+	AGB_LCD* render_worker;
+	SDL_Thread* render_thread;
+	SDL_mutex* render_lock;
+	SDL_cond* render_signal;
+	u32 render_lines_submitted;
+	u32 render_lines_drawn;
+	bool render_thread_quit;
+	bool render_obj_update;
+	bool render_pal_update;
+	bool is_render_worker;
+
 	int frame_start_time;
 	int frame_current_time;
 	int fps_count;
@@ -137,20 +221,33 @@ class AGB_LCD
 	bool try_window_rebuild;
 
 	void render_scanline();
-	bool render_sprite_pixel();
-	bool render_bg_pixel(u32 bg_control);
-	bool render_bg_mode_0(u32 bg_control);
-	bool render_bg_mode_1(u32 bg_control);
-	bool render_bg_mode_3();
-	bool render_bg_mode_4();
-	bool render_bg_mode_5();
+	void draw_scanline();
+	void render_obj_line();
+	void render_obj_sprite(u8 sprite_id);
+	void render_bg_line(u8 bg_id);
+	const u8* get_tile_4bpp(u32 tile_addr);
+	void render_bg_mode_0(u8 bg_id);
+	void render_bg_mode_1(u8 bg_id);
+	void render_bg_mode_3(u8 bg_id);
+	void render_bg_mode_4(u8 bg_id);
+	void render_bg_mode_5(u8 bg_id);
+	void render_window_line();
+	void compose_pixel(u8* bg_render_list, bool winout);
+	bool fetch_obj_pixel();
+	bool fetch_bg_pixel(u8 bg_id);
 	void scanline_compare();
 	void reload_affine_references(u32 bg_control);
 
+	void start_render_thread();
+	void stop_render_thread();
+	void sync_render_thread();
+	void submit_render_line();
+	void replay_render_line(render_line_record& record);
+	static int render_thread_main(void* data);
+
 	void apply_sfx();
-	u32 brightness_up();
-	u32 brightness_down();
-	u32 alpha_blend();
+	void apply_sfx_line();
+	sfx_types alpha_blend();
 };
 
 #endif // GBA_LCD
\ No newline at end of file
@@ -0,0 +1,125 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : memory_map.h
+// Date : October 17, 2026
+// Description : GBA memory map
+//
+// Backs each GBA memory region with its own buffer instead of one flat 256MB array
+// Indexing by address still works, so memory_map[address] reaches the right region
+
+#ifndef GBA_MEMORY_MAP
+#define GBA_MEMORY_MAP
+
+#include <vector>
+
+#include "common.h"
+
+//Largest possible ROM, also mirrored at 0xA000000 and 0xC000000
+#define AGB_MAX_ROM_SIZE 0x2000000
+
+struct agb_memory_region
+{
+	std::vector<u8> data;
+	u32 mask;
+};
+
+struct agb_memory_map
+{
+	enum region_types
+	{
+		BIOS,
+		EWRAM,
+		IWRAM,
+		IO,
+		PAL,
+		VRAM,
+		OAM,
+		ROM,
+		EEPROM,
+		SRAM,
+		REGION_COUNT,
+	};
+
+	agb_memory_region regions[REGION_COUNT];
+
+	//Region used by each 16MB block of the address space
+	u8 region_index[16];
+
+	//Unbacked addresses read as zero and drop writes
+	u8 open_bus;
+
+	/****** Access a byte at the given address ******/
+	u8& operator[](u32 address)
+	{
+		if(address < 0x10000000)
+		{
+			agb_memory_region& region = regions[region_index[address >> 24]];
+			u32 offset = address & region.mask;
+
+			if(offset < region.data.size()) { return region.data[offset]; }
+		}
+
+		open_bus = 0;
+		return open_bus;
+	}
+
+	/****** Returns a host pointer to a run of bytes, or NULL if they are not all backed by the same buffer ******/
+	u8* get_pointer(u32 address, u32 length)
+	{
+		if(address >= 0x10000000) { return NULL; }
+
+		agb_memory_region& region = regions[region_index[address >> 24]];
+		u32 offset = address & region.mask;
+
+		if((offset + length) > region.data.size()) { return NULL; }
+		return &region.data[offset];
+	}
+
+	/****** Allocates and clears every region - ROM stays empty until a cart is loaded ******/
+	void reset()
+	{
+		//16KB BIOS is padded to a full 32KB memory page
+		//I/O is only backed for its first 64KB, everything above that reads as zero
+		//EEPROM is a single 16-bit port, mirrored throughout its block
+		set_region(BIOS, 0x8000, 0x1FFFFFF);
+		set_region(EWRAM, 0x40000, 0x3FFFF);
+		set_region(IWRAM, 0x8000, 0x7FFF);
+		set_region(IO, 0x10000, 0xFFFFFF);
+		set_region(PAL, 0x8000, 0x7FFF);
+		set_region(VRAM, 0x20000, 0x1FFFF);
+		set_region(OAM, 0x8000, 0x7FFF);
+		set_region(ROM, 0, (AGB_MAX_ROM_SIZE - 1));
+		set_region(EEPROM, 2, 1);
+		set_region(SRAM, 0x10000, 0xFFFF);
+
+		u8 index[16] = { BIOS, BIOS, EWRAM, IWRAM, IO, PAL, VRAM, OAM, ROM, ROM, ROM, ROM, ROM, EEPROM, SRAM, SRAM };
+		for(u32 x = 0; x < 16; x++) { region_index[x] = index[x]; }
+
+		open_bus = 0;
+	}
+
+	/****** Frees every region ******/
+	void clear()
+	{
+		for(u32 x = 0; x < REGION_COUNT; x++) { regions[x].data.clear(); }
+	}
+
+	/****** Grows or shrinks the ROM buffer, keeping existing data ******/
+	void resize_rom(u32 size)
+	{
+		if(size > AGB_MAX_ROM_SIZE) { size = AGB_MAX_ROM_SIZE; }
+		regions[ROM].data.resize(size, 0);
+	}
+
+	private:
+
+	void set_region(u8 id, u32 size, u32 mask)
+	{
+		regions[id].data.assign(size, 0);
+		regions[id].mask = mask;
+	}
+};
+
+#endif // GBA_MEMORY_MAP
@@ -9,6 +9,7 @@
 // Handles reading and writing bytes to memory locations
 
 #include <filesystem>
+#include <cstring>
 
 #include "mmu.h"
 #include "common/util.h"
@@ -16,13 +17,14 @@
 /****** MMU Constructor ******/
 AGB_MMU::AGB_MMU() 
 {
+	write_backup = ((!config::netplay_local) || (config::netplay_id == 0));
 	reset();
 }
 
 /****** MMU Deconstructor ******/
 AGB_MMU::~AGB_MMU() 
 { 
-	save_backup(config::save_file);
+	if(write_backup) { save_backup(config::save_file); }
 	memory_map.clear();
 
 	#ifdef GBE_NETPLAY
@@ -46,8 +48,9 @@ AGB_MMU::~AGB_MMU()
 /****** MMU Reset ******/
 void AGB_MMU::reset()
 {
-	memory_map.clear();
-	memory_map.resize(0x10000000, 0);
+	memory_map.reset();
+	build_page_tables();
+	std::memset(vram_dirty, 0xFF, sizeof(vram_dirty));
 
 	eeprom.data.clear();
 	eeprom.data.resize(0x200, 0);
@@ -174,6 +177,13 @@ void AGB_MMU::reset()
 
 	g_pad = nullptr;
 	timer = nullptr;
+	timer_pending = 0;
+
+	write_count = 0;
+	timer_read = false;
+
+	code_cache.generation = 0;
+	flush_code_cache();
 
 	//Advanced debugging
 	#ifdef GBE_DEBUG
@@ -312,34 +322,50 @@ u8 AGB_MMU::read_u8(u32 address)
 	switch(address)
 	{
 		case TM0CNT_L:
+			sync_timers();
+			timer_read = true;
 			return (timer->at(0).counter & 0xFF);
 			break;
 
 		case TM0CNT_L+1:
+			sync_timers();
+			timer_read = true;
 			return (timer->at(0).counter >> 8);
 			break;
 
 		case TM1CNT_L:
+			sync_timers();
+			timer_read = true;
 			return (timer->at(1).counter & 0xFF);
 			break;
 
 		case TM1CNT_L+1:
+			sync_timers();
+			timer_read = true;
 			return (timer->at(1).counter >> 8);
 			break;
 
 		case TM2CNT_L:
+			sync_timers();
+			timer_read = true;
 			return (timer->at(2).counter & 0xFF);
 			break;
 
 		case TM2CNT_L+1:
+			sync_timers();
+			timer_read = true;
 			return (timer->at(2).counter >> 8);
 			break;
 
 		case TM3CNT_L:
+			sync_timers();
+			timer_read = true;
 			return (timer->at(3).counter & 0xFF);
 			break;
 
 		case TM3CNT_L+1:
+			sync_timers();
+			timer_read = true;
 			return (timer->at(3).counter >> 8);
 			break;
 
@@ -573,12 +599,40 @@ u8 AGB_MMU::read_u8(u32 address)
 /****** Read 2 bytes from memory ******/
 u16 AGB_MMU::read_u16(u32 address)
 {
+	//Aligned reads from memory without side effects go straight to the page
+	#ifndef GBE_DEBUG
+	if(((address & 0x1) == 0) && ((address >> MEM_PAGE_SHIFT) < MEM_PAGE_COUNT))
+	{
+		u8* page = read_pages[address >> MEM_PAGE_SHIFT];
+
+		if(page != NULL)
+		{
+			page += (address & (MEM_PAGE_SIZE - 1));
+			return (page[0] | (page[1] << 8));
+		}
+	}
+	#endif
+
 	return (read_u8(address) | (read_u8(address+1) << 8) ); 
 }
 
 /****** Read 4 bytes from memory ******/
 u32 AGB_MMU::read_u32(u32 address)
 {
+	//Aligned reads from memory without side effects go straight to the page
+	#ifndef GBE_DEBUG
+	if(((address & 0x3) == 0) && ((address >> MEM_PAGE_SHIFT) < MEM_PAGE_COUNT))
+	{
+		u8* page = read_pages[address >> MEM_PAGE_SHIFT];
+
+		if(page != NULL)
+		{
+			page += (address & (MEM_PAGE_SIZE - 1));
+			return (page[0] | (page[1] << 8) | (page[2] << 16) | (page[3] << 24));
+		}
+	}
+	#endif
+
 	return (read_u8(address) |  (read_u8(address+1) << 8) | (read_u8(address+2) << 16) | (read_u8(address+3) << 24));
 }
 
@@ -603,16 +657,22 @@ void AGB_MMU::write_u8(u32 address, u8 value)
 	debug_addr[address & 0x3] = address;
 	#endif
 
+	write_count++;
+
 	//Check for unused memory and mirrors first
 	switch(address >> 24)
 	{
 		case 0x0:
 		case 0x1:
 		case 0x4:
-		case 0x6:
 		case 0x9:
 			break;
 
+		//VRAM
+		case 0x6:
+			mark_vram_dirty(address);
+			break;
+
 		//Slow WRAM 256KB mirror
 		case 0x2:
 			address &= 0x203FFFF;
@@ -678,6 +738,9 @@ void AGB_MMU::write_u8(u32 address, u8 value)
 	//BIOS is read-only, prevent any attempted writes
 	if((address <= 0x3FFF) && (bios_lock)) { return; }
 
+	//Drop any cached code this write modifies
+	if((!code_cache.blocks.empty()) && (memory_map[address] != value)) { invalidate_code(address); }
+
 	switch(address)
 	{
 		//Display Control
@@ -1819,6 +1882,8 @@ void AGB_MMU::write_u8(u32 address, u8 value)
 		case TM0CNT_H:
 		case TM0CNT_H+1:
 			{
+				sync_timers();
+
 				bool prev_enable = (memory_map[TM0CNT_H] & 0x80) ?  true : false;
 				memory_map[address] = value;
 
@@ -1841,6 +1906,8 @@ void AGB_MMU::write_u8(u32 address, u8 value)
 		case TM1CNT_H:
 		case TM1CNT_H+1:
 			{
+				sync_timers();
+
 				bool prev_enable = (memory_map[TM1CNT_H] & 0x80) ?  true : false;
 				memory_map[address] = value;
 
@@ -1866,6 +1933,8 @@ void AGB_MMU::write_u8(u32 address, u8 value)
 		case TM2CNT_H:
 		case TM2CNT_H+1:
 			{
+				sync_timers();
+
 				bool prev_enable = (memory_map[TM2CNT_H] & 0x80) ?  true : false;
 				memory_map[address] = value;
 
@@ -1891,6 +1960,8 @@ void AGB_MMU::write_u8(u32 address, u8 value)
 		case TM3CNT_H:
 		case TM3CNT_H+1:
 			{
+				sync_timers();
+
 				bool prev_enable = (memory_map[TM3CNT_H] & 0x80) ?  true : false;
 				memory_map[address] = value;
 
@@ -2162,6 +2233,29 @@ void AGB_MMU::write_u8(u32 address, u8 value)
 /****** Write 2 bytes into memory ******/
 void AGB_MMU::write_u16(u32 address, u16 value)
 {
+	//Aligned writes to memory without side effects go straight to the page
+	#ifndef GBE_DEBUG
+	if(((address & 0x1) == 0) && ((address >> MEM_PAGE_SHIFT) < MEM_PAGE_COUNT))
+	{
+		u8* page = write_pages[address >> MEM_PAGE_SHIFT];
+
+		if(page != NULL)
+		{
+			page += (address & (MEM_PAGE_SIZE - 1));
+
+			//Drop any cached code this write modifies
+			if((!code_cache.blocks.empty()) && ((page[0] | (page[1] << 8)) != value)) { invalidate_code(address); }
+
+			page[0] = (value & 0xFF);
+			page[1] = ((value >> 8) & 0xFF);
+			write_count++;
+
+			if((address >> 24) == 0x6) { mark_vram_dirty(address); }
+			return;
+		}
+	}
+	#endif
+
 	write_u8(address, (value & 0xFF));
 	write_u8((address+1), ((value >> 8) & 0xFF));
 }
@@ -2169,6 +2263,31 @@ void AGB_MMU::write_u16(u32 address, u16 value)
 /****** Write 4 bytes into memory ******/
 void AGB_MMU::write_u32(u32 address, u32 value)
 {
+	//Aligned writes to memory without side effects go straight to the page
+	#ifndef GBE_DEBUG
+	if(((address & 0x3) == 0) && ((address >> MEM_PAGE_SHIFT) < MEM_PAGE_COUNT))
+	{
+		u8* page = write_pages[address >> MEM_PAGE_SHIFT];
+
+		if(page != NULL)
+		{
+			page += (address & (MEM_PAGE_SIZE - 1));
+
+			//Drop any cached code this write modifies
+			if((!code_cache.blocks.empty()) && ((page[0] | (page[1] << 8) | (page[2] << 16) | (u32(page[3]) << 24)) != value)) { invalidate_code(address); }
+
+			page[0] = (value & 0xFF);
+			page[1] = ((value >> 8) & 0xFF);
+			page[2] = ((value >> 16) & 0xFF);
+			page[3] = ((value >> 24) & 0xFF);
+			write_count++;
+
+			if((address >> 24) == 0x6) { mark_vram_dirty(address); }
+			return;
+		}
+	}
+	#endif
+
 	write_u8(address, (value & 0xFF));
 	write_u8((address+1), ((value >> 8) & 0xFF));
 	write_u8((address+2), ((value >> 16) & 0xFF));
@@ -2220,6 +2339,28 @@ bool AGB_MMU::read_file(std::string filename)
 	u32 file_size = (config::use_am3_folder) ? 0 : util::get_file_size(filename);
 	if(!file_size && !config::use_am3_folder) { return util::report_error(filename, util::FILE_SIZE_ZERO); }
 
+	if(file_size > AGB_MAX_ROM_SIZE)
+	{
+		std::cout<<"MMU::Warning - ROM size exceeds 32MB, truncating\n";
+		file_size = AGB_MAX_ROM_SIZE;
+	}
+
+	//Special carts map registers throughout ROM, so give them the full 32MB
+	//Otherwise only allocate what the ROM needs, rounded up to a whole memory page
+	switch(config::cart_type)
+	{
+		case AGB_AM3:
+		case AGB_JUKEBOX:
+		case AGB_PLAY_YAN:
+		case AGB_CAMPHO:
+		case AGB_TV_TUNER:
+			memory_map.resize_rom(AGB_MAX_ROM_SIZE);
+			break;
+
+		default:
+			memory_map.resize_rom((file_size + MEM_PAGE_SIZE - 1) & ~(MEM_PAGE_SIZE - 1));
+	}
+
 	u8* ex_mem = &memory_map[0x8000000];
 
 	//For AM3 SmartMedia card dumps, only read 1st 1KB
@@ -2292,18 +2433,14 @@ bool AGB_MMU::read_file(std::string filename)
 	{
 		std::cout<<"MMU::Classic NES Title Detected\n";
 
+		memory_map.resize_rom(AGB_MAX_ROM_SIZE);
+
 		for(u32 x = (0x8000000 + file_size), y = 0; x < 0xA000000; x++, y++)
 		{
 			memory_map[x] = memory_map[0x8000000 + (y % file_size)];
 		}
 	}
 
-	for(u32 x = 0; x < file_size; x++)
-	{
-		memory_map[0xA000000 + x] = memory_map[0x8000000 + x];
-		memory_map[0xC000000 + x] = memory_map[0x8000000 + x];
-	}
-
 	std::string title = "";
 	for(u32 x = 0; x < 12; x++) { title += memory_map[0x80000A0 + x]; }
 
@@ -2325,22 +2462,32 @@ bool AGB_MMU::read_file(std::string filename)
 	{
 		std::string patch_file = util::get_filename_no_ext(filename);
 
+		//Patches may grow the ROM, so give them the full 32MB to work with
+		std::vector<u8>& rom_data = memory_map.regions[agb_memory_map::ROM].data;
+		u32 rom_size = rom_data.size();
+		memory_map.resize_rom(AGB_MAX_ROM_SIZE);
+
 		//Attempt a IPS patch
-		bool patch_pass = util::patch_ips((patch_file + ".ips"), memory_map, 0x8000000, 0x2000000);
+		bool patch_pass = util::patch_ips((patch_file + ".ips"), rom_data, 0, (AGB_MAX_ROM_SIZE - 1));
 
 		//Attempt a UPS patch
 		if(!patch_pass)
 		{
-			patch_pass = util::patch_ups((patch_file + ".ups"), memory_map, 0x8000000, 0x2000000);
+			patch_pass = util::patch_ups((patch_file + ".ups"), rom_data, 0, (AGB_MAX_ROM_SIZE - 1));
 		}
 
 		//Attempt a BPS patch
 		if(!patch_pass)
 		{
-			patch_pass = util::patch_bps((patch_file + ".bps"), memory_map, 0x8000000, 0x2000000);
-		}		
+			patch_pass = util::patch_bps((patch_file + ".bps"), rom_data, 0, (AGB_MAX_ROM_SIZE - 1));
+		}
+
+		if(!patch_pass) { memory_map.resize_rom(rom_size); }
 	}
 
+	//ROM may have moved in host memory
+	build_page_tables();
+
 	//Calculate 8-bit checksum
 	u8 checksum = 0;
 
@@ -2437,6 +2584,7 @@ bool AGB_MMU::read_file(std::string filename)
 					{
 						std::cout<<"MMU::8M DACS FLASH save type detected\n";
 						current_save_type = DACS;
+						resize_dacs();
 						config::save_file = filename;
 						return true;
 					}
@@ -2509,6 +2657,7 @@ bool AGB_MMU::read_file(std::string filename)
 		case AGB_DACS_FLASH:
 			std::cout<<"MMU::Forcing 8M DACS FLASH save type\n";
 			current_save_type = DACS;
+			resize_dacs();
 			config::save_file = filename;
 			return true;
 
@@ -2584,6 +2733,9 @@ bool AGB_MMU::read_bios(std::string filename)
 		file.close();
 		return false;
 	}
+
+	//Only the first 16KB are mapped as BIOS
+	file_size = 0x4000;
 	
 	u8* ex_mem = &memory_map[0];
 
@@ -3183,6 +3335,13 @@ void AGB_MMU::flash_erase_sector(u32 sector)
 	}
 }
 
+/****** Expands ROM to the full 32MB for 8M DACS FLASH, which is saved back as a whole ******/
+void AGB_MMU::resize_dacs()
+{
+	memory_map.resize_rom(AGB_MAX_ROM_SIZE);
+	build_page_tables();
+}
+
 /****** Read 8-bit data from 8M DACS FLASH cartridge or its commands ******/
 u8 AGB_MMU::read_dacs(u32 address)
 {
@@ -3574,6 +3733,249 @@ void AGB_MMU::magic_watch_recv()
 	}		
 }
 
+/****** Applies cycles elapsed since the last update to the timer counters - Returns a bitmask of timers that overflowed ******/
+u8 AGB_MMU::sync_timers()
+{
+	u8 overflow = 0;
+
+	for(u32 x = 0; x < 4; x++)
+	{
+		gba_timer& current_timer = timer->at(x);
+
+		//Count-up timers are only incremented by the previous timer
+		if((!current_timer.enable) || (current_timer.count_up) || (current_timer.prescalar == 0)) { continue; }
+
+		//Overflows are scheduled by the CPU, so a counter never passes more than one between updates
+		u32 timer_cycles = current_timer.cycles + timer_pending;
+		u32 counter = current_timer.counter + (timer_cycles / current_timer.prescalar);
+
+		if(counter > 0xFFFF) { overflow |= (1 << x); }
+
+		current_timer.counter = counter;
+		current_timer.cycles = timer_cycles % current_timer.prescalar;
+	}
+
+	timer_pending = 0;
+	return overflow;
+}
+
+/****** Invalidates cached code blocks after a write to memory ******/
+void AGB_MMU::invalidate_code(u32 address)
+{
+	u32 page = 0;
+
+	switch(address >> 24)
+	{
+		//EWRAM and IWRAM - Only drop blocks from the written page
+		case 0x2: page = (address & 0x3FFFF) >> BLOCK_PAGE_SHIFT; break;
+		case 0x3: page = BLOCK_EWRAM_PAGES + ((address & 0x7FFF) >> BLOCK_PAGE_SHIFT); break;
+
+		//ROM and its mirrors - Writes are rare, so drop everything
+		case 0x8:
+		case 0x9:
+			flush_code_cache();
+			return;
+
+		default: return;
+	}
+
+	if(code_cache.page_blocks[page].empty()) { return; }
+
+	//Count how often this page drops code, to detect self-modifying code
+	if(code_cache.page_invalidations[page] < BLOCK_MAX_INVALIDATIONS) { code_cache.page_invalidations[page]++; }
+
+	drop_code_page(page);
+}
+
+/****** Removes every cached code block living in an EWRAM or IWRAM page ******/
+void AGB_MMU::drop_code_page(u32 page)
+{
+	std::vector<u32>& page_list = code_cache.page_blocks[page];
+	if(page_list.empty()) { return; }
+
+	for(u32 x = 0; x < page_list.size(); x++)
+	{
+		auto block = code_cache.blocks.find(page_list[x]);
+		if(block == code_cache.blocks.end()) { continue; }
+
+		if(code_cache.current_block == &block->second) { code_cache.current_block = nullptr; }
+		code_cache.blocks.erase(block);
+	}
+
+	page_list.clear();
+	code_cache.generation++;
+}
+
+/****** Removes every cached code block ******/
+void AGB_MMU::flush_code_cache()
+{
+	code_cache.blocks.clear();
+	code_cache.page_blocks.clear();
+	code_cache.page_blocks.resize(BLOCK_EWRAM_PAGES + BLOCK_IWRAM_PAGES);
+	code_cache.page_invalidations.assign(BLOCK_EWRAM_PAGES + BLOCK_IWRAM_PAGES, 0);
+	code_cache.current_block = nullptr;
+	code_cache.enable = config::use_block_cache;
+	code_cache.generation++;
+}
+
+/****** Loads WRAM or VRAM from a save state - Only blocks that actually change drop cached code or decoded tiles ******/
+void AGB_MMU::read_state_memory(state_reader& state, u32 address, u32 length)
+{
+	state_scratch.resize(length);
+	state.read(&state_scratch[0], length);
+
+	//Compare 32 bytes at a time, the size of one VRAM dirty bit
+	for(u32 offset = 0; offset < length; offset += 32)
+	{
+		u8* current = &memory_map[address + offset];
+		if(!memcmp(current, &state_scratch[offset], 32)) { continue; }
+
+		memcpy(current, &state_scratch[offset], 32);
+
+		switch(address >> 24)
+		{
+			case 0x2: drop_code_page(offset >> BLOCK_PAGE_SHIFT); break;
+			case 0x3: drop_code_page(BLOCK_EWRAM_PAGES + (offset >> BLOCK_PAGE_SHIFT)); break;
+			case 0x6: mark_vram_dirty(address + offset); break;
+		}
+	}
+
+	//The PC may now point anywhere, so look up the next block from scratch
+	code_cache.current_block = nullptr;
+}
+
+/****** Maps memory regions without side effects to host pointers for fast access ******/
+void AGB_MMU::build_page_tables()
+{
+	read_pages.assign(MEM_PAGE_COUNT, NULL);
+	write_pages.assign(MEM_PAGE_COUNT, NULL);
+
+	//Special carts map registers into ROM, so leave all of it on the slow path
+	bool fast_rom = true;
+
+	switch(config::cart_type)
+	{
+		case AGB_AM3:
+		case AGB_JUKEBOX:
+		case AGB_PLAY_YAN:
+		case AGB_CAMPHO:
+		case AGB_TV_TUNER:
+			fast_rom = false;
+			break;
+
+		default: break;
+	}
+
+	for(u32 page = 0; page < MEM_PAGE_COUNT; page++)
+	{
+		u32 address = (page << MEM_PAGE_SHIFT);
+		u32 offset = address;
+		bool can_read = true;
+		bool can_write = false;
+
+		switch(address >> 24)
+		{
+			//BIOS and VRAM
+			case 0x0:
+			case 0x1:
+				break;
+
+			case 0x6:
+				can_write = true;
+				break;
+
+			//Slow WRAM 256KB mirror
+			case 0x2:
+				offset &= 0x203FFFF;
+				can_write = true;
+				break;
+
+			//Fast WRAM 32KB mirror
+			case 0x3:
+				offset &= 0x3007FFF;
+				can_write = true;
+				break;
+
+			//Pallete RAM and OAM 32KB mirrors - Writes must update the LCD
+			case 0x5:
+			case 0x7:
+				offset &= 0xF007FFF;
+				break;
+
+			//ROM and mirrors - The first page holds GPIO registers
+			case 0x8:
+			case 0x9:
+			case 0xA:
+			case 0xB:
+			case 0xC:
+				if((address & 0xFFFFFF) == 0) { can_read = false; }
+				else if(!fast_rom) { can_read = false; }
+				else if(address >= 0xC000000) { offset -= 0x4000000; }
+				else if(address >= 0xA000000) { offset -= 0x2000000; }
+				break;
+
+			//I/O, EEPROM, and save data
+			default:
+				can_read = false;
+		}
+
+		if(can_read) { read_pages[page] = memory_map.get_pointer(offset, MEM_PAGE_SIZE); }
+		if(can_write) { write_pages[page] = memory_map.get_pointer(offset, MEM_PAGE_SIZE); }
+	}
+}
+
+/****** Returns a host pointer to memory without side effects and how many bytes follow it contiguously ******/
+u8* AGB_MMU::get_host_span(u32 address, u32& length, bool write)
+{
+	length = 0;
+
+	//Debugging needs to see every access
+	#ifdef GBE_DEBUG
+	return NULL;
+	#endif
+
+	u32 page = (address >> MEM_PAGE_SHIFT);
+	if(page >= MEM_PAGE_COUNT) { return NULL; }
+
+	std::vector<u8*>& pages = (write) ? write_pages : read_pages;
+	if(pages[page] == NULL) { return NULL; }
+
+	u8* host_ptr = pages[page] + (address & (MEM_PAGE_SIZE - 1));
+	length = MEM_PAGE_SIZE - (address & (MEM_PAGE_SIZE - 1));
+
+	//Extend across following pages as long as they continue the same buffer
+	while(((page + 1) < MEM_PAGE_COUNT) && (pages[page + 1] != NULL) && (pages[page + 1] == (pages[page] + MEM_PAGE_SIZE)))
+	{
+		page++;
+		length += MEM_PAGE_SIZE;
+	}
+
+	return host_ptr;
+}
+
+/****** Handles bookkeeping after memory was written directly through a host pointer ******/
+void AGB_MMU::notify_host_write(u32 address, u32 length)
+{
+	write_count++;
+
+	if((address >> 24) == 0x6) { mark_vram_dirty(address, length); }
+
+	if(code_cache.blocks.empty() || (length == 0)) { return; }
+
+	//Drop cached code from every page touched
+	for(u32 x = 0; x < length; x += (1 << BLOCK_PAGE_SHIFT)) { invalidate_code(address + x); }
+	invalidate_code(address + length - 1);
+}
+
+/****** Flags every 32 byte block of VRAM within a range as modified ******/
+void AGB_MMU::mark_vram_dirty(u32 address, u32 length)
+{
+	if(length == 0) { return; }
+
+	for(u32 x = 0; x < length; x += 32) { mark_vram_dirty(address + x); }
+	mark_vram_dirty(address + length - 1);
+}
+
 /****** Points the MMU to an lcd_data structure (FROM THE LCD ITSELF) ******/
 void AGB_MMU::set_lcd_data(agb_lcd_data* ex_lcd_stat) { lcd_stat = ex_lcd_stat; }
 
@@ -3587,247 +3989,177 @@ void AGB_MMU::set_sio_data(agb_sio_data* ex_sio_stat) { sio_stat = ex_sio_stat;
 void AGB_MMU::set_mw_data(mag_watch* ex_mw_data) { mw = ex_mw_data; }
 
 /****** Read MMU data from save state ******/
-bool AGB_MMU::mmu_read(u32 offset, std::string filename)
+void AGB_MMU::mmu_read(state_reader& state)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
-
-	//Serialize WRAM from save state
-	u8* ex_mem = &memory_map[0x2000000];
-	file.read((char*)ex_mem, 0x40000);
+	//Timers are loaded fully up to date
+	timer_pending = 0;
 
-	//Serialize WRAM from save state
-	ex_mem = &memory_map[0x3000000];
-	file.read((char*)ex_mem, 0x8000);
+	//Serialize WRAM from save state - Only cached code on changed pages is dropped
+	read_state_memory(state, 0x2000000, 0x40000);
+	read_state_memory(state, 0x3000000, 0x8000);
 
 	//Serialize IO registers from save state
-	ex_mem = &memory_map[0x4000000];
-	file.read((char*)ex_mem, 0x400);
+	u8* ex_mem = &memory_map[0x4000000];
+	state.read(ex_mem, 0x400);
 
 	//Serialize BG and OBJ palettes from save state
 	ex_mem = &memory_map[0x5000000];
-	file.read((char*)ex_mem, 0x400);
+	state.read(ex_mem, 0x400);
 
-	//Serialize VRAM from save state
-	ex_mem = &memory_map[0x6000000];
-	file.read((char*)ex_mem, 0x18000);
+	//Serialize VRAM from save state - Only changed tiles are marked dirty
+	read_state_memory(state, 0x6000000, 0x18000);
 
 	//Serialize OAM from save state
 	ex_mem = &memory_map[0x7000000];
-	file.read((char*)ex_mem, 0x400);
+	state.read(ex_mem, 0x400);
 
 	//Serialize SRAM from save state
 	ex_mem = &memory_map[0xE000000];
-	file.read((char*)ex_mem, 0x10000);
+	state.read(ex_mem, 0x10000);
 
 	//Serialize misc data from MMU from save state
-	file.read((char*)&current_save_type, sizeof(current_save_type));
-	file.read((char*)&n_clock, sizeof(n_clock));
-	file.read((char*)&s_clock, sizeof(s_clock));
-	file.read((char*)&bios_lock, sizeof(bios_lock));
-	file.read((char*)&dma[0], sizeof(dma[0]));
-	file.read((char*)&dma[1], sizeof(dma[1]));
-	file.read((char*)&dma[2], sizeof(dma[2]));
-	file.read((char*)&dma[3], sizeof(dma[3]));
-	file.read((char*)&gpio, sizeof(gpio));
+	state.read(&current_save_type, sizeof(current_save_type));
+	state.read(&n_clock, sizeof(n_clock));
+	state.read(&s_clock, sizeof(s_clock));
+	state.read(&bios_lock, sizeof(bios_lock));
+	state.read(&dma[0], sizeof(dma[0]));
+	state.read(&dma[1], sizeof(dma[1]));
+	state.read(&dma[2], sizeof(dma[2]));
+	state.read(&dma[3], sizeof(dma[3]));
+	state.read(&gpio, sizeof(gpio));
 
 	//Serialize EEPROM from save state
-	file.read((char*)&eeprom.bitstream_byte, sizeof(eeprom.bitstream_byte));
-	file.read((char*)&eeprom.address, sizeof(eeprom.address));
-	file.read((char*)&eeprom.dma_ptr, sizeof(eeprom.dma_ptr));
-	file.read((char*)&eeprom.size, sizeof(eeprom.size));
-	file.read((char*)&eeprom.size_lock, sizeof(eeprom.size_lock));
-	file.read((char*)&eeprom.data[0], eeprom.size);
+	state.read(&eeprom.bitstream_byte, sizeof(eeprom.bitstream_byte));
+	state.read(&eeprom.address, sizeof(eeprom.address));
+	state.read(&eeprom.dma_ptr, sizeof(eeprom.dma_ptr));
+	state.read(&eeprom.size, sizeof(eeprom.size));
+	state.read(&eeprom.size_lock, sizeof(eeprom.size_lock));
+
+	//Only 512 byte and 8KB EEPROMs exist, any other size would overrun the buffer and fails once the chunk is closed
+	if((eeprom.size == 0x200) || (eeprom.size == 0x2000)) { eeprom.data.resize(eeprom.size, 0); }
+	else { eeprom.size = eeprom.data.size(); }
+
+	state.read(&eeprom.data[0], eeprom.size);
 
 	//Serialize FLASH RAM from save state
-	file.read((char*)&flash_ram.current_command, sizeof(flash_ram.current_command));
-	file.read((char*)&flash_ram.bank, sizeof(flash_ram.bank));
-	file.read((char*)&flash_ram.write_single_byte, sizeof(flash_ram.write_single_byte));
-	file.read((char*)&flash_ram.switch_bank, sizeof(flash_ram.switch_bank));
-	file.read((char*)&flash_ram.grab_ids, sizeof(flash_ram.grab_ids));
-	file.read((char*)&flash_ram.next_write, sizeof(flash_ram.next_write));
-	file.read((char*)&flash_ram.data[0][0], 0x10000);
-	file.read((char*)&flash_ram.data[1][0], 0x10000);
+	state.read(&flash_ram.current_command, sizeof(flash_ram.current_command));
+	state.read(&flash_ram.bank, sizeof(flash_ram.bank));
+	state.read(&flash_ram.write_single_byte, sizeof(flash_ram.write_single_byte));
+	state.read(&flash_ram.switch_bank, sizeof(flash_ram.switch_bank));
+	state.read(&flash_ram.grab_ids, sizeof(flash_ram.grab_ids));
+	state.read(&flash_ram.next_write, sizeof(flash_ram.next_write));
+	state.read(&flash_ram.data[0][0], 0x10000);
+	state.read(&flash_ram.data[1][0], 0x10000);
 
 	//Serialize AM3 data from save state
 	if(config::cart_type == AGB_AM3)
 	{
-		file.read((char*)&am3.read_sm_card, sizeof(am3.read_sm_card));
-		file.read((char*)&am3.read_key, sizeof(am3.read_key));
-		file.read((char*)&am3.op_delay, sizeof(am3.op_delay));
-		file.read((char*)&am3.transfer_delay, sizeof(am3.transfer_delay));
-		file.read((char*)&am3.base_addr, sizeof(am3.base_addr));
-		file.read((char*)&am3.blk_stat, sizeof(am3.blk_stat));
-		file.read((char*)&am3.blk_size, sizeof(am3.blk_size));
-		file.read((char*)&am3.blk_addr, sizeof(am3.blk_addr));
-		file.read((char*)&am3.smc_offset, sizeof(am3.smc_offset));
-		file.read((char*)&am3.last_offset, sizeof(am3.last_offset));
-		file.read((char*)&am3.smc_size, sizeof(am3.smc_size));
-		file.read((char*)&am3.smc_base, sizeof(am3.smc_base));
-		file.read((char*)&am3.file_index, sizeof(am3.file_index));
-		file.read((char*)&am3.file_count, sizeof(am3.file_count));
-		file.read((char*)&am3.file_size, sizeof(am3.file_size));
-		file.read((char*)&am3.remaining_size, sizeof(am3.remaining_size));
-		file.read((char*)&am3.file_size_list[0], (sizeof(u32) * am3.file_size_list.size()));
-		file.read((char*)&am3.file_addr_list[0], (sizeof(u32) * am3.file_addr_list.size()));
-		file.read((char*)&am3.smid[0], 0x10);
-		file.read((char*)&memory_map[0x8000000], 0x400);
+		state.read(&am3.read_sm_card, sizeof(am3.read_sm_card));
+		state.read(&am3.read_key, sizeof(am3.read_key));
+		state.read(&am3.op_delay, sizeof(am3.op_delay));
+		state.read(&am3.transfer_delay, sizeof(am3.transfer_delay));
+		state.read(&am3.base_addr, sizeof(am3.base_addr));
+		state.read(&am3.blk_stat, sizeof(am3.blk_stat));
+		state.read(&am3.blk_size, sizeof(am3.blk_size));
+		state.read(&am3.blk_addr, sizeof(am3.blk_addr));
+		state.read(&am3.smc_offset, sizeof(am3.smc_offset));
+		state.read(&am3.last_offset, sizeof(am3.last_offset));
+		state.read(&am3.smc_size, sizeof(am3.smc_size));
+		state.read(&am3.smc_base, sizeof(am3.smc_base));
+		state.read(&am3.file_index, sizeof(am3.file_index));
+		state.read(&am3.file_count, sizeof(am3.file_count));
+		state.read(&am3.file_size, sizeof(am3.file_size));
+		state.read(&am3.remaining_size, sizeof(am3.remaining_size));
+		state.read(&am3.file_size_list[0], (sizeof(u32) * am3.file_size_list.size()));
+		state.read(&am3.file_addr_list[0], (sizeof(u32) * am3.file_addr_list.size()));
+		state.read(&am3.smid[0], 0x10);
+		state.read(&memory_map[0x8000000], 0x400);
 	}
-
-	file.close();
-	return true;
 }
 
 /****** Write MMU data to save state ******/
-bool AGB_MMU::mmu_write(std::string filename)
+void AGB_MMU::mmu_write(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
-
 	//Serialize WRAM to save state
 	u8* ex_mem = &memory_map[0x2000000];
-	file.write((char*)ex_mem, 0x40000);
+	state.write(ex_mem, 0x40000);
 
 	//Serialize WRAM to save state
 	ex_mem = &memory_map[0x3000000];
-	file.write((char*)ex_mem, 0x8000);
+	state.write(ex_mem, 0x8000);
 
 	//Serialize IO registers to save state
 	ex_mem = &memory_map[0x4000000];
-	file.write((char*)ex_mem, 0x400);
+	state.write(ex_mem, 0x400);
 
 	//Serialize BG and OBJ palettes to save state
 	ex_mem = &memory_map[0x5000000];
-	file.write((char*)ex_mem, 0x400);
+	state.write(ex_mem, 0x400);
 
 	//Serialize VRAM to save state
 	ex_mem = &memory_map[0x6000000];
-	file.write((char*)ex_mem, 0x18000);
+	state.write(ex_mem, 0x18000);
 
 	//Serialize OAM to save state
 	ex_mem = &memory_map[0x7000000];
-	file.write((char*)ex_mem, 0x400);
+	state.write(ex_mem, 0x400);
 
 	//Serialize SRAM to save state
 	ex_mem = &memory_map[0xE000000];
-	file.write((char*)ex_mem, 0x10000);
+	state.write(ex_mem, 0x10000);
 
 	//Serialize misc data from MMU to save state
-	file.write((char*)&current_save_type, sizeof(current_save_type));
-	file.write((char*)&n_clock, sizeof(n_clock));
-	file.write((char*)&s_clock, sizeof(s_clock));
-	file.write((char*)&bios_lock, sizeof(bios_lock));
-	file.write((char*)&dma[0], sizeof(dma[0]));
-	file.write((char*)&dma[1], sizeof(dma[1]));
-	file.write((char*)&dma[2], sizeof(dma[2]));
-	file.write((char*)&dma[3], sizeof(dma[3]));
-	file.write((char*)&gpio, sizeof(gpio));
+	state.write(&current_save_type, sizeof(current_save_type));
+	state.write(&n_clock, sizeof(n_clock));
+	state.write(&s_clock, sizeof(s_clock));
+	state.write(&bios_lock, sizeof(bios_lock));
+	state.write(&dma[0], sizeof(dma[0]));
+	state.write(&dma[1], sizeof(dma[1]));
+	state.write(&dma[2], sizeof(dma[2]));
+	state.write(&dma[3], sizeof(dma[3]));
+	state.write(&gpio, sizeof(gpio));
 
 	//Serialize EEPROM to save state
-	file.write((char*)&eeprom.bitstream_byte, sizeof(eeprom.bitstream_byte));
-	file.write((char*)&eeprom.address, sizeof(eeprom.address));
-	file.write((char*)&eeprom.dma_ptr, sizeof(eeprom.dma_ptr));
-	file.write((char*)&eeprom.size, sizeof(eeprom.size));
-	file.write((char*)&eeprom.size_lock, sizeof(eeprom.size_lock));
-	file.write((char*)&eeprom.data[0], eeprom.size);
+	state.write(&eeprom.bitstream_byte, sizeof(eeprom.bitstream_byte));
+	state.write(&eeprom.address, sizeof(eeprom.address));
+	state.write(&eeprom.dma_ptr, sizeof(eeprom.dma_ptr));
+	state.write(&eeprom.size, sizeof(eeprom.size));
+	state.write(&eeprom.size_lock, sizeof(eeprom.size_lock));
+	state.write(&eeprom.data[0], eeprom.size);
 
 	//Serialize FLASH RAM to save state
-	file.write((char*)&flash_ram.current_command, sizeof(flash_ram.current_command));
-	file.write((char*)&flash_ram.bank, sizeof(flash_ram.bank));
-	file.write((char*)&flash_ram.write_single_byte, sizeof(flash_ram.write_single_byte));
-	file.write((char*)&flash_ram.switch_bank, sizeof(flash_ram.switch_bank));
-	file.write((char*)&flash_ram.grab_ids, sizeof(flash_ram.grab_ids));
-	file.write((char*)&flash_ram.next_write, sizeof(flash_ram.next_write));
-	file.write((char*)&flash_ram.data[0][0], 0x10000);
-	file.write((char*)&flash_ram.data[1][0], 0x10000);
+	state.write(&flash_ram.current_command, sizeof(flash_ram.current_command));
+	state.write(&flash_ram.bank, sizeof(flash_ram.bank));
+	state.write(&flash_ram.write_single_byte, sizeof(flash_ram.write_single_byte));
+	state.write(&flash_ram.switch_bank, sizeof(flash_ram.switch_bank));
+	state.write(&flash_ram.grab_ids, sizeof(flash_ram.grab_ids));
+	state.write(&flash_ram.next_write, sizeof(flash_ram.next_write));
+	state.write(&flash_ram.data[0][0], 0x10000);
+	state.write(&flash_ram.data[1][0], 0x10000);
 
 	//Serialize AM3 data to save state
 	if(config::cart_type == AGB_AM3)
 	{ 
-		file.write((char*)&am3.read_sm_card, sizeof(am3.read_sm_card));
-		file.write((char*)&am3.read_key, sizeof(am3.read_key));
-		file.write((char*)&am3.op_delay, sizeof(am3.op_delay));
-		file.write((char*)&am3.transfer_delay, sizeof(am3.transfer_delay));
-		file.write((char*)&am3.base_addr, sizeof(am3.base_addr));
-		file.write((char*)&am3.blk_stat, sizeof(am3.blk_stat));
-		file.write((char*)&am3.blk_size, sizeof(am3.blk_size));
-		file.write((char*)&am3.blk_addr, sizeof(am3.blk_addr));
-		file.write((char*)&am3.smc_offset, sizeof(am3.smc_offset));
-		file.write((char*)&am3.last_offset, sizeof(am3.last_offset));
-		file.write((char*)&am3.smc_size, sizeof(am3.smc_size));
-		file.write((char*)&am3.smc_base, sizeof(am3.smc_base));
-		file.write((char*)&am3.file_index, sizeof(am3.file_index));
-		file.write((char*)&am3.file_count, sizeof(am3.file_count));
-		file.write((char*)&am3.file_size, sizeof(am3.file_size));
-		file.write((char*)&am3.remaining_size, sizeof(am3.remaining_size));
-		file.write((char*)&am3.file_size_list[0], (sizeof(u32) * am3.file_size_list.size()));
-		file.write((char*)&am3.file_addr_list[0], (sizeof(u32) * am3.file_addr_list.size()));
-		file.write((char*)&am3.smid[0], 0x10);
-		file.write((char*)&memory_map[0x8000000], 0x400);
+		state.write(&am3.read_sm_card, sizeof(am3.read_sm_card));
+		state.write(&am3.read_key, sizeof(am3.read_key));
+		state.write(&am3.op_delay, sizeof(am3.op_delay));
+		state.write(&am3.transfer_delay, sizeof(am3.transfer_delay));
+		state.write(&am3.base_addr, sizeof(am3.base_addr));
+		state.write(&am3.blk_stat, sizeof(am3.blk_stat));
+		state.write(&am3.blk_size, sizeof(am3.blk_size));
+		state.write(&am3.blk_addr, sizeof(am3.blk_addr));
+		state.write(&am3.smc_offset, sizeof(am3.smc_offset));
+		state.write(&am3.last_offset, sizeof(am3.last_offset));
+		state.write(&am3.smc_size, sizeof(am3.smc_size));
+		state.write(&am3.smc_base, sizeof(am3.smc_base));
+		state.write(&am3.file_index, sizeof(am3.file_index));
+		state.write(&am3.file_count, sizeof(am3.file_count));
+		state.write(&am3.file_size, sizeof(am3.file_size));
+		state.write(&am3.remaining_size, sizeof(am3.remaining_size));
+		state.write(&am3.file_size_list[0], (sizeof(u32) * am3.file_size_list.size()));
+		state.write(&am3.file_addr_list[0], (sizeof(u32) * am3.file_addr_list.size()));
+		state.write(&am3.smid[0], 0x10);
+		state.write(&memory_map[0x8000000], 0x400);
 	}
-
-	file.close();
-	return true;
 }
 
-/****** Gets the size of MMU data for serialization ******/
-u32 AGB_MMU::size()
-{
-	u32 mmu_size = 0x70C00;
-
-	mmu_size += sizeof(current_save_type);
-	mmu_size += sizeof(n_clock);
-	mmu_size += sizeof(s_clock);
-	mmu_size += sizeof(bios_lock);
-	mmu_size += sizeof(dma[0]);
-	mmu_size += sizeof(dma[1]);
-	mmu_size += sizeof(dma[2]);
-	mmu_size += sizeof(dma[3]);
-	mmu_size += sizeof(gpio);
-
-	mmu_size += sizeof(eeprom.bitstream_byte);
-	mmu_size += sizeof(eeprom.address);
-	mmu_size += sizeof(eeprom.dma_ptr);
-	mmu_size += sizeof(eeprom.size);
-	mmu_size += sizeof(eeprom.size_lock);
-	mmu_size += eeprom.size;
-
-	mmu_size += sizeof(flash_ram.current_command);
-	mmu_size += sizeof(flash_ram.bank);
-	mmu_size += sizeof(flash_ram.write_single_byte);
-	mmu_size += sizeof(flash_ram.switch_bank);
-	mmu_size += sizeof(flash_ram.grab_ids);
-	mmu_size += sizeof(flash_ram.next_write);
-	mmu_size += 0x20000;
-
-	if(config::cart_type == AGB_AM3)
-	{
-		mmu_size += sizeof(am3.read_sm_card);
-		mmu_size += sizeof(am3.read_key);
-		mmu_size += sizeof(am3.op_delay);
-		mmu_size += sizeof(am3.transfer_delay);
-		mmu_size += sizeof(am3.base_addr);
-		mmu_size += sizeof(am3.blk_stat);
-		mmu_size += sizeof(am3.blk_size);
-		mmu_size += sizeof(am3.blk_addr);
-		mmu_size += sizeof(am3.smc_offset);
-		mmu_size += sizeof(am3.last_offset);
-		mmu_size += sizeof(am3.smc_size);
-		mmu_size += sizeof(am3.smc_base);
-		mmu_size += sizeof(am3.file_index);
-		mmu_size += sizeof(am3.file_count);
-		mmu_size += sizeof(am3.file_size);
-		mmu_size += sizeof(am3.remaining_size);
-		mmu_size += (sizeof(u32) * am3.file_size_list.size());
-		mmu_size += (sizeof(u32) * am3.file_addr_list.size());
-		mmu_size += 0x10;
-		mmu_size += 0x400;
-	}
-
-	return mmu_size;
-}
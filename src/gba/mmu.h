@@ -24,6 +24,9 @@
 #include "common.h"
 #include "gamepad.h"
 #include "timer.h"
+#include "block_cache.h"
+#include "memory_map.h"
+#include "common/save_state.h"
 #include "lcd_data.h"
 #include "apu_data.h"
 #include "sio_data.h"
@@ -178,7 +181,14 @@ class AGB_MMU
 
 	backup_types current_save_type;
 
-	std::vector <u8> memory_map;
+	//Local link sessions only keep Player 1's save data, every player shares the same path
+	bool write_backup;
+
+	agb_memory_map memory_map;
+
+	//Host pointers to 32KB pages that can be accessed without side effects, NULL means use the slow path
+	std::vector <u8*> read_pages;
+	std::vector <u8*> write_pages;
 
 	//Memory access timings (Nonsequential and Sequential)
 	u8 n_clock;
@@ -690,6 +700,7 @@ class AGB_MMU
 	void flash_erase_sector(u32 sector);
 	void flash_switch_bank();
 
+	void resize_dacs();
 	u8 read_dacs(u32 address);
 	void write_dacs(u32 address, u8 value);
 
@@ -809,10 +820,44 @@ class AGB_MMU
 	AGB_GamePad* g_pad;
 	std::vector<gba_timer>* timer;
 
+	//Cycles not yet applied to the timer counters
+	u32 timer_pending;
+	u8 sync_timers();
+
+	//Stores and timer counter reads seen by idle loop detection
+	u32 write_count;
+	bool timer_read;
+
+	//Pre-decoded code blocks built by the CPU
+	agb_block_cache code_cache;
+
+	void invalidate_code(u32 address);
+	void drop_code_page(u32 page);
+	void flush_code_cache();
+
+	//Staging area for memory loaded from save states
+	std::vector<u8> state_scratch;
+	void read_state_memory(state_reader& state, u32 address, u32 length);
+
+	//One bit per 32 bytes of VRAM, set on every write so the LCD knows which decoded tiles are stale
+	u32 vram_dirty[0x80];
+
+	/****** Flags the 32 bytes of VRAM holding an address as modified ******/
+	inline void mark_vram_dirty(u32 address)
+	{
+		u32 block = (address & 0x1FFFF) >> 5;
+		vram_dirty[block >> 5] |= (1 << (block & 0x1F));
+	}
+
+	void mark_vram_dirty(u32 address, u32 length);
+
+	void build_page_tables();
+	u8* get_host_span(u32 address, u32& length, bool write);
+	void notify_host_write(u32 address, u32 length);
+
 	//Serialize data for save state loading/saving
-	bool mmu_read(u32 offset, std::string filename);
-	bool mmu_write(std::string filename);
-	u32 size();
+	void mmu_read(state_reader& state);
+	void mmu_write(state_writer& state);
 
 	private:
 
@@ -62,7 +62,7 @@ AGB_SIO::~AGB_SIO()
 	#ifdef GBE_NETPLAY
 
 	//Send disconnect byte to another system
-	if(sender.host_socket != nullptr)
+	if(sender.connected)
 	{
 		u8 temp_buffer[6] = { 0, 0, 0, 0, 0, 0x80 };
 		
@@ -70,6 +70,8 @@ AGB_SIO::~AGB_SIO()
 	}
 
 	//Close SDL_net and any current connections
+	receiver.stop();
+
 	net_util::close_comm(server);
 	net_util::close_comm(sender);
 
@@ -121,8 +123,8 @@ bool AGB_SIO::init()
 	network_init = true;
 
 	//Server and Client info
-	net_util::setup_comm(server, config::netplay_server_port, NET_COMM_SERVER);
-	net_util::setup_comm(sender, config::netplay_client_port, NET_COMM_CLIENT);
+	net_util::setup_comm(server, config::netplay_server_port, NET_COMM_SERVER, config::netplay_local);
+	net_util::setup_comm(sender, config::netplay_client_port, NET_COMM_CLIENT, config::netplay_local);
 
 	//Abort initialization if server and client ports are the same
 	if(config::netplay_server_port == config::netplay_client_port)
@@ -193,6 +195,8 @@ void AGB_SIO::reset()
 	sio_stat.player_id = config::netplay_id;
 	sio_stat.halt_counter = 0;
 
+	rollback.reset(0);
+
 	switch(config::sio_device)
 	{
 		//Ignore invalid DMG/GBC devices
@@ -469,6 +473,8 @@ void AGB_SIO::reset()
 		
 		net_util::send_data(sender, temp_buffer, 6);
 
+		receiver.stop();
+
 		net_util::close_comm(server);
 		net_util::close_comm(sender);
 	}
@@ -481,6 +487,27 @@ bool AGB_SIO::send_data()
 {
 	#ifdef GBE_NETPLAY
 
+	//With rollback, 16-bit Multiplayer transfers finish right away with a predicted reply
+	bool predict = predicts_transfers();
+	u32 reply = 0;
+
+	if(predict)
+	{
+		//Transfers sent before resimulating only need their reply again
+		if(!rollback.next_local_transfer(reply))
+		{
+			multiplay_reply(reply);
+			return true;
+		}
+	}
+
+	//Nothing else is sent again while resimulating
+	else if(rollback.replaying())
+	{
+		if((sio_stat.sio_mode == NORMAL_8BIT) || (sio_stat.sio_mode == NORMAL_32BIT)) { sio_stat.send_so_status = false; }
+		return true;
+	}
+
 	u8 temp_buffer[6];
 	temp_buffer[0] = (sio_stat.transfer_data & 0xFF);
 	temp_buffer[1] = ((sio_stat.transfer_data >> 8) & 0xFF);
@@ -525,76 +552,97 @@ bool AGB_SIO::send_data()
 		sio_stat.send_so_status = false;
 	}
 
-	//Wait for other GBA to acknowledge
-	if(net_util::recv_data(server, temp_buffer, 6, NET_COMM_IS_BLOCKING) >= 6)
+	//Use the predicted reply, the real one is checked once it arrives
+	if(predict) { multiplay_reply(reply); }
+
+	//Wait for other GBA to acknowledge - Modes rollback does not predict still block here
+	else if(receiver.wait(temp_buffer))
 	{
 		//16-bit Multiplayer
 		if((sio_stat.sio_mode == MULTIPLAY_16BIT) && (temp_buffer[5] == 0x48))
 		{
-			//Reset transfer data
-			mem->write_u32_fast(0x4000120, 0xFFFFFFFF);
-			mem->write_u32_fast(0x4000124, 0xFFFFFFFF);
+			multiplay_reply((temp_buffer[4] << 16) | (temp_buffer[1] << 8) | temp_buffer[0]);
+		}
+	}
 
-			//Only process response if the emulated SIO connection is ready
-			if(sio_stat.connection_ready)
-			{
-				switch(temp_buffer[4] & 0x03)
-				{
-					case 0x00:
-						mem->memory_map[0x4000120] = temp_buffer[0];
-						mem->memory_map[0x4000121] = temp_buffer[1];
-						break;
+	//Reset hard sync if new SIO byte sent - Rollback replaces hard sync only for transfers it predicts
+	if((config::netplay_hard_sync) && (!predict) && (!sio_stat.use_hard_sync))
+	{
+		sio_stat.use_hard_sync = true;
+	}
 
-					case 0x01:
-						mem->memory_map[0x4000122] = temp_buffer[0];
-						mem->memory_map[0x4000123] = temp_buffer[1];
-						break; 
+	#endif
 
-					case 0x02:
-						mem->memory_map[0x4000124] = temp_buffer[0];
-						mem->memory_map[0x4000125] = temp_buffer[1];
-						break; 
+	return true;
+}
 
-					case 0x03:
-						mem->memory_map[0x4000126] = temp_buffer[0];
-						mem->memory_map[0x4000127] = temp_buffer[1];
-						break;
-				}
+/****** Returns true if transfers in the current mode finish with a predicted reply instead of waiting on the other GBA ******/
+bool AGB_SIO::predicts_transfers()
+{
+	return ((rollback.enabled()) && (sio_stat.sio_mode == MULTIPLAY_16BIT));
+}
 
-				//Set master data
-				mem->write_u16_fast(0x4000120, sio_stat.transfer_data);
+/****** Completes a 16-bit Multiplayer transfer on the parent - Reply holds the child's ID (Bits 16-17) and data ******/
+void AGB_SIO::multiplay_reply(u32 reply)
+{
+	//Reset transfer data
+	mem->write_u32_fast(0x4000120, 0xFFFFFFFF);
+	mem->write_u32_fast(0x4000124, 0xFFFFFFFF);
 
-				//Raise SIO IRQ after sending byte
-				if(sio_stat.cnt & 0x4000) { mem->memory_map[REG_IF] |= 0x80; }
+	//Only process response if the emulated SIO connection is ready
+	if(sio_stat.connection_ready)
+	{
+		//Store the child's data in the slot for its ID
+		u32 slot = 0x4000120 + (((reply >> 16) & 0x03) << 1);
+		mem->memory_map[slot] = (reply & 0xFF);
+		mem->memory_map[slot + 1] = ((reply >> 8) & 0xFF);
 
-				//Set SC and SO HIGH on master
-				mem->write_u8(R_CNT, (mem->memory_map[R_CNT] | 0x09));
+		//Set master data
+		mem->write_u16_fast(0x4000120, sio_stat.transfer_data);
 
-				sio_stat.active_transfer = false;
-				sio_stat.shifts_left = 0;
-				sio_stat.shift_counter = 0;
-			}
+		//Raise SIO IRQ after sending byte
+		if(sio_stat.cnt & 0x4000) { mem->memory_map[REG_IF] |= 0x80; }
 
-			//Otherwise delay the transfer
-			else
-			{
-				sio_stat.active_transfer = true;
-				sio_stat.shifts_left = 1;
-				sio_stat.shift_counter = 0;
-				mem->memory_map[SIO_CNT] |= 0x80;
-			}
-		}
+		//Set SC and SO HIGH on master
+		mem->write_u8(R_CNT, (mem->memory_map[R_CNT] | 0x09));
+
+		sio_stat.active_transfer = false;
+		sio_stat.shifts_left = 0;
+		sio_stat.shift_counter = 0;
 	}
 
-	//Reset hard sync if new SIO byte sent
-	if((config::netplay_hard_sync) && (!sio_stat.use_hard_sync))
+	//Otherwise delay the transfer
+	else
 	{
-		sio_stat.use_hard_sync = true;
+		sio_stat.active_transfer = true;
+		sio_stat.shifts_left = 1;
+		sio_stat.shift_counter = 0;
+		mem->memory_map[SIO_CNT] |= 0x80;
 	}
+}
 
-	#endif
+/****** Completes a 16-bit Multiplayer transfer on a child - Transfer holds the parent's ID (Bits 16-17) and data ******/
+void AGB_SIO::multiplay_receive(u32 transfer)
+{
+	//Reset transfer data
+	mem->write_u32_fast(0x4000120, 0xFFFFFFFF);
+	mem->write_u32_fast(0x4000124, 0xFFFFFFFF);
 
-	return true;
+	//Raise SIO IRQ after sending byte
+	if(sio_stat.cnt & 0x4000) { mem->memory_map[REG_IF] |= 0x80; }
+
+	//Set SO HIGH on all children
+	mem->write_u8(R_CNT, (mem->memory_map[R_CNT] | 0x08));
+
+	//Store data from transfer into SIO data registers
+	u32 slot = 0x4000120 + (((transfer >> 16) & 0x03) << 1);
+	mem->memory_map[slot] = (transfer & 0xFF);
+	mem->memory_map[slot + 1] = ((transfer >> 8) & 0xFF);
+
+	sio_stat.transfer_data = (mem->memory_map[SIO_DATA_8 + 1] << 8) | mem->memory_map[SIO_DATA_8];
+
+	//Set own multiplayer data based on SIOMLT_SEND
+	mem->write_u16_fast((0x4000120 + (sio_stat.player_id << 1)), sio_stat.transfer_data);
 }
 
 /****** Receives one byte from another system ******/
@@ -602,13 +650,13 @@ bool AGB_SIO::receive_byte()
 {
 	#ifdef GBE_NETPLAY
 
-	u8 temp_buffer[6] = { 0, 0, 0, 0, 0, 0 };
+	//Transfers received while resimulating wait until it finishes
+	if(rollback.replaying()) { return true; }
 
-	//Check the status of connection
-	SDLNet_CheckSockets(server.tcp_sockets, 0);
+	u8 temp_buffer[6] = { 0, 0, 0, 0, 0, 0 };
 
-	//If this socket is active, receive the transfer
-	if(net_util::recv_data(server, temp_buffer, 6) >= 6)
+	//If the receiving thread has a transfer waiting, process it
+	if(receiver.pop(temp_buffer))
 	{
 		//Stop sync
 		if(temp_buffer[5] == 0xFF)
@@ -668,6 +716,13 @@ bool AGB_SIO::receive_byte()
 			return true;
 		}
 
+		//Replies to transfers sent with rollback - Only 16-bit Multiplayer replies carry data
+		else if((temp_buffer[5] >= 0x50) && (temp_buffer[5] <= 0x5F))
+		{
+			if(temp_buffer[5] == 0x58) { rollback.confirm_transfer((temp_buffer[4] << 16) | (temp_buffer[1] << 8) | temp_buffer[0]); }
+			return true;
+		}
+
 		//Process GBA SIO communications
 		else if((temp_buffer[5] >= 0x40) && (temp_buffer[5] <= 0x4F))
 		{
@@ -685,7 +740,22 @@ bool AGB_SIO::receive_byte()
 
 			else if(sio_stat.sio_mode == MULTIPLAY_16BIT)
 			{
-				if(sio_stat.connection_ready)
+				//Store byte from transfer into SIO data registers - 16-bit Multiplayer
+				if((sio_stat.connection_ready) && (temp_buffer[5] == 0x48))
+				{
+					u32 transfer = (temp_buffer[4] << 16) | (temp_buffer[1] << 8) | temp_buffer[0];
+
+					//Keep a record so rollback can apply this transfer again while resimulating
+					rollback.log_event(LINK_EVENT_TRANSFER, transfer);
+					multiplay_receive(transfer);
+
+					temp_buffer[0] = (sio_stat.transfer_data & 0xFF);
+					temp_buffer[1] = ((sio_stat.transfer_data >> 8) & 0xFF);
+					temp_buffer[2] = ((sio_stat.transfer_data >> 16) & 0xFF);
+					temp_buffer[3] = ((sio_stat.transfer_data >> 24) & 0xFF);
+				}
+
+				else if(sio_stat.connection_ready)
 				{
 					//Reset transfer data
 					mem->write_u32_fast(0x4000120, 0xFFFFFFFF);
@@ -696,48 +766,14 @@ bool AGB_SIO::receive_byte()
 
 					//Set SO HIGH on all children
 					mem->write_u8(R_CNT, (mem->memory_map[R_CNT] | 0x08));
-
-					//Store byte from transfer into SIO data registers - 16-bit Multiplayer
-					if((sio_stat.sio_mode == MULTIPLAY_16BIT) && (temp_buffer[5] == 0x48))
-					{
-						switch(temp_buffer[4] & 0x3)
-						{
-							case 0x0:
-								mem->memory_map[0x4000120] = temp_buffer[0];
-								mem->memory_map[0x4000121] = temp_buffer[1];
-								break;
-
-							case 0x1:
-								mem->memory_map[0x4000122] = temp_buffer[0];
-								mem->memory_map[0x4000123] = temp_buffer[1];
-								break; 
-
-							case 0x2:
-								mem->memory_map[0x4000124] = temp_buffer[0];
-								mem->memory_map[0x4000125] = temp_buffer[1];
-								break; 
-
-							case 0x3:
-								mem->memory_map[0x4000126] = temp_buffer[0];
-								mem->memory_map[0x4000127] = temp_buffer[1];
-								break;
-						}
-
-						sio_stat.transfer_data = (mem->memory_map[SIO_DATA_8 + 1] << 8) | mem->memory_map[SIO_DATA_8];
-
-						//Set own multiplayer data based on SIOMLT_SEND
-						mem->write_u16_fast((0x4000120 + (sio_stat.player_id << 1)), sio_stat.transfer_data);
-
-						temp_buffer[0] = (sio_stat.transfer_data & 0xFF);
-						temp_buffer[1] = ((sio_stat.transfer_data >> 8) & 0xFF);
-						temp_buffer[2] = ((sio_stat.transfer_data >> 16) & 0xFF);
-						temp_buffer[3] = ((sio_stat.transfer_data >> 24) & 0xFF);
-					}
 				}
 			}
 
 			temp_buffer[4] = sio_stat.player_id;
 
+			//Mark acknowledgements as replies when using rollback
+			if(config::netplay_rollback) { temp_buffer[5] |= 0x10; }
+
 			//Send acknowledgement
 			if(net_util::send_data(sender, temp_buffer, 6) < 0)
 			{
@@ -750,8 +786,8 @@ bool AGB_SIO::receive_byte()
 			//Start hard sync timeout countdown
 			sio_stat.halt_counter = 0x400000;
 
-			//Reset hard sync if new IR signal received
-			if((config::netplay_hard_sync) && (!sio_stat.use_hard_sync))
+			//Reset hard sync if new SIO byte received - Rollback replaces hard sync only for transfers it predicts
+			if((config::netplay_hard_sync) && (!predicts_transfers()) && (!sio_stat.use_hard_sync))
 			{
 				sio_stat.use_hard_sync = true;
 			} 
@@ -818,6 +854,45 @@ bool AGB_SIO::stop_sync()
 	return true;
 }
 
+/****** Returns true once the other side of a netplay connection has hung up ******/
+bool AGB_SIO::link_lost()
+{
+	#ifdef GBE_NETPLAY
+
+	return receiver.disconnected();
+
+	#else
+
+	return false;
+
+	#endif
+}
+
+/****** Sleeps until the receiving thread has a transfer waiting or the timeout (in ms) passes ******/
+bool AGB_SIO::wait_receive(u32 timeout)
+{
+	#ifdef GBE_NETPLAY
+
+	return receiver.wait_pending(timeout);
+
+	#else
+
+	return false;
+
+	#endif
+}
+
+/****** Puts back the status that belongs to the live connection after a rollback snapshot is loaded ******/
+void AGB_SIO::restore_link_status(const agb_sio_data& live)
+{
+	sio_stat.connected = live.connected;
+	sio_stat.connection_ready = live.connection_ready;
+	sio_stat.sync = live.sync;
+	sio_stat.sync_counter = live.sync_counter;
+	sio_stat.use_hard_sync = live.use_hard_sync;
+	sio_stat.halt_counter = live.halt_counter;
+}
+
 /****** Manages network communication via SDL_net ******/
 void AGB_SIO::process_network_communication()
 {
@@ -852,6 +927,12 @@ void AGB_SIO::process_network_communication()
 
 			sio_stat.connection_ready = true;
 			mem->process_sio();
+
+			//Start polling the server for transfers
+			receiver.start(&server, 6);
+
+			//Start keeping frames for rollback
+			rollback.reset(config::netplay_rollback);
 		}
 	}
 
@@ -20,6 +20,8 @@
 #include "sio_data.h"
 
 #include "common/net_util.h"
+#include "common/net_receiver.h"
+#include "common/link_rollback.h"
 
 class AGB_SIO
 {
@@ -43,8 +45,14 @@ class AGB_SIO
 	//Sending client
 	gbe_net_comm sender;
 
+	//Reads the receiving server on a separate thread
+	net_receiver receiver;
+
 	#endif
 
+	//Rollback for link cable netplay
+	link_rollback rollback;
+
 	//GB Player Rumble
 	struct gb_player_rumble
 	{
@@ -231,9 +239,15 @@ class AGB_SIO
 	void reset();
 
 	bool send_data();
+	bool predicts_transfers();
 	bool receive_byte();
+	void multiplay_reply(u32 reply);
+	void multiplay_receive(u32 transfer);
 	bool request_sync();
 	bool stop_sync();
+	bool link_lost();
+	bool wait_receive(u32 timeout);
+	void restore_link_status(const agb_sio_data& live);
 	void process_network_communication();
 
 	void gba_player_rumble_process();
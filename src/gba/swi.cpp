@@ -11,6 +11,7 @@
 #include <cmath>
 
 #include "arm7.h"
+#include "common/hle_decompress.h"
 
 s16 sine_lut[256] = 
 {
@@ -364,6 +365,7 @@ void ARM7::swi_softreset()
 
 	//Clear top 0x200 bytes of the 32KB WRAM
 	for(int x = 0x3007E00; x < 0x3008000; x++) { mem->memory_map[x] = 0; }
+	mem->flush_code_cache();
 
 	arm_mode = ARM;
 	in_interrupt = false;
@@ -445,7 +447,7 @@ void ARM7::swi_halt()
 	//Run controllers until an interrupt happens
 	while(halt)
 	{
-		clock();
+		clock_idle();
 
 		if_check = mem->read_u16(REG_IF);
 		ie_check = mem->read_u16(REG_IE);
@@ -798,7 +800,7 @@ void ARM7::swi_intrwait()
 	//Run controllers until an interrupt is generated
 	while(!fire_interrupt)
 	{
-		clock();
+		clock_idle();
 
 		current_if = mem->read_u16_fast(REG_IF);
 		ie_check = mem->read_u16_fast(REG_IE);
@@ -842,7 +844,7 @@ void ARM7::swi_vblankintrwait()
 	//Run controllers until an interrupt is generated
 	while(!fire_interrupt && !is_vblank)
 	{
-		clock();
+		clock_idle();
 
 		if_check = mem->read_u16_fast(REG_IF);
 		ie_check = mem->read_u16_fast(REG_IE);
@@ -896,14 +898,15 @@ void ARM7::swi_bitunpack()
 		return;
 	}
 
-	u8 bit_mask = 0;
-
+	//Only 1, 2, 4, and 8-bit source widths are valid
 	switch(src_width)
 	{
-		case 1: bit_mask = 0x1; break;
-		case 2: bit_mask = 0x3; break;
-		case 4: bit_mask = 0xF; break;
-		case 8: bit_mask = 0xFF; break;
+		case 1:
+		case 2:
+		case 4:
+		case 8:
+			break;
+
 		default: std::cout<<"SWI::ERROR - Invalid source width\n"; return;
 	}
 
@@ -912,281 +915,31 @@ void ARM7::swi_bitunpack()
 	u8 zero_flag = (data_offset & 0x80000000) ? 1 : 0;
 	data_offset &= ~0x80000000;
 
-	u8 src_byte = 0;
-	u8 src_count = 0;
-	u32 result = 0;
-
 	//Decompress bytes from source addr
-	while(length > 0)
-	{
-		result = 0;
-
-		//Cycle through the byte and expand to destination width
-		for(u8 x = 0; x < 32; x += dest_width)
-		{
-			//Grab new source byte
-			if((src_count % 8) == 0) 
-			{
-				src_byte = mem->read_u8(src_addr++);
-				length--;
-			}
-
-			//Grab the slice
-			u32 slice = (src_byte & bit_mask);
-			src_byte >>= src_width;
-			src_count += src_width;
-
-			if(slice != 0) { slice += data_offset; }
-			else if ((slice == 0) && (zero_flag == 1)) { slice += data_offset; }
-
-			//OR the slice to the final result
-			result |= (slice << x);
-		}
-
-		//Write result to the destination address
-		mem->write_u32(dest_addr, result);
-		dest_addr += 4;
-	}
+	hle_bit_unpack(mem, src_addr, dest_addr, length, src_width, dest_width, data_offset, zero_flag);
 }			
 
 /****** HLE implementation of LZ77UnCompVram ******/
 void ARM7::swi_lz77uncompvram()
 {
-	//Grab source address - R0
-	u32 src_addr = get_reg(0);
-
-	//Grab destination address - R1
-	u32 dest_addr = get_reg(1);
-
-	//Grab data header
-	u32 data_header = mem->read_u32(src_addr);
-
-	//Grab compressed data size in bytes
-	u32 data_size = (data_header >> 8);
-
-	//Pointer to current address of compressed data that needs to be processed
-	//When uncompression starts, move 5 bytes from source address (header + flag)
-	u32 data_ptr = (src_addr + 4);
-
-	u8 temp = 0;
-
-	//Uncompress data
-	while(data_size > 0)
-	{
-		//Grab flag data
-		u8 flag_data = mem->read_u8(data_ptr++);
-
-		//Process 8 blocks
-		for(int x = 7; x >= 0; x--)
-		{
-			u8 block_type = (flag_data & (1 << x)) ? 1 : 0;
-
-			//Block Type 0 - Uncompressed
-			if(block_type == 0)
-			{
-				temp = mem->read_u8(data_ptr++);
-				mem->write_u8(dest_addr++, temp);
-				
-				data_size--;
-				if(data_size == 0) { return; }
-			}
-
-
-			//Block Type 1 - Compressed
-			else
-			{
-				u16 compressed_block = mem->read_u16(data_ptr);
-				data_ptr += 2;
-
-				u16 distance = ((compressed_block & 0xF) << 8);
-				distance |= (compressed_block >> 8);
-
-				u8 length = ((compressed_block >> 4) & 0xF) + 3;
-
-				//Copy length+3 Bytes from dest_addr-length-1 to dest_addr
-				for(int y = 0; y < length; y++)
-				{
-					temp = mem->read_u8(dest_addr - distance - 1);
-					mem->write_u8(dest_addr, temp);
-					
-					dest_addr++;
-					data_size--;
-					if(data_size == 0) { return; }
-				}
-			}
-		}
-	}
+	//Source address - R0, destination address - R1
+	hle_lz77_uncomp(mem, get_reg(0), get_reg(1));
 }
 
 /****** HLE implementation of HuffUnComp ******/
 void ARM7::swi_huffuncomp()
 {
-	//Grab source address - R0
-	u32 src_addr = get_reg(0);
-
-	//Grab destination address - R1
-	u32 dest_addr = get_reg(1);
-
-	//Grab data header
-	u32 data_header = mem->read_u32(src_addr);
-
-	//Grab data bit-size
-	u8 bit_size = (data_header & 0xF);
+	//Source address - R0, destination address - R1
+	u8 bit_size = hle_huff_uncomp(mem, get_reg(0), get_reg(1));
 
 	if((bit_size != 4) && (bit_size != 8)) { std::cout<<"SWI::Warning - HuffUnComp has irregular data size : " << (int)bit_size << "\n"; }
-
-	//Grab compressed data size in bytes - Data comes in units of 32-bits, 4 bytes
-	u32 data_size = (data_header >> 8);
-	while((data_size & 0x3) != 0) { data_size++; }
-
-	//Pointer to current address that needs to be processed
-	//When uncompression start, points to data after the header (the first Tree Size attribute)
-	u32 data_ptr = (src_addr + 4);
-
-	u8 data_shift = 0;
-	u32 temp = 0;
-
-	//Grab Tree Size
-	u16 tree_size = mem->read_u8(data_ptr++);
-	tree_size = ((tree_size + 1) * 2) - 1;
-
-	//Grab the root node
-	u32 root_node_addr = data_ptr;
-	u32 node_position = 0;
-
-	//Grab the 32-bit compressed bitstream
-	u32 bitstream = mem->read_u32(data_ptr + tree_size);
-	u32 bitstream_addr = (data_ptr + tree_size);
-	u32 bitstream_mask = 0x80000000;
-
-	bool is_data_node = false;
-
-	//Uncompress data
-	while(data_size > 0)
-	{
-		//Begin parsing the nodes, starting with root node
-		while(bitstream_mask != 0)
-		{
-			u8 node = mem->read_u8(data_ptr);
-			u8 node_offset = (node & 0x3F);
-			u8 node_0_type = (node & 0x80) ? 1 : 0;
-			u8 node_1_type = (node & 0x40) ? 1 : 0;
-
-			//If this node is a data node, read data
-			if(is_data_node) 
-			{
-				//Grab data from the node
-				u8 data = 0;
-
-				if(bit_size == 4) { data = node & 0xF; }
-				else { data = node; }
-
-				//Add data to 32-bit value
-				temp |= (data << data_shift);
-				data_shift += bit_size;
-
-				//Transfer completed 32-bit value to memory
-				if(data_shift >= 32) 
-				{
-					mem->write_u32(dest_addr, temp);
-					dest_addr += 4;
-					data_size -= 4;
-					temp = 0;
-					data_shift = 0;
-
-					if(data_size == 0) { return; } 
-				}
-
-				//Return to root node
-				data_ptr = root_node_addr;
-				is_data_node = false;
-				node_position = 0;
-			}
-
-			//If this node is a child node, continue along the binary trees
-			else
-			{
-				if(node_position == 0) { node_position++; }
-				else { node_position += ((node_offset + 1) * 2); }
-			
-				//Read bitstream bit, decide if child_node.0 or child_node.1 should be looked at
-				u8 bitstream_bit = (bitstream & bitstream_mask) ? 1 : 0;
-				bitstream_mask >>= 1;
-
-				//Go offset for child_node.1
-				if(bitstream_bit == 1) 
-				{
-					data_ptr = (root_node_addr + node_position + 1);
-					if(node_1_type == 1) { is_data_node = true; }
-					else { is_data_node = false; }
-				}
-
-				//Go offset for child_node.0
-				else 
-				{
-					data_ptr = (root_node_addr + node_position);
-					if(node_0_type == 1) { is_data_node = true; }
-					else { is_data_node = false; }
-				}
-				
-			}
-		}
-
-		//After this 32-bit bitstream is complete, move onto the next bitstream
-		bitstream_addr += 4;
-		bitstream = mem->read_u32(bitstream_addr);
-		bitstream_mask = 0x80000000;
-	}
 }
 
 /****** HLE implementation of RLUnCompVram ******/
 void ARM7::swi_rluncompvram()
 {
-	//Grab source address - R0
-	u32 src_addr = get_reg(0);
-
-	//Grab destination address - R1
-	u32 dest_addr = get_reg(1);
-
-	//Grab data header
-	u32 data_header = mem->read_u32(src_addr);
-
-	u32 data_size = (data_header >> 8);
-
-	//Data pointer to compressed data. Points to first flag.
-	u32 data_ptr = (src_addr + 4);
-
-	//Uncompress data
-	while(data_size > 0)
-	{
-		u8 flag = mem->read_u8(data_ptr++);
-
-		u8 data_length = (flag & 0x7F);
-
-		//Adjust data length, +1 for uncompressed data, +3 for compressed data
-		if(flag & 0x80) { data_length += 3; }
-		else { data_length += 1; }
-
-		//Output the specified byte the amount of times in data_length
-		for(int x = 0; x < data_length; x++)
-		{
-			u8 data_byte = 0;
-
-			//Compressed
-			if(flag & 0x80) { data_byte = mem->read_u8(data_ptr); }
-
-			//Uncompressed
-			else { data_byte = mem->read_u8(data_ptr++); }
-				
-			mem->write_u8(dest_addr++, data_byte);
-			data_size--;
-
-			if(data_size == 0) { return; }
-		}
-
-		//Manually adjust data pointer for compressed data to point to next flag
-		if(flag & 0x80) { data_ptr++; }
-	}
+	//Source address - R0, destination address - R1
+	hle_rl_uncomp(mem, get_reg(0), get_reg(1));
 }
 
 /****** HLE implementation of Diff8bitUnFilter******/
@@ -0,0 +1,359 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : link_session.cpp
+// Date : October 17, 2026
+// Description : Local link sessions
+//
+// Runs several copies of one game inside a single GBE+ process, each core on its own thread
+// Cores link through the in-process hub and draw side by side into one shared window
+
+#include "gba/core.h"
+#include "dmg/core.h"
+#include "min/core.h"
+#include "common/config.h"
+#include "common/util.h"
+#include "common/link_hub.h"
+
+#include "link_session.h"
+
+//Cycles each core runs before waiting on the others - About 1/4096 of a second on every system
+#define LINK_SESSION_GBA_QUANTUM 0x1000
+#define LINK_SESSION_DMG_QUANTUM 0x400
+#define LINK_SESSION_MIN_QUANTUM 0x200
+
+link_session* link_session::active = nullptr;
+
+//Index of the player whose core runs on the current thread
+static thread_local u8 current_player = 0;
+
+/****** Link session constructor ******/
+link_session::link_session()
+{
+	for(u32 x = 0; x < 4; x++)
+	{
+		players[x].core = nullptr;
+		players[x].thread = nullptr;
+		players[x].id = x;
+		players[x].done = false;
+	}
+
+	total_players = 0;
+	focus = 0;
+
+	width = 0;
+	height = 0;
+
+	window = nullptr;
+	screen = nullptr;
+	frame_lock = nullptr;
+}
+
+/****** Link session destructor ******/
+link_session::~link_session()
+{
+	//Cores tear themselves down when run_core() returns, so only the window is cleaned up here
+	if(screen != nullptr) { SDL_FreeSurface(screen); }
+	if(window != nullptr) { SDL_DestroyWindow(window); }
+	if(frame_lock != nullptr) { SDL_DestroyMutex(frame_lock); }
+
+	if(active == this) { active = nullptr; }
+}
+
+/****** Creates and starts one core per player ******/
+bool link_session::init(u8 count)
+{
+	#ifdef GBE_NETPLAY
+
+	u8 max_players = 0;
+
+	if(config::gb_type == SYS_GBA) { max_players = 2; }
+	else if(config::gb_type == SYS_MIN) { max_players = 2; }
+	else if((config::gb_type >= SYS_AUTO) && (config::gb_type <= SYS_GBC)) { max_players = (config::sio_device == SIO_4_PLAYER_ADAPTER) ? 4 : 2; }
+
+	if(!max_players)
+	{
+		std::cout<<"GBE::Error - Local link sessions only support GBA, DMG-GBC, and Pokemon Mini games\n";
+		return false;
+	}
+
+	if((count < 2) || (count > max_players))
+	{
+		std::cout<<"GBE::Error - Current link setup supports 2 to " << (u32)max_players << " players\n";
+		return false;
+	}
+
+	frame_lock = SDL_CreateMutex();
+
+	if(frame_lock == nullptr)
+	{
+		std::cout<<"GBE::Error - Could not create link session lock\n";
+		return false;
+	}
+
+	//Cores run in lockstep, so every transfer lands on the same cycle no matter how threads get scheduled
+	//The DMG-07 protocol polls for its own sync messages between instructions, so it keeps hard sync instead
+	bool lockstep = (config::gb_type == SYS_MIN) || (config::sio_device != SIO_4_PLAYER_ADAPTER);
+	u32 quantum = LINK_SESSION_DMG_QUANTUM;
+
+	if(config::gb_type == SYS_GBA) { quantum = LINK_SESSION_GBA_QUANTUM; }
+	else if(config::gb_type == SYS_MIN) { quantum = LINK_SESSION_MIN_QUANTUM; }
+
+	if(lockstep) { link_hub::start_lockstep(count, quantum); }
+
+	//Cores link through the hub and hand their frames to the session
+	config::use_netplay = true;
+	config::netplay_local = true;
+	config::netplay_hard_sync = !lockstep;
+	config::netplay_rollback = 0;
+	config::sdl_render = false;
+	config::use_opengl = false;
+	config::render_external_sw = render_player;
+
+	active = this;
+
+	u16 base_port = config::netplay_server_port;
+
+	for(u32 x = 0; x < count; x++)
+	{
+		//Each player gets the same ID and ports a separate GBE+ instance would use
+		//Cores read these when built and started, so they only need to be valid until start() returns
+		//Pokemon Mini IR already offsets every port by netplay ID, so all players share the base port
+		config::netplay_id = x;
+		config::netplay_server_port = ((x == 0) || (config::gb_type == SYS_MIN)) ? base_port : (base_port + 1);
+		config::netplay_client_port = (x == 0) ? (base_port + 1) : base_port;
+
+		if(config::gb_type == SYS_GBA) { players[x].core = new AGB_core(); }
+		else if(config::gb_type == SYS_MIN) { players[x].core = new MIN_core(); }
+		else { players[x].core = new DMG_core(); }
+
+		if((config::use_bios) && (!players[x].core->read_bios(config::bios_file))) { return false; }
+		if(!players[x].core->read_file(config::rom_file)) { return false; }
+
+		players[x].core->start();
+		total_players++;
+
+		if(!players[x].core->running)
+		{
+			std::cout<<"GBE::Error - Could not start Player " << (x + 1) << "\n";
+			return false;
+		}
+	}
+
+	//Leave Player 1's settings in place
+	config::netplay_id = 0;
+	config::netplay_server_port = base_port;
+	config::netplay_client_port = base_port + 1;
+
+	width = config::sys_width;
+	height = config::sys_height;
+
+	return true;
+
+	#else
+
+	std::cout<<"GBE::Error - Local link sessions require netplay support\n";
+	return false;
+
+	#endif
+}
+
+/****** Runs every player until the window closes or any core stops ******/
+void link_session::run()
+{
+	if(!total_players) { return; }
+
+	u32 scale = (config::scaling_factor) ? config::scaling_factor : 1;
+
+	window = SDL_CreateWindow("GBE+", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, width * scale * total_players, height * scale, config::flags);
+	screen = SDL_CreateRGBSurface(SDL_SWSURFACE, width * total_players, height, 32, 0, 0, 0, 0);
+
+	if((window == nullptr) || (screen == nullptr))
+	{
+		std::cout<<"GBE::Error - Could not create link session window\n";
+		return;
+	}
+
+	update_title();
+
+	//Disbale mouse cursor in SDL, it's annoying
+	SDL_ShowCursor(SDL_DISABLE);
+
+	for(u32 x = 0; x < total_players; x++)
+	{
+		players[x].thread = SDL_CreateThread(player_thread, "GBE+ Player", &players[x]);
+
+		if(players[x].thread == nullptr)
+		{
+			std::cout<<"GBE::Error - Could not start thread for Player " << (x + 1) << "\n";
+			players[x].done = true;
+
+			#ifdef GBE_NETPLAY
+			link_hub::leave_lockstep(x);
+			#endif
+		}
+	}
+
+	SDL_Event event;
+	bool quit = false;
+
+	while(!quit)
+	{
+		while(SDL_PollEvent(&event))
+		{
+			if(event.type == SDL_QUIT) { quit = true; }
+
+			else if(((event.type == SDL_KEYDOWN) || (event.type == SDL_KEYUP)) && (!event.key.repeat))
+			{
+				bool pressed = (event.type == SDL_KEYDOWN);
+
+				int key = event.key.keysym.sym;
+
+				//Backquote moves the keyboard to the next player
+				if(key == SDLK_BACKQUOTE)
+				{
+					if(pressed)
+					{
+						focus = (focus + 1) % total_players;
+						update_title();
+					}
+				}
+
+				//Turbo goes to every player, so linked cores keep the same pace
+				else if(key == (int)config::hotkey_turbo)
+				{
+					SDL_LockMutex(frame_lock);
+					for(u32 x = 0; x < total_players; x++) { players[x].key_queue.push_back(std::make_pair(key, pressed)); }
+					SDL_UnlockMutex(frame_lock);
+				}
+
+				//Other hotkeys only reach Player 1, since some of them change emulator-wide settings
+				else if((focus == 0) || (!is_hotkey(key)))
+				{
+					SDL_LockMutex(frame_lock);
+					players[focus].key_queue.push_back(std::make_pair(key, pressed));
+					SDL_UnlockMutex(frame_lock);
+				}
+			}
+		}
+
+		//Any core stopping on its own ends the session
+		for(u32 x = 0; x < total_players; x++)
+		{
+			if(players[x].done) { quit = true; }
+		}
+
+		draw();
+		SDL_Delay(16);
+	}
+
+	//Signal every core first, so none of them sits in a hard sync waiting on a player that already stopped
+	for(u32 x = 0; x < total_players; x++) { players[x].core->running = false; }
+
+	#ifdef GBE_NETPLAY
+	link_hub::stop_lockstep();
+	#endif
+
+	for(u32 x = 0; x < total_players; x++) { stop_player(x); }
+}
+
+/****** Thread for one player's core ******/
+int link_session::player_thread(void* data)
+{
+	player_data* player = (player_data*)data;
+	current_player = player->id;
+
+	#ifdef GBE_NETPLAY
+	link_hub::join_lockstep(player->id);
+	#endif
+
+	player->core->start_netplay();
+	player->core->run_core();
+
+	#ifdef GBE_NETPLAY
+	link_hub::leave_lockstep(player->id);
+	#endif
+
+	player->done = true;
+	return 0;
+}
+
+/****** External rendering hook - Called on each core's own thread once per frame ******/
+void link_session::render_player(std::vector<u32> &image)
+{
+	if(active == nullptr) { return; }
+
+	player_data &player = active->players[current_player];
+	std::vector<std::pair<int, bool>> keys;
+
+	SDL_LockMutex(active->frame_lock);
+
+	player.frame = image;
+	keys.swap(player.key_queue);
+
+	SDL_UnlockMutex(active->frame_lock);
+
+	//Apply input between frames, on the same thread as the core
+	for(u32 x = 0; x < keys.size(); x++) { player.core->feed_key_input(keys[x].first, keys[x].second); }
+}
+
+/****** Copies every player's last frame into the window ******/
+void link_session::draw()
+{
+	if(SDL_MUSTLOCK(screen)) { SDL_LockSurface(screen); }
+
+	u32* out_pixel_data = (u32*)screen->pixels;
+	u32 pitch = screen->pitch / 4;
+
+	SDL_LockMutex(frame_lock);
+
+	for(u32 x = 0; x < total_players; x++)
+	{
+		if(players[x].frame.size() < (width * height)) { continue; }
+
+		for(u32 y = 0; y < height; y++)
+		{
+			u32* dst = out_pixel_data + (y * pitch) + (x * width);
+			u32* src = &players[x].frame[y * width];
+
+			for(u32 z = 0; z < width; z++) { dst[z] = src[z]; }
+		}
+	}
+
+	SDL_UnlockMutex(frame_lock);
+
+	if(SDL_MUSTLOCK(screen)) { SDL_UnlockSurface(screen); }
+
+	SDL_BlitScaled(screen, NULL, SDL_GetWindowSurface(window), NULL);
+	SDL_UpdateWindowSurface(window);
+}
+
+/****** Shows which player has the keyboard ******/
+void link_session::update_title()
+{
+	std::string title = "GBE+ Link Session - Player " + util::to_str(focus + 1);
+	SDL_SetWindowTitle(window, title.c_str());
+}
+
+/****** Returns true if a key is bound to one of the emulator's hotkeys ******/
+bool link_session::is_hotkey(int key)
+{
+	if((key >= SDLK_F1) && (key <= SDLK_F12)) { return true; }
+
+	return ((key == (int)config::hotkey_turbo) || (key == (int)config::hotkey_mute) || (key == (int)config::hotkey_camera)
+	|| (key == (int)config::hotkey_swap_screen) || (key == (int)config::hotkey_shift_screen) || (key == (int)config::hotkey_rewind));
+}
+
+/****** Stops one player's core and waits for its thread ******/
+void link_session::stop_player(u8 id)
+{
+	player_data &player = players[id];
+	if(player.thread == nullptr) { return; }
+
+	//Cores check their running flag every instruction, even while waiting in a hard sync
+	player.core->running = false;
+
+	SDL_WaitThread(player.thread, nullptr);
+	player.thread = nullptr;
+}
@@ -0,0 +1,68 @@
+// GB Enhanced+ Copyright Daniel Baxter 2014
+// Licensed under the GPLv2
+// See LICENSE.txt for full license text
+
+// File : link_session.h
+// Date : October 17, 2026
+// Description : Local link sessions
+//
+// Runs several copies of one game inside a single GBE+ process, each core on its own thread
+// Cores link through the in-process hub and draw side by side into one shared window
+
+#ifndef GBE_LINK_SESSION
+#define GBE_LINK_SESSION
+
+#include <atomic>
+#include <vector>
+#include <utility>
+
+#include "common/core_emu.h"
+
+class link_session
+{
+	public:
+
+	link_session();
+	~link_session();
+
+	bool init(u8 count);
+	void run();
+
+	private:
+
+	struct player_data
+	{
+		core_emu* core;
+		SDL_Thread* thread;
+		u8 id;
+
+		//Shared with the main thread, guarded by frame_lock
+		std::vector<u32> frame;
+		std::vector<std::pair<int, bool>> key_queue;
+
+		std::atomic<bool> done;
+	};
+
+	static int player_thread(void* data);
+	static void render_player(std::vector<u32> &image);
+
+	void draw();
+	void update_title();
+	void stop_player(u8 id);
+	static bool is_hotkey(int key);
+
+	player_data players[4];
+	u8 total_players;
+	u8 focus;
+
+	u32 width;
+	u32 height;
+
+	SDL_Window* window;
+	SDL_Surface* screen;
+	SDL_mutex* frame_lock;
+
+	static link_session* active;
+};
+
+#endif // GBE_LINK_SESSION
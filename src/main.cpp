@@ -15,6 +15,7 @@
 #include "min/core.h"
 #include "common/config.h"
 #include "common/info.h"
+#include "link_session.h"
 
 #include <SDL_main.h>
 
@@ -64,6 +65,26 @@ int main(int argc, char* args[])
 	//Get emulated system type from file
 	config::gb_type = get_system_type_from_file(config::rom_file);
 
+	//If no bios file was passed from the command-line arguments, defer to .ini options
+	if((config::use_bios) && (config::bios_file == ""))
+	{
+		switch(config::gb_type)
+		{
+			case SYS_DMG: config::bios_file = config::dmg_bios_path; break;
+			case SYS_GBC: config::bios_file = config::gbc_bios_path; break;
+			case SYS_GBA: config::bios_file = config::agb_bios_path; break;
+			case SYS_MIN: config::bios_file = config::min_bios_path; break;
+		}
+	}
+
+	//Run several linked copies of the game in one window instead
+	if(config::netplay_local_players > 1)
+	{
+		link_session session;
+		if(session.init(config::netplay_local_players)) { session.run(); }
+		return 0;
+	}
+
 	//GBA core
 	if(config::gb_type == SYS_GBA)
 	{
@@ -97,18 +118,6 @@ int main(int argc, char* args[])
 	//Read BIOS file optionally
 	if(config::use_bios) 
 	{
-		//If no bios file was passed from the command-line arguments, defer to .ini options
-		if(config::bios_file == "")
-		{
-			switch(config::gb_type)
-			{
-				case SYS_DMG: config::bios_file = config::dmg_bios_path; break;
-				case SYS_GBC: config::bios_file = config::gbc_bios_path; break;
-				case SYS_GBA: config::bios_file = config::agb_bios_path; break;
-				case SYS_MIN: config::bios_file = config::min_bios_path; break;
-			}
-		}
-
 		if(!gbe_plus->read_bios(config::bios_file)) { return 0; } 
 	}
 
@@ -68,6 +68,13 @@ bool MIN_APU::init()
 		return false;
 	}
 
+	//In a local link session, only the first player owns the audio device, everyone else runs silently
+	if((config::netplay_local) && (SDL_GetAudioStatus() != SDL_AUDIO_STOPPED))
+	{
+		std::cout<<"APU::Initialized - Silent\n";
+		return true;
+	}
+
 	//Setup the desired audio specifications
     	desired_spec.freq = apu_stat.sample_rate;
 	desired_spec.format = AUDIO_S16SYS;
@@ -204,42 +211,16 @@ void min_audio_callback(void* _apu, u8 *_stream, int _length)
 }
 
 /****** Read APU data from save state ******/
-bool MIN_APU::apu_read(u32 offset, std::string filename)
+void MIN_APU::apu_read(state_reader& state)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
-
 	//Serialize misc APU data from save state
-	file.read((char*)&apu_stat, sizeof(apu_stat));
-
-	file.close();
-	return true;
+	state.read(&apu_stat, sizeof(apu_stat));
 }
 
 /****** Read MMU data from save state ******/
-bool MIN_APU::apu_write(std::string filename)
+void MIN_APU::apu_write(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
-
 	//Serialize misc APU data from save state
-	file.write((char*)&apu_stat, sizeof(apu_stat));
-
-	file.close();
-	return true;
+	state.write(&apu_stat, sizeof(apu_stat));
 }
 
-/****** Gets the size of MMU data for serialization ******/
-u32 MIN_APU::size()
-{
-	u32 apu_size = 0;
-
-	apu_size += sizeof(apu_stat);
-
-	return apu_size;
-}
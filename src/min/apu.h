@@ -37,9 +37,8 @@ class MIN_APU
 	void generate_samples(s16* stream, int length);
 
 	//Serialize data for save state loading/saving
-	bool apu_read(u32 offset, std::string filename);
-	bool apu_write(std::string filename);
-	u32 size();
+	void apu_read(state_reader& state);
+	void apu_write(state_writer& state);
 };
 
 /****** SDL Audio Callback ******/ 
@@ -15,6 +15,7 @@
 #include <sstream>
 
 #include "common/util.h"
+#include "common/link_hub.h"
 
 #include "core.h"
 
@@ -163,38 +164,26 @@ void MIN_core::load_state(u8 slot)
 		state_file = config::rom_file + ".ss" + id;
 	}
 
-	u32 offset = 0;
+	std::vector<u8> state_data;
 
 	//Check if save state is accessible
-	std::ifstream test(state_file.c_str());
-	
-	if(!test.good())
+	if(!read_state_file(state_file, state_data))
 	{
-		config::osd_message = "NO SS " + util::to_str(slot);
+		config::osd_message = "INVALID SAVE STATE " + util::to_str(slot);
 		config::osd_count = 180;
 		return;
 	}
 
-	if(!get_save_state_info(offset, state_file)) { return; }
-	offset += sizeof(MIN_SAVE_STATE_VERSION);
-	offset += sizeof(config::gb_type);
-	offset += 32;
-
-	if(!core_cpu.cpu_read(offset, state_file)) { return; }
-	offset += core_cpu.size();
-
-	if(!core_mmu.mmu_read(offset, state_file)) { return; }
-	offset += core_mmu.size();
-
-	if(!core_cpu.controllers.audio.apu_read(offset, state_file)) { return; }
-	offset += core_cpu.controllers.audio.size();
-
-	if(!core_cpu.controllers.video.lcd_read(offset, state_file)) { return; }
+	if(!deserialize_state(&state_data[0], state_data.size()))
+	{
+		std::cout<<"GBE::Error - Could not load save state " << state_file << "\n";
+		return;
+	}
 
 	std::cout<<"GBE::Loaded state " << state_file << "\n";
 
 	//OSD
-	config::osd_message = "LOADED SS " + util::to_str(slot);
+	config::osd_message = "LOADED STATE " + util::to_str(slot);
 	config::osd_count = 180;
 }
 
@@ -216,44 +205,116 @@ void MIN_core::save_state(u8 slot)
 		state_file = config::rom_file + ".ss" + id;
 	}
 
-	if(!set_save_state_info(state_file)) { return; }
-	if(!core_cpu.cpu_write(state_file)) { return; }
-	if(!core_mmu.mmu_write(state_file)) { return; }
-	if(!core_cpu.controllers.audio.apu_write(state_file)) { return; }
-	if(!core_cpu.controllers.video.lcd_write(state_file)) { return; }
+	//Serialize the whole state in memory, then write it out at once
+	std::vector<u8> state_data(get_state_size());
+
+	if(!serialize_state(&state_data[0], state_data.size())) { return; }
+	if(!write_state_file(state_file, state_data)) { return; }
 
 	std::cout<<"GBE::Saved state " << state_file << "\n";
 
 	//OSD
-	config::osd_message = "SAVE SS " + util::to_str(slot);
+	config::osd_message = "SAVED STATE " + util::to_str(slot);
 	config::osd_count = 180;
 }
 
+/****** Gets the number of bytes needed to serialize the core ******/
+u32 MIN_core::get_state_size() { return serialize_state(NULL, 0); }
+
+/****** Serializes the core into a buffer - Returns the bytes written, or 0 if the buffer is too small ******/
+u32 MIN_core::serialize_state(u8* buffer, u32 length)
+{
+	state_writer state(buffer, length);
+
+	set_save_state_info(state);
+
+	state.begin_chunk(STATE_CHUNK_CPU, MIN_SAVE_STATE_VERSION);
+	core_cpu.cpu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_MMU, MIN_SAVE_STATE_VERSION);
+	core_mmu.mmu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_APU, MIN_SAVE_STATE_VERSION);
+	core_cpu.controllers.audio.apu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_LCD, MIN_SAVE_STATE_VERSION);
+	core_cpu.controllers.video.lcd_write(state);
+	state.end_chunk();
+
+	return (state.good()) ? state.size() : 0;
+}
+
+/****** Restores the core from a buffer filled by serialize_state() - The core is left untouched if the buffer is rejected ******/
+bool MIN_core::deserialize_state(const u8* buffer, u32 length)
+{
+	state_reader state(buffer, length);
+
+	if(!get_save_state_info(state)) { return false; }
+
+	//Make sure every chunk is present before changing anything
+	if(!state.has_chunk(STATE_CHUNK_CPU, MIN_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_MMU, MIN_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_APU, MIN_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_LCD, MIN_SAVE_STATE_VERSION)) { return false; }
+
+	return restore_state(buffer, length, [this](u8* data, u32 size) { return serialize_state(data, size); }, [this](const u8* data, u32 size) { return read_state_chunks(data, size); });
+}
+
+/****** Reads every chunk of a state into the core - Only use directly on buffers this core serialized itself ******/
+bool MIN_core::read_state_chunks(const u8* buffer, u32 length)
+{
+	state_reader state(buffer, length);
+
+	if(!get_save_state_info(state)) { return false; }
+
+	state.open_chunk(STATE_CHUNK_CPU, MIN_SAVE_STATE_VERSION);
+	core_cpu.cpu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_MMU, MIN_SAVE_STATE_VERSION);
+	core_mmu.mmu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_APU, MIN_SAVE_STATE_VERSION);
+	core_cpu.controllers.audio.apu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_LCD, MIN_SAVE_STATE_VERSION);
+	core_cpu.controllers.video.lcd_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	return true;
+}
+
 /****** Gets the save state info (Version + System Type) ******/
-bool MIN_core::get_save_state_info(u32 offset, std::string filename)
+bool MIN_core::get_save_state_info(state_reader& state)
 {
 	u32 version = 0;
 	u8 system_type = 0;
 	u8 state_date[32];
 
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	if(!file.is_open()) { return false; }
+	state.read(&version, sizeof(version));
+	state.read(&system_type, sizeof(system_type));
+	state.read(&state_date[0], 32);
 
-	file.seekg(offset);
-	file.read((char*)&version, sizeof(version));
-	file.read((char*)&system_type, sizeof(system_type));
-	file.read((char*)&state_date[0], 32);
-	file.close();
+	if(!state.good())
+	{
+		std::cout<<"GBE::Error - Save State is too small. Cannot load save.\n";
+		return false;
+	}
 
 	if(system_type != config::gb_type)
 	{
-		std::cout<<"GBE::Error - Save State " <<  filename << " has incorrect system type. Cannot load save.\n";
+		std::cout<<"GBE::Error - Save State has incorrect system type. Cannot load save.\n";
 		return false;
 	}
 
 	if(version != MIN_SAVE_STATE_VERSION)
 	{
-		std::cout<<"GBE::Error - Save State " <<  filename << " has outdated version number. Cannot load save.\n";
+		std::cout<<"GBE::Error - Save State has outdated version number. Cannot load save.\n";
 		return false;
 	}
 
@@ -261,11 +322,8 @@ bool MIN_core::get_save_state_info(u32 offset, std::string filename)
 }
 
 /****** Sets the save state info (Version + System Type) ******/
-bool MIN_core::set_save_state_info(std::string filename)
+void MIN_core::set_save_state_info(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
-	if(!file.is_open()) { return false; }
-
 	//Add current date metadata - Fixed size of 32 bytes
 	u8 state_date[32];
 	std::string date = util::get_long_date(true);
@@ -280,12 +338,9 @@ bool MIN_core::set_save_state_info(std::string filename)
 		}
 	}
 
-	file.write((char*)&MIN_SAVE_STATE_VERSION, sizeof(MIN_SAVE_STATE_VERSION));
-	file.write((char*)&config::gb_type, sizeof(config::gb_type));
-	file.write((char*)&state_date[0], 32);
-	file.close();
-
-	return true;
+	state.write(&MIN_SAVE_STATE_VERSION, sizeof(MIN_SAVE_STATE_VERSION));
+	state.write(&config::gb_type, sizeof(config::gb_type));
+	state.write(&state_date[0], 32);
 }
 
 /****** Run the core in a loop until exit ******/
@@ -295,7 +350,8 @@ void MIN_core::run_core()
 	while(running)
 	{
 		//Handle SDL Events
-		if((core_cpu.controllers.video.lcd_stat.prc_counter == 1) && SDL_PollEvent(&event))
+		//Local link sessions poll SDL on the main thread and feed keys through the render hook in video.update()
+		if((core_cpu.controllers.video.lcd_stat.prc_counter == 1) && (!config::netplay_local) && SDL_PollEvent(&event))
 		{
 			//X out of a window
 			if(event.type == SDL_QUIT) { stop(); SDL_Quit(); }
@@ -346,6 +402,11 @@ void MIN_core::run_core()
 				}
 			}
 
+			//Local link sessions run every core in fixed cycle quanta
+			#ifdef GBE_NETPLAY
+			if(config::netplay_local) { link_hub::step_lockstep(core_cpu.system_cycles); }
+			#endif
+
 			//Reset system cycles for next instruction
 			core_cpu.debug_cycles += core_cpu.system_cycles;
 			core_cpu.system_cycles = 0;
@@ -433,7 +494,7 @@ void MIN_core::handle_hotkey(SDL_Event& event)
 		core_mmu.ir_stat.sync_balance = 4;
 
 		//OSD
-		if(core_mmu.ir_stat.network_id != config::netplay_id)
+		if(core_mmu.ir_stat.network_id != core_mmu.player_id)
 		{
 			config::osd_message = "P" + util::to_str(core_mmu.ir_stat.network_id + 1) + " LINKED";
 			core_mmu.ir_stat.try_connection = true;
@@ -633,7 +694,7 @@ void MIN_core::handle_hotkey(int input, bool pressed)
 		core_mmu.ir_stat.try_connection = true;
 
 		//OSD
-		if(core_mmu.ir_stat.network_id != config::netplay_id)
+		if(core_mmu.ir_stat.network_id != core_mmu.player_id)
 		{
 			config::osd_message = "P" + util::to_str(core_mmu.ir_stat.network_id + 1) + " LINKED";
 		}
@@ -738,7 +799,37 @@ u8 MIN_core::ex_read_u8(u16 address) { return core_mmu.read_u8(address); }
 void MIN_core::ex_write_u8(u16 address, u8 value) { core_mmu.write_u8(address, value); }
 
 /****** Starts netplay connection ******/
-void MIN_core::start_netplay() { }
+void MIN_core::start_netplay()
+{
+	//Separate GBE+ instances pick their IR partner with F3 and connect while running
+	if((!config::use_netplay) || (!config::netplay_local)) { return; }
+
+	//Local link sessions point IR at the other player, so both connect before any cycles run
+	u8 id = (core_mmu.player_id) ? 0 : 1;
+
+	core_mmu.ir_stat.network_id = id;
+	core_mmu.ir_stat.try_connection = true;
+
+	//Wait 10 seconds before timing out
+	u32 time_out = 0;
+
+	while(time_out < 10000)
+	{
+		time_out += 100;
+		if((time_out % 1000) == 0) { std::cout<<"IR::Netplay is waiting to establish remote connection...\n"; }
+
+		SDL_Delay(100);
+
+		//Process network connections
+		core_mmu.process_network_communication();
+
+		//Check again if the GBE+ instances connected
+		if(core_mmu.ir_stat.connected[id]) { break; }
+	}
+
+	if(!core_mmu.ir_stat.connected[id]) { std::cout<<"IR::No netplay connection established\n"; }
+	else { std::cout<<"IR::Netplay connection established\n"; }
+}
 
 /****** Perform hard sync for netplay ******/
 void MIN_core::hard_sync()
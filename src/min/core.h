@@ -38,8 +38,12 @@ class MIN_core : virtual public core_emu
 		void feed_key_input(int sdl_key, bool pressed);
 		void save_state(u8 slot);
 		void load_state(u8 slot);
-		bool get_save_state_info(u32 offset, std::string filename);
-		bool set_save_state_info(std::string filename);
+		bool get_save_state_info(state_reader& state);
+		void set_save_state_info(state_writer& state);
+		u32 get_state_size();
+		u32 serialize_state(u8* buffer, u32 length);
+		bool deserialize_state(const u8* buffer, u32 length);
+		bool read_state_chunks(const u8* buffer, u32 length);
 		void run_core();
 
 		//Core debugging
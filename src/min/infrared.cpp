@@ -46,18 +46,18 @@ bool MIN_MMU::init_ir()
 
 	ir_stat.init = true;
 	ir_stat.sync_clock = config::netplay_sync_threshold;
-	ir_stat.network_id = config::netplay_id;
+	ir_stat.network_id = player_id;
 
 	//Server and Client info
 	for(u32 x = 0; x < 10; x++)
 	{
-		u16 server_port = config::netplay_server_port + (10 * config::netplay_id) + x;
-		u16 client_port = config::netplay_server_port + (10 * x) + config::netplay_id;
+		u16 server_port = config::netplay_server_port + (10 * player_id) + x;
+		u16 client_port = config::netplay_server_port + (10 * x) + player_id;
 
-		net_util::setup_comm(server[x], server_port, NET_COMM_SERVER);
-		net_util::setup_comm(sender[x], client_port, NET_COMM_CLIENT);
+		net_util::setup_comm(server[x], server_port, NET_COMM_SERVER, config::netplay_local);
+		net_util::setup_comm(sender[x], client_port, NET_COMM_CLIENT, config::netplay_local);
 
-		if(x != config::netplay_id)
+		if(x != player_id)
 		{
 			//Setup server, resolve the server with nullptr as the hostname, the server will now listen for connections
 			if(net_util::resolve_host(server[x], "") < 0)
@@ -111,7 +111,7 @@ void MIN_MMU::disconnect_ir()
 
 	for(u8 x = 0; x < 10; x++)
 	{
-		if(x != config::netplay_id)
+		if(x != player_id)
 		{
 			//Send disconnect byte to another system
 			u8 temp_buffer[2];
@@ -166,7 +166,7 @@ void MIN_MMU::process_network_communication()
 	u8 id = ir_stat.network_id;
 
 	if(!ir_stat.init) { return; }
-	if(id == config::netplay_id) { return; }
+	if(id == player_id) { return; }
 
 	#ifdef GBE_NETPLAY
 
@@ -209,7 +209,7 @@ bool MIN_MMU::process_ir()
 
 	if(!ir_stat.init || !ir_stat.connected[id]) { return true; }
 	if(memory_map[PM_IO_DATA] & 0x20) { return true; }
-	if(id == config::netplay_id) { return true; }
+	if(id == player_id) { return true; }
 
 	#ifdef GBE_NETPLAY
 
@@ -304,7 +304,7 @@ bool MIN_MMU::recv_byte()
 	u8 id = ir_stat.network_id;
 
 	if(!ir_stat.init || !ir_stat.connected[id]) { return true; }
-	if(id == config::netplay_id) { return true; }
+	if(id == player_id) { return true; }
 
 	#ifdef GBE_NETPLAY
 
@@ -312,7 +312,7 @@ bool MIN_MMU::recv_byte()
 	temp_buffer[0] = temp_buffer[1] = 0;
 
 	//Check the status of connection
-	SDLNet_CheckSockets(server[id].tcp_sockets, 0);
+	net_util::check_sockets(server[id], 0);
 
 	//If this socket is active, receive the transfer
 	if(net_util::recv_data(server[id], temp_buffer, 2) > 0)
@@ -405,7 +405,7 @@ bool MIN_MMU::request_sync()
 	u8 id = ir_stat.network_id;
 
 	if(!ir_stat.init || !ir_stat.connected[id]) { return true; }
-	if(id == config::netplay_id) { return true; }
+	if(id == player_id) { return true; }
 
 	#ifdef GBE_NETPLAY
 
@@ -437,7 +437,7 @@ bool MIN_MMU::stop_sync()
 	u8 id = ir_stat.network_id;
 
 	if(!ir_stat.init || !ir_stat.connected[id]) { return true; }
-	if(id == config::netplay_id) { return true; }
+	if(id == player_id) { return true; }
 
 	#ifdef GBE_NETPLAY
 
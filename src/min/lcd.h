@@ -48,8 +48,8 @@ class MIN_LCD
 	u32 mix_colors[64];
 
 	//Serialize data for save state loading/saving
-	bool lcd_read(u32 offset, std::string filename);
-	bool lcd_write(std::string filename);
+	void lcd_read(state_reader& state);
+	void lcd_write(state_writer& state);
 
 	private:
 
@@ -20,6 +20,10 @@ MIN_MMU::MIN_MMU()
 	//Use shared EEPROM if necessary
 	if((config::min_config & 0x4) == 0) { config::save_file = config::data_path + "min_shared.sav"; }
 
+	//Netplay ID is only valid while the core is built, so keep this player's own copy
+	write_backup = ((!config::netplay_local) || (config::netplay_id == 0));
+	player_id = config::netplay_id;
+
 	reset();
 	init_ir();
 }
@@ -27,7 +31,7 @@ MIN_MMU::MIN_MMU()
 /****** MMU Deconstructor ******/
 MIN_MMU::~MIN_MMU() 
 {
-	if(save_eeprom) { save_backup(config::save_file); }
+	if((save_eeprom) && (write_backup)) { save_backup(config::save_file); }
 	
 	memory_map.clear();
 	disconnect_ir();
@@ -1492,99 +1496,56 @@ void MIN_MMU::set_lcd_data(min_lcd_data* ex_lcd_stat) { lcd_stat = ex_lcd_stat;
 void MIN_MMU::set_apu_data(min_apu_data* ex_apu_stat) { apu_stat = ex_apu_stat; }
 
 /****** Read MMU data from save state ******/
-bool MIN_MMU::mmu_read(u32 offset, std::string filename)
+void MIN_MMU::mmu_read(state_reader& state)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
-
 	//Serialize RAM and hardware MMIO registers from save state
 	u8* ex_mem = &memory_map[0x1000];
-	file.read((char*)ex_mem, 0x1100);
+	state.read(ex_mem, 0x1100);
 
 	//Serialize IRQ stuff to save state
 	for(u32 x = 0; x < 32; x++)
 	{
-		file.read((char*)&irq_priority[x], sizeof(irq_priority[x]));
-		file.read((char*)&irq_enable[x], sizeof(irq_enable[x]));
-		file.read((char*)&irq_vectors[x], sizeof(irq_vectors[x]));
+		state.read(&irq_priority[x], sizeof(irq_priority[x]));
+		state.read(&irq_enable[x], sizeof(irq_enable[x]));
+		state.read(&irq_vectors[x], sizeof(irq_vectors[x]));
 	}
 
 	//Serialize misc data from MMU from save state
-	file.read((char*)&master_irq_flags, sizeof(master_irq_flags));
-	file.read((char*)&osc_1_enable, sizeof(osc_1_enable));
-	file.read((char*)&osc_2_enable, sizeof(osc_2_enable));
-	file.read((char*)&save_eeprom, sizeof(save_eeprom));
-	file.read((char*)&rtc, sizeof(rtc));
-	file.read((char*)&enable_rtc, sizeof(enable_rtc));
-	file.read((char*)&eeprom, sizeof(eeprom));
-	file.read((char*)&sed, sizeof(sed));
-	file.read((char*)&ir_stat, sizeof(ir_stat));
-
-	file.close();
-	return true;
+	state.read(&master_irq_flags, sizeof(master_irq_flags));
+	state.read(&osc_1_enable, sizeof(osc_1_enable));
+	state.read(&osc_2_enable, sizeof(osc_2_enable));
+	state.read(&save_eeprom, sizeof(save_eeprom));
+	state.read(&rtc, sizeof(rtc));
+	state.read(&enable_rtc, sizeof(enable_rtc));
+	state.read(&eeprom, sizeof(eeprom));
+	state.read(&sed, sizeof(sed));
+	state.read(&ir_stat, sizeof(ir_stat));
 }
 
 /****** Write MMU data to save state ******/
-bool MIN_MMU::mmu_write(std::string filename)
+void MIN_MMU::mmu_write(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
-
 	//Serialize RAM and hardware MMIO registers to save state
 	u8* ex_mem = &memory_map[0x1000];
-	file.write((char*)ex_mem, 0x1100);
+	state.write(ex_mem, 0x1100);
 
 	//Serialize IRQ stuff to save state
 	for(u32 x = 0; x < 32; x++)
 	{
-		file.write((char*)&irq_priority[x], sizeof(irq_priority[x]));
-		file.write((char*)&irq_enable[x], sizeof(irq_enable[x]));
-		file.write((char*)&irq_vectors[x], sizeof(irq_vectors[x]));
+		state.write(&irq_priority[x], sizeof(irq_priority[x]));
+		state.write(&irq_enable[x], sizeof(irq_enable[x]));
+		state.write(&irq_vectors[x], sizeof(irq_vectors[x]));
 	}
 
 	//Serialize misc data from MMU to save state
-	file.write((char*)&master_irq_flags, sizeof(master_irq_flags));
-	file.write((char*)&osc_1_enable, sizeof(osc_1_enable));
-	file.write((char*)&osc_2_enable, sizeof(osc_2_enable));
-	file.write((char*)&save_eeprom, sizeof(save_eeprom));
-	file.write((char*)&rtc, sizeof(rtc));
-	file.write((char*)&enable_rtc, sizeof(enable_rtc));
-	file.write((char*)&eeprom, sizeof(eeprom));
-	file.write((char*)&sed, sizeof(sed));
-	file.write((char*)&ir_stat, sizeof(ir_stat));
-
-	file.close();
-	return true;
+	state.write(&master_irq_flags, sizeof(master_irq_flags));
+	state.write(&osc_1_enable, sizeof(osc_1_enable));
+	state.write(&osc_2_enable, sizeof(osc_2_enable));
+	state.write(&save_eeprom, sizeof(save_eeprom));
+	state.write(&rtc, sizeof(rtc));
+	state.write(&enable_rtc, sizeof(enable_rtc));
+	state.write(&eeprom, sizeof(eeprom));
+	state.write(&sed, sizeof(sed));
+	state.write(&ir_stat, sizeof(ir_stat));
 }
 
-/****** Gets the size of MMU data for serialization ******/
-u32 MIN_MMU::size()
-{
-	u32 mmu_size = 0x1100;
-
-	//Serialize IRQ stuff to save state
-	for(u32 x = 0; x < 32; x++)
-	{
-		mmu_size += sizeof(irq_priority[x]);
-		mmu_size += sizeof(irq_enable[x]);
-		mmu_size += sizeof(irq_vectors[x]);
-	}
-
-	//Serialize misc data from MMU from save state
-	mmu_size += sizeof(master_irq_flags);
-	mmu_size += sizeof(osc_1_enable);
-	mmu_size += sizeof(osc_2_enable);
-	mmu_size += sizeof(save_eeprom);
-	mmu_size += sizeof(rtc);
-	mmu_size += sizeof(enable_rtc);
-	mmu_size += sizeof(eeprom);
-	mmu_size += sizeof(sed);
-	mmu_size += sizeof(ir_stat);
-
-	return mmu_size;
-}
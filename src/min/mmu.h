@@ -26,6 +26,7 @@
 #include "common/util.h"
 #include "common/net_util.h"
 #include "timer.h"
+#include "common/save_state.h"
 #include "lcd_data.h"
 #include "apu_data.h"
 
@@ -94,6 +95,12 @@ class MIN_MMU
 
 	bool save_eeprom;
 
+	//Local link sessions only keep Player 1's save data, every player shares the same path
+	bool write_backup;
+
+	//This player's netplay ID, kept apart from IR status so save states leave it alone
+	u8 player_id;
+
 	u32 rtc;
 	u32 rtc_cycles;
 	bool enable_rtc;
@@ -181,9 +188,8 @@ class MIN_MMU
 	void reset();
 
 	//Serialize data for save state loading/saving
-	bool mmu_read(u32 offset, std::string filename);
-	bool mmu_write(std::string filename);
-	u32 size();
+	void mmu_read(state_reader& state);
+	void mmu_write(state_writer& state);
 
 	private:
 
@@ -158,9 +158,8 @@ class S1C88
 	void update_regs();
 
 	//Serialize data for save state loading/saving
-	bool cpu_read(u32 offset, std::string filename);
-	bool cpu_write(std::string filename);
-	u32 size();
+	void cpu_read(state_reader& state);
+	void cpu_write(state_writer& state);
 };
 		
 #endif // PM_CPU 
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "common.h"
+#include "common/arm_alu.h"
 #include "timer.h"
 #include "mmu.h"
 #include "lcd.h"
@@ -270,14 +271,14 @@ class NTR_ARM7
 	void nds7_dma(u8 index);
 
 	//Misc CPU helpers
-	void update_condition_logical(u32 result, u8 shift_out);
+	void update_condition_logical(u32 result, u8 shift_out) { arm_alu<ARM_V4T>::update_condition_logical(reg.cpsr, result, shift_out); }
 	void update_condition_arithmetic(u32 input, u32 operand, u32 result, bool addition);
-	bool check_condition(u32 current_arm_instruction) const;
-	u8 logical_shift_left(u32& input, u8 offset);
-	u8 logical_shift_right(u32& input, u8 offset);
-	u8 arithmetic_shift_right(u32& input, u8 offset);
-	u8 rotate_right(u32& input, u8 offset);
-	u8 rotate_right_special(u32& input, u8 offset);
+	bool check_condition(u32 current_arm_instruction) const { return arm_alu<ARM_V4T>::check_condition(reg.cpsr, current_arm_instruction); }
+	u8 logical_shift_left(u32& input, u8 offset) { return arm_alu<ARM_V4T>::logical_shift_left(input, offset); }
+	u8 logical_shift_right(u32& input, u8 offset) { return arm_alu<ARM_V4T>::logical_shift_right(input, offset); }
+	u8 arithmetic_shift_right(u32& input, u8 offset) { return arm_alu<ARM_V4T>::arithmetic_shift_right(input, offset); }
+	u8 rotate_right(u32& input, u8 offset) { return arm_alu<ARM_V4T>::rotate_right(reg.cpsr, input, offset); }
+	u8 rotate_right_special(u32& input, u8 offset) { return arm_alu<ARM_V4T>::rotate_right_special(reg.cpsr, input, offset); }
 	void mem_check_32(u32 addr, u32& value, bool load_store);
 	void mem_check_16(u32 addr, u32& value, bool load_store);
 	void mem_check_8(u32 addr, u32& value, bool load_store);
@@ -315,9 +316,8 @@ class NTR_ARM7
 	void swi_getvolumetable();
 
 	//Serialize data for save state loading/saving
-	bool cpu_read(u32 offset, std::string filename);
-	bool cpu_write(std::string filename);
-	u32 size();
+	void cpu_read(state_reader& state);
+	void cpu_write(state_writer& state);
 };
 		
 #endif // NDS7_CPU
@@ -69,6 +69,14 @@ void NTR_ARM9::reset()
 	last_instr_branch = false;
 	swi_waitbyloop_count = 0;
 
+	idle_loop.enable = false;
+	idle_loop.addr = 0xFFFFFFFF;
+	idle_loop.write_count = 0;
+	idle_loop.if_flags = 0;
+	idle_loop.scanline = 0;
+	idle_loop.lcd_mode = 0;
+	memset(idle_loop.regs, 0, sizeof(idle_loop.regs));
+
 	arm_mode = ARM;
 
 	controllers.timer.clear();
@@ -954,146 +962,7 @@ void NTR_ARM9::update_pc()
 	reg.r15 += (arm_mode == ARM) ? 4 : 2;
 }
 
-/****** Check conditional code ******/
-bool NTR_ARM9::check_condition(u32 current_arm_instruction) const
-{
-	switch(current_arm_instruction >> 28)
-	{
-		//EQ
-		case 0x0:
-			if(reg.cpsr & CPSR_Z_FLAG) { return true; }
-			else { return false; }
-			break;
-
-		//NE
-		case 0x1:
-			if(reg.cpsr & CPSR_Z_FLAG) { return false; }
-			else { return true; }
-			break;
-
-		//CS
-		case 0x2:
-			if(reg.cpsr & CPSR_C_FLAG) { return true; }
-			else { return false; }
-			break;
-
-		//CC
-		case 0x3:
-			if(reg.cpsr & CPSR_C_FLAG) { return false; }
-			else { return true; }
-			break;
-
-		//MI
-		case 0x4:
-			if(reg.cpsr & CPSR_N_FLAG) { return true; }
-			else { return false; }
-			break;
-
-		//PL
-		case 0x5:
-			if(reg.cpsr & CPSR_N_FLAG) { return false; }
-			else { return true; }
-			break;
-
-		//VS
-		case 0x6:
-			if(reg.cpsr & CPSR_V_FLAG) { return true; }
-			else { return false; }
-			break;
-
-		//VC
-		case 0x7:
-			if(reg.cpsr & CPSR_V_FLAG) { return false; }
-			else { return true; }
-			break;
-
-		//HI
-		case 0x8:
-			if((reg.cpsr & CPSR_C_FLAG) && ((reg.cpsr & CPSR_Z_FLAG) == 0)) { return true; }
-			else { return false; }
-			break;
-
-		//LS
-		case 0x9:
-			if((reg.cpsr & CPSR_Z_FLAG) || ((reg.cpsr & CPSR_C_FLAG) == 0)) { return true; }
-			else { return false; }
-			break;
 
-		//GE
-		case 0xA:
-			{
-				u8 n = (reg.cpsr & CPSR_N_FLAG) ? 1 : 0;
-				u8 v = (reg.cpsr & CPSR_V_FLAG) ? 1 : 0;
-
-				if(n == v) { return true; }
-				else { return false; }
-			}
-			break;
-
-		//LT
-		case 0xB:
-			{
-				u8 n = (reg.cpsr & CPSR_N_FLAG) ? 1 : 0;
-				u8 v = (reg.cpsr & CPSR_V_FLAG) ? 1 : 0;
-
-				if(n != v) { return true; }
-				else { return false; }
-			}
-			break;
-
-		//GT
-		case 0xC:
-			{
-				u8 n = (reg.cpsr & CPSR_N_FLAG) ? 1 : 0;
-				u8 v = (reg.cpsr & CPSR_V_FLAG) ? 1 : 0;
-				u8 z = (reg.cpsr & CPSR_Z_FLAG) ? 1 : 0;
-
-				if((z == 0) && (n == v)) { return true; }
-				else { return false; }
-			}
-			break;
-
-		//LE
-		case 0xD:
-			{
-				u8 n = (reg.cpsr & CPSR_N_FLAG) ? 1 : 0;
-				u8 v = (reg.cpsr & CPSR_V_FLAG) ? 1 : 0;
-				u8 z = (reg.cpsr & CPSR_Z_FLAG) ? 1 : 0;
-
-				if((z == 1) || (n != v)) { return true; }
-				else { return false; }
-			}
-			break;
-
-		//AL
-		case 0xE: return true; break;
-
-		//NV
-		default:
-			if(instruction_pipeline[((pipeline_pointer + 1) % 3)] != ARM_4)
-			{
-				//std::cout<<"CPU::ARM9::Warning: ARM instruction uses reserved conditional code NV \n";
-			}
-
-			return true;
-	}
-}
-
-/****** Updates the condition codes in the CPSR register after logical operations ******/
-void NTR_ARM9::update_condition_logical(u32 result, u8 shift_out)
-{
-	//Negative flag
-	if(result & 0x80000000) { reg.cpsr |= CPSR_N_FLAG; }
-	else { reg.cpsr &= ~CPSR_N_FLAG; }
-
-	//Zero flag
-	if(result == 0) { reg.cpsr |= CPSR_Z_FLAG; }
-	else { reg.cpsr &= ~CPSR_Z_FLAG; }
-
-	//Carry flag
-	if(shift_out == 1) { reg.cpsr |= CPSR_C_FLAG; }
-	else if(shift_out == 0) { reg.cpsr &= ~CPSR_C_FLAG; }
-}
 
 /****** Updates the condition codes in the CPSR register after arithmetic operations ******/
 void NTR_ARM9::update_condition_arithmetic(u32 input, u32 operand, u32 result, bool addition)
@@ -1165,146 +1034,10 @@ u8 NTR_ARM9::update_sticky_overflow(u32 input, u32 operand, u32 result, bool add
 	return saturation_code;
 }
 
-/****** Performs 32-bit logical shift left - Returns Carry Out ******/
-u8 NTR_ARM9::logical_shift_left(u32& input, u8 offset)
-{
-	u8 carry_out = 0;
-
-	if(offset > 0)
-	{
-		//Test for carry
-		//Perform LSL #(n-1), if Bit 31 is 1, we know it will carry out
-		u32 carry_test = input << (offset - 1);
-		carry_out = (carry_test & 0x80000000) ? 1 : 0;
-
-		if(offset >= 32)
-		{
-			input = 0;
-			carry_out = (offset == 32) ? carry_out : 0;
-		}
-
-		else { input <<= offset; }
-	}
-
-	//LSL #0
-	//No shift performed, carry flag not affected, set it to something not 0 or 1 to check!
-	else { carry_out = 2; }
-
-	return carry_out;
-}
-
-/****** Performs 32-bit logical shift right - Returns Carry Out ******/
-u8 NTR_ARM9::logical_shift_right(u32& input, u8 offset)
-{
-	u8 carry_out = 0;
-
-	if(offset > 0)
-	{
-		//Test for carry
-		//Perform LSR #(n-1), if Bit 0 is 1, we know it will carry out
-		u32 carry_test = input >> (offset - 1);
-		carry_out = (carry_test & 0x1) ? 1 : 0;
-
-		if(offset >= 32)
-		{
-			input = 0;
-			carry_out = (offset == 32) ? carry_out : 0;
-		}
-
-		else { input >>= offset; }
-	}
-
-	//LSR #0
-	//Same as LSR #32, input becomes zero, carry flag is Bit 31 of input
-	else
-	{
-		carry_out = (input & 0x80000000) ? 1 : 0;
-		input = 0;
-	}
-
-	return carry_out;
-}
-
-/****** Performs 32-bit arithmetic shift right - Returns Carry Out ******/
-u8 NTR_ARM9::arithmetic_shift_right(u32& input, u8 offset)
-{
-	u8 carry_out = 0;
-
-	if(offset > 0)
-	{
-		u8 high_bit = (input & 0x80000000) ? 1 : 0;		
 
-		//Basically LSR, but bits become Bit 31
-		for(int x = 0; x < offset; x++)
-		{
-			carry_out = (input & 0x1) ? 1 : 0;
-			input >>= 1;
-			if(high_bit == 1) { input |= 0x80000000; }
-		}	
-	}
 
-	//ASR #0
-	//Same as ASR #32, input becomes 0xFFFFFFFF or 0x0 depending on Bit 31 of input
-	//Carry flag set to 0 or 1 depending on Bit 31 of input
-	else
-	{
-		if(input & 0x80000000) { input = 0xFFFFFFFF; carry_out = 1; }
-		else { input = 0; carry_out = 0; }
-	}
 
-	return carry_out;
-}
 
-/****** Performs 32-bit rotate right ******/
-u8 NTR_ARM9::rotate_right(u32& input, u8 offset)
-{
-	u8 carry_out = 0;
-
-	if(offset > 0)
-	{
-		//Perform ROR shift on immediate
-		for(int x = 0; x < offset; x++)
-		{
-			carry_out = input & 0x1;
-			input >>= 1;
-
-			if(carry_out) { input |= 0x80000000; }
-		}
-	}
-
-	//ROR #0
-	//Same as RRX #1, which is similar to ROR #1, except Bit 31 now becomes the old carry flag
-	else
-	{
-		u8 old_carry = (reg.cpsr & CPSR_C_FLAG) ? 1 : 0;
-		carry_out = input & 0x1;
-		input >>= 1;
-		
-		if(old_carry) { input |= 0x80000000; }
-	}
-
-	return carry_out;
-}
-
-/****** Performs 32-bit rotate right - For ARM.5 Data Processing when Bit 25 is 1 ******/
-u8 NTR_ARM9::rotate_right_special(u32& input, u8 offset)
-{
-	u8 carry_out = 2;
-
-	if(offset > 0)
-	{
-		//Perform ROR shift on immediate
-		for(int x = 0; x < (offset * 2); x++)
-		{
-			carry_out = input & 0x1;
-			input >>= 1;
-
-			if(carry_out) { input |= 0x80000000; }
-		}
-	}
-
-	return carry_out;
-}			
 
 /****** Checks address before 32-bit reading/writing for special case scenarios ******/
 void NTR_ARM9::mem_check_32(u32 addr, u32& value, bool load_store)
@@ -1421,6 +1154,47 @@ void NTR_ARM9::clock_system()
 	system_cycles = 2;
 }
 
+/****** Checks whether a branch has landed in an idle loop and puts the NDS9 to sleep if so ******/
+void NTR_ARM9::check_idle_loop()
+{
+	//Geometry commands, DMAs, and cart transfers change state without going through memory writes
+	if(controllers.video.lcd_3D_stat.process_command || mem->nds_card.active_transfer) { return; }
+	if(mem->dma[0].enable || mem->dma[1].enable || mem->dma[2].enable || mem->dma[3].enable) { return; }
+
+	u32 current_regs[16];
+	for(u32 x = 0; x < 15; x++) { current_regs[x] = get_reg(x); }
+	current_regs[15] = reg.cpsr;
+
+	//Same target, same registers, no stores and no timer reads since the last pass
+	//Every further pass would be identical until something outside the CPU changes, so sleep until then
+	if((reg.r15 == idle_loop.addr) && (mem->write_count == idle_loop.write_count) && (!mem->timer_read)
+	&& (std::memcmp(current_regs, idle_loop.regs, sizeof(current_regs)) == 0))
+	{
+		idle_state = 4;
+		idle_loop.if_flags = mem->nds9_if;
+		idle_loop.scanline = controllers.video.lcd_stat.current_scanline;
+		idle_loop.lcd_mode = controllers.video.lcd_stat.lcd_mode;
+		return;
+	}
+
+	idle_loop.addr = reg.r15;
+	idle_loop.write_count = mem->write_count;
+	std::memcpy(idle_loop.regs, current_regs, sizeof(current_regs));
+	mem->timer_read = false;
+}
+
+/****** Wakes the NDS9 from an idle loop once anything it could be polling changes ******/
+void NTR_ARM9::check_idle_exit()
+{
+	if((mem->nds9_if != idle_loop.if_flags) || (mem->write_count != idle_loop.write_count)
+	|| (controllers.video.lcd_stat.current_scanline != idle_loop.scanline) || (controllers.video.lcd_stat.lcd_mode != idle_loop.lcd_mode)
+	|| (!idle_loop.enable))
+	{
+		idle_state = 0;
+		idle_loop.addr = 0xFFFFFFFF;
+	}
+}
+
 /****** Runs DMA controllers every clock cycle ******/
 void NTR_ARM9::clock_dma()
 {
@@ -1586,167 +1360,102 @@ void NTR_ARM9::handle_interrupt()
 }
 
 /****** Read CPU data from save state ******/
-bool NTR_ARM9::cpu_read(u32 offset, std::string filename)
+void NTR_ARM9::cpu_read(state_reader& state)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
-	//Go to offset
-	file.seekg(offset);
-
-	//Serialize CPU registers data from file stream
-	file.read((char*)&reg, sizeof(reg));
+	//Serialize CPU registers data from save state
+	state.read(&reg, sizeof(reg));
 
 	//Serialize misc CPU data from save state
-	file.read((char*)&current_cpu_mode, sizeof(current_cpu_mode));
-	file.read((char*)&arm_mode, sizeof(arm_mode));
-	file.read((char*)&running, sizeof(running));
-	file.read((char*)&lbl_addr, sizeof(lbl_addr));
-	file.read((char*)&first_branch, sizeof(first_branch));
-	file.read((char*)&needs_flush, sizeof(needs_flush));
-	file.read((char*)&in_interrupt, sizeof(in_interrupt));
-	file.read((char*)&idle_state, sizeof(idle_state));
-	file.read((char*)&last_idle_state, sizeof(last_idle_state));
-	file.read((char*)&thumb_long_branch, sizeof(thumb_long_branch));
-	file.read((char*)&last_instr_branch, sizeof(last_instr_branch));
-	file.read((char*)&swi_waitbyloop_count, sizeof(swi_waitbyloop_count));
-	file.read((char*)&instruction_pipeline, sizeof(instruction_pipeline));
-	file.read((char*)&instruction_operation, sizeof(instruction_operation));
-	file.read((char*)&pipeline_pointer, sizeof(pipeline_pointer));
-	file.read((char*)&debug_message, sizeof(debug_message));
-	file.read((char*)&debug_code, sizeof(debug_code));
-	file.read((char*)&debug_cycles, sizeof(debug_cycles));
-	file.read((char*)&debug_addr, sizeof(debug_addr));
-	file.read((char*)&sync_cycles, sizeof(sync_cycles));
-	file.read((char*)&system_cycles, sizeof(system_cycles));
-	file.read((char*)&re_sync, sizeof(re_sync));
+	state.read(&current_cpu_mode, sizeof(current_cpu_mode));
+	state.read(&arm_mode, sizeof(arm_mode));
+	state.read(&running, sizeof(running));
+	state.read(&lbl_addr, sizeof(lbl_addr));
+	state.read(&first_branch, sizeof(first_branch));
+	state.read(&needs_flush, sizeof(needs_flush));
+	state.read(&in_interrupt, sizeof(in_interrupt));
+	state.read(&idle_state, sizeof(idle_state));
+	state.read(&last_idle_state, sizeof(last_idle_state));
+	state.read(&thumb_long_branch, sizeof(thumb_long_branch));
+	state.read(&last_instr_branch, sizeof(last_instr_branch));
+	state.read(&swi_waitbyloop_count, sizeof(swi_waitbyloop_count));
+	state.read(&instruction_pipeline, sizeof(instruction_pipeline));
+	state.read(&instruction_operation, sizeof(instruction_operation));
+	state.read(&pipeline_pointer, sizeof(pipeline_pointer));
+	state.read(&debug_message, sizeof(debug_message));
+	state.read(&debug_code, sizeof(debug_code));
+	state.read(&debug_cycles, sizeof(debug_cycles));
+	state.read(&debug_addr, sizeof(debug_addr));
+	state.read(&sync_cycles, sizeof(sync_cycles));
+	state.read(&system_cycles, sizeof(system_cycles));
+	state.read(&re_sync, sizeof(re_sync));
 
 	//Serialize timers from save state
 	for(u32 x = 0; x < 4; x++)
 	{
-		file.read((char*)&controllers.timer[x], sizeof(controllers.timer[x]));
+		state.read(&controllers.timer[x], sizeof(controllers.timer[x]));
 	}
 
 	//Serialize CP15 registers
-	file.read((char*)&co_proc.regs, sizeof(co_proc.regs));
+	state.read(&co_proc.regs, sizeof(co_proc.regs));
 
 	//Serialize misc CP15 data
-	file.read((char*)&co_proc.pu_enable, sizeof(co_proc.pu_enable));
-	file.read((char*)&co_proc.unified_cache, sizeof(co_proc.unified_cache));
-	file.read((char*)&co_proc.instr_cache, sizeof(co_proc.instr_cache));
-	file.read((char*)&co_proc.exception_vector, sizeof(co_proc.exception_vector));
-	file.read((char*)&co_proc.cache_replacement, sizeof(co_proc.cache_replacement));
-	file.read((char*)&co_proc.pre_armv5, sizeof(co_proc.pre_armv5));
-	file.read((char*)&co_proc.dtcm_enable, sizeof(co_proc.dtcm_enable));
-	file.read((char*)&co_proc.itcm_enable, sizeof(co_proc.itcm_enable));
-
-	file.close();
-	return true;
+	state.read(&co_proc.pu_enable, sizeof(co_proc.pu_enable));
+	state.read(&co_proc.unified_cache, sizeof(co_proc.unified_cache));
+	state.read(&co_proc.instr_cache, sizeof(co_proc.instr_cache));
+	state.read(&co_proc.exception_vector, sizeof(co_proc.exception_vector));
+	state.read(&co_proc.cache_replacement, sizeof(co_proc.cache_replacement));
+	state.read(&co_proc.pre_armv5, sizeof(co_proc.pre_armv5));
+	state.read(&co_proc.dtcm_enable, sizeof(co_proc.dtcm_enable));
+	state.read(&co_proc.itcm_enable, sizeof(co_proc.itcm_enable));
 }
 
 /****** Write CPU data to save state ******/
-bool NTR_ARM9::cpu_write(std::string filename)
+void NTR_ARM9::cpu_write(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
-
 	//Serialize CPU registers data to save state
-	file.write((char*)&reg, sizeof(reg));
+	state.write(&reg, sizeof(reg));
 
 	//Serialize misc CPU data to save state
-	file.write((char*)&current_cpu_mode, sizeof(current_cpu_mode));
-	file.write((char*)&arm_mode, sizeof(arm_mode));
-	file.write((char*)&running, sizeof(running));
-	file.write((char*)&lbl_addr, sizeof(lbl_addr));
-	file.write((char*)&first_branch, sizeof(first_branch));
-	file.write((char*)&needs_flush, sizeof(needs_flush));
-	file.write((char*)&in_interrupt, sizeof(in_interrupt));
-	file.write((char*)&idle_state, sizeof(idle_state));
-	file.write((char*)&last_idle_state, sizeof(last_idle_state));
-	file.write((char*)&thumb_long_branch, sizeof(thumb_long_branch));
-	file.write((char*)&last_instr_branch, sizeof(last_instr_branch));
-	file.write((char*)&swi_waitbyloop_count, sizeof(swi_waitbyloop_count));
-	file.write((char*)&instruction_pipeline, sizeof(instruction_pipeline));
-	file.write((char*)&instruction_operation, sizeof(instruction_operation));
-	file.write((char*)&pipeline_pointer, sizeof(pipeline_pointer));
-	file.write((char*)&debug_message, sizeof(debug_message));
-	file.write((char*)&debug_code, sizeof(debug_code));
-	file.write((char*)&debug_cycles, sizeof(debug_cycles));
-	file.write((char*)&debug_addr, sizeof(debug_addr));
-	file.write((char*)&sync_cycles, sizeof(sync_cycles));
-	file.write((char*)&system_cycles, sizeof(system_cycles));
-	file.write((char*)&re_sync, sizeof(re_sync));
+	state.write(&current_cpu_mode, sizeof(current_cpu_mode));
+	state.write(&arm_mode, sizeof(arm_mode));
+	state.write(&running, sizeof(running));
+	state.write(&lbl_addr, sizeof(lbl_addr));
+	state.write(&first_branch, sizeof(first_branch));
+	state.write(&needs_flush, sizeof(needs_flush));
+	state.write(&in_interrupt, sizeof(in_interrupt));
+	state.write(&idle_state, sizeof(idle_state));
+	state.write(&last_idle_state, sizeof(last_idle_state));
+	state.write(&thumb_long_branch, sizeof(thumb_long_branch));
+	state.write(&last_instr_branch, sizeof(last_instr_branch));
+	state.write(&swi_waitbyloop_count, sizeof(swi_waitbyloop_count));
+	state.write(&instruction_pipeline, sizeof(instruction_pipeline));
+	state.write(&instruction_operation, sizeof(instruction_operation));
+	state.write(&pipeline_pointer, sizeof(pipeline_pointer));
+	state.write(&debug_message, sizeof(debug_message));
+	state.write(&debug_code, sizeof(debug_code));
+	state.write(&debug_cycles, sizeof(debug_cycles));
+	state.write(&debug_addr, sizeof(debug_addr));
+	state.write(&sync_cycles, sizeof(sync_cycles));
+	state.write(&system_cycles, sizeof(system_cycles));
+	state.write(&re_sync, sizeof(re_sync));
 
 	//Serialize timers to save state
 	for(u32 x = 0; x < 4; x++)
 	{
-		file.write((char*)&controllers.timer[x], sizeof(controllers.timer[x]));
+		state.write(&controllers.timer[x], sizeof(controllers.timer[x]));
 	}
 
 	//Serialize CP15 registers
-	file.write((char*)&co_proc.regs, sizeof(co_proc.regs));
+	state.write(&co_proc.regs, sizeof(co_proc.regs));
 
 	//Serialize misc CP15 data
-	file.write((char*)&co_proc.pu_enable, sizeof(co_proc.pu_enable));
-	file.write((char*)&co_proc.unified_cache, sizeof(co_proc.unified_cache));
-	file.write((char*)&co_proc.instr_cache, sizeof(co_proc.instr_cache));
-	file.write((char*)&co_proc.exception_vector, sizeof(co_proc.exception_vector));
-	file.write((char*)&co_proc.cache_replacement, sizeof(co_proc.cache_replacement));
-	file.write((char*)&co_proc.pre_armv5, sizeof(co_proc.pre_armv5));
-	file.write((char*)&co_proc.dtcm_enable, sizeof(co_proc.dtcm_enable));
-	file.write((char*)&co_proc.itcm_enable, sizeof(co_proc.itcm_enable));
-
-	file.close();
-	return true;
+	state.write(&co_proc.pu_enable, sizeof(co_proc.pu_enable));
+	state.write(&co_proc.unified_cache, sizeof(co_proc.unified_cache));
+	state.write(&co_proc.instr_cache, sizeof(co_proc.instr_cache));
+	state.write(&co_proc.exception_vector, sizeof(co_proc.exception_vector));
+	state.write(&co_proc.cache_replacement, sizeof(co_proc.cache_replacement));
+	state.write(&co_proc.pre_armv5, sizeof(co_proc.pre_armv5));
+	state.write(&co_proc.dtcm_enable, sizeof(co_proc.dtcm_enable));
+	state.write(&co_proc.itcm_enable, sizeof(co_proc.itcm_enable));
 }
 
-/****** Gets the size of CPU data for serialization ******/
-u32 NTR_ARM9::size()
-{
-	u32 cpu_size = 0;
-
-	cpu_size += sizeof(reg);
-	cpu_size += sizeof(current_cpu_mode);
-	cpu_size += sizeof(arm_mode);
-	cpu_size += sizeof(running);
-	cpu_size += sizeof(lbl_addr);
-	cpu_size += sizeof(first_branch);
-	cpu_size += sizeof(needs_flush);
-	cpu_size += sizeof(in_interrupt);
-	cpu_size += sizeof(idle_state);
-	cpu_size += sizeof(last_idle_state);
-	cpu_size += sizeof(thumb_long_branch);
-	cpu_size += sizeof(last_instr_branch);
-	cpu_size += sizeof(swi_waitbyloop_count);
-	cpu_size += sizeof(instruction_pipeline);
-	cpu_size += sizeof(instruction_operation);
-	cpu_size += sizeof(pipeline_pointer);
-	cpu_size += sizeof(debug_message);
-	cpu_size += sizeof(debug_code);
-	cpu_size += sizeof(debug_cycles);
-	cpu_size += sizeof(debug_addr);
-
-	for(u32 x = 0; x < 4; x++)
-	{
-		cpu_size += sizeof(controllers.timer[x]);
-	}
-
-	cpu_size += sizeof(sync_cycles);
-	cpu_size += sizeof(system_cycles);
-	cpu_size += sizeof(re_sync);
-
-	cpu_size += sizeof(co_proc.regs);
-
-	cpu_size += sizeof(co_proc.pu_enable);
-	cpu_size += sizeof(co_proc.unified_cache);
-	cpu_size += sizeof(co_proc.instr_cache);
-	cpu_size += sizeof(co_proc.exception_vector);
-	cpu_size += sizeof(co_proc.cache_replacement);
-	cpu_size += sizeof(co_proc.pre_armv5);
-	cpu_size += sizeof(co_proc.dtcm_enable);
-	cpu_size += sizeof(co_proc.itcm_enable);
-
-	return cpu_size;
-}
@@ -15,8 +15,10 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <cstring>
 
 #include "common.h"
+#include "common/arm_alu.h"
 #include "timer.h"
 #include "mmu.h"
 #include "lcd.h"
@@ -183,6 +185,18 @@ class NTR_ARM9
 	bool last_instr_branch;
 	u32 swi_waitbyloop_count;
 
+	//Idle loop detection
+	struct idle_loop_data
+	{
+		bool enable;
+		u32 addr;
+		u32 regs[16];
+		u32 write_count;
+		u32 if_flags;
+		u16 scanline;
+		u8 lcd_mode;
+	} idle_loop;
+
 	u32 instruction_pipeline[3];
 	arm_instructions instruction_operation[3];
 	u8 pipeline_pointer;
@@ -274,20 +288,22 @@ class NTR_ARM9
 	void clock_system();
 	void clock_dma();
 	void handle_interrupt();
+	void check_idle_loop();
+	void check_idle_exit();
 
 	//DMA
 	void nds9_dma(u8 index);
 
 	//Misc CPU helpers
-	void update_condition_logical(u32 result, u8 shift_out);
+	void update_condition_logical(u32 result, u8 shift_out) { arm_alu<ARM_V5TE>::update_condition_logical(reg.cpsr, result, shift_out); }
 	void update_condition_arithmetic(u32 input, u32 operand, u32 result, bool addition);
 	u8 update_sticky_overflow(u32 input, u32 operand, u32 result, bool addition);
-	bool check_condition(u32 current_arm_instruction) const;
-	u8 logical_shift_left(u32& input, u8 offset);
-	u8 logical_shift_right(u32& input, u8 offset);
-	u8 arithmetic_shift_right(u32& input, u8 offset);
-	u8 rotate_right(u32& input, u8 offset);
-	u8 rotate_right_special(u32& input, u8 offset);
+	bool check_condition(u32 current_arm_instruction) const { return arm_alu<ARM_V5TE>::check_condition(reg.cpsr, current_arm_instruction); }
+	u8 logical_shift_left(u32& input, u8 offset) { return arm_alu<ARM_V5TE>::logical_shift_left(input, offset); }
+	u8 logical_shift_right(u32& input, u8 offset) { return arm_alu<ARM_V5TE>::logical_shift_right(input, offset); }
+	u8 arithmetic_shift_right(u32& input, u8 offset) { return arm_alu<ARM_V5TE>::arithmetic_shift_right(input, offset); }
+	u8 rotate_right(u32& input, u8 offset) { return arm_alu<ARM_V5TE>::rotate_right(reg.cpsr, input, offset); }
+	u8 rotate_right_special(u32& input, u8 offset) { return arm_alu<ARM_V5TE>::rotate_right_special(reg.cpsr, input, offset); }
 	void mem_check_32(u32 addr, u32& value, bool load_store);
 	void mem_check_16(u32 addr, u32& value, bool load_store);
 	void mem_check_8(u32 addr, u32& value, bool load_store);
@@ -313,9 +329,8 @@ class NTR_ARM9
 	void swi_custompost();
 
 	//Serialize data for save state loading/saving
-	bool cpu_read(u32 offset, std::string filename);
-	bool cpu_write(std::string filename);
-	u32 size();
+	void cpu_read(state_reader& state);
+	void cpu_write(state_writer& state);
 };
 		
 #endif // NDS9_CPU 
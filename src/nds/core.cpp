@@ -46,6 +46,10 @@ NTR_core::NTR_core()
 	core_mmu.nds9_timer = &core_cpu_nds9.controllers.timer;
 	core_mmu.nds7_timer = &core_cpu_nds7.controllers.timer;
 
+	rewind_frame = 0;
+	rewind_counter = 0;
+	rewinding = false;
+
 	db_unit.debug_mode = false;
 	//db_unit.display_cycles = false;
 	db_unit.print_all = false;
@@ -106,6 +110,12 @@ void NTR_core::start()
 	core_pad.init();
 
 	get_core_data(3);
+
+	//Start rewind history over
+	rewind.reset((config::rewind_interval) ? (config::rewind_buffer_size << 20) : 0);
+	rewind_frame = core_cpu_nds9.controllers.video.frame_count;
+	rewind_counter = 0;
+	rewinding = false;
 }
 
 /****** Stop the core ******/
@@ -202,35 +212,21 @@ void NTR_core::load_state(u8 slot)
 		state_file = config::rom_file + ".ss" + id;
 	}
 
-	u32 offset = 0;
+	std::vector<u8> state_data;
 
 	//Check if save state is accessible
-	std::ifstream test(state_file.c_str());
-	
-	if(!test.good())
+	if(!read_state_file(state_file, state_data))
 	{
 		config::osd_message = "INVALID SAVE STATE " + util::to_str(slot);
 		config::osd_count = 180;
 		return;
 	}
 
-	if(!get_save_state_info(offset, state_file)) { return; }
-	offset += sizeof(NTR_SAVE_STATE_VERSION);
-	offset += sizeof(config::gb_type);
-	offset += 32;
-
-	if(!core_cpu_nds9.cpu_read(offset, state_file)) { return; }
-	offset += core_cpu_nds9.size();
-
-	if(!core_cpu_nds7.cpu_read(offset, state_file)) { return; }
-	offset += core_cpu_nds7.size();
-
-
-	if(!core_mmu.mmu_read(offset, state_file)) { return; }
-	offset += core_mmu.size();
-
-	if(!core_cpu_nds9.controllers.video.lcd_read(offset, state_file)) { return; }
-
+	if(!deserialize_state(&state_data[0], state_data.size()))
+	{
+		std::cout<<"GBE::Error - Could not load save state " << state_file << "\n";
+		return;
+	}
 
 	std::cout<<"GBE::Loaded state " << state_file << "\n";
 
@@ -257,11 +253,11 @@ void NTR_core::save_state(u8 slot)
 		state_file = config::rom_file + ".ss" + id;
 	}
 
-	if(!set_save_state_info(state_file)) { return; }
-	if(!core_cpu_nds9.cpu_write(state_file)) { return; }
-	if(!core_cpu_nds7.cpu_write(state_file)) { return; }
-	if(!core_mmu.mmu_write(state_file)) { return; }
-	if(!core_cpu_nds9.controllers.video.lcd_write(state_file)) { return; }
+	//Serialize the whole state in memory, then write it out at once
+	std::vector<u8> state_data(get_state_size());
+
+	if(!serialize_state(&state_data[0], state_data.size())) { return; }
+	if(!write_state_file(state_file, state_data)) { return; }
 
 	std::cout<<"GBE::Saved state " << state_file << "\n";
 
@@ -270,31 +266,103 @@ void NTR_core::save_state(u8 slot)
 	config::osd_count = 180;
 }
 
+/****** Gets the number of bytes needed to serialize the core ******/
+u32 NTR_core::get_state_size() { return serialize_state(NULL, 0); }
+
+/****** Serializes the core into a buffer - Returns the bytes written, or 0 if the buffer is too small ******/
+u32 NTR_core::serialize_state(u8* buffer, u32 length)
+{
+	state_writer state(buffer, length);
+
+	set_save_state_info(state);
+
+	state.begin_chunk(STATE_CHUNK_CPU, NTR_SAVE_STATE_VERSION);
+	core_cpu_nds9.cpu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_CPU_2, NTR_SAVE_STATE_VERSION);
+	core_cpu_nds7.cpu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_MMU, NTR_SAVE_STATE_VERSION);
+	core_mmu.mmu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_LCD, NTR_SAVE_STATE_VERSION);
+	core_cpu_nds9.controllers.video.lcd_write(state);
+	state.end_chunk();
+
+	return (state.good()) ? state.size() : 0;
+}
+
+/****** Restores the core from a buffer filled by serialize_state() - The core is left untouched if the buffer is rejected ******/
+bool NTR_core::deserialize_state(const u8* buffer, u32 length)
+{
+	state_reader state(buffer, length);
+
+	if(!get_save_state_info(state)) { return false; }
+
+	//Make sure every chunk is present before changing anything
+	if(!state.has_chunk(STATE_CHUNK_CPU, NTR_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_CPU_2, NTR_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_MMU, NTR_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_LCD, NTR_SAVE_STATE_VERSION)) { return false; }
+
+	return restore_state(buffer, length, [this](u8* data, u32 size) { return serialize_state(data, size); }, [this](const u8* data, u32 size) { return read_state_chunks(data, size); });
+}
+
+/****** Reads every chunk of a state into the core - Only use directly on buffers this core serialized itself ******/
+bool NTR_core::read_state_chunks(const u8* buffer, u32 length)
+{
+	state_reader state(buffer, length);
+
+	if(!get_save_state_info(state)) { return false; }
+
+	state.open_chunk(STATE_CHUNK_CPU, NTR_SAVE_STATE_VERSION);
+	core_cpu_nds9.cpu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_CPU_2, NTR_SAVE_STATE_VERSION);
+	core_cpu_nds7.cpu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_MMU, NTR_SAVE_STATE_VERSION);
+	core_mmu.mmu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_LCD, NTR_SAVE_STATE_VERSION);
+	core_cpu_nds9.controllers.video.lcd_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	return true;
+}
+
 /****** Gets the save state info (Version + System Type) ******/
-bool NTR_core::get_save_state_info(u32 offset, std::string filename)
+bool NTR_core::get_save_state_info(state_reader& state)
 {
 	u32 version = 0;
 	u8 system_type = 0;
 	u8 state_date[32];
 
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	if(!file.is_open()) { return false; }
+	state.read(&version, sizeof(version));
+	state.read(&system_type, sizeof(system_type));
+	state.read(&state_date[0], 32);
 
-	file.seekg(offset);
-	file.read((char*)&version, sizeof(version));
-	file.read((char*)&system_type, sizeof(system_type));
-	file.read((char*)&state_date[0], 32);
-	file.close();
+	if(!state.good())
+	{
+		std::cout<<"GBE::Error - Save State is too small. Cannot load save.\n";
+		return false;
+	}
 
 	if(system_type != config::gb_type)
 	{
-		std::cout<<"GBE::Error - Save State " <<  filename << " has incorrect system type. Cannot load save.\n";
+		std::cout<<"GBE::Error - Save State has incorrect system type. Cannot load save.\n";
 		return false;
 	}
 
 	if(version != NTR_SAVE_STATE_VERSION)
 	{
-		std::cout<<"GBE::Error - Save State " <<  filename << " has outdated version number. Cannot load save.\n";
+		std::cout<<"GBE::Error - Save State has outdated version number. Cannot load save.\n";
 		return false;
 	}
 
@@ -302,11 +370,8 @@ bool NTR_core::get_save_state_info(u32 offset, std::string filename)
 }
 
 /****** Sets the save state info (Version + System Type) ******/
-bool NTR_core::set_save_state_info(std::string filename)
+void NTR_core::set_save_state_info(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
-	if(!file.is_open()) { return false; }
-
 	//Add current date metadata - Fixed size of 32 bytes
 	u8 state_date[32];
 	std::string date = util::get_long_date(true);
@@ -321,12 +386,73 @@ bool NTR_core::set_save_state_info(std::string filename)
 		}
 	}
 
-	file.write((char*)&NTR_SAVE_STATE_VERSION, sizeof(NTR_SAVE_STATE_VERSION));
-	file.write((char*)&config::gb_type, sizeof(config::gb_type));
-	file.write((char*)&state_date[0], 32);
-	file.close();
+	state.write(&NTR_SAVE_STATE_VERSION, sizeof(NTR_SAVE_STATE_VERSION));
+	state.write(&config::gb_type, sizeof(config::gb_type));
+	state.write(&state_date[0], 32);
+}
 
-	return true;
+/****** Takes rewind snapshots, or steps back through them while rewinding - Called once per frame ******/
+void NTR_core::update_rewind()
+{
+	rewind_frame = core_cpu_nds9.controllers.video.frame_count;
+
+	if(!config::rewind_interval) { return; }
+
+	//Load the newest snapshot each frame, history steps back by one every time
+	if(rewinding)
+	{
+		if(rewind.pop(rewind_state)) { read_state_chunks(&rewind_state[0], rewind_state.size()); }
+		rewind_counter = 0;
+	}
+
+	else if(++rewind_counter >= config::rewind_interval)
+	{
+		rewind_counter = 0;
+		rewind_state.resize(get_state_size());
+
+		if(serialize_state(&rewind_state[0], rewind_state.size())) { rewind.push(rewind_state); }
+	}
+}
+
+/****** Shows a frame from the future, then rolls back to the committed one - Called once per frame ******/
+void NTR_core::update_run_ahead()
+{
+	NTR_LCD& video = core_cpu_nds9.controllers.video;
+
+	//Rewinding shows each snapshot as is
+	if((!config::run_ahead) || (rewinding) || (db_unit.debug_mode))
+	{
+		video.frame_skip.set_hidden(false);
+		return;
+	}
+
+	run_ahead_state.resize(get_state_size());
+
+	if(!serialize_state(&run_ahead_state[0], run_ahead_state.size()))
+	{
+		video.frame_skip.set_hidden(false);
+		return;
+	}
+
+	//Future frames must never be heard, so keep the audio callback out until they are rolled back
+	SDL_LockAudio();
+
+	for(u32 x = 1; x <= config::run_ahead; x++)
+	{
+		video.frame_skip.set_hidden(x != config::run_ahead);
+		video.frame_skip.set_paced(false);
+		u32 frame = video.frame_count;
+
+		//Give up on frames the LCD never finishes
+		for(u32 y = 0; ((core_cpu_nds9.running) && (core_cpu_nds7.running)) && (video.frame_count == frame) && (y < 0x800000); y++) { step(); }
+	}
+
+	read_state_chunks(&run_ahead_state[0], run_ahead_state.size());
+	SDL_UnlockAudio();
+
+	//The committed frame is emulated next, but never shown - It waits on the frame limiter instead, outside of any audio lock
+	video.frame_skip.set_hidden(true);
+	video.frame_skip.set_paced(true);
 }
 
 /****** Run the core in a loop until exit ******/
@@ -376,11 +502,21 @@ void NTR_core::run_core()
 			else if((event.type == SDL_JOYDEVICEREMOVED) && (core_pad.joy_init)) { core_pad.close_joystick(); }
 		}
 
+		//Once per frame, take rewind snapshots or step backwards, then run ahead
+		if(core_cpu_nds9.controllers.video.frame_count != rewind_frame)
+		{
+			update_rewind();
+			update_run_ahead();
+			rewind_frame = core_cpu_nds9.controllers.video.frame_count;
+		}
+
 		//Run the CPU
 		if((core_cpu_nds9.running) && (core_cpu_nds7.running))
 		{	
 			if(db_unit.debug_mode) { debug_step(); }
 
+			core_cpu_nds9.idle_loop.enable = (config::skip_idle_loops && !db_unit.debug_mode);
+
 			//Run NDS9
 			if(core_cpu_nds9.re_sync)
 			{
@@ -421,6 +557,11 @@ void NTR_core::run_core()
 							if(core_cpu_nds9.swi_waitbyloop_count & 0x80000000) { core_cpu_nds9.idle_state = 0; }
 							break;
 
+						//Idle loop
+						case 0x4:
+							core_cpu_nds9.check_idle_exit();
+							break;
+
 						//IntrWait, VBlankIntrWait
 						case 0x3:
 							//If R0 == 0, quit on any IRQ
@@ -488,6 +629,9 @@ void NTR_core::run_core()
 					{
 						core_cpu_nds9.flush_pipeline();
 						core_cpu_nds9.last_instr_branch = true;
+
+						//Branches may land in an idle loop
+						if(core_cpu_nds9.idle_loop.enable) { core_cpu_nds9.check_idle_loop(); }
 					}
 
 					//Else update the pipeline and PC
@@ -693,6 +837,11 @@ void NTR_core::step()
 						if(core_cpu_nds9.swi_waitbyloop_count & 0x80000000) { core_cpu_nds9.idle_state = 0; }
 						break;
 
+					//Idle loop
+					case 0x4:
+						core_cpu_nds9.check_idle_exit();
+						break;
+
 					//IntrWait, VBlankIntrWait
 					case 0x3:
 						//If R0 == 0, quit on any IRQ
@@ -1029,6 +1178,10 @@ void NTR_core::handle_hotkey(SDL_Event& event)
 		if((config::sdl_render) && (config::use_opengl)) { SDL_GL_SetSwapInterval(1); }
 	}
 
+	//Step backwards while the rewind hotkey is held
+	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == config::hotkey_rewind)) { rewinding = true; }
+	else if((event.type == SDL_KEYUP) && (event.key.keysym.sym == config::hotkey_rewind)) { rewinding = false; }
+
 	//Start IR communications
 	else if((event.type == SDL_KEYDOWN) && (event.key.keysym.sym == SDLK_F3))
 	{
@@ -1089,6 +1242,9 @@ void NTR_core::handle_hotkey(int input, bool pressed)
 	//Toggle turbo off
 	else if((input == config::hotkey_turbo) && (!pressed)) { config::turbo = false; }
 
+	//Step backwards while the rewind hotkey is held
+	else if(input == config::hotkey_rewind) { rewinding = pressed; }
+
 	//Toggle swap NDS screens on F4
 	else if((input == config::hotkey_swap_screen) && (pressed))
 	{
@@ -16,6 +16,7 @@
 #define NDS_CORE
 
 #include "common/core_emu.h"
+#include "common/rewind.h"
 #include "common/config.h"
 #include "mmu.h"
 #include "lcd.h"
@@ -40,9 +41,15 @@ class NTR_core : virtual public core_emu
 		void feed_key_input(int sdl_key, bool pressed);
 		void save_state(u8 slot);
 		void load_state(u8 slot);
-		bool get_save_state_info(u32 offset, std::string filename);
-		bool set_save_state_info(std::string filename);
+		bool get_save_state_info(state_reader& state);
+		void set_save_state_info(state_writer& state);
+		u32 get_state_size();
+		u32 serialize_state(u8* buffer, u32 length);
+		bool deserialize_state(const u8* buffer, u32 length);
+		bool read_state_chunks(const u8* buffer, u32 length);
 		void run_core();
+		void update_rewind();
+		void update_run_ahead();
 		void step();
 
 		//Core debugging
@@ -78,6 +85,16 @@ class NTR_core : virtual public core_emu
 		bool arm_debug;
 
 		NTR_GamePad core_pad;
+
+		//Rewind history
+		rewind_buffer rewind;
+		std::vector<u8> rewind_state;
+		u32 rewind_frame;
+		u32 rewind_counter;
+		bool rewinding;
+
+		//Snapshot of the committed frame while running ahead
+		std::vector<u8> run_ahead_state;
 };
 		
 #endif // NDS_CORE
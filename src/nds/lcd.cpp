@@ -68,7 +68,9 @@ void NTR_LCD::reset()
 	frame_start_time = 0;
 	frame_current_time = 0;
 	fps_count = 0;
+	frame_count = 0;
 	fps_time = 0;
+	frame_skip.reset();
 
 	for(u32 x = 0; x < 60; x++)
 	{
@@ -93,6 +95,13 @@ void NTR_LCD::reset()
 	scanline_buffer_a.resize(0x100, 0);
 	scanline_buffer_b.resize(0x100, 0);
 
+	for(u32 x = 0; x < 256; x++)
+	{
+		sfx_line_target_1[x] = 0;
+		sfx_line_target_2[x] = 0;
+		sfx_line_enable[x] = false;
+	}
+
 	render_buffer_a.resize(0x100, 0);
 	render_buffer_b.resize(0x100, 0);
 	gx_render_buffer.resize(2);
@@ -541,7 +550,7 @@ bool NTR_LCD::init()
 		final_screen = SDL_CreateRGBSurface(SDL_SWSURFACE, config::sys_width, config::sys_height, 32, 0, 0, 0, 0);
 	}
 
-	std::cout<<"LCD::Initialized\n";
+	std::cout<<"LCD::Initialized - " << sfx_kernel_name() << " SFX kernels\n";
 
 	return true;
 }
@@ -3338,7 +3347,7 @@ void NTR_LCD::brightness_up(u32 bg_control)
 	u8 bg_priority_2 = (bg_control == NDS_DISPCNT_A) ? lcd_stat.bg_priority_a[2] : lcd_stat.bg_priority_b[2];
 	u8 bg_priority_3 = (bg_control == NDS_DISPCNT_A) ? lcd_stat.bg_priority_a[3] : lcd_stat.bg_priority_b[3];
 
-	double coef = (bg_control == NDS_DISPCNT_A) ? lcd_stat.brightness_coef_a : lcd_stat.brightness_coef_b;
+	u8 evy = ((bg_control == NDS_DISPCNT_A) ? lcd_stat.brightness_coef_a : lcd_stat.brightness_coef_b) * 16.0;
 
 	//Determine BG priority
 	for(int x = 0, list_length = 0; x < 4; x++)
@@ -3418,36 +3427,19 @@ void NTR_LCD::brightness_up(u32 bg_control)
 		//Check to see if target is enabled
 		target_enable = (bg_control == NDS_DISPCNT_A) ? lcd_stat.sfx_target_a[target][0] : lcd_stat.sfx_target_b[target][0];
 
-		//Proceed with SFX
-		if(target_enable)
-		{
-			u32 color = 0;
-			s16 result = 0;
-
-			//Pull color from backdrop
-			if(target == 5) { color = (bg_control == NDS_DISPCNT_A) ? lcd_stat.bg_pal_a[0] : lcd_stat.bg_pal_b[0]; }
-
-			//Pull color from layers
-			else { color = (is_obj) ? obj_line_buffer[layer][x] : line_buffer[layer][x]; }
+		//Gather the 1st target for SFX
+		sfx_line_enable[x] = target_enable;
 
-			//Increase RGB intensities
-			u8 red = ((color >> 19) & 0x1F);
-			result = red + ((0x1F - red) * coef);
-			red = (result > 0x1F) ? 0x1F : result;
+		//Pull color from backdrop
+		if(target == 5) { sfx_line_target_1[x] = (bg_control == NDS_DISPCNT_A) ? lcd_stat.bg_pal_a[0] : lcd_stat.bg_pal_b[0]; }
 
-			u8 green = ((color >> 11) & 0x1F);
-			result = green + ((0x1F - green) * coef);
-			green = (result > 0x1F) ? 0x1F : result;
-
-			u8 blue = ((color >> 3) & 0x1F);
-			result = blue + ((0x1F - blue) * coef);
-			blue = (result > 0x1F) ? 0x1F : result;
-
-			//Copy 32-bit color to scanline buffer
-			if(bg_control == NDS_DISPCNT_A) { scanline_buffer_a[x] = 0xFF000000 | (red << 19) | (green << 11) | (blue << 3); }
-			else { scanline_buffer_b[x] = 0xFF000000 | (red << 19) | (green << 11) | (blue << 3); }
-		}
+		//Pull color from layers
+		else { sfx_line_target_1[x] = (is_obj) ? obj_line_buffer[layer][x] : line_buffer[layer][x]; }
 	}
+
+	//Increase RGB intensities
+	sfx_brightness_up(sfx_line_result, sfx_line_target_1, evy, 256, SFX_RGB15);
+	copy_sfx_line(bg_control);
 }
 
 /****** SFX - Adjust scanline brightness down ******/
@@ -3461,7 +3453,7 @@ void NTR_LCD::brightness_down(u32 bg_control)
 	u8 bg_priority_2 = (bg_control == NDS_DISPCNT_A) ? lcd_stat.bg_priority_a[2] : lcd_stat.bg_priority_b[2];
 	u8 bg_priority_3 = (bg_control == NDS_DISPCNT_A) ? lcd_stat.bg_priority_a[3] : lcd_stat.bg_priority_b[3];
 
-	double coef = (bg_control == NDS_DISPCNT_A) ? lcd_stat.brightness_coef_a : lcd_stat.brightness_coef_b;
+	u8 evy = ((bg_control == NDS_DISPCNT_A) ? lcd_stat.brightness_coef_a : lcd_stat.brightness_coef_b) * 16.0;
 
 	//Determine BG priority
 	for(int x = 0, list_length = 0; x < 4; x++)
@@ -3541,36 +3533,19 @@ void NTR_LCD::brightness_down(u32 bg_control)
 		//Check to see if target is enabled
 		target_enable = (bg_control == NDS_DISPCNT_A) ? lcd_stat.sfx_target_a[target][0] : lcd_stat.sfx_target_b[target][0];
 
-		//Proceed with SFX
-		if(target_enable)
-		{
-			u32 color = 0;
-			s16 result = 0;
-
-			//Pull color from backdrop
-			if(target == 5) { color = (bg_control == NDS_DISPCNT_A) ? lcd_stat.bg_pal_a[0] : lcd_stat.bg_pal_b[0]; }
+		//Gather the 1st target for SFX
+		sfx_line_enable[x] = target_enable;
 
-			//Pull color from layers
-			else { color = (is_obj) ? obj_line_buffer[layer][x] : line_buffer[layer][x]; }
+		//Pull color from backdrop
+		if(target == 5) { sfx_line_target_1[x] = (bg_control == NDS_DISPCNT_A) ? lcd_stat.bg_pal_a[0] : lcd_stat.bg_pal_b[0]; }
 
-			//Decrease RGB intensities 
-			u8 red = ((color >> 19) & 0x1F);
-			result = red - (red * coef);
-			red = (result < 0) ? 0 : result;
-
-			u8 green = ((color >> 11) & 0x1F);
-			result = green - (green * coef);
-			green = (result < 0) ? 0 : result;
-
-			u8 blue = ((color >> 3) & 0x1F);
-			result = blue - (blue * coef);
-			blue = (result < 0) ? 0 : result;
-
-			//Copy 32-bit color to scanline buffer
-			if(bg_control == NDS_DISPCNT_A) { scanline_buffer_a[x] = 0xFF000000 | (red << 19) | (green << 11) | (blue << 3); }
-			else { scanline_buffer_b[x] = 0xFF000000 | (red << 19) | (green << 11) | (blue << 3); }
-		}
+		//Pull color from layers
+		else { sfx_line_target_1[x] = (is_obj) ? obj_line_buffer[layer][x] : line_buffer[layer][x]; }
 	}
+
+	//Decrease RGB intensities
+	sfx_brightness_down(sfx_line_result, sfx_line_target_1, evy, 256, SFX_RGB15);
+	copy_sfx_line(bg_control);
 }
 
 /****** SFX - Alpha blending *****/
@@ -3579,12 +3554,8 @@ void NTR_LCD::alpha_blend(u32 bg_control)
 	u8 bg_render_list[4];
 	u8 bg_layer[4];
 
-	u8 r1, r2;
-	u8 g1, g2;
-	u8 b1, b2;
-
-	double coef_1 = (bg_control == NDS_DISPCNT_A) ? lcd_stat.alpha_coef_a[0] : lcd_stat.alpha_coef_b[0];
-	double coef_2 = (bg_control == NDS_DISPCNT_A) ? lcd_stat.alpha_coef_a[1] : lcd_stat.alpha_coef_b[1];
+	u8 eva = ((bg_control == NDS_DISPCNT_A) ? lcd_stat.alpha_coef_a[0] : lcd_stat.alpha_coef_b[0]) * 16.0;
+	u8 evb = ((bg_control == NDS_DISPCNT_A) ? lcd_stat.alpha_coef_a[1] : lcd_stat.alpha_coef_b[1]) * 16.0;
 
 	u8 bg_priority_0 = (bg_control == NDS_DISPCNT_A) ? lcd_stat.bg_priority_a[0] : lcd_stat.bg_priority_b[0];
 	u8 bg_priority_1 = (bg_control == NDS_DISPCNT_A) ? lcd_stat.bg_priority_a[1] : lcd_stat.bg_priority_b[1];
@@ -3751,41 +3722,31 @@ void NTR_LCD::alpha_blend(u32 bg_control)
 		//If 1st target is 3D BG0, a separate alpha-blending formula must be used
 		target_3D = ((bg0_is_3D) && (target_1 == 0));
 
-		//Proceed with alpha blending if conditions met
-		if(found_target_1 && found_target_2 && target_1_enable && target_2_enable && !target_3D)
-		{
-			u8 result = 0;
-			u32 color_1 = (is_obj_1) ? obj_line_buffer[layer_1][x] : line_buffer[layer_1][x];
-			u32 color_2 = 0;
-
-			//Pull color from backdrop
-			if(target_2 == 5) { color_2 = (bg_control == NDS_DISPCNT_A) ? lcd_stat.bg_pal_a[0] : lcd_stat.bg_pal_b[0]; }
-
-			//Pull color from layers
-			else { color_2 = (is_obj_2) ? obj_line_buffer[layer_2][x] : line_buffer[layer_2][x]; }
+		//Gather both targets if alpha blending conditions are met
+		sfx_line_enable[x] = (found_target_1 && found_target_2 && target_1_enable && target_2_enable && !target_3D);
+		if(!sfx_line_enable[x]) { continue; }
 
-			//Grab RGB15 values of both targets
-			r1 = (color_1 >> 19) & 0x1F;
-			g1 = (color_1 >> 11) & 0x1F;
-			b1 = (color_1 >> 3) & 0x1F;
+		sfx_line_target_1[x] = (is_obj_1) ? obj_line_buffer[layer_1][x] : line_buffer[layer_1][x];
 
-			r2 = (color_2 >> 19) & 0x1F;
-			g2 = (color_2 >> 11) & 0x1F;
-			b2 = (color_2 >> 3) & 0x1F;
+		//Pull color from backdrop
+		if(target_2 == 5) { sfx_line_target_2[x] = (bg_control == NDS_DISPCNT_A) ? lcd_stat.bg_pal_a[0] : lcd_stat.bg_pal_b[0]; }
 
-			result = (r1 * coef_1) + (r2 * coef_2);
-			u8 red = (result > 0x1F) ? 0x1F : result;
+		//Pull color from layers
+		else { sfx_line_target_2[x] = (is_obj_2) ? obj_line_buffer[layer_2][x] : line_buffer[layer_2][x]; }
+	}
 
-			result = (g1 * coef_1) + (g2 * coef_2);
-			u8 green = (result > 0x1F) ? 0x1F : result;
+	sfx_alpha_blend(sfx_line_result, sfx_line_target_1, sfx_line_target_2, eva, evb, 256);
+	copy_sfx_line(bg_control);
+}
 
-			result = (b1 * coef_1) + (b2 * coef_2);
-			u8 blue = (result > 0x1F) ? 0x1F : result;
+/****** Copies SFX kernel results to every scanline pixel that uses SFX ******/
+void NTR_LCD::copy_sfx_line(u32 bg_control)
+{
+	std::vector<u32>& scanline_buffer = (bg_control == NDS_DISPCNT_A) ? scanline_buffer_a : scanline_buffer_b;
 
-			//Copy 32-bit color to scanline buffer
-			if(bg_control == NDS_DISPCNT_A) { scanline_buffer_a[x] = 0xFF000000 | (red << 19) | (green << 11) | (blue << 3); }
-			else { scanline_buffer_b[x] = 0xFF000000 | (red << 19) | (green << 11) | (blue << 3); }
-		}
+	for(u32 x = 0; x < 256; x++)
+	{
+		if(sfx_line_enable[x]) { scanline_buffer[x] = sfx_line_result[x]; }
 	}
 }
 
@@ -3793,114 +3754,16 @@ void NTR_LCD::alpha_blend(u32 bg_control)
 void NTR_LCD::adjust_master_brightness(u8 engine_id)
 {
 	u16 master_bright = (engine_id) ? lcd_stat.master_bright_a : lcd_stat.master_bright_b;
+	u8 factor = (master_bright & 0x1F);
 
-	double factor = (master_bright & 0x1F) / 16.0;
-	u32 color = 0;
-	
-	u8 r = 0;
-	u8 g = 0;
-	u8 b = 0;
-	s16 result = 0;
+	//Engine A or B pixels
+	std::vector<u32>& scanline_buffer = (engine_id) ? scanline_buffer_a : scanline_buffer_b;
 
 	//Master Brightness Up
-	if((master_bright >> 14) == 0x1)
-	{
-		//Engine A pixels
-		if(engine_id)
-		{
-			for(u32 x = 0; x < 256; x++)
-			{
-				color = scanline_buffer_a[x];
-
-				r = (color >> 18) & 0x3F;
-				result = r + ((63 - r) * factor);
-				r = (result > 63) ? 63 : result;
-
-				g = (color >> 10) & 0x3F;
-				result = g + ((63 - g) * factor);
-				g = (result > 63) ? 63 : result;
-
-				b = (color >> 2) & 0x3F;
-				result = b + ((63 - b) * factor);
-				b = (result > 63) ? 63 : result;
-
-				scanline_buffer_a[x] = 0xFF000000 | (r << 18) | (g << 10) | (b << 2);
-			}
-		}
-
-		//Engine B pixels
-		else
-		{
-			for(u32 x = 0; x < 256; x++)
-			{
-				color = scanline_buffer_b[x];
-
-				r = (color >> 18) & 0x3F;
-				result = r + ((63 - r) * factor);
-				r = (result > 63) ? 63 : result;
-
-				g = (color >> 10) & 0x3F;
-				result = g + ((63 - g) * factor);
-				g = (result > 63) ? 63 : result;
-
-				b = (color >> 2) & 0x3F;
-				result = b + ((63 - b) * factor);
-				b = (result > 63) ? 63 : result;
-
-				scanline_buffer_b[x] = 0xFF000000 | (r << 18) | (g << 10) | (b << 2);
-			}
-		}
-	}
+	if((master_bright >> 14) == 0x1) { sfx_brightness_up(&scanline_buffer[0], &scanline_buffer[0], factor, 256, SFX_RGB18); }
 
 	//Master Bright Down
-	if((master_bright >> 14) == 0x2)
-	{
-		//Engine A pixels
-		if(engine_id)
-		{
-			for(u32 x = 0; x < 256; x++)
-			{
-				color = scanline_buffer_a[x];
-
-				r = ((color >> 18) & 0x3F);
-				result = r - (r * factor);
-				r = (result < 0) ? 0 : result;
-
-				g = ((color >> 10) & 0x3F);
-				result = g - (g * factor);
-				g = (result < 0) ? 0 : result;
-
-				b = ((color >> 2) & 0x3F);
-				result = b - (b * factor);
-				b = (result < 0) ? 0 : result;
-
-				scanline_buffer_a[x] = 0xFF000000 | (r << 18) | (g << 10) | (b << 2);
-			}
-		}
-
-		//Engine B pixels
-		else
-		{
-			for(u32 x = 0; x < 256; x++)
-			{
-				color = scanline_buffer_b[x];
-
-				r = ((color >> 18) & 0x3F);
-				result = r - (r * factor);
-				r = (result < 0) ? 0 : result;
-
-				g = ((color >> 10) & 0x3F);
-				result = g - (g * factor);
-				g = (result < 0) ? 0 : result;
-
-				b = ((color >> 2) & 0x3F);
-				result = b - (b * factor);
-				b = (result < 0) ? 0 : result;
-
-				scanline_buffer_b[x] = 0xFF000000 | (r << 18) | (g << 10) | (b << 2);
-			}
-		}
-	}
+	if((master_bright >> 14) == 0x2) { sfx_brightness_down(&scanline_buffer[0], &scanline_buffer[0], factor, 256, SFX_RGB18); }
 }
 
 /****** Calculates what coordinates of a scanline are within a Window ******/
@@ -4190,38 +4053,41 @@ void NTR_LCD::step()
 				lcd_stat.update_bg_control_b = false;
 			}
 
-			//Render scanline data
-			render_scanline();
+			//Render scanline data - Frames being captured are always drawn when frame skipping
+			if((!frame_skip.skip_frame) || (lcd_stat.cap_started))
+			{
+				render_scanline();
 
-			//Apply Master Brightness on Engine A and/or Engine B if necessary
-			if(lcd_stat.master_bright_a & 0xC000) { adjust_master_brightness(1); }
-			if(lcd_stat.master_bright_b & 0xC000) { adjust_master_brightness(0); }
+				//Apply Master Brightness on Engine A and/or Engine B if necessary
+				if(lcd_stat.master_bright_a & 0xC000) { adjust_master_brightness(1); }
+				if(lcd_stat.master_bright_b & 0xC000) { adjust_master_brightness(0); }
 
-			u32 render_position = (lcd_stat.current_scanline * config::sys_width);
+				u32 render_position = (lcd_stat.current_scanline * config::sys_width);
 
-			//Swap top and bottom if POWERCNT1 Bit 15 is not set, otherwise A is top, B is bottom
-			u16 disp_a_offset = (mem->power_cnt1 & 0x8000) ? 0 : 0xC000;
-			u16 disp_b_offset = (mem->power_cnt1 & 0x8000) ? 0xC000 : 0;
+				//Swap top and bottom if POWERCNT1 Bit 15 is not set, otherwise A is top, B is bottom
+				u16 disp_a_offset = (mem->power_cnt1 & 0x8000) ? 0 : 0xC000;
+				u16 disp_b_offset = (mem->power_cnt1 & 0x8000) ? 0xC000 : 0;
 
-			//Swap top and bottom if LCD configuration calls for it
-			if(config::lcd_config & 0x1)
-			{
-				disp_a_offset = (disp_a_offset) ? 0 : 0xC000;
-				disp_b_offset = (disp_b_offset) ? 0 : 0xC000;
-			}
+				//Swap top and bottom if LCD configuration calls for it
+				if(config::lcd_config & 0x1)
+				{
+					disp_a_offset = (disp_a_offset) ? 0 : 0xC000;
+					disp_b_offset = (disp_b_offset) ? 0 : 0xC000;
+				}
 
-			//Horizontal vs. Vertical mode
-			if(config::lcd_config & 0x2)
-			{
-				disp_a_offset = (disp_a_offset) ? 0x100 : 0;
-				disp_b_offset = (disp_b_offset) ? 0x100 : 0;
-			} 
+				//Horizontal vs. Vertical mode
+				if(config::lcd_config & 0x2)
+				{
+					disp_a_offset = (disp_a_offset) ? 0x100 : 0;
+					disp_b_offset = (disp_b_offset) ? 0x100 : 0;
+				} 
 			
-			//Push scanline pixel data to screen buffer
-			for(u16 x = 0; x < 256; x++)
-			{
-				screen_buffer[render_position + x + disp_a_offset] = scanline_buffer_a[x];
-				screen_buffer[render_position + x + disp_b_offset] = scanline_buffer_b[x];
+				//Push scanline pixel data to screen buffer
+				for(u16 x = 0; x < 256; x++)
+				{
+					screen_buffer[render_position + x + disp_a_offset] = scanline_buffer_a[x];
+					screen_buffer[render_position + x + disp_b_offset] = scanline_buffer_b[x];
+				}
 			}
 
 			//Start HBlank DMA
@@ -4270,8 +4136,8 @@ void NTR_LCD::step()
 				if(mem->g_pad->vc_pause < config::vc_timeout) { render_virtual_cursor(); }
 			}
 
-			//Use SDL
-			if(config::sdl_render)
+			//Use SDL - Nothing is blitted for skipped frames
+			if((config::sdl_render) && (!frame_skip.skip_frame))
 			{
 				//If using SDL and no OpenGL, manually stretch for fullscreen via SDL
 				if((config::flags & SDL_WINDOW_FULLSCREEN) && (!config::use_opengl))
@@ -4346,7 +4212,7 @@ void NTR_LCD::step()
 			}
 
 			//Use external rendering method (GUI)
-			else
+			else if((!config::sdl_render) && (!frame_skip.skip_frame))
 			{
 				if(!config::use_opengl) { config::render_external_sw(screen_buffer); }
 
@@ -4365,8 +4231,11 @@ void NTR_LCD::step()
 				}
 			}
 
-			//Limit framerate
-			if(!config::turbo)
+			//Decide whether the next frame gets drawn
+			frame_skip.update(SDL_GetTicks(), frame_start_time, frame_delay[fps_count % 60]);
+
+			//Limit framerate - Unpaced frames (run-ahead, rollback) run as fast as possible
+			if((!config::turbo) && (frame_skip.paced))
 			{
 				frame_current_time = SDL_GetTicks();
 				int delay = frame_delay[fps_count % 60];
@@ -4375,7 +4244,8 @@ void NTR_LCD::step()
 			}
 
 			//Update FPS counter + title
-			fps_count++;
+			if(!frame_skip.hidden) { fps_count++; }
+			frame_count++;
 			if(((SDL_GetTicks() - fps_time) >= 1000) && (config::sdl_render))
 			{ 
 				fps_time = SDL_GetTicks(); 
@@ -4385,8 +4255,8 @@ void NTR_LCD::step()
 				fps_count = 0; 
 			}
 
-			//Process Turbo Buttons
-			if(mem->g_pad->turbo_button_enabled) { mem->g_pad->process_turbo_buttons(); }
+			//Process Turbo Buttons - Once per shown frame
+			if((mem->g_pad->turbo_button_enabled) && (!frame_skip.hidden)) { mem->g_pad->process_turbo_buttons(); }
 
 			//Check for screen resize - Horizontal vs Vertical
 			if(config::request_resize)
@@ -4789,117 +4659,100 @@ void NTR_LCD::render_virtual_cursor()
 }
 
 /****** Read LCD data from save state ******/
-bool NTR_LCD::lcd_read(u32 offset, std::string filename)
+void NTR_LCD::lcd_read(state_reader& state)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
+	state.read(&lcd_stat, sizeof(lcd_stat));
+	state.read(&lcd_3D_stat, sizeof(lcd_3D_stat));
 
-	//Go to offset
-	file.seekg(offset);
-
-	file.read((char*)&lcd_stat, sizeof(lcd_stat));
-	file.read((char*)&lcd_3D_stat, sizeof(lcd_3D_stat));
-
-	file.read((char*)&obj, sizeof(obj));
-	file.read((char*)&capture_on, sizeof(capture_on));
+	state.read(&obj, sizeof(obj));
+	state.read(&capture_on, sizeof(capture_on));
 
 	//Serialize fixed sets of matrices
-	serialize_matrix(file, last_poly);
-	serialize_matrix(file, current_poly);
+	serialize_matrix(state, last_poly);
+	serialize_matrix(state, current_poly);
 
-	serialize_matrix(file, gx_projection_matrix);
-	serialize_matrix(file, gx_position_matrix);
-	serialize_matrix(file, gx_vector_matrix);
-	serialize_matrix(file, gx_texture_matrix);
+	serialize_matrix(state, gx_projection_matrix);
+	serialize_matrix(state, gx_position_matrix);
+	serialize_matrix(state, gx_vector_matrix);
+	serialize_matrix(state, gx_texture_matrix);
 
 	//Serialize multi sets of matrices
 	for(u32 x = 0; x < 4; x++)
 	{
-		serialize_matrix(file, last_pos_matrix[x]);
-		serialize_matrix(file, light_vector[x]);
-		serialize_matrix(file, current_normal[x]);
+		serialize_matrix(state, last_pos_matrix[x]);
+		serialize_matrix(state, light_vector[x]);
+		serialize_matrix(state, current_normal[x]);
 	}
 
 	for(u32 x = 0; x < 2; x++)
 	{
-		serialize_matrix(file, gx_projection_stack[x]);
-		serialize_matrix(file, gx_texture_stack[x]);
+		serialize_matrix(state, gx_projection_stack[x]);
+		serialize_matrix(state, gx_texture_stack[x]);
 	}
 
 	for(u32 x = 0; x < 32; x++)
 	{
-		serialize_matrix(file, gx_position_stack[x]);
-		serialize_matrix(file, gx_vector_stack[x]);
+		serialize_matrix(state, gx_position_stack[x]);
+		serialize_matrix(state, gx_vector_stack[x]);
 	}
 
-	file.read((char*)&position_sp, sizeof(position_sp));
-	file.read((char*)&vector_sp, sizeof(vector_sp));
-	file.read((char*)&projection_sp, sizeof(projection_sp));
-
-	file.read((char*)&light_colors, sizeof(light_colors));
-	file.read((char*)&material_colors, sizeof(material_colors));
-	file.read((char*)&shine_table, sizeof(shine_table));
+	state.read(&position_sp, sizeof(position_sp));
+	state.read(&vector_sp, sizeof(vector_sp));
+	state.read(&projection_sp, sizeof(projection_sp));
 
-	file.close();
-	return true;
+	state.read(&light_colors, sizeof(light_colors));
+	state.read(&material_colors, sizeof(material_colors));
+	state.read(&shine_table, sizeof(shine_table));
 }
 
 /****** Write LCD data to save state ******/
-bool NTR_LCD::lcd_write(std::string filename)
+void NTR_LCD::lcd_write(state_writer& state)
 {
 	gx_projection_stack.resize(2);
 	gx_position_stack.resize(32);
 	gx_vector_stack.resize(32);
 	gx_texture_stack.resize(2);
 
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
-
-	file.write((char*)&lcd_stat, sizeof(lcd_stat));
-	file.write((char*)&lcd_3D_stat, sizeof(lcd_3D_stat));
+	state.write(&lcd_stat, sizeof(lcd_stat));
+	state.write(&lcd_3D_stat, sizeof(lcd_3D_stat));
 
-	file.write((char*)&obj, sizeof(obj));
-	file.write((char*)&capture_on, sizeof(capture_on));
+	state.write(&obj, sizeof(obj));
+	state.write(&capture_on, sizeof(capture_on));
 
 	//Serialize fixed sets of matrices
-	serialize_matrix(file, last_poly);
-	serialize_matrix(file, current_poly);
+	serialize_matrix(state, last_poly);
+	serialize_matrix(state, current_poly);
 
-	serialize_matrix(file, gx_projection_matrix);
-	serialize_matrix(file, gx_position_matrix);
-	serialize_matrix(file, gx_vector_matrix);
-	serialize_matrix(file, gx_texture_matrix);
+	serialize_matrix(state, gx_projection_matrix);
+	serialize_matrix(state, gx_position_matrix);
+	serialize_matrix(state, gx_vector_matrix);
+	serialize_matrix(state, gx_texture_matrix);
 
 	//Serialize multi sets of matrices
 	for(u32 x = 0; x < 4; x++)
 	{
-		serialize_matrix(file, last_pos_matrix[x]);
-		serialize_matrix(file, light_vector[x]);
-		serialize_matrix(file, current_normal[x]);
+		serialize_matrix(state, last_pos_matrix[x]);
+		serialize_matrix(state, light_vector[x]);
+		serialize_matrix(state, current_normal[x]);
 	}
 
 	for(u32 x = 0; x < 2; x++)
 	{
-		serialize_matrix(file, gx_projection_stack[x]);
-		serialize_matrix(file, gx_texture_stack[x]);
+		serialize_matrix(state, gx_projection_stack[x]);
+		serialize_matrix(state, gx_texture_stack[x]);
 	}
 
 	for(u32 x = 0; x < 32; x++)
 	{
-		serialize_matrix(file, gx_position_stack[x]);
-		serialize_matrix(file, gx_vector_stack[x]);
+		serialize_matrix(state, gx_position_stack[x]);
+		serialize_matrix(state, gx_vector_stack[x]);
 	}
 
-	file.write((char*)&position_sp, sizeof(position_sp));
-	file.write((char*)&vector_sp, sizeof(vector_sp));
-	file.write((char*)&projection_sp, sizeof(projection_sp));
+	state.write(&position_sp, sizeof(position_sp));
+	state.write(&vector_sp, sizeof(vector_sp));
+	state.write(&projection_sp, sizeof(projection_sp));
 
-	file.write((char*)&light_colors, sizeof(light_colors));
-	file.write((char*)&material_colors, sizeof(material_colors));
-	file.write((char*)&shine_table, sizeof(shine_table));
-
-	file.close();
-	return true;
+	state.write(&light_colors, sizeof(light_colors));
+	state.write(&material_colors, sizeof(material_colors));
+	state.write(&shine_table, sizeof(shine_table));
 }
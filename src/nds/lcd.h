@@ -16,6 +16,8 @@
 #include "mmu.h"
 
 #include "common/gx_util.h"
+#include "common/sfx_kernels.h"
+#include "common/frame_skip.h"
 
 class NTR_LCD
 {
@@ -47,12 +49,18 @@ class NTR_LCD
 
 	int max_fullscreen_ratio;
 
+	//Frames completed since the last reset
+	u32 frame_count;
+
+	//Frame skipping, also hides frames while running ahead
+	frame_skipper frame_skip;
+
 	//Needs to be called by ARM9 when performing GXFIFO DMA, so not private
 	void process_gx_command();
 
 	//Serialize data for save state loading/saving
-	bool lcd_read(u32 offset, std::string filename);
-	bool lcd_write(std::string filename);
+	void lcd_read(state_reader& state);
+	void lcd_write(state_writer& state);
 
 	private:
 
@@ -134,6 +142,12 @@ class NTR_LCD
 	std::vector< std::vector<u32> > obj_line_buffer;
 	std::vector <u32> tex_data;
 
+	//SFX targets gathered for each pixel of the line, run through the SFX kernels together
+	u32 sfx_line_target_1[256];
+	u32 sfx_line_target_2[256];
+	u32 sfx_line_result[256];
+	bool sfx_line_enable[256];
+
 	//Display Capture
 	bool capture_on;
 	std::vector<u16> capture_buffer;
@@ -235,6 +249,7 @@ class NTR_LCD
 	void brightness_up(u32 bg_control);
 	void brightness_down(u32 bg_control);
 	void alpha_blend(u32 bg_control);
+	void copy_sfx_line(u32 bg_control);
 	void adjust_master_brightness(u8 engine_id);
 
 	//Window functions
@@ -390,6 +390,8 @@ void NTR_MMU::reset()
 	wram_mode = 3;
 	rumble_state = 0;
 	do_save = false;
+	write_count = 0;
+	timer_read = false;
 
 	//Small LUT for quickly getting DMAx register IDs.
 	//Each DMA register set is 12-bytes long, so this avoids using division frequently to get the ID
@@ -642,7 +644,11 @@ u8 NTR_MMU::read_u8(u32 address)
 		else if(!access_mode && timer_cnt) { return ((nds7_timer->at(timer_id).cnt >> addr_shift) & 0xFF); }
 
 		//NDS9 and NDS7 timer counter
-		else if(access_mode && !timer_cnt) { return ((nds9_timer->at(timer_id).counter >> addr_shift) & 0xFF); }
+		else if(access_mode && !timer_cnt)
+		{
+			timer_read = true;
+			return ((nds9_timer->at(timer_id).counter >> addr_shift) & 0xFF);
+		}
 		else { return ((nds7_timer->at(timer_id).counter >> addr_shift) & 0xFF); }
 	}
 
@@ -1160,6 +1166,35 @@ u32 NTR_MMU::read_u32_fast(u32 address) const
 	return ((memory_map[address+3] << 24) | (memory_map[address+2] << 16) | (memory_map[address+1] << 8) | memory_map[address]);
 }
 
+/****** Returns a host pointer to memory without side effects and how many bytes follow it contiguously ******/
+u8* NTR_MMU::get_host_span(u32 address, u32& length, bool write)
+{
+	length = 0;
+
+	//Debugging needs to see every access
+	#ifdef GBE_DEBUG
+	return NULL;
+	#endif
+
+	//Only Main RAM is plain memory for both CPUs
+	if((address >> 24) != 0x2) { return NULL; }
+
+	u32 offset = (address & 0x3FFFFF);
+	length = 0x400000 - offset;
+
+	//DTCM sits on top of Main RAM for the NDS9
+	if(access_mode)
+	{
+		if((address >= dtcm_addr) && (address <= dtcm_end)) { length = 0; return NULL; }
+		if((dtcm_addr > address) && ((dtcm_addr - address) < length)) { length = (dtcm_addr - address); }
+	}
+
+	return &memory_map[0x2000000 + offset];
+}
+
+/****** Handles bookkeeping after memory was written directly through a host pointer ******/
+void NTR_MMU::notify_host_write(u32 address, u32 length) { write_count++; }
+
 /****** Reads 2 bytes from cartridge memory - No checks done on the read ******/
 u16 NTR_MMU::read_cart_u16(u32 address) const
 {
@@ -1182,6 +1217,8 @@ void NTR_MMU::write_u8(u32 address, u8 value)
 	debug_addr[(address & 0x3) + (access_mode << 2)] = address;
 	#endif
 
+	write_count++;
+
 	//Check DTCM first
 	if((access_mode) && (address >= dtcm_addr) && (address <= dtcm_end))
 	{
@@ -5893,450 +5930,345 @@ void NTR_MMU::set_nds7_pc(u32* ex_pc) { nds7_pc = ex_pc; }
 void NTR_MMU::set_nds9_pc(u32* ex_pc) { nds9_pc = ex_pc; }
 
 /****** Read MMU data from save state ******/
-bool NTR_MMU::mmu_read(u32 offset, std::string filename)
+void NTR_MMU::mmu_read(state_reader& state)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
-
 	u32 temp_word = 0;
 	u32 temp_size = 0;
 
-	//Go to offset
-	file.seekg(offset);
-
 	//Serialize WRAM from save state
 	u8* ex_mem = &memory_map[0x2000000];
-	file.read((char*)ex_mem, 0x400000);
+	state.read(ex_mem, 0x400000);
 
 	//Serialize WRAM from save state
 	ex_mem = &memory_map[0x3000000];
-	file.read((char*)ex_mem, 0x8000);
+	state.read(ex_mem, 0x8000);
 
 	//Serialize WRAM from save state
 	ex_mem = &memory_map[0x3800000];
-	file.read((char*)ex_mem, 0x10000);
+	state.read(ex_mem, 0x10000);
 
 	//Serialize ARM9 IO registers from save state
 	ex_mem = &memory_map[0x4000000];
-	file.read((char*)ex_mem, 0x700);
+	state.read(ex_mem, 0x700);
 
 	ex_mem = &memory_map[0x4001000];
-	file.read((char*)ex_mem, 0x70);
+	state.read(ex_mem, 0x70);
 
 	ex_mem = &memory_map[0x4100000];
-	file.read((char*)ex_mem, 0x4);
+	state.read(ex_mem, 0x4);
 
 	ex_mem = &memory_map[0x4100010];
-	file.read((char*)ex_mem, 0x4);
+	state.read(ex_mem, 0x4);
 	
 	//Serialize palettes from save state
 	ex_mem = &memory_map[0x5000000];
-	file.read((char*)ex_mem, 0x800);
+	state.read(ex_mem, 0x800);
 
 	//Serialize VRAM from save state
 	ex_mem = &memory_map[0x6000000];
-	file.read((char*)ex_mem, 0x80000);
+	state.read(ex_mem, 0x80000);
 
 	ex_mem = &memory_map[0x6200000];
-	file.read((char*)ex_mem, 0x20000);
+	state.read(ex_mem, 0x20000);
 
 	ex_mem = &memory_map[0x6400000];
-	file.read((char*)ex_mem, 0x40000);
+	state.read(ex_mem, 0x40000);
 
 	ex_mem = &memory_map[0x6600000];
-	file.read((char*)ex_mem, 0x20000);
+	state.read(ex_mem, 0x20000);
 
 	ex_mem = &memory_map[0x6800000];
-	file.read((char*)ex_mem, 0xA4000);
+	state.read(ex_mem, 0xA4000);
 
 	//Serialize OAM from save state
 	ex_mem = &memory_map[0x7000000];
-	file.read((char*)ex_mem, 0x800);
+	state.read(ex_mem, 0x800);
 
 	//Serialize DTCM
 	ex_mem = &dtcm[0];
-	file.read((char*)ex_mem, 0x4000);
+	state.read(ex_mem, 0x4000);
 
 	//Serialize misc data from MMU from save state
-	file.read((char*)&current_save_type, sizeof(current_save_type));
-	file.read((char*)&gba_save_type, sizeof(gba_save_type));
-	file.read((char*)&current_slot1_device, sizeof(current_slot1_device));
-	file.read((char*)&current_slot2_device, sizeof(current_slot2_device));
+	state.read(&current_save_type, sizeof(current_save_type));
+	state.read(&gba_save_type, sizeof(gba_save_type));
+	state.read(&current_slot1_device, sizeof(current_slot1_device));
+	state.read(&current_slot2_device, sizeof(current_slot2_device));
 
 	//Serialize IPC from save state
-	file.read((char*)&nds7_ipc.sync, sizeof(nds7_ipc.sync));
-	file.read((char*)&nds7_ipc.cnt, sizeof(nds7_ipc.cnt));
-	file.read((char*)&nds7_ipc.fifo_latest, sizeof(nds7_ipc.fifo_latest));
-	file.read((char*)&nds7_ipc.fifo_incoming, sizeof(nds7_ipc.fifo_incoming));
+	state.read(&nds7_ipc.sync, sizeof(nds7_ipc.sync));
+	state.read(&nds7_ipc.cnt, sizeof(nds7_ipc.cnt));
+	state.read(&nds7_ipc.fifo_latest, sizeof(nds7_ipc.fifo_latest));
+	state.read(&nds7_ipc.fifo_incoming, sizeof(nds7_ipc.fifo_incoming));
 
-	file.read((char*)&temp_size, sizeof(temp_size));
+	state.read(&temp_size, sizeof(temp_size));
 	while(!nds7_ipc.fifo.empty()) { nds7_ipc.fifo.pop(); }
 
 	for(u32 x = 0; x < temp_size; x++)
 	{
-		file.read((char*)&temp_word, sizeof(temp_word));
+		state.read(&temp_word, sizeof(temp_word));
 		nds7_ipc.fifo.push(temp_word);
 	} 
 
-	file.read((char*)&nds9_ipc.sync, sizeof(nds9_ipc.sync));
-	file.read((char*)&nds9_ipc.cnt, sizeof(nds9_ipc.cnt));
-	file.read((char*)&nds9_ipc.fifo_latest, sizeof(nds9_ipc.fifo_latest));
-	file.read((char*)&nds9_ipc.fifo_incoming, sizeof(nds9_ipc.fifo_incoming));
+	state.read(&nds9_ipc.sync, sizeof(nds9_ipc.sync));
+	state.read(&nds9_ipc.cnt, sizeof(nds9_ipc.cnt));
+	state.read(&nds9_ipc.fifo_latest, sizeof(nds9_ipc.fifo_latest));
+	state.read(&nds9_ipc.fifo_incoming, sizeof(nds9_ipc.fifo_incoming));
 
-	file.read((char*)&temp_size, sizeof(temp_size));
+	state.read(&temp_size, sizeof(temp_size));
 	while(!nds9_ipc.fifo.empty()) { nds9_ipc.fifo.pop(); }
 
 	for(u32 x = 0; x < temp_size; x++)
 	{
-		file.read((char*)&temp_word, sizeof(temp_word));
+		state.read(&temp_word, sizeof(temp_word));
 		nds9_ipc.fifo.push(temp_word);
 	} 
 
 	//Serialize SPI, AUX_SPI, Game Card, RTC, NDS9 Math, and Touchscreen from save state
-	file.read((char*)&nds7_spi, sizeof(nds7_spi));
-	file.read((char*)&nds_aux_spi, sizeof(nds_aux_spi));
-	file.read((char*)&nds_card, sizeof(nds_card));
-	file.read((char*)&nds7_rtc, sizeof(nds7_rtc));
-	file.read((char*)&nds9_math, sizeof(nds9_math));
-	file.read((char*)&touchscreen, sizeof(touchscreen));
+	state.read(&nds7_spi, sizeof(nds7_spi));
+	state.read(&nds_aux_spi, sizeof(nds_aux_spi));
+	state.read(&nds_card, sizeof(nds_card));
+	state.read(&nds7_rtc, sizeof(nds7_rtc));
+	state.read(&nds9_math, sizeof(nds9_math));
+	state.read(&touchscreen, sizeof(touchscreen));
 
 	//Serialize GX data from save state
-	file.read((char*)&gx_fifo_entry, sizeof(gx_fifo_entry));
-	file.read((char*)&gx_fifo_param_length, sizeof(gx_fifo_param_length));
-	file.read((char*)&gx_fifo_mem, sizeof(gx_fifo_mem));
+	state.read(&gx_fifo_entry, sizeof(gx_fifo_entry));
+	state.read(&gx_fifo_param_length, sizeof(gx_fifo_param_length));
+	state.read(&gx_fifo_mem, sizeof(gx_fifo_mem));
 
-	file.read((char*)&temp_size, sizeof(temp_size));
+	state.read(&temp_size, sizeof(temp_size));
 	while(!nds9_gx_fifo.empty()) { nds9_gx_fifo.pop(); }
 
 	for(u32 x = 0; x < temp_size; x++)
 	{
-		file.read((char*)&temp_word, sizeof(temp_word));
+		state.read(&temp_word, sizeof(temp_word));
 		nds9_gx_fifo.push(temp_word);
 	} 
 
 	//Serialize more misc data from MMU from save state
-	file.read((char*)&n_clock, sizeof(n_clock));
-	file.read((char*)&s_clock, sizeof(s_clock));
-	file.read((char*)&nds9_bios_vector, sizeof(nds9_bios_vector));
-	file.read((char*)&nds9_irq_handler, sizeof(nds9_irq_handler));
-	file.read((char*)&nds7_bios_vector, sizeof(nds7_bios_vector));
-	file.read((char*)&nds7_irq_handler, sizeof(nds7_irq_handler));
-	file.read((char*)&access_mode, sizeof(access_mode));
-	file.read((char*)&wram_mode, sizeof(wram_mode));
-	file.read((char*)&rumble_state, sizeof(rumble_state));
-	file.read((char*)&do_save, sizeof(do_save));
-	file.read((char*)&fetch_request, sizeof(fetch_request));
-	file.read((char*)&gx_command, sizeof(gx_command));
+	state.read(&n_clock, sizeof(n_clock));
+	state.read(&s_clock, sizeof(s_clock));
+	state.read(&nds9_bios_vector, sizeof(nds9_bios_vector));
+	state.read(&nds9_irq_handler, sizeof(nds9_irq_handler));
+	state.read(&nds7_bios_vector, sizeof(nds7_bios_vector));
+	state.read(&nds7_irq_handler, sizeof(nds7_irq_handler));
+	state.read(&access_mode, sizeof(access_mode));
+	state.read(&wram_mode, sizeof(wram_mode));
+	state.read(&rumble_state, sizeof(rumble_state));
+	state.read(&do_save, sizeof(do_save));
+	state.read(&fetch_request, sizeof(fetch_request));
+	state.read(&gx_command, sizeof(gx_command));
 
 	//Serialize DMA and Sound Capture data from save state
-	file.read((char*)&dma, sizeof(dma));
-	file.read((char*)&sound_cap, sizeof(sound_cap));
+	state.read(&dma, sizeof(dma));
+	state.read(&sound_cap, sizeof(sound_cap));
 
 	//Serialize even more misc data from MMU from save state
-	file.read((char*)&nds9_ie, sizeof(nds9_ie));
-	file.read((char*)&nds9_if, sizeof(nds9_if));
-	file.read((char*)&gx_if, sizeof(gx_if));
-	file.read((char*)&nds9_temp_if, sizeof(nds9_temp_if));
-	file.read((char*)&nds9_ime, sizeof(nds9_ime));
-	file.read((char*)&power_cnt1, sizeof(power_cnt1));
-	file.read((char*)&nds9_exmem, sizeof(nds9_exmem));
-
-	file.read((char*)&nds7_ie, sizeof(nds7_ie));
-	file.read((char*)&nds7_if, sizeof(nds7_if));
-	file.read((char*)&nds7_temp_if, sizeof(nds7_temp_if));
-	file.read((char*)&nds7_ime, sizeof(nds7_ime));
-	file.read((char*)&power_cnt2, sizeof(power_cnt2));
-	file.read((char*)&nds7_exmem, sizeof(nds7_exmem));
-
-	file.read((char*)&firmware_status, sizeof(firmware_status));
-	file.read((char*)&firmware_state, sizeof(firmware_state));
-	file.read((char*)&firmware_count, sizeof(firmware_count));
-	file.read((char*)&firmware_index, sizeof(firmware_index));
-	file.read((char*)&in_firmware, sizeof(in_firmware));
-	file.read((char*)&touchscreen_state, sizeof(touchscreen_state));
-	file.read((char*)&apu_io_id, sizeof(apu_io_id));
-	file.read((char*)&dtcm_addr, sizeof(dtcm_addr));
-	file.read((char*)&dtcm_end, sizeof(dtcm_end));
-	file.read((char*)&dtcm_load_mode, sizeof(dtcm_load_mode));
-	file.read((char*)&itcm_addr, sizeof(itcm_addr));
-	file.read((char*)&itcm_load_mode, sizeof(itcm_load_mode));
-	file.read((char*)&pal_a_bg_slot, sizeof(pal_a_bg_slot));
-	file.read((char*)&pal_a_obj_slot, sizeof(pal_a_obj_slot));
-	file.read((char*)&pal_b_bg_slot, sizeof(pal_b_bg_slot));
-	file.read((char*)&pal_b_obj_slot, sizeof(pal_b_obj_slot));
-	file.read((char*)&vram_tex_slot, sizeof(vram_tex_slot));
-
-	file.close();
-	return true;
+	state.read(&nds9_ie, sizeof(nds9_ie));
+	state.read(&nds9_if, sizeof(nds9_if));
+	state.read(&gx_if, sizeof(gx_if));
+	state.read(&nds9_temp_if, sizeof(nds9_temp_if));
+	state.read(&nds9_ime, sizeof(nds9_ime));
+	state.read(&power_cnt1, sizeof(power_cnt1));
+	state.read(&nds9_exmem, sizeof(nds9_exmem));
+
+	state.read(&nds7_ie, sizeof(nds7_ie));
+	state.read(&nds7_if, sizeof(nds7_if));
+	state.read(&nds7_temp_if, sizeof(nds7_temp_if));
+	state.read(&nds7_ime, sizeof(nds7_ime));
+	state.read(&power_cnt2, sizeof(power_cnt2));
+	state.read(&nds7_exmem, sizeof(nds7_exmem));
+
+	state.read(&firmware_status, sizeof(firmware_status));
+	state.read(&firmware_state, sizeof(firmware_state));
+	state.read(&firmware_count, sizeof(firmware_count));
+	state.read(&firmware_index, sizeof(firmware_index));
+	state.read(&in_firmware, sizeof(in_firmware));
+	state.read(&touchscreen_state, sizeof(touchscreen_state));
+	state.read(&apu_io_id, sizeof(apu_io_id));
+	state.read(&dtcm_addr, sizeof(dtcm_addr));
+	state.read(&dtcm_end, sizeof(dtcm_end));
+	state.read(&dtcm_load_mode, sizeof(dtcm_load_mode));
+	state.read(&itcm_addr, sizeof(itcm_addr));
+	state.read(&itcm_load_mode, sizeof(itcm_load_mode));
+	state.read(&pal_a_bg_slot, sizeof(pal_a_bg_slot));
+	state.read(&pal_a_obj_slot, sizeof(pal_a_obj_slot));
+	state.read(&pal_b_bg_slot, sizeof(pal_b_bg_slot));
+	state.read(&pal_b_obj_slot, sizeof(pal_b_obj_slot));
+	state.read(&vram_tex_slot, sizeof(vram_tex_slot));
 }
 
 /****** Write MMU data to save state ******/
-bool NTR_MMU::mmu_write(std::string filename)
+void NTR_MMU::mmu_write(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
-
 	u32 temp_word = 0;
 
 	//Serialize WRAM to save state
 	u8* ex_mem = &memory_map[0x2000000];
-	file.write((char*)ex_mem, 0x400000);
+	state.write(ex_mem, 0x400000);
 
 	//Serialize WRAM to save state
 	ex_mem = &memory_map[0x3000000];
-	file.write((char*)ex_mem, 0x8000);
+	state.write(ex_mem, 0x8000);
 
 	//Serialize WRAM to save state
 	ex_mem = &memory_map[0x3800000];
-	file.write((char*)ex_mem, 0x10000);
+	state.write(ex_mem, 0x10000);
 
 	//Serialize ARM9 IO registers to save state
 	ex_mem = &memory_map[0x4000000];
-	file.write((char*)ex_mem, 0x700);
+	state.write(ex_mem, 0x700);
 
 	ex_mem = &memory_map[0x4001000];
-	file.write((char*)ex_mem, 0x70);
+	state.write(ex_mem, 0x70);
 
 	ex_mem = &memory_map[0x4100000];
-	file.write((char*)ex_mem, 0x4);
+	state.write(ex_mem, 0x4);
 
 	ex_mem = &memory_map[0x4100010];
-	file.write((char*)ex_mem, 0x4);
+	state.write(ex_mem, 0x4);
 	
 	//Serialize palettes to save state
 	ex_mem = &memory_map[0x5000000];
-	file.write((char*)ex_mem, 0x800);
+	state.write(ex_mem, 0x800);
 
 	//Serialize VRAM to save state
 	ex_mem = &memory_map[0x6000000];
-	file.write((char*)ex_mem, 0x80000);
+	state.write(ex_mem, 0x80000);
 
 	ex_mem = &memory_map[0x6200000];
-	file.write((char*)ex_mem, 0x20000);
+	state.write(ex_mem, 0x20000);
 
 	ex_mem = &memory_map[0x6400000];
-	file.write((char*)ex_mem, 0x40000);
+	state.write(ex_mem, 0x40000);
 
 	ex_mem = &memory_map[0x6600000];
-	file.write((char*)ex_mem, 0x20000);
+	state.write(ex_mem, 0x20000);
 
 	ex_mem = &memory_map[0x6800000];
-	file.write((char*)ex_mem, 0xA4000);
+	state.write(ex_mem, 0xA4000);
 
 	//Serialize OAM to save state
 	ex_mem = &memory_map[0x7000000];
-	file.write((char*)ex_mem, 0x800);
+	state.write(ex_mem, 0x800);
 
 	//Serialize DTCM
 	ex_mem = &dtcm[0];
-	file.write((char*)ex_mem, 0x4000);
+	state.write(ex_mem, 0x4000);
 
 	//Serialize misc data to MMU to save state
-	file.write((char*)&current_save_type, sizeof(current_save_type));
-	file.write((char*)&gba_save_type, sizeof(gba_save_type));
-	file.write((char*)&current_slot1_device, sizeof(current_slot1_device));
-	file.write((char*)&current_slot2_device, sizeof(current_slot2_device));
+	state.write(&current_save_type, sizeof(current_save_type));
+	state.write(&gba_save_type, sizeof(gba_save_type));
+	state.write(&current_slot1_device, sizeof(current_slot1_device));
+	state.write(&current_slot2_device, sizeof(current_slot2_device));
 
 	//Serialize IPC to save state
-	file.write((char*)&nds7_ipc.sync, sizeof(nds7_ipc.sync));
-	file.write((char*)&nds7_ipc.cnt, sizeof(nds7_ipc.cnt));
-	file.write((char*)&nds7_ipc.fifo_latest, sizeof(nds7_ipc.fifo_latest));
-	file.write((char*)&nds7_ipc.fifo_incoming, sizeof(nds7_ipc.fifo_incoming));
+	state.write(&nds7_ipc.sync, sizeof(nds7_ipc.sync));
+	state.write(&nds7_ipc.cnt, sizeof(nds7_ipc.cnt));
+	state.write(&nds7_ipc.fifo_latest, sizeof(nds7_ipc.fifo_latest));
+	state.write(&nds7_ipc.fifo_incoming, sizeof(nds7_ipc.fifo_incoming));
 
 	std::queue <u32> temp_q1(nds7_ipc.fifo);
 	temp_word = temp_q1.size();
-	file.write((char*)&temp_word, sizeof(temp_word));
+	state.write(&temp_word, sizeof(temp_word));
 
 	while(!temp_q1.empty())
 	{
 		temp_word = temp_q1.front();
-		file.write((char*)&temp_word, sizeof(temp_word));
+		state.write(&temp_word, sizeof(temp_word));
 		temp_q1.pop();
 	}
 
-	file.write((char*)&nds9_ipc.sync, sizeof(nds9_ipc.sync));
-	file.write((char*)&nds9_ipc.cnt, sizeof(nds9_ipc.cnt));
-	file.write((char*)&nds9_ipc.fifo_latest, sizeof(nds9_ipc.fifo_latest));
-	file.write((char*)&nds9_ipc.fifo_incoming, sizeof(nds9_ipc.fifo_incoming));
+	state.write(&nds9_ipc.sync, sizeof(nds9_ipc.sync));
+	state.write(&nds9_ipc.cnt, sizeof(nds9_ipc.cnt));
+	state.write(&nds9_ipc.fifo_latest, sizeof(nds9_ipc.fifo_latest));
+	state.write(&nds9_ipc.fifo_incoming, sizeof(nds9_ipc.fifo_incoming));
 
 	std::queue <u32> temp_q2(nds9_ipc.fifo);
 	temp_word = temp_q2.size();
-	file.write((char*)&temp_word, sizeof(temp_word));
+	state.write(&temp_word, sizeof(temp_word));
 
 	while(!temp_q2.empty())
 	{
 		temp_word = temp_q2.front();
-		file.write((char*)&temp_word, sizeof(temp_word));
+		state.write(&temp_word, sizeof(temp_word));
 		temp_q2.pop();
 	}
 
 	//Serialize SPI, AUX_SPI, Game Card, RTC, NDS9 Math, and Touchscreen to save state
-	file.write((char*)&nds7_spi, sizeof(nds7_spi));
-	file.write((char*)&nds_aux_spi, sizeof(nds_aux_spi));
-	file.write((char*)&nds_card, sizeof(nds_card));
-	file.write((char*)&nds7_rtc, sizeof(nds7_rtc));
-	file.write((char*)&nds9_math, sizeof(nds9_math));
-	file.write((char*)&touchscreen, sizeof(touchscreen));
+	state.write(&nds7_spi, sizeof(nds7_spi));
+	state.write(&nds_aux_spi, sizeof(nds_aux_spi));
+	state.write(&nds_card, sizeof(nds_card));
+	state.write(&nds7_rtc, sizeof(nds7_rtc));
+	state.write(&nds9_math, sizeof(nds9_math));
+	state.write(&touchscreen, sizeof(touchscreen));
 
 	//Serialize GX data to save state
-	file.write((char*)&gx_fifo_entry, sizeof(gx_fifo_entry));
-	file.write((char*)&gx_fifo_param_length, sizeof(gx_fifo_param_length));
-	file.write((char*)&gx_fifo_mem, sizeof(gx_fifo_mem));
+	state.write(&gx_fifo_entry, sizeof(gx_fifo_entry));
+	state.write(&gx_fifo_param_length, sizeof(gx_fifo_param_length));
+	state.write(&gx_fifo_mem, sizeof(gx_fifo_mem));
 
 	std::queue <u32> temp_q3(nds9_gx_fifo);
 	temp_word = temp_q3.size();
-	file.write((char*)&temp_word, sizeof(temp_word));
+	state.write(&temp_word, sizeof(temp_word));
 
 	while(!temp_q3.empty())
 	{
 		temp_word = temp_q3.front();
-		file.write((char*)&temp_word, sizeof(temp_word));
+		state.write(&temp_word, sizeof(temp_word));
 		temp_q3.pop();
 	}
 
 	//Serialize more misc data from MMU to save state
-	file.write((char*)&n_clock, sizeof(n_clock));
-	file.write((char*)&s_clock, sizeof(s_clock));
-	file.write((char*)&nds9_bios_vector, sizeof(nds9_bios_vector));
-	file.write((char*)&nds9_irq_handler, sizeof(nds9_irq_handler));
-	file.write((char*)&nds7_bios_vector, sizeof(nds7_bios_vector));
-	file.write((char*)&nds7_irq_handler, sizeof(nds7_irq_handler));
-	file.write((char*)&access_mode, sizeof(access_mode));
-	file.write((char*)&wram_mode, sizeof(wram_mode));
-	file.write((char*)&rumble_state, sizeof(rumble_state));
-	file.write((char*)&do_save, sizeof(do_save));
-	file.write((char*)&fetch_request, sizeof(fetch_request));
-	file.write((char*)&gx_command, sizeof(gx_command));
+	state.write(&n_clock, sizeof(n_clock));
+	state.write(&s_clock, sizeof(s_clock));
+	state.write(&nds9_bios_vector, sizeof(nds9_bios_vector));
+	state.write(&nds9_irq_handler, sizeof(nds9_irq_handler));
+	state.write(&nds7_bios_vector, sizeof(nds7_bios_vector));
+	state.write(&nds7_irq_handler, sizeof(nds7_irq_handler));
+	state.write(&access_mode, sizeof(access_mode));
+	state.write(&wram_mode, sizeof(wram_mode));
+	state.write(&rumble_state, sizeof(rumble_state));
+	state.write(&do_save, sizeof(do_save));
+	state.write(&fetch_request, sizeof(fetch_request));
+	state.write(&gx_command, sizeof(gx_command));
 
 	//Serialize DMA and Sound Capture data to save state
-	file.write((char*)&dma, sizeof(dma));
-	file.write((char*)&sound_cap, sizeof(sound_cap));
+	state.write(&dma, sizeof(dma));
+	state.write(&sound_cap, sizeof(sound_cap));
 
 	//Serialize even more misc data to MMU to save state
-	file.write((char*)&nds9_ie, sizeof(nds9_ie));
-	file.write((char*)&nds9_if, sizeof(nds9_if));
-	file.write((char*)&gx_if, sizeof(gx_if));
-	file.write((char*)&nds9_temp_if, sizeof(nds9_temp_if));
-	file.write((char*)&nds9_ime, sizeof(nds9_ime));
-	file.write((char*)&power_cnt1, sizeof(power_cnt1));
-	file.write((char*)&nds9_exmem, sizeof(nds9_exmem));
-
-	file.write((char*)&nds7_ie, sizeof(nds7_ie));
-	file.write((char*)&nds7_if, sizeof(nds7_if));
-	file.write((char*)&nds7_temp_if, sizeof(nds7_temp_if));
-	file.write((char*)&nds7_ime, sizeof(nds7_ime));
-	file.write((char*)&power_cnt2, sizeof(power_cnt2));
-	file.write((char*)&nds7_exmem, sizeof(nds7_exmem));
-
-	file.write((char*)&firmware_status, sizeof(firmware_status));
-	file.write((char*)&firmware_state, sizeof(firmware_state));
-	file.write((char*)&firmware_count, sizeof(firmware_count));
-	file.write((char*)&firmware_index, sizeof(firmware_index));
-	file.write((char*)&in_firmware, sizeof(in_firmware));
-	file.write((char*)&touchscreen_state, sizeof(touchscreen_state));
-	file.write((char*)&apu_io_id, sizeof(apu_io_id));
-	file.write((char*)&dtcm_addr, sizeof(dtcm_addr));
-	file.write((char*)&dtcm_end, sizeof(dtcm_end));
-	file.write((char*)&dtcm_load_mode, sizeof(dtcm_load_mode));
-	file.write((char*)&itcm_addr, sizeof(itcm_addr));
-	file.write((char*)&itcm_load_mode, sizeof(itcm_load_mode));
-	file.write((char*)&pal_a_bg_slot, sizeof(pal_a_bg_slot));
-	file.write((char*)&pal_a_obj_slot, sizeof(pal_a_obj_slot));
-	file.write((char*)&pal_b_bg_slot, sizeof(pal_b_bg_slot));
-	file.write((char*)&pal_b_obj_slot, sizeof(pal_b_obj_slot));
-	file.write((char*)&vram_tex_slot, sizeof(vram_tex_slot));
-
-	file.close();
-	return true;
+	state.write(&nds9_ie, sizeof(nds9_ie));
+	state.write(&nds9_if, sizeof(nds9_if));
+	state.write(&gx_if, sizeof(gx_if));
+	state.write(&nds9_temp_if, sizeof(nds9_temp_if));
+	state.write(&nds9_ime, sizeof(nds9_ime));
+	state.write(&power_cnt1, sizeof(power_cnt1));
+	state.write(&nds9_exmem, sizeof(nds9_exmem));
+
+	state.write(&nds7_ie, sizeof(nds7_ie));
+	state.write(&nds7_if, sizeof(nds7_if));
+	state.write(&nds7_temp_if, sizeof(nds7_temp_if));
+	state.write(&nds7_ime, sizeof(nds7_ime));
+	state.write(&power_cnt2, sizeof(power_cnt2));
+	state.write(&nds7_exmem, sizeof(nds7_exmem));
+
+	state.write(&firmware_status, sizeof(firmware_status));
+	state.write(&firmware_state, sizeof(firmware_state));
+	state.write(&firmware_count, sizeof(firmware_count));
+	state.write(&firmware_index, sizeof(firmware_index));
+	state.write(&in_firmware, sizeof(in_firmware));
+	state.write(&touchscreen_state, sizeof(touchscreen_state));
+	state.write(&apu_io_id, sizeof(apu_io_id));
+	state.write(&dtcm_addr, sizeof(dtcm_addr));
+	state.write(&dtcm_end, sizeof(dtcm_end));
+	state.write(&dtcm_load_mode, sizeof(dtcm_load_mode));
+	state.write(&itcm_addr, sizeof(itcm_addr));
+	state.write(&itcm_load_mode, sizeof(itcm_load_mode));
+	state.write(&pal_a_bg_slot, sizeof(pal_a_bg_slot));
+	state.write(&pal_a_obj_slot, sizeof(pal_a_obj_slot));
+	state.write(&pal_b_bg_slot, sizeof(pal_b_bg_slot));
+	state.write(&pal_b_obj_slot, sizeof(pal_b_obj_slot));
+	state.write(&vram_tex_slot, sizeof(vram_tex_slot));
 }
 
-/****** Gets the size of MMU data for serialization ******/
-u32 NTR_MMU::size()
-{
-	u32 mmu_size = 0x5C1778;
-
-	mmu_size += sizeof(current_save_type);
-	mmu_size += sizeof(gba_save_type);
-	mmu_size += sizeof(current_slot1_device);
-	mmu_size += sizeof(current_slot2_device);
-
-	mmu_size += sizeof(nds7_ipc.sync);
-	mmu_size += sizeof(nds7_ipc.cnt);
-	mmu_size += sizeof(nds7_ipc.fifo_latest);
-	mmu_size += sizeof(nds7_ipc.fifo_incoming);
-
-	mmu_size += (4 + (nds7_ipc.fifo.size() * 4));
-
-	mmu_size += sizeof(nds9_ipc.sync);
-	mmu_size += sizeof(nds9_ipc.cnt);
-	mmu_size += sizeof(nds9_ipc.fifo_latest);
-	mmu_size += sizeof(nds9_ipc.fifo_incoming);
-
-	mmu_size += (4 + (nds9_ipc.fifo.size() * 4));
-
-	mmu_size += sizeof(nds7_spi);
-	mmu_size += sizeof(nds_aux_spi);
-	mmu_size += sizeof(nds_card);
-	mmu_size += sizeof(nds7_rtc);
-	mmu_size += sizeof(nds9_math);
-	mmu_size += sizeof(touchscreen);
-
-	mmu_size += sizeof(gx_fifo_entry);
-	mmu_size += sizeof(gx_fifo_param_length);
-	mmu_size += sizeof(gx_fifo_mem);
-
-	mmu_size += (4 + (nds9_gx_fifo.size() * 4));
-
-	mmu_size += sizeof(n_clock);
-	mmu_size += sizeof(s_clock);
-	mmu_size += sizeof(nds9_bios_vector);
-	mmu_size += sizeof(nds9_irq_handler);
-	mmu_size += sizeof(nds7_bios_vector);
-	mmu_size += sizeof(nds7_irq_handler);
-	mmu_size += sizeof(access_mode);
-	mmu_size += sizeof(wram_mode);
-	mmu_size += sizeof(rumble_state);
-	mmu_size += sizeof(do_save);
-	mmu_size += sizeof(fetch_request);
-	mmu_size += sizeof(gx_command);
-
-	mmu_size += sizeof(dma);
-	mmu_size += sizeof(sound_cap);
-
-	mmu_size += sizeof(nds9_ie);
-	mmu_size += sizeof(nds9_if);
-	mmu_size += sizeof(gx_if);
-	mmu_size += sizeof(nds9_temp_if);
-	mmu_size += sizeof(nds9_ime);
-	mmu_size += sizeof(power_cnt1);
-	mmu_size += sizeof(nds9_exmem);
-
-	mmu_size += sizeof(nds7_ie);
-	mmu_size += sizeof(nds7_if);
-	mmu_size += sizeof(nds7_temp_if);
-	mmu_size += sizeof(nds7_ime);
-	mmu_size += sizeof(power_cnt2);
-	mmu_size += sizeof(nds7_exmem);
-
-	mmu_size += sizeof(firmware_status);
-	mmu_size += sizeof(firmware_state);
-	mmu_size += sizeof(firmware_count);
-	mmu_size += sizeof(firmware_index);
-	mmu_size += sizeof(in_firmware);
-	mmu_size += sizeof(touchscreen_state);
-	mmu_size += sizeof(apu_io_id);
-	mmu_size += sizeof(dtcm_addr);
-	mmu_size += sizeof(dtcm_end);
-	mmu_size += sizeof(dtcm_load_mode);
-	mmu_size += sizeof(itcm_addr);
-	mmu_size += sizeof(itcm_load_mode);
-	mmu_size += sizeof(pal_a_bg_slot);
-	mmu_size += sizeof(pal_a_obj_slot);
-	mmu_size += sizeof(pal_b_bg_slot);
-	mmu_size += sizeof(pal_b_obj_slot);
-	mmu_size += sizeof(vram_tex_slot);
-
-	return mmu_size;
-}
@@ -21,6 +21,7 @@
 #include "gamepad.h"
 #include "timer.h"
 #include "common/config.h"
+#include "common/save_state.h"
 #include "lcd_data.h"
 #include "apu_data.h"
 
@@ -339,6 +340,10 @@ class NTR_MMU
 	bool fetch_request;
 	bool gx_command;
 
+	//Used by the NDS9 to detect idle loops
+	u32 write_count;
+	bool timer_read;
+
 	//Structure for handling DS cart headers
 	struct cart_header
 	{
@@ -482,6 +487,9 @@ class NTR_MMU
 	void write_u32_fast(u32 address, u32 value);
 	void write_u64_fast(u32 address, u64 value);
 
+	u8* get_host_span(u32 address, u32& length, bool write);
+	void notify_host_write(u32 address, u32 length);
+
 	u16 read_cart_u16(u32 address) const;
 	u32 read_cart_u32(u32 address) const;
 
@@ -555,9 +563,8 @@ class NTR_MMU
 	std::vector<nds_timer>* nds9_timer;
 
 	//Serialize data for save state loading/saving
-	bool mmu_read(u32 offset, std::string filename);
-	bool mmu_write(std::string filename);
-	u32 size();
+	void mmu_read(state_reader& state);
+	void mmu_write(state_writer& state);
 
 	private:
 
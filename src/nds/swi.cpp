@@ -12,6 +12,7 @@
 
 #include "arm9.h"
 #include "arm7.h"
+#include "common/hle_decompress.h"
 
 /****** Process Software Interrupts - NDS9 ******/
 void NTR_ARM9::process_swi(u32 comment)
@@ -500,14 +501,15 @@ void NTR_ARM9::swi_bitunpack()
 		return;
 	}
 
-	u8 bit_mask = 0;
-
+	//Only 1, 2, 4, and 8-bit source widths are valid
 	switch(src_width)
 	{
-		case 1: bit_mask = 0x1; break;
-		case 2: bit_mask = 0x3; break;
-		case 4: bit_mask = 0xF; break;
-		case 8: bit_mask = 0xFF; break;
+		case 1:
+		case 2:
+		case 4:
+		case 8:
+			break;
+
 		default: std::cout<<"ARM9::SWI::ERROR - Invalid source width\n"; return;
 	}
 
@@ -516,160 +518,22 @@ void NTR_ARM9::swi_bitunpack()
 	u8 zero_flag = (data_offset & 0x80000000) ? 1 : 0;
 	data_offset &= ~0x80000000;
 
-	u8 src_byte = 0;
-	u8 src_count = 0;
-	u32 result = 0;
-
 	//Decompress bytes from source addr
-	while(length > 0)
-	{
-		result = 0;
-
-		//Cycle through the byte and expand to destination width
-		for(u8 x = 0; x < 32; x += dest_width)
-		{
-			//Grab new source byte
-			if((src_count % 8) == 0) 
-			{
-				src_byte = mem->read_u8(src_addr++);
-				length--;
-			}
-
-			//Grab the slice
-			u32 slice = (src_byte & bit_mask);
-			src_byte >>= src_width;
-			src_count += src_width;
-
-			if(slice != 0) { slice += data_offset; }
-			else if ((slice == 0) && (zero_flag == 1)) { slice += data_offset; }
-
-			//OR the slice to the final result
-			result |= (slice << x);
-		}
-
-		//Write result to the destination address
-		mem->write_u32(dest_addr, result);
-		dest_addr += 4;
-	}
+	hle_bit_unpack(mem, src_addr, dest_addr, length, src_width, dest_width, data_offset, zero_flag);
 }	
 
 /****** HLE implementation of LZ77UnCompReadByCallback - NDS9 ******/
 void NTR_ARM9::swi_lz77uncompvram()
 {
-	//Grab source address - R0
-	u32 src_addr = get_reg(0);
-
-	//Grab destination address - R1
-	u32 dest_addr = get_reg(1);
-
-	//Grab data header
-	u32 data_header = mem->read_u32(src_addr);
-
-	//Grab compressed data size in bytes
-	u32 data_size = (data_header >> 8);
-
-	//Pointer to current address of compressed data that needs to be processed
-	//When uncompression starts, move 5 bytes from source address (header + flag)
-	u32 data_ptr = (src_addr + 4);
-
-	u8 temp = 0;
-
-	//Uncompress data
-	while(data_size > 0)
-	{
-		//Grab flag data
-		u8 flag_data = mem->read_u8(data_ptr++);
-
-		//Process 8 blocks
-		for(int x = 7; x >= 0; x--)
-		{
-			u8 block_type = (flag_data & (1 << x)) ? 1 : 0;
-
-			//Block Type 0 - Uncompressed
-			if(block_type == 0)
-			{
-				temp = mem->read_u8(data_ptr++);
-				mem->write_u8(dest_addr++, temp);
-				
-				data_size--;
-				if(data_size == 0) { return; }
-			}
-
-
-			//Block Type 1 - Compressed
-			else
-			{
-				u16 compressed_block = mem->read_u16(data_ptr);
-				data_ptr += 2;
-
-				u16 distance = ((compressed_block & 0xF) << 8);
-				distance |= (compressed_block >> 8);
-
-				u8 length = ((compressed_block >> 4) & 0xF) + 3;
-
-				//Copy length+3 Bytes from dest_addr-length-1 to dest_addr
-				for(int y = 0; y < length; y++)
-				{
-					temp = mem->read_u8(dest_addr - distance - 1);
-					mem->write_u8(dest_addr, temp);
-					
-					dest_addr++;
-					data_size--;
-					if(data_size == 0) { return; }
-				}
-			}
-		}
-	}
+	//Source address - R0, destination address - R1
+	hle_lz77_uncomp(mem, get_reg(0), get_reg(1));
 }
 
 /****** HLE implementation of RLUnCompVram - NDS9 ******/
 void NTR_ARM9::swi_rluncompvram()
 {
-	//Grab source address - R0
-	u32 src_addr = get_reg(0);
-
-	//Grab destination address - R1
-	u32 dest_addr = get_reg(1);
-
-	//Grab data header
-	u32 data_header = mem->read_u32(src_addr);
-
-	u32 data_size = (data_header >> 8);
-
-	//Data pointer to compressed data. Points to first flag.
-	u32 data_ptr = (src_addr + 4);
-
-	//Uncompress data
-	while(data_size > 0)
-	{
-		u8 flag = mem->read_u8(data_ptr++);
-
-		u8 data_length = (flag & 0x7F);
-
-		//Adjust data length, +1 for uncompressed data, +3 for compressed data
-		if(flag & 0x80) { data_length += 3; }
-		else { data_length += 1; }
-
-		//Output the specified byte the amount of times in data_length
-		for(int x = 0; x < data_length; x++)
-		{
-			u8 data_byte = 0;
-
-			//Compressed
-			if(flag & 0x80) { data_byte = mem->read_u8(data_ptr); }
-
-			//Uncompressed
-			else { data_byte = mem->read_u8(data_ptr++); }
-				
-			mem->write_u8(dest_addr++, data_byte);
-			data_size--;
-
-			if(data_size == 0) { return; }
-		}
-
-		//Manually adjust data pointer for compressed data to point to next flag
-		if(flag & 0x80) { data_ptr++; }
-	}
+	//Source address - R0, destination address - R1
+	hle_rl_uncomp(mem, get_reg(0), get_reg(1));
 }
 
 /****** HLE implementation of CustomPost - NDS9 ******/
@@ -1197,14 +1061,15 @@ void NTR_ARM7::swi_bitunpack()
 		return;
 	}
 
-	u8 bit_mask = 0;
-
+	//Only 1, 2, 4, and 8-bit source widths are valid
 	switch(src_width)
 	{
-		case 1: bit_mask = 0x1; break;
-		case 2: bit_mask = 0x3; break;
-		case 4: bit_mask = 0xF; break;
-		case 8: bit_mask = 0xFF; break;
+		case 1:
+		case 2:
+		case 4:
+		case 8:
+			break;
+
 		default: std::cout<<"ARM7::SWI::ERROR - Invalid source width\n"; return;
 	}
 
@@ -1213,160 +1078,22 @@ void NTR_ARM7::swi_bitunpack()
 	u8 zero_flag = (data_offset & 0x80000000) ? 1 : 0;
 	data_offset &= ~0x80000000;
 
-	u8 src_byte = 0;
-	u8 src_count = 0;
-	u32 result = 0;
-
 	//Decompress bytes from source addr
-	while(length > 0)
-	{
-		result = 0;
-
-		//Cycle through the byte and expand to destination width
-		for(u8 x = 0; x < 32; x += dest_width)
-		{
-			//Grab new source byte
-			if((src_count % 8) == 0) 
-			{
-				src_byte = mem->read_u8(src_addr++);
-				length--;
-			}
-
-			//Grab the slice
-			u32 slice = (src_byte & bit_mask);
-			src_byte >>= src_width;
-			src_count += src_width;
-
-			if(slice != 0) { slice += data_offset; }
-			else if ((slice == 0) && (zero_flag == 1)) { slice += data_offset; }
-
-			//OR the slice to the final result
-			result |= (slice << x);
-		}
-
-		//Write result to the destination address
-		mem->write_u32(dest_addr, result);
-		dest_addr += 4;
-	}
+	hle_bit_unpack(mem, src_addr, dest_addr, length, src_width, dest_width, data_offset, zero_flag);
 }	
 
 /****** HLE implementation of LZ77UnCompReadByCallback - NDS7 ******/
 void NTR_ARM7::swi_lz77uncompvram()
 {
-	//Grab source address - R0
-	u32 src_addr = get_reg(0);
-
-	//Grab destination address - R1
-	u32 dest_addr = get_reg(1);
-
-	//Grab data header
-	u32 data_header = mem->read_u32(src_addr);
-
-	//Grab compressed data size in bytes
-	u32 data_size = (data_header >> 8);
-
-	//Pointer to current address of compressed data that needs to be processed
-	//When uncompression starts, move 5 bytes from source address (header + flag)
-	u32 data_ptr = (src_addr + 4);
-
-	u8 temp = 0;
-
-	//Uncompress data
-	while(data_size > 0)
-	{
-		//Grab flag data
-		u8 flag_data = mem->read_u8(data_ptr++);
-
-		//Process 8 blocks
-		for(int x = 7; x >= 0; x--)
-		{
-			u8 block_type = (flag_data & (1 << x)) ? 1 : 0;
-
-			//Block Type 0 - Uncompressed
-			if(block_type == 0)
-			{
-				temp = mem->read_u8(data_ptr++);
-				mem->write_u8(dest_addr++, temp);
-				
-				data_size--;
-				if(data_size == 0) { return; }
-			}
-
-
-			//Block Type 1 - Compressed
-			else
-			{
-				u16 compressed_block = mem->read_u16(data_ptr);
-				data_ptr += 2;
-
-				u16 distance = ((compressed_block & 0xF) << 8);
-				distance |= (compressed_block >> 8);
-
-				u8 length = ((compressed_block >> 4) & 0xF) + 3;
-
-				//Copy length+3 Bytes from dest_addr-length-1 to dest_addr
-				for(int y = 0; y < length; y++)
-				{
-					temp = mem->read_u8(dest_addr - distance - 1);
-					mem->write_u8(dest_addr, temp);
-					
-					dest_addr++;
-					data_size--;
-					if(data_size == 0) { return; }
-				}
-			}
-		}
-	}
+	//Source address - R0, destination address - R1
+	hle_lz77_uncomp(mem, get_reg(0), get_reg(1));
 }
 
 /****** HLE implementation of RLUnCompVram - NDS7 ******/
 void NTR_ARM7::swi_rluncompvram()
 {
-	//Grab source address - R0
-	u32 src_addr = get_reg(0);
-
-	//Grab destination address - R1
-	u32 dest_addr = get_reg(1);
-
-	//Grab data header
-	u32 data_header = mem->read_u32(src_addr);
-
-	u32 data_size = (data_header >> 8);
-
-	//Data pointer to compressed data. Points to first flag.
-	u32 data_ptr = (src_addr + 4);
-
-	//Uncompress data
-	while(data_size > 0)
-	{
-		u8 flag = mem->read_u8(data_ptr++);
-
-		u8 data_length = (flag & 0x7F);
-
-		//Adjust data length, +1 for uncompressed data, +3 for compressed data
-		if(flag & 0x80) { data_length += 3; }
-		else { data_length += 1; }
-
-		//Output the specified byte the amount of times in data_length
-		for(int x = 0; x < data_length; x++)
-		{
-			u8 data_byte = 0;
-
-			//Compressed
-			if(flag & 0x80) { data_byte = mem->read_u8(data_ptr); }
-
-			//Uncompressed
-			else { data_byte = mem->read_u8(data_ptr++); }
-				
-			mem->write_u8(dest_addr++, data_byte);
-			data_size--;
-
-			if(data_size == 0) { return; }
-		}
-
-		//Manually adjust data pointer for compressed data to point to next flag
-		if(flag & 0x80) { data_ptr++; }
-	}
+	//Source address - R0, destination address - R1
+	hle_rl_uncomp(mem, get_reg(0), get_reg(1));
 }	
 
 /****** HLE implementation of GetSineTable - NDS7 ******/
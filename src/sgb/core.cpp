@@ -151,33 +151,21 @@ void SGB_core::load_state(u8 slot)
 		state_file = config::rom_file + ".ss" + id;
 	}
 
-	u32 offset = 0;
+	std::vector<u8> state_data;
 
 	//Check if save state is accessible
-	std::ifstream test(state_file.c_str());
-	
-	if(!test.good())
+	if(!read_state_file(state_file, state_data))
 	{
 		config::osd_message = "INVALID SAVE STATE " + util::to_str(slot);
 		config::osd_count = 180;
 		return;
 	}
 
-	if(!get_save_state_info(offset, state_file)) { return; }
-	offset += sizeof(SGB_SAVE_STATE_VERSION);
-	offset += sizeof(config::gb_type);
-	offset += 32;
-
-	if(!core_cpu.cpu_read(offset, state_file)) { return; }
-	offset += core_cpu.size();	
-
-	if(!core_mmu.mmu_read(offset, state_file)) { return; }
-	offset += core_mmu.size();
-
-	if(!core_cpu.controllers.audio.apu_read(offset, state_file)) { return; }
-	offset += core_cpu.controllers.audio.size();
-
-	if(!core_cpu.controllers.video.lcd_read(offset, state_file)) { return; }
+	if(!deserialize_state(&state_data[0], state_data.size()))
+	{
+		std::cout<<"GBE::Error - Could not load save state " << state_file << "\n";
+		return;
+	}
 
 	std::cout<<"GBE::Loaded state " << state_file << "\n";
 
@@ -204,11 +192,11 @@ void SGB_core::save_state(u8 slot)
 		state_file = config::rom_file + ".ss" + id;
 	}
 
-	if(!set_save_state_info(state_file)) { return; }
-	if(!core_cpu.cpu_write(state_file)) { return; }
-	if(!core_mmu.mmu_write(state_file)) { return; }
-	if(!core_cpu.controllers.audio.apu_write(state_file)) { return; }
-	if(!core_cpu.controllers.video.lcd_write(state_file)) { return; }
+	//Serialize the whole state in memory, then write it out at once
+	std::vector<u8> state_data(get_state_size());
+
+	if(!serialize_state(&state_data[0], state_data.size())) { return; }
+	if(!write_state_file(state_file, state_data)) { return; }
 
 	std::cout<<"GBE::Saved state " << state_file << "\n";
 
@@ -217,31 +205,103 @@ void SGB_core::save_state(u8 slot)
 	config::osd_count = 180;
 }
 
+/****** Gets the number of bytes needed to serialize the core ******/
+u32 SGB_core::get_state_size() { return serialize_state(NULL, 0); }
+
+/****** Serializes the core into a buffer - Returns the bytes written, or 0 if the buffer is too small ******/
+u32 SGB_core::serialize_state(u8* buffer, u32 length)
+{
+	state_writer state(buffer, length);
+
+	set_save_state_info(state);
+
+	state.begin_chunk(STATE_CHUNK_CPU, SGB_SAVE_STATE_VERSION);
+	core_cpu.cpu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_MMU, SGB_SAVE_STATE_VERSION);
+	core_mmu.mmu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_APU, SGB_SAVE_STATE_VERSION);
+	core_cpu.controllers.audio.apu_write(state);
+	state.end_chunk();
+
+	state.begin_chunk(STATE_CHUNK_LCD, SGB_SAVE_STATE_VERSION);
+	core_cpu.controllers.video.lcd_write(state);
+	state.end_chunk();
+
+	return (state.good()) ? state.size() : 0;
+}
+
+/****** Restores the core from a buffer filled by serialize_state() - The core is left untouched if the buffer is rejected ******/
+bool SGB_core::deserialize_state(const u8* buffer, u32 length)
+{
+	state_reader state(buffer, length);
+
+	if(!get_save_state_info(state)) { return false; }
+
+	//Make sure every chunk is present before changing anything
+	if(!state.has_chunk(STATE_CHUNK_CPU, SGB_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_MMU, SGB_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_APU, SGB_SAVE_STATE_VERSION)) { return false; }
+	if(!state.has_chunk(STATE_CHUNK_LCD, SGB_SAVE_STATE_VERSION)) { return false; }
+
+	return restore_state(buffer, length, [this](u8* data, u32 size) { return serialize_state(data, size); }, [this](const u8* data, u32 size) { return read_state_chunks(data, size); });
+}
+
+/****** Reads every chunk of a state into the core - Only use directly on buffers this core serialized itself ******/
+bool SGB_core::read_state_chunks(const u8* buffer, u32 length)
+{
+	state_reader state(buffer, length);
+
+	if(!get_save_state_info(state)) { return false; }
+
+	state.open_chunk(STATE_CHUNK_CPU, SGB_SAVE_STATE_VERSION);
+	core_cpu.cpu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_MMU, SGB_SAVE_STATE_VERSION);
+	core_mmu.mmu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_APU, SGB_SAVE_STATE_VERSION);
+	core_cpu.controllers.audio.apu_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	state.open_chunk(STATE_CHUNK_LCD, SGB_SAVE_STATE_VERSION);
+	core_cpu.controllers.video.lcd_read(state);
+	if(!state.close_chunk()) { return false; }
+
+	return true;
+}
+
 /****** Gets the save state info (Version + System Type) ******/
-bool SGB_core::get_save_state_info(u32 offset, std::string filename)
+bool SGB_core::get_save_state_info(state_reader& state)
 {
 	u32 version = 0;
 	u8 system_type = 0;
 	u8 state_date[32];
 
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	if(!file.is_open()) { return false; }
+	state.read(&version, sizeof(version));
+	state.read(&system_type, sizeof(system_type));
+	state.read(&state_date[0], 32);
 
-	file.seekg(offset);
-	file.read((char*)&version, sizeof(version));
-	file.read((char*)&system_type, sizeof(system_type));
-	file.read((char*)&state_date[0], 32);
-	file.close();
+	if(!state.good())
+	{
+		std::cout<<"GBE::Error - Save State is too small. Cannot load save.\n";
+		return false;
+	}
 
-	if((system_type != SYS_SGB) && (system_type != SYS_SGB2))
+	if(system_type != config::gb_type)
 	{
-		std::cout<<"GBE::Error - Save State " <<  filename << " has incorrect system type. Cannot load save.\n";
+		std::cout<<"GBE::Error - Save State has incorrect system type. Cannot load save.\n";
 		return false;
 	}
 
 	if(version != SGB_SAVE_STATE_VERSION)
 	{
-		std::cout<<"GBE::Error - Save State " <<  filename << " has outdated version number. Cannot load save.\n";
+		std::cout<<"GBE::Error - Save State has outdated version number. Cannot load save.\n";
 		return false;
 	}
 
@@ -249,11 +309,8 @@ bool SGB_core::get_save_state_info(u32 offset, std::string filename)
 }
 
 /****** Sets the save state info (Version + System Type) ******/
-bool SGB_core::set_save_state_info(std::string filename)
+void SGB_core::set_save_state_info(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
-	if(!file.is_open()) { return false; }
-
 	//Add current date metadata - Fixed size of 32 bytes
 	u8 state_date[32];
 	std::string date = util::get_long_date(true);
@@ -268,12 +325,9 @@ bool SGB_core::set_save_state_info(std::string filename)
 		}
 	}
 
-	file.write((char*)&SGB_SAVE_STATE_VERSION, sizeof(SGB_SAVE_STATE_VERSION));
-	file.write((char*)&core_mmu.original_sys_type, sizeof(core_mmu.original_sys_type));
-	file.write((char*)&state_date[0], 32);
-	file.close();
-
-	return true;
+	state.write(&SGB_SAVE_STATE_VERSION, sizeof(SGB_SAVE_STATE_VERSION));
+	state.write(&config::gb_type, sizeof(config::gb_type));
+	state.write(&state_date[0], 32);
 }
 
 /****** Run the core in a loop until exit ******/
@@ -267,38 +267,31 @@ bool SGB_LCD::init()
 }
 
 /****** Read LCD data from save state ******/
-bool SGB_LCD::lcd_read(u32 offset, std::string filename)
+void SGB_LCD::lcd_read(state_reader& state)
 {
-	std::ifstream file(filename.c_str(), std::ios::binary);
-	
-	if(!file.is_open()) { return false; }
+	//Serialize LCD data from save state
+	state.read(&lcd_stat, sizeof(lcd_stat));
 
-	//Go to offset
-	file.seekg(offset);
-
-	//Serialize LCD data from file stream
-	file.read((char*)&lcd_stat, sizeof(lcd_stat));
-
-	//Serialize OBJ data from file stream
+	//Serialize OBJ data from save state
 	for(int x = 0; x < 40; x++)
 	{
-		file.read((char*)&obj[x], sizeof(obj[x]));
+		state.read(&obj[x], sizeof(obj[x]));
 	}
 
-	file.read((char*)&sgb_mask_mode, sizeof(sgb_mask_mode));
-	file.read((char*)&sgb_gfx_mode, sizeof(sgb_gfx_mode));
-	file.read((char*)&sgb_pal, sizeof(sgb_pal));
-	file.read((char*)&atf_data, sizeof(atf_data));
-	file.read((char*)&sgb_system_pal, sizeof(sgb_system_pal));
-	file.read((char*)&current_atf, sizeof(current_atf));
-	file.read((char*)&color_0, sizeof(color_0));
-	file.read((char*)&manual_pal, sizeof(manual_pal));
-	file.read((char*)&render_border, sizeof(render_border));
-
-	file.read((char*)border_tile_map, sizeof(border_tile_map));
-	file.read((char*)border_pal, sizeof(border_pal));
-	file.read((char*)border_chr, sizeof(border_chr));
-	file.read((char*)atr_blk, sizeof(atr_blk));
+	state.read(&sgb_mask_mode, sizeof(sgb_mask_mode));
+	state.read(&sgb_gfx_mode, sizeof(sgb_gfx_mode));
+	state.read(&sgb_pal, sizeof(sgb_pal));
+	state.read(&atf_data, sizeof(atf_data));
+	state.read(&sgb_system_pal, sizeof(sgb_system_pal));
+	state.read(&current_atf, sizeof(current_atf));
+	state.read(&color_0, sizeof(color_0));
+	state.read(&manual_pal, sizeof(manual_pal));
+	state.read(&render_border, sizeof(render_border));
+
+	state.read(border_tile_map, sizeof(border_tile_map));
+	state.read(border_pal, sizeof(border_pal));
+	state.read(border_chr, sizeof(border_chr));
+	state.read(atr_blk, sizeof(atr_blk));
 
 	//Render border now. Loading save state after booting can lead to black borders.
 	render_sgb_border();
@@ -310,44 +303,34 @@ bool SGB_LCD::lcd_read(u32 offset, std::string filename)
 
 	lcd_stat.lcd_mode &= 0x3;
 	lcd_stat.hdma_type &= 0x1;
-	
-	file.close();
-	return true;
 }
 
 /****** Read LCD data from save state ******/
-bool SGB_LCD::lcd_write(std::string filename)
+void SGB_LCD::lcd_write(state_writer& state)
 {
-	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::app);
-	
-	if(!file.is_open()) { return false; }
+	//Serialize LCD data to save state
+	state.write(&lcd_stat, sizeof(lcd_stat));
 
-	//Serialize LCD data to file stream
-	file.write((char*)&lcd_stat, sizeof(lcd_stat));
-
-	//Serialize OBJ data to file stream
+	//Serialize OBJ data to save state
 	for(int x = 0; x < 40; x++)
 	{
-		file.write((char*)&obj[x], sizeof(obj[x]));
+		state.write(&obj[x], sizeof(obj[x]));
 	}
 
-	file.write((char*)&sgb_mask_mode, sizeof(sgb_mask_mode));
-	file.write((char*)&sgb_gfx_mode, sizeof(sgb_gfx_mode));
-	file.write((char*)&sgb_pal, sizeof(sgb_pal));
-	file.write((char*)&atf_data, sizeof(atf_data));
-	file.write((char*)&sgb_system_pal, sizeof(sgb_system_pal));
-	file.write((char*)&current_atf, sizeof(current_atf));
-	file.write((char*)&color_0, sizeof(color_0));
-	file.write((char*)&manual_pal, sizeof(manual_pal));
-	file.write((char*)&render_border, sizeof(render_border));
-
-	file.write((char*)border_tile_map, sizeof(border_tile_map));
-	file.write((char*)border_pal, sizeof(border_pal));
-	file.write((char*)border_chr, sizeof(border_chr));
-	file.write((char*)atr_blk, sizeof(atr_blk));
-
-	file.close();
-	return true;
+	state.write(&sgb_mask_mode, sizeof(sgb_mask_mode));
+	state.write(&sgb_gfx_mode, sizeof(sgb_gfx_mode));
+	state.write(&sgb_pal, sizeof(sgb_pal));
+	state.write(&atf_data, sizeof(atf_data));
+	state.write(&sgb_system_pal, sizeof(sgb_system_pal));
+	state.write(&current_atf, sizeof(current_atf));
+	state.write(&color_0, sizeof(color_0));
+	state.write(&manual_pal, sizeof(manual_pal));
+	state.write(&render_border, sizeof(render_border));
+
+	state.write(border_tile_map, sizeof(border_tile_map));
+	state.write(border_pal, sizeof(border_pal));
+	state.write(border_chr, sizeof(border_chr));
+	state.write(atr_blk, sizeof(atr_blk));
 }
 
 /****** Compares LY and LYC - Generates STAT interrupt ******/
@@ -34,8 +34,8 @@ class SGB_LCD
 	bool opengl_init();
 
 	//Serialize data for save state loading/saving
-	bool lcd_read(u32 offset, std::string filename);
-	bool lcd_write(std::string filename);
+	void lcd_read(state_reader& state);
+	void lcd_write(state_writer& state);
 
 	//Screen data
 	SDL_Window *window;
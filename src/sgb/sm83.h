@@ -122,9 +122,8 @@ class SGB_SM83
 	void exec_op(u16 opcode);
 
 	//Serialize data for save state loading/saving
-	bool cpu_read(u32 offset, std::string filename);
-	bool cpu_write(std::string filename);
-	u32 size();
+	void cpu_read(state_reader& state);
+	void cpu_write(state_writer& state);
 
 	//Interrupt handling
 	bool handle_interrupts();